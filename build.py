@@ -1,28 +1,210 @@
 #!/usr/bin/env python3
 
-import sys
+import argparse
+import os
+import shutil
 import subprocess
+import sys
+import time
+
+BUILD_DIR = "build"
+PROJECT_DIR = "mvp-godot-project"
+INSTALLED_LIBRARY = os.path.join(PROJECT_DIR, "build", "entry.so")
+
+# Only `godot_entry` has to be visible to Godot, everything else stays local
+# to the library so the compiler is free to inline and drop it.
+#
+# NOTE: This is used instead of `-fvisibility=hidden`, which would need every
+# example to mark `godot_entry` as visible. With LTO the linker tells GCC which
+# symbols aren't exported, so they get internalized just the same.
+EXPORTS_MAP = "{ global: godot_entry; local: *; };\n"
+
+# How long the training/benchmark run lasts, in frames
+DEFAULT_FRAMES = 600
 
+CONFIGS = {
+    # What the examples have always been built with
+    "debug": {
+        "cflags": ["-g", "-O0"],
+        "ldflags": ["-rdynamic"],
+        "local_symbols": False,
+        "strip": False,
+    },
+    "release": {
+        "cflags": ["-O2", "-flto=auto", "-fno-plt", "-DNDEBUG"],
+        "ldflags": ["-flto=auto", "-O2"],
+        "local_symbols": True,
+        "strip": True,
+    },
+    # Release with symbols and frame pointers, for `perf record -g`
+    "profile": {
+        "cflags": ["-O2", "-g", "-flto=auto", "-fno-omit-frame-pointer", "-DNDEBUG"],
+        "ldflags": ["-flto=auto", "-O2", "-g"],
+        "local_symbols": True,
+        "strip": False,
+    },
+}
 
-def run(args):
-    res = subprocess.run(args)
+
+def run(args, **kwargs):
+    res = subprocess.run(args, **kwargs)
     if res.returncode != 0:
         print("Exiting because of nonzero return code")
         sys.exit(1)
+    return res
+
+
+def example_name(filename):
+    return os.path.splitext(os.path.basename(filename))[0]
+
+
+def all_examples():
+    return sorted(
+        os.path.join("src", f)
+        for f in os.listdir("src")
+        if f.endswith(".c") or f.endswith(".cpp")
+    )
+
+
+def compiler_for(filename):
+    # C++ examples don't use exceptions or RTTI, so they don't need them
+    if filename.endswith(".cpp"):
+        return ["g++", "-std=c++17", "-fno-exceptions", "-fno-rtti"]
+    return ["gcc"]
+
+
+def build_library(filename, config_name, out_path, extra_flags=[]):
+    config = CONFIGS[config_name]
+    os.makedirs(os.path.dirname(out_path), exist_ok=True)
+
+    first_args = compiler_for(filename) + ["-Wall", "-Wl,--no-as-needed"] + config["cflags"] + extra_flags
+    if config["local_symbols"]:
+        first_args += ["-fno-semantic-interposition"]
+
+    link_args = list(config["ldflags"])
+    if config["local_symbols"]:
+        exports_map = os.path.join(BUILD_DIR, "exports.map")
+        with open(exports_map, "w") as f:
+            f.write(EXPORTS_MAP)
+        link_args += [f"-Wl,--version-script={exports_map}"]
+    if config["strip"]:
+        link_args += ["-s"]
+
+    obj_path = out_path + ".o"
+    run(first_args + ["-fPIC", "-c", filename, "-o", obj_path])
+    run(first_args + ["-shared", "-o", out_path, obj_path] + link_args)
+    run(["rm", obj_path])
+
+
+def install(library):
+    run(["mkdir", "-p", os.path.dirname(INSTALLED_LIBRARY)])
+    run(["cp", library, INSTALLED_LIBRARY])
 
 
-def build_file(filename):
-    first_args = ["gcc", "-g", "-Wall", "-Wl,--no-as-needed"]
-    run(first_args + ["-fPIC", "-c", filename, "-o", "entry.o", "-rdynamic"])
-    run(first_args + ["-shared", "-o", "entry.so", "entry.o", "-rdynamic"])
-    run(["rm", "entry.o"])
-    run(["mkdir", "-p", "mvp-godot-project/build"])
-    run(["mv", "entry.so", "mvp-godot-project/build"])
+def build_file(filename, config_name="debug"):
+    out_path = os.path.join(BUILD_DIR, config_name, example_name(filename) + ".so")
+    build_library(filename, config_name, out_path)
+    install(out_path)
+
+
+def build_all(config_name):
+    for filename in all_examples():
+        out_path = os.path.join(BUILD_DIR, config_name, example_name(filename) + ".so")
+        print(f"{config_name}: {filename} -> {out_path}")
+        build_library(filename, config_name, out_path)
+
+
+# ---------------------------------------------------------------------------
+# Headless harness
+# ---------------------------------------------------------------------------
+
+
+def harness_command(godot, frames):
+    # `--quit-after` makes Godot exit normally, which is what writes the
+    # profile data (and the deinitialization output) at the end
+    return [godot, "--headless", "--path", PROJECT_DIR, "--quit-after", str(frames)]
+
+
+def run_harness(library, godot, frames, log_path):
+    install(library)
+    start = time.monotonic()
+    with open(log_path, "w") as log:
+        run(harness_command(godot, frames), stdout=log, stderr=subprocess.STDOUT)
+    return time.monotonic() - start
+
+
+def pgo(filename, godot, frames):
+    name = example_name(filename)
+    profile_dir = os.path.abspath(os.path.join(BUILD_DIR, "pgo-data", name))
+    shutil.rmtree(profile_dir, ignore_errors=True)
+
+    # 1. Instrumented build. `atomic` keeps the counters sane when Godot calls
+    # us from several threads.
+    instrumented = os.path.join(BUILD_DIR, "pgo-instrumented", name + ".so")
+    build_library(filename, "release", instrumented,
+                  [f"-fprofile-generate={profile_dir}", "-fprofile-update=atomic"])
+
+    # 2. Training run
+    log_path = os.path.join(BUILD_DIR, "pgo-instrumented", name + ".log")
+    print(f"training {name} for {frames} frames, output in {log_path}")
+    run_harness(instrumented, godot, frames, log_path)
+
+    # 3. Optimized build. Functions that the training run didn't reach are
+    # still compiled normally.
+    out_path = os.path.join(BUILD_DIR, "pgo", name + ".so")
+    build_library(filename, "release", out_path,
+                  [f"-fprofile-use={profile_dir}", "-fprofile-correction", "-Wno-missing-profile"])
+    install(out_path)
+    print(f"pgo: {filename} -> {out_path}")
+    return out_path
+
+
+def bench(filename, godot, frames):
+    name = example_name(filename)
+    results = []
+    for config_name in CONFIGS:
+        library = os.path.join(BUILD_DIR, config_name, name + ".so")
+        build_library(filename, config_name, library)
+        results.append((config_name, library))
+    results.append(("pgo", pgo(filename, godot, frames)))
+
+    print(f"\n{name}, {frames} frames headless")
+    print(f"{'config':<10} {'size':>10} {'wall time':>12}  log")
+    for config_name, library in results:
+        log_path = os.path.join(BUILD_DIR, config_name, name + ".log")
+        seconds = run_harness(library, godot, frames, log_path)
+        size = os.path.getsize(library)
+        print(f"{config_name:<10} {size:>10} {seconds:>11.3f}s  {log_path}")
+
+    # Leave the normal debug build installed
+    install(os.path.join(BUILD_DIR, "debug", name + ".so"))
 
 
 if __name__ == "__main__":
-    if len(sys.argv) != 2:
-        print(f"usage: {sys.argv[0]} [source-file]")
-        sys.exit(1)
+    parser = argparse.ArgumentParser(
+        description="Builds the examples. With only a source file, builds it in the debug "
+                    "configuration and installs it into the project like before.")
+    parser.add_argument("source_file", nargs="?", help="example to build and install")
+    parser.add_argument("--config", choices=CONFIGS.keys(), default="debug")
+    parser.add_argument("--all", action="store_true",
+                        help="build every example in src/ into build/<config>/, nothing is installed")
+    parser.add_argument("--pgo", action="store_true",
+                        help="instrumented build, training run in the headless harness, optimized build")
+    parser.add_argument("--bench", action="store_true",
+                        help="build and run the example in every configuration (and with PGO) and compare")
+    parser.add_argument("--godot", default=os.environ.get("GODOT", "godot"),
+                        help="Godot binary used by the harness (default: $GODOT or godot)")
+    parser.add_argument("--frames", type=int, default=DEFAULT_FRAMES)
+    args = parser.parse_args()
 
-    build_file(sys.argv[1])
+    if args.all:
+        build_all(args.config)
+    elif args.source_file is None:
+        parser.print_usage()
+        sys.exit(1)
+    elif args.bench:
+        bench(args.source_file, args.godot, args.frames)
+    elif args.pgo:
+        pgo(args.source_file, args.godot, args.frames)
+    else:
+        build_file(args.source_file, args.config)
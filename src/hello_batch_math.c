@@ -0,0 +1,522 @@
+#include "../godot-headers/gdextension_interface.h"
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#define STORE_GD_EXTENSION(str_name) gd_extension.str_name = (void *)p_get_proc_address(#str_name);
+#define IS_GODOT_64_BIT (true)
+#define IS_GODOT_USING_LARGE_WORLD_COORDINATES (false)
+#define VARIANT_SIZE (IS_GODOT_USING_LARGE_WORLD_COORDINATES ? 40 : 24)
+// Not a multiple of any kernel's width, so the leftovers get checked too
+#define ELEMENT_COUNT (4099)
+#define SAMPLE_STRIDE (61)
+#define BENCHMARK_ROUNDS (100)
+#define WEIGHT (0.3)
+// Relative to the value, or absolute below 1
+#define TOLERANCE (IS_GODOT_USING_LARGE_WORLD_COORDINATES ? 1e-12 : 1e-5)
+
+#include "../util/gd_math.h"
+
+struct {
+  GDExtensionInterfaceStringNameNewWithUtf8Chars string_name_new_with_utf8_chars;
+  GDExtensionInterfaceVariantGetPtrDestructor variant_get_ptr_destructor;
+  GDExtensionInterfaceVariantDestroy variant_destroy;
+  GDExtensionInterfaceVariantCall variant_call;
+  GDExtensionInterfaceVariantEvaluate variant_evaluate;
+  GDExtensionInterfaceGetVariantFromTypeConstructor get_variant_from_type_constructor;
+  GDExtensionInterfaceGetVariantToTypeConstructor get_variant_to_type_constructor;
+} gd_extension;
+
+struct {
+  struct {
+    GDExtensionPtrDestructor string_name;
+  } destructor;
+  struct {
+    GDExtensionVariantFromTypeConstructorFunc type_double;
+    GDExtensionVariantFromTypeConstructorFunc vector2;
+    GDExtensionVariantFromTypeConstructorFunc vector3;
+    GDExtensionVariantFromTypeConstructorFunc vector4;
+    GDExtensionVariantFromTypeConstructorFunc quaternion;
+    GDExtensionVariantFromTypeConstructorFunc transform2d;
+    GDExtensionVariantFromTypeConstructorFunc transform3d;
+    GDExtensionVariantFromTypeConstructorFunc basis;
+    GDExtensionVariantFromTypeConstructorFunc aabb;
+  } wrap;
+  struct {
+    GDExtensionTypeFromVariantConstructorFunc vector2;
+    GDExtensionTypeFromVariantConstructorFunc vector3;
+    GDExtensionTypeFromVariantConstructorFunc vector4;
+    GDExtensionTypeFromVariantConstructorFunc quaternion;
+    GDExtensionTypeFromVariantConstructorFunc aabb;
+  } unwrap;
+  struct {
+    GDExtensionStringNamePtr normalized;
+    GDExtensionStringNamePtr lerp;
+    GDExtensionStringNamePtr slerp;
+    GDExtensionStringNamePtr merge;
+  } string_name;
+} gd_extension_helper;
+
+static struct {
+  gd_math_transform2d_t transform2d;
+  gd_math_transform3d_t transform3d;
+  gd_math_vector2_t vectors2[ELEMENT_COUNT];
+  gd_math_vector2_t targets2[ELEMENT_COUNT];
+  gd_math_vector3_t vectors3[ELEMENT_COUNT];
+  gd_math_vector3_t targets3[ELEMENT_COUNT];
+  gd_math_vector4_t vectors4[ELEMENT_COUNT];
+  gd_math_vector4_t targets4[ELEMENT_COUNT];
+  gd_math_quaternion_t quaternions[ELEMENT_COUNT];
+  // Normalized, Godot's slerp refuses anything else
+  gd_math_quaternion_t rotations[ELEMENT_COUNT];
+  gd_math_quaternion_t rotation_targets[ELEMENT_COUNT];
+  gd_math_aabb_t boxes[ELEMENT_COUNT];
+} inputs;
+
+// The same inputs as Variants, for the engine side
+static struct {
+  uint8_t transform2d[VARIANT_SIZE];
+  uint8_t transform3d[VARIANT_SIZE];
+  uint8_t basis[VARIANT_SIZE];
+  uint8_t weight[VARIANT_SIZE];
+} godot_inputs;
+
+// One batch operation next to the engine doing the same for one element.
+// `result_size` is the number of reals per result.
+typedef struct {
+  const char *name;
+  int result_size;
+  int64_t result_count;
+  void (*batch)(void *r_res);
+  void (*godot)(int64_t p_index, void *r_res);
+} operation_t;
+
+static gd_real_t results[ELEMENT_COUNT * 4];
+
+GDExtensionStringNamePtr construct_string_name(const char *c_string) {
+  void *res = malloc(IS_GODOT_64_BIT ? 8 : 4);
+  gd_extension.string_name_new_with_utf8_chars(res, c_string);
+  return res;
+}
+
+void destruct_string_name(GDExtensionStringNamePtr p) {
+  gd_extension_helper.destructor.string_name(p);
+  free(p);
+}
+
+uint64_t now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+gd_real_t random_real(uint32_t *state) {
+  *state = *state * 1664525u + 1013904223u;
+  return (gd_real_t)((*state >> 8) / (double)(1 << 24) * 20.0 - 10.0);
+}
+
+void make_inputs() {
+  uint32_t state = 12345;
+  inputs.transform2d = (gd_math_transform2d_t){ .columns = {
+    { .x = 0.8, .y = 0.6 }, { .x = -1.2, .y = 1.6 }, { .x = 10, .y = -4.5 },
+  } };
+  inputs.transform3d = (gd_math_transform3d_t){
+    .basis = { .rows = {
+      { .x = 0.36, .y = 0.48, .z = -0.8 },
+      { .x = -0.8, .y = 0.6, .z = 0 },
+      { .x = 0.96, .y = 1.28, .z = 1.2 },
+    } },
+    .origin = { .x = 3.5, .y = -7.25, .z = 100 },
+  };
+
+  for (int i = 0; i < ELEMENT_COUNT; i++) {
+    gd_real_t *values = &inputs.vectors2[i].x;
+    for (int k = 0; k < 2; k++) values[k] = random_real(&state);
+    values = &inputs.targets2[i].x;
+    for (int k = 0; k < 2; k++) values[k] = random_real(&state);
+    values = &inputs.vectors3[i].x;
+    for (int k = 0; k < 3; k++) values[k] = random_real(&state);
+    values = &inputs.targets3[i].x;
+    for (int k = 0; k < 3; k++) values[k] = random_real(&state);
+    values = &inputs.vectors4[i].x;
+    for (int k = 0; k < 4; k++) values[k] = random_real(&state);
+    values = &inputs.targets4[i].x;
+    for (int k = 0; k < 4; k++) values[k] = random_real(&state);
+    values = &inputs.quaternions[i].x;
+    for (int k = 0; k < 4; k++) values[k] = random_real(&state);
+    values = &inputs.rotations[i].x;
+    for (int k = 0; k < 4; k++) values[k] = random_real(&state);
+    values = &inputs.rotation_targets[i].x;
+    for (int k = 0; k < 4; k++) values[k] = random_real(&state);
+    values = &inputs.boxes[i].position.x;
+    for (int k = 0; k < 3; k++) values[k] = random_real(&state) * 100;
+    values = &inputs.boxes[i].size.x;
+    for (int k = 0; k < 3; k++) values[k] = random_real(&state) + 10;
+
+    // Zero vectors take their own path through normalization
+    if (i % 17 == 0) {
+      inputs.vectors2[i] = (gd_math_vector2_t){ 0 };
+      inputs.vectors3[i] = (gd_math_vector3_t){ 0 };
+      inputs.vectors4[i] = (gd_math_vector4_t){ 0 };
+    }
+  }
+  gd_math_set_level(GD_MATH_LEVEL_SCALAR);
+  gd_math_quaternion_normalize(inputs.rotations, inputs.rotations, ELEMENT_COUNT);
+  gd_math_quaternion_normalize(inputs.rotation_targets, inputs.rotation_targets, ELEMENT_COUNT);
+
+  double weight = WEIGHT;
+  gd_extension_helper.wrap.transform2d(godot_inputs.transform2d, &inputs.transform2d);
+  gd_extension_helper.wrap.transform3d(godot_inputs.transform3d, &inputs.transform3d);
+  gd_extension_helper.wrap.basis(godot_inputs.basis, &inputs.transform3d.basis);
+  gd_extension_helper.wrap.type_double(godot_inputs.weight, &weight);
+}
+
+// ---------------------------------------------------------------------------
+// The engine, one element at a time
+// ---------------------------------------------------------------------------
+
+void godot_multiply(
+  GDExtensionConstVariantPtr p_transform,
+  GDExtensionVariantFromTypeConstructorFunc p_wrap,
+  const void *p_vector,
+  GDExtensionTypeFromVariantConstructorFunc p_unwrap,
+  void *r_res
+) {
+  uint8_t vector[VARIANT_SIZE];
+  uint8_t res[VARIANT_SIZE];
+  GDExtensionBool valid;
+  p_wrap(vector, (void *)p_vector);
+  gd_extension.variant_evaluate(GDEXTENSION_VARIANT_OP_MULTIPLY, p_transform, vector, res, &valid);
+  p_unwrap(r_res, res);
+  gd_extension.variant_destroy(res);
+  gd_extension.variant_destroy(vector);
+}
+
+// Calls `p_method` on `p_self` with an optional second value of the same
+// type and the weight
+void godot_call(
+  GDExtensionConstStringNamePtr p_method,
+  GDExtensionVariantFromTypeConstructorFunc p_wrap,
+  const void *p_self,
+  const void *p_other,
+  GDExtensionTypeFromVariantConstructorFunc p_unwrap,
+  void *r_res
+) {
+  uint8_t self[VARIANT_SIZE];
+  uint8_t other[VARIANT_SIZE];
+  uint8_t res[VARIANT_SIZE];
+  GDExtensionCallError error;
+  p_wrap(self, (void *)p_self);
+  if (p_other != NULL) {
+    p_wrap(other, (void *)p_other);
+    GDExtensionConstVariantPtr args[] = { other, godot_inputs.weight };
+    gd_extension.variant_call(self, p_method, args, 2, res, &error);
+    gd_extension.variant_destroy(other);
+  } else {
+    gd_extension.variant_call(self, p_method, NULL, 0, res, &error);
+  }
+  p_unwrap(r_res, res);
+  gd_extension.variant_destroy(res);
+  gd_extension.variant_destroy(self);
+}
+
+void godot_xform2(int64_t p_index, void *r_res) {
+  godot_multiply(godot_inputs.transform2d, gd_extension_helper.wrap.vector2, &inputs.vectors2[p_index],
+                 gd_extension_helper.unwrap.vector2, r_res);
+}
+
+void godot_xform3(int64_t p_index, void *r_res) {
+  godot_multiply(godot_inputs.transform3d, gd_extension_helper.wrap.vector3, &inputs.vectors3[p_index],
+                 gd_extension_helper.unwrap.vector3, r_res);
+}
+
+void godot_basis_xform3(int64_t p_index, void *r_res) {
+  godot_multiply(godot_inputs.basis, gd_extension_helper.wrap.vector3, &inputs.vectors3[p_index],
+                 gd_extension_helper.unwrap.vector3, r_res);
+}
+
+void godot_normalize2(int64_t p_index, void *r_res) {
+  godot_call(gd_extension_helper.string_name.normalized, gd_extension_helper.wrap.vector2,
+             &inputs.vectors2[p_index], NULL, gd_extension_helper.unwrap.vector2, r_res);
+}
+
+void godot_normalize3(int64_t p_index, void *r_res) {
+  godot_call(gd_extension_helper.string_name.normalized, gd_extension_helper.wrap.vector3,
+             &inputs.vectors3[p_index], NULL, gd_extension_helper.unwrap.vector3, r_res);
+}
+
+void godot_normalize4(int64_t p_index, void *r_res) {
+  godot_call(gd_extension_helper.string_name.normalized, gd_extension_helper.wrap.vector4,
+             &inputs.vectors4[p_index], NULL, gd_extension_helper.unwrap.vector4, r_res);
+}
+
+void godot_quaternion_normalize(int64_t p_index, void *r_res) {
+  godot_call(gd_extension_helper.string_name.normalized, gd_extension_helper.wrap.quaternion,
+             &inputs.quaternions[p_index], NULL, gd_extension_helper.unwrap.quaternion, r_res);
+}
+
+void godot_lerp2(int64_t p_index, void *r_res) {
+  godot_call(gd_extension_helper.string_name.lerp, gd_extension_helper.wrap.vector2,
+             &inputs.vectors2[p_index], &inputs.targets2[p_index], gd_extension_helper.unwrap.vector2, r_res);
+}
+
+void godot_lerp3(int64_t p_index, void *r_res) {
+  godot_call(gd_extension_helper.string_name.lerp, gd_extension_helper.wrap.vector3,
+             &inputs.vectors3[p_index], &inputs.targets3[p_index], gd_extension_helper.unwrap.vector3, r_res);
+}
+
+void godot_lerp4(int64_t p_index, void *r_res) {
+  godot_call(gd_extension_helper.string_name.lerp, gd_extension_helper.wrap.vector4,
+             &inputs.vectors4[p_index], &inputs.targets4[p_index], gd_extension_helper.unwrap.vector4, r_res);
+}
+
+void godot_slerp(int64_t p_index, void *r_res) {
+  godot_call(gd_extension_helper.string_name.slerp, gd_extension_helper.wrap.quaternion,
+             &inputs.rotations[p_index], &inputs.rotation_targets[p_index], gd_extension_helper.unwrap.quaternion, r_res);
+}
+
+// The whole array, one `merge` call per box
+void godot_aabb_merge(int64_t p_index, void *r_res) {
+  uint8_t merged[VARIANT_SIZE];
+  GDExtensionCallError error;
+  gd_extension_helper.wrap.aabb(merged, &inputs.boxes[0]);
+  for (int i = 1; i < ELEMENT_COUNT; i++) {
+    uint8_t box[VARIANT_SIZE];
+    uint8_t res[VARIANT_SIZE];
+    gd_extension_helper.wrap.aabb(box, &inputs.boxes[i]);
+    GDExtensionConstVariantPtr args[] = { box };
+    gd_extension.variant_call(merged, gd_extension_helper.string_name.merge, args, 1, res, &error);
+    gd_extension.variant_destroy(merged);
+    gd_extension.variant_destroy(box);
+    memcpy(merged, res, VARIANT_SIZE);
+  }
+  gd_extension_helper.unwrap.aabb(r_res, merged);
+  gd_extension.variant_destroy(merged);
+}
+
+// ---------------------------------------------------------------------------
+// The same in batches
+// ---------------------------------------------------------------------------
+
+void batch_xform2(void *r_res) {
+  gd_math_transform2d_xform_vector2(&inputs.transform2d, inputs.vectors2, r_res, ELEMENT_COUNT);
+}
+
+void batch_xform3(void *r_res) {
+  gd_math_transform3d_xform_vector3(&inputs.transform3d, inputs.vectors3, r_res, ELEMENT_COUNT);
+}
+
+void batch_basis_xform3(void *r_res) {
+  gd_math_basis_xform_vector3(&inputs.transform3d.basis, inputs.vectors3, r_res, ELEMENT_COUNT);
+}
+
+void batch_normalize2(void *r_res) {
+  gd_math_vector2_normalize(inputs.vectors2, r_res, ELEMENT_COUNT);
+}
+
+void batch_normalize3(void *r_res) {
+  gd_math_vector3_normalize(inputs.vectors3, r_res, ELEMENT_COUNT);
+}
+
+void batch_normalize4(void *r_res) {
+  gd_math_vector4_normalize(inputs.vectors4, r_res, ELEMENT_COUNT);
+}
+
+void batch_quaternion_normalize(void *r_res) {
+  gd_math_quaternion_normalize(inputs.quaternions, r_res, ELEMENT_COUNT);
+}
+
+void batch_lerp2(void *r_res) {
+  gd_math_vector2_lerp(inputs.vectors2, inputs.targets2, WEIGHT, r_res, ELEMENT_COUNT);
+}
+
+void batch_lerp3(void *r_res) {
+  gd_math_vector3_lerp(inputs.vectors3, inputs.targets3, WEIGHT, r_res, ELEMENT_COUNT);
+}
+
+void batch_lerp4(void *r_res) {
+  gd_math_vector4_lerp(inputs.vectors4, inputs.targets4, WEIGHT, r_res, ELEMENT_COUNT);
+}
+
+void batch_slerp(void *r_res) {
+  gd_math_quaternion_slerp(inputs.rotations, inputs.rotation_targets, WEIGHT, r_res, ELEMENT_COUNT);
+}
+
+void batch_aabb_merge(void *r_res) {
+  *(gd_math_aabb_t *)r_res = gd_math_aabb_merge(inputs.boxes, ELEMENT_COUNT);
+}
+
+static const operation_t operations[] = {
+  { "Transform2D * Vector2", 2, ELEMENT_COUNT, batch_xform2, godot_xform2 },
+  { "Transform3D * Vector3", 3, ELEMENT_COUNT, batch_xform3, godot_xform3 },
+  { "Basis * Vector3", 3, ELEMENT_COUNT, batch_basis_xform3, godot_basis_xform3 },
+  { "Vector2.normalized", 2, ELEMENT_COUNT, batch_normalize2, godot_normalize2 },
+  { "Vector3.normalized", 3, ELEMENT_COUNT, batch_normalize3, godot_normalize3 },
+  { "Vector4.normalized", 4, ELEMENT_COUNT, batch_normalize4, godot_normalize4 },
+  { "Quaternion.normalized", 4, ELEMENT_COUNT, batch_quaternion_normalize, godot_quaternion_normalize },
+  { "Vector2.lerp", 2, ELEMENT_COUNT, batch_lerp2, godot_lerp2 },
+  { "Vector3.lerp", 3, ELEMENT_COUNT, batch_lerp3, godot_lerp3 },
+  { "Vector4.lerp", 4, ELEMENT_COUNT, batch_lerp4, godot_lerp4 },
+  { "Quaternion.slerp", 4, ELEMENT_COUNT, batch_slerp, godot_slerp },
+  { "AABB.merge", 6, 1, batch_aabb_merge, godot_aabb_merge },
+};
+
+// ---------------------------------------------------------------------------
+// Checks and timing
+// ---------------------------------------------------------------------------
+
+double result_error(const gd_real_t *p_ours, const gd_real_t *p_theirs, int p_size) {
+  double res = 0;
+  for (int k = 0; k < p_size; k++) {
+    if (p_ours[k] == p_theirs[k]) continue;
+    double scale = fabs((double)p_theirs[k]) > 1 ? fabs((double)p_theirs[k]) : 1;
+    double error = fabs((double)p_ours[k] - (double)p_theirs[k]) / scale;
+    // NaN fails the check
+    if (!(error <= res)) res = isnan(error) ? INFINITY : error;
+  }
+  return res;
+}
+
+bool is_sample(int64_t p_index, int64_t p_count) {
+  return p_index % SAMPLE_STRIDE == 0 || p_index >= p_count - 8;
+}
+
+// Compares the current kernels with the engine on a sample of the elements
+void check_operation(const operation_t *p_op, int *r_samples, int *r_exact, int *r_off, double *r_max_error) {
+  p_op->batch(results);
+  for (int64_t i = 0; i < p_op->result_count; i++) {
+    if (!is_sample(i, p_op->result_count)) continue;
+    gd_real_t theirs[6];
+    p_op->godot(i, theirs);
+    double error = result_error(results + i * p_op->result_size, theirs, p_op->result_size);
+    *r_samples += 1;
+    if (error == 0) *r_exact += 1;
+    if (error > TOLERANCE) *r_off += 1;
+    if (error > *r_max_error) *r_max_error = error;
+  }
+}
+
+void print_operation(const operation_t *p_op) {
+  gd_real_t theirs[6];
+  uint64_t start = now_ns();
+  for (int64_t i = 0; i < p_op->result_count; i++) {
+    p_op->godot(i, theirs);
+  }
+  double godot_ns = (double)(now_ns() - start) / ELEMENT_COUNT;
+  printf("%-22s Godot %7.1f ns", p_op->name, godot_ns);
+
+  int samples = 0;
+  int exact = 0;
+  int off = 0;
+  double max_error = 0;
+  for (gd_math_level_t level = GD_MATH_LEVEL_SCALAR; level <= gd_math.best_level; level++) {
+    gd_math_set_level(level);
+    check_operation(p_op, &samples, &exact, &off, &max_error);
+
+    start = now_ns();
+    for (int round = 0; round < BENCHMARK_ROUNDS; round++) {
+      p_op->batch(results);
+    }
+    double batch_ns = (double)(now_ns() - start) / ((double)ELEMENT_COUNT * BENCHMARK_ROUNDS);
+    printf(", %s %5.2f ns", gd_math_level_names[level], batch_ns);
+  }
+  printf(" per element\n");
+  printf("%-22s %d/%d samples exact, %d off by more than %g (max %g)\n",
+         "", exact, samples, off, TOLERANCE, max_error);
+}
+
+void run_batch_math_example() {
+  make_inputs();
+  printf("batch math on %d elements, best kernels: %s\n", ELEMENT_COUNT, gd_math_level_names[gd_math.best_level]);
+  for (size_t i = 0; i < sizeof(operations) / sizeof(operations[0]); i++) {
+    print_operation(&operations[i]);
+  }
+  gd_math_set_level(gd_math.best_level);
+
+  gd_extension.variant_destroy(godot_inputs.transform2d);
+  gd_extension.variant_destroy(godot_inputs.transform3d);
+  gd_extension.variant_destroy(godot_inputs.basis);
+  gd_extension.variant_destroy(godot_inputs.weight);
+}
+
+void godot_initialize(void *userdata, GDExtensionInitializationLevel p_level) {
+  if (p_level == GDEXTENSION_INITIALIZATION_SCENE) {
+    gd_extension_helper.string_name.normalized = construct_string_name("normalized");
+    gd_extension_helper.string_name.lerp = construct_string_name("lerp");
+    gd_extension_helper.string_name.slerp = construct_string_name("slerp");
+    gd_extension_helper.string_name.merge = construct_string_name("merge");
+
+    run_batch_math_example();
+    return;
+  }
+}
+
+void godot_deinitialize(void *userdata, GDExtensionInitializationLevel p_level) {
+  if (p_level == GDEXTENSION_INITIALIZATION_SCENE) {
+    destruct_string_name(gd_extension_helper.string_name.normalized);
+    destruct_string_name(gd_extension_helper.string_name.lerp);
+    destruct_string_name(gd_extension_helper.string_name.slerp);
+    destruct_string_name(gd_extension_helper.string_name.merge);
+  }
+}
+
+GDExtensionBool
+godot_entry(
+  GDExtensionInterfaceGetProcAddress p_get_proc_address,
+  const GDExtensionClassLibraryPtr _p_library,
+  GDExtensionInitialization *r_initialization
+) {
+  r_initialization->minimum_initialization_level = GDEXTENSION_INITIALIZATION_SCENE;
+  r_initialization->userdata = NULL;
+  r_initialization->initialize = godot_initialize;
+  r_initialization->deinitialize = godot_deinitialize;
+
+  STORE_GD_EXTENSION(string_name_new_with_utf8_chars);
+  STORE_GD_EXTENSION(variant_get_ptr_destructor);
+  STORE_GD_EXTENSION(variant_destroy);
+  STORE_GD_EXTENSION(variant_call);
+  STORE_GD_EXTENSION(variant_evaluate);
+  STORE_GD_EXTENSION(get_variant_from_type_constructor);
+  STORE_GD_EXTENSION(get_variant_to_type_constructor);
+
+  gd_extension_helper.destructor.string_name
+    = gd_extension.variant_get_ptr_destructor(GDEXTENSION_VARIANT_TYPE_STRING_NAME);
+
+  gd_extension_helper.wrap.type_double
+    = gd_extension.get_variant_from_type_constructor(GDEXTENSION_VARIANT_TYPE_FLOAT);
+  gd_extension_helper.wrap.vector2
+    = gd_extension.get_variant_from_type_constructor(GDEXTENSION_VARIANT_TYPE_VECTOR2);
+  gd_extension_helper.wrap.vector3
+    = gd_extension.get_variant_from_type_constructor(GDEXTENSION_VARIANT_TYPE_VECTOR3);
+  gd_extension_helper.wrap.vector4
+    = gd_extension.get_variant_from_type_constructor(GDEXTENSION_VARIANT_TYPE_VECTOR4);
+  gd_extension_helper.wrap.quaternion
+    = gd_extension.get_variant_from_type_constructor(GDEXTENSION_VARIANT_TYPE_QUATERNION);
+  gd_extension_helper.wrap.transform2d
+    = gd_extension.get_variant_from_type_constructor(GDEXTENSION_VARIANT_TYPE_TRANSFORM2D);
+  gd_extension_helper.wrap.transform3d
+    = gd_extension.get_variant_from_type_constructor(GDEXTENSION_VARIANT_TYPE_TRANSFORM3D);
+  gd_extension_helper.wrap.basis
+    = gd_extension.get_variant_from_type_constructor(GDEXTENSION_VARIANT_TYPE_BASIS);
+  gd_extension_helper.wrap.aabb
+    = gd_extension.get_variant_from_type_constructor(GDEXTENSION_VARIANT_TYPE_AABB);
+
+  gd_extension_helper.unwrap.vector2
+    = gd_extension.get_variant_to_type_constructor(GDEXTENSION_VARIANT_TYPE_VECTOR2);
+  gd_extension_helper.unwrap.vector3
+    = gd_extension.get_variant_to_type_constructor(GDEXTENSION_VARIANT_TYPE_VECTOR3);
+  gd_extension_helper.unwrap.vector4
+    = gd_extension.get_variant_to_type_constructor(GDEXTENSION_VARIANT_TYPE_VECTOR4);
+  gd_extension_helper.unwrap.quaternion
+    = gd_extension.get_variant_to_type_constructor(GDEXTENSION_VARIANT_TYPE_QUATERNION);
+  gd_extension_helper.unwrap.aabb
+    = gd_extension.get_variant_to_type_constructor(GDEXTENSION_VARIANT_TYPE_AABB);
+
+  gd_math_init();
+
+  return true;
+}
@@ -0,0 +1,149 @@
+#include "../godot-headers/gdextension_interface.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define STORE_GD_EXTENSION(str_name) \
+  gd_extension.str_name = reinterpret_cast<decltype(gd_extension.str_name)>(p_get_proc_address(#str_name));
+#define IS_GODOT_64_BIT (true)
+#define IS_GODOT_USING_LARGE_WORLD_COORDINATES (false)
+#define BENCHMARK_COUNT (100000)
+#define ARRAY_COUNT (16)
+
+#include "../util/builtin.hpp"
+
+struct {
+  GDExtensionInterfaceStringNameNewWithUtf8Chars string_name_new_with_utf8_chars;
+  GDExtensionInterfaceVariantGetPtrDestructor variant_get_ptr_destructor;
+  GDExtensionInterfaceVariantGetPtrBuiltinMethod variant_get_ptr_builtin_method;
+} gd_extension;
+
+struct {
+  GDExtensionPtrDestructor string_name_destructor;
+  GDExtensionPtrBuiltInMethod array_resize;
+  GDExtensionPtrBuiltInMethod array_size;
+} gd_extension_helper;
+
+uint64_t now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// The way the other examples do it, for comparison
+GDExtensionStringNamePtr construct_string_name(const char *c_string) {
+  void *res = malloc(IS_GODOT_64_BIT ? 8 : 4);
+  gd_extension.string_name_new_with_utf8_chars(res, c_string);
+  return res;
+}
+
+void destruct_string_name(GDExtensionStringNamePtr p) {
+  gd_extension_helper.string_name_destructor(p);
+  free(p);
+}
+
+// Returned by value: the wrapper is moved out (or elided), never copied
+gd::Array make_array(int64_t size) {
+  gd::Array res;
+  const GDExtensionConstTypePtr args[1] = { &size };
+  int64_t err;
+  gd_extension_helper.array_resize(res.ptr(), args, &err, 1);
+  return res;
+}
+
+int64_t array_size(const gd::Array &array) {
+  int64_t res;
+  // Builtin methods take a non-const base even for const methods
+  gd_extension_helper.array_size(const_cast<GDExtensionTypePtr>(array.ptr()), NULL, &res, 0);
+  return res;
+}
+
+void print_layout() {
+  printf("sizeof(gd::String) = %zu (Godot: %d)\n", sizeof(gd::String), GD_BUILTIN_SIZE_STRING);
+  printf("sizeof(gd::Transform3D) = %zu (Godot: %d)\n", sizeof(gd::Transform3D), GD_BUILTIN_SIZE_TRANSFORM3D);
+  printf("sizeof(gd::Variant) = %zu (Godot: %d)\n", sizeof(gd::Variant), GD_BUILTIN_SIZE_VARIANT);
+}
+
+void print_string_name_benchmark() {
+  uint64_t start = now_ns();
+  for (int i = 0; i < BENCHMARK_COUNT; i++) {
+    GDExtensionStringNamePtr name = construct_string_name("position");
+    destruct_string_name(name);
+  }
+  uint64_t heap_ns = now_ns() - start;
+
+  start = now_ns();
+  for (int i = 0; i < BENCHMARK_COUNT; i++) {
+    gd::StringName name = gd::StringName::from_utf8("position");
+  }
+  uint64_t inline_ns = now_ns() - start;
+
+  printf("StringName temporary: malloc'd %.1f ns, inline %.1f ns\n",
+         (double)heap_ns / BENCHMARK_COUNT,
+         (double)inline_ns / BENCHMARK_COUNT);
+}
+
+void print_array_moves() {
+  // Arrays live directly in this stack buffer, moving them in is a memcpy of
+  // the 8 byte handle and doesn't touch the reference count
+  gd::Array arrays[ARRAY_COUNT];
+  for (int i = 0; i < ARRAY_COUNT; i++) {
+    arrays[i] = make_array(i);
+  }
+
+  // Godot's Array copy constructor shares the same storage
+  gd::Array shared = arrays[ARRAY_COUNT - 1];
+  int64_t total = 0;
+  for (int i = 0; i < ARRAY_COUNT; i++) {
+    total += array_size(arrays[i]);
+  }
+  printf("%d arrays with %ld elements in total, shared copy has %ld\n",
+         ARRAY_COUNT,
+         (long)total,
+         (long)array_size(shared));
+}
+
+void godot_initialize(void *userdata, GDExtensionInitializationLevel p_level) {
+  if (p_level == GDEXTENSION_INITIALIZATION_SCENE) {
+    gd::StringName resize_name = gd::StringName::from_utf8("resize");
+    gd::StringName size_name = gd::StringName::from_utf8("size");
+    gd_extension_helper.array_resize = gd_extension.variant_get_ptr_builtin_method(GDEXTENSION_VARIANT_TYPE_ARRAY,
+                                                                                   resize_name.ptr(),
+                                                                                   848867239);
+    gd_extension_helper.array_size = gd_extension.variant_get_ptr_builtin_method(GDEXTENSION_VARIANT_TYPE_ARRAY,
+                                                                                 size_name.ptr(),
+                                                                                 3173160232);
+
+    print_layout();
+    print_string_name_benchmark();
+    print_array_moves();
+    return;
+  }
+}
+
+void godot_deinitialize(void *userdata, GDExtensionInitializationLevel p_level) {
+  return;
+}
+
+extern "C" GDExtensionBool
+godot_entry(
+  GDExtensionInterfaceGetProcAddress p_get_proc_address,
+  const GDExtensionClassLibraryPtr _p_library,
+  GDExtensionInitialization *r_initialization
+) {
+  r_initialization->minimum_initialization_level = GDEXTENSION_INITIALIZATION_SCENE;
+  r_initialization->userdata = NULL;
+  r_initialization->initialize = godot_initialize;
+  r_initialization->deinitialize = godot_deinitialize;
+
+  STORE_GD_EXTENSION(string_name_new_with_utf8_chars);
+  STORE_GD_EXTENSION(variant_get_ptr_destructor);
+  STORE_GD_EXTENSION(variant_get_ptr_builtin_method);
+
+  gd_extension_helper.string_name_destructor = gd_extension.variant_get_ptr_destructor(GDEXTENSION_VARIANT_TYPE_STRING_NAME);
+
+  gd::builtin_init(p_get_proc_address);
+
+  return true;
+}
@@ -0,0 +1,1210 @@
+#include "../godot-headers/gdextension_interface.h"
+#include <stdio.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define STORE_GD_EXTENSION(str_name) gd_extension.str_name = (void *)p_get_proc_address(#str_name);
+#define IS_GODOT_64_BIT (true)
+#define IS_GODOT_USING_LARGE_WORLD_COORDINATES (false)
+#define VARIANT_SIZE (IS_GODOT_USING_LARGE_WORLD_COORDINATES ? 40 : 24)
+#define PACKED_ARRAY_SIZE (16)
+#define LOADER_CLASS_NAME ("BulkLoader")
+#define LOADER_CLASS_PARENT ("RefCounted")
+#define LOADER_MAX_ARGUMENTS (2)
+#define PROPERTY_USAGE_DEFAULT (6)
+#define SIZE_HASH (3173160232)
+#define RESIZE_HASH (848867239)
+#define DICTIONARY_KEYS_HASH (4144163970)
+// Godot's Error enum
+#define GODOT_OK (0)
+#define GODOT_ERR_UNCONFIGURED (3)
+#define GODOT_ERR_OUT_OF_MEMORY (6)
+#define GODOT_ERR_FILE_NOT_FOUND (7)
+#define GODOT_ERR_FILE_CANT_OPEN (12)
+#define GODOT_ERR_FILE_CANT_WRITE (13)
+#define GODOT_ERR_FILE_UNRECOGNIZED (15)
+#define GODOT_ERR_FILE_CORRUPT (16)
+#define GODOT_ERR_INVALID_PARAMETER (31)
+// The prefetch thread publishes its progress after every step
+#define PREFETCH_STEP (1024 * 1024)
+#define TEST_HEIGHTS (2 * 1024 * 1024)
+#define TEST_POINTS (2 * 1024 * 1024)
+#define TEST_GRID (8 * 1024 * 1024)
+
+struct {
+  GDExtensionInterfaceClassdbConstructObject classdb_construct_object;
+  GDExtensionInterfaceClassdbRegisterExtensionClass2 classdb_register_extension_class2;
+  GDExtensionInterfaceClassdbRegisterExtensionClassMethod classdb_register_extension_class_method;
+  GDExtensionInterfaceStringNameNewWithUtf8Chars string_name_new_with_utf8_chars;
+  GDExtensionInterfaceStringNewWithUtf8Chars string_new_with_utf8_chars;
+  GDExtensionInterfaceStringNewWithUtf8CharsAndLen string_new_with_utf8_chars_and_len;
+  GDExtensionInterfaceStringToUtf8Chars string_to_utf8_chars;
+  GDExtensionInterfaceObjectSetInstance object_set_instance;
+  GDExtensionInterfaceGlobalGetSingleton global_get_singleton;
+  GDExtensionInterfaceVariantGetPtrDestructor variant_get_ptr_destructor;
+  GDExtensionInterfaceVariantGetPtrConstructor variant_get_ptr_constructor;
+  GDExtensionInterfaceVariantGetPtrBuiltinMethod variant_get_ptr_builtin_method;
+  GDExtensionInterfaceGetVariantFromTypeConstructor get_variant_from_type_constructor;
+  GDExtensionInterfaceGetVariantToTypeConstructor get_variant_to_type_constructor;
+  GDExtensionInterfaceVariantGetType variant_get_type;
+  GDExtensionInterfaceVariantCall variant_call;
+  GDExtensionInterfaceVariantDestroy variant_destroy;
+  GDExtensionInterfaceArrayOperatorIndexConst array_operator_index_const;
+  GDExtensionInterfaceDictionaryOperatorIndexConst dictionary_operator_index_const;
+  GDExtensionInterfacePackedByteArrayOperatorIndex packed_byte_array_operator_index;
+  GDExtensionInterfacePackedByteArrayOperatorIndexConst packed_byte_array_operator_index_const;
+  GDExtensionInterfacePackedFloat32ArrayOperatorIndex packed_float32_array_operator_index;
+  GDExtensionInterfacePackedFloat32ArrayOperatorIndexConst packed_float32_array_operator_index_const;
+  GDExtensionInterfacePackedVector2ArrayOperatorIndex packed_vector2_array_operator_index;
+  GDExtensionInterfacePackedVector2ArrayOperatorIndexConst packed_vector2_array_operator_index_const;
+} gd_extension;
+
+// Indexed by GDExtensionVariantType, only filled for the types used here
+struct {
+  GDExtensionPtrDestructor destructor[GDEXTENSION_VARIANT_TYPE_VARIANT_MAX];
+  GDExtensionPtrConstructor constructor[GDEXTENSION_VARIANT_TYPE_VARIANT_MAX];
+  GDExtensionPtrBuiltInMethod size[GDEXTENSION_VARIANT_TYPE_VARIANT_MAX];
+  GDExtensionPtrBuiltInMethod resize[GDEXTENSION_VARIANT_TYPE_VARIANT_MAX];
+  GDExtensionVariantFromTypeConstructorFunc wrap[GDEXTENSION_VARIANT_TYPE_VARIANT_MAX];
+  GDExtensionTypeFromVariantConstructorFunc unwrap[GDEXTENSION_VARIANT_TYPE_VARIANT_MAX];
+  struct {
+    GDExtensionPtrBuiltInMethod dictionary_keys;
+  } builtin_method;
+  struct {
+    GDExtensionClassLibraryPtr p_library;
+  } misc;
+} gd_extension_helper;
+
+GDExtensionStringNamePtr construct_string_name(const char *c_string) {
+  void *res = malloc(IS_GODOT_64_BIT ? 8 : 4);
+  gd_extension.string_name_new_with_utf8_chars(res, c_string);
+  return res;
+}
+
+GDExtensionStringPtr construct_string(const char *c_string) {
+  void *res = malloc(IS_GODOT_64_BIT ? 8 : 4);
+  gd_extension.string_new_with_utf8_chars(res, c_string);
+  return res;
+}
+
+void destruct_string_name(GDExtensionStringNamePtr p) {
+  gd_extension_helper.destructor[GDEXTENSION_VARIANT_TYPE_STRING_NAME](p);
+  free(p);
+}
+
+void destruct_string(GDExtensionStringPtr p) {
+  gd_extension_helper.destructor[GDEXTENSION_VARIANT_TYPE_STRING](p);
+  free(p);
+}
+
+uint64_t now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+GDExtensionInt builtin_size(GDExtensionVariantType type, GDExtensionConstTypePtr p_value) {
+  GDExtensionInt res;
+  gd_extension_helper.size[type]((void *)p_value, NULL, &res, 0);
+  return res;
+}
+
+void builtin_resize(GDExtensionVariantType type, GDExtensionTypePtr p_value, GDExtensionInt p_size) {
+  GDExtensionConstTypePtr args[] = { &p_size };
+  GDExtensionInt error;
+  gd_extension_helper.resize[type](p_value, args, &error, 1);
+}
+
+// Returns a malloc-ed UTF-8 copy of a Godot String
+char *string_to_c_string(GDExtensionConstStringPtr p_string) {
+  GDExtensionInt length = gd_extension.string_to_utf8_chars(p_string, NULL, 0);
+  char *res = malloc(length + 1);
+  gd_extension.string_to_utf8_chars(p_string, res, length);
+  res[length] = '\0';
+  return res;
+}
+
+// `res://` and `user://` paths become OS paths through
+// ProjectSettings.globalize_path. Called once per file, so a Variant call is
+// good enough. Returns a malloc-ed UTF-8 string.
+//
+// NOTE: Files packed into a .pck have no OS path, mmap needs a real file.
+// Exported games keep bulk data next to the executable or in user://.
+char *path_to_c_string(GDExtensionConstStringPtr p_path) {
+  char *path = string_to_c_string(p_path);
+  if (strncmp(path, "res://", 6) != 0 && strncmp(path, "user://", 7) != 0) return path;
+  free(path);
+
+  void *project_settings_string_name = construct_string_name("ProjectSettings");
+  void *method_string_name = construct_string_name("globalize_path");
+  GDExtensionObjectPtr project_settings = gd_extension.global_get_singleton(project_settings_string_name);
+
+  uint8_t self[VARIANT_SIZE];
+  uint8_t argument[VARIANT_SIZE];
+  uint8_t ret[VARIANT_SIZE];
+  gd_extension_helper.wrap[GDEXTENSION_VARIANT_TYPE_OBJECT](self, &project_settings);
+  gd_extension_helper.wrap[GDEXTENSION_VARIANT_TYPE_STRING](argument, (void *)p_path);
+
+  const GDExtensionConstVariantPtr args[] = { argument };
+  GDExtensionCallError error;
+  gd_extension.variant_call(self, method_string_name, args, 1, ret, &error);
+
+  uint8_t global_path[8];
+  if (error.error == GDEXTENSION_CALL_OK && gd_extension.variant_get_type(ret) == GDEXTENSION_VARIANT_TYPE_STRING) {
+    gd_extension_helper.unwrap[GDEXTENSION_VARIANT_TYPE_STRING](global_path, ret);
+    path = string_to_c_string(global_path);
+    gd_extension_helper.destructor[GDEXTENSION_VARIANT_TYPE_STRING](global_path);
+  } else {
+    path = string_to_c_string(p_path);
+  }
+
+  gd_extension.variant_destroy(ret);
+  gd_extension.variant_destroy(argument);
+  gd_extension.variant_destroy(self);
+  destruct_string_name(project_settings_string_name);
+  destruct_string_name(method_string_name);
+  return path;
+}
+
+// ---------------------------------------------------------------------------
+// Bulk files
+// ---------------------------------------------------------------------------
+
+// File layout (host byte order, every chunk starts on a BULK_ALIGNMENT
+// boundary):
+//
+//   bulk_header_t
+//   bulk_chunk_t chunks[chunk_count]
+//   chunk data, one plain array per chunk
+//
+// A chunk holds exactly the bytes of one Packed*Array, so loading it is a
+// resize and a memcpy from the mapping into the array's data. Chunks record
+// their element size too, a file with Vector2s of doubles is refused by a
+// build with floats instead of being misread. Bump BULK_VERSION whenever the
+// layout changes.
+
+#define BULK_MAGIC ("GDBK")
+#define BULK_VERSION (1)
+#define BULK_ALIGNMENT (64)
+#define BULK_NAME_SIZE (24)
+
+typedef enum {
+  BULK_CHUNK_BYTES = 1,
+  BULK_CHUNK_FLOAT32 = 2,
+  BULK_CHUNK_VECTOR2 = 3,
+} bulk_chunk_type_t;
+
+typedef struct {
+  char magic[4];
+  uint32_t version;
+  uint32_t chunk_count;
+  uint32_t reserved;
+} bulk_header_t;
+
+typedef struct {
+  // NUL-terminated
+  char name[BULK_NAME_SIZE];
+  uint32_t type;
+  uint32_t element_size;
+  uint64_t offset;
+  uint64_t count;
+} bulk_chunk_t;
+
+// What the chunk types load into
+const struct {
+  GDExtensionVariantType array_type;
+  uint32_t element_size;
+} bulk_chunk_types[] = {
+  [BULK_CHUNK_BYTES] = { GDEXTENSION_VARIANT_TYPE_PACKED_BYTE_ARRAY, 1 },
+  [BULK_CHUNK_FLOAT32] = { GDEXTENSION_VARIANT_TYPE_PACKED_FLOAT32_ARRAY, 4 },
+  [BULK_CHUNK_VECTOR2] = { GDEXTENSION_VARIANT_TYPE_PACKED_VECTOR2_ARRAY, IS_GODOT_USING_LARGE_WORLD_COORDINATES ? 16 : 8 },
+};
+
+#define BULK_CHUNK_TYPE_COUNT (sizeof(bulk_chunk_types) / sizeof(bulk_chunk_types[0]))
+
+uint64_t bulk_align(uint64_t offset) {
+  return (offset + BULK_ALIGNMENT - 1) & ~(uint64_t)(BULK_ALIGNMENT - 1);
+}
+
+bulk_chunk_type_t bulk_chunk_type_for(GDExtensionVariantType array_type) {
+  for (uint32_t t = 1; t < BULK_CHUNK_TYPE_COUNT; t++) {
+    if (bulk_chunk_types[t].array_type == array_type) return t;
+  }
+  return 0;
+}
+
+// Returns GODOT_OK, GODOT_ERR_FILE_UNRECOGNIZED for something that isn't a
+// bulk file of this version, or GODOT_ERR_FILE_CORRUPT when anything points
+// outside the file.
+GDExtensionInt bulk_validate(const unsigned char *data, uint64_t file_size) {
+  if (file_size < sizeof(bulk_header_t)) return GODOT_ERR_FILE_UNRECOGNIZED;
+
+  const bulk_header_t *header = (const bulk_header_t *)data;
+  if (memcmp(header->magic, BULK_MAGIC, 4) != 0) return GODOT_ERR_FILE_UNRECOGNIZED;
+  if (header->version != BULK_VERSION) return GODOT_ERR_FILE_UNRECOGNIZED;
+  if (header->chunk_count > (file_size - sizeof(bulk_header_t)) / sizeof(bulk_chunk_t)) {
+    return GODOT_ERR_FILE_CORRUPT;
+  }
+
+  const bulk_chunk_t *chunks = (const bulk_chunk_t *)(data + sizeof(bulk_header_t));
+  for (uint32_t c = 0; c < header->chunk_count; c++) {
+    const bulk_chunk_t *chunk = &chunks[c];
+    if (memchr(chunk->name, '\0', BULK_NAME_SIZE) == NULL) return GODOT_ERR_FILE_CORRUPT;
+    if (chunk->type == 0 || chunk->type >= BULK_CHUNK_TYPE_COUNT) return GODOT_ERR_FILE_UNRECOGNIZED;
+    if (chunk->element_size != bulk_chunk_types[chunk->type].element_size) return GODOT_ERR_FILE_UNRECOGNIZED;
+    if (chunk->offset % BULK_ALIGNMENT != 0 || chunk->offset > file_size) return GODOT_ERR_FILE_CORRUPT;
+    if (chunk->count > (file_size - chunk->offset) / chunk->element_size) return GODOT_ERR_FILE_CORRUPT;
+  }
+
+  return GODOT_OK;
+}
+
+typedef struct {
+  const char *name;
+  bulk_chunk_type_t type;
+  const void *data;
+  uint64_t count;
+} bulk_source_t;
+
+bool write_all(int fd, const void *p_data, uint64_t p_size) {
+  const unsigned char *data = p_data;
+  while (p_size > 0) {
+    ssize_t n = write(fd, data, p_size);
+    if (n <= 0) return false;
+    data += n;
+    p_size -= n;
+  }
+  return true;
+}
+
+// Streams the chunks straight from their arrays, nothing is copied into a
+// second buffer. Written next to the destination and renamed, so a reader
+// never maps a half-written file.
+GDExtensionInt bulk_write(const char *path, const bulk_source_t *sources, uint32_t source_count) {
+  uint64_t table_size = sizeof(bulk_header_t) + (uint64_t)source_count * sizeof(bulk_chunk_t);
+  unsigned char *table = calloc(1, table_size);
+  if (table == NULL) return GODOT_ERR_OUT_OF_MEMORY;
+
+  bulk_header_t *header = (bulk_header_t *)table;
+  memcpy(header->magic, BULK_MAGIC, 4);
+  header->version = BULK_VERSION;
+  header->chunk_count = source_count;
+
+  bulk_chunk_t *chunks = (bulk_chunk_t *)(table + sizeof(bulk_header_t));
+  uint64_t offset = bulk_align(table_size);
+  for (uint32_t c = 0; c < source_count; c++) {
+    size_t name_length = strlen(sources[c].name);
+    if (name_length >= BULK_NAME_SIZE) {
+      fprintf(stderr, "BulkLoader: chunk name \"%s\" is longer than %d bytes\n", sources[c].name, BULK_NAME_SIZE - 1);
+      free(table);
+      return GODOT_ERR_INVALID_PARAMETER;
+    }
+    memcpy(chunks[c].name, sources[c].name, name_length);
+    chunks[c].type = sources[c].type;
+    chunks[c].element_size = bulk_chunk_types[sources[c].type].element_size;
+    chunks[c].offset = offset;
+    chunks[c].count = sources[c].count;
+    offset = bulk_align(offset + sources[c].count * chunks[c].element_size);
+  }
+
+  size_t path_length = strlen(path);
+  char *tmp_path = malloc(path_length + 5);
+  memcpy(tmp_path, path, path_length);
+  memcpy(tmp_path + path_length, ".tmp", 5);
+
+  GDExtensionInt res = GODOT_ERR_FILE_CANT_WRITE;
+  int fd = open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd >= 0) {
+    static const unsigned char padding[BULK_ALIGNMENT] = { 0 };
+    bool ok = write_all(fd, table, table_size);
+    uint64_t written = table_size;
+    for (uint32_t c = 0; ok && c < source_count; c++) {
+      ok = write_all(fd, padding, chunks[c].offset - written);
+      uint64_t size = chunks[c].count * chunks[c].element_size;
+      ok = ok && write_all(fd, sources[c].data, size);
+      written = chunks[c].offset + size;
+    }
+    close(fd);
+
+    if (ok && rename(tmp_path, path) == 0) {
+      res = GODOT_OK;
+    } else {
+      unlink(tmp_path);
+    }
+  }
+
+  if (res != GODOT_OK) {
+    fprintf(stderr, "BulkLoader: failed to write %s\n", path);
+  }
+
+  free(tmp_path);
+  free(table);
+  return res;
+}
+
+// ---------------------------------------------------------------------------
+// BulkLoader
+// ---------------------------------------------------------------------------
+
+// The whole file is mapped read-only for as long as it's open. Arrays are
+// filled straight from the mapping, the kernel reads the pages in as the copy
+// touches them. `prefetch` has a thread touch them first instead, so the
+// reading happens while the game does something else and the copies later
+// run at memory speed.
+//
+// NOTE: Truncating an open file under the mapping makes reads past the new
+// end crash. `save_file` writes a new file and renames it over the old one,
+// so a loader that still has the old one open keeps reading the old data.
+typedef struct {
+  GDExtensionObjectPtr godot_object;
+  // NULL when nothing is open
+  const unsigned char *data;
+  uint64_t size;
+  pthread_t prefetch_thread;
+  // Started and not joined yet
+  bool prefetch_started;
+  atomic_bool cancel_prefetch;
+  // Bytes from the start of the file the prefetch thread has read in
+  atomic_uint_least64_t prefetched;
+} loader_t;
+
+void *loader_prefetch(void *userdata) {
+  loader_t *loader = userdata;
+  const volatile unsigned char *data = loader->data;
+  uint64_t page_size = sysconf(_SC_PAGESIZE);
+
+  // Readahead for the whole file, then touch every page so we know when
+  // it's actually in
+  madvise((void *)loader->data, loader->size, MADV_WILLNEED);
+  unsigned char sum = 0;
+  for (uint64_t offset = 0; offset < loader->size; offset += PREFETCH_STEP) {
+    if (atomic_load_explicit(&loader->cancel_prefetch, memory_order_relaxed)) break;
+
+    uint64_t end = offset + PREFETCH_STEP < loader->size ? offset + PREFETCH_STEP : loader->size;
+    for (uint64_t page = offset; page < end; page += page_size) sum += data[page];
+    atomic_store_explicit(&loader->prefetched, end, memory_order_release);
+  }
+  (void)sum;
+  return NULL;
+}
+
+void loader_join_prefetch(loader_t *loader) {
+  if (!loader->prefetch_started) return;
+
+  atomic_store_explicit(&loader->cancel_prefetch, true, memory_order_relaxed);
+  pthread_join(loader->prefetch_thread, NULL);
+  loader->prefetch_started = false;
+}
+
+void loader_close(loader_t *loader) {
+  loader_join_prefetch(loader);
+  if (loader->data != NULL) munmap((void *)loader->data, loader->size);
+  loader->data = NULL;
+  loader->size = 0;
+  atomic_store_explicit(&loader->prefetched, 0, memory_order_relaxed);
+}
+
+GDExtensionInt loader_open(loader_t *loader, const char *path) {
+  loader_close(loader);
+
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    fprintf(stderr, "BulkLoader: can't open %s\n", path);
+    return GODOT_ERR_FILE_NOT_FOUND;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size == 0) {
+    fprintf(stderr, "BulkLoader: can't stat %s\n", path);
+    close(fd);
+    return GODOT_ERR_FILE_CANT_OPEN;
+  }
+
+  uint64_t file_size = st.st_size;
+  const unsigned char *data = mmap(NULL, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  // NOTE: The mapping stays valid after the descriptor is closed
+  close(fd);
+
+  if (data == MAP_FAILED) {
+    fprintf(stderr, "BulkLoader: can't mmap %s\n", path);
+    return GODOT_ERR_FILE_CANT_OPEN;
+  }
+
+  GDExtensionInt error = bulk_validate(data, file_size);
+  if (error != GODOT_OK) {
+    fprintf(stderr, "BulkLoader: %s is not a valid version %d bulk file\n", path, BULK_VERSION);
+    munmap((void *)data, file_size);
+    return error;
+  }
+
+  loader->data = data;
+  loader->size = file_size;
+  return GODOT_OK;
+}
+
+// Starts the prefetch thread, once per open file
+void loader_start_prefetch(loader_t *loader) {
+  if (loader->data == NULL || loader->prefetch_started) return;
+
+  atomic_store_explicit(&loader->cancel_prefetch, false, memory_order_relaxed);
+  atomic_store_explicit(&loader->prefetched, 0, memory_order_relaxed);
+  loader->prefetch_started = pthread_create(&loader->prefetch_thread, NULL, loader_prefetch, loader) == 0;
+}
+
+double loader_progress(const loader_t *loader) {
+  if (loader->data == NULL) return 0.0;
+  return (double)atomic_load_explicit(&loader->prefetched, memory_order_acquire) / loader->size;
+}
+
+uint32_t loader_chunk_count(const loader_t *loader) {
+  return loader->data != NULL ? ((const bulk_header_t *)loader->data)->chunk_count : 0;
+}
+
+const bulk_chunk_t *loader_chunk(const loader_t *loader, uint32_t index) {
+  return (const bulk_chunk_t *)(loader->data + sizeof(bulk_header_t)) + index;
+}
+
+// NULL when there's no chunk with that name
+const bulk_chunk_t *loader_find_chunk(const loader_t *loader, GDExtensionConstStringPtr p_name) {
+  char name[BULK_NAME_SIZE];
+  GDExtensionInt length = gd_extension.string_to_utf8_chars(p_name, NULL, 0);
+  if (length >= BULK_NAME_SIZE) return NULL;
+  gd_extension.string_to_utf8_chars(p_name, name, length);
+  name[length] = '\0';
+
+  uint32_t chunk_count = loader_chunk_count(loader);
+  for (uint32_t c = 0; c < chunk_count; c++) {
+    const bulk_chunk_t *chunk = loader_chunk(loader, c);
+    if (strcmp(chunk->name, name) == 0) return chunk;
+  }
+  return NULL;
+}
+
+void *packed_array_data(GDExtensionVariantType type, GDExtensionTypePtr p_array) {
+  switch (type) {
+    case GDEXTENSION_VARIANT_TYPE_PACKED_BYTE_ARRAY:
+      return gd_extension.packed_byte_array_operator_index(p_array, 0);
+    case GDEXTENSION_VARIANT_TYPE_PACKED_FLOAT32_ARRAY:
+      return gd_extension.packed_float32_array_operator_index(p_array, 0);
+    case GDEXTENSION_VARIANT_TYPE_PACKED_VECTOR2_ARRAY:
+      return gd_extension.packed_vector2_array_operator_index(p_array, 0);
+    default:
+      return NULL;
+  }
+}
+
+const void *packed_array_data_const(GDExtensionVariantType type, GDExtensionConstTypePtr p_array) {
+  switch (type) {
+    case GDEXTENSION_VARIANT_TYPE_PACKED_BYTE_ARRAY:
+      return gd_extension.packed_byte_array_operator_index_const(p_array, 0);
+    case GDEXTENSION_VARIANT_TYPE_PACKED_FLOAT32_ARRAY:
+      return gd_extension.packed_float32_array_operator_index_const(p_array, 0);
+    case GDEXTENSION_VARIANT_TYPE_PACKED_VECTOR2_ARRAY:
+      return gd_extension.packed_vector2_array_operator_index_const(p_array, 0);
+    default:
+      return NULL;
+  }
+}
+
+// Constructs `r_array` as a Packed*Array of `type` holding the chunk called
+// `p_name`. The array is resized once and filled with one memcpy. It's left
+// empty when the chunk is missing or holds another type.
+void
+loader_fill(
+  const loader_t *loader,
+  GDExtensionConstStringPtr p_name,
+  bulk_chunk_type_t type,
+  GDExtensionUninitializedTypePtr r_array
+) {
+  GDExtensionVariantType array_type = bulk_chunk_types[type].array_type;
+  gd_extension_helper.constructor[array_type](r_array, NULL);
+
+  const bulk_chunk_t *chunk = loader->data != NULL ? loader_find_chunk(loader, p_name) : NULL;
+  if (chunk == NULL || chunk->type != type) {
+    char *name = string_to_c_string(p_name);
+    fprintf(stderr, "BulkLoader: %s \"%s\"\n", chunk == NULL ? "no chunk called" : "wrong type for chunk", name);
+    free(name);
+    return;
+  }
+  if (chunk->count == 0) return;
+
+  builtin_resize(array_type, r_array, chunk->count);
+  memcpy(packed_array_data(array_type, r_array), loader->data + chunk->offset, chunk->count * chunk->element_size);
+}
+
+// Keys are chunk names and values are PackedByteArray, PackedFloat32Array or
+// PackedVector2Array
+GDExtensionInt loader_save(GDExtensionConstStringPtr p_path, GDExtensionConstTypePtr p_chunks) {
+  // keys() assigns into an existing Array
+  uint8_t keys[8];
+  gd_extension_helper.constructor[GDEXTENSION_VARIANT_TYPE_ARRAY](keys, NULL);
+  gd_extension_helper.builtin_method.dictionary_keys((void *)p_chunks, NULL, keys, 0);
+  GDExtensionInt count = builtin_size(GDEXTENSION_VARIANT_TYPE_ARRAY, keys);
+
+  bulk_source_t *sources = calloc(count > 0 ? count : 1, sizeof(bulk_source_t));
+  uint8_t (*arrays)[PACKED_ARRAY_SIZE] = calloc(count > 0 ? count : 1, PACKED_ARRAY_SIZE);
+  GDExtensionInt res = GODOT_OK;
+  GDExtensionInt filled = 0;
+
+  for (; filled < count; filled++) {
+    GDExtensionConstVariantPtr key = gd_extension.array_operator_index_const(keys, filled);
+    GDExtensionConstVariantPtr value = gd_extension.dictionary_operator_index_const(p_chunks, key);
+    GDExtensionVariantType array_type = gd_extension.variant_get_type(value);
+    bulk_chunk_type_t type = bulk_chunk_type_for(array_type);
+    if (gd_extension.variant_get_type(key) != GDEXTENSION_VARIANT_TYPE_STRING || type == 0) {
+      fprintf(stderr, "BulkLoader: save_file takes String keys and PackedByteArray, PackedFloat32Array or PackedVector2Array values\n");
+      res = GODOT_ERR_INVALID_PARAMETER;
+      break;
+    }
+
+    uint8_t name[8];
+    gd_extension_helper.unwrap[GDEXTENSION_VARIANT_TYPE_STRING](name, (void *)key);
+    sources[filled].name = string_to_c_string(name);
+    gd_extension_helper.destructor[GDEXTENSION_VARIANT_TYPE_STRING](name);
+
+    // A reference to the array, not a copy, it's only read from
+    gd_extension_helper.unwrap[array_type](arrays[filled], (void *)value);
+    sources[filled].type = type;
+    sources[filled].count = builtin_size(array_type, arrays[filled]);
+    sources[filled].data = sources[filled].count > 0 ? packed_array_data_const(array_type, arrays[filled]) : NULL;
+  }
+
+  if (res == GODOT_OK) {
+    char *path = path_to_c_string(p_path);
+    res = bulk_write(path, sources, (uint32_t)count);
+    free(path);
+  }
+
+  for (GDExtensionInt i = 0; i < filled; i++) {
+    free((void *)sources[i].name);
+    gd_extension_helper.destructor[bulk_chunk_types[sources[i].type].array_type](arrays[i]);
+  }
+  free(arrays);
+  free(sources);
+  gd_extension_helper.destructor[GDEXTENSION_VARIANT_TYPE_ARRAY](keys);
+  return res;
+}
+
+GDExtensionObjectPtr loader_init(void *userdata) {
+  loader_t *loader = malloc(sizeof(loader_t));
+
+  void *my_class_string_name = construct_string_name(LOADER_CLASS_NAME);
+  void *parent_class_string_name = construct_string_name(LOADER_CLASS_PARENT);
+
+  loader->godot_object = gd_extension.classdb_construct_object(parent_class_string_name);
+  loader->data = NULL;
+  loader->size = 0;
+  loader->prefetch_started = false;
+  atomic_init(&loader->cancel_prefetch, false);
+  atomic_init(&loader->prefetched, 0);
+  gd_extension.object_set_instance(loader->godot_object, my_class_string_name, loader);
+
+  destruct_string_name(my_class_string_name);
+  destruct_string_name(parent_class_string_name);
+
+  return loader->godot_object;
+}
+
+void loader_deinit(void *userdata, GDExtensionClassInstancePtr p_instance) {
+  if (p_instance == NULL) return;
+
+  loader_t *loader = p_instance;
+  loader_close(loader);
+  free(loader);
+}
+
+// ---------------------------------------------------------------------------
+// Methods
+// ---------------------------------------------------------------------------
+
+// Methods are written against ptrcall's typed pointers. A Variant call
+// unwraps the arguments into locals first. `r_ret` is uninitialized, the
+// ptrcall wrapper destructs the value Godot passes in before calling.
+typedef void (*loader_method_func_t)(loader_t *loader, const GDExtensionConstTypePtr *p_args, GDExtensionUninitializedTypePtr r_ret);
+
+void loader_method_open(loader_t *loader, const GDExtensionConstTypePtr *p_args, GDExtensionUninitializedTypePtr r_ret) {
+  char *path = path_to_c_string(p_args[0]);
+  *(GDExtensionInt *)r_ret = loader_open(loader, path);
+  free(path);
+}
+
+void loader_method_close(loader_t *loader, const GDExtensionConstTypePtr *p_args, GDExtensionUninitializedTypePtr r_ret) {
+  loader_close(loader);
+}
+
+void loader_method_prefetch(loader_t *loader, const GDExtensionConstTypePtr *p_args, GDExtensionUninitializedTypePtr r_ret) {
+  if (loader->data == NULL) {
+    *(GDExtensionInt *)r_ret = GODOT_ERR_UNCONFIGURED;
+    return;
+  }
+  loader_start_prefetch(loader);
+  *(GDExtensionInt *)r_ret = loader->prefetch_started ? GODOT_OK : GODOT_ERR_OUT_OF_MEMORY;
+}
+
+void loader_method_get_progress(loader_t *loader, const GDExtensionConstTypePtr *p_args, GDExtensionUninitializedTypePtr r_ret) {
+  *(double *)r_ret = loader_progress(loader);
+}
+
+void loader_method_get_chunk_count(loader_t *loader, const GDExtensionConstTypePtr *p_args, GDExtensionUninitializedTypePtr r_ret) {
+  *(GDExtensionInt *)r_ret = loader_chunk_count(loader);
+}
+
+void loader_method_get_chunk_name(loader_t *loader, const GDExtensionConstTypePtr *p_args, GDExtensionUninitializedTypePtr r_ret) {
+  GDExtensionInt index = *(const GDExtensionInt *)p_args[0];
+  if (index < 0 || index >= loader_chunk_count(loader)) {
+    gd_extension.string_new_with_utf8_chars_and_len(r_ret, "", 0);
+    return;
+  }
+  const bulk_chunk_t *chunk = loader_chunk(loader, index);
+  gd_extension.string_new_with_utf8_chars_and_len(r_ret, chunk->name, strlen(chunk->name));
+}
+
+void loader_method_get_chunk_size(loader_t *loader, const GDExtensionConstTypePtr *p_args, GDExtensionUninitializedTypePtr r_ret) {
+  const bulk_chunk_t *chunk = loader->data != NULL ? loader_find_chunk(loader, p_args[0]) : NULL;
+  *(GDExtensionInt *)r_ret = chunk != NULL ? (GDExtensionInt)chunk->count : -1;
+}
+
+void loader_method_get_byte_array(loader_t *loader, const GDExtensionConstTypePtr *p_args, GDExtensionUninitializedTypePtr r_ret) {
+  loader_fill(loader, p_args[0], BULK_CHUNK_BYTES, r_ret);
+}
+
+void loader_method_get_float32_array(loader_t *loader, const GDExtensionConstTypePtr *p_args, GDExtensionUninitializedTypePtr r_ret) {
+  loader_fill(loader, p_args[0], BULK_CHUNK_FLOAT32, r_ret);
+}
+
+void loader_method_get_vector2_array(loader_t *loader, const GDExtensionConstTypePtr *p_args, GDExtensionUninitializedTypePtr r_ret) {
+  loader_fill(loader, p_args[0], BULK_CHUNK_VECTOR2, r_ret);
+}
+
+void loader_method_save_file(loader_t *loader, const GDExtensionConstTypePtr *p_args, GDExtensionUninitializedTypePtr r_ret) {
+  *(GDExtensionInt *)r_ret = loader_save(p_args[0], p_args[1]);
+}
+
+typedef struct {
+  const char *name;
+  loader_method_func_t func;
+  GDExtensionClassMethodFlags flags;
+  // NIL for no return value
+  GDExtensionVariantType return_type;
+  int argument_count;
+  struct {
+    const char *name;
+    GDExtensionVariantType type;
+  } arguments[LOADER_MAX_ARGUMENTS];
+} loader_method_t;
+
+const loader_method_t loader_methods[] = {
+  {
+    .name = "open",
+    .func = loader_method_open,
+    .flags = GDEXTENSION_METHOD_FLAG_NORMAL,
+    .return_type = GDEXTENSION_VARIANT_TYPE_INT,
+    .argument_count = 1,
+    .arguments = { { "path", GDEXTENSION_VARIANT_TYPE_STRING } },
+  },
+  {
+    .name = "close",
+    .func = loader_method_close,
+    .flags = GDEXTENSION_METHOD_FLAG_NORMAL,
+    .return_type = GDEXTENSION_VARIANT_TYPE_NIL,
+    .argument_count = 0,
+  },
+  {
+    .name = "prefetch",
+    .func = loader_method_prefetch,
+    .flags = GDEXTENSION_METHOD_FLAG_NORMAL,
+    .return_type = GDEXTENSION_VARIANT_TYPE_INT,
+    .argument_count = 0,
+  },
+  {
+    .name = "get_progress",
+    .func = loader_method_get_progress,
+    .flags = GDEXTENSION_METHOD_FLAG_NORMAL | GDEXTENSION_METHOD_FLAG_CONST,
+    .return_type = GDEXTENSION_VARIANT_TYPE_FLOAT,
+    .argument_count = 0,
+  },
+  {
+    .name = "get_chunk_count",
+    .func = loader_method_get_chunk_count,
+    .flags = GDEXTENSION_METHOD_FLAG_NORMAL | GDEXTENSION_METHOD_FLAG_CONST,
+    .return_type = GDEXTENSION_VARIANT_TYPE_INT,
+    .argument_count = 0,
+  },
+  {
+    .name = "get_chunk_name",
+    .func = loader_method_get_chunk_name,
+    .flags = GDEXTENSION_METHOD_FLAG_NORMAL | GDEXTENSION_METHOD_FLAG_CONST,
+    .return_type = GDEXTENSION_VARIANT_TYPE_STRING,
+    .argument_count = 1,
+    .arguments = { { "index", GDEXTENSION_VARIANT_TYPE_INT } },
+  },
+  {
+    .name = "get_chunk_size",
+    .func = loader_method_get_chunk_size,
+    .flags = GDEXTENSION_METHOD_FLAG_NORMAL | GDEXTENSION_METHOD_FLAG_CONST,
+    .return_type = GDEXTENSION_VARIANT_TYPE_INT,
+    .argument_count = 1,
+    .arguments = { { "name", GDEXTENSION_VARIANT_TYPE_STRING } },
+  },
+  {
+    .name = "get_byte_array",
+    .func = loader_method_get_byte_array,
+    .flags = GDEXTENSION_METHOD_FLAG_NORMAL | GDEXTENSION_METHOD_FLAG_CONST,
+    .return_type = GDEXTENSION_VARIANT_TYPE_PACKED_BYTE_ARRAY,
+    .argument_count = 1,
+    .arguments = { { "name", GDEXTENSION_VARIANT_TYPE_STRING } },
+  },
+  {
+    .name = "get_float32_array",
+    .func = loader_method_get_float32_array,
+    .flags = GDEXTENSION_METHOD_FLAG_NORMAL | GDEXTENSION_METHOD_FLAG_CONST,
+    .return_type = GDEXTENSION_VARIANT_TYPE_PACKED_FLOAT32_ARRAY,
+    .argument_count = 1,
+    .arguments = { { "name", GDEXTENSION_VARIANT_TYPE_STRING } },
+  },
+  {
+    .name = "get_vector2_array",
+    .func = loader_method_get_vector2_array,
+    .flags = GDEXTENSION_METHOD_FLAG_NORMAL | GDEXTENSION_METHOD_FLAG_CONST,
+    .return_type = GDEXTENSION_VARIANT_TYPE_PACKED_VECTOR2_ARRAY,
+    .argument_count = 1,
+    .arguments = { { "name", GDEXTENSION_VARIANT_TYPE_STRING } },
+  },
+  {
+    .name = "save_file",
+    .func = loader_method_save_file,
+    .flags = GDEXTENSION_METHOD_FLAG_NORMAL | GDEXTENSION_METHOD_FLAG_STATIC,
+    .return_type = GDEXTENSION_VARIANT_TYPE_INT,
+    .argument_count = 2,
+    .arguments = {
+      { "path", GDEXTENSION_VARIANT_TYPE_STRING },
+      { "chunks", GDEXTENSION_VARIANT_TYPE_DICTIONARY },
+    },
+  },
+};
+
+#define LOADER_METHOD_COUNT (sizeof(loader_methods) / sizeof(loader_methods[0]))
+
+// Every type that goes in or out of the methods, plus the ones needed on the
+// way. Their wrap/unwrap/destructor functions are fetched on load.
+const GDExtensionVariantType loader_types[] = {
+  GDEXTENSION_VARIANT_TYPE_INT,
+  GDEXTENSION_VARIANT_TYPE_FLOAT,
+  GDEXTENSION_VARIANT_TYPE_STRING,
+  GDEXTENSION_VARIANT_TYPE_STRING_NAME,
+  GDEXTENSION_VARIANT_TYPE_OBJECT,
+  GDEXTENSION_VARIANT_TYPE_DICTIONARY,
+  GDEXTENSION_VARIANT_TYPE_ARRAY,
+  GDEXTENSION_VARIANT_TYPE_PACKED_BYTE_ARRAY,
+  GDEXTENSION_VARIANT_TYPE_PACKED_FLOAT32_ARRAY,
+  GDEXTENSION_VARIANT_TYPE_PACKED_VECTOR2_ARRAY,
+};
+
+// Ints and floats have no destructor
+void destruct_value(GDExtensionVariantType type, GDExtensionTypePtr p_value) {
+  if (gd_extension_helper.destructor[type] != NULL) gd_extension_helper.destructor[type](p_value);
+}
+
+void
+loader_method_call(
+  void *method_userdata,
+  GDExtensionClassInstancePtr p_instance,
+  const GDExtensionConstVariantPtr *p_args,
+  GDExtensionInt p_argument_count,
+  GDExtensionVariantPtr r_return,
+  GDExtensionCallError *r_error
+) {
+  const loader_method_t *method = method_userdata;
+  if (p_argument_count != method->argument_count) {
+    r_error->error = p_argument_count < method->argument_count
+      ? GDEXTENSION_CALL_ERROR_TOO_FEW_ARGUMENTS
+      : GDEXTENSION_CALL_ERROR_TOO_MANY_ARGUMENTS;
+    r_error->argument = 0;
+    r_error->expected = method->argument_count;
+    return;
+  }
+
+  for (int i = 0; i < method->argument_count; i++) {
+    GDExtensionVariantType type = method->arguments[i].type;
+    if (gd_extension.variant_get_type(p_args[i]) != type) {
+      r_error->error = GDEXTENSION_CALL_ERROR_INVALID_ARGUMENT;
+      r_error->argument = i;
+      r_error->expected = type;
+      return;
+    }
+  }
+
+  _Alignas(8) uint8_t arguments[LOADER_MAX_ARGUMENTS][VARIANT_SIZE];
+  GDExtensionConstTypePtr args[LOADER_MAX_ARGUMENTS];
+  for (int i = 0; i < method->argument_count; i++) {
+    gd_extension_helper.unwrap[method->arguments[i].type](arguments[i], (void *)p_args[i]);
+    args[i] = arguments[i];
+  }
+
+  r_error->error = GDEXTENSION_CALL_OK;
+  _Alignas(8) uint8_t ret[VARIANT_SIZE];
+  method->func(p_instance, args, ret);
+  if (method->return_type != GDEXTENSION_VARIANT_TYPE_NIL) {
+    gd_extension_helper.wrap[method->return_type](r_return, ret);
+    destruct_value(method->return_type, ret);
+  }
+
+  for (int i = 0; i < method->argument_count; i++) destruct_value(method->arguments[i].type, arguments[i]);
+}
+
+void
+loader_method_ptrcall(
+  void *method_userdata,
+  GDExtensionClassInstancePtr p_instance,
+  const GDExtensionConstTypePtr *p_args,
+  GDExtensionTypePtr r_ret
+) {
+  const loader_method_t *method = method_userdata;
+  // `r_ret` is already constructed
+  if (method->return_type != GDEXTENSION_VARIANT_TYPE_NIL) destruct_value(method->return_type, r_ret);
+  method->func(p_instance, p_args, r_ret);
+}
+
+GDExtensionPropertyInfo make_property_info(GDExtensionVariantType type, const char *name) {
+  GDExtensionPropertyInfo res = {
+    .type = type,
+    .name = construct_string_name(name),
+    .class_name = construct_string_name(""),
+    .hint = 0, // Corresponds to no hints
+    .hint_string = construct_string(""),
+    .usage = PROPERTY_USAGE_DEFAULT,
+  };
+  return res;
+}
+
+void destruct_property_info(GDExtensionPropertyInfo *p_info) {
+  destruct_string_name(p_info->name);
+  destruct_string_name(p_info->class_name);
+  destruct_string(p_info->hint_string);
+}
+
+GDExtensionClassMethodArgumentMetadata metadata_for(GDExtensionVariantType type) {
+  switch (type) {
+    case GDEXTENSION_VARIANT_TYPE_INT:
+      return GDEXTENSION_METHOD_ARGUMENT_METADATA_INT_IS_INT64;
+    case GDEXTENSION_VARIANT_TYPE_FLOAT:
+      return GDEXTENSION_METHOD_ARGUMENT_METADATA_REAL_IS_DOUBLE;
+    default:
+      return GDEXTENSION_METHOD_ARGUMENT_METADATA_NONE;
+  }
+}
+
+void register_loader_methods(GDExtensionConstStringNamePtr class_string_name) {
+  for (size_t m = 0; m < LOADER_METHOD_COUNT; m++) {
+    const loader_method_t *method = &loader_methods[m];
+    GDExtensionPropertyInfo arguments[LOADER_MAX_ARGUMENTS];
+    GDExtensionClassMethodArgumentMetadata arguments_metadata[LOADER_MAX_ARGUMENTS];
+    for (int i = 0; i < method->argument_count; i++) {
+      arguments[i] = make_property_info(method->arguments[i].type, method->arguments[i].name);
+      arguments_metadata[i] = metadata_for(method->arguments[i].type);
+    }
+    GDExtensionPropertyInfo return_value = make_property_info(method->return_type, "");
+
+    GDExtensionClassMethodInfo info = {
+      .name = construct_string_name(method->name),
+      .method_userdata = (void *)method,
+      .call_func = loader_method_call,
+      .ptrcall_func = loader_method_ptrcall,
+      .method_flags = method->flags,
+      .has_return_value = method->return_type != GDEXTENSION_VARIANT_TYPE_NIL,
+      .return_value_info = method->return_type != GDEXTENSION_VARIANT_TYPE_NIL ? &return_value : NULL,
+      .return_value_metadata = metadata_for(method->return_type),
+      .argument_count = method->argument_count,
+      .arguments_info = arguments,
+      .arguments_metadata = arguments_metadata,
+      .default_argument_count = 0,
+      .default_arguments = NULL,
+    };
+    gd_extension.classdb_register_extension_class_method(gd_extension_helper.misc.p_library,
+                                                         class_string_name,
+                                                         &info);
+
+    for (int i = 0; i < method->argument_count; i++) destruct_property_info(&arguments[i]);
+    destruct_property_info(&return_value);
+    destruct_string_name(info.name);
+  }
+}
+
+void register_loader_class() {
+  GDExtensionClassCreationInfo2 class_info = {
+    .is_virtual = false,
+    .is_abstract = false,
+    .is_exposed = true,
+    .set_func = NULL,
+    .get_func = NULL,
+    .get_property_list_func = NULL,
+    .free_property_list_func = NULL,
+    .property_can_revert_func = NULL,
+    .property_get_revert_func = NULL,
+    .validate_property_func = NULL,
+    .notification_func = NULL,
+    .to_string_func = NULL,
+    .reference_func = NULL,
+    .unreference_func = NULL,
+    .create_instance_func = loader_init,
+    .free_instance_func = loader_deinit,
+    .recreate_instance_func = NULL,
+    .get_virtual_func = NULL,
+    .get_virtual_call_data_func = NULL,
+    .call_virtual_with_data_func = NULL,
+    .get_rid_func = NULL,
+    .class_userdata = NULL,
+  };
+
+  void *my_class_string_name = construct_string_name(LOADER_CLASS_NAME);
+  void *parent_class_string_name = construct_string_name(LOADER_CLASS_PARENT);
+
+  gd_extension.classdb_register_extension_class2(gd_extension_helper.misc.p_library,
+                                                 my_class_string_name,
+                                                 parent_class_string_name,
+                                                 &class_info);
+  register_loader_methods(my_class_string_name);
+
+  destruct_string_name(my_class_string_name);
+  destruct_string_name(parent_class_string_name);
+}
+
+// ---------------------------------------------------------------------------
+// Load test
+// ---------------------------------------------------------------------------
+
+// Drops the file from the page cache, so the next load reads from disk.
+// Files on tmpfs stay in memory no matter what.
+void evict_from_page_cache(const char *path) {
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) return;
+  fdatasync(fd);
+  posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+  close(fd);
+}
+
+// Loads all three chunks, returns the nanoseconds it took or 0 if a chunk
+// didn't match what was written
+uint64_t
+load_test_chunks(
+  loader_t *loader,
+  const float *p_heights,
+  const float *p_points,
+  const uint8_t *p_grid
+) {
+  void *heights_name = construct_string("heights");
+  void *points_name = construct_string("points");
+  void *grid_name = construct_string("grid");
+  uint8_t heights[PACKED_ARRAY_SIZE];
+  uint8_t points[PACKED_ARRAY_SIZE];
+  uint8_t grid[PACKED_ARRAY_SIZE];
+
+  uint64_t start = now_ns();
+  loader_fill(loader, heights_name, BULK_CHUNK_FLOAT32, heights);
+  loader_fill(loader, points_name, BULK_CHUNK_VECTOR2, points);
+  loader_fill(loader, grid_name, BULK_CHUNK_BYTES, grid);
+  uint64_t res = now_ns() - start;
+
+  bool ok = builtin_size(GDEXTENSION_VARIANT_TYPE_PACKED_FLOAT32_ARRAY, heights) == TEST_HEIGHTS
+    && builtin_size(GDEXTENSION_VARIANT_TYPE_PACKED_VECTOR2_ARRAY, points) == TEST_POINTS
+    && builtin_size(GDEXTENSION_VARIANT_TYPE_PACKED_BYTE_ARRAY, grid) == TEST_GRID;
+  ok = ok
+    && memcmp(gd_extension.packed_float32_array_operator_index_const(heights, 0), p_heights, TEST_HEIGHTS * sizeof(float)) == 0
+    && memcmp(gd_extension.packed_vector2_array_operator_index_const(points, 0), p_points, TEST_POINTS * 2 * sizeof(float)) == 0
+    && memcmp(gd_extension.packed_byte_array_operator_index_const(grid, 0), p_grid, TEST_GRID) == 0;
+
+  gd_extension_helper.destructor[GDEXTENSION_VARIANT_TYPE_PACKED_FLOAT32_ARRAY](heights);
+  gd_extension_helper.destructor[GDEXTENSION_VARIANT_TYPE_PACKED_VECTOR2_ARRAY](points);
+  gd_extension_helper.destructor[GDEXTENSION_VARIANT_TYPE_PACKED_BYTE_ARRAY](grid);
+  destruct_string(heights_name);
+  destruct_string(points_name);
+  destruct_string(grid_name);
+  return ok ? (res > 0 ? res : 1) : 0;
+}
+
+// Writes a file like baked level data (a height field, a point cloud and a
+// navigation grid), loads it cold, then cold with prefetching, and checks
+// that damaged copies are refused
+void print_load_results() {
+  const char *tmp_dir = getenv("TMPDIR") != NULL ? getenv("TMPDIR") : "/tmp";
+  char path[1024];
+  snprintf(path, sizeof(path), "%s/bulk_loader_test_%d.gdbk", tmp_dir, (int)getpid());
+
+  float *heights = malloc(TEST_HEIGHTS * sizeof(float));
+  float *points = malloc(TEST_POINTS * 2 * sizeof(float));
+  uint8_t *grid = malloc(TEST_GRID);
+  for (uint32_t i = 0; i < TEST_HEIGHTS; i++) heights[i] = (float)(i % 4093) * 0.25f;
+  for (uint32_t i = 0; i < TEST_POINTS * 2; i++) points[i] = (float)i * 0.5f;
+  for (uint32_t i = 0; i < TEST_GRID; i++) grid[i] = (uint8_t)(i * 2654435761u >> 24);
+
+  const bulk_source_t sources[] = {
+    { "heights", BULK_CHUNK_FLOAT32, heights, TEST_HEIGHTS },
+    { "points", BULK_CHUNK_VECTOR2, points, TEST_POINTS },
+    { "grid", BULK_CHUNK_BYTES, grid, TEST_GRID },
+  };
+  if (bulk_write(path, sources, 3) != GODOT_OK) {
+    free(heights);
+    free(points);
+    free(grid);
+    return;
+  }
+  double megabytes = (TEST_HEIGHTS * 4.0 + TEST_POINTS * 8.0 + TEST_GRID) / (1024.0 * 1024.0);
+
+  loader_t loader = { .data = NULL, .size = 0, .prefetch_started = false };
+  atomic_init(&loader.cancel_prefetch, false);
+  atomic_init(&loader.prefetched, 0);
+
+  evict_from_page_cache(path);
+  uint64_t cold_ns = 0;
+  if (loader_open(&loader, path) == GODOT_OK) {
+    cold_ns = load_test_chunks(&loader, heights, points, grid);
+  }
+  loader_close(&loader);
+
+  evict_from_page_cache(path);
+  uint64_t prefetch_ns = 0;
+  uint64_t wait_ns = 0;
+  uint64_t prefetched_ns = 0;
+  if (loader_open(&loader, path) == GODOT_OK) {
+    uint64_t start = now_ns();
+    loader_start_prefetch(&loader);
+    // A loading screen would poll this once a frame
+    double progress_seen[4] = { -1, -1, -1, -1 };
+    int progress_count = 0;
+    while (loader.prefetch_started && loader_progress(&loader) < 1.0) {
+      double progress = loader_progress(&loader);
+      if (progress_count < 4 && progress >= progress_count * 0.25) progress_seen[progress_count++] = progress;
+      struct timespec frame = { 0, 1000000 };
+      nanosleep(&frame, NULL);
+    }
+    wait_ns = now_ns() - start;
+    prefetched_ns = load_test_chunks(&loader, heights, points, grid);
+    prefetch_ns = now_ns() - start;
+    printf("prefetch progress seen:");
+    for (int i = 0; i < progress_count; i++) printf(" %.0f%%", progress_seen[i] * 100.0);
+    printf(" 100%%\n");
+  }
+  loader_close(&loader);
+
+  printf("%.0f MB cold:          %8.1f ms (%s)\n",
+         megabytes, cold_ns / 1e6, cold_ns != 0 ? "ok" : "WRONG");
+  printf("%.0f MB with prefetch: %8.1f ms, %.1f ms of it in the background, copies %.1f ms (%s, %.0f MB/s)\n",
+         megabytes, prefetch_ns / 1e6, wait_ns / 1e6, prefetched_ns / 1e6,
+         prefetched_ns != 0 ? "ok" : "WRONG",
+         prefetched_ns != 0 ? megabytes / (prefetched_ns / 1e9) : 0.0);
+
+  // Damaged copies: cut off in the middle of the last chunk, and with the
+  // magic overwritten
+  bool truncated_refused = truncate(path, sizeof(bulk_header_t) + 3 * sizeof(bulk_chunk_t) + 1024) == 0
+    && loader_open(&loader, path) == GODOT_ERR_FILE_CORRUPT;
+  loader_close(&loader);
+  int fd = open(path, O_WRONLY);
+  bool bad_magic_refused = fd >= 0 && pwrite(fd, "NOPE", 4, 0) == 4;
+  if (fd >= 0) close(fd);
+  bad_magic_refused = bad_magic_refused && loader_open(&loader, path) == GODOT_ERR_FILE_UNRECOGNIZED;
+  loader_close(&loader);
+  printf("truncated file %s, bad magic %s\n",
+         truncated_refused ? "refused" : "ACCEPTED",
+         bad_magic_refused ? "refused" : "ACCEPTED");
+
+  unlink(path);
+  free(heights);
+  free(points);
+  free(grid);
+}
+
+void godot_initialize(void *userdata, GDExtensionInitializationLevel p_level) {
+  if (p_level == GDEXTENSION_INITIALIZATION_SCENE) {
+    void *size_string_name = construct_string_name("size");
+    void *resize_string_name = construct_string_name("resize");
+    void *keys_string_name = construct_string_name("keys");
+    const GDExtensionVariantType sized_types[] = {
+      GDEXTENSION_VARIANT_TYPE_ARRAY,
+      GDEXTENSION_VARIANT_TYPE_PACKED_BYTE_ARRAY,
+      GDEXTENSION_VARIANT_TYPE_PACKED_FLOAT32_ARRAY,
+      GDEXTENSION_VARIANT_TYPE_PACKED_VECTOR2_ARRAY,
+    };
+    for (size_t i = 0; i < sizeof(sized_types) / sizeof(sized_types[0]); i++) {
+      GDExtensionVariantType type = sized_types[i];
+      gd_extension_helper.size[type] = gd_extension.variant_get_ptr_builtin_method(type, size_string_name, SIZE_HASH);
+      gd_extension_helper.resize[type] = gd_extension.variant_get_ptr_builtin_method(type, resize_string_name, RESIZE_HASH);
+    }
+    gd_extension_helper.builtin_method.dictionary_keys
+      = gd_extension.variant_get_ptr_builtin_method(GDEXTENSION_VARIANT_TYPE_DICTIONARY,
+                                                    keys_string_name,
+                                                    DICTIONARY_KEYS_HASH);
+    destruct_string_name(size_string_name);
+    destruct_string_name(resize_string_name);
+    destruct_string_name(keys_string_name);
+
+    register_loader_class();
+
+    print_load_results();
+    return;
+  }
+}
+
+void godot_deinitialize(void *userdata, GDExtensionInitializationLevel p_level) {
+}
+
+GDExtensionBool
+godot_entry(
+  GDExtensionInterfaceGetProcAddress p_get_proc_address,
+  const GDExtensionClassLibraryPtr p_library,
+  GDExtensionInitialization *r_initialization
+) {
+  r_initialization->minimum_initialization_level = GDEXTENSION_INITIALIZATION_SCENE;
+  r_initialization->userdata = NULL;
+  r_initialization->initialize = godot_initialize;
+  r_initialization->deinitialize = godot_deinitialize;
+
+  STORE_GD_EXTENSION(classdb_construct_object);
+  STORE_GD_EXTENSION(classdb_register_extension_class2);
+  STORE_GD_EXTENSION(classdb_register_extension_class_method);
+  STORE_GD_EXTENSION(string_name_new_with_utf8_chars);
+  STORE_GD_EXTENSION(string_new_with_utf8_chars);
+  STORE_GD_EXTENSION(string_new_with_utf8_chars_and_len);
+  STORE_GD_EXTENSION(string_to_utf8_chars);
+  STORE_GD_EXTENSION(object_set_instance);
+  STORE_GD_EXTENSION(global_get_singleton);
+  STORE_GD_EXTENSION(variant_get_ptr_destructor);
+  STORE_GD_EXTENSION(variant_get_ptr_constructor);
+  STORE_GD_EXTENSION(variant_get_ptr_builtin_method);
+  STORE_GD_EXTENSION(get_variant_from_type_constructor);
+  STORE_GD_EXTENSION(get_variant_to_type_constructor);
+  STORE_GD_EXTENSION(variant_get_type);
+  STORE_GD_EXTENSION(variant_call);
+  STORE_GD_EXTENSION(variant_destroy);
+  STORE_GD_EXTENSION(array_operator_index_const);
+  STORE_GD_EXTENSION(dictionary_operator_index_const);
+  STORE_GD_EXTENSION(packed_byte_array_operator_index);
+  STORE_GD_EXTENSION(packed_byte_array_operator_index_const);
+  STORE_GD_EXTENSION(packed_float32_array_operator_index);
+  STORE_GD_EXTENSION(packed_float32_array_operator_index_const);
+  STORE_GD_EXTENSION(packed_vector2_array_operator_index);
+  STORE_GD_EXTENSION(packed_vector2_array_operator_index_const);
+
+  gd_extension_helper.misc.p_library = p_library;
+
+  for (size_t i = 0; i < sizeof(loader_types) / sizeof(loader_types[0]); i++) {
+    GDExtensionVariantType type = loader_types[i];
+    // Ints, floats and Objects have no destructor to call
+    if (type != GDEXTENSION_VARIANT_TYPE_INT && type != GDEXTENSION_VARIANT_TYPE_FLOAT && type != GDEXTENSION_VARIANT_TYPE_OBJECT) {
+      gd_extension_helper.destructor[type] = gd_extension.variant_get_ptr_destructor(type);
+    }
+    gd_extension_helper.constructor[type] = gd_extension.variant_get_ptr_constructor(type, 0);
+    gd_extension_helper.wrap[type] = gd_extension.get_variant_from_type_constructor(type);
+    gd_extension_helper.unwrap[type] = gd_extension.get_variant_to_type_constructor(type);
+  }
+
+  return true;
+}
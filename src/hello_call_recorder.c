@@ -0,0 +1,772 @@
+#include "../godot-headers/gdextension_interface.h"
+#include "../stub-host/interface_log.h"
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+
+#define STORE_GD_EXTENSION(str_name) gd_extension.str_name = (void *)p_get_proc_address(#str_name);
+#define IS_GODOT_64_BIT (true)
+#define IS_GODOT_USING_LARGE_WORLD_COORDINATES (false)
+#define VARIANT_SIZE (IS_GODOT_USING_LARGE_WORLD_COORDINATES ? 40 : 24)
+#define STRING_NAME_SIZE (IS_GODOT_64_BIT ? 8 : 4)
+#define MY_CUSTOM_CLASS_NAME ("MyCustomNode")
+#define MY_CUSTOM_CLASS_PARENT ("Sprite2D")
+
+
+struct {
+  GDExtensionInterfaceClassdbConstructObject classdb_construct_object;
+  GDExtensionInterfaceClassdbRegisterExtensionClass2 classdb_register_extension_class2;
+  GDExtensionInterfaceClassdbGetMethodBind classdb_get_method_bind;
+  GDExtensionInterfaceStringNameNewWithUtf8Chars string_name_new_with_utf8_chars;
+  GDExtensionInterfaceStringNewWithUtf8Chars string_new_with_utf8_chars;
+  GDExtensionInterfaceObjectSetInstance object_set_instance;
+  GDExtensionInterfaceVariantGetPtrDestructor variant_get_ptr_destructor;
+  GDExtensionInterfaceVariantEvaluate variant_evaluate;
+  GDExtensionInterfaceGetVariantFromTypeConstructor get_variant_from_type_constructor;
+  GDExtensionInterfaceGetVariantToTypeConstructor get_variant_to_type_constructor;
+  GDExtensionInterfaceVariantGetPtrOperatorEvaluator variant_get_ptr_operator_evaluator;
+  GDExtensionInterfaceVariantGetType variant_get_type;
+  GDExtensionInterfaceObjectMethodBindPtrcall object_method_bind_ptrcall;
+} gd_extension;
+
+struct {
+  struct {
+    GDExtensionPtrDestructor string_name;
+    GDExtensionPtrDestructor string;
+  } destructor;
+  struct {
+    GDExtensionVariantFromTypeConstructorFunc type_double;
+  } wrap;
+  struct {
+    GDExtensionTypeFromVariantConstructorFunc type_double;
+    GDExtensionTypeFromVariantConstructorFunc type_int;
+  } unwrap;
+  struct {
+    GDExtensionStringNamePtr amplitude;
+    GDExtensionStringNamePtr frequency;
+    GDExtensionStringNamePtr _process;
+    GDExtensionStringNamePtr position;
+  } string_name;
+  struct {
+    GDExtensionClassLibraryPtr p_library;
+    GDExtensionPtrOperatorEvaluator string_name_eq_op;
+    GDExtensionMethodBindPtr node2d_set_position;
+  } misc;
+} gd_extension_helper;
+
+#if (IS_GODOT_USING_LARGE_WORLD_COORDINATES)
+typedef struct {
+  double x;
+  double y;
+} GDVector2;
+#else
+typedef struct {
+  float x;
+  float y;
+} GDVector2;
+#endif
+
+GDExtensionStringNamePtr construct_string_name(const char *c_string) {
+  void *res = malloc(IS_GODOT_64_BIT ? 8 : 4);
+  gd_extension.string_name_new_with_utf8_chars(res, c_string);
+  return res;
+}
+
+GDExtensionStringPtr construct_string(const char *c_string) {
+  void *res = malloc(IS_GODOT_64_BIT ? 8 : 4);
+  gd_extension.string_new_with_utf8_chars(res, c_string);
+  return res;
+}
+
+void destruct_string_name(GDExtensionStringNamePtr p) {
+  gd_extension_helper.destructor.string_name(p);
+}
+
+void destruct_string(GDExtensionStringPtr p) {
+  gd_extension_helper.destructor.string(p);
+}
+
+// ---------------------------------------------------------------------------
+// Interface call recorder
+// ---------------------------------------------------------------------------
+
+// Every interface function we fetch goes through `recorder_get_proc_address`.
+// For the functions listed in `stub-host/interface_log.h` it hands out a
+// wrapper that appends a record and then calls the real function. Functions
+// that return function pointers (destructors, operator evaluators, Variant
+// converters) get their results wrapped as well, using a fixed number of
+// trampoline slots per kind.
+//
+// NOTE: Recording is not thread-safe, it assumes that all calls come from the
+// main thread, which is the case for this example.
+
+#define RECORDER_SLOT_COUNT (8)
+#define RECORDER_SLOTS(X) X(0) X(1) X(2) X(3) X(4) X(5) X(6) X(7)
+#define RECORDER_DEFAULT_PATH ("interface_calls.gdxr")
+
+struct {
+  GDExtensionInterfaceGetProcAddress real_get_proc_address;
+  struct {
+    GDExtensionInterfaceClassdbConstructObject classdb_construct_object;
+    GDExtensionInterfaceClassdbRegisterExtensionClass2 classdb_register_extension_class2;
+    GDExtensionInterfaceClassdbGetMethodBind classdb_get_method_bind;
+    GDExtensionInterfaceStringNameNewWithUtf8Chars string_name_new_with_utf8_chars;
+    GDExtensionInterfaceStringNewWithUtf8Chars string_new_with_utf8_chars;
+    GDExtensionInterfaceObjectSetInstance object_set_instance;
+    GDExtensionInterfaceVariantGetPtrDestructor variant_get_ptr_destructor;
+    GDExtensionInterfaceGetVariantFromTypeConstructor get_variant_from_type_constructor;
+    GDExtensionInterfaceGetVariantToTypeConstructor get_variant_to_type_constructor;
+    GDExtensionInterfaceVariantGetPtrOperatorEvaluator variant_get_ptr_operator_evaluator;
+    GDExtensionInterfaceVariantGetType variant_get_type;
+    GDExtensionInterfaceObjectMethodBindPtrcall object_method_bind_ptrcall;
+    GDExtensionInterfaceGlobalGetSingleton global_get_singleton;
+  } real;
+  struct {
+    GDExtensionPtrDestructor destructor[RECORDER_SLOT_COUNT];
+    GDExtensionVariantFromTypeConstructorFunc variant_from_type[RECORDER_SLOT_COUNT];
+    GDExtensionTypeFromVariantConstructorFunc variant_to_type[RECORDER_SLOT_COUNT];
+    GDExtensionPtrOperatorEvaluator operator_evaluator[RECORDER_SLOT_COUNT];
+  } slots;
+  interface_log_record_t *records;
+  size_t record_count;
+  size_t record_capacity;
+  uint64_t start_ns;
+  uint64_t last_process_frame;
+  GDExtensionObjectPtr engine_singleton;
+  GDExtensionMethodBindPtr engine_get_process_frames;
+} recorder;
+
+uint64_t recorder_now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+void recorder_record(uint16_t function_id, uint32_t arg_bytes, const void *object) {
+  if (recorder.record_count == recorder.record_capacity) {
+    size_t capacity = recorder.record_capacity == 0 ? 4096 : recorder.record_capacity * 2;
+    interface_log_record_t *records = realloc(recorder.records, capacity * sizeof(interface_log_record_t));
+    if (records == NULL) return; // Drop the record rather than crash the game
+    recorder.records = records;
+    recorder.record_capacity = capacity;
+  }
+
+  interface_log_record_t *record = &recorder.records[recorder.record_count++];
+  record->function_id = function_id;
+  record->reserved = 0;
+  record->arg_bytes = arg_bytes;
+  record->timestamp_ns = recorder_now_ns() - recorder.start_ns;
+  record->object = (uint64_t)(uintptr_t)object;
+}
+
+// Called at the start of every `_process`. Several nodes share a frame, so we
+// only emit a marker when the engine's frame counter moves.
+void recorder_mark_frame() {
+  uint64_t frame;
+  recorder.real.object_method_bind_ptrcall(recorder.engine_get_process_frames,
+                                           recorder.engine_singleton,
+                                           NULL,
+                                           &frame);
+
+  if (frame != recorder.last_process_frame) {
+    recorder.last_process_frame = frame;
+    recorder_record(INTERFACE_LOG_FRAME_MARKER, 0, NULL);
+  }
+}
+
+void recorder_write(const char *path) {
+  FILE *f = fopen(path, "wb");
+  if (f == NULL) {
+    fprintf(stderr, "recorder: can't open %s\n", path);
+    return;
+  }
+
+  interface_log_header_t header = {
+    .version = INTERFACE_LOG_VERSION,
+    .function_count = INTERFACE_LOG_FUNCTION_COUNT,
+    .record_size = sizeof(interface_log_record_t),
+  };
+  memcpy(header.magic, INTERFACE_LOG_MAGIC, 4);
+  fwrite(&header, sizeof(header), 1, f);
+
+#define WRITE_FUNCTION_NAME(name) {                       \
+    char buffer[INTERFACE_LOG_NAME_SIZE] = { 0 };         \
+    strncpy(buffer, #name, INTERFACE_LOG_NAME_SIZE - 1);  \
+    fwrite(buffer, INTERFACE_LOG_NAME_SIZE, 1, f);        \
+  }
+  INTERFACE_LOG_FUNCTIONS(WRITE_FUNCTION_NAME)
+#undef WRITE_FUNCTION_NAME
+
+  fwrite(recorder.records, sizeof(interface_log_record_t), recorder.record_count, f);
+  fclose(f);
+
+  printf("recorder: wrote %zu records to %s\n", recorder.record_count, path);
+}
+
+// Wrappers around plain interface functions
+
+GDExtensionObjectPtr
+recorded_classdb_construct_object(GDExtensionConstStringNamePtr p_classname) {
+  recorder_record(INTERFACE_LOG_FN_classdb_construct_object, STRING_NAME_SIZE, NULL);
+  return recorder.real.classdb_construct_object(p_classname);
+}
+
+void
+recorded_classdb_register_extension_class2(
+  GDExtensionClassLibraryPtr p_library,
+  GDExtensionConstStringNamePtr p_class_name,
+  GDExtensionConstStringNamePtr p_parent_class_name,
+  const GDExtensionClassCreationInfo2 *p_extension_funcs
+) {
+  recorder_record(INTERFACE_LOG_FN_classdb_register_extension_class2,
+                  2 * STRING_NAME_SIZE + sizeof(GDExtensionClassCreationInfo2),
+                  NULL);
+  recorder.real.classdb_register_extension_class2(p_library,
+                                                  p_class_name,
+                                                  p_parent_class_name,
+                                                  p_extension_funcs);
+}
+
+GDExtensionMethodBindPtr
+recorded_classdb_get_method_bind(
+  GDExtensionConstStringNamePtr p_classname,
+  GDExtensionConstStringNamePtr p_methodname,
+  GDExtensionInt p_hash
+) {
+  recorder_record(INTERFACE_LOG_FN_classdb_get_method_bind,
+                  2 * STRING_NAME_SIZE + sizeof(GDExtensionInt),
+                  NULL);
+  return recorder.real.classdb_get_method_bind(p_classname, p_methodname, p_hash);
+}
+
+void
+recorded_string_name_new_with_utf8_chars(GDExtensionUninitializedStringNamePtr r_dest, const char *p_contents) {
+  recorder_record(INTERFACE_LOG_FN_string_name_new_with_utf8_chars, strlen(p_contents), NULL);
+  recorder.real.string_name_new_with_utf8_chars(r_dest, p_contents);
+}
+
+void
+recorded_string_new_with_utf8_chars(GDExtensionUninitializedStringPtr r_dest, const char *p_contents) {
+  recorder_record(INTERFACE_LOG_FN_string_new_with_utf8_chars, strlen(p_contents), NULL);
+  recorder.real.string_new_with_utf8_chars(r_dest, p_contents);
+}
+
+void
+recorded_object_set_instance(
+  GDExtensionObjectPtr p_o,
+  GDExtensionConstStringNamePtr p_classname,
+  GDExtensionClassInstancePtr p_instance
+) {
+  recorder_record(INTERFACE_LOG_FN_object_set_instance, STRING_NAME_SIZE, p_o);
+  recorder.real.object_set_instance(p_o, p_classname, p_instance);
+}
+
+GDExtensionVariantType recorded_variant_get_type(GDExtensionConstVariantPtr p_self) {
+  recorder_record(INTERFACE_LOG_FN_variant_get_type, VARIANT_SIZE, NULL);
+  return recorder.real.variant_get_type(p_self);
+}
+
+void
+recorded_object_method_bind_ptrcall(
+  GDExtensionMethodBindPtr p_method_bind,
+  GDExtensionObjectPtr p_instance,
+  const GDExtensionConstTypePtr *p_args,
+  GDExtensionTypePtr r_ret
+) {
+  recorder_record(INTERFACE_LOG_FN_object_method_bind_ptrcall, 0, p_instance);
+  recorder.real.object_method_bind_ptrcall(p_method_bind, p_instance, p_args, r_ret);
+}
+
+// Trampolines for returned function pointers. Each slot remembers one real
+// function, the getters below hand out the matching trampoline.
+
+#define DEFINE_DESTRUCTOR_SLOT(i)                                       \
+  void destructor_slot_##i(GDExtensionTypePtr p_base) {                 \
+    recorder_record(INTERFACE_LOG_FN_destructor_call, 0, NULL);         \
+    recorder.slots.destructor[i](p_base);                               \
+  }
+RECORDER_SLOTS(DEFINE_DESTRUCTOR_SLOT)
+
+#define DEFINE_VARIANT_FROM_TYPE_SLOT(i)                                \
+  void variant_from_type_slot_##i(GDExtensionUninitializedVariantPtr r_dest, GDExtensionTypePtr p_src) { \
+    recorder_record(INTERFACE_LOG_FN_variant_from_type_call, VARIANT_SIZE, NULL); \
+    recorder.slots.variant_from_type[i](r_dest, p_src);                 \
+  }
+RECORDER_SLOTS(DEFINE_VARIANT_FROM_TYPE_SLOT)
+
+#define DEFINE_VARIANT_TO_TYPE_SLOT(i)                                  \
+  void variant_to_type_slot_##i(GDExtensionUninitializedTypePtr r_dest, GDExtensionVariantPtr p_src) { \
+    recorder_record(INTERFACE_LOG_FN_variant_to_type_call, VARIANT_SIZE, NULL); \
+    recorder.slots.variant_to_type[i](r_dest, p_src);                   \
+  }
+RECORDER_SLOTS(DEFINE_VARIANT_TO_TYPE_SLOT)
+
+#define DEFINE_OPERATOR_EVALUATOR_SLOT(i)                               \
+  void operator_evaluator_slot_##i(GDExtensionConstTypePtr p_left, GDExtensionConstTypePtr p_right, GDExtensionTypePtr r_result) { \
+    recorder_record(INTERFACE_LOG_FN_operator_evaluator_call, 0, NULL); \
+    recorder.slots.operator_evaluator[i](p_left, p_right, r_result);    \
+  }
+RECORDER_SLOTS(DEFINE_OPERATOR_EVALUATOR_SLOT)
+
+#define SLOT_ENTRY_DESTRUCTOR(i) destructor_slot_##i,
+#define SLOT_ENTRY_VARIANT_FROM_TYPE(i) variant_from_type_slot_##i,
+#define SLOT_ENTRY_VARIANT_TO_TYPE(i) variant_to_type_slot_##i,
+#define SLOT_ENTRY_OPERATOR_EVALUATOR(i) operator_evaluator_slot_##i,
+
+const GDExtensionPtrDestructor destructor_slots[] = { RECORDER_SLOTS(SLOT_ENTRY_DESTRUCTOR) };
+const GDExtensionVariantFromTypeConstructorFunc variant_from_type_slots[] = { RECORDER_SLOTS(SLOT_ENTRY_VARIANT_FROM_TYPE) };
+const GDExtensionTypeFromVariantConstructorFunc variant_to_type_slots[] = { RECORDER_SLOTS(SLOT_ENTRY_VARIANT_TO_TYPE) };
+const GDExtensionPtrOperatorEvaluator operator_evaluator_slots[] = { RECORDER_SLOTS(SLOT_ENTRY_OPERATOR_EVALUATOR) };
+
+// Finds (or takes) the slot for `real` in `reals` and returns its index, -1 if
+// all slots are taken.
+int recorder_claim_slot(void **reals, void *real) {
+  for (int i = 0; i < RECORDER_SLOT_COUNT; i++) {
+    if (reals[i] == real) return i;
+    if (reals[i] == NULL) {
+      reals[i] = real;
+      return i;
+    }
+  }
+  fprintf(stderr, "recorder: out of slots, calls won't be recorded\n");
+  return -1;
+}
+
+GDExtensionPtrDestructor recorded_variant_get_ptr_destructor(GDExtensionVariantType p_type) {
+  recorder_record(INTERFACE_LOG_FN_variant_get_ptr_destructor, 0, NULL);
+  GDExtensionPtrDestructor real = recorder.real.variant_get_ptr_destructor(p_type);
+  if (real == NULL) return NULL;
+
+  int slot = recorder_claim_slot((void **)recorder.slots.destructor, real);
+  return slot < 0 ? real : destructor_slots[slot];
+}
+
+GDExtensionVariantFromTypeConstructorFunc
+recorded_get_variant_from_type_constructor(GDExtensionVariantType p_type) {
+  recorder_record(INTERFACE_LOG_FN_get_variant_from_type_constructor, 0, NULL);
+  GDExtensionVariantFromTypeConstructorFunc real = recorder.real.get_variant_from_type_constructor(p_type);
+  if (real == NULL) return NULL;
+
+  int slot = recorder_claim_slot((void **)recorder.slots.variant_from_type, real);
+  return slot < 0 ? real : variant_from_type_slots[slot];
+}
+
+GDExtensionTypeFromVariantConstructorFunc
+recorded_get_variant_to_type_constructor(GDExtensionVariantType p_type) {
+  recorder_record(INTERFACE_LOG_FN_get_variant_to_type_constructor, 0, NULL);
+  GDExtensionTypeFromVariantConstructorFunc real = recorder.real.get_variant_to_type_constructor(p_type);
+  if (real == NULL) return NULL;
+
+  int slot = recorder_claim_slot((void **)recorder.slots.variant_to_type, real);
+  return slot < 0 ? real : variant_to_type_slots[slot];
+}
+
+GDExtensionPtrOperatorEvaluator
+recorded_variant_get_ptr_operator_evaluator(
+  GDExtensionVariantOperator p_operator,
+  GDExtensionVariantType p_type_a,
+  GDExtensionVariantType p_type_b
+) {
+  recorder_record(INTERFACE_LOG_FN_variant_get_ptr_operator_evaluator, 0, NULL);
+  GDExtensionPtrOperatorEvaluator real
+    = recorder.real.variant_get_ptr_operator_evaluator(p_operator, p_type_a, p_type_b);
+  if (real == NULL) return NULL;
+
+  int slot = recorder_claim_slot((void **)recorder.slots.operator_evaluator, real);
+  return slot < 0 ? real : operator_evaluator_slots[slot];
+}
+
+#define RECORDER_WRAP(name) { #name, (GDExtensionInterfaceFunctionPtr)recorded_##name },
+
+struct {
+  const char *name;
+  GDExtensionInterfaceFunctionPtr wrapper;
+} recorder_wrappers[] = {
+  RECORDER_WRAP(classdb_construct_object)
+  RECORDER_WRAP(classdb_register_extension_class2)
+  RECORDER_WRAP(classdb_get_method_bind)
+  RECORDER_WRAP(string_name_new_with_utf8_chars)
+  RECORDER_WRAP(string_new_with_utf8_chars)
+  RECORDER_WRAP(object_set_instance)
+  RECORDER_WRAP(variant_get_ptr_destructor)
+  RECORDER_WRAP(get_variant_from_type_constructor)
+  RECORDER_WRAP(get_variant_to_type_constructor)
+  RECORDER_WRAP(variant_get_ptr_operator_evaluator)
+  RECORDER_WRAP(variant_get_type)
+  RECORDER_WRAP(object_method_bind_ptrcall)
+};
+
+GDExtensionInterfaceFunctionPtr recorder_get_proc_address(const char *p_function_name) {
+  size_t n = sizeof(recorder_wrappers) / sizeof(*recorder_wrappers);
+  for (size_t i = 0; i < n; i++) {
+    if (strcmp(recorder_wrappers[i].name, p_function_name) == 0) {
+      return recorder_wrappers[i].wrapper;
+    }
+  }
+  return recorder.real_get_proc_address(p_function_name);
+}
+
+#define RECORDER_STORE_REAL(name) recorder.real.name = (void *)p_get_proc_address(#name);
+
+void recorder_init(GDExtensionInterfaceGetProcAddress p_get_proc_address) {
+  recorder.real_get_proc_address = p_get_proc_address;
+  RECORDER_STORE_REAL(classdb_construct_object);
+  RECORDER_STORE_REAL(classdb_register_extension_class2);
+  RECORDER_STORE_REAL(classdb_get_method_bind);
+  RECORDER_STORE_REAL(string_name_new_with_utf8_chars);
+  RECORDER_STORE_REAL(string_new_with_utf8_chars);
+  RECORDER_STORE_REAL(object_set_instance);
+  RECORDER_STORE_REAL(variant_get_ptr_destructor);
+  RECORDER_STORE_REAL(get_variant_from_type_constructor);
+  RECORDER_STORE_REAL(get_variant_to_type_constructor);
+  RECORDER_STORE_REAL(variant_get_ptr_operator_evaluator);
+  RECORDER_STORE_REAL(variant_get_type);
+  RECORDER_STORE_REAL(object_method_bind_ptrcall);
+  RECORDER_STORE_REAL(global_get_singleton);
+  recorder.start_ns = recorder_now_ns();
+}
+
+// Needs ClassDB, so it's called during GDEXTENSION_INITIALIZATION_SCENE. These
+// calls go to the real functions and don't show up in the log.
+void recorder_init_frame_counter() {
+  void *engine_string_name = construct_string_name("Engine");
+  void *get_process_frames_string_name = construct_string_name("get_process_frames");
+
+  recorder.engine_singleton = recorder.real.global_get_singleton(engine_string_name);
+  recorder.engine_get_process_frames
+    = recorder.real.classdb_get_method_bind(engine_string_name,
+                                            get_process_frames_string_name,
+                                            3905245786);
+
+  destruct_string_name(engine_string_name);
+  destruct_string_name(get_process_frames_string_name);
+}
+
+typedef struct {
+  GDExtensionObjectPtr godot_object;
+  double time_elapsed;
+  struct {
+    double amplitude;
+    double frequency;
+  } prop_state;
+} my_custom_class_t;
+
+struct {
+  const char *name;
+  const GDExtensionVariantType type;
+} my_custom_class_props[] = {
+  {
+    .name = "frequency",
+    .type = GDEXTENSION_VARIANT_TYPE_FLOAT,
+  },
+  {
+    .name = "amplitude",
+    .type = GDEXTENSION_VARIANT_TYPE_FLOAT,
+  }
+};
+
+const GDExtensionPropertyInfo *
+my_custom_class_get_property_list(
+  GDExtensionClassInstancePtr p_instance,
+  uint32_t *r_count
+) {
+  size_t n = sizeof(my_custom_class_props) / sizeof(*my_custom_class_props);
+  *r_count = n;
+
+  GDExtensionPropertyInfo *res = malloc(n * sizeof(GDExtensionPropertyInfo));
+
+  for (size_t i = 0; i < n; i++) {
+    res[i].type = my_custom_class_props[i].type;
+    res[i].name = construct_string_name(my_custom_class_props[i].name);
+    res[i].class_name = construct_string_name(MY_CUSTOM_CLASS_NAME);
+    res[i].hint = 0; // Corresponds to no hints
+    res[i].hint_string = construct_string("");
+    res[i].usage = 6; // Corresponds to default usage flags
+  }
+
+  return res;
+}
+
+void
+my_custom_class_free_property_list(
+  GDExtensionClassInstancePtr p_instance,
+  const GDExtensionPropertyInfo *p_list
+) {
+  size_t n = sizeof(my_custom_class_props) / sizeof(*my_custom_class_props);
+
+  for (size_t i = 0; i < n; i++) {
+    destruct_string_name((void*)p_list[i].name);
+    destruct_string((void*)p_list[i].hint_string);
+    destruct_string_name((void*)p_list[i].class_name);
+  }
+
+  free((void*)p_list);
+}
+
+GDExtensionObjectPtr my_custom_class_init(void *userdata) {
+  my_custom_class_t *my_instance = malloc(sizeof(my_custom_class_t));
+
+  void *my_class_string_name = construct_string_name(MY_CUSTOM_CLASS_NAME);
+  void *parent_class_string_name = construct_string_name(MY_CUSTOM_CLASS_PARENT);
+
+  my_instance->godot_object = gd_extension.classdb_construct_object(parent_class_string_name);
+  my_instance->time_elapsed = 0.0;
+  my_instance->prop_state.amplitude = 1.23;
+  my_instance->prop_state.frequency = 2.45;
+  gd_extension.object_set_instance(my_instance->godot_object, my_class_string_name, my_instance);
+
+  destruct_string_name(my_class_string_name);
+  destruct_string_name(parent_class_string_name);
+
+  printf("Hey, instancing is done!\n");
+
+  return my_instance->godot_object;
+}
+
+void my_custom_class_deinit(void *userdata, GDExtensionClassInstancePtr p_instance) {
+  if (p_instance == NULL) return;
+
+  my_custom_class_t *my_instance = p_instance;
+  free(my_instance);
+
+  printf("my_custom_class is going down, goodbye world!\n");
+}
+
+bool string_name_eq(const void *a, const void *b) {
+  GDExtensionBool res;
+  gd_extension_helper.misc.string_name_eq_op(a, b, &res);
+  return res;
+}
+
+// GDScript passes `node.amplitude = 2` as an int, so ints are numbers too.
+// Kept by hand instead of `util/variant_unwrap.h`, whose init would fetch
+// an unwrap function per type and run out of recorder slots.
+bool unwrap_number(double *r_value, GDExtensionConstVariantPtr p_value) {
+  switch (gd_extension.variant_get_type(p_value)) {
+    case GDEXTENSION_VARIANT_TYPE_FLOAT:
+      gd_extension_helper.unwrap.type_double(r_value, (void *)p_value);
+      return true;
+    case GDEXTENSION_VARIANT_TYPE_INT: {
+      GDExtensionInt value;
+      gd_extension_helper.unwrap.type_int(&value, (void *)p_value);
+      *r_value = (double)value;
+      return true;
+    }
+    default:
+      return false;
+  }
+}
+
+GDExtensionBool
+my_custom_class_set_func(
+  GDExtensionClassInstancePtr p_instance,
+  GDExtensionConstStringNamePtr p_name,
+  GDExtensionConstVariantPtr p_value
+) {
+  my_custom_class_t *my_instance = p_instance;
+
+  if (string_name_eq(p_name, gd_extension_helper.string_name.frequency)) {
+    return unwrap_number(&my_instance->prop_state.frequency, p_value);
+  }
+
+  if (string_name_eq(p_name, gd_extension_helper.string_name.amplitude)) {
+    return unwrap_number(&my_instance->prop_state.amplitude, p_value);
+  }
+
+  return false;
+}
+
+GDExtensionBool
+my_custom_class_get_func(
+  GDExtensionClassInstancePtr p_instance,
+  GDExtensionConstStringNamePtr p_name,
+  GDExtensionVariantPtr r_ret
+) {
+  my_custom_class_t *my_instance = p_instance;
+
+  if (string_name_eq(p_name, gd_extension_helper.string_name.frequency)) {
+    gd_extension_helper.wrap.type_double(r_ret, &(my_instance->prop_state.frequency));
+    return true;
+  }
+
+  if (string_name_eq(p_name, gd_extension_helper.string_name.amplitude)) {
+    gd_extension_helper.wrap.type_double(r_ret, &(my_instance->prop_state.amplitude));
+    return true;
+  }
+
+  return false;
+}
+
+void
+my_custom_class__process_override(
+   GDExtensionClassInstancePtr p_instance,
+   const GDExtensionConstTypePtr *p_args,
+   GDExtensionTypePtr r_ret
+) {
+  recorder_mark_frame();
+
+  my_custom_class_t *my_instance = p_instance;
+  my_instance->time_elapsed += *((double*)(p_args[0]));
+
+  double t = my_instance->time_elapsed;
+  double A = my_instance->prop_state.amplitude;
+  double w = my_instance->prop_state.frequency;
+
+  const GDVector2 new_position = {
+    .x = 0,
+    .y = A * sin(w * t),
+  };
+
+  GDExtensionConstTypePtr args[] = { &new_position };
+
+  gd_extension.object_method_bind_ptrcall(gd_extension_helper.misc.node2d_set_position,
+                                          my_instance->godot_object,
+                                          args,
+                                          NULL);
+
+  r_ret = NULL;
+}
+
+GDExtensionClassCallVirtual
+my_custom_class_get_virtual(
+   void *p_class_userdata,
+   GDExtensionConstStringNamePtr p_name
+) {
+  if (string_name_eq(p_name, gd_extension_helper.string_name._process)) {
+    return my_custom_class__process_override;
+  }
+  return NULL;
+}
+
+// NOTE: We can only call this when Node has been loaded in ClassDB (during
+// GDEXTENSION_INITIALIZATION_SCENE)
+void register_my_custom_class() {
+  GDExtensionClassCreationInfo2 class_info = {
+    .is_virtual = false,
+    .is_abstract = false,
+    .is_exposed = true,
+    .set_func = my_custom_class_set_func,
+    .get_func = my_custom_class_get_func,
+    .get_property_list_func = my_custom_class_get_property_list,
+    .free_property_list_func = my_custom_class_free_property_list,
+    .property_can_revert_func = NULL,
+    .property_get_revert_func = NULL,
+    .validate_property_func = NULL,
+    .notification_func = NULL,
+    .to_string_func = NULL,
+    .reference_func = NULL,
+    .unreference_func = NULL,
+    .create_instance_func = my_custom_class_init,
+    .free_instance_func = my_custom_class_deinit,
+    .recreate_instance_func = NULL,
+    .get_virtual_func = my_custom_class_get_virtual,
+    .get_virtual_call_data_func = NULL,
+    .call_virtual_with_data_func = NULL,
+    .get_rid_func = NULL,
+    .class_userdata = NULL,
+  };
+
+  void *my_class_string_name = construct_string_name(MY_CUSTOM_CLASS_NAME);
+  void *parent_class_string_name = construct_string_name(MY_CUSTOM_CLASS_PARENT);
+
+  gd_extension.classdb_register_extension_class2(gd_extension_helper.misc.p_library,
+                                                 my_class_string_name,
+                                                 parent_class_string_name,
+                                                 &class_info);
+
+  destruct_string_name(my_class_string_name);
+  destruct_string_name(parent_class_string_name);
+}
+
+void godot_initialize(void *userdata, GDExtensionInitializationLevel p_level) {
+  if (p_level == GDEXTENSION_INITIALIZATION_SCENE) {
+    gd_extension_helper.string_name.amplitude = construct_string_name("amplitude");
+    gd_extension_helper.string_name.frequency = construct_string_name("frequency");
+    gd_extension_helper.string_name._process = construct_string_name("_process");
+    gd_extension_helper.string_name.position = construct_string_name("position");
+
+    void *node2d_string_name = construct_string_name("Node2D");
+    void *set_position_string_name = construct_string_name("set_position");
+
+    gd_extension_helper.misc.node2d_set_position
+      = gd_extension.classdb_get_method_bind(node2d_string_name,
+                                             set_position_string_name,
+                                             743155724);
+
+    destruct_string_name(node2d_string_name);
+    destruct_string_name(set_position_string_name);
+
+    recorder_init_frame_counter();
+    register_my_custom_class();
+    return;
+  }
+}
+
+void godot_deinitialize(void *userdata, GDExtensionInitializationLevel p_level) {
+  if (p_level == GDEXTENSION_INITIALIZATION_SCENE) {
+    destruct_string_name(gd_extension_helper.string_name.amplitude);
+    destruct_string_name(gd_extension_helper.string_name.frequency);
+    destruct_string_name(gd_extension_helper.string_name._process);
+    destruct_string_name(gd_extension_helper.string_name.position);
+
+    const char *path = getenv("GDEXT_INTERFACE_LOG");
+    recorder_write(path != NULL ? path : RECORDER_DEFAULT_PATH);
+    free(recorder.records);
+    recorder.records = NULL;
+  }
+}
+
+GDExtensionBool
+godot_entry(
+  GDExtensionInterfaceGetProcAddress p_get_proc_address,
+  const GDExtensionClassLibraryPtr p_library,
+  GDExtensionInitialization *r_initialization
+) {
+  r_initialization->minimum_initialization_level = GDEXTENSION_INITIALIZATION_SCENE;
+  r_initialization->userdata = NULL;
+  r_initialization->initialize = godot_initialize;
+  r_initialization->deinitialize = godot_deinitialize;
+
+  // From here on every function we fetch is the recording version
+  recorder_init(p_get_proc_address);
+  p_get_proc_address = recorder_get_proc_address;
+
+  STORE_GD_EXTENSION(classdb_construct_object);
+  STORE_GD_EXTENSION(classdb_register_extension_class2);
+  STORE_GD_EXTENSION(classdb_get_method_bind);
+  STORE_GD_EXTENSION(string_name_new_with_utf8_chars);
+  STORE_GD_EXTENSION(string_new_with_utf8_chars);
+  STORE_GD_EXTENSION(object_set_instance);
+  STORE_GD_EXTENSION(variant_get_ptr_destructor);
+  STORE_GD_EXTENSION(variant_evaluate);
+  STORE_GD_EXTENSION(get_variant_from_type_constructor);
+  STORE_GD_EXTENSION(get_variant_to_type_constructor);
+  STORE_GD_EXTENSION(variant_get_ptr_operator_evaluator);
+  STORE_GD_EXTENSION(variant_get_type);
+  STORE_GD_EXTENSION(object_method_bind_ptrcall);
+
+  gd_extension_helper.wrap.type_double
+    = gd_extension.get_variant_from_type_constructor(GDEXTENSION_VARIANT_TYPE_FLOAT);
+
+  gd_extension_helper.unwrap.type_double
+    = gd_extension.get_variant_to_type_constructor(GDEXTENSION_VARIANT_TYPE_FLOAT);
+  gd_extension_helper.unwrap.type_int
+    = gd_extension.get_variant_to_type_constructor(GDEXTENSION_VARIANT_TYPE_INT);
+
+  gd_extension_helper.misc.p_library = p_library;
+  gd_extension_helper.misc.string_name_eq_op
+    = gd_extension.variant_get_ptr_operator_evaluator(GDEXTENSION_VARIANT_OP_EQUAL,
+                                                      GDEXTENSION_VARIANT_TYPE_STRING_NAME,
+                                                      GDEXTENSION_VARIANT_TYPE_STRING_NAME);
+
+  gd_extension_helper.destructor.string_name
+    = gd_extension.variant_get_ptr_destructor(GDEXTENSION_VARIANT_TYPE_STRING_NAME);
+  gd_extension_helper.destructor.string
+    = gd_extension.variant_get_ptr_destructor(GDEXTENSION_VARIANT_TYPE_STRING);
+
+  return true;
+}
@@ -0,0 +1,319 @@
+#include "../godot-headers/gdextension_interface.h"
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define STORE_GD_EXTENSION(str_name) gd_extension.str_name = (void *)p_get_proc_address(#str_name);
+#define IS_GODOT_64_BIT (true)
+#define IS_GODOT_USING_LARGE_WORLD_COORDINATES (false)
+#define VARIANT_SIZE (IS_GODOT_USING_LARGE_WORLD_COORDINATES ? 40 : 24)
+#define SPAWN_COUNT (10000)
+#define CONFIG_ROUNDS (10000)
+#define ARRAY_RESIZE_HASH (848867239)
+
+#include "../util/gd_container.h"
+
+struct {
+  GDExtensionInterfaceStringNameNewWithUtf8Chars string_name_new_with_utf8_chars;
+  GDExtensionInterfaceVariantGetPtrDestructor variant_get_ptr_destructor;
+  GDExtensionInterfaceVariantGetPtrConstructor variant_get_ptr_constructor;
+  GDExtensionInterfaceVariantGetPtrBuiltinMethod variant_get_ptr_builtin_method;
+  GDExtensionInterfaceVariantDestroy variant_destroy;
+  GDExtensionInterfaceVariantCall variant_call;
+  GDExtensionInterfaceGetVariantFromTypeConstructor get_variant_from_type_constructor;
+  GDExtensionInterfaceArrayOperatorIndex array_operator_index;
+  GDExtensionInterfaceArrayOperatorIndexConst array_operator_index_const;
+  GDExtensionInterfaceDictionaryOperatorIndex dictionary_operator_index;
+} gd_extension;
+
+struct {
+  struct {
+    GDExtensionPtrDestructor string_name;
+    GDExtensionPtrDestructor array;
+    GDExtensionPtrDestructor dictionary;
+  } destructor;
+  struct {
+    GDExtensionPtrConstructor array;
+    GDExtensionPtrConstructor dictionary;
+  } constructor;
+  struct {
+    GDExtensionPtrBuiltInMethod array_resize;
+  } builtin_method;
+  struct {
+    GDExtensionVariantFromTypeConstructorFunc type_int;
+    GDExtensionVariantFromTypeConstructorFunc type_double;
+    GDExtensionVariantFromTypeConstructorFunc array;
+    GDExtensionVariantFromTypeConstructorFunc dictionary;
+  } wrap;
+  struct {
+    GDExtensionStringNamePtr get;
+  } string_name;
+} gd_extension_helper;
+
+// What a game would read from a config Dictionary every frame. Ints and
+// floats are mixed, like GDScript writes them.
+static const struct {
+  const char *name;
+  double value;
+  bool is_int;
+} config_entries[] = {
+  { "speed", 320.5, false },
+  { "health", 100, true },
+  { "armor", 0.25, false },
+  { "spawn_rate", 1.5, false },
+  { "gravity", 980, true },
+  { "jump_height", 64.75, false },
+  { "friction", 0.8, false },
+  { "max_enemies", 32, true },
+};
+
+#define CONFIG_COUNT (sizeof(config_entries) / sizeof(config_entries[0]))
+
+gd_dictionary_key_t config_keys[CONFIG_COUNT];
+
+GDExtensionStringNamePtr construct_string_name(const char *c_string) {
+  void *res = malloc(IS_GODOT_64_BIT ? 8 : 4);
+  gd_extension.string_name_new_with_utf8_chars(res, c_string);
+  return res;
+}
+
+void destruct_string_name(GDExtensionStringNamePtr p) {
+  gd_extension_helper.destructor.string_name(p);
+  free(p);
+}
+
+uint64_t now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// Writes a number over the nil Variant a new Dictionary entry or a resized
+// Array starts with, nil has nothing to destroy
+void write_number(GDExtensionVariantPtr r_variant, double p_value, bool p_is_int) {
+  if (p_is_int) {
+    GDExtensionInt value = (GDExtensionInt)p_value;
+    gd_extension_helper.wrap.type_int(r_variant, &value);
+  } else {
+    gd_extension_helper.wrap.type_double(r_variant, &p_value);
+  }
+}
+
+void make_config(GDExtensionUninitializedTypePtr r_config) {
+  gd_extension_helper.constructor.dictionary(r_config, NULL);
+  for (size_t i = 0; i < CONFIG_COUNT; i++) {
+    // The non-const index inserts the key
+    GDExtensionVariantPtr value = gd_extension.dictionary_operator_index(r_config, config_keys[i].variant);
+    write_number(value, config_entries[i].value, config_entries[i].is_int);
+  }
+}
+
+// Every other spawn weight is an int
+void make_spawn_table(GDExtensionUninitializedTypePtr r_table) {
+  gd_extension_helper.constructor.array(r_table, NULL);
+  GDExtensionInt size = SPAWN_COUNT;
+  GDExtensionConstTypePtr resize_args[] = { &size };
+  GDExtensionInt resize_result;
+  gd_extension_helper.builtin_method.array_resize(r_table, resize_args, &resize_result, 1);
+  for (int i = 0; i < SPAWN_COUNT; i++) {
+    write_number(gd_extension.array_operator_index(r_table, i), i % 100 + (i & 1 ? 0 : 0.5), i & 1);
+  }
+}
+
+// The way to read a container without these helpers: box the index or key,
+// call `get` by name, unwrap the copy that comes back
+bool read_with_call(GDExtensionVariantPtr p_container, GDExtensionConstVariantPtr p_key, double *r_value) {
+  uint8_t res[VARIANT_SIZE];
+  GDExtensionCallError error;
+  GDExtensionConstVariantPtr args[] = { p_key };
+  gd_extension.variant_call(p_container, gd_extension_helper.string_name.get, args, 1, res, &error);
+  bool ok = error.error == GDEXTENSION_CALL_OK && variant_unwrap_float(res, r_value);
+  gd_extension.variant_destroy(res);
+  return ok;
+}
+
+void print_config_benchmark() {
+  uint8_t config[GD_BUILTIN_SIZE_DICTIONARY];
+  make_config(config);
+  uint8_t config_variant[VARIANT_SIZE];
+  gd_extension_helper.wrap.dictionary(config_variant, config);
+
+  double expected = 0;
+  for (size_t i = 0; i < CONFIG_COUNT; i++) expected += config_entries[i].value;
+  expected *= CONFIG_ROUNDS;
+  int total = CONFIG_ROUNDS * CONFIG_COUNT;
+
+  double call_sum = 0;
+  uint64_t start = now_ns();
+  for (int round = 0; round < CONFIG_ROUNDS; round++) {
+    for (size_t i = 0; i < CONFIG_COUNT; i++) {
+      double value;
+      if (read_with_call(config_variant, config_keys[i].variant, &value)) call_sum += value;
+    }
+  }
+  uint64_t call_ns = now_ns() - start;
+
+  double get_sum = 0;
+  start = now_ns();
+  for (int round = 0; round < CONFIG_ROUNDS; round++) {
+    for (size_t i = 0; i < CONFIG_COUNT; i++) {
+      double value;
+      GDExtensionConstVariantPtr entry = gd_dictionary_get(config, config_keys[i].variant);
+      if (entry != NULL && variant_unwrap_float(entry, &value)) get_sum += value;
+    }
+  }
+  uint64_t get_ns = now_ns() - start;
+
+  double lookup_sum = 0;
+  start = now_ns();
+  gd_dictionary_lookup_t lookup;
+  bool lookup_built = gd_dictionary_lookup_build(&lookup, config);
+  if (lookup_built) {
+    for (int round = 0; round < CONFIG_ROUNDS; round++) {
+      for (size_t i = 0; i < CONFIG_COUNT; i++) {
+        double value;
+        if (gd_dictionary_lookup_get_float(&lookup, &config_keys[i], &value)) lookup_sum += value;
+      }
+    }
+    gd_dictionary_lookup_destroy(&lookup);
+  }
+  uint64_t lookup_ns = now_ns() - start;
+
+  gd_dictionary_key_t missing;
+  gd_dictionary_key_new(&missing, "no_such_key");
+  bool missing_ok = gd_dictionary_get(config, missing.variant) == NULL;
+  if (gd_dictionary_lookup_build(&lookup, config)) {
+    missing_ok = missing_ok && gd_dictionary_lookup_get(&lookup, &missing) == NULL;
+    gd_dictionary_lookup_destroy(&lookup);
+  } else {
+    lookup_built = false;
+  }
+  gd_dictionary_key_destroy(&missing);
+
+  printf("config lookup: variant_call %.1f ns (%s), gd_dictionary_get %.1f ns (%s), prepared lookup %.1f ns (%s, build included), missing keys %s\n",
+         (double)call_ns / total, call_sum == expected ? "ok" : "WRONG",
+         (double)get_ns / total, get_sum == expected ? "ok" : "WRONG",
+         (double)lookup_ns / total, !lookup_built ? "out of memory" : lookup_sum == expected ? "ok" : "WRONG",
+         missing_ok ? "ok" : "WRONG");
+
+  gd_extension.variant_destroy(config_variant);
+  gd_extension_helper.destructor.dictionary(config);
+}
+
+void print_spawn_table_benchmark() {
+  uint8_t table[GD_BUILTIN_SIZE_ARRAY];
+  make_spawn_table(table);
+  uint8_t table_variant[VARIANT_SIZE];
+  gd_extension_helper.wrap.array(table_variant, table);
+
+  double expected = 0;
+  for (int i = 0; i < SPAWN_COUNT; i++) expected += i % 100 + (i & 1 ? 0 : 0.5);
+
+  double call_sum = 0;
+  uint64_t start = now_ns();
+  for (int i = 0; i < SPAWN_COUNT; i++) {
+    uint8_t index[VARIANT_SIZE];
+    GDExtensionInt value_index = i;
+    gd_extension_helper.wrap.type_int(index, &value_index);
+    double value;
+    if (read_with_call(table_variant, index, &value)) call_sum += value;
+  }
+  uint64_t call_ns = now_ns() - start;
+
+  double index_sum = 0;
+  start = now_ns();
+  for (int i = 0; i < SPAWN_COUNT; i++) {
+    double value;
+    if (variant_unwrap_float(gd_extension.array_operator_index_const(table, i), &value)) index_sum += value;
+  }
+  uint64_t index_ns = now_ns() - start;
+
+  double view_sum = 0;
+  start = now_ns();
+  double *weights = malloc(SPAWN_COUNT * sizeof(double));
+  gd_array_view_t view = gd_array_view(table);
+  int64_t converted = gd_array_view_to_floats(view, weights);
+  for (int64_t i = 0; i < converted; i++) view_sum += weights[i];
+  uint64_t view_ns = now_ns() - start;
+  free(weights);
+
+  printf("spawn table of %d: variant_call %.1f ns, array_operator_index_const %.1f ns, view %.1f ns per element (%s)\n",
+         SPAWN_COUNT,
+         (double)call_ns / SPAWN_COUNT, (double)index_ns / SPAWN_COUNT, (double)view_ns / SPAWN_COUNT,
+         call_sum == expected && index_sum == expected && view_sum == expected ? "same sums" : "DIFFERENT sums");
+
+  gd_extension.variant_destroy(table_variant);
+  gd_extension_helper.destructor.array(table);
+}
+
+void godot_initialize(void *userdata, GDExtensionInitializationLevel p_level) {
+  if (p_level == GDEXTENSION_INITIALIZATION_SCENE) {
+    gd_extension_helper.string_name.get = construct_string_name("get");
+    for (size_t i = 0; i < CONFIG_COUNT; i++) {
+      gd_dictionary_key_new(&config_keys[i], config_entries[i].name);
+    }
+
+    print_config_benchmark();
+    print_spawn_table_benchmark();
+    return;
+  }
+}
+
+void godot_deinitialize(void *userdata, GDExtensionInitializationLevel p_level) {
+  if (p_level == GDEXTENSION_INITIALIZATION_SCENE) {
+    for (size_t i = 0; i < CONFIG_COUNT; i++) {
+      gd_dictionary_key_destroy(&config_keys[i]);
+    }
+    destruct_string_name(gd_extension_helper.string_name.get);
+  }
+}
+
+GDExtensionBool
+godot_entry(
+  GDExtensionInterfaceGetProcAddress p_get_proc_address,
+  const GDExtensionClassLibraryPtr _p_library,
+  GDExtensionInitialization *r_initialization
+) {
+  r_initialization->minimum_initialization_level = GDEXTENSION_INITIALIZATION_SCENE;
+  r_initialization->userdata = NULL;
+  r_initialization->initialize = godot_initialize;
+  r_initialization->deinitialize = godot_deinitialize;
+
+  STORE_GD_EXTENSION(string_name_new_with_utf8_chars);
+  STORE_GD_EXTENSION(variant_get_ptr_destructor);
+  STORE_GD_EXTENSION(variant_get_ptr_constructor);
+  STORE_GD_EXTENSION(variant_get_ptr_builtin_method);
+  STORE_GD_EXTENSION(variant_destroy);
+  STORE_GD_EXTENSION(variant_call);
+  STORE_GD_EXTENSION(get_variant_from_type_constructor);
+  STORE_GD_EXTENSION(array_operator_index);
+  STORE_GD_EXTENSION(array_operator_index_const);
+  STORE_GD_EXTENSION(dictionary_operator_index);
+
+  gd_extension_helper.destructor.string_name
+    = gd_extension.variant_get_ptr_destructor(GDEXTENSION_VARIANT_TYPE_STRING_NAME);
+  gd_extension_helper.destructor.array
+    = gd_extension.variant_get_ptr_destructor(GDEXTENSION_VARIANT_TYPE_ARRAY);
+  gd_extension_helper.destructor.dictionary
+    = gd_extension.variant_get_ptr_destructor(GDEXTENSION_VARIANT_TYPE_DICTIONARY);
+
+  gd_extension_helper.constructor.array
+    = gd_extension.variant_get_ptr_constructor(GDEXTENSION_VARIANT_TYPE_ARRAY, 0);
+  gd_extension_helper.constructor.dictionary
+    = gd_extension.variant_get_ptr_constructor(GDEXTENSION_VARIANT_TYPE_DICTIONARY, 0);
+
+  gd_extension_helper.wrap.type_int
+    = gd_extension.get_variant_from_type_constructor(GDEXTENSION_VARIANT_TYPE_INT);
+  gd_extension_helper.wrap.type_double
+    = gd_extension.get_variant_from_type_constructor(GDEXTENSION_VARIANT_TYPE_FLOAT);
+  gd_extension_helper.wrap.array
+    = gd_extension.get_variant_from_type_constructor(GDEXTENSION_VARIANT_TYPE_ARRAY);
+  gd_extension_helper.wrap.dictionary
+    = gd_extension.get_variant_from_type_constructor(GDEXTENSION_VARIANT_TYPE_DICTIONARY);
+
+  gd_container_init(p_get_proc_address);
+
+  return true;
+}
@@ -0,0 +1,217 @@
+#include "../godot-headers/gdextension_interface.h"
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define STORE_GD_EXTENSION(str_name) gd_extension.str_name = (void *)p_get_proc_address(#str_name);
+#define IS_GODOT_64_BIT (true)
+#define IS_GODOT_USING_LARGE_WORLD_COORDINATES (false)
+#define VARIANT_SIZE (IS_GODOT_USING_LARGE_WORLD_COORDINATES ? 40 : 24)
+#define BENCHMARK_CALL_COUNT (100000)
+
+#include "../util/dynamic_call.h"
+
+struct {
+  GDExtensionInterfaceStringNameNewWithUtf8Chars string_name_new_with_utf8_chars;
+  GDExtensionInterfaceVariantGetPtrDestructor variant_get_ptr_destructor;
+  GDExtensionInterfaceGetVariantFromTypeConstructor get_variant_from_type_constructor;
+  GDExtensionInterfaceGetVariantToTypeConstructor get_variant_to_type_constructor;
+  GDExtensionInterfaceVariantCall variant_call;
+  GDExtensionInterfaceVariantDestroy variant_destroy;
+  GDExtensionInterfaceClassdbConstructObject classdb_construct_object;
+  GDExtensionInterfaceObjectDestroy object_destroy;
+} gd_extension;
+
+struct {
+  struct {
+    GDExtensionPtrDestructor string_name;
+  } destructor;
+  struct {
+    GDExtensionVariantFromTypeConstructorFunc type_vector2;
+    GDExtensionVariantFromTypeConstructorFunc type_object;
+  } wrap;
+  struct {
+    GDExtensionTypeFromVariantConstructorFunc type_vector2;
+    GDExtensionTypeFromVariantConstructorFunc type_int;
+  } unwrap;
+} gd_extension_helper;
+
+#if (IS_GODOT_USING_LARGE_WORLD_COORDINATES)
+typedef struct {
+  double x;
+  double y;
+} GDVector2;
+#else
+typedef struct {
+  float x;
+  float y;
+} GDVector2;
+#endif
+
+GDExtensionStringNamePtr construct_string_name(const char *c_string) {
+  void *res = malloc(IS_GODOT_64_BIT ? 8 : 4);
+  gd_extension.string_name_new_with_utf8_chars(res, c_string);
+  return res;
+}
+
+void destruct_string_name(GDExtensionStringNamePtr p) {
+  gd_extension_helper.destructor.string_name(p);
+  free(p);
+}
+
+uint64_t now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+GDExtensionObjectPtr construct_object(const char *class_name) {
+  GDExtensionStringNamePtr class_string_name = construct_string_name(class_name);
+  GDExtensionObjectPtr res = gd_extension.classdb_construct_object(class_string_name);
+  destruct_string_name(class_string_name);
+  return res;
+}
+
+// What a binding does without any caching: every call finds the method by
+// name again
+void call_by_name(GDExtensionObjectPtr object, GDExtensionConstStringNamePtr method, const GDExtensionConstVariantPtr *args, GDExtensionInt argument_count, GDExtensionUninitializedVariantPtr r_ret) {
+  uint8_t self[VARIANT_SIZE];
+  GDExtensionCallError error;
+  gd_extension_helper.wrap.type_object(self, &object);
+  gd_extension.variant_call(self, method, args, argument_count, r_ret, &error);
+  gd_extension.variant_destroy(self);
+}
+
+void print_set_position_benchmark(GDExtensionObjectPtr node) {
+  GDExtensionStringNamePtr set_position = construct_string_name("set_position");
+  uint8_t arg[VARIANT_SIZE];
+  uint8_t ret[VARIANT_SIZE];
+  GDExtensionCallError error;
+  GDVector2 position = { .x = 1, .y = 2 };
+  gd_extension_helper.wrap.type_vector2(arg, &position);
+  const GDExtensionConstVariantPtr args[1] = { arg };
+
+  uint64_t start = now_ns();
+  for (int i = 0; i < BENCHMARK_CALL_COUNT; i++) {
+    call_by_name(node, set_position, args, 1, ret);
+    gd_extension.variant_destroy(ret);
+  }
+  uint64_t by_name_ns = now_ns() - start;
+
+  start = now_ns();
+  for (int i = 0; i < BENCHMARK_CALL_COUNT; i++) {
+    DYNAMIC_CALL(node, set_position, args, 1, ret, &error);
+    gd_extension.variant_destroy(ret);
+  }
+  uint64_t cached_ns = now_ns() - start;
+
+  printf("Node2D.set_position: variant_call %.1f ns, DYNAMIC_CALL %.1f ns\n",
+         (double)by_name_ns / BENCHMARK_CALL_COUNT,
+         (double)cached_ns / BENCHMARK_CALL_COUNT);
+
+  gd_extension.variant_destroy(arg);
+  destruct_string_name(set_position);
+}
+
+// One site, two classes: Sprite2D has no registered `get_position` of its
+// own, the lookup finds the one of Node2D
+void print_polymorphic_calls(GDExtensionObjectPtr node, GDExtensionObjectPtr sprite) {
+  GDExtensionStringNamePtr get_position = construct_string_name("get_position");
+  GDExtensionObjectPtr objects[2] = { node, sprite };
+  GDExtensionCallError error;
+  float sum = 0;
+
+  for (int i = 0; i < 1000; i++) {
+    uint8_t ret[VARIANT_SIZE];
+    GDVector2 position;
+    DYNAMIC_CALL(objects[i & 1], get_position, NULL, 0, ret, &error);
+    gd_extension_helper.unwrap.type_vector2(&position, ret);
+    gd_extension.variant_destroy(ret);
+    sum += position.x + position.y;
+  }
+  printf("sum of 1000 positions from Node2D and Sprite2D: %f\n", sum);
+
+  destruct_string_name(get_position);
+}
+
+// Nobody registered a hash for `get_child_count`, so this goes through
+// `variant_call`. A script method would as well.
+void print_fallback_call(GDExtensionObjectPtr node) {
+  GDExtensionStringNamePtr get_child_count = construct_string_name("get_child_count");
+  uint8_t ret[VARIANT_SIZE];
+  GDExtensionCallError error;
+  GDExtensionInt count = -1;
+
+  DYNAMIC_CALL(node, get_child_count, NULL, 0, ret, &error);
+  if (error.error == GDEXTENSION_CALL_OK) {
+    gd_extension_helper.unwrap.type_int(&count, ret);
+  }
+  gd_extension.variant_destroy(ret);
+  printf("get_child_count() = %ld\n", (long)count);
+
+  destruct_string_name(get_child_count);
+}
+
+void godot_initialize(void *userdata, GDExtensionInitializationLevel p_level) {
+  if (p_level == GDEXTENSION_INITIALIZATION_SCENE) {
+    // From `extension_api.json`
+    dynamic_call_register("Node2D", "set_position", 743155724);
+    dynamic_call_register("Node2D", "get_position", 3341600327);
+
+    GDExtensionObjectPtr node = construct_object("Node2D");
+    GDExtensionObjectPtr sprite = construct_object("Sprite2D");
+
+    print_set_position_benchmark(node);
+    print_polymorphic_calls(node, sprite);
+    print_fallback_call(node);
+    dynamic_call_print_stats();
+
+    gd_extension.object_destroy(node);
+    gd_extension.object_destroy(sprite);
+    return;
+  }
+}
+
+void godot_deinitialize(void *userdata, GDExtensionInitializationLevel p_level) {
+  if (p_level == GDEXTENSION_INITIALIZATION_SCENE) {
+    dynamic_call_deinit();
+  }
+}
+
+GDExtensionBool
+godot_entry(
+  GDExtensionInterfaceGetProcAddress p_get_proc_address,
+  const GDExtensionClassLibraryPtr p_library,
+  GDExtensionInitialization *r_initialization
+) {
+  r_initialization->minimum_initialization_level = GDEXTENSION_INITIALIZATION_SCENE;
+  r_initialization->userdata = NULL;
+  r_initialization->initialize = godot_initialize;
+  r_initialization->deinitialize = godot_deinitialize;
+
+  STORE_GD_EXTENSION(string_name_new_with_utf8_chars);
+  STORE_GD_EXTENSION(variant_get_ptr_destructor);
+  STORE_GD_EXTENSION(get_variant_from_type_constructor);
+  STORE_GD_EXTENSION(get_variant_to_type_constructor);
+  STORE_GD_EXTENSION(variant_call);
+  STORE_GD_EXTENSION(variant_destroy);
+  STORE_GD_EXTENSION(classdb_construct_object);
+  STORE_GD_EXTENSION(object_destroy);
+
+  gd_extension_helper.destructor.string_name
+    = gd_extension.variant_get_ptr_destructor(GDEXTENSION_VARIANT_TYPE_STRING_NAME);
+  gd_extension_helper.wrap.type_vector2
+    = gd_extension.get_variant_from_type_constructor(GDEXTENSION_VARIANT_TYPE_VECTOR2);
+  gd_extension_helper.wrap.type_object
+    = gd_extension.get_variant_from_type_constructor(GDEXTENSION_VARIANT_TYPE_OBJECT);
+  gd_extension_helper.unwrap.type_vector2
+    = gd_extension.get_variant_to_type_constructor(GDEXTENSION_VARIANT_TYPE_VECTOR2);
+  gd_extension_helper.unwrap.type_int
+    = gd_extension.get_variant_to_type_constructor(GDEXTENSION_VARIANT_TYPE_INT);
+
+  dynamic_call_init(p_get_proc_address, p_library);
+
+  return true;
+}
@@ -0,0 +1,991 @@
+#include "../godot-headers/gdextension_interface.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define STORE_GD_EXTENSION(str_name) gd_extension.str_name = (void *)p_get_proc_address(#str_name);
+#define IS_GODOT_64_BIT (true)
+#define IS_GODOT_USING_LARGE_WORLD_COORDINATES (false)
+#define VARIANT_SIZE (IS_GODOT_USING_LARGE_WORLD_COORDINATES ? 40 : 24)
+#define PACKED_ARRAY_SIZE (16)
+#define SERVER_CLASS_NAME ("EntityServer")
+#define SERVER_CLASS_PARENT ("Object")
+#define SERVER_MAX_ARGUMENTS (2)
+#define PROPERTY_USAGE_DEFAULT (6)
+#define PACKED_SIZE_HASH (3173160232)
+#define PACKED_RESIZE_HASH (848867239)
+// RenderingServer.MULTIMESH_TRANSFORM_2D
+#define MULTIMESH_TRANSFORM_2D (0)
+// A 2D MultiMesh instance is 8 floats: x.x, y.x, padding, origin.x, x.y, y.y, padding, origin.y
+#define FLOATS_PER_TRANSFORM_2D (8)
+#define ENTITY_MIN_SPEED (40.0f)
+#define ENTITY_MAX_SPEED (160.0f)
+#define BENCHMARK_ENTITIES (1000000)
+#define BENCHMARK_STEPS (10)
+#define BENCHMARK_NODES (10000)
+
+#include "../util/rid_storage.h"
+
+typedef float real_t;
+
+typedef struct {
+  real_t x;
+  real_t y;
+} vector2_t;
+
+typedef struct {
+  vector2_t position;
+  vector2_t size;
+} rect2_t;
+
+struct {
+  GDExtensionInterfaceClassdbConstructObject classdb_construct_object;
+  GDExtensionInterfaceClassdbRegisterExtensionClass2 classdb_register_extension_class2;
+  GDExtensionInterfaceClassdbRegisterExtensionClassMethod classdb_register_extension_class_method;
+  GDExtensionInterfaceStringNameNewWithUtf8Chars string_name_new_with_utf8_chars;
+  GDExtensionInterfaceStringNewWithUtf8Chars string_new_with_utf8_chars;
+  GDExtensionInterfaceObjectSetInstance object_set_instance;
+  GDExtensionInterfaceObjectDestroy object_destroy;
+  GDExtensionInterfaceGlobalGetSingleton global_get_singleton;
+  GDExtensionInterfaceVariantGetPtrDestructor variant_get_ptr_destructor;
+  GDExtensionInterfaceVariantGetPtrConstructor variant_get_ptr_constructor;
+  GDExtensionInterfaceVariantGetPtrBuiltinMethod variant_get_ptr_builtin_method;
+  GDExtensionInterfaceGetVariantFromTypeConstructor get_variant_from_type_constructor;
+  GDExtensionInterfaceGetVariantToTypeConstructor get_variant_to_type_constructor;
+  GDExtensionInterfaceVariantGetType variant_get_type;
+  GDExtensionInterfaceVariantCall variant_call;
+  GDExtensionInterfaceVariantDestroy variant_destroy;
+  GDExtensionInterfacePackedFloat32ArrayOperatorIndex packed_float32_array_operator_index;
+} gd_extension;
+
+struct {
+  struct {
+    GDExtensionPtrDestructor string_name;
+    GDExtensionPtrDestructor string;
+    GDExtensionPtrDestructor packed_float32_array;
+  } destructor;
+  struct {
+    GDExtensionPtrConstructor packed_float32_array;
+  } constructor;
+  struct {
+    GDExtensionPtrBuiltInMethod packed_float32_array_size;
+    GDExtensionPtrBuiltInMethod packed_float32_array_resize;
+  } builtin_method;
+  // Indexed by GDExtensionVariantType, only filled for the types the methods use
+  struct {
+    GDExtensionVariantFromTypeConstructorFunc type[GDEXTENSION_VARIANT_TYPE_VARIANT_MAX];
+  } wrap;
+  struct {
+    GDExtensionTypeFromVariantConstructorFunc type[GDEXTENSION_VARIANT_TYPE_VARIANT_MAX];
+  } unwrap;
+  struct {
+    GDExtensionClassLibraryPtr p_library;
+    GDExtensionObjectPtr server;
+    GDExtensionObjectPtr rendering_server;
+    GDExtensionStringNamePtr multimesh_allocate_data;
+    GDExtensionStringNamePtr multimesh_set_buffer;
+    GDExtensionStringNamePtr multimesh_set_visible_instances;
+  } misc;
+} gd_extension_helper;
+
+GDExtensionStringNamePtr construct_string_name(const char *c_string) {
+  void *res = malloc(IS_GODOT_64_BIT ? 8 : 4);
+  gd_extension.string_name_new_with_utf8_chars(res, c_string);
+  return res;
+}
+
+GDExtensionStringPtr construct_string(const char *c_string) {
+  void *res = malloc(IS_GODOT_64_BIT ? 8 : 4);
+  gd_extension.string_new_with_utf8_chars(res, c_string);
+  return res;
+}
+
+void destruct_string_name(GDExtensionStringNamePtr p) {
+  gd_extension_helper.destructor.string_name(p);
+  free(p);
+}
+
+void destruct_string(GDExtensionStringPtr p) {
+  gd_extension_helper.destructor.string(p);
+  free(p);
+}
+
+uint64_t now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+GDExtensionInt packed_float32_array_size(GDExtensionConstTypePtr p_array) {
+  GDExtensionInt res;
+  gd_extension_helper.builtin_method.packed_float32_array_size((void *)p_array, NULL, &res, 0);
+  return res;
+}
+
+void packed_float32_array_resize(GDExtensionTypePtr p_array, GDExtensionInt p_size) {
+  GDExtensionConstTypePtr args[] = { &p_size };
+  GDExtensionInt error;
+  gd_extension_helper.builtin_method.packed_float32_array_resize(p_array, args, &error, 1);
+}
+
+// Calls `method` on `object` by name. The server makes a few of these per
+// frame at most, so a Variant call is good enough and needs no method hash.
+// `r_ret` is constructed either way.
+bool
+object_call(
+  GDExtensionObjectPtr object,
+  GDExtensionConstStringNamePtr method,
+  const GDExtensionConstVariantPtr *p_args,
+  GDExtensionInt p_argument_count,
+  GDExtensionUninitializedVariantPtr r_ret
+) {
+  uint8_t object_variant[VARIANT_SIZE];
+  gd_extension_helper.wrap.type[GDEXTENSION_VARIANT_TYPE_OBJECT](object_variant, &object);
+
+  GDExtensionCallError error;
+  gd_extension.variant_call(object_variant, method, p_args, p_argument_count, r_ret, &error);
+  gd_extension.variant_destroy(object_variant);
+  return error.error == GDEXTENSION_CALL_OK;
+}
+
+// Engine.register_singleton and Engine.unregister_singleton. Called once, so
+// the Variant call is good enough here too.
+void engine_call_with_server(const char *method) {
+  void *engine_string_name = construct_string_name("Engine");
+  void *method_string_name = construct_string_name(method);
+  void *name_string_name = construct_string_name(SERVER_CLASS_NAME);
+  GDExtensionObjectPtr engine = gd_extension.global_get_singleton(engine_string_name);
+
+  uint8_t name_variant[VARIANT_SIZE];
+  uint8_t server_variant[VARIANT_SIZE];
+  uint8_t ret[VARIANT_SIZE];
+  gd_extension_helper.wrap.type[GDEXTENSION_VARIANT_TYPE_STRING_NAME](name_variant, name_string_name);
+  gd_extension_helper.wrap.type[GDEXTENSION_VARIANT_TYPE_OBJECT](server_variant, &gd_extension_helper.misc.server);
+
+  const GDExtensionConstVariantPtr args[] = { name_variant, server_variant };
+  // unregister_singleton only takes the name
+  GDExtensionInt argument_count = strcmp(method, "register_singleton") == 0 ? 2 : 1;
+  if (!object_call(engine, method_string_name, args, argument_count, ret)) {
+    fprintf(stderr, "Engine.%s failed\n", method);
+  }
+
+  gd_extension.variant_destroy(ret);
+  gd_extension.variant_destroy(server_variant);
+  gd_extension.variant_destroy(name_variant);
+  destruct_string_name(engine_string_name);
+  destruct_string_name(method_string_name);
+  destruct_string_name(name_string_name);
+}
+
+// ---------------------------------------------------------------------------
+// EntityServer
+// ---------------------------------------------------------------------------
+
+// Entities are a position and a velocity, nothing else. A Node2D carries a
+// name, a transform, a canvas item, signals, groups and a place in the tree
+// for each one, and the scene tree visits all of them every frame. Here they
+// are two float pairs in arrays the size of the live count, and `step`
+// moves all of them in one loop.
+//
+// What the entities look like is up to a MultiMesh: `step` writes one 2D
+// transform per entity into `transforms` and hands the whole array to
+// RenderingServer in one call. `transforms` is never shared, so it's
+// written in place.
+typedef struct {
+  GDExtensionObjectPtr godot_object;
+  rid_storage_t storage;
+  // Indexed by the storage's dense index
+  vector2_t *positions;
+  vector2_t *velocities;
+  rect2_t bounds;
+  uint64_t random_state;
+  // RenderingServer RID, 0 when nothing is drawn
+  uint64_t multimesh;
+  // Instances the MultiMesh was allocated with, 0 to allocate it again
+  GDExtensionInt multimesh_instances;
+  // PackedFloat32Array, FLOATS_PER_TRANSFORM_2D per entity of capacity
+  unsigned char transforms[PACKED_ARRAY_SIZE];
+} entity_server_t;
+
+void entity_server_init(entity_server_t *server) {
+  rid_storage_init(&server->storage);
+  server->positions = NULL;
+  server->velocities = NULL;
+  server->bounds = (rect2_t){ { 0, 0 }, { 1024, 600 } };
+  server->random_state = 0x9e3779b97f4a7c15ull;
+  server->multimesh = 0;
+  server->multimesh_instances = 0;
+  gd_extension_helper.constructor.packed_float32_array(&server->transforms, NULL);
+}
+
+void entity_server_destroy(entity_server_t *server) {
+  rid_storage_destroy(&server->storage);
+  free(server->positions);
+  free(server->velocities);
+  gd_extension_helper.destructor.packed_float32_array(&server->transforms);
+}
+
+bool entity_server_reserve(entity_server_t *server, uint32_t capacity) {
+  if (capacity <= server->storage.capacity) return true;
+
+  vector2_t *positions = realloc(server->positions, capacity * sizeof(vector2_t));
+  if (positions == NULL) return false;
+  server->positions = positions;
+  vector2_t *velocities = realloc(server->velocities, capacity * sizeof(vector2_t));
+  if (velocities == NULL) return false;
+  server->velocities = velocities;
+  return rid_storage_reserve(&server->storage, capacity);
+}
+
+// 0 when out of memory
+uint64_t entity_server_create(entity_server_t *server, vector2_t position, vector2_t velocity) {
+  rid_storage_t *storage = &server->storage;
+  if (storage->count == storage->capacity) {
+    uint32_t capacity = storage->capacity < 1024 ? 1024 : storage->capacity * 2;
+    if (capacity <= storage->capacity || !entity_server_reserve(server, capacity)) return 0;
+  }
+
+  uint32_t index;
+  uint64_t rid = rid_storage_make(storage, &index);
+  if (rid == 0) return 0;
+  server->positions[index] = position;
+  server->velocities[index] = velocity;
+  return rid;
+}
+
+void entity_server_free(entity_server_t *server, uint64_t rid) {
+  uint32_t moved_from;
+  uint32_t index = rid_storage_free(&server->storage, rid, &moved_from);
+  if (index == RID_STORAGE_INVALID || index == moved_from) return;
+
+  server->positions[index] = server->positions[moved_from];
+  server->velocities[index] = server->velocities[moved_from];
+}
+
+float entity_server_random(entity_server_t *server) {
+  uint64_t x = server->random_state;
+  x ^= x << 13;
+  x ^= x >> 7;
+  x ^= x << 17;
+  server->random_state = x;
+  return (float)(x >> 40) * (1.0f / 16777216.0f);
+}
+
+// Random positions inside the bounds, random directions and speeds. Returns
+// how many were made, fewer than `count` only when out of memory.
+GDExtensionInt entity_server_spawn(entity_server_t *server, GDExtensionInt count) {
+  if (count <= 0) return 0;
+  if (count > RID_STORAGE_INVALID - 1 - (GDExtensionInt)server->storage.count) {
+    count = RID_STORAGE_INVALID - 1 - server->storage.count;
+  }
+  // One allocation for the whole batch instead of doubling along the way
+  entity_server_reserve(server, server->storage.count + (uint32_t)count);
+
+  const rect2_t bounds = server->bounds;
+  for (GDExtensionInt i = 0; i < count; i++) {
+    vector2_t position = {
+      bounds.position.x + entity_server_random(server) * bounds.size.x,
+      bounds.position.y + entity_server_random(server) * bounds.size.y,
+    };
+    vector2_t direction = {
+      entity_server_random(server) * 2.0f - 1.0f,
+      entity_server_random(server) * 2.0f - 1.0f,
+    };
+    real_t length = sqrtf(direction.x * direction.x + direction.y * direction.y);
+    real_t speed = ENTITY_MIN_SPEED + entity_server_random(server) * (ENTITY_MAX_SPEED - ENTITY_MIN_SPEED);
+    real_t scale = length > 0.0001f ? speed / length : 0.0f;
+    vector2_t velocity = { direction.x * scale, direction.y * scale };
+    if (entity_server_create(server, position, velocity) == 0) return i;
+  }
+  return count;
+}
+
+// Moves every entity and bounces it off the bounds. No RID lookups, no
+// calls, two arrays walked front to back.
+void entity_server_integrate(entity_server_t *server, real_t delta) {
+  const uint32_t count = server->storage.count;
+  const real_t min_x = server->bounds.position.x;
+  const real_t min_y = server->bounds.position.y;
+  const real_t max_x = min_x + server->bounds.size.x;
+  const real_t max_y = min_y + server->bounds.size.y;
+  vector2_t *restrict positions = server->positions;
+  vector2_t *restrict velocities = server->velocities;
+
+  for (uint32_t i = 0; i < count; i++) {
+    vector2_t p = positions[i];
+    vector2_t v = velocities[i];
+    p.x += v.x * delta;
+    p.y += v.y * delta;
+    if (p.x < min_x || p.x > max_x) {
+      v.x = -v.x;
+      p.x = p.x < min_x ? min_x : max_x;
+    }
+    if (p.y < min_y || p.y > max_y) {
+      v.y = -v.y;
+      p.y = p.y < min_y ? min_y : max_y;
+    }
+    positions[i] = p;
+    velocities[i] = v;
+  }
+}
+
+// One transform per entity, rotated to face where it's going
+void entity_server_write_transforms(entity_server_t *server, float *restrict r_transforms) {
+  const uint32_t count = server->storage.count;
+  const vector2_t *restrict positions = server->positions;
+  const vector2_t *restrict velocities = server->velocities;
+
+  for (uint32_t i = 0; i < count; i++) {
+    vector2_t v = velocities[i];
+    real_t length = sqrtf(v.x * v.x + v.y * v.y);
+    real_t c = length > 0.0001f ? v.x / length : 1.0f;
+    real_t s = length > 0.0001f ? v.y / length : 0.0f;
+    float *t = r_transforms + (size_t)i * FLOATS_PER_TRANSFORM_2D;
+    t[0] = c;
+    t[1] = -s;
+    t[2] = 0.0f;
+    t[3] = positions[i].x;
+    t[4] = s;
+    t[5] = c;
+    t[6] = 0.0f;
+    t[7] = positions[i].y;
+  }
+}
+
+// The MultiMesh is allocated with the server's capacity and only shows the
+// live count, so it's reallocated when the capacity grows, not on every
+// spawn and free.
+void entity_server_push_to_multimesh(entity_server_t *server) {
+  GDExtensionInt instances = server->storage.capacity;
+  if (server->multimesh == 0 || instances == 0) return;
+
+  if (packed_float32_array_size(&server->transforms) != instances * FLOATS_PER_TRANSFORM_2D) {
+    packed_float32_array_resize(&server->transforms, instances * FLOATS_PER_TRANSFORM_2D);
+  }
+  entity_server_write_transforms(server, gd_extension.packed_float32_array_operator_index(&server->transforms, 0));
+
+  uint8_t multimesh[VARIANT_SIZE];
+  uint8_t value[VARIANT_SIZE];
+  uint8_t ret[VARIANT_SIZE];
+  gd_extension_helper.wrap.type[GDEXTENSION_VARIANT_TYPE_RID](multimesh, &server->multimesh);
+  GDExtensionObjectPtr rendering_server = gd_extension_helper.misc.rendering_server;
+
+  if (server->multimesh_instances != instances) {
+    GDExtensionInt transform_format = MULTIMESH_TRANSFORM_2D;
+    uint8_t format[VARIANT_SIZE];
+    gd_extension_helper.wrap.type[GDEXTENSION_VARIANT_TYPE_INT](value, &instances);
+    gd_extension_helper.wrap.type[GDEXTENSION_VARIANT_TYPE_INT](format, &transform_format);
+    const GDExtensionConstVariantPtr args[] = { multimesh, value, format };
+    object_call(rendering_server, gd_extension_helper.misc.multimesh_allocate_data, args, 3, ret);
+    gd_extension.variant_destroy(ret);
+    gd_extension.variant_destroy(value);
+    server->multimesh_instances = instances;
+  }
+
+  // RenderingServer copies the floats, the array is ours alone again after
+  // the call
+  gd_extension_helper.wrap.type[GDEXTENSION_VARIANT_TYPE_PACKED_FLOAT32_ARRAY](value, &server->transforms);
+  const GDExtensionConstVariantPtr buffer_args[] = { multimesh, value };
+  object_call(rendering_server, gd_extension_helper.misc.multimesh_set_buffer, buffer_args, 2, ret);
+  gd_extension.variant_destroy(ret);
+  gd_extension.variant_destroy(value);
+
+  GDExtensionInt visible = server->storage.count;
+  gd_extension_helper.wrap.type[GDEXTENSION_VARIANT_TYPE_INT](value, &visible);
+  const GDExtensionConstVariantPtr visible_args[] = { multimesh, value };
+  object_call(rendering_server, gd_extension_helper.misc.multimesh_set_visible_instances, visible_args, 2, ret);
+  gd_extension.variant_destroy(ret);
+  gd_extension.variant_destroy(value);
+
+  gd_extension.variant_destroy(multimesh);
+}
+
+// Everything the server holds, divided by the entities it holds
+double entity_server_bytes_per_entity(const entity_server_t *server) {
+  if (server->storage.count == 0) return 0.0;
+  size_t bytes = server->storage.capacity * (RID_STORAGE_BYTES_PER_ENTRY + 2 * sizeof(vector2_t));
+  bytes += packed_float32_array_size(&server->transforms) * sizeof(float);
+  return (double)bytes / server->storage.count;
+}
+
+typedef struct {
+  GDExtensionObjectPtr godot_object;
+  entity_server_t server;
+} server_object_t;
+
+GDExtensionObjectPtr server_object_init(void *userdata) {
+  server_object_t *object = malloc(sizeof(server_object_t));
+
+  void *my_class_string_name = construct_string_name(SERVER_CLASS_NAME);
+  void *parent_class_string_name = construct_string_name(SERVER_CLASS_PARENT);
+
+  object->godot_object = gd_extension.classdb_construct_object(parent_class_string_name);
+  entity_server_init(&object->server);
+  gd_extension.object_set_instance(object->godot_object, my_class_string_name, object);
+
+  destruct_string_name(my_class_string_name);
+  destruct_string_name(parent_class_string_name);
+
+  return object->godot_object;
+}
+
+void server_object_deinit(void *userdata, GDExtensionClassInstancePtr p_instance) {
+  if (p_instance == NULL) return;
+
+  server_object_t *object = p_instance;
+  entity_server_destroy(&object->server);
+  free(object);
+}
+
+// ---------------------------------------------------------------------------
+// Methods
+// ---------------------------------------------------------------------------
+
+// Every argument and return value is plain data (int, float, bool, Vector2,
+// Rect2, RID), so the methods are written against ptrcall's typed pointers,
+// and a Variant call unwraps into locals first. Typed GDScript goes through
+// ptrcall and pays nothing for the Variants.
+typedef void (*server_method_func_t)(entity_server_t *server, const GDExtensionConstTypePtr *p_args, GDExtensionTypePtr r_ret);
+
+void server_entity_create(entity_server_t *server, const GDExtensionConstTypePtr *p_args, GDExtensionTypePtr r_ret) {
+  *(uint64_t *)r_ret = entity_server_create(server, *(const vector2_t *)p_args[0], *(const vector2_t *)p_args[1]);
+}
+
+void server_entity_free(entity_server_t *server, const GDExtensionConstTypePtr *p_args, GDExtensionTypePtr r_ret) {
+  entity_server_free(server, *(const uint64_t *)p_args[0]);
+}
+
+void server_entity_is_valid(entity_server_t *server, const GDExtensionConstTypePtr *p_args, GDExtensionTypePtr r_ret) {
+  *(GDExtensionBool *)r_ret = rid_storage_owns(&server->storage, *(const uint64_t *)p_args[0]);
+}
+
+void server_entity_set_position(entity_server_t *server, const GDExtensionConstTypePtr *p_args, GDExtensionTypePtr r_ret) {
+  uint32_t index = rid_storage_index(&server->storage, *(const uint64_t *)p_args[0]);
+  if (index != RID_STORAGE_INVALID) server->positions[index] = *(const vector2_t *)p_args[1];
+}
+
+void server_entity_get_position(entity_server_t *server, const GDExtensionConstTypePtr *p_args, GDExtensionTypePtr r_ret) {
+  uint32_t index = rid_storage_index(&server->storage, *(const uint64_t *)p_args[0]);
+  *(vector2_t *)r_ret = index != RID_STORAGE_INVALID ? server->positions[index] : (vector2_t){ 0, 0 };
+}
+
+void server_entity_set_velocity(entity_server_t *server, const GDExtensionConstTypePtr *p_args, GDExtensionTypePtr r_ret) {
+  uint32_t index = rid_storage_index(&server->storage, *(const uint64_t *)p_args[0]);
+  if (index != RID_STORAGE_INVALID) server->velocities[index] = *(const vector2_t *)p_args[1];
+}
+
+void server_entity_get_velocity(entity_server_t *server, const GDExtensionConstTypePtr *p_args, GDExtensionTypePtr r_ret) {
+  uint32_t index = rid_storage_index(&server->storage, *(const uint64_t *)p_args[0]);
+  *(vector2_t *)r_ret = index != RID_STORAGE_INVALID ? server->velocities[index] : (vector2_t){ 0, 0 };
+}
+
+void server_set_bounds(entity_server_t *server, const GDExtensionConstTypePtr *p_args, GDExtensionTypePtr r_ret) {
+  server->bounds = *(const rect2_t *)p_args[0];
+}
+
+void server_spawn(entity_server_t *server, const GDExtensionConstTypePtr *p_args, GDExtensionTypePtr r_ret) {
+  *(GDExtensionInt *)r_ret = entity_server_spawn(server, *(const GDExtensionInt *)p_args[0]);
+}
+
+void server_clear(entity_server_t *server, const GDExtensionConstTypePtr *p_args, GDExtensionTypePtr r_ret) {
+  rid_storage_clear(&server->storage);
+}
+
+void server_step(entity_server_t *server, const GDExtensionConstTypePtr *p_args, GDExtensionTypePtr r_ret) {
+  entity_server_integrate(server, (real_t)*(const double *)p_args[0]);
+  entity_server_push_to_multimesh(server);
+}
+
+void server_set_multimesh(entity_server_t *server, const GDExtensionConstTypePtr *p_args, GDExtensionTypePtr r_ret) {
+  server->multimesh = *(const uint64_t *)p_args[0];
+  server->multimesh_instances = 0;
+}
+
+void server_get_entity_count(entity_server_t *server, const GDExtensionConstTypePtr *p_args, GDExtensionTypePtr r_ret) {
+  *(GDExtensionInt *)r_ret = server->storage.count;
+}
+
+void server_get_bytes_per_entity(entity_server_t *server, const GDExtensionConstTypePtr *p_args, GDExtensionTypePtr r_ret) {
+  *(double *)r_ret = entity_server_bytes_per_entity(server);
+}
+
+typedef struct {
+  const char *name;
+  server_method_func_t func;
+  // NIL for no return value
+  GDExtensionVariantType return_type;
+  int argument_count;
+  struct {
+    const char *name;
+    GDExtensionVariantType type;
+  } arguments[SERVER_MAX_ARGUMENTS];
+} server_method_t;
+
+const server_method_t server_methods[] = {
+  {
+    .name = "entity_create",
+    .func = server_entity_create,
+    .return_type = GDEXTENSION_VARIANT_TYPE_RID,
+    .argument_count = 2,
+    .arguments = {
+      { "position", GDEXTENSION_VARIANT_TYPE_VECTOR2 },
+      { "velocity", GDEXTENSION_VARIANT_TYPE_VECTOR2 },
+    },
+  },
+  {
+    .name = "entity_free",
+    .func = server_entity_free,
+    .return_type = GDEXTENSION_VARIANT_TYPE_NIL,
+    .argument_count = 1,
+    .arguments = { { "rid", GDEXTENSION_VARIANT_TYPE_RID } },
+  },
+  {
+    .name = "entity_is_valid",
+    .func = server_entity_is_valid,
+    .return_type = GDEXTENSION_VARIANT_TYPE_BOOL,
+    .argument_count = 1,
+    .arguments = { { "rid", GDEXTENSION_VARIANT_TYPE_RID } },
+  },
+  {
+    .name = "entity_set_position",
+    .func = server_entity_set_position,
+    .return_type = GDEXTENSION_VARIANT_TYPE_NIL,
+    .argument_count = 2,
+    .arguments = {
+      { "rid", GDEXTENSION_VARIANT_TYPE_RID },
+      { "position", GDEXTENSION_VARIANT_TYPE_VECTOR2 },
+    },
+  },
+  {
+    .name = "entity_get_position",
+    .func = server_entity_get_position,
+    .return_type = GDEXTENSION_VARIANT_TYPE_VECTOR2,
+    .argument_count = 1,
+    .arguments = { { "rid", GDEXTENSION_VARIANT_TYPE_RID } },
+  },
+  {
+    .name = "entity_set_velocity",
+    .func = server_entity_set_velocity,
+    .return_type = GDEXTENSION_VARIANT_TYPE_NIL,
+    .argument_count = 2,
+    .arguments = {
+      { "rid", GDEXTENSION_VARIANT_TYPE_RID },
+      { "velocity", GDEXTENSION_VARIANT_TYPE_VECTOR2 },
+    },
+  },
+  {
+    .name = "entity_get_velocity",
+    .func = server_entity_get_velocity,
+    .return_type = GDEXTENSION_VARIANT_TYPE_VECTOR2,
+    .argument_count = 1,
+    .arguments = { { "rid", GDEXTENSION_VARIANT_TYPE_RID } },
+  },
+  {
+    .name = "set_bounds",
+    .func = server_set_bounds,
+    .return_type = GDEXTENSION_VARIANT_TYPE_NIL,
+    .argument_count = 1,
+    .arguments = { { "bounds", GDEXTENSION_VARIANT_TYPE_RECT2 } },
+  },
+  {
+    .name = "spawn",
+    .func = server_spawn,
+    .return_type = GDEXTENSION_VARIANT_TYPE_INT,
+    .argument_count = 1,
+    .arguments = { { "count", GDEXTENSION_VARIANT_TYPE_INT } },
+  },
+  {
+    .name = "clear",
+    .func = server_clear,
+    .return_type = GDEXTENSION_VARIANT_TYPE_NIL,
+    .argument_count = 0,
+  },
+  {
+    .name = "step",
+    .func = server_step,
+    .return_type = GDEXTENSION_VARIANT_TYPE_NIL,
+    .argument_count = 1,
+    .arguments = { { "delta", GDEXTENSION_VARIANT_TYPE_FLOAT } },
+  },
+  {
+    .name = "set_multimesh",
+    .func = server_set_multimesh,
+    .return_type = GDEXTENSION_VARIANT_TYPE_NIL,
+    .argument_count = 1,
+    .arguments = { { "multimesh", GDEXTENSION_VARIANT_TYPE_RID } },
+  },
+  {
+    .name = "get_entity_count",
+    .func = server_get_entity_count,
+    .return_type = GDEXTENSION_VARIANT_TYPE_INT,
+    .argument_count = 0,
+  },
+  {
+    .name = "get_bytes_per_entity",
+    .func = server_get_bytes_per_entity,
+    .return_type = GDEXTENSION_VARIANT_TYPE_FLOAT,
+    .argument_count = 0,
+  },
+};
+
+#define SERVER_METHOD_COUNT (sizeof(server_methods) / sizeof(server_methods[0]))
+
+// Types the methods use, their wrap/unwrap functions are fetched on load
+const GDExtensionVariantType server_method_types[] = {
+  GDEXTENSION_VARIANT_TYPE_BOOL,
+  GDEXTENSION_VARIANT_TYPE_INT,
+  GDEXTENSION_VARIANT_TYPE_FLOAT,
+  GDEXTENSION_VARIANT_TYPE_VECTOR2,
+  GDEXTENSION_VARIANT_TYPE_RECT2,
+  GDEXTENSION_VARIANT_TYPE_RID,
+};
+
+void
+server_method_call(
+  void *method_userdata,
+  GDExtensionClassInstancePtr p_instance,
+  const GDExtensionConstVariantPtr *p_args,
+  GDExtensionInt p_argument_count,
+  GDExtensionVariantPtr r_return,
+  GDExtensionCallError *r_error
+) {
+  const server_method_t *method = method_userdata;
+  if (p_argument_count != method->argument_count) {
+    r_error->error = p_argument_count < method->argument_count
+      ? GDEXTENSION_CALL_ERROR_TOO_FEW_ARGUMENTS
+      : GDEXTENSION_CALL_ERROR_TOO_MANY_ARGUMENTS;
+    r_error->argument = 0;
+    r_error->expected = method->argument_count;
+    return;
+  }
+
+  // Big enough for every type in `server_method_types`
+  _Alignas(8) uint8_t arguments[SERVER_MAX_ARGUMENTS][VARIANT_SIZE];
+  GDExtensionConstTypePtr args[SERVER_MAX_ARGUMENTS];
+  for (int i = 0; i < method->argument_count; i++) {
+    GDExtensionVariantType type = method->arguments[i].type;
+    GDExtensionVariantType given = gd_extension.variant_get_type(p_args[i]);
+    // `step(1)` is fine, the int is converted like Godot's own methods do
+    if (type == GDEXTENSION_VARIANT_TYPE_FLOAT && given == GDEXTENSION_VARIANT_TYPE_INT) {
+      GDExtensionInt value;
+      gd_extension_helper.unwrap.type[GDEXTENSION_VARIANT_TYPE_INT](&value, (void *)p_args[i]);
+      *(double *)arguments[i] = (double)value;
+    } else if (given == type) {
+      gd_extension_helper.unwrap.type[type](arguments[i], (void *)p_args[i]);
+    } else {
+      r_error->error = GDEXTENSION_CALL_ERROR_INVALID_ARGUMENT;
+      r_error->argument = i;
+      r_error->expected = type;
+      return;
+    }
+    args[i] = arguments[i];
+  }
+
+  r_error->error = GDEXTENSION_CALL_OK;
+  _Alignas(8) uint8_t ret[VARIANT_SIZE] = { 0 };
+  method->func(&((server_object_t *)p_instance)->server, args, ret);
+  if (method->return_type != GDEXTENSION_VARIANT_TYPE_NIL) {
+    gd_extension_helper.wrap.type[method->return_type](r_return, ret);
+  }
+}
+
+void
+server_method_ptrcall(
+  void *method_userdata,
+  GDExtensionClassInstancePtr p_instance,
+  const GDExtensionConstTypePtr *p_args,
+  GDExtensionTypePtr r_ret
+) {
+  const server_method_t *method = method_userdata;
+  method->func(&((server_object_t *)p_instance)->server, p_args, r_ret);
+}
+
+GDExtensionPropertyInfo make_property_info(GDExtensionVariantType type, const char *name) {
+  GDExtensionPropertyInfo res = {
+    .type = type,
+    .name = construct_string_name(name),
+    .class_name = construct_string_name(""),
+    .hint = 0, // Corresponds to no hints
+    .hint_string = construct_string(""),
+    .usage = PROPERTY_USAGE_DEFAULT,
+  };
+  return res;
+}
+
+void destruct_property_info(GDExtensionPropertyInfo *p_info) {
+  destruct_string_name(p_info->name);
+  destruct_string_name(p_info->class_name);
+  destruct_string(p_info->hint_string);
+}
+
+GDExtensionClassMethodArgumentMetadata metadata_for(GDExtensionVariantType type) {
+  switch (type) {
+    case GDEXTENSION_VARIANT_TYPE_INT:
+      return GDEXTENSION_METHOD_ARGUMENT_METADATA_INT_IS_INT64;
+    case GDEXTENSION_VARIANT_TYPE_FLOAT:
+      return GDEXTENSION_METHOD_ARGUMENT_METADATA_REAL_IS_DOUBLE;
+    default:
+      return GDEXTENSION_METHOD_ARGUMENT_METADATA_NONE;
+  }
+}
+
+void register_server_methods(GDExtensionConstStringNamePtr class_string_name) {
+  for (size_t m = 0; m < SERVER_METHOD_COUNT; m++) {
+    const server_method_t *method = &server_methods[m];
+    GDExtensionPropertyInfo arguments[SERVER_MAX_ARGUMENTS];
+    GDExtensionClassMethodArgumentMetadata arguments_metadata[SERVER_MAX_ARGUMENTS];
+    for (int i = 0; i < method->argument_count; i++) {
+      arguments[i] = make_property_info(method->arguments[i].type, method->arguments[i].name);
+      arguments_metadata[i] = metadata_for(method->arguments[i].type);
+    }
+    GDExtensionPropertyInfo return_value = make_property_info(method->return_type, "");
+
+    GDExtensionClassMethodInfo info = {
+      .name = construct_string_name(method->name),
+      .method_userdata = (void *)method,
+      .call_func = server_method_call,
+      .ptrcall_func = server_method_ptrcall,
+      .method_flags = GDEXTENSION_METHOD_FLAG_NORMAL,
+      .has_return_value = method->return_type != GDEXTENSION_VARIANT_TYPE_NIL,
+      .return_value_info = method->return_type != GDEXTENSION_VARIANT_TYPE_NIL ? &return_value : NULL,
+      .return_value_metadata = metadata_for(method->return_type),
+      .argument_count = method->argument_count,
+      .arguments_info = arguments,
+      .arguments_metadata = arguments_metadata,
+      .default_argument_count = 0,
+      .default_arguments = NULL,
+    };
+    gd_extension.classdb_register_extension_class_method(gd_extension_helper.misc.p_library,
+                                                         class_string_name,
+                                                         &info);
+
+    for (int i = 0; i < method->argument_count; i++) destruct_property_info(&arguments[i]);
+    destruct_property_info(&return_value);
+    destruct_string_name(info.name);
+  }
+}
+
+void register_server_class() {
+  GDExtensionClassCreationInfo2 class_info = {
+    .is_virtual = false,
+    .is_abstract = false,
+    .is_exposed = true,
+    .set_func = NULL,
+    .get_func = NULL,
+    .get_property_list_func = NULL,
+    .free_property_list_func = NULL,
+    .property_can_revert_func = NULL,
+    .property_get_revert_func = NULL,
+    .validate_property_func = NULL,
+    .notification_func = NULL,
+    .to_string_func = NULL,
+    .reference_func = NULL,
+    .unreference_func = NULL,
+    .create_instance_func = server_object_init,
+    .free_instance_func = server_object_deinit,
+    .recreate_instance_func = NULL,
+    .get_virtual_func = NULL,
+    .get_virtual_call_data_func = NULL,
+    .call_virtual_with_data_func = NULL,
+    // The server is a singleton, not a resource. An object wrapping one
+    // entity would answer with `rid_storage_get_rid`, RIDs are already the
+    // uint64_t this callback returns.
+    .get_rid_func = NULL,
+    .class_userdata = NULL,
+  };
+
+  void *my_class_string_name = construct_string_name(SERVER_CLASS_NAME);
+  void *parent_class_string_name = construct_string_name(SERVER_CLASS_PARENT);
+
+  gd_extension.classdb_register_extension_class2(gd_extension_helper.misc.p_library,
+                                                 my_class_string_name,
+                                                 parent_class_string_name,
+                                                 &class_info);
+  register_server_methods(my_class_string_name);
+
+  destruct_string_name(my_class_string_name);
+  destruct_string_name(parent_class_string_name);
+}
+
+// ---------------------------------------------------------------------------
+// Entities vs Nodes
+// ---------------------------------------------------------------------------
+
+// OS.get_static_memory_usage, only tracked in debug builds of Godot
+GDExtensionInt static_memory_usage() {
+  void *os_string_name = construct_string_name("OS");
+  void *method_string_name = construct_string_name("get_static_memory_usage");
+  GDExtensionObjectPtr os = gd_extension.global_get_singleton(os_string_name);
+
+  GDExtensionInt res = 0;
+  uint8_t ret[VARIANT_SIZE];
+  if (object_call(os, method_string_name, NULL, 0, ret)) {
+    gd_extension_helper.unwrap.type[GDEXTENSION_VARIANT_TYPE_INT](&res, ret);
+  }
+  gd_extension.variant_destroy(ret);
+
+  destruct_string_name(os_string_name);
+  destruct_string_name(method_string_name);
+  return res;
+}
+
+// A million entities against ten thousand Node2Ds, per entity. The Nodes
+// aren't in the tree, so their cost per frame isn't even counted.
+void print_entities_vs_nodes() {
+  entity_server_t server;
+  entity_server_init(&server);
+
+  uint64_t start = now_ns();
+  GDExtensionInt spawned = entity_server_spawn(&server, BENCHMARK_ENTITIES);
+  uint64_t spawn_ns = now_ns() - start;
+
+  // What `step` writes for the MultiMesh, without sending it anywhere
+  packed_float32_array_resize(&server.transforms, (GDExtensionInt)server.storage.capacity * FLOATS_PER_TRANSFORM_2D);
+  float *transforms = gd_extension.packed_float32_array_operator_index(&server.transforms, 0);
+  start = now_ns();
+  for (int i = 0; i < BENCHMARK_STEPS; i++) {
+    entity_server_integrate(&server, 1.0f / 60.0f);
+    entity_server_write_transforms(&server, transforms);
+  }
+  uint64_t step_ns = (now_ns() - start) / BENCHMARK_STEPS;
+
+  printf("%lld entities: %.1f bytes each, spawned in %.1f ms, step in %.2f ms (%.2f ns per entity)\n",
+         (long long)spawned,
+         entity_server_bytes_per_entity(&server),
+         spawn_ns / 1e6,
+         step_ns / 1e6,
+         spawned > 0 ? (double)step_ns / spawned : 0.0);
+  entity_server_destroy(&server);
+
+  GDExtensionObjectPtr *nodes = malloc(BENCHMARK_NODES * sizeof(GDExtensionObjectPtr));
+  void *node_string_name = construct_string_name("Node2D");
+  GDExtensionInt memory_before = static_memory_usage();
+  start = now_ns();
+  for (int i = 0; i < BENCHMARK_NODES; i++) {
+    nodes[i] = gd_extension.classdb_construct_object(node_string_name);
+  }
+  uint64_t create_ns = now_ns() - start;
+  GDExtensionInt memory_after = static_memory_usage();
+  for (int i = 0; i < BENCHMARK_NODES; i++) gd_extension.object_destroy(nodes[i]);
+  destruct_string_name(node_string_name);
+  free(nodes);
+
+  if (memory_after > memory_before) {
+    printf("%d Node2Ds: %.1f bytes each, created in %.1f ms\n",
+           BENCHMARK_NODES,
+           (double)(memory_after - memory_before) / BENCHMARK_NODES,
+           create_ns / 1e6);
+  } else {
+    printf("%d Node2Ds: created in %.1f ms, memory use needs a debug build of Godot\n",
+           BENCHMARK_NODES,
+           create_ns / 1e6);
+  }
+}
+
+void godot_initialize(void *userdata, GDExtensionInitializationLevel p_level) {
+  if (p_level == GDEXTENSION_INITIALIZATION_SCENE) {
+    void *size_string_name = construct_string_name("size");
+    void *resize_string_name = construct_string_name("resize");
+    gd_extension_helper.builtin_method.packed_float32_array_size
+      = gd_extension.variant_get_ptr_builtin_method(GDEXTENSION_VARIANT_TYPE_PACKED_FLOAT32_ARRAY,
+                                                    size_string_name,
+                                                    PACKED_SIZE_HASH);
+    gd_extension_helper.builtin_method.packed_float32_array_resize
+      = gd_extension.variant_get_ptr_builtin_method(GDEXTENSION_VARIANT_TYPE_PACKED_FLOAT32_ARRAY,
+                                                    resize_string_name,
+                                                    PACKED_RESIZE_HASH);
+    destruct_string_name(size_string_name);
+    destruct_string_name(resize_string_name);
+
+    void *rendering_server_string_name = construct_string_name("RenderingServer");
+    gd_extension_helper.misc.rendering_server = gd_extension.global_get_singleton(rendering_server_string_name);
+    destruct_string_name(rendering_server_string_name);
+    gd_extension_helper.misc.multimesh_allocate_data = construct_string_name("multimesh_allocate_data");
+    gd_extension_helper.misc.multimesh_set_buffer = construct_string_name("multimesh_set_buffer");
+    gd_extension_helper.misc.multimesh_set_visible_instances = construct_string_name("multimesh_set_visible_instances");
+
+    register_server_class();
+
+    void *server_string_name = construct_string_name(SERVER_CLASS_NAME);
+    gd_extension_helper.misc.server = gd_extension.classdb_construct_object(server_string_name);
+    destruct_string_name(server_string_name);
+    engine_call_with_server("register_singleton");
+
+    print_entities_vs_nodes();
+    return;
+  }
+}
+
+void godot_deinitialize(void *userdata, GDExtensionInitializationLevel p_level) {
+  if (p_level == GDEXTENSION_INITIALIZATION_SCENE) {
+    engine_call_with_server("unregister_singleton");
+    gd_extension.object_destroy(gd_extension_helper.misc.server);
+    gd_extension_helper.misc.server = NULL;
+
+    destruct_string_name(gd_extension_helper.misc.multimesh_allocate_data);
+    destruct_string_name(gd_extension_helper.misc.multimesh_set_buffer);
+    destruct_string_name(gd_extension_helper.misc.multimesh_set_visible_instances);
+  }
+}
+
+GDExtensionBool
+godot_entry(
+  GDExtensionInterfaceGetProcAddress p_get_proc_address,
+  const GDExtensionClassLibraryPtr p_library,
+  GDExtensionInitialization *r_initialization
+) {
+  r_initialization->minimum_initialization_level = GDEXTENSION_INITIALIZATION_SCENE;
+  r_initialization->userdata = NULL;
+  r_initialization->initialize = godot_initialize;
+  r_initialization->deinitialize = godot_deinitialize;
+
+  STORE_GD_EXTENSION(classdb_construct_object);
+  STORE_GD_EXTENSION(classdb_register_extension_class2);
+  STORE_GD_EXTENSION(classdb_register_extension_class_method);
+  STORE_GD_EXTENSION(string_name_new_with_utf8_chars);
+  STORE_GD_EXTENSION(string_new_with_utf8_chars);
+  STORE_GD_EXTENSION(object_set_instance);
+  STORE_GD_EXTENSION(object_destroy);
+  STORE_GD_EXTENSION(global_get_singleton);
+  STORE_GD_EXTENSION(variant_get_ptr_destructor);
+  STORE_GD_EXTENSION(variant_get_ptr_constructor);
+  STORE_GD_EXTENSION(variant_get_ptr_builtin_method);
+  STORE_GD_EXTENSION(get_variant_from_type_constructor);
+  STORE_GD_EXTENSION(get_variant_to_type_constructor);
+  STORE_GD_EXTENSION(variant_get_type);
+  STORE_GD_EXTENSION(variant_call);
+  STORE_GD_EXTENSION(variant_destroy);
+  STORE_GD_EXTENSION(packed_float32_array_operator_index);
+
+  gd_extension_helper.misc.p_library = p_library;
+
+  gd_extension_helper.destructor.string_name
+    = gd_extension.variant_get_ptr_destructor(GDEXTENSION_VARIANT_TYPE_STRING_NAME);
+  gd_extension_helper.destructor.string
+    = gd_extension.variant_get_ptr_destructor(GDEXTENSION_VARIANT_TYPE_STRING);
+  gd_extension_helper.destructor.packed_float32_array
+    = gd_extension.variant_get_ptr_destructor(GDEXTENSION_VARIANT_TYPE_PACKED_FLOAT32_ARRAY);
+
+  gd_extension_helper.constructor.packed_float32_array
+    = gd_extension.variant_get_ptr_constructor(GDEXTENSION_VARIANT_TYPE_PACKED_FLOAT32_ARRAY, 0);
+
+  for (size_t i = 0; i < sizeof(server_method_types) / sizeof(server_method_types[0]); i++) {
+    GDExtensionVariantType type = server_method_types[i];
+    gd_extension_helper.wrap.type[type] = gd_extension.get_variant_from_type_constructor(type);
+    gd_extension_helper.unwrap.type[type] = gd_extension.get_variant_to_type_constructor(type);
+  }
+  const GDExtensionVariantType other_types[] = {
+    GDEXTENSION_VARIANT_TYPE_OBJECT,
+    GDEXTENSION_VARIANT_TYPE_STRING_NAME,
+    GDEXTENSION_VARIANT_TYPE_PACKED_FLOAT32_ARRAY,
+  };
+  for (size_t i = 0; i < sizeof(other_types) / sizeof(other_types[0]); i++) {
+    gd_extension_helper.wrap.type[other_types[i]] = gd_extension.get_variant_from_type_constructor(other_types[i]);
+  }
+
+  return true;
+}
@@ -0,0 +1,815 @@
+#include "../godot-headers/gdextension_interface.h"
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <math.h>
+
+#define STORE_GD_EXTENSION(str_name) gd_extension.str_name = (void *)p_get_proc_address(#str_name);
+#define IS_GODOT_64_BIT (true)
+#define IS_GODOT_USING_LARGE_WORLD_COORDINATES (false)
+#define VARIANT_SIZE (IS_GODOT_USING_LARGE_WORLD_COORDINATES ? 40 : 24)
+#define MY_CUSTOM_CLASS_NAME ("MyCustomNode")
+#define MY_CUSTOM_CLASS_PARENT ("Sprite2D")
+#define ARRAY_SIZE (8)
+#define PACKED_ARRAY_SIZE (16)
+
+#include "../util/variant_unwrap.h"
+
+struct {
+  GDExtensionInterfaceClassdbConstructObject classdb_construct_object;
+  GDExtensionInterfaceClassdbRegisterExtensionClass2 classdb_register_extension_class2;
+  GDExtensionInterfaceClassdbGetMethodBind classdb_get_method_bind;
+  GDExtensionInterfaceStringNameNewWithUtf8Chars string_name_new_with_utf8_chars;
+  GDExtensionInterfaceStringNewWithUtf8Chars string_new_with_utf8_chars;
+  GDExtensionInterfaceObjectSetInstance object_set_instance;
+  GDExtensionInterfaceVariantGetPtrDestructor variant_get_ptr_destructor;
+  GDExtensionInterfaceVariantEvaluate variant_evaluate;
+  GDExtensionInterfaceGetVariantFromTypeConstructor get_variant_from_type_constructor;
+  GDExtensionInterfaceGetVariantToTypeConstructor get_variant_to_type_constructor;
+  GDExtensionInterfaceVariantGetPtrOperatorEvaluator variant_get_ptr_operator_evaluator;
+  GDExtensionInterfaceVariantGetType variant_get_type;
+  GDExtensionInterfaceObjectMethodBindPtrcall object_method_bind_ptrcall;
+  GDExtensionInterfaceObjectSetInstanceBinding object_set_instance_binding;
+  GDExtensionInterfaceObjectGetInstanceBinding object_get_instance_binding;
+  GDExtensionInterfaceObjectGetInstanceFromId object_get_instance_from_id;
+  GDExtensionInterfaceObjectCastTo object_cast_to;
+  GDExtensionInterfaceClassdbGetClassTag classdb_get_class_tag;
+  GDExtensionInterfaceClassdbRegisterExtensionClassMethod classdb_register_extension_class_method;
+  GDExtensionInterfaceVariantGetPtrBuiltinMethod variant_get_ptr_builtin_method;
+  GDExtensionInterfaceVariantGetPtrConstructor variant_get_ptr_constructor;
+  GDExtensionInterfaceArrayOperatorIndex array_operator_index;
+  GDExtensionInterfaceArrayOperatorIndexConst array_operator_index_const;
+  GDExtensionInterfaceArrayRef array_ref;
+  GDExtensionInterfacePackedFloat64ArrayOperatorIndex packed_float64_array_operator_index;
+  GDExtensionInterfacePackedFloat64ArrayOperatorIndexConst packed_float64_array_operator_index_const;
+} gd_extension;
+
+struct {
+  struct {
+    GDExtensionPtrDestructor string_name;
+    GDExtensionPtrDestructor string;
+    GDExtensionPtrDestructor array;
+    GDExtensionPtrDestructor packed_float64_array;
+  } destructor;
+  struct {
+    GDExtensionPtrConstructor array;
+    GDExtensionPtrConstructor packed_float64_array;
+  } constructor;
+  struct {
+    GDExtensionPtrBuiltInMethod array_size;
+    GDExtensionPtrBuiltInMethod array_resize;
+    GDExtensionPtrBuiltInMethod packed_float64_array_size;
+    GDExtensionPtrBuiltInMethod packed_float64_array_resize;
+  } builtin_method;
+  struct {
+    GDExtensionVariantFromTypeConstructorFunc type_double;
+    GDExtensionVariantFromTypeConstructorFunc type_int;
+    GDExtensionVariantFromTypeConstructorFunc array;
+    GDExtensionVariantFromTypeConstructorFunc packed_float64_array;
+  } wrap;
+  struct {
+    GDExtensionTypeFromVariantConstructorFunc object;
+    GDExtensionTypeFromVariantConstructorFunc type_int;
+    GDExtensionTypeFromVariantConstructorFunc array;
+    GDExtensionTypeFromVariantConstructorFunc packed_float64_array;
+  } unwrap;
+  struct {
+    GDExtensionStringNamePtr amplitude;
+    GDExtensionStringNamePtr frequency;
+    GDExtensionStringNamePtr _process;
+    GDExtensionStringNamePtr position;
+  } string_name;
+  struct {
+    GDExtensionClassLibraryPtr p_library;
+    GDExtensionPtrOperatorEvaluator string_name_eq_op;
+    GDExtensionMethodBindPtr node2d_set_position;
+    void *my_custom_class_tag;
+  } misc;
+} gd_extension_helper;
+
+#if (IS_GODOT_USING_LARGE_WORLD_COORDINATES)
+typedef struct {
+  double x;
+  double y;
+} GDVector2;
+#else
+typedef struct {
+  float x;
+  float y;
+} GDVector2;
+#endif
+
+GDExtensionStringNamePtr construct_string_name(const char *c_string) {
+  void *res = malloc(IS_GODOT_64_BIT ? 8 : 4);
+  gd_extension.string_name_new_with_utf8_chars(res, c_string);
+  return res;
+}
+
+GDExtensionStringPtr construct_string(const char *c_string) {
+  void *res = malloc(IS_GODOT_64_BIT ? 8 : 4);
+  gd_extension.string_new_with_utf8_chars(res, c_string);
+  return res;
+}
+
+void destruct_string_name(GDExtensionStringNamePtr p) {
+  gd_extension_helper.destructor.string_name(p);
+}
+
+void destruct_string(GDExtensionStringPtr p) {
+  gd_extension_helper.destructor.string(p);
+}
+
+typedef struct {
+  GDExtensionObjectPtr godot_object;
+  double time_elapsed;
+  struct {
+    double amplitude;
+    double frequency;
+  } prop_state;
+} my_custom_class_t;
+
+struct {
+  const char *name;
+  const GDExtensionVariantType type;
+} my_custom_class_props[] = {
+  {
+    .name = "frequency",
+    .type = GDEXTENSION_VARIANT_TYPE_FLOAT,
+  },
+  {
+    .name = "amplitude",
+    .type = GDEXTENSION_VARIANT_TYPE_FLOAT,
+  }
+};
+
+const GDExtensionPropertyInfo *
+my_custom_class_get_property_list(
+  GDExtensionClassInstancePtr p_instance,
+  uint32_t *r_count
+) {
+  size_t n = sizeof(my_custom_class_props) / sizeof(*my_custom_class_props);
+  *r_count = n;
+
+  GDExtensionPropertyInfo *res = malloc(n * sizeof(GDExtensionPropertyInfo));
+
+  for (size_t i = 0; i < n; i++) {
+    res[i].type = my_custom_class_props[i].type;
+    res[i].name = construct_string_name(my_custom_class_props[i].name);
+    res[i].class_name = construct_string_name(MY_CUSTOM_CLASS_NAME);
+    res[i].hint = 0; // Corresponds to no hints
+    res[i].hint_string = construct_string("");
+    res[i].usage = 6; // Corresponds to default usage flags
+  }
+
+  return res;
+}
+
+void
+my_custom_class_free_property_list(
+  GDExtensionClassInstancePtr p_instance,
+  const GDExtensionPropertyInfo *p_list
+) {
+  size_t n = sizeof(my_custom_class_props) / sizeof(*my_custom_class_props);
+
+  for (size_t i = 0; i < n; i++) {
+    destruct_string_name((void*)p_list[i].name);
+    destruct_string((void*)p_list[i].hint_string);
+    destruct_string_name((void*)p_list[i].class_name);
+  }
+
+  free((void*)p_list);
+}
+
+void *my_custom_class_binding_create(void *p_token, void *p_instance) {
+  // NOTE: Bindings are only made in `my_custom_class_init`, an object without
+  // one is not ours.
+  return NULL;
+}
+
+void my_custom_class_binding_free(void *p_token, void *p_instance, void *p_binding) {
+  // NOTE: The binding is our instance struct and it's freed in
+  // `my_custom_class_deinit`.
+}
+
+GDExtensionBool
+my_custom_class_binding_reference(void *p_token, void *p_binding, GDExtensionBool p_reference) {
+  return true;
+}
+
+const GDExtensionInstanceBindingCallbacks my_custom_class_binding_callbacks = {
+  .create_callback = my_custom_class_binding_create,
+  .free_callback = my_custom_class_binding_free,
+  .reference_callback = my_custom_class_binding_reference,
+};
+
+GDExtensionObjectPtr my_custom_class_init(void *userdata) {
+  my_custom_class_t *my_instance = malloc(sizeof(my_custom_class_t));
+
+  void *my_class_string_name = construct_string_name(MY_CUSTOM_CLASS_NAME);
+  void *parent_class_string_name = construct_string_name(MY_CUSTOM_CLASS_PARENT);
+
+  my_instance->godot_object = gd_extension.classdb_construct_object(parent_class_string_name);
+  my_instance->time_elapsed = 0.0;
+  my_instance->prop_state.amplitude = 1.23;
+  my_instance->prop_state.frequency = 2.45;
+  gd_extension.object_set_instance(my_instance->godot_object, my_class_string_name, my_instance);
+  // The binding lets us go from a Godot object back to `my_instance` which is
+  // what the bulk methods need.
+  gd_extension.object_set_instance_binding(my_instance->godot_object,
+                                           gd_extension_helper.misc.p_library,
+                                           my_instance,
+                                           &my_custom_class_binding_callbacks);
+
+  destruct_string_name(my_class_string_name);
+  destruct_string_name(parent_class_string_name);
+
+  printf("Hey, instancing is done!\n");
+
+  return my_instance->godot_object;
+}
+
+void my_custom_class_deinit(void *userdata, GDExtensionClassInstancePtr p_instance) {
+  if (p_instance == NULL) return;
+
+  my_custom_class_t *my_instance = p_instance;
+  free(my_instance);
+
+  printf("my_custom_class is going down, goodbye world!\n");
+}
+
+bool string_name_eq(const void *a, const void *b) {
+  GDExtensionBool res;
+  gd_extension_helper.misc.string_name_eq_op(a, b, &res);
+  return res;
+}
+
+GDExtensionBool
+my_custom_class_set_func(
+  GDExtensionClassInstancePtr p_instance,
+  GDExtensionConstStringNamePtr p_name,
+  GDExtensionConstVariantPtr p_value
+) {
+  my_custom_class_t *my_instance = p_instance;
+
+  if (string_name_eq(p_name, gd_extension_helper.string_name.frequency)) {
+    return variant_unwrap_float(p_value, &my_instance->prop_state.frequency);
+  }
+
+  if (string_name_eq(p_name, gd_extension_helper.string_name.amplitude)) {
+    return variant_unwrap_float(p_value, &my_instance->prop_state.amplitude);
+  }
+
+  return false;
+}
+
+GDExtensionBool
+my_custom_class_get_func(
+  GDExtensionClassInstancePtr p_instance,
+  GDExtensionConstStringNamePtr p_name,
+  GDExtensionVariantPtr r_ret
+) {
+  my_custom_class_t *my_instance = p_instance;
+
+  if (string_name_eq(p_name, gd_extension_helper.string_name.frequency)) {
+    gd_extension_helper.wrap.type_double(r_ret, &(my_instance->prop_state.frequency));
+    return true;
+  }
+
+  if (string_name_eq(p_name, gd_extension_helper.string_name.amplitude)) {
+    gd_extension_helper.wrap.type_double(r_ret, &(my_instance->prop_state.amplitude));
+    return true;
+  }
+
+  return false;
+}
+
+void
+my_custom_class__process_override(
+   GDExtensionClassInstancePtr p_instance,
+   const GDExtensionConstTypePtr *p_args,
+   GDExtensionTypePtr r_ret
+) {
+  my_custom_class_t *my_instance = p_instance;
+  my_instance->time_elapsed += *((double*)(p_args[0]));
+
+  double t = my_instance->time_elapsed;
+  double A = my_instance->prop_state.amplitude;
+  double w = my_instance->prop_state.frequency;
+
+  const GDVector2 new_position = {
+    .x = 0,
+    .y = A * sin(w * t),
+  };
+
+  GDExtensionConstTypePtr args[] = { &new_position };
+
+  gd_extension.object_method_bind_ptrcall(gd_extension_helper.misc.node2d_set_position,
+                                          my_instance->godot_object,
+                                          args,
+                                          NULL);
+
+  r_ret = NULL;
+}
+
+GDExtensionInt array_size(GDExtensionConstTypePtr p_array) {
+  GDExtensionInt res;
+  gd_extension_helper.builtin_method.array_size((void *)p_array, NULL, &res, 0);
+  return res;
+}
+
+GDExtensionInt packed_float64_array_size(GDExtensionConstTypePtr p_array) {
+  GDExtensionInt res;
+  gd_extension_helper.builtin_method.packed_float64_array_size((void *)p_array, NULL, &res, 0);
+  return res;
+}
+
+// Accepts both a MyCustomNode object and its instance ID, returns NULL for
+// anything else (freed objects, other classes, wrong variant types).
+my_custom_class_t *my_custom_class_from_variant(GDExtensionConstVariantPtr p_variant) {
+  GDExtensionObjectPtr object = NULL;
+
+  switch (gd_extension.variant_get_type(p_variant)) {
+  case GDEXTENSION_VARIANT_TYPE_OBJECT:
+    gd_extension_helper.unwrap.object(&object, (void *)p_variant);
+    break;
+  case GDEXTENSION_VARIANT_TYPE_INT: {
+    GDExtensionInt instance_id;
+    gd_extension_helper.unwrap.type_int(&instance_id, (void *)p_variant);
+    object = gd_extension.object_get_instance_from_id(instance_id);
+    break;
+  }
+  default:
+    return NULL;
+  }
+
+  if (object == NULL) return NULL;
+  if (gd_extension.object_cast_to(object, gd_extension_helper.misc.my_custom_class_tag) == NULL) {
+    return NULL;
+  }
+
+  return gd_extension.object_get_instance_binding(object,
+                                                  gd_extension_helper.misc.p_library,
+                                                  &my_custom_class_binding_callbacks);
+}
+
+// Returns the number of nodes that were updated. Entries that don't resolve to
+// a MyCustomNode are skipped.
+GDExtensionInt
+my_custom_class_bulk_set(
+  GDExtensionConstTypePtr p_nodes,
+  GDExtensionConstTypePtr p_amplitudes,
+  GDExtensionConstTypePtr p_frequencies
+) {
+  GDExtensionInt n = array_size(p_nodes);
+
+  if (packed_float64_array_size(p_amplitudes) != n || packed_float64_array_size(p_frequencies) != n) {
+    fprintf(stderr, "bulk_set: nodes, amplitudes and frequencies must have the same size\n");
+    return 0;
+  }
+  if (n == 0) return 0;
+
+  // One interface call per array gives us the whole buffer
+  const double *amplitudes = gd_extension.packed_float64_array_operator_index_const(p_amplitudes, 0);
+  const double *frequencies = gd_extension.packed_float64_array_operator_index_const(p_frequencies, 0);
+
+  GDExtensionInt applied = 0;
+  for (GDExtensionInt i = 0; i < n; i++) {
+    my_custom_class_t *my_instance
+      = my_custom_class_from_variant(gd_extension.array_operator_index_const(p_nodes, i));
+    if (my_instance == NULL) continue;
+
+    my_instance->prop_state.amplitude = amplitudes[i];
+    my_instance->prop_state.frequency = frequencies[i];
+    applied++;
+  }
+
+  return applied;
+}
+
+// Writes `[amplitudes, frequencies]` into an already constructed Array. Entries
+// that don't resolve to a MyCustomNode are reported as NAN.
+void my_custom_class_bulk_get(GDExtensionConstTypePtr p_nodes, GDExtensionTypePtr r_result) {
+  GDExtensionInt n = array_size(p_nodes);
+
+  unsigned char amplitudes[PACKED_ARRAY_SIZE];
+  unsigned char frequencies[PACKED_ARRAY_SIZE];
+  gd_extension_helper.constructor.packed_float64_array(&amplitudes, NULL);
+  gd_extension_helper.constructor.packed_float64_array(&frequencies, NULL);
+
+  GDExtensionInt resize_result;
+  GDExtensionConstTypePtr resize_args[] = { &n };
+  gd_extension_helper.builtin_method.packed_float64_array_resize(&amplitudes, resize_args, &resize_result, 1);
+  gd_extension_helper.builtin_method.packed_float64_array_resize(&frequencies, resize_args, &resize_result, 1);
+
+  if (n > 0) {
+    double *amplitude_data = gd_extension.packed_float64_array_operator_index(&amplitudes, 0);
+    double *frequency_data = gd_extension.packed_float64_array_operator_index(&frequencies, 0);
+
+    for (GDExtensionInt i = 0; i < n; i++) {
+      my_custom_class_t *my_instance
+        = my_custom_class_from_variant(gd_extension.array_operator_index_const(p_nodes, i));
+
+      amplitude_data[i] = my_instance != NULL ? my_instance->prop_state.amplitude : NAN;
+      frequency_data[i] = my_instance != NULL ? my_instance->prop_state.frequency : NAN;
+    }
+  }
+
+  GDExtensionInt two = 2;
+  GDExtensionConstTypePtr result_resize_args[] = { &two };
+  gd_extension_helper.builtin_method.array_resize(r_result, result_resize_args, &resize_result, 1);
+  // NOTE: resize filled the slots with Nil variants, so there is nothing to destroy
+  gd_extension_helper.wrap.packed_float64_array(gd_extension.array_operator_index(r_result, 0), &amplitudes);
+  gd_extension_helper.wrap.packed_float64_array(gd_extension.array_operator_index(r_result, 1), &frequencies);
+
+  gd_extension_helper.destructor.packed_float64_array(&amplitudes);
+  gd_extension_helper.destructor.packed_float64_array(&frequencies);
+}
+
+void
+my_custom_class_bulk_set_ptrcall(
+  void *method_userdata,
+  GDExtensionClassInstancePtr p_instance,
+  const GDExtensionConstTypePtr *p_args,
+  GDExtensionTypePtr r_ret
+) {
+  *(GDExtensionInt *)r_ret = my_custom_class_bulk_set(p_args[0], p_args[1], p_args[2]);
+}
+
+void
+my_custom_class_bulk_get_ptrcall(
+  void *method_userdata,
+  GDExtensionClassInstancePtr p_instance,
+  const GDExtensionConstTypePtr *p_args,
+  GDExtensionTypePtr r_ret
+) {
+  // NOTE: ptrcall hands us an already constructed Array, so we fill a local one
+  // and make `r_ret` reference it.
+  unsigned char result[ARRAY_SIZE];
+  gd_extension_helper.constructor.array(&result, NULL);
+  my_custom_class_bulk_get(p_args[0], &result);
+  gd_extension.array_ref(r_ret, &result);
+  gd_extension_helper.destructor.array(&result);
+}
+
+bool
+check_call_args(
+  const GDExtensionConstVariantPtr *p_args,
+  GDExtensionInt p_argument_count,
+  const GDExtensionVariantType *expected_types,
+  GDExtensionInt expected_count,
+  GDExtensionCallError *r_error
+) {
+  if (p_argument_count != expected_count) {
+    r_error->error = p_argument_count < expected_count
+      ? GDEXTENSION_CALL_ERROR_TOO_FEW_ARGUMENTS
+      : GDEXTENSION_CALL_ERROR_TOO_MANY_ARGUMENTS;
+    r_error->argument = 0;
+    r_error->expected = expected_count;
+    return false;
+  }
+
+  for (GDExtensionInt i = 0; i < expected_count; i++) {
+    if (gd_extension.variant_get_type(p_args[i]) != expected_types[i]) {
+      r_error->error = GDEXTENSION_CALL_ERROR_INVALID_ARGUMENT;
+      r_error->argument = i;
+      r_error->expected = expected_types[i];
+      return false;
+    }
+  }
+
+  r_error->error = GDEXTENSION_CALL_OK;
+  return true;
+}
+
+void
+my_custom_class_bulk_set_call(
+  void *method_userdata,
+  GDExtensionClassInstancePtr p_instance,
+  const GDExtensionConstVariantPtr *p_args,
+  GDExtensionInt p_argument_count,
+  GDExtensionVariantPtr r_return,
+  GDExtensionCallError *r_error
+) {
+  const GDExtensionVariantType expected_types[] = {
+    GDEXTENSION_VARIANT_TYPE_ARRAY,
+    GDEXTENSION_VARIANT_TYPE_PACKED_FLOAT64_ARRAY,
+    GDEXTENSION_VARIANT_TYPE_PACKED_FLOAT64_ARRAY,
+  };
+  if (!check_call_args(p_args, p_argument_count, expected_types, 3, r_error)) return;
+
+  // Unwrapping containers only bumps their refcount, the data is not copied
+  unsigned char nodes[ARRAY_SIZE];
+  unsigned char amplitudes[PACKED_ARRAY_SIZE];
+  unsigned char frequencies[PACKED_ARRAY_SIZE];
+  gd_extension_helper.unwrap.array(&nodes, (void *)p_args[0]);
+  gd_extension_helper.unwrap.packed_float64_array(&amplitudes, (void *)p_args[1]);
+  gd_extension_helper.unwrap.packed_float64_array(&frequencies, (void *)p_args[2]);
+
+  GDExtensionInt applied = my_custom_class_bulk_set(&nodes, &amplitudes, &frequencies);
+  gd_extension_helper.wrap.type_int(r_return, &applied);
+
+  gd_extension_helper.destructor.array(&nodes);
+  gd_extension_helper.destructor.packed_float64_array(&amplitudes);
+  gd_extension_helper.destructor.packed_float64_array(&frequencies);
+}
+
+void
+my_custom_class_bulk_get_call(
+  void *method_userdata,
+  GDExtensionClassInstancePtr p_instance,
+  const GDExtensionConstVariantPtr *p_args,
+  GDExtensionInt p_argument_count,
+  GDExtensionVariantPtr r_return,
+  GDExtensionCallError *r_error
+) {
+  const GDExtensionVariantType expected_types[] = { GDEXTENSION_VARIANT_TYPE_ARRAY };
+  if (!check_call_args(p_args, p_argument_count, expected_types, 1, r_error)) return;
+
+  unsigned char nodes[ARRAY_SIZE];
+  unsigned char result[ARRAY_SIZE];
+  gd_extension_helper.unwrap.array(&nodes, (void *)p_args[0]);
+  gd_extension_helper.constructor.array(&result, NULL);
+
+  my_custom_class_bulk_get(&nodes, &result);
+  gd_extension_helper.wrap.array(r_return, &result);
+
+  gd_extension_helper.destructor.array(&nodes);
+  gd_extension_helper.destructor.array(&result);
+}
+
+GDExtensionPropertyInfo make_property_info(GDExtensionVariantType type, const char *name) {
+  GDExtensionPropertyInfo res = {
+    .type = type,
+    .name = construct_string_name(name),
+    .class_name = construct_string_name(""),
+    .hint = 0, // Corresponds to no hints
+    .hint_string = construct_string(""),
+    .usage = 6, // Corresponds to default usage flags
+  };
+  return res;
+}
+
+void destruct_property_info(GDExtensionPropertyInfo *p_info) {
+  destruct_string_name(p_info->name);
+  destruct_string_name(p_info->class_name);
+  destruct_string(p_info->hint_string);
+}
+
+void register_my_custom_class_bulk_methods(GDExtensionConstStringNamePtr class_string_name) {
+  GDExtensionPropertyInfo bulk_set_args[] = {
+    make_property_info(GDEXTENSION_VARIANT_TYPE_ARRAY, "nodes"),
+    make_property_info(GDEXTENSION_VARIANT_TYPE_PACKED_FLOAT64_ARRAY, "amplitudes"),
+    make_property_info(GDEXTENSION_VARIANT_TYPE_PACKED_FLOAT64_ARRAY, "frequencies"),
+  };
+  GDExtensionClassMethodArgumentMetadata bulk_set_args_metadata[] = {
+    GDEXTENSION_METHOD_ARGUMENT_METADATA_NONE,
+    GDEXTENSION_METHOD_ARGUMENT_METADATA_NONE,
+    GDEXTENSION_METHOD_ARGUMENT_METADATA_NONE,
+  };
+  GDExtensionPropertyInfo bulk_set_return = make_property_info(GDEXTENSION_VARIANT_TYPE_INT, "");
+
+  GDExtensionClassMethodInfo bulk_set_info = {
+    .name = construct_string_name("bulk_set"),
+    .method_userdata = NULL,
+    .call_func = my_custom_class_bulk_set_call,
+    .ptrcall_func = my_custom_class_bulk_set_ptrcall,
+    .method_flags = GDEXTENSION_METHOD_FLAG_NORMAL | GDEXTENSION_METHOD_FLAG_STATIC,
+    .has_return_value = true,
+    .return_value_info = &bulk_set_return,
+    .return_value_metadata = GDEXTENSION_METHOD_ARGUMENT_METADATA_INT_IS_INT64,
+    .argument_count = 3,
+    .arguments_info = bulk_set_args,
+    .arguments_metadata = bulk_set_args_metadata,
+    .default_argument_count = 0,
+    .default_arguments = NULL,
+  };
+
+  GDExtensionPropertyInfo bulk_get_args[] = {
+    make_property_info(GDEXTENSION_VARIANT_TYPE_ARRAY, "nodes"),
+  };
+  GDExtensionClassMethodArgumentMetadata bulk_get_args_metadata[] = {
+    GDEXTENSION_METHOD_ARGUMENT_METADATA_NONE,
+  };
+  GDExtensionPropertyInfo bulk_get_return = make_property_info(GDEXTENSION_VARIANT_TYPE_ARRAY, "");
+
+  GDExtensionClassMethodInfo bulk_get_info = {
+    .name = construct_string_name("bulk_get"),
+    .method_userdata = NULL,
+    .call_func = my_custom_class_bulk_get_call,
+    .ptrcall_func = my_custom_class_bulk_get_ptrcall,
+    .method_flags = GDEXTENSION_METHOD_FLAG_NORMAL | GDEXTENSION_METHOD_FLAG_STATIC,
+    .has_return_value = true,
+    .return_value_info = &bulk_get_return,
+    .return_value_metadata = GDEXTENSION_METHOD_ARGUMENT_METADATA_NONE,
+    .argument_count = 1,
+    .arguments_info = bulk_get_args,
+    .arguments_metadata = bulk_get_args_metadata,
+    .default_argument_count = 0,
+    .default_arguments = NULL,
+  };
+
+  gd_extension.classdb_register_extension_class_method(gd_extension_helper.misc.p_library,
+                                                       class_string_name,
+                                                       &bulk_set_info);
+  gd_extension.classdb_register_extension_class_method(gd_extension_helper.misc.p_library,
+                                                       class_string_name,
+                                                       &bulk_get_info);
+
+  for (size_t i = 0; i < 3; i++) destruct_property_info(&bulk_set_args[i]);
+  destruct_property_info(&bulk_get_args[0]);
+  destruct_property_info(&bulk_set_return);
+  destruct_property_info(&bulk_get_return);
+  destruct_string_name(bulk_set_info.name);
+  destruct_string_name(bulk_get_info.name);
+}
+
+GDExtensionClassCallVirtual
+my_custom_class_get_virtual(
+   void *p_class_userdata,
+   GDExtensionConstStringNamePtr p_name
+) {
+  if (string_name_eq(p_name, gd_extension_helper.string_name._process)) {
+    return my_custom_class__process_override;
+  }
+  return NULL;
+}
+
+// NOTE: We can only call this when Node has been loaded in ClassDB (during
+// GDEXTENSION_INITIALIZATION_SCENE)
+void register_my_custom_class() {
+  GDExtensionClassCreationInfo2 class_info = {
+    .is_virtual = false,
+    .is_abstract = false,
+    .is_exposed = true,
+    .set_func = my_custom_class_set_func,
+    .get_func = my_custom_class_get_func,
+    .get_property_list_func = my_custom_class_get_property_list,
+    .free_property_list_func = my_custom_class_free_property_list,
+    .property_can_revert_func = NULL,
+    .property_get_revert_func = NULL,
+    .validate_property_func = NULL,
+    .notification_func = NULL,
+    .to_string_func = NULL,
+    .reference_func = NULL,
+    .unreference_func = NULL,
+    .create_instance_func = my_custom_class_init,
+    .free_instance_func = my_custom_class_deinit,
+    .recreate_instance_func = NULL,
+    .get_virtual_func = my_custom_class_get_virtual,
+    .get_virtual_call_data_func = NULL,
+    .call_virtual_with_data_func = NULL,
+    .get_rid_func = NULL,
+    .class_userdata = NULL,
+  };
+
+  void *my_class_string_name = construct_string_name(MY_CUSTOM_CLASS_NAME);
+  void *parent_class_string_name = construct_string_name(MY_CUSTOM_CLASS_PARENT);
+
+  gd_extension.classdb_register_extension_class2(gd_extension_helper.misc.p_library,
+                                                 my_class_string_name,
+                                                 parent_class_string_name,
+                                                 &class_info);
+
+  register_my_custom_class_bulk_methods(my_class_string_name);
+  gd_extension_helper.misc.my_custom_class_tag = gd_extension.classdb_get_class_tag(my_class_string_name);
+
+  destruct_string_name(my_class_string_name);
+  destruct_string_name(parent_class_string_name);
+}
+
+void godot_initialize(void *userdata, GDExtensionInitializationLevel p_level) {
+  if (p_level == GDEXTENSION_INITIALIZATION_SCENE) {
+    gd_extension_helper.string_name.amplitude = construct_string_name("amplitude");
+    gd_extension_helper.string_name.frequency = construct_string_name("frequency");
+    gd_extension_helper.string_name._process = construct_string_name("_process");
+    gd_extension_helper.string_name.position = construct_string_name("position");
+
+    void *node2d_string_name = construct_string_name("Node2D");
+    void *set_position_string_name = construct_string_name("set_position");
+
+    gd_extension_helper.misc.node2d_set_position
+      = gd_extension.classdb_get_method_bind(node2d_string_name,
+                                             set_position_string_name,
+                                             743155724);
+
+    destruct_string_name(node2d_string_name);
+    destruct_string_name(set_position_string_name);
+
+    void *size_string_name = construct_string_name("size");
+    void *resize_string_name = construct_string_name("resize");
+
+    gd_extension_helper.builtin_method.array_size
+      = gd_extension.variant_get_ptr_builtin_method(GDEXTENSION_VARIANT_TYPE_ARRAY,
+                                                    size_string_name,
+                                                    3173160232);
+    gd_extension_helper.builtin_method.array_resize
+      = gd_extension.variant_get_ptr_builtin_method(GDEXTENSION_VARIANT_TYPE_ARRAY,
+                                                    resize_string_name,
+                                                    848867239);
+    gd_extension_helper.builtin_method.packed_float64_array_size
+      = gd_extension.variant_get_ptr_builtin_method(GDEXTENSION_VARIANT_TYPE_PACKED_FLOAT64_ARRAY,
+                                                    size_string_name,
+                                                    3173160232);
+    gd_extension_helper.builtin_method.packed_float64_array_resize
+      = gd_extension.variant_get_ptr_builtin_method(GDEXTENSION_VARIANT_TYPE_PACKED_FLOAT64_ARRAY,
+                                                    resize_string_name,
+                                                    848867239);
+
+    destruct_string_name(size_string_name);
+    destruct_string_name(resize_string_name);
+
+    register_my_custom_class();
+    return;
+  }
+}
+
+void godot_deinitialize(void *userdata, GDExtensionInitializationLevel p_level) {
+  if (p_level == GDEXTENSION_INITIALIZATION_SCENE) {
+    destruct_string_name(gd_extension_helper.string_name.amplitude);
+    destruct_string_name(gd_extension_helper.string_name.frequency);
+    destruct_string_name(gd_extension_helper.string_name._process);
+    destruct_string_name(gd_extension_helper.string_name.position);
+  }
+}
+
+GDExtensionBool
+godot_entry(
+  GDExtensionInterfaceGetProcAddress p_get_proc_address,
+  const GDExtensionClassLibraryPtr p_library,
+  GDExtensionInitialization *r_initialization
+) {
+  r_initialization->minimum_initialization_level = GDEXTENSION_INITIALIZATION_SCENE;
+  r_initialization->userdata = NULL;
+  r_initialization->initialize = godot_initialize;
+  r_initialization->deinitialize = godot_deinitialize;
+
+  STORE_GD_EXTENSION(classdb_construct_object);
+  STORE_GD_EXTENSION(classdb_register_extension_class2);
+  STORE_GD_EXTENSION(classdb_get_method_bind);
+  STORE_GD_EXTENSION(string_name_new_with_utf8_chars);
+  STORE_GD_EXTENSION(string_new_with_utf8_chars);
+  STORE_GD_EXTENSION(object_set_instance);
+  STORE_GD_EXTENSION(variant_get_ptr_destructor);
+  STORE_GD_EXTENSION(variant_evaluate);
+  STORE_GD_EXTENSION(get_variant_from_type_constructor);
+  STORE_GD_EXTENSION(get_variant_to_type_constructor);
+  STORE_GD_EXTENSION(variant_get_ptr_operator_evaluator);
+  STORE_GD_EXTENSION(variant_get_type);
+  STORE_GD_EXTENSION(object_method_bind_ptrcall);
+  STORE_GD_EXTENSION(object_set_instance_binding);
+  STORE_GD_EXTENSION(object_get_instance_binding);
+  STORE_GD_EXTENSION(object_get_instance_from_id);
+  STORE_GD_EXTENSION(object_cast_to);
+  STORE_GD_EXTENSION(classdb_get_class_tag);
+  STORE_GD_EXTENSION(classdb_register_extension_class_method);
+  STORE_GD_EXTENSION(variant_get_ptr_builtin_method);
+  STORE_GD_EXTENSION(variant_get_ptr_constructor);
+  STORE_GD_EXTENSION(array_operator_index);
+  STORE_GD_EXTENSION(array_operator_index_const);
+  STORE_GD_EXTENSION(array_ref);
+  STORE_GD_EXTENSION(packed_float64_array_operator_index);
+  STORE_GD_EXTENSION(packed_float64_array_operator_index_const);
+
+  gd_extension_helper.wrap.type_double
+    = gd_extension.get_variant_from_type_constructor(GDEXTENSION_VARIANT_TYPE_FLOAT);
+
+  gd_extension_helper.wrap.type_int
+    = gd_extension.get_variant_from_type_constructor(GDEXTENSION_VARIANT_TYPE_INT);
+  gd_extension_helper.wrap.array
+    = gd_extension.get_variant_from_type_constructor(GDEXTENSION_VARIANT_TYPE_ARRAY);
+  gd_extension_helper.wrap.packed_float64_array
+    = gd_extension.get_variant_from_type_constructor(GDEXTENSION_VARIANT_TYPE_PACKED_FLOAT64_ARRAY);
+
+  gd_extension_helper.unwrap.type_int
+    = gd_extension.get_variant_to_type_constructor(GDEXTENSION_VARIANT_TYPE_INT);
+  gd_extension_helper.unwrap.object
+    = gd_extension.get_variant_to_type_constructor(GDEXTENSION_VARIANT_TYPE_OBJECT);
+  gd_extension_helper.unwrap.array
+    = gd_extension.get_variant_to_type_constructor(GDEXTENSION_VARIANT_TYPE_ARRAY);
+  gd_extension_helper.unwrap.packed_float64_array
+    = gd_extension.get_variant_to_type_constructor(GDEXTENSION_VARIANT_TYPE_PACKED_FLOAT64_ARRAY);
+
+  gd_extension_helper.misc.p_library = p_library;
+  gd_extension_helper.misc.string_name_eq_op
+    = gd_extension.variant_get_ptr_operator_evaluator(GDEXTENSION_VARIANT_OP_EQUAL,
+                                                      GDEXTENSION_VARIANT_TYPE_STRING_NAME,
+                                                      GDEXTENSION_VARIANT_TYPE_STRING_NAME);
+
+  gd_extension_helper.destructor.string_name
+    = gd_extension.variant_get_ptr_destructor(GDEXTENSION_VARIANT_TYPE_STRING_NAME);
+  gd_extension_helper.destructor.string
+    = gd_extension.variant_get_ptr_destructor(GDEXTENSION_VARIANT_TYPE_STRING);
+  gd_extension_helper.destructor.array
+    = gd_extension.variant_get_ptr_destructor(GDEXTENSION_VARIANT_TYPE_ARRAY);
+  gd_extension_helper.destructor.packed_float64_array
+    = gd_extension.variant_get_ptr_destructor(GDEXTENSION_VARIANT_TYPE_PACKED_FLOAT64_ARRAY);
+
+  gd_extension_helper.constructor.array
+    = gd_extension.variant_get_ptr_constructor(GDEXTENSION_VARIANT_TYPE_ARRAY, 0);
+  gd_extension_helper.constructor.packed_float64_array
+    = gd_extension.variant_get_ptr_constructor(GDEXTENSION_VARIANT_TYPE_PACKED_FLOAT64_ARRAY, 0);
+
+  variant_unwrap_init(p_get_proc_address);
+
+  return true;
+}
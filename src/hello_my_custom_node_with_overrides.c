@@ -11,6 +11,7 @@
 #define MY_CUSTOM_CLASS_NAME ("MyCustomNode")
 #define MY_CUSTOM_CLASS_PARENT ("Sprite2D")
 
+#include "../util/variant_unwrap.h"
 
 struct {
   GDExtensionInterfaceClassdbConstructObject classdb_construct_object;
@@ -36,9 +37,6 @@ struct {
   struct {
     GDExtensionVariantFromTypeConstructorFunc type_double;
   } wrap;
-  struct {
-    GDExtensionTypeFromVariantConstructorFunc type_double;
-  } unwrap;
   struct {
     GDExtensionStringNamePtr amplitude;
     GDExtensionStringNamePtr frequency;
@@ -189,21 +187,11 @@ my_custom_class_set_func(
   my_custom_class_t *my_instance = p_instance;
 
   if (string_name_eq(p_name, gd_extension_helper.string_name.frequency)) {
-    if (gd_extension.variant_get_type(p_value) == GDEXTENSION_VARIANT_TYPE_FLOAT) {
-      gd_extension_helper.unwrap.type_double(&my_instance->prop_state.frequency, (void *)p_value);
-      return true;
-    } else {
-      return false;
-    }
+    return variant_unwrap_float(p_value, &my_instance->prop_state.frequency);
   }
 
   if (string_name_eq(p_name, gd_extension_helper.string_name.amplitude)) {
-    if (gd_extension.variant_get_type(p_value) == GDEXTENSION_VARIANT_TYPE_FLOAT) {
-      gd_extension_helper.unwrap.type_double(&my_instance->prop_state.amplitude, (void *)p_value);
-      return true;
-    } else {
-      return false;
-    }
+    return variant_unwrap_float(p_value, &my_instance->prop_state.amplitude);
   }
 
   return false;
@@ -369,9 +357,6 @@ godot_entry(
   gd_extension_helper.wrap.type_double
     = gd_extension.get_variant_from_type_constructor(GDEXTENSION_VARIANT_TYPE_FLOAT);
 
-  gd_extension_helper.unwrap.type_double
-    = gd_extension.get_variant_to_type_constructor(GDEXTENSION_VARIANT_TYPE_FLOAT);
-
   gd_extension_helper.misc.p_library = p_library;
   gd_extension_helper.misc.string_name_eq_op
     = gd_extension.variant_get_ptr_operator_evaluator(GDEXTENSION_VARIANT_OP_EQUAL,
@@ -383,5 +368,7 @@ godot_entry(
   gd_extension_helper.destructor.string
     = gd_extension.variant_get_ptr_destructor(GDEXTENSION_VARIANT_TYPE_STRING);
 
+  variant_unwrap_init(p_get_proc_address);
+
   return true;
 }
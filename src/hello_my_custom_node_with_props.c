@@ -35,6 +35,7 @@ struct {
   } wrap;
   struct {
     GDExtensionTypeFromVariantConstructorFunc type_double;
+    GDExtensionTypeFromVariantConstructorFunc type_int;
   } unwrap;
   struct {
     GDExtensionStringNamePtr amplitude;
@@ -160,6 +161,23 @@ bool string_name_eq(const void *a, const void *b) {
   return res;
 }
 
+// GDScript passes `node.amplitude = 2` as an int, so ints are numbers too
+bool unwrap_number(double *r_value, GDExtensionConstVariantPtr p_value) {
+  switch (gd_extension.variant_get_type(p_value)) {
+    case GDEXTENSION_VARIANT_TYPE_FLOAT:
+      gd_extension_helper.unwrap.type_double(r_value, (void *)p_value);
+      return true;
+    case GDEXTENSION_VARIANT_TYPE_INT: {
+      GDExtensionInt value;
+      gd_extension_helper.unwrap.type_int(&value, (void *)p_value);
+      *r_value = (double)value;
+      return true;
+    }
+    default:
+      return false;
+  }
+}
+
 GDExtensionBool
 my_custom_class_set_func(
   GDExtensionClassInstancePtr p_instance,
@@ -169,21 +187,11 @@ my_custom_class_set_func(
   my_custom_class_t *my_instance = p_instance;
 
   if (string_name_eq(p_name, gd_extension_helper.string_name.frequency)) {
-    if (gd_extension.variant_get_type(p_value) == GDEXTENSION_VARIANT_TYPE_FLOAT) {
-      gd_extension_helper.unwrap.type_double(&my_instance->prop_state.frequency, (void *)p_value);
-      return true;
-    } else {
-      return false;
-    }
+    return unwrap_number(&my_instance->prop_state.frequency, p_value);
   }
 
   if (string_name_eq(p_name, gd_extension_helper.string_name.amplitude)) {
-    if (gd_extension.variant_get_type(p_value) == GDEXTENSION_VARIANT_TYPE_FLOAT) {
-      gd_extension_helper.unwrap.type_double(&my_instance->prop_state.amplitude, (void *)p_value);
-      return true;
-    } else {
-      return false;
-    }
+    return unwrap_number(&my_instance->prop_state.amplitude, p_value);
   }
 
   return false;
@@ -294,6 +302,8 @@ godot_entry(
 
   gd_extension_helper.unwrap.type_double
     = gd_extension.get_variant_to_type_constructor(GDEXTENSION_VARIANT_TYPE_FLOAT);
+  gd_extension_helper.unwrap.type_int
+    = gd_extension.get_variant_to_type_constructor(GDEXTENSION_VARIANT_TYPE_INT);
 
   gd_extension_helper.misc.p_library = p_library;
   gd_extension_helper.misc.string_name_eq_op
@@ -0,0 +1,1315 @@
+#include "../godot-headers/gdextension_interface.h"
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+
+#define STORE_GD_EXTENSION(str_name) gd_extension.str_name = (void *)p_get_proc_address(#str_name);
+#define IS_GODOT_64_BIT (true)
+#define IS_GODOT_USING_LARGE_WORLD_COORDINATES (false)
+#define VARIANT_SIZE (IS_GODOT_USING_LARGE_WORLD_COORDINATES ? 40 : 24)
+#define MY_CUSTOM_CLASS_NAME ("MyCustomNode")
+#define MY_CUSTOM_CLASS_PARENT ("Sprite2D")
+#define ARRAY_SIZE (8)
+#define PACKED_ARRAY_SIZE (16)
+#define SNAPSHOT_BENCHMARK_NODES (5000)
+#define SNAPSHOT_BENCHMARK_PATH ("snapshot_benchmark.mcns")
+
+#include "../util/variant_unwrap.h"
+
+struct {
+  GDExtensionInterfaceClassdbConstructObject classdb_construct_object;
+  GDExtensionInterfaceClassdbRegisterExtensionClass2 classdb_register_extension_class2;
+  GDExtensionInterfaceClassdbGetMethodBind classdb_get_method_bind;
+  GDExtensionInterfaceStringNameNewWithUtf8Chars string_name_new_with_utf8_chars;
+  GDExtensionInterfaceStringNewWithUtf8Chars string_new_with_utf8_chars;
+  GDExtensionInterfaceStringToUtf8Chars string_to_utf8_chars;
+  GDExtensionInterfaceObjectSetInstance object_set_instance;
+  GDExtensionInterfaceObjectDestroy object_destroy;
+  GDExtensionInterfaceVariantGetPtrDestructor variant_get_ptr_destructor;
+  GDExtensionInterfaceVariantEvaluate variant_evaluate;
+  GDExtensionInterfaceGetVariantFromTypeConstructor get_variant_from_type_constructor;
+  GDExtensionInterfaceGetVariantToTypeConstructor get_variant_to_type_constructor;
+  GDExtensionInterfaceVariantGetPtrOperatorEvaluator variant_get_ptr_operator_evaluator;
+  GDExtensionInterfaceVariantGetType variant_get_type;
+  GDExtensionInterfaceObjectMethodBindPtrcall object_method_bind_ptrcall;
+  GDExtensionInterfaceObjectSetInstanceBinding object_set_instance_binding;
+  GDExtensionInterfaceObjectGetInstanceBinding object_get_instance_binding;
+  GDExtensionInterfaceObjectGetInstanceFromId object_get_instance_from_id;
+  GDExtensionInterfaceObjectCastTo object_cast_to;
+  GDExtensionInterfaceClassdbGetClassTag classdb_get_class_tag;
+  GDExtensionInterfaceClassdbRegisterExtensionClassMethod classdb_register_extension_class_method;
+  GDExtensionInterfaceVariantGetPtrBuiltinMethod variant_get_ptr_builtin_method;
+  GDExtensionInterfaceVariantGetPtrConstructor variant_get_ptr_constructor;
+  GDExtensionInterfaceArrayOperatorIndex array_operator_index;
+  GDExtensionInterfaceArrayOperatorIndexConst array_operator_index_const;
+  GDExtensionInterfaceArrayRef array_ref;
+  GDExtensionInterfacePackedFloat64ArrayOperatorIndex packed_float64_array_operator_index;
+  GDExtensionInterfacePackedFloat64ArrayOperatorIndexConst packed_float64_array_operator_index_const;
+} gd_extension;
+
+struct {
+  struct {
+    GDExtensionPtrDestructor string_name;
+    GDExtensionPtrDestructor string;
+    GDExtensionPtrDestructor array;
+    GDExtensionPtrDestructor packed_float64_array;
+  } destructor;
+  struct {
+    GDExtensionPtrConstructor array;
+    GDExtensionPtrConstructor packed_float64_array;
+  } constructor;
+  struct {
+    GDExtensionPtrBuiltInMethod array_size;
+    GDExtensionPtrBuiltInMethod array_resize;
+    GDExtensionPtrBuiltInMethod packed_float64_array_size;
+    GDExtensionPtrBuiltInMethod packed_float64_array_resize;
+  } builtin_method;
+  struct {
+    GDExtensionVariantFromTypeConstructorFunc type_double;
+    GDExtensionVariantFromTypeConstructorFunc type_int;
+    GDExtensionVariantFromTypeConstructorFunc array;
+    GDExtensionVariantFromTypeConstructorFunc packed_float64_array;
+    GDExtensionVariantFromTypeConstructorFunc object;
+  } wrap;
+  struct {
+    GDExtensionTypeFromVariantConstructorFunc object;
+    GDExtensionTypeFromVariantConstructorFunc type_int;
+    GDExtensionTypeFromVariantConstructorFunc array;
+    GDExtensionTypeFromVariantConstructorFunc packed_float64_array;
+    GDExtensionTypeFromVariantConstructorFunc string;
+  } unwrap;
+  struct {
+    GDExtensionStringNamePtr amplitude;
+    GDExtensionStringNamePtr frequency;
+    GDExtensionStringNamePtr _process;
+    GDExtensionStringNamePtr position;
+  } string_name;
+  struct {
+    GDExtensionClassLibraryPtr p_library;
+    GDExtensionPtrOperatorEvaluator string_name_eq_op;
+    GDExtensionMethodBindPtr node2d_set_position;
+    GDExtensionMethodBindPtr node_add_child;
+    GDExtensionMethodBindPtr node_set_owner;
+    GDExtensionMethodBindPtr node_get_child;
+    GDExtensionMethodBindPtr packed_scene_pack;
+    GDExtensionMethodBindPtr packed_scene_instantiate;
+    void *my_custom_class_tag;
+    // Mutes the instance messages while the benchmark makes thousands of nodes
+    bool quiet;
+  } misc;
+} gd_extension_helper;
+
+#if (IS_GODOT_USING_LARGE_WORLD_COORDINATES)
+typedef struct {
+  double x;
+  double y;
+} GDVector2;
+#else
+typedef struct {
+  float x;
+  float y;
+} GDVector2;
+#endif
+
+GDExtensionStringNamePtr construct_string_name(const char *c_string) {
+  void *res = malloc(IS_GODOT_64_BIT ? 8 : 4);
+  gd_extension.string_name_new_with_utf8_chars(res, c_string);
+  return res;
+}
+
+GDExtensionStringPtr construct_string(const char *c_string) {
+  void *res = malloc(IS_GODOT_64_BIT ? 8 : 4);
+  gd_extension.string_new_with_utf8_chars(res, c_string);
+  return res;
+}
+
+void destruct_string_name(GDExtensionStringNamePtr p) {
+  gd_extension_helper.destructor.string_name(p);
+}
+
+void destruct_string(GDExtensionStringPtr p) {
+  gd_extension_helper.destructor.string(p);
+}
+
+typedef struct {
+  GDExtensionObjectPtr godot_object;
+  double time_elapsed;
+  struct {
+    double amplitude;
+    double frequency;
+  } prop_state;
+} my_custom_class_t;
+
+struct {
+  const char *name;
+  const GDExtensionVariantType type;
+} my_custom_class_props[] = {
+  {
+    .name = "frequency",
+    .type = GDEXTENSION_VARIANT_TYPE_FLOAT,
+  },
+  {
+    .name = "amplitude",
+    .type = GDEXTENSION_VARIANT_TYPE_FLOAT,
+  }
+};
+
+const GDExtensionPropertyInfo *
+my_custom_class_get_property_list(
+  GDExtensionClassInstancePtr p_instance,
+  uint32_t *r_count
+) {
+  size_t n = sizeof(my_custom_class_props) / sizeof(*my_custom_class_props);
+  *r_count = n;
+
+  GDExtensionPropertyInfo *res = malloc(n * sizeof(GDExtensionPropertyInfo));
+
+  for (size_t i = 0; i < n; i++) {
+    res[i].type = my_custom_class_props[i].type;
+    res[i].name = construct_string_name(my_custom_class_props[i].name);
+    res[i].class_name = construct_string_name(MY_CUSTOM_CLASS_NAME);
+    res[i].hint = 0; // Corresponds to no hints
+    res[i].hint_string = construct_string("");
+    res[i].usage = 6; // Corresponds to default usage flags
+  }
+
+  return res;
+}
+
+void
+my_custom_class_free_property_list(
+  GDExtensionClassInstancePtr p_instance,
+  const GDExtensionPropertyInfo *p_list
+) {
+  size_t n = sizeof(my_custom_class_props) / sizeof(*my_custom_class_props);
+
+  for (size_t i = 0; i < n; i++) {
+    destruct_string_name((void*)p_list[i].name);
+    destruct_string((void*)p_list[i].hint_string);
+    destruct_string_name((void*)p_list[i].class_name);
+  }
+
+  free((void*)p_list);
+}
+
+void *my_custom_class_binding_create(void *p_token, void *p_instance) {
+  // NOTE: Bindings are only made in `my_custom_class_init`, an object without
+  // one is not ours.
+  return NULL;
+}
+
+void my_custom_class_binding_free(void *p_token, void *p_instance, void *p_binding) {
+  // NOTE: The binding is our instance struct and it's freed in
+  // `my_custom_class_deinit`.
+}
+
+GDExtensionBool
+my_custom_class_binding_reference(void *p_token, void *p_binding, GDExtensionBool p_reference) {
+  return true;
+}
+
+const GDExtensionInstanceBindingCallbacks my_custom_class_binding_callbacks = {
+  .create_callback = my_custom_class_binding_create,
+  .free_callback = my_custom_class_binding_free,
+  .reference_callback = my_custom_class_binding_reference,
+};
+
+GDExtensionObjectPtr my_custom_class_init(void *userdata) {
+  my_custom_class_t *my_instance = malloc(sizeof(my_custom_class_t));
+
+  void *my_class_string_name = construct_string_name(MY_CUSTOM_CLASS_NAME);
+  void *parent_class_string_name = construct_string_name(MY_CUSTOM_CLASS_PARENT);
+
+  my_instance->godot_object = gd_extension.classdb_construct_object(parent_class_string_name);
+  my_instance->time_elapsed = 0.0;
+  my_instance->prop_state.amplitude = 1.23;
+  my_instance->prop_state.frequency = 2.45;
+  gd_extension.object_set_instance(my_instance->godot_object, my_class_string_name, my_instance);
+  // The binding lets us go from a Godot object back to `my_instance` which is
+  // what the bulk methods need.
+  gd_extension.object_set_instance_binding(my_instance->godot_object,
+                                           gd_extension_helper.misc.p_library,
+                                           my_instance,
+                                           &my_custom_class_binding_callbacks);
+
+  destruct_string_name(my_class_string_name);
+  destruct_string_name(parent_class_string_name);
+
+  if (!gd_extension_helper.misc.quiet) printf("Hey, instancing is done!\n");
+
+  return my_instance->godot_object;
+}
+
+void my_custom_class_deinit(void *userdata, GDExtensionClassInstancePtr p_instance) {
+  if (p_instance == NULL) return;
+
+  my_custom_class_t *my_instance = p_instance;
+  free(my_instance);
+
+  if (!gd_extension_helper.misc.quiet) printf("my_custom_class is going down, goodbye world!\n");
+}
+
+bool string_name_eq(const void *a, const void *b) {
+  GDExtensionBool res;
+  gd_extension_helper.misc.string_name_eq_op(a, b, &res);
+  return res;
+}
+
+GDExtensionBool
+my_custom_class_set_func(
+  GDExtensionClassInstancePtr p_instance,
+  GDExtensionConstStringNamePtr p_name,
+  GDExtensionConstVariantPtr p_value
+) {
+  my_custom_class_t *my_instance = p_instance;
+
+  if (string_name_eq(p_name, gd_extension_helper.string_name.frequency)) {
+    return variant_unwrap_float(p_value, &my_instance->prop_state.frequency);
+  }
+
+  if (string_name_eq(p_name, gd_extension_helper.string_name.amplitude)) {
+    return variant_unwrap_float(p_value, &my_instance->prop_state.amplitude);
+  }
+
+  return false;
+}
+
+GDExtensionBool
+my_custom_class_get_func(
+  GDExtensionClassInstancePtr p_instance,
+  GDExtensionConstStringNamePtr p_name,
+  GDExtensionVariantPtr r_ret
+) {
+  my_custom_class_t *my_instance = p_instance;
+
+  if (string_name_eq(p_name, gd_extension_helper.string_name.frequency)) {
+    gd_extension_helper.wrap.type_double(r_ret, &(my_instance->prop_state.frequency));
+    return true;
+  }
+
+  if (string_name_eq(p_name, gd_extension_helper.string_name.amplitude)) {
+    gd_extension_helper.wrap.type_double(r_ret, &(my_instance->prop_state.amplitude));
+    return true;
+  }
+
+  return false;
+}
+
+void
+my_custom_class__process_override(
+   GDExtensionClassInstancePtr p_instance,
+   const GDExtensionConstTypePtr *p_args,
+   GDExtensionTypePtr r_ret
+) {
+  my_custom_class_t *my_instance = p_instance;
+  my_instance->time_elapsed += *((double*)(p_args[0]));
+
+  double t = my_instance->time_elapsed;
+  double A = my_instance->prop_state.amplitude;
+  double w = my_instance->prop_state.frequency;
+
+  const GDVector2 new_position = {
+    .x = 0,
+    .y = A * sin(w * t),
+  };
+
+  GDExtensionConstTypePtr args[] = { &new_position };
+
+  gd_extension.object_method_bind_ptrcall(gd_extension_helper.misc.node2d_set_position,
+                                          my_instance->godot_object,
+                                          args,
+                                          NULL);
+
+  r_ret = NULL;
+}
+
+GDExtensionInt array_size(GDExtensionConstTypePtr p_array) {
+  GDExtensionInt res;
+  gd_extension_helper.builtin_method.array_size((void *)p_array, NULL, &res, 0);
+  return res;
+}
+
+GDExtensionInt packed_float64_array_size(GDExtensionConstTypePtr p_array) {
+  GDExtensionInt res;
+  gd_extension_helper.builtin_method.packed_float64_array_size((void *)p_array, NULL, &res, 0);
+  return res;
+}
+
+// Accepts both a MyCustomNode object and its instance ID, returns NULL for
+// anything else (freed objects, other classes, wrong variant types).
+my_custom_class_t *my_custom_class_from_variant(GDExtensionConstVariantPtr p_variant) {
+  GDExtensionObjectPtr object = NULL;
+
+  switch (gd_extension.variant_get_type(p_variant)) {
+  case GDEXTENSION_VARIANT_TYPE_OBJECT:
+    gd_extension_helper.unwrap.object(&object, (void *)p_variant);
+    break;
+  case GDEXTENSION_VARIANT_TYPE_INT: {
+    GDExtensionInt instance_id;
+    gd_extension_helper.unwrap.type_int(&instance_id, (void *)p_variant);
+    object = gd_extension.object_get_instance_from_id(instance_id);
+    break;
+  }
+  default:
+    return NULL;
+  }
+
+  if (object == NULL) return NULL;
+  if (gd_extension.object_cast_to(object, gd_extension_helper.misc.my_custom_class_tag) == NULL) {
+    return NULL;
+  }
+
+  return gd_extension.object_get_instance_binding(object,
+                                                  gd_extension_helper.misc.p_library,
+                                                  &my_custom_class_binding_callbacks);
+}
+
+// Returns the number of nodes that were updated. Entries that don't resolve to
+// a MyCustomNode are skipped.
+GDExtensionInt
+my_custom_class_bulk_set(
+  GDExtensionConstTypePtr p_nodes,
+  GDExtensionConstTypePtr p_amplitudes,
+  GDExtensionConstTypePtr p_frequencies
+) {
+  GDExtensionInt n = array_size(p_nodes);
+
+  if (packed_float64_array_size(p_amplitudes) != n || packed_float64_array_size(p_frequencies) != n) {
+    fprintf(stderr, "bulk_set: nodes, amplitudes and frequencies must have the same size\n");
+    return 0;
+  }
+  if (n == 0) return 0;
+
+  // One interface call per array gives us the whole buffer
+  const double *amplitudes = gd_extension.packed_float64_array_operator_index_const(p_amplitudes, 0);
+  const double *frequencies = gd_extension.packed_float64_array_operator_index_const(p_frequencies, 0);
+
+  GDExtensionInt applied = 0;
+  for (GDExtensionInt i = 0; i < n; i++) {
+    my_custom_class_t *my_instance
+      = my_custom_class_from_variant(gd_extension.array_operator_index_const(p_nodes, i));
+    if (my_instance == NULL) continue;
+
+    my_instance->prop_state.amplitude = amplitudes[i];
+    my_instance->prop_state.frequency = frequencies[i];
+    applied++;
+  }
+
+  return applied;
+}
+
+// Writes `[amplitudes, frequencies]` into an already constructed Array. Entries
+// that don't resolve to a MyCustomNode are reported as NAN.
+void my_custom_class_bulk_get(GDExtensionConstTypePtr p_nodes, GDExtensionTypePtr r_result) {
+  GDExtensionInt n = array_size(p_nodes);
+
+  unsigned char amplitudes[PACKED_ARRAY_SIZE];
+  unsigned char frequencies[PACKED_ARRAY_SIZE];
+  gd_extension_helper.constructor.packed_float64_array(&amplitudes, NULL);
+  gd_extension_helper.constructor.packed_float64_array(&frequencies, NULL);
+
+  GDExtensionInt resize_result;
+  GDExtensionConstTypePtr resize_args[] = { &n };
+  gd_extension_helper.builtin_method.packed_float64_array_resize(&amplitudes, resize_args, &resize_result, 1);
+  gd_extension_helper.builtin_method.packed_float64_array_resize(&frequencies, resize_args, &resize_result, 1);
+
+  if (n > 0) {
+    double *amplitude_data = gd_extension.packed_float64_array_operator_index(&amplitudes, 0);
+    double *frequency_data = gd_extension.packed_float64_array_operator_index(&frequencies, 0);
+
+    for (GDExtensionInt i = 0; i < n; i++) {
+      my_custom_class_t *my_instance
+        = my_custom_class_from_variant(gd_extension.array_operator_index_const(p_nodes, i));
+
+      amplitude_data[i] = my_instance != NULL ? my_instance->prop_state.amplitude : NAN;
+      frequency_data[i] = my_instance != NULL ? my_instance->prop_state.frequency : NAN;
+    }
+  }
+
+  GDExtensionInt two = 2;
+  GDExtensionConstTypePtr result_resize_args[] = { &two };
+  gd_extension_helper.builtin_method.array_resize(r_result, result_resize_args, &resize_result, 1);
+  // NOTE: resize filled the slots with Nil variants, so there is nothing to destroy
+  gd_extension_helper.wrap.packed_float64_array(gd_extension.array_operator_index(r_result, 0), &amplitudes);
+  gd_extension_helper.wrap.packed_float64_array(gd_extension.array_operator_index(r_result, 1), &frequencies);
+
+  gd_extension_helper.destructor.packed_float64_array(&amplitudes);
+  gd_extension_helper.destructor.packed_float64_array(&frequencies);
+}
+
+void
+my_custom_class_bulk_set_ptrcall(
+  void *method_userdata,
+  GDExtensionClassInstancePtr p_instance,
+  const GDExtensionConstTypePtr *p_args,
+  GDExtensionTypePtr r_ret
+) {
+  *(GDExtensionInt *)r_ret = my_custom_class_bulk_set(p_args[0], p_args[1], p_args[2]);
+}
+
+void
+my_custom_class_bulk_get_ptrcall(
+  void *method_userdata,
+  GDExtensionClassInstancePtr p_instance,
+  const GDExtensionConstTypePtr *p_args,
+  GDExtensionTypePtr r_ret
+) {
+  // NOTE: ptrcall hands us an already constructed Array, so we fill a local one
+  // and make `r_ret` reference it.
+  unsigned char result[ARRAY_SIZE];
+  gd_extension_helper.constructor.array(&result, NULL);
+  my_custom_class_bulk_get(p_args[0], &result);
+  gd_extension.array_ref(r_ret, &result);
+  gd_extension_helper.destructor.array(&result);
+}
+
+bool
+check_call_args(
+  const GDExtensionConstVariantPtr *p_args,
+  GDExtensionInt p_argument_count,
+  const GDExtensionVariantType *expected_types,
+  GDExtensionInt expected_count,
+  GDExtensionCallError *r_error
+) {
+  if (p_argument_count != expected_count) {
+    r_error->error = p_argument_count < expected_count
+      ? GDEXTENSION_CALL_ERROR_TOO_FEW_ARGUMENTS
+      : GDEXTENSION_CALL_ERROR_TOO_MANY_ARGUMENTS;
+    r_error->argument = 0;
+    r_error->expected = expected_count;
+    return false;
+  }
+
+  for (GDExtensionInt i = 0; i < expected_count; i++) {
+    if (gd_extension.variant_get_type(p_args[i]) != expected_types[i]) {
+      r_error->error = GDEXTENSION_CALL_ERROR_INVALID_ARGUMENT;
+      r_error->argument = i;
+      r_error->expected = expected_types[i];
+      return false;
+    }
+  }
+
+  r_error->error = GDEXTENSION_CALL_OK;
+  return true;
+}
+
+void
+my_custom_class_bulk_set_call(
+  void *method_userdata,
+  GDExtensionClassInstancePtr p_instance,
+  const GDExtensionConstVariantPtr *p_args,
+  GDExtensionInt p_argument_count,
+  GDExtensionVariantPtr r_return,
+  GDExtensionCallError *r_error
+) {
+  const GDExtensionVariantType expected_types[] = {
+    GDEXTENSION_VARIANT_TYPE_ARRAY,
+    GDEXTENSION_VARIANT_TYPE_PACKED_FLOAT64_ARRAY,
+    GDEXTENSION_VARIANT_TYPE_PACKED_FLOAT64_ARRAY,
+  };
+  if (!check_call_args(p_args, p_argument_count, expected_types, 3, r_error)) return;
+
+  // Unwrapping containers only bumps their refcount, the data is not copied
+  unsigned char nodes[ARRAY_SIZE];
+  unsigned char amplitudes[PACKED_ARRAY_SIZE];
+  unsigned char frequencies[PACKED_ARRAY_SIZE];
+  gd_extension_helper.unwrap.array(&nodes, (void *)p_args[0]);
+  gd_extension_helper.unwrap.packed_float64_array(&amplitudes, (void *)p_args[1]);
+  gd_extension_helper.unwrap.packed_float64_array(&frequencies, (void *)p_args[2]);
+
+  GDExtensionInt applied = my_custom_class_bulk_set(&nodes, &amplitudes, &frequencies);
+  gd_extension_helper.wrap.type_int(r_return, &applied);
+
+  gd_extension_helper.destructor.array(&nodes);
+  gd_extension_helper.destructor.packed_float64_array(&amplitudes);
+  gd_extension_helper.destructor.packed_float64_array(&frequencies);
+}
+
+void
+my_custom_class_bulk_get_call(
+  void *method_userdata,
+  GDExtensionClassInstancePtr p_instance,
+  const GDExtensionConstVariantPtr *p_args,
+  GDExtensionInt p_argument_count,
+  GDExtensionVariantPtr r_return,
+  GDExtensionCallError *r_error
+) {
+  const GDExtensionVariantType expected_types[] = { GDEXTENSION_VARIANT_TYPE_ARRAY };
+  if (!check_call_args(p_args, p_argument_count, expected_types, 1, r_error)) return;
+
+  unsigned char nodes[ARRAY_SIZE];
+  unsigned char result[ARRAY_SIZE];
+  gd_extension_helper.unwrap.array(&nodes, (void *)p_args[0]);
+  gd_extension_helper.constructor.array(&result, NULL);
+
+  my_custom_class_bulk_get(&nodes, &result);
+  gd_extension_helper.wrap.array(r_return, &result);
+
+  gd_extension_helper.destructor.array(&nodes);
+  gd_extension_helper.destructor.array(&result);
+}
+
+GDExtensionPropertyInfo make_property_info(GDExtensionVariantType type, const char *name) {
+  GDExtensionPropertyInfo res = {
+    .type = type,
+    .name = construct_string_name(name),
+    .class_name = construct_string_name(""),
+    .hint = 0, // Corresponds to no hints
+    .hint_string = construct_string(""),
+    .usage = 6, // Corresponds to default usage flags
+  };
+  return res;
+}
+
+void destruct_property_info(GDExtensionPropertyInfo *p_info) {
+  destruct_string_name(p_info->name);
+  destruct_string_name(p_info->class_name);
+  destruct_string(p_info->hint_string);
+}
+
+void register_my_custom_class_bulk_methods(GDExtensionConstStringNamePtr class_string_name) {
+  GDExtensionPropertyInfo bulk_set_args[] = {
+    make_property_info(GDEXTENSION_VARIANT_TYPE_ARRAY, "nodes"),
+    make_property_info(GDEXTENSION_VARIANT_TYPE_PACKED_FLOAT64_ARRAY, "amplitudes"),
+    make_property_info(GDEXTENSION_VARIANT_TYPE_PACKED_FLOAT64_ARRAY, "frequencies"),
+  };
+  GDExtensionClassMethodArgumentMetadata bulk_set_args_metadata[] = {
+    GDEXTENSION_METHOD_ARGUMENT_METADATA_NONE,
+    GDEXTENSION_METHOD_ARGUMENT_METADATA_NONE,
+    GDEXTENSION_METHOD_ARGUMENT_METADATA_NONE,
+  };
+  GDExtensionPropertyInfo bulk_set_return = make_property_info(GDEXTENSION_VARIANT_TYPE_INT, "");
+
+  GDExtensionClassMethodInfo bulk_set_info = {
+    .name = construct_string_name("bulk_set"),
+    .method_userdata = NULL,
+    .call_func = my_custom_class_bulk_set_call,
+    .ptrcall_func = my_custom_class_bulk_set_ptrcall,
+    .method_flags = GDEXTENSION_METHOD_FLAG_NORMAL | GDEXTENSION_METHOD_FLAG_STATIC,
+    .has_return_value = true,
+    .return_value_info = &bulk_set_return,
+    .return_value_metadata = GDEXTENSION_METHOD_ARGUMENT_METADATA_INT_IS_INT64,
+    .argument_count = 3,
+    .arguments_info = bulk_set_args,
+    .arguments_metadata = bulk_set_args_metadata,
+    .default_argument_count = 0,
+    .default_arguments = NULL,
+  };
+
+  GDExtensionPropertyInfo bulk_get_args[] = {
+    make_property_info(GDEXTENSION_VARIANT_TYPE_ARRAY, "nodes"),
+  };
+  GDExtensionClassMethodArgumentMetadata bulk_get_args_metadata[] = {
+    GDEXTENSION_METHOD_ARGUMENT_METADATA_NONE,
+  };
+  GDExtensionPropertyInfo bulk_get_return = make_property_info(GDEXTENSION_VARIANT_TYPE_ARRAY, "");
+
+  GDExtensionClassMethodInfo bulk_get_info = {
+    .name = construct_string_name("bulk_get"),
+    .method_userdata = NULL,
+    .call_func = my_custom_class_bulk_get_call,
+    .ptrcall_func = my_custom_class_bulk_get_ptrcall,
+    .method_flags = GDEXTENSION_METHOD_FLAG_NORMAL | GDEXTENSION_METHOD_FLAG_STATIC,
+    .has_return_value = true,
+    .return_value_info = &bulk_get_return,
+    .return_value_metadata = GDEXTENSION_METHOD_ARGUMENT_METADATA_NONE,
+    .argument_count = 1,
+    .arguments_info = bulk_get_args,
+    .arguments_metadata = bulk_get_args_metadata,
+    .default_argument_count = 0,
+    .default_arguments = NULL,
+  };
+
+  gd_extension.classdb_register_extension_class_method(gd_extension_helper.misc.p_library,
+                                                       class_string_name,
+                                                       &bulk_set_info);
+  gd_extension.classdb_register_extension_class_method(gd_extension_helper.misc.p_library,
+                                                       class_string_name,
+                                                       &bulk_get_info);
+
+  for (size_t i = 0; i < 3; i++) destruct_property_info(&bulk_set_args[i]);
+  destruct_property_info(&bulk_get_args[0]);
+  destruct_property_info(&bulk_set_return);
+  destruct_property_info(&bulk_get_return);
+  destruct_string_name(bulk_set_info.name);
+  destruct_string_name(bulk_get_info.name);
+}
+
+// ---------------------------------------------------------------------------
+// Binary snapshots
+// ---------------------------------------------------------------------------
+
+// File layout (host byte order, every section starts on a SNAPSHOT_ALIGNMENT
+// boundary):
+//
+//   snapshot_header_t
+//   double amplitude[count]
+//   double frequency[count]
+//   double time_elapsed[count]
+//
+// Each section is a plain array, so loading is a matter of mmap-ing the file
+// and reading the arrays in place. Bump SNAPSHOT_VERSION whenever the layout
+// changes, old files are rejected instead of being misread.
+
+#define SNAPSHOT_MAGIC ("MCNS")
+#define SNAPSHOT_VERSION (1)
+#define SNAPSHOT_ALIGNMENT (64)
+
+typedef enum {
+  SNAPSHOT_SECTION_AMPLITUDE,
+  SNAPSHOT_SECTION_FREQUENCY,
+  SNAPSHOT_SECTION_TIME_ELAPSED,
+  SNAPSHOT_SECTION_COUNT,
+} snapshot_section_t;
+
+typedef struct {
+  char magic[4];
+  uint32_t version;
+  uint64_t count;
+  uint64_t section_offset[SNAPSHOT_SECTION_COUNT];
+} snapshot_header_t;
+
+uint64_t snapshot_align(uint64_t offset) {
+  return (offset + SNAPSHOT_ALIGNMENT - 1) & ~(uint64_t)(SNAPSHOT_ALIGNMENT - 1);
+}
+
+// A rename is only durable once the directory holding it is synced too.
+// Best effort, the snapshot itself is already complete when this fails.
+void snapshot_sync_directory(const char *p_path) {
+  const char *slash = strrchr(p_path, '/');
+  char *dir;
+  if (slash == NULL) {
+    dir = strdup(".");
+  } else {
+    size_t length = slash == p_path ? 1 : (size_t)(slash - p_path);
+    dir = malloc(length + 1);
+    memcpy(dir, p_path, length);
+    dir[length] = '\0';
+  }
+
+  int fd = open(dir, O_RDONLY | O_DIRECTORY);
+  if (fd >= 0) {
+    fsync(fd);
+    close(fd);
+  }
+  free(dir);
+}
+
+// Returns a malloc-ed UTF-8 copy of a Godot String
+char *string_to_c_string(GDExtensionConstStringPtr p_string) {
+  GDExtensionInt length = gd_extension.string_to_utf8_chars(p_string, NULL, 0);
+  char *res = malloc(length + 1);
+  gd_extension.string_to_utf8_chars(p_string, res, length);
+  res[length] = '\0';
+  return res;
+}
+
+// Returns the number of saved nodes or -1 on failure. Nodes that can't be
+// resolved are saved with zeroed state so that indices keep lining up.
+GDExtensionInt snapshot_save(GDExtensionConstStringPtr p_path, GDExtensionConstTypePtr p_nodes) {
+  uint64_t count = array_size(p_nodes);
+
+  snapshot_header_t header;
+  memcpy(header.magic, SNAPSHOT_MAGIC, 4);
+  header.version = SNAPSHOT_VERSION;
+  header.count = count;
+
+  uint64_t offset = snapshot_align(sizeof(snapshot_header_t));
+  for (int s = 0; s < SNAPSHOT_SECTION_COUNT; s++) {
+    header.section_offset[s] = offset;
+    offset = snapshot_align(offset + count * sizeof(double));
+  }
+  uint64_t file_size = offset;
+
+  unsigned char *buffer = calloc(1, file_size);
+  if (buffer == NULL) return -1;
+  memcpy(buffer, &header, sizeof(header));
+
+  double *amplitude = (double *)(buffer + header.section_offset[SNAPSHOT_SECTION_AMPLITUDE]);
+  double *frequency = (double *)(buffer + header.section_offset[SNAPSHOT_SECTION_FREQUENCY]);
+  double *time_elapsed = (double *)(buffer + header.section_offset[SNAPSHOT_SECTION_TIME_ELAPSED]);
+
+  for (uint64_t i = 0; i < count; i++) {
+    my_custom_class_t *my_instance
+      = my_custom_class_from_variant(gd_extension.array_operator_index_const(p_nodes, i));
+    if (my_instance == NULL) continue;
+
+    amplitude[i] = my_instance->prop_state.amplitude;
+    frequency[i] = my_instance->prop_state.frequency;
+    time_elapsed[i] = my_instance->time_elapsed;
+  }
+
+  // Write next to the destination and rename, so a crash during quicksave
+  // never leaves a half-written snapshot behind.
+  char *path = string_to_c_string(p_path);
+  size_t path_length = strlen(path);
+  char *tmp_path = malloc(path_length + 5);
+  memcpy(tmp_path, path, path_length);
+  memcpy(tmp_path + path_length, ".tmp", 5);
+
+  GDExtensionInt res = -1;
+  int fd = open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd >= 0) {
+    uint64_t written = 0;
+    while (written < file_size) {
+      ssize_t n = write(fd, buffer + written, file_size - written);
+      if (n <= 0) break;
+      written += n;
+    }
+    // The data has to be on disk before the rename makes it the snapshot,
+    // or a power cut can leave the new name pointing at an empty file.
+    bool synced = written == file_size && fsync(fd) == 0;
+    close(fd);
+
+    if (synced && rename(tmp_path, path) == 0) {
+      snapshot_sync_directory(path);
+      res = count;
+    } else {
+      unlink(tmp_path);
+    }
+  }
+
+  if (res < 0) {
+    fprintf(stderr, "save_snapshot: failed to write %s\n", path);
+  }
+
+  free(tmp_path);
+  free(path);
+  free(buffer);
+  return res;
+}
+
+bool snapshot_is_valid(const unsigned char *data, uint64_t file_size) {
+  if (file_size < sizeof(snapshot_header_t)) return false;
+
+  const snapshot_header_t *header = (const snapshot_header_t *)data;
+  if (memcmp(header->magic, SNAPSHOT_MAGIC, 4) != 0) return false;
+  if (header->version != SNAPSHOT_VERSION) return false;
+  if (header->count > file_size / sizeof(double)) return false;
+
+  for (int s = 0; s < SNAPSHOT_SECTION_COUNT; s++) {
+    uint64_t offset = header->section_offset[s];
+    if (offset % SNAPSHOT_ALIGNMENT != 0) return false;
+    if (offset > file_size || header->count * sizeof(double) > file_size - offset) return false;
+  }
+
+  return true;
+}
+
+// Returns the number of restored nodes or -1 on failure. If the snapshot and
+// `p_nodes` differ in size, only the common prefix is restored.
+GDExtensionInt snapshot_load(GDExtensionConstStringPtr p_path, GDExtensionConstTypePtr p_nodes) {
+  char *path = string_to_c_string(p_path);
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    fprintf(stderr, "load_snapshot: can't open %s\n", path);
+    free(path);
+    return -1;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size == 0) {
+    fprintf(stderr, "load_snapshot: can't stat %s\n", path);
+    close(fd);
+    free(path);
+    return -1;
+  }
+
+  uint64_t file_size = st.st_size;
+  const unsigned char *data = mmap(NULL, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  // NOTE: The mapping stays valid after the descriptor is closed
+  close(fd);
+
+  if (data == MAP_FAILED) {
+    fprintf(stderr, "load_snapshot: can't mmap %s\n", path);
+    free(path);
+    return -1;
+  }
+
+  if (!snapshot_is_valid(data, file_size)) {
+    fprintf(stderr, "load_snapshot: %s is not a version %d snapshot\n", path, SNAPSHOT_VERSION);
+    munmap((void *)data, file_size);
+    free(path);
+    return -1;
+  }
+  // We are going to read every section front to back exactly once
+  madvise((void *)data, file_size, MADV_SEQUENTIAL);
+
+  const snapshot_header_t *header = (const snapshot_header_t *)data;
+  const double *amplitude = (const double *)(data + header->section_offset[SNAPSHOT_SECTION_AMPLITUDE]);
+  const double *frequency = (const double *)(data + header->section_offset[SNAPSHOT_SECTION_FREQUENCY]);
+  const double *time_elapsed = (const double *)(data + header->section_offset[SNAPSHOT_SECTION_TIME_ELAPSED]);
+
+  uint64_t node_count = array_size(p_nodes);
+  uint64_t n = node_count < header->count ? node_count : header->count;
+
+  GDExtensionInt restored = 0;
+  for (uint64_t i = 0; i < n; i++) {
+    my_custom_class_t *my_instance
+      = my_custom_class_from_variant(gd_extension.array_operator_index_const(p_nodes, i));
+    if (my_instance == NULL) continue;
+
+    my_instance->prop_state.amplitude = amplitude[i];
+    my_instance->prop_state.frequency = frequency[i];
+    my_instance->time_elapsed = time_elapsed[i];
+    restored++;
+  }
+
+  munmap((void *)data, file_size);
+  free(path);
+  return restored;
+}
+
+void
+my_custom_class_save_snapshot_ptrcall(
+  void *method_userdata,
+  GDExtensionClassInstancePtr p_instance,
+  const GDExtensionConstTypePtr *p_args,
+  GDExtensionTypePtr r_ret
+) {
+  *(GDExtensionInt *)r_ret = snapshot_save(p_args[0], p_args[1]);
+}
+
+void
+my_custom_class_load_snapshot_ptrcall(
+  void *method_userdata,
+  GDExtensionClassInstancePtr p_instance,
+  const GDExtensionConstTypePtr *p_args,
+  GDExtensionTypePtr r_ret
+) {
+  *(GDExtensionInt *)r_ret = snapshot_load(p_args[0], p_args[1]);
+}
+
+void
+my_custom_class_snapshot_call(
+  void *method_userdata,
+  GDExtensionClassInstancePtr p_instance,
+  const GDExtensionConstVariantPtr *p_args,
+  GDExtensionInt p_argument_count,
+  GDExtensionVariantPtr r_return,
+  GDExtensionCallError *r_error
+) {
+  const GDExtensionVariantType expected_types[] = {
+    GDEXTENSION_VARIANT_TYPE_STRING,
+    GDEXTENSION_VARIANT_TYPE_ARRAY,
+  };
+  if (!check_call_args(p_args, p_argument_count, expected_types, 2, r_error)) return;
+
+  unsigned char path[IS_GODOT_64_BIT ? 8 : 4];
+  unsigned char nodes[ARRAY_SIZE];
+  gd_extension_helper.unwrap.string(&path, (void *)p_args[0]);
+  gd_extension_helper.unwrap.array(&nodes, (void *)p_args[1]);
+
+  // `method_userdata` tells the save and load methods apart
+  GDExtensionInt (*snapshot_func)(GDExtensionConstStringPtr, GDExtensionConstTypePtr) = method_userdata;
+  GDExtensionInt res = snapshot_func(&path, &nodes);
+  gd_extension_helper.wrap.type_int(r_return, &res);
+
+  destruct_string(&path);
+  gd_extension_helper.destructor.array(&nodes);
+}
+
+void register_my_custom_class_snapshot_methods(GDExtensionConstStringNamePtr class_string_name) {
+  const char *names[] = { "save_snapshot", "load_snapshot" };
+  void *userdata[] = { snapshot_save, snapshot_load };
+  GDExtensionClassMethodPtrCall ptrcall_funcs[] = {
+    my_custom_class_save_snapshot_ptrcall,
+    my_custom_class_load_snapshot_ptrcall,
+  };
+
+  for (size_t i = 0; i < 2; i++) {
+    GDExtensionPropertyInfo args[] = {
+      make_property_info(GDEXTENSION_VARIANT_TYPE_STRING, "path"),
+      make_property_info(GDEXTENSION_VARIANT_TYPE_ARRAY, "nodes"),
+    };
+    GDExtensionClassMethodArgumentMetadata args_metadata[] = {
+      GDEXTENSION_METHOD_ARGUMENT_METADATA_NONE,
+      GDEXTENSION_METHOD_ARGUMENT_METADATA_NONE,
+    };
+    GDExtensionPropertyInfo return_info = make_property_info(GDEXTENSION_VARIANT_TYPE_INT, "");
+
+    GDExtensionClassMethodInfo method_info = {
+      .name = construct_string_name(names[i]),
+      .method_userdata = userdata[i],
+      .call_func = my_custom_class_snapshot_call,
+      .ptrcall_func = ptrcall_funcs[i],
+      .method_flags = GDEXTENSION_METHOD_FLAG_NORMAL | GDEXTENSION_METHOD_FLAG_STATIC,
+      .has_return_value = true,
+      .return_value_info = &return_info,
+      .return_value_metadata = GDEXTENSION_METHOD_ARGUMENT_METADATA_INT_IS_INT64,
+      .argument_count = 2,
+      .arguments_info = args,
+      .arguments_metadata = args_metadata,
+      .default_argument_count = 0,
+      .default_arguments = NULL,
+    };
+
+    gd_extension.classdb_register_extension_class_method(gd_extension_helper.misc.p_library,
+                                                         class_string_name,
+                                                         &method_info);
+
+    destruct_property_info(&args[0]);
+    destruct_property_info(&args[1]);
+    destruct_property_info(&return_info);
+    destruct_string_name(method_info.name);
+  }
+}
+
+GDExtensionClassCallVirtual
+my_custom_class_get_virtual(
+   void *p_class_userdata,
+   GDExtensionConstStringNamePtr p_name
+) {
+  if (string_name_eq(p_name, gd_extension_helper.string_name._process)) {
+    return my_custom_class__process_override;
+  }
+  return NULL;
+}
+
+// NOTE: We can only call this when Node has been loaded in ClassDB (during
+// GDEXTENSION_INITIALIZATION_SCENE)
+void register_my_custom_class() {
+  GDExtensionClassCreationInfo2 class_info = {
+    .is_virtual = false,
+    .is_abstract = false,
+    .is_exposed = true,
+    .set_func = my_custom_class_set_func,
+    .get_func = my_custom_class_get_func,
+    .get_property_list_func = my_custom_class_get_property_list,
+    .free_property_list_func = my_custom_class_free_property_list,
+    .property_can_revert_func = NULL,
+    .property_get_revert_func = NULL,
+    .validate_property_func = NULL,
+    .notification_func = NULL,
+    .to_string_func = NULL,
+    .reference_func = NULL,
+    .unreference_func = NULL,
+    .create_instance_func = my_custom_class_init,
+    .free_instance_func = my_custom_class_deinit,
+    .recreate_instance_func = NULL,
+    .get_virtual_func = my_custom_class_get_virtual,
+    .get_virtual_call_data_func = NULL,
+    .call_virtual_with_data_func = NULL,
+    .get_rid_func = NULL,
+    .class_userdata = NULL,
+  };
+
+  void *my_class_string_name = construct_string_name(MY_CUSTOM_CLASS_NAME);
+  void *parent_class_string_name = construct_string_name(MY_CUSTOM_CLASS_PARENT);
+
+  gd_extension.classdb_register_extension_class2(gd_extension_helper.misc.p_library,
+                                                 my_class_string_name,
+                                                 parent_class_string_name,
+                                                 &class_info);
+
+  register_my_custom_class_bulk_methods(my_class_string_name);
+  register_my_custom_class_snapshot_methods(my_class_string_name);
+  gd_extension_helper.misc.my_custom_class_tag = gd_extension.classdb_get_class_tag(my_class_string_name);
+
+  destruct_string_name(my_class_string_name);
+  destruct_string_name(parent_class_string_name);
+}
+
+// ---------------------------------------------------------------------------
+// Snapshot vs scene benchmark
+// ---------------------------------------------------------------------------
+
+uint64_t now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+GDExtensionMethodBindPtr get_method_bind(const char *class_name, const char *method_name, GDExtensionInt hash) {
+  void *class_string_name = construct_string_name(class_name);
+  void *method_string_name = construct_string_name(method_name);
+
+  GDExtensionMethodBindPtr res
+    = gd_extension.classdb_get_method_bind(class_string_name, method_string_name, hash);
+
+  destruct_string_name(class_string_name);
+  destruct_string_name(method_string_name);
+  return res;
+}
+
+GDExtensionObjectPtr construct_object(const char *class_name) {
+  void *class_string_name = construct_string_name(class_name);
+  GDExtensionObjectPtr res = gd_extension.classdb_construct_object(class_string_name);
+  destruct_string_name(class_string_name);
+  return res;
+}
+
+// Makes `count` MyCustomNodes and puts them into the already constructed
+// `r_nodes`. With a `root`, they become its children and it owns them, which
+// is what `PackedScene.pack` saves.
+void snapshot_benchmark_make_nodes(GDExtensionTypePtr r_nodes, GDExtensionInt count, GDExtensionObjectPtr root) {
+  GDExtensionInt err;
+  const GDExtensionConstTypePtr resize_args[] = { &count };
+  gd_extension_helper.builtin_method.array_resize(r_nodes, resize_args, &err, 1);
+
+  for (GDExtensionInt i = 0; i < count; i++) {
+    GDExtensionObjectPtr node = construct_object(MY_CUSTOM_CLASS_NAME);
+    // Resizing filled the Array with Nil, which owns nothing
+    gd_extension_helper.wrap.object(gd_extension.array_operator_index(r_nodes, i), &node);
+    if (root == NULL) continue;
+
+    GDExtensionBool force_readable_name = false;
+    GDExtensionInt internal = 0;
+    const GDExtensionConstTypePtr add_child_args[] = { &node, &force_readable_name, &internal };
+    gd_extension.object_method_bind_ptrcall(gd_extension_helper.misc.node_add_child, root, add_child_args, NULL);
+    const GDExtensionConstTypePtr set_owner_args[] = { &root };
+    gd_extension.object_method_bind_ptrcall(gd_extension_helper.misc.node_set_owner, node, set_owner_args, NULL);
+  }
+}
+
+// The nodes have to be freed one by one, the Array only holds pointers
+void snapshot_benchmark_free_nodes(GDExtensionConstTypePtr p_nodes) {
+  for (GDExtensionInt i = 0; i < array_size(p_nodes); i++) {
+    GDExtensionObjectPtr node;
+    gd_extension_helper.unwrap.object(&node, (void *)gd_extension.array_operator_index_const(p_nodes, i));
+    gd_extension.object_destroy(node);
+  }
+}
+
+GDExtensionObjectPtr snapshot_benchmark_child(GDExtensionObjectPtr root, GDExtensionInt index) {
+  GDExtensionBool include_internal = false;
+  const GDExtensionConstTypePtr args[] = { &index, &include_internal };
+  GDExtensionObjectPtr res = NULL;
+  gd_extension.object_method_bind_ptrcall(gd_extension_helper.misc.node_get_child, root, args, &res);
+  return res;
+}
+
+// Restores the same nodes from a snapshot and from a scene made with
+// `PackedScene.pack`. Both sides make every node from scratch, the scene sets
+// the properties through `.set_func`, the snapshot reads them from the mmap-ed
+// file. The packed scene is kept in memory, so the time a `.tscn` spends in the
+// text parser isn't even counted.
+void print_snapshot_benchmark() {
+  GDExtensionInt count = SNAPSHOT_BENCHMARK_NODES;
+  gd_extension_helper.misc.quiet = true;
+
+  GDExtensionObjectPtr root = construct_object("Node");
+  uint8_t nodes[ARRAY_SIZE];
+  gd_extension_helper.constructor.array(nodes, NULL);
+  snapshot_benchmark_make_nodes(nodes, count, root);
+  for (GDExtensionInt i = 0; i < count; i++) {
+    my_custom_class_t *my_instance = my_custom_class_from_variant(gd_extension.array_operator_index_const(nodes, i));
+    my_instance->prop_state.amplitude = 1.0 + i;
+    my_instance->prop_state.frequency = 0.5 * i;
+  }
+
+  GDExtensionObjectPtr scene = construct_object("PackedScene");
+  GDExtensionInt packed = -1;
+  const GDExtensionConstTypePtr pack_args[] = { &root };
+  gd_extension.object_method_bind_ptrcall(gd_extension_helper.misc.packed_scene_pack, scene, pack_args, &packed);
+
+  GDExtensionStringPtr path = construct_string(SNAPSHOT_BENCHMARK_PATH);
+  GDExtensionInt saved = snapshot_save(path, nodes);
+
+  uint64_t start = now_ns();
+  GDExtensionInt edit_state = 0;
+  const GDExtensionConstTypePtr instantiate_args[] = { &edit_state };
+  GDExtensionObjectPtr scene_root = NULL;
+  gd_extension.object_method_bind_ptrcall(gd_extension_helper.misc.packed_scene_instantiate,
+                                          scene,
+                                          instantiate_args,
+                                          &scene_root);
+  uint64_t scene_ns = now_ns() - start;
+
+  start = now_ns();
+  uint8_t loaded[ARRAY_SIZE];
+  gd_extension_helper.constructor.array(loaded, NULL);
+  snapshot_benchmark_make_nodes(loaded, count, NULL);
+  GDExtensionInt restored = snapshot_load(path, loaded);
+  uint64_t snapshot_ns = now_ns() - start;
+
+  // Both copies have to match the nodes they were made from
+  bool same = packed == 0 && saved == count && restored == count && scene_root != NULL;
+  for (GDExtensionInt i = 0; same && i < count; i++) {
+    my_custom_class_t *original = my_custom_class_from_variant(gd_extension.array_operator_index_const(nodes, i));
+    my_custom_class_t *from_snapshot = my_custom_class_from_variant(gd_extension.array_operator_index_const(loaded, i));
+    GDExtensionObjectPtr child = snapshot_benchmark_child(scene_root, i);
+    my_custom_class_t *from_scene = child == NULL ? NULL
+      : gd_extension.object_get_instance_binding(child,
+                                                 gd_extension_helper.misc.p_library,
+                                                 &my_custom_class_binding_callbacks);
+    same = from_scene != NULL
+           && memcmp(&from_scene->prop_state, &original->prop_state, sizeof(original->prop_state)) == 0
+           && memcmp(&from_snapshot->prop_state, &original->prop_state, sizeof(original->prop_state)) == 0;
+  }
+
+  printf("%ld nodes: PackedScene.instantiate %.1f us, new nodes + load_snapshot %.1f us (%s)\n",
+         (long)count,
+         scene_ns / 1000.0,
+         snapshot_ns / 1000.0,
+         same ? "same state" : "DIFFERENT state");
+
+  // Freeing a node frees its children
+  if (scene_root != NULL) gd_extension.object_destroy(scene_root);
+  gd_extension.object_destroy(root);
+  snapshot_benchmark_free_nodes(loaded);
+  gd_extension.object_destroy(scene);
+  gd_extension_helper.destructor.array(loaded);
+  gd_extension_helper.destructor.array(nodes);
+  unlink(SNAPSHOT_BENCHMARK_PATH);
+  destruct_string(path);
+  gd_extension_helper.misc.quiet = false;
+}
+
+void godot_initialize(void *userdata, GDExtensionInitializationLevel p_level) {
+  if (p_level == GDEXTENSION_INITIALIZATION_SCENE) {
+    gd_extension_helper.string_name.amplitude = construct_string_name("amplitude");
+    gd_extension_helper.string_name.frequency = construct_string_name("frequency");
+    gd_extension_helper.string_name._process = construct_string_name("_process");
+    gd_extension_helper.string_name.position = construct_string_name("position");
+
+    void *node2d_string_name = construct_string_name("Node2D");
+    void *set_position_string_name = construct_string_name("set_position");
+
+    gd_extension_helper.misc.node2d_set_position
+      = gd_extension.classdb_get_method_bind(node2d_string_name,
+                                             set_position_string_name,
+                                             743155724);
+
+    destruct_string_name(node2d_string_name);
+    destruct_string_name(set_position_string_name);
+
+    gd_extension_helper.misc.node_add_child = get_method_bind("Node", "add_child", 3863233950);
+    gd_extension_helper.misc.node_set_owner = get_method_bind("Node", "set_owner", 1078189570);
+    gd_extension_helper.misc.node_get_child = get_method_bind("Node", "get_child", 541253412);
+    gd_extension_helper.misc.packed_scene_pack = get_method_bind("PackedScene", "pack", 2584678054);
+    gd_extension_helper.misc.packed_scene_instantiate = get_method_bind("PackedScene", "instantiate", 2628778455);
+
+    void *size_string_name = construct_string_name("size");
+    void *resize_string_name = construct_string_name("resize");
+
+    gd_extension_helper.builtin_method.array_size
+      = gd_extension.variant_get_ptr_builtin_method(GDEXTENSION_VARIANT_TYPE_ARRAY,
+                                                    size_string_name,
+                                                    3173160232);
+    gd_extension_helper.builtin_method.array_resize
+      = gd_extension.variant_get_ptr_builtin_method(GDEXTENSION_VARIANT_TYPE_ARRAY,
+                                                    resize_string_name,
+                                                    848867239);
+    gd_extension_helper.builtin_method.packed_float64_array_size
+      = gd_extension.variant_get_ptr_builtin_method(GDEXTENSION_VARIANT_TYPE_PACKED_FLOAT64_ARRAY,
+                                                    size_string_name,
+                                                    3173160232);
+    gd_extension_helper.builtin_method.packed_float64_array_resize
+      = gd_extension.variant_get_ptr_builtin_method(GDEXTENSION_VARIANT_TYPE_PACKED_FLOAT64_ARRAY,
+                                                    resize_string_name,
+                                                    848867239);
+
+    destruct_string_name(size_string_name);
+    destruct_string_name(resize_string_name);
+
+    register_my_custom_class();
+    print_snapshot_benchmark();
+    return;
+  }
+}
+
+void godot_deinitialize(void *userdata, GDExtensionInitializationLevel p_level) {
+  if (p_level == GDEXTENSION_INITIALIZATION_SCENE) {
+    destruct_string_name(gd_extension_helper.string_name.amplitude);
+    destruct_string_name(gd_extension_helper.string_name.frequency);
+    destruct_string_name(gd_extension_helper.string_name._process);
+    destruct_string_name(gd_extension_helper.string_name.position);
+  }
+}
+
+GDExtensionBool
+godot_entry(
+  GDExtensionInterfaceGetProcAddress p_get_proc_address,
+  const GDExtensionClassLibraryPtr p_library,
+  GDExtensionInitialization *r_initialization
+) {
+  r_initialization->minimum_initialization_level = GDEXTENSION_INITIALIZATION_SCENE;
+  r_initialization->userdata = NULL;
+  r_initialization->initialize = godot_initialize;
+  r_initialization->deinitialize = godot_deinitialize;
+
+  STORE_GD_EXTENSION(classdb_construct_object);
+  STORE_GD_EXTENSION(classdb_register_extension_class2);
+  STORE_GD_EXTENSION(classdb_get_method_bind);
+  STORE_GD_EXTENSION(string_name_new_with_utf8_chars);
+  STORE_GD_EXTENSION(string_new_with_utf8_chars);
+  STORE_GD_EXTENSION(string_to_utf8_chars);
+  STORE_GD_EXTENSION(object_set_instance);
+  STORE_GD_EXTENSION(object_destroy);
+  STORE_GD_EXTENSION(variant_get_ptr_destructor);
+  STORE_GD_EXTENSION(variant_evaluate);
+  STORE_GD_EXTENSION(get_variant_from_type_constructor);
+  STORE_GD_EXTENSION(get_variant_to_type_constructor);
+  STORE_GD_EXTENSION(variant_get_ptr_operator_evaluator);
+  STORE_GD_EXTENSION(variant_get_type);
+  STORE_GD_EXTENSION(object_method_bind_ptrcall);
+  STORE_GD_EXTENSION(object_set_instance_binding);
+  STORE_GD_EXTENSION(object_get_instance_binding);
+  STORE_GD_EXTENSION(object_get_instance_from_id);
+  STORE_GD_EXTENSION(object_cast_to);
+  STORE_GD_EXTENSION(classdb_get_class_tag);
+  STORE_GD_EXTENSION(classdb_register_extension_class_method);
+  STORE_GD_EXTENSION(variant_get_ptr_builtin_method);
+  STORE_GD_EXTENSION(variant_get_ptr_constructor);
+  STORE_GD_EXTENSION(array_operator_index);
+  STORE_GD_EXTENSION(array_operator_index_const);
+  STORE_GD_EXTENSION(array_ref);
+  STORE_GD_EXTENSION(packed_float64_array_operator_index);
+  STORE_GD_EXTENSION(packed_float64_array_operator_index_const);
+
+  gd_extension_helper.wrap.type_double
+    = gd_extension.get_variant_from_type_constructor(GDEXTENSION_VARIANT_TYPE_FLOAT);
+
+  gd_extension_helper.wrap.type_int
+    = gd_extension.get_variant_from_type_constructor(GDEXTENSION_VARIANT_TYPE_INT);
+  gd_extension_helper.wrap.array
+    = gd_extension.get_variant_from_type_constructor(GDEXTENSION_VARIANT_TYPE_ARRAY);
+  gd_extension_helper.wrap.packed_float64_array
+    = gd_extension.get_variant_from_type_constructor(GDEXTENSION_VARIANT_TYPE_PACKED_FLOAT64_ARRAY);
+  gd_extension_helper.wrap.object
+    = gd_extension.get_variant_from_type_constructor(GDEXTENSION_VARIANT_TYPE_OBJECT);
+
+  gd_extension_helper.unwrap.type_int
+    = gd_extension.get_variant_to_type_constructor(GDEXTENSION_VARIANT_TYPE_INT);
+  gd_extension_helper.unwrap.object
+    = gd_extension.get_variant_to_type_constructor(GDEXTENSION_VARIANT_TYPE_OBJECT);
+  gd_extension_helper.unwrap.array
+    = gd_extension.get_variant_to_type_constructor(GDEXTENSION_VARIANT_TYPE_ARRAY);
+  gd_extension_helper.unwrap.packed_float64_array
+    = gd_extension.get_variant_to_type_constructor(GDEXTENSION_VARIANT_TYPE_PACKED_FLOAT64_ARRAY);
+  gd_extension_helper.unwrap.string
+    = gd_extension.get_variant_to_type_constructor(GDEXTENSION_VARIANT_TYPE_STRING);
+
+  gd_extension_helper.misc.p_library = p_library;
+  gd_extension_helper.misc.string_name_eq_op
+    = gd_extension.variant_get_ptr_operator_evaluator(GDEXTENSION_VARIANT_OP_EQUAL,
+                                                      GDEXTENSION_VARIANT_TYPE_STRING_NAME,
+                                                      GDEXTENSION_VARIANT_TYPE_STRING_NAME);
+
+  gd_extension_helper.destructor.string_name
+    = gd_extension.variant_get_ptr_destructor(GDEXTENSION_VARIANT_TYPE_STRING_NAME);
+  gd_extension_helper.destructor.string
+    = gd_extension.variant_get_ptr_destructor(GDEXTENSION_VARIANT_TYPE_STRING);
+  gd_extension_helper.destructor.array
+    = gd_extension.variant_get_ptr_destructor(GDEXTENSION_VARIANT_TYPE_ARRAY);
+  gd_extension_helper.destructor.packed_float64_array
+    = gd_extension.variant_get_ptr_destructor(GDEXTENSION_VARIANT_TYPE_PACKED_FLOAT64_ARRAY);
+
+  gd_extension_helper.constructor.array
+    = gd_extension.variant_get_ptr_constructor(GDEXTENSION_VARIANT_TYPE_ARRAY, 0);
+  gd_extension_helper.constructor.packed_float64_array
+    = gd_extension.variant_get_ptr_constructor(GDEXTENSION_VARIANT_TYPE_PACKED_FLOAT64_ARRAY, 0);
+
+  variant_unwrap_init(p_get_proc_address);
+
+  return true;
+}
@@ -0,0 +1,453 @@
+#include "../godot-headers/gdextension_interface.h"
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <math.h>
+
+#define STORE_GD_EXTENSION(str_name) gd_extension.str_name = (void *)p_get_proc_address(#str_name);
+#define IS_GODOT_64_BIT (true)
+#define IS_GODOT_USING_LARGE_WORLD_COORDINATES (false)
+#define VARIANT_SIZE (IS_GODOT_USING_LARGE_WORLD_COORDINATES ? 40 : 24)
+#define MY_CUSTOM_CLASS_NAME ("MyCustomNode")
+#define MY_CUSTOM_CLASS_PARENT ("Sprite2D")
+#define DEFAULT_HARMONICS (8)
+#define MAX_HARMONICS (1024)
+
+#include "../util/variant_unwrap.h"
+#include "../util/mem_tag.h"
+#include "../util/thread_scratch.h"
+
+// NOTE: `gd_extension` and `gd_extension_helper` are only written in
+// `godot_entry` and `godot_initialize`, before any instance exists, and in
+// `godot_deinitialize`, after the last one is gone. In between they are
+// read-only tables, which is what lets the callbacks below run on any thread.
+struct {
+  GDExtensionInterfaceClassdbConstructObject classdb_construct_object;
+  GDExtensionInterfaceClassdbRegisterExtensionClass2 classdb_register_extension_class2;
+  GDExtensionInterfaceClassdbGetMethodBind classdb_get_method_bind;
+  GDExtensionInterfaceStringNameNewWithUtf8Chars string_name_new_with_utf8_chars;
+  GDExtensionInterfaceStringNewWithUtf8Chars string_new_with_utf8_chars;
+  GDExtensionInterfaceObjectSetInstance object_set_instance;
+  GDExtensionInterfaceVariantGetPtrDestructor variant_get_ptr_destructor;
+  GDExtensionInterfaceGetVariantFromTypeConstructor get_variant_from_type_constructor;
+  GDExtensionInterfaceVariantGetPtrOperatorEvaluator variant_get_ptr_operator_evaluator;
+  GDExtensionInterfaceObjectMethodBindPtrcall object_method_bind_ptrcall;
+} gd_extension;
+
+struct {
+  struct {
+    GDExtensionPtrDestructor string_name;
+    GDExtensionPtrDestructor string;
+  } destructor;
+  struct {
+    GDExtensionVariantFromTypeConstructorFunc type_double;
+    GDExtensionVariantFromTypeConstructorFunc type_int;
+  } wrap;
+  // Everything the callbacks need is made once in `godot_initialize`, so
+  // they never construct a StringName of their own
+  struct {
+    GDExtensionStringNamePtr amplitude;
+    GDExtensionStringNamePtr frequency;
+    GDExtensionStringNamePtr harmonics;
+    GDExtensionStringNamePtr _process;
+    GDExtensionStringNamePtr my_custom_class;
+    GDExtensionStringNamePtr my_custom_class_parent;
+  } string_name;
+  struct {
+    GDExtensionClassLibraryPtr p_library;
+    GDExtensionPtrOperatorEvaluator string_name_eq_op;
+    GDExtensionMethodBindPtr node2d_set_position;
+  } misc;
+} gd_extension_helper;
+
+#if (IS_GODOT_USING_LARGE_WORLD_COORDINATES)
+typedef struct {
+  double x;
+  double y;
+} GDVector2;
+#else
+typedef struct {
+  float x;
+  float y;
+} GDVector2;
+#endif
+
+static mem_tag_t node_tag = MEM_TAG("MyCustomNode", 0, MEM_BUDGET_WARN);
+static mem_tag_t property_list_tag = MEM_TAG("property_list", 0, MEM_BUDGET_WARN);
+static mem_tag_t string_tag = MEM_TAG("string", 0, MEM_BUDGET_WARN);
+
+static mem_pool_t node_pool;
+
+static atomic_int live_instances;
+
+GDExtensionStringNamePtr construct_string_name(const char *c_string) {
+  void *res = mem_tag_alloc(&string_tag, IS_GODOT_64_BIT ? 8 : 4);
+  gd_extension.string_name_new_with_utf8_chars(res, c_string);
+  return res;
+}
+
+GDExtensionStringPtr construct_string(const char *c_string) {
+  void *res = mem_tag_alloc(&string_tag, IS_GODOT_64_BIT ? 8 : 4);
+  gd_extension.string_new_with_utf8_chars(res, c_string);
+  return res;
+}
+
+void destruct_string_name(GDExtensionStringNamePtr p) {
+  gd_extension_helper.destructor.string_name(p);
+  mem_tag_free(p);
+}
+
+void destruct_string(GDExtensionStringPtr p) {
+  gd_extension_helper.destructor.string(p);
+  mem_tag_free(p);
+}
+
+// `time_elapsed` belongs to the thread that processes the node. The
+// properties can be set from another one, for example the main thread while
+// the node's group runs on a worker, so they are atomics. Relaxed is enough:
+// `_process` only needs some recent value of each.
+typedef struct {
+  GDExtensionObjectPtr godot_object;
+  double time_elapsed;
+  struct {
+    _Atomic double amplitude;
+    _Atomic double frequency;
+    _Atomic GDExtensionInt harmonics;
+  } prop_state;
+} my_custom_class_t;
+
+struct {
+  const char *name;
+  const GDExtensionVariantType type;
+} my_custom_class_props[] = {
+  {
+    .name = "frequency",
+    .type = GDEXTENSION_VARIANT_TYPE_FLOAT,
+  },
+  {
+    .name = "amplitude",
+    .type = GDEXTENSION_VARIANT_TYPE_FLOAT,
+  },
+  {
+    .name = "harmonics",
+    .type = GDEXTENSION_VARIANT_TYPE_INT,
+  }
+};
+
+const GDExtensionPropertyInfo *
+my_custom_class_get_property_list(
+  GDExtensionClassInstancePtr p_instance,
+  uint32_t *r_count
+) {
+  size_t n = sizeof(my_custom_class_props) / sizeof(*my_custom_class_props);
+  *r_count = n;
+
+  GDExtensionPropertyInfo *res = mem_tag_alloc(&property_list_tag, n * sizeof(GDExtensionPropertyInfo));
+
+  for (size_t i = 0; i < n; i++) {
+    res[i].type = my_custom_class_props[i].type;
+    res[i].name = construct_string_name(my_custom_class_props[i].name);
+    res[i].class_name = construct_string_name(MY_CUSTOM_CLASS_NAME);
+    res[i].hint = 0; // Corresponds to no hints
+    res[i].hint_string = construct_string("");
+    res[i].usage = 6; // Corresponds to default usage flags
+  }
+
+  return res;
+}
+
+void
+my_custom_class_free_property_list(
+  GDExtensionClassInstancePtr p_instance,
+  const GDExtensionPropertyInfo *p_list
+) {
+  size_t n = sizeof(my_custom_class_props) / sizeof(*my_custom_class_props);
+
+  for (size_t i = 0; i < n; i++) {
+    destruct_string_name((void*)p_list[i].name);
+    destruct_string((void*)p_list[i].hint_string);
+    destruct_string_name((void*)p_list[i].class_name);
+  }
+
+  mem_tag_free((void*)p_list);
+}
+
+// Godot can create nodes on any thread, so this only touches the pool, which
+// locks, and the prebuilt StringNames
+GDExtensionObjectPtr my_custom_class_init(void *userdata) {
+  my_custom_class_t *my_instance = mem_pool_alloc(&node_pool);
+
+  my_instance->godot_object
+    = gd_extension.classdb_construct_object(gd_extension_helper.string_name.my_custom_class_parent);
+  my_instance->time_elapsed = 0.0;
+  atomic_init(&my_instance->prop_state.amplitude, 1.23);
+  atomic_init(&my_instance->prop_state.frequency, 2.45);
+  atomic_init(&my_instance->prop_state.harmonics, DEFAULT_HARMONICS);
+  gd_extension.object_set_instance(my_instance->godot_object,
+                                   gd_extension_helper.string_name.my_custom_class,
+                                   my_instance);
+
+  atomic_fetch_add_explicit(&live_instances, 1, memory_order_relaxed);
+  return my_instance->godot_object;
+}
+
+void my_custom_class_deinit(void *userdata, GDExtensionClassInstancePtr p_instance) {
+  if (p_instance == NULL) return;
+
+  mem_pool_free(&node_pool, p_instance);
+  atomic_fetch_sub_explicit(&live_instances, 1, memory_order_relaxed);
+}
+
+bool string_name_eq(const void *a, const void *b) {
+  GDExtensionBool res;
+  gd_extension_helper.misc.string_name_eq_op(a, b, &res);
+  return res;
+}
+
+GDExtensionBool
+my_custom_class_set_func(
+  GDExtensionClassInstancePtr p_instance,
+  GDExtensionConstStringNamePtr p_name,
+  GDExtensionConstVariantPtr p_value
+) {
+  my_custom_class_t *my_instance = p_instance;
+
+  if (string_name_eq(p_name, gd_extension_helper.string_name.frequency)) {
+    double frequency;
+    if (!variant_unwrap_float(p_value, &frequency)) return false;
+    atomic_store_explicit(&my_instance->prop_state.frequency, frequency, memory_order_relaxed);
+    return true;
+  }
+
+  if (string_name_eq(p_name, gd_extension_helper.string_name.amplitude)) {
+    double amplitude;
+    if (!variant_unwrap_float(p_value, &amplitude)) return false;
+    atomic_store_explicit(&my_instance->prop_state.amplitude, amplitude, memory_order_relaxed);
+    return true;
+  }
+
+  if (string_name_eq(p_name, gd_extension_helper.string_name.harmonics)) {
+    GDExtensionInt harmonics;
+    if (!variant_unwrap_int(p_value, &harmonics) || harmonics < 1 || harmonics > MAX_HARMONICS) return false;
+    atomic_store_explicit(&my_instance->prop_state.harmonics, harmonics, memory_order_relaxed);
+    return true;
+  }
+
+  return false;
+}
+
+GDExtensionBool
+my_custom_class_get_func(
+  GDExtensionClassInstancePtr p_instance,
+  GDExtensionConstStringNamePtr p_name,
+  GDExtensionVariantPtr r_ret
+) {
+  my_custom_class_t *my_instance = p_instance;
+
+  if (string_name_eq(p_name, gd_extension_helper.string_name.frequency)) {
+    double frequency = atomic_load_explicit(&my_instance->prop_state.frequency, memory_order_relaxed);
+    gd_extension_helper.wrap.type_double(r_ret, &frequency);
+    return true;
+  }
+
+  if (string_name_eq(p_name, gd_extension_helper.string_name.amplitude)) {
+    double amplitude = atomic_load_explicit(&my_instance->prop_state.amplitude, memory_order_relaxed);
+    gd_extension_helper.wrap.type_double(r_ret, &amplitude);
+    return true;
+  }
+
+  if (string_name_eq(p_name, gd_extension_helper.string_name.harmonics)) {
+    GDExtensionInt harmonics = atomic_load_explicit(&my_instance->prop_state.harmonics, memory_order_relaxed);
+    gd_extension_helper.wrap.type_int(r_ret, &harmonics);
+    return true;
+  }
+
+  return false;
+}
+
+// The first `harmonics` terms of the Fourier series of a square wave. The
+// terms go into scratch memory of this thread and are added smallest first,
+// which loses less precision than adding them as they come. A global buffer
+// would be shared by every thread in the process group, and `malloc` here
+// would allocate every frame.
+double square_wave(double t, GDExtensionInt harmonics) {
+  thread_scratch_mark_t mark = thread_scratch_mark();
+  double *terms = thread_scratch_alloc(harmonics * sizeof(double));
+  if (terms == NULL) return 0.0;
+
+  for (GDExtensionInt k = 0; k < harmonics; k++) {
+    double n = 2 * k + 1;
+    terms[k] = sin(n * t) / n;
+  }
+  double sum = 0.0;
+  for (GDExtensionInt k = harmonics; k > 0; k--) {
+    sum += terms[k - 1];
+  }
+
+  thread_scratch_release(mark);
+  return 4 / M_PI * sum;
+}
+
+void
+my_custom_class__process_override(
+   GDExtensionClassInstancePtr p_instance,
+   const GDExtensionConstTypePtr *p_args,
+   GDExtensionTypePtr r_ret
+) {
+  my_custom_class_t *my_instance = p_instance;
+  my_instance->time_elapsed += *((double*)(p_args[0]));
+
+  double t = my_instance->time_elapsed;
+  double A = atomic_load_explicit(&my_instance->prop_state.amplitude, memory_order_relaxed);
+  double w = atomic_load_explicit(&my_instance->prop_state.frequency, memory_order_relaxed);
+  GDExtensionInt harmonics = atomic_load_explicit(&my_instance->prop_state.harmonics, memory_order_relaxed);
+
+  const GDVector2 new_position = {
+    .x = 0,
+    .y = A * square_wave(w * t, harmonics),
+  };
+
+  GDExtensionConstTypePtr args[] = { &new_position };
+
+  // Godot allows this from the node's own process thread
+  gd_extension.object_method_bind_ptrcall(gd_extension_helper.misc.node2d_set_position,
+                                          my_instance->godot_object,
+                                          args,
+                                          NULL);
+}
+
+GDExtensionClassCallVirtual
+my_custom_class_get_virtual(
+   void *p_class_userdata,
+   GDExtensionConstStringNamePtr p_name
+) {
+  if (string_name_eq(p_name, gd_extension_helper.string_name._process)) {
+    return my_custom_class__process_override;
+  }
+  return NULL;
+}
+
+// NOTE: We can only call this when Node has been loaded in ClassDB (during
+// GDEXTENSION_INITIALIZATION_SCENE)
+void register_my_custom_class() {
+  GDExtensionClassCreationInfo2 class_info = {
+    .is_virtual = false,
+    .is_abstract = false,
+    .is_exposed = true,
+    .set_func = my_custom_class_set_func,
+    .get_func = my_custom_class_get_func,
+    .get_property_list_func = my_custom_class_get_property_list,
+    .free_property_list_func = my_custom_class_free_property_list,
+    .property_can_revert_func = NULL,
+    .property_get_revert_func = NULL,
+    .validate_property_func = NULL,
+    .notification_func = NULL,
+    .to_string_func = NULL,
+    .reference_func = NULL,
+    .unreference_func = NULL,
+    .create_instance_func = my_custom_class_init,
+    .free_instance_func = my_custom_class_deinit,
+    .recreate_instance_func = NULL,
+    .get_virtual_func = my_custom_class_get_virtual,
+    .get_virtual_call_data_func = NULL,
+    .call_virtual_with_data_func = NULL,
+    .get_rid_func = NULL,
+    .class_userdata = NULL,
+  };
+
+  gd_extension.classdb_register_extension_class2(gd_extension_helper.misc.p_library,
+                                                 gd_extension_helper.string_name.my_custom_class,
+                                                 gd_extension_helper.string_name.my_custom_class_parent,
+                                                 &class_info);
+}
+
+void godot_initialize(void *userdata, GDExtensionInitializationLevel p_level) {
+  if (p_level == GDEXTENSION_INITIALIZATION_SCENE) {
+    gd_extension_helper.string_name.amplitude = construct_string_name("amplitude");
+    gd_extension_helper.string_name.frequency = construct_string_name("frequency");
+    gd_extension_helper.string_name.harmonics = construct_string_name("harmonics");
+    gd_extension_helper.string_name._process = construct_string_name("_process");
+    gd_extension_helper.string_name.my_custom_class = construct_string_name(MY_CUSTOM_CLASS_NAME);
+    gd_extension_helper.string_name.my_custom_class_parent = construct_string_name(MY_CUSTOM_CLASS_PARENT);
+
+    void *node2d_string_name = construct_string_name("Node2D");
+    void *set_position_string_name = construct_string_name("set_position");
+
+    gd_extension_helper.misc.node2d_set_position
+      = gd_extension.classdb_get_method_bind(node2d_string_name,
+                                             set_position_string_name,
+                                             743155724);
+
+    destruct_string_name(node2d_string_name);
+    destruct_string_name(set_position_string_name);
+
+    mem_pool_init(&node_pool, &node_tag, sizeof(my_custom_class_t));
+    register_my_custom_class();
+    return;
+  }
+}
+
+void godot_deinitialize(void *userdata, GDExtensionInitializationLevel p_level) {
+  if (p_level == GDEXTENSION_INITIALIZATION_SCENE) {
+    if (atomic_load(&live_instances) != 0) {
+      fprintf(stderr, "%d MyCustomNode instances are still alive\n", atomic_load(&live_instances));
+    }
+
+    destruct_string_name(gd_extension_helper.string_name.amplitude);
+    destruct_string_name(gd_extension_helper.string_name.frequency);
+    destruct_string_name(gd_extension_helper.string_name.harmonics);
+    destruct_string_name(gd_extension_helper.string_name._process);
+    destruct_string_name(gd_extension_helper.string_name.my_custom_class);
+    destruct_string_name(gd_extension_helper.string_name.my_custom_class_parent);
+
+    // No node runs anymore, on any thread
+    thread_scratch_destroy();
+    mem_pool_destroy(&node_pool);
+    mem_tag_report(stdout);
+  }
+}
+
+GDExtensionBool
+godot_entry(
+  GDExtensionInterfaceGetProcAddress p_get_proc_address,
+  const GDExtensionClassLibraryPtr p_library,
+  GDExtensionInitialization *r_initialization
+) {
+  r_initialization->minimum_initialization_level = GDEXTENSION_INITIALIZATION_SCENE;
+  r_initialization->userdata = NULL;
+  r_initialization->initialize = godot_initialize;
+  r_initialization->deinitialize = godot_deinitialize;
+
+  STORE_GD_EXTENSION(classdb_construct_object);
+  STORE_GD_EXTENSION(classdb_register_extension_class2);
+  STORE_GD_EXTENSION(classdb_get_method_bind);
+  STORE_GD_EXTENSION(string_name_new_with_utf8_chars);
+  STORE_GD_EXTENSION(string_new_with_utf8_chars);
+  STORE_GD_EXTENSION(object_set_instance);
+  STORE_GD_EXTENSION(variant_get_ptr_destructor);
+  STORE_GD_EXTENSION(get_variant_from_type_constructor);
+  STORE_GD_EXTENSION(variant_get_ptr_operator_evaluator);
+  STORE_GD_EXTENSION(object_method_bind_ptrcall);
+
+  gd_extension_helper.wrap.type_double
+    = gd_extension.get_variant_from_type_constructor(GDEXTENSION_VARIANT_TYPE_FLOAT);
+  gd_extension_helper.wrap.type_int
+    = gd_extension.get_variant_from_type_constructor(GDEXTENSION_VARIANT_TYPE_INT);
+
+  gd_extension_helper.misc.p_library = p_library;
+  gd_extension_helper.misc.string_name_eq_op
+    = gd_extension.variant_get_ptr_operator_evaluator(GDEXTENSION_VARIANT_OP_EQUAL,
+                                                      GDEXTENSION_VARIANT_TYPE_STRING_NAME,
+                                                      GDEXTENSION_VARIANT_TYPE_STRING_NAME);
+
+  gd_extension_helper.destructor.string_name
+    = gd_extension.variant_get_ptr_destructor(GDEXTENSION_VARIANT_TYPE_STRING_NAME);
+  gd_extension_helper.destructor.string
+    = gd_extension.variant_get_ptr_destructor(GDEXTENSION_VARIANT_TYPE_STRING);
+
+  variant_unwrap_init(p_get_proc_address);
+  mem_tag_init(p_get_proc_address);
+
+  return true;
+}
@@ -0,0 +1,484 @@
+#include "../godot-headers/gdextension_interface.h"
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define STORE_GD_EXTENSION(str_name) gd_extension.str_name = (void *)p_get_proc_address(#str_name);
+#define IS_GODOT_64_BIT (true)
+#define IS_GODOT_USING_LARGE_WORLD_COORDINATES (false)
+#define VARIANT_SIZE (IS_GODOT_USING_LARGE_WORLD_COORDINATES ? 40 : 24)
+#define CALLABLE_SIZE (16)
+#define MY_EMITTER_CLASS_NAME ("MySignalEmitter")
+#define MY_EMITTER_CLASS_PARENT ("Object")
+#define MY_EMITTER_SIGNAL_NAME ("pinged")
+#define BENCHMARK_EMIT_COUNT (100000)
+
+#include "../util/variant_unwrap.h"
+
+struct {
+  GDExtensionInterfaceClassdbConstructObject classdb_construct_object;
+  GDExtensionInterfaceClassdbRegisterExtensionClass2 classdb_register_extension_class2;
+  GDExtensionInterfaceClassdbRegisterExtensionClassSignal classdb_register_extension_class_signal;
+  GDExtensionInterfaceClassdbGetMethodBind classdb_get_method_bind;
+  GDExtensionInterfaceStringNameNewWithUtf8Chars string_name_new_with_utf8_chars;
+  GDExtensionInterfaceStringNewWithUtf8Chars string_new_with_utf8_chars;
+  GDExtensionInterfaceObjectSetInstance object_set_instance;
+  GDExtensionInterfaceObjectDestroy object_destroy;
+  GDExtensionInterfaceVariantGetPtrDestructor variant_get_ptr_destructor;
+  GDExtensionInterfaceGetVariantFromTypeConstructor get_variant_from_type_constructor;
+  GDExtensionInterfaceGetVariantToTypeConstructor get_variant_to_type_constructor;
+  GDExtensionInterfaceVariantGetType variant_get_type;
+  GDExtensionInterfaceVariantDestroy variant_destroy;
+  GDExtensionInterfaceObjectMethodBindPtrcall object_method_bind_ptrcall;
+  GDExtensionInterfaceObjectMethodBindCall object_method_bind_call;
+  GDExtensionInterfaceCallableCustomCreate callable_custom_create;
+  GDExtensionInterfaceCallableCustomGetUserData callable_custom_get_userdata;
+} gd_extension;
+
+struct {
+  struct {
+    GDExtensionPtrDestructor string_name;
+    GDExtensionPtrDestructor string;
+    GDExtensionPtrDestructor callable;
+  } destructor;
+  struct {
+    GDExtensionVariantFromTypeConstructorFunc type_double;
+    GDExtensionVariantFromTypeConstructorFunc string_name;
+  } wrap;
+  struct {
+    GDExtensionMethodBindPtr object_connect;
+    GDExtensionMethodBindPtr object_disconnect;
+    GDExtensionMethodBindPtr object_emit_signal;
+  } method_bind;
+  struct {
+    GDExtensionClassLibraryPtr p_library;
+  } misc;
+} gd_extension_helper;
+
+GDExtensionStringNamePtr construct_string_name(const char *c_string) {
+  void *res = malloc(IS_GODOT_64_BIT ? 8 : 4);
+  gd_extension.string_name_new_with_utf8_chars(res, c_string);
+  return res;
+}
+
+GDExtensionStringPtr construct_string(const char *c_string) {
+  void *res = malloc(IS_GODOT_64_BIT ? 8 : 4);
+  gd_extension.string_new_with_utf8_chars(res, c_string);
+  return res;
+}
+
+void destruct_string_name(GDExtensionStringNamePtr p) {
+  gd_extension_helper.destructor.string_name(p);
+}
+
+void destruct_string(GDExtensionStringPtr p) {
+  gd_extension_helper.destructor.string(p);
+}
+
+uint64_t now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// ---------------------------------------------------------------------------
+// Native callable layer
+// ---------------------------------------------------------------------------
+
+// A handler receives the Variant arguments exactly as Godot passes them to the
+// callable. Nothing is copied or unwrapped on our behalf.
+typedef void (*native_handler_t)(void *userdata,
+                                 const GDExtensionConstVariantPtr *p_args,
+                                 GDExtensionInt p_argument_count);
+
+typedef struct {
+  native_handler_t handler;
+  void *userdata;
+  // Godot asks for the hash every time the callable is looked up in a signal's
+  // connection map, so we compute it once instead of on every request.
+  uint32_t hash;
+} native_callable_t;
+
+uint32_t native_callable_compute_hash(native_handler_t handler, void *userdata) {
+  // splitmix64 finalizer over both pointers, folded down to 32 bits
+  uint64_t x = (uint64_t)(uintptr_t)handler ^ ((uint64_t)(uintptr_t)userdata * 0x9E3779B97F4A7C15ull);
+  x ^= x >> 30;
+  x *= 0xBF58476D1CE4E5B9ull;
+  x ^= x >> 27;
+  x *= 0x94D049BB133111EBull;
+  x ^= x >> 31;
+  return (uint32_t)(x ^ (x >> 32));
+}
+
+void
+native_callable_call(
+  void *callable_userdata,
+  const GDExtensionConstVariantPtr *p_args,
+  GDExtensionInt p_argument_count,
+  GDExtensionVariantPtr r_return,
+  GDExtensionCallError *r_error
+) {
+  native_callable_t *callable = callable_userdata;
+  callable->handler(callable->userdata, p_args, p_argument_count);
+  // NOTE: r_return already holds a Nil Variant, we leave it as is
+  r_error->error = GDEXTENSION_CALL_OK;
+}
+
+GDExtensionBool native_callable_is_valid(void *callable_userdata) {
+  return callable_userdata != NULL;
+}
+
+void native_callable_free(void *callable_userdata) {
+  free(callable_userdata);
+}
+
+uint32_t native_callable_hash(void *callable_userdata) {
+  return ((native_callable_t *)callable_userdata)->hash;
+}
+
+GDExtensionBool native_callable_equal(void *callable_userdata_a, void *callable_userdata_b) {
+  native_callable_t *a = callable_userdata_a;
+  native_callable_t *b = callable_userdata_b;
+  return a->hash == b->hash && a->handler == b->handler && a->userdata == b->userdata;
+}
+
+GDExtensionBool native_callable_less_than(void *callable_userdata_a, void *callable_userdata_b) {
+  native_callable_t *a = callable_userdata_a;
+  native_callable_t *b = callable_userdata_b;
+  if (a->handler != b->handler) {
+    return (uintptr_t)a->handler < (uintptr_t)b->handler;
+  }
+  return (uintptr_t)a->userdata < (uintptr_t)b->userdata;
+}
+
+// Writes a new Callable into `r_callable` (CALLABLE_SIZE bytes). `object_id` can
+// be 0 or the instance ID of the object the handler belongs to, in which case
+// Godot treats the callable as invalid once that object is freed.
+void
+native_callable_create(
+  GDExtensionUninitializedTypePtr r_callable,
+  native_handler_t handler,
+  void *userdata,
+  GDObjectInstanceID object_id
+) {
+  native_callable_t *callable = malloc(sizeof(native_callable_t));
+  callable->handler = handler;
+  callable->userdata = userdata;
+  callable->hash = native_callable_compute_hash(handler, userdata);
+
+  GDExtensionCallableCustomInfo info = {
+    .callable_userdata = callable,
+    // NOTE: The token tells Godot which extension the callable belongs to, the
+    // library pointer is the conventional choice.
+    .token = gd_extension_helper.misc.p_library,
+    .object_id = object_id,
+    .call_func = native_callable_call,
+    .is_valid_func = native_callable_is_valid,
+    .free_func = native_callable_free,
+    .hash_func = native_callable_hash,
+    .equal_func = native_callable_equal,
+    .less_than_func = native_callable_less_than,
+    .to_string_func = NULL,
+  };
+
+  gd_extension.callable_custom_create(r_callable, &info);
+}
+
+// Returns NULL if `p_callable` was not created by `native_callable_create`.
+native_callable_t *native_callable_get(GDExtensionConstTypePtr p_callable) {
+  return gd_extension.callable_custom_get_userdata(p_callable, gd_extension_helper.misc.p_library);
+}
+
+void native_callable_destroy(GDExtensionTypePtr p_callable) {
+  gd_extension_helper.destructor.callable(p_callable);
+}
+
+// ---------------------------------------------------------------------------
+// Signal emitter class
+// ---------------------------------------------------------------------------
+
+typedef struct {
+  GDExtensionObjectPtr godot_object;
+} my_emitter_t;
+
+GDExtensionObjectPtr my_emitter_init(void *userdata) {
+  my_emitter_t *my_instance = malloc(sizeof(my_emitter_t));
+
+  void *my_class_string_name = construct_string_name(MY_EMITTER_CLASS_NAME);
+  void *parent_class_string_name = construct_string_name(MY_EMITTER_CLASS_PARENT);
+
+  my_instance->godot_object = gd_extension.classdb_construct_object(parent_class_string_name);
+  gd_extension.object_set_instance(my_instance->godot_object, my_class_string_name, my_instance);
+
+  destruct_string_name(my_class_string_name);
+  destruct_string_name(parent_class_string_name);
+
+  return my_instance->godot_object;
+}
+
+void my_emitter_deinit(void *userdata, GDExtensionClassInstancePtr p_instance) {
+  if (p_instance == NULL) return;
+  free(p_instance);
+}
+
+void register_my_emitter_class() {
+  GDExtensionClassCreationInfo2 class_info = {
+    .is_virtual = false,
+    .is_abstract = false,
+    .is_exposed = true,
+    .set_func = NULL,
+    .get_func = NULL,
+    .get_property_list_func = NULL,
+    .free_property_list_func = NULL,
+    .property_can_revert_func = NULL,
+    .property_get_revert_func = NULL,
+    .validate_property_func = NULL,
+    .notification_func = NULL,
+    .to_string_func = NULL,
+    .reference_func = NULL,
+    .unreference_func = NULL,
+    .create_instance_func = my_emitter_init,
+    .free_instance_func = my_emitter_deinit,
+    .recreate_instance_func = NULL,
+    .get_virtual_func = NULL,
+    .get_virtual_call_data_func = NULL,
+    .call_virtual_with_data_func = NULL,
+    .get_rid_func = NULL,
+    .class_userdata = NULL,
+  };
+
+  void *my_class_string_name = construct_string_name(MY_EMITTER_CLASS_NAME);
+  void *parent_class_string_name = construct_string_name(MY_EMITTER_CLASS_PARENT);
+  void *signal_string_name = construct_string_name(MY_EMITTER_SIGNAL_NAME);
+
+  gd_extension.classdb_register_extension_class2(gd_extension_helper.misc.p_library,
+                                                 my_class_string_name,
+                                                 parent_class_string_name,
+                                                 &class_info);
+
+  GDExtensionPropertyInfo signal_args[] = {
+    {
+      .type = GDEXTENSION_VARIANT_TYPE_FLOAT,
+      .name = construct_string_name("value"),
+      .class_name = construct_string_name(""),
+      .hint = 0, // Corresponds to no hints
+      .hint_string = construct_string(""),
+      .usage = 6, // Corresponds to default usage flags
+    },
+  };
+
+  gd_extension.classdb_register_extension_class_signal(gd_extension_helper.misc.p_library,
+                                                       my_class_string_name,
+                                                       signal_string_name,
+                                                       signal_args,
+                                                       1);
+
+  destruct_string_name(signal_args[0].name);
+  destruct_string_name(signal_args[0].class_name);
+  destruct_string(signal_args[0].hint_string);
+  destruct_string_name(my_class_string_name);
+  destruct_string_name(parent_class_string_name);
+  destruct_string_name(signal_string_name);
+}
+
+// ---------------------------------------------------------------------------
+// Demo + benchmark
+// ---------------------------------------------------------------------------
+
+typedef struct {
+  uint64_t call_count;
+  double value_sum;
+} pinged_handler_state_t;
+
+void
+on_pinged(
+  void *userdata,
+  const GDExtensionConstVariantPtr *p_args,
+  GDExtensionInt p_argument_count
+) {
+  pinged_handler_state_t *state = userdata;
+  state->call_count++;
+
+  double value;
+  if (p_argument_count == 1 && variant_unwrap_float(p_args[0], &value)) {
+    state->value_sum += value;
+  }
+}
+
+GDExtensionInt object_connect(GDExtensionObjectPtr object,
+                              GDExtensionConstStringNamePtr signal,
+                              GDExtensionConstTypePtr callable) {
+  int64_t flags = 0;
+  GDExtensionInt res;
+  GDExtensionConstTypePtr args[] = { signal, callable, &flags };
+  gd_extension.object_method_bind_ptrcall(gd_extension_helper.method_bind.object_connect,
+                                          object,
+                                          args,
+                                          &res);
+  return res;
+}
+
+void object_disconnect(GDExtensionObjectPtr object,
+                       GDExtensionConstStringNamePtr signal,
+                       GDExtensionConstTypePtr callable) {
+  GDExtensionConstTypePtr args[] = { signal, callable };
+  gd_extension.object_method_bind_ptrcall(gd_extension_helper.method_bind.object_disconnect,
+                                          object,
+                                          args,
+                                          NULL);
+}
+
+void do_work() {
+  void *emitter_class_string_name = construct_string_name(MY_EMITTER_CLASS_NAME);
+  void *signal_string_name = construct_string_name(MY_EMITTER_SIGNAL_NAME);
+
+  GDExtensionObjectPtr emitter = gd_extension.classdb_construct_object(emitter_class_string_name);
+
+  pinged_handler_state_t state = { .call_count = 0, .value_sum = 0.0 };
+
+  unsigned char callable[CALLABLE_SIZE];
+  native_callable_create(&callable, on_pinged, &state, 0);
+
+  printf("Callable was created by us: %s\n", native_callable_get(&callable) != NULL ? "yes" : "no");
+
+  GDExtensionInt err = object_connect(emitter, signal_string_name, &callable);
+  if (err != 0) {
+    fprintf(stderr, "connect failed with error %ld\n", (long)err);
+  }
+
+  // emit_signal is vararg, so we have to go through the Variant call path
+  unsigned char signal_variant[VARIANT_SIZE];
+  unsigned char value_variant[VARIANT_SIZE];
+  unsigned char return_variant[VARIANT_SIZE];
+  double value = 0.5;
+
+  gd_extension_helper.wrap.string_name(&signal_variant, signal_string_name);
+  gd_extension_helper.wrap.type_double(&value_variant, &value);
+
+  const GDExtensionConstVariantPtr emit_args[] = { &signal_variant, &value_variant };
+  GDExtensionCallError call_error;
+
+  // A failed emit returns right away, so stop at the first one instead of
+  // timing it as a fast success
+  call_error.error = GDEXTENSION_CALL_OK;
+  int emit_count = 0;
+  uint64_t start = now_ns();
+  while (emit_count < BENCHMARK_EMIT_COUNT && call_error.error == GDEXTENSION_CALL_OK) {
+    gd_extension.object_method_bind_call(gd_extension_helper.method_bind.object_emit_signal,
+                                         emitter,
+                                         emit_args,
+                                         2,
+                                         &return_variant,
+                                         &call_error);
+    gd_extension.variant_destroy(&return_variant);
+    emit_count++;
+  }
+  uint64_t elapsed = now_ns() - start;
+
+  if (call_error.error != GDEXTENSION_CALL_OK) {
+    fprintf(stderr, "emit_signal failed with call error %d after %d emits, benchmark aborted\n",
+            (int)call_error.error,
+            emit_count - 1);
+  } else {
+    printf("emit_signal -> native handler: %d emits in %.3f ms (%.1f ns/emit)\n",
+           BENCHMARK_EMIT_COUNT,
+           elapsed / 1e6,
+           (double)elapsed / BENCHMARK_EMIT_COUNT);
+    printf("handler saw %lu calls, value sum %f\n",
+           (unsigned long)state.call_count,
+           state.value_sum);
+  }
+
+  // Disconnecting with a freshly made callable works because equality and hash
+  // only look at the handler + userdata pair.
+  unsigned char same_callable[CALLABLE_SIZE];
+  native_callable_create(&same_callable, on_pinged, &state, 0);
+  object_disconnect(emitter, signal_string_name, &same_callable);
+
+  native_callable_destroy(&same_callable);
+  native_callable_destroy(&callable);
+  gd_extension.variant_destroy(&signal_variant);
+  gd_extension.variant_destroy(&value_variant);
+  gd_extension.object_destroy(emitter);
+  destruct_string_name(emitter_class_string_name);
+  destruct_string_name(signal_string_name);
+}
+
+void godot_initialize(void *userdata, GDExtensionInitializationLevel p_level) {
+  if (p_level == GDEXTENSION_INITIALIZATION_SCENE) {
+    void *object_string_name = construct_string_name("Object");
+    void *connect_string_name = construct_string_name("connect");
+    void *disconnect_string_name = construct_string_name("disconnect");
+    void *emit_signal_string_name = construct_string_name("emit_signal");
+
+    gd_extension_helper.method_bind.object_connect
+      = gd_extension.classdb_get_method_bind(object_string_name, connect_string_name, 1518146889);
+    gd_extension_helper.method_bind.object_disconnect
+      = gd_extension.classdb_get_method_bind(object_string_name, disconnect_string_name, 1874754934);
+    gd_extension_helper.method_bind.object_emit_signal
+      = gd_extension.classdb_get_method_bind(object_string_name, emit_signal_string_name, 4047867050);
+
+    destruct_string_name(object_string_name);
+    destruct_string_name(connect_string_name);
+    destruct_string_name(disconnect_string_name);
+    destruct_string_name(emit_signal_string_name);
+
+    register_my_emitter_class();
+    do_work();
+    return;
+  }
+}
+
+void godot_deinitialize(void *userdata, GDExtensionInitializationLevel p_level) {
+  return;
+}
+
+GDExtensionBool
+godot_entry(
+  GDExtensionInterfaceGetProcAddress p_get_proc_address,
+  const GDExtensionClassLibraryPtr p_library,
+  GDExtensionInitialization *r_initialization
+) {
+  r_initialization->minimum_initialization_level = GDEXTENSION_INITIALIZATION_SCENE;
+  r_initialization->userdata = NULL;
+  r_initialization->initialize = godot_initialize;
+  r_initialization->deinitialize = godot_deinitialize;
+
+  STORE_GD_EXTENSION(classdb_construct_object);
+  STORE_GD_EXTENSION(classdb_register_extension_class2);
+  STORE_GD_EXTENSION(classdb_register_extension_class_signal);
+  STORE_GD_EXTENSION(classdb_get_method_bind);
+  STORE_GD_EXTENSION(string_name_new_with_utf8_chars);
+  STORE_GD_EXTENSION(string_new_with_utf8_chars);
+  STORE_GD_EXTENSION(object_set_instance);
+  STORE_GD_EXTENSION(object_destroy);
+  STORE_GD_EXTENSION(variant_get_ptr_destructor);
+  STORE_GD_EXTENSION(get_variant_from_type_constructor);
+  STORE_GD_EXTENSION(get_variant_to_type_constructor);
+  STORE_GD_EXTENSION(variant_get_type);
+  STORE_GD_EXTENSION(variant_destroy);
+  STORE_GD_EXTENSION(object_method_bind_ptrcall);
+  STORE_GD_EXTENSION(object_method_bind_call);
+  STORE_GD_EXTENSION(callable_custom_create);
+  STORE_GD_EXTENSION(callable_custom_get_userdata);
+
+  gd_extension_helper.misc.p_library = p_library;
+
+  gd_extension_helper.wrap.type_double
+    = gd_extension.get_variant_from_type_constructor(GDEXTENSION_VARIANT_TYPE_FLOAT);
+  gd_extension_helper.wrap.string_name
+    = gd_extension.get_variant_from_type_constructor(GDEXTENSION_VARIANT_TYPE_STRING_NAME);
+
+  gd_extension_helper.destructor.string_name
+    = gd_extension.variant_get_ptr_destructor(GDEXTENSION_VARIANT_TYPE_STRING_NAME);
+  gd_extension_helper.destructor.string
+    = gd_extension.variant_get_ptr_destructor(GDEXTENSION_VARIANT_TYPE_STRING);
+  gd_extension_helper.destructor.callable
+    = gd_extension.variant_get_ptr_destructor(GDEXTENSION_VARIANT_TYPE_CALLABLE);
+
+  variant_unwrap_init(p_get_proc_address);
+
+  return true;
+}
@@ -0,0 +1,287 @@
+#include "../godot-headers/gdextension_interface.h"
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <time.h>
+
+#define STORE_GD_EXTENSION(str_name) gd_extension.str_name = (void *)p_get_proc_address(#str_name);
+#define IS_GODOT_64_BIT (true)
+#define TRACKED_NODE_CLASS_NAME ("TrackedNode")
+#define TRACKED_NODE_CLASS_PARENT ("Node2D")
+#define NODE_COUNT (10000)
+#define WORKER_COUNT (4)
+#define WORKER_ROUNDS (100)
+
+#include "../util/object_handle.h"
+
+struct {
+  GDExtensionInterfaceStringNameNewWithUtf8Chars string_name_new_with_utf8_chars;
+  GDExtensionInterfaceVariantGetPtrDestructor variant_get_ptr_destructor;
+  GDExtensionInterfaceClassdbConstructObject classdb_construct_object;
+  GDExtensionInterfaceClassdbRegisterExtensionClass2 classdb_register_extension_class2;
+  GDExtensionInterfaceObjectSetInstance object_set_instance;
+  GDExtensionInterfaceObjectDestroy object_destroy;
+  GDExtensionInterfaceObjectGetInstanceId object_get_instance_id;
+  GDExtensionInterfaceObjectGetInstanceFromId object_get_instance_from_id;
+} gd_extension;
+
+struct {
+  struct {
+    GDExtensionPtrDestructor string_name;
+  } destructor;
+  struct {
+    GDExtensionClassLibraryPtr p_library;
+  } misc;
+} gd_extension_helper;
+
+// The native side of a TrackedNode, what its handles resolve to
+typedef struct {
+  GDExtensionObjectPtr godot_object;
+  object_handle_t handle;
+} tracked_node_t;
+
+typedef struct {
+  const object_handle_t *handles;
+  int64_t resolved;
+} worker_t;
+
+GDExtensionStringNamePtr construct_string_name(const char *c_string) {
+  void *res = malloc(IS_GODOT_64_BIT ? 8 : 4);
+  gd_extension.string_name_new_with_utf8_chars(res, c_string);
+  return res;
+}
+
+void destruct_string_name(GDExtensionStringNamePtr p) {
+  gd_extension_helper.destructor.string_name(p);
+  free(p);
+}
+
+uint64_t now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+GDExtensionObjectPtr tracked_node_init(void *userdata) {
+  tracked_node_t *my_instance = malloc(sizeof(tracked_node_t));
+
+  void *my_class_string_name = construct_string_name(TRACKED_NODE_CLASS_NAME);
+  void *parent_class_string_name = construct_string_name(TRACKED_NODE_CLASS_PARENT);
+
+  my_instance->godot_object = gd_extension.classdb_construct_object(parent_class_string_name);
+  gd_extension.object_set_instance(my_instance->godot_object, my_class_string_name, my_instance);
+  my_instance->handle = object_handle_bind(my_instance->godot_object, my_instance);
+
+  destruct_string_name(my_class_string_name);
+  destruct_string_name(parent_class_string_name);
+
+  return my_instance->godot_object;
+}
+
+void tracked_node_deinit(void *userdata, GDExtensionClassInstancePtr p_instance) {
+  if (p_instance == NULL) return;
+
+  tracked_node_t *my_instance = p_instance;
+  // Godot calls this before the binding's free callback, so until then a
+  // lookup on a worker would still hand out the struct we're about to free
+  object_handle_release(my_instance->handle);
+  free(my_instance);
+}
+
+void register_tracked_node_class() {
+  GDExtensionClassCreationInfo2 class_info = {
+    .is_virtual = false,
+    .is_abstract = false,
+    .is_exposed = true,
+    .set_func = NULL,
+    .get_func = NULL,
+    .get_property_list_func = NULL,
+    .free_property_list_func = NULL,
+    .property_can_revert_func = NULL,
+    .property_get_revert_func = NULL,
+    .validate_property_func = NULL,
+    .notification_func = NULL,
+    .to_string_func = NULL,
+    .reference_func = NULL,
+    .unreference_func = NULL,
+    .create_instance_func = tracked_node_init,
+    .free_instance_func = tracked_node_deinit,
+    .recreate_instance_func = NULL,
+    .get_virtual_func = NULL,
+    .get_virtual_call_data_func = NULL,
+    .call_virtual_with_data_func = NULL,
+    .get_rid_func = NULL,
+    .class_userdata = NULL,
+  };
+
+  void *my_class_string_name = construct_string_name(TRACKED_NODE_CLASS_NAME);
+  void *parent_class_string_name = construct_string_name(TRACKED_NODE_CLASS_PARENT);
+
+  gd_extension.classdb_register_extension_class2(gd_extension_helper.misc.p_library,
+                                                 my_class_string_name,
+                                                 parent_class_string_name,
+                                                 &class_info);
+
+  destruct_string_name(my_class_string_name);
+  destruct_string_name(parent_class_string_name);
+}
+
+// Makes a TrackedNode the way GDScript's `TrackedNode.new()` would and
+// returns its handle. `tracked_node_init` already bound it, binding again
+// only hands back the existing handle.
+object_handle_t tracked_node_new(GDExtensionConstStringNamePtr class_name) {
+  GDExtensionObjectPtr object = gd_extension.classdb_construct_object(class_name);
+  return object_handle_bind(object, NULL);
+}
+
+int count_valid(const object_handle_t *handles, int count) {
+  int res = 0;
+  for (int i = 0; i < count; i++) {
+    if (object_handle_is_valid(handles[i])) res++;
+  }
+  return res;
+}
+
+// A job on a worker thread: nothing here calls into Godot
+void *resolve_handles(void *userdata) {
+  worker_t *worker = userdata;
+  for (int round = 0; round < WORKER_ROUNDS; round++) {
+    for (int i = 0; i < NODE_COUNT; i++) {
+      if (object_handle_get(worker->handles[i]) != NULL) worker->resolved++;
+    }
+  }
+  return NULL;
+}
+
+void print_lookup_benchmark(const object_handle_t *handles, const GDObjectInstanceID *ids) {
+  uintptr_t checksum = 0;
+  uint64_t start = now_ns();
+  for (int i = 0; i < NODE_COUNT; i++) {
+    checksum += (uintptr_t)gd_extension.object_get_instance_from_id(ids[i]);
+  }
+  uint64_t from_id_ns = now_ns() - start;
+
+  // The handle goes straight to our struct, the ID only to the object
+  start = now_ns();
+  for (int i = 0; i < NODE_COUNT; i++) {
+    tracked_node_t *my_instance = object_handle_get(handles[i]);
+    checksum -= (uintptr_t)my_instance->godot_object;
+  }
+  uint64_t handle_ns = now_ns() - start;
+
+  printf("lookup: object_get_instance_from_id %.1f ns, object_handle_get %.1f ns (%s)\n",
+         (double)from_id_ns / NODE_COUNT,
+         (double)handle_ns / NODE_COUNT,
+         checksum == 0 ? "same objects" : "DIFFERENT objects");
+}
+
+void print_worker_lookups(const object_handle_t *handles) {
+  pthread_t threads[WORKER_COUNT];
+  worker_t workers[WORKER_COUNT];
+  uint64_t start = now_ns();
+  for (int i = 0; i < WORKER_COUNT; i++) {
+    workers[i] = (worker_t){ .handles = handles, .resolved = 0 };
+    pthread_create(&threads[i], NULL, resolve_handles, &workers[i]);
+  }
+  int64_t resolved = 0;
+  for (int i = 0; i < WORKER_COUNT; i++) {
+    pthread_join(threads[i], NULL);
+    resolved += workers[i].resolved;
+  }
+  printf("%d workers resolved %ld handles in %.1f ms\n",
+         WORKER_COUNT, (long)resolved, (now_ns() - start) / 1000000.0);
+}
+
+void run_object_handles_example() {
+  GDExtensionStringNamePtr class_name = construct_string_name(TRACKED_NODE_CLASS_NAME);
+  GDExtensionObjectPtr *nodes = malloc(NODE_COUNT * sizeof(GDExtensionObjectPtr));
+  object_handle_t *handles = malloc(NODE_COUNT * sizeof(object_handle_t));
+  GDObjectInstanceID *ids = malloc(NODE_COUNT * sizeof(GDObjectInstanceID));
+
+  for (int i = 0; i < NODE_COUNT; i++) {
+    handles[i] = tracked_node_new(class_name);
+    tracked_node_t *my_instance = object_handle_get(handles[i]);
+    nodes[i] = my_instance->godot_object;
+    ids[i] = gd_extension.object_get_instance_id(nodes[i]);
+  }
+
+  print_lookup_benchmark(handles, ids);
+  print_worker_lookups(handles);
+
+  // `tracked_node_deinit` releases the handles before the structs are freed,
+  // nobody else has to
+  for (int i = 0; i < NODE_COUNT; i += 2) {
+    gd_extension.object_destroy(nodes[i]);
+    nodes[i] = NULL;
+  }
+  printf("after freeing half: %d/%d handles valid, %u live slots\n",
+         count_valid(handles, NODE_COUNT), NODE_COUNT, object_handle_live_count());
+
+  // New nodes get the freed slots, and their structs quite likely the freed
+  // memory. Old handles to those slots must not resolve to the new structs.
+  object_handle_t *reused = malloc(NODE_COUNT / 2 * sizeof(object_handle_t));
+  for (int i = 0; i < NODE_COUNT; i += 2) {
+    reused[i / 2] = tracked_node_new(class_name);
+    tracked_node_t *my_instance = object_handle_get(reused[i / 2]);
+    nodes[i] = my_instance->godot_object;
+  }
+  printf("after reusing the slots: %d/%d old handles valid, %d/%d new ones\n",
+         count_valid(handles, NODE_COUNT), NODE_COUNT,
+         count_valid(reused, NODE_COUNT / 2), NODE_COUNT / 2);
+
+  for (int i = 0; i < NODE_COUNT; i++) {
+    gd_extension.object_destroy(nodes[i]);
+  }
+  printf("after freeing everything: %u live slots\n", object_handle_live_count());
+
+  free(reused);
+  free(ids);
+  free(handles);
+  free(nodes);
+  destruct_string_name(class_name);
+}
+
+void godot_initialize(void *userdata, GDExtensionInitializationLevel p_level) {
+  if (p_level == GDEXTENSION_INITIALIZATION_SCENE) {
+    register_tracked_node_class();
+    run_object_handles_example();
+    return;
+  }
+}
+
+void godot_deinitialize(void *userdata, GDExtensionInitializationLevel p_level) {
+  if (p_level == GDEXTENSION_INITIALIZATION_SCENE) {
+    object_handle_deinit();
+  }
+}
+
+GDExtensionBool
+godot_entry(
+  GDExtensionInterfaceGetProcAddress p_get_proc_address,
+  const GDExtensionClassLibraryPtr p_library,
+  GDExtensionInitialization *r_initialization
+) {
+  r_initialization->minimum_initialization_level = GDEXTENSION_INITIALIZATION_SCENE;
+  r_initialization->userdata = NULL;
+  r_initialization->initialize = godot_initialize;
+  r_initialization->deinitialize = godot_deinitialize;
+
+  STORE_GD_EXTENSION(string_name_new_with_utf8_chars);
+  STORE_GD_EXTENSION(variant_get_ptr_destructor);
+  STORE_GD_EXTENSION(classdb_construct_object);
+  STORE_GD_EXTENSION(classdb_register_extension_class2);
+  STORE_GD_EXTENSION(object_set_instance);
+  STORE_GD_EXTENSION(object_destroy);
+  STORE_GD_EXTENSION(object_get_instance_id);
+  STORE_GD_EXTENSION(object_get_instance_from_id);
+
+  gd_extension_helper.destructor.string_name
+    = gd_extension.variant_get_ptr_destructor(GDEXTENSION_VARIANT_TYPE_STRING_NAME);
+  gd_extension_helper.misc.p_library = p_library;
+
+  object_handle_init(p_get_proc_address);
+
+  return true;
+}
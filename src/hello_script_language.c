@@ -0,0 +1,2527 @@
+#include "../godot-headers/gdextension_interface.h"
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#define STORE_GD_EXTENSION(str_name) gd_extension.str_name = (void *)p_get_proc_address(#str_name);
+#define IS_GODOT_64_BIT (true)
+#define IS_GODOT_USING_LARGE_WORLD_COORDINATES (false)
+#define VARIANT_SIZE (IS_GODOT_USING_LARGE_WORLD_COORDINATES ? 40 : 24)
+#define LANGUAGE_CLASS_NAME ("TinyScriptLanguage")
+#define LANGUAGE_CLASS_PARENT ("ScriptLanguageExtension")
+#define SCRIPT_CLASS_NAME ("TinyScript")
+#define SCRIPT_CLASS_PARENT ("ScriptExtension")
+#define TINY_LANGUAGE_NAME ("TinyScript")
+#define TINY_FILE_EXTENSION ("tiny")
+
+#define TINY_MAX_REGISTERS (250)
+#define TINY_MAX_CALL_DEPTH (64)
+#define TINY_MAX_NAME_LENGTH (64)
+#define TINY_CACHE_SIZE (4)
+#define TINY_ERROR_SIZE (256)
+#define TINY_BENCHMARK_ITERATIONS (1000000)
+
+// Values of Godot's `Error` enum
+#define GODOT_OK (0)
+#define GODOT_ERR_PARSE_ERROR (43)
+
+struct {
+  GDExtensionInterfaceClassdbConstructObject classdb_construct_object;
+  GDExtensionInterfaceClassdbRegisterExtensionClass2 classdb_register_extension_class2;
+  GDExtensionInterfaceClassdbGetMethodBind classdb_get_method_bind;
+  GDExtensionInterfaceClassdbGetClassTag classdb_get_class_tag;
+  GDExtensionInterfaceStringNameNewWithUtf8Chars string_name_new_with_utf8_chars;
+  GDExtensionInterfaceStringNewWithUtf8Chars string_new_with_utf8_chars;
+  GDExtensionInterfaceStringToUtf8Chars string_to_utf8_chars;
+  GDExtensionInterfaceObjectSetInstance object_set_instance;
+  GDExtensionInterfaceObjectDestroy object_destroy;
+  GDExtensionInterfaceObjectGetClassName object_get_class_name;
+  GDExtensionInterfaceObjectMethodBindPtrcall object_method_bind_ptrcall;
+  GDExtensionInterfaceGlobalGetSingleton global_get_singleton;
+  GDExtensionInterfaceScriptInstanceCreate2 script_instance_create2;
+  GDExtensionInterfaceVariantGetPtrDestructor variant_get_ptr_destructor;
+  GDExtensionInterfaceVariantGetPtrOperatorEvaluator variant_get_ptr_operator_evaluator;
+  GDExtensionInterfaceVariantGetPtrBuiltinMethod variant_get_ptr_builtin_method;
+  GDExtensionInterfaceGetVariantFromTypeConstructor get_variant_from_type_constructor;
+  GDExtensionInterfaceGetVariantToTypeConstructor get_variant_to_type_constructor;
+  GDExtensionInterfaceVariantGetType variant_get_type;
+  GDExtensionInterfaceVariantNewNil variant_new_nil;
+  GDExtensionInterfaceVariantDestroy variant_destroy;
+  GDExtensionInterfaceVariantCall variant_call;
+  GDExtensionInterfaceVariantEvaluate variant_evaluate;
+  GDExtensionInterfaceVariantGetNamed variant_get_named;
+  GDExtensionInterfaceVariantSetNamed variant_set_named;
+  GDExtensionInterfacePackedStringArrayOperatorIndex packed_string_array_operator_index;
+} gd_extension;
+
+struct {
+  struct {
+    GDExtensionPtrDestructor string_name;
+    GDExtensionPtrDestructor string;
+  } destructor;
+  struct {
+    GDExtensionVariantFromTypeConstructorFunc type_bool;
+    GDExtensionVariantFromTypeConstructorFunc type_int;
+    GDExtensionVariantFromTypeConstructorFunc type_double;
+    GDExtensionVariantFromTypeConstructorFunc type_vector2;
+    GDExtensionVariantFromTypeConstructorFunc type_object;
+    GDExtensionVariantFromTypeConstructorFunc type_string;
+  } wrap;
+  struct {
+    GDExtensionTypeFromVariantConstructorFunc type_bool;
+    GDExtensionTypeFromVariantConstructorFunc type_int;
+    GDExtensionTypeFromVariantConstructorFunc type_double;
+    GDExtensionTypeFromVariantConstructorFunc type_vector2;
+  } unwrap;
+  struct {
+    GDExtensionClassLibraryPtr p_library;
+    GDExtensionPtrOperatorEvaluator string_name_eq_op;
+    GDExtensionPtrBuiltInMethod packed_string_array_resize;
+    // The one TinyScriptLanguage instance, registered with the Engine
+    GDExtensionObjectPtr language;
+  } misc;
+} gd_extension_helper;
+
+#if (IS_GODOT_USING_LARGE_WORLD_COORDINATES)
+typedef struct {
+  double x;
+  double y;
+} GDVector2;
+#else
+typedef struct {
+  float x;
+  float y;
+} GDVector2;
+#endif
+
+GDExtensionStringNamePtr construct_string_name(const char *c_string) {
+  void *res = malloc(IS_GODOT_64_BIT ? 8 : 4);
+  gd_extension.string_name_new_with_utf8_chars(res, c_string);
+  return res;
+}
+
+GDExtensionStringPtr construct_string(const char *c_string) {
+  void *res = malloc(IS_GODOT_64_BIT ? 8 : 4);
+  gd_extension.string_new_with_utf8_chars(res, c_string);
+  return res;
+}
+
+void destruct_string_name(GDExtensionStringNamePtr p) {
+  gd_extension_helper.destructor.string_name(p);
+  free(p);
+}
+
+void destruct_string(GDExtensionStringPtr p) {
+  gd_extension_helper.destructor.string(p);
+  free(p);
+}
+
+bool string_name_eq(const void *a, const void *b) {
+  GDExtensionBool res;
+  gd_extension_helper.misc.string_name_eq_op(a, b, &res);
+  return res;
+}
+
+char *string_to_c_string(GDExtensionConstStringPtr p_string) {
+  GDExtensionInt length = gd_extension.string_to_utf8_chars(p_string, NULL, 0);
+  char *res = malloc(length + 1);
+  gd_extension.string_to_utf8_chars(p_string, res, length);
+  res[length] = '\0';
+  return res;
+}
+
+// Grows `*array` so that it can hold at least `count + 1` elements
+void *grow_array(void *array, uint32_t count, uint32_t *capacity, size_t element_size) {
+  if (count < *capacity) return array;
+  *capacity = *capacity > 0 ? *capacity * 2 : 8;
+  return realloc(array, *capacity * element_size);
+}
+
+// ---------------------------------------------------------------------------
+// Program
+// ---------------------------------------------------------------------------
+
+// Registers hold unboxed values. Variants only show up when a value crosses
+// into Godot and there's no ptrcall for it.
+typedef enum {
+  TINY_NIL,
+  TINY_BOOL,
+  TINY_INT,
+  TINY_FLOAT,
+  TINY_VECTOR2,
+} tiny_type_t;
+
+typedef struct {
+  tiny_type_t type;
+  union {
+    GDExtensionBool b;
+    int64_t i;
+    double f;
+    GDVector2 v;
+  };
+} tiny_value_t;
+
+typedef enum {
+  OP_LOADK,          // a = constants[k]
+  OP_MOVE,           // a = b
+  OP_GET_MEMBER,     // a = members[k]
+  OP_SET_MEMBER,     // members[k] = a
+  OP_ADD,            // a = b + c
+  OP_SUB,            // a = b - c
+  OP_MUL,            // a = b * c
+  OP_DIV,            // a = b / c
+  OP_MOD,            // a = b % c
+  OP_LT,             // a = b < c
+  OP_LE,             // a = b <= c
+  OP_EQ,             // a = b == c
+  OP_NE,             // a = b != c
+  OP_NEG,            // a = -b
+  OP_NOT,            // a = not b
+  OP_JUMP,           // pc = k
+  OP_JUMP_IF_FALSE,  // if not a: pc = k
+  OP_JUMP_IF_TRUE,   // if a: pc = k
+  OP_SIN,            // a = sin(b)
+  OP_COS,            // a = cos(b)
+  OP_SQRT,           // a = sqrt(b)
+  OP_VEC2,           // a = Vector2(b, c)
+  OP_GET_X,          // a = b.x
+  OP_GET_Y,          // a = b.y
+  OP_GET_PROPERTY,   // a = owner.<sites[k]>
+  OP_SET_PROPERTY,   // owner.<sites[k]> = a
+  OP_CALL_ENGINE,    // a = owner.<sites[k]>(b, ..., b + c - 1)
+  OP_CALL_SCRIPT,    // a = functions[k](b, ..., b + c - 1)
+  OP_RETURN,         // return a
+  OP_RETURN_NIL,     // return
+} tiny_opcode_t;
+
+typedef struct {
+  uint8_t op;
+  uint8_t a;
+  uint8_t b;
+  uint8_t c;
+  int32_t k;
+} tiny_instruction_t;
+
+// Engine methods with a signature we know, so they can be ptrcalled. Hashes
+// are from `extension_api.json`.
+typedef enum {
+  TINY_SIGNATURE_VOID,         // void f()
+  TINY_SIGNATURE_GET_FLOAT,    // float f()
+  TINY_SIGNATURE_SET_FLOAT,    // void f(float)
+  TINY_SIGNATURE_GET_VECTOR2,  // Vector2 f()
+  TINY_SIGNATURE_SET_VECTOR2,  // void f(Vector2)
+} tiny_signature_t;
+
+typedef struct {
+  const char *name;
+  GDExtensionInt hash;
+  tiny_signature_t signature;
+} tiny_known_method_t;
+
+const tiny_known_method_t tiny_known_methods[] = {
+  { "get_position", 3341600327, TINY_SIGNATURE_GET_VECTOR2 },
+  { "set_position", 743155724, TINY_SIGNATURE_SET_VECTOR2 },
+  { "get_scale", 3341600327, TINY_SIGNATURE_GET_VECTOR2 },
+  { "set_scale", 743155724, TINY_SIGNATURE_SET_VECTOR2 },
+  { "translate", 743155724, TINY_SIGNATURE_SET_VECTOR2 },
+  { "get_rotation", 1740695150, TINY_SIGNATURE_GET_FLOAT },
+  { "set_rotation", 373806689, TINY_SIGNATURE_SET_FLOAT },
+  { "rotate", 373806689, TINY_SIGNATURE_SET_FLOAT },
+  { "queue_free", 3218959716, TINY_SIGNATURE_VOID },
+};
+
+const tiny_known_method_t *tiny_find_known_method(const char *name) {
+  size_t n = sizeof(tiny_known_methods) / sizeof(*tiny_known_methods);
+  for (size_t i = 0; i < n; i++) {
+    if (strcmp(tiny_known_methods[i].name, name) == 0) return &tiny_known_methods[i];
+  }
+  return NULL;
+}
+
+typedef enum {
+  TINY_SITE_GET,
+  TINY_SITE_SET,
+  TINY_SITE_CALL,
+} tiny_site_kind_t;
+
+// One entry of a polymorphic inline cache: the method bind for the owner's
+// class. `bind` is NULL when the class doesn't have the known method, then
+// the site goes through the Variant fallback.
+typedef struct {
+  void *class_tag;
+  GDExtensionMethodBindPtr bind;
+} tiny_cache_entry_t;
+
+// A place in the code that touches the engine (property get/set or method
+// call on the owner)
+typedef struct {
+  tiny_site_kind_t kind;
+  // Property or method name as written, for the Variant fallback
+  GDExtensionStringNamePtr name;
+  // NULL if we don't know a ptrcall signature for it
+  const tiny_known_method_t *known;
+  GDExtensionStringNamePtr known_name;
+  uint32_t cache_count;
+  tiny_cache_entry_t cache[TINY_CACHE_SIZE];
+} tiny_site_t;
+
+typedef struct {
+  char *name;
+  GDExtensionStringNamePtr string_name;
+  uint32_t arg_count;
+  uint32_t register_count;
+  tiny_instruction_t *code;
+  uint32_t code_count;
+  uint32_t code_capacity;
+} tiny_function_t;
+
+typedef struct {
+  char *name;
+  GDExtensionStringNamePtr string_name;
+  tiny_value_t initial;
+} tiny_member_t;
+
+// Compiled script, shared by the script and all of its instances. A reload
+// makes a new program, instances keep the one they were made with.
+typedef struct {
+  uint32_t refcount;
+  char base_type[TINY_MAX_NAME_LENGTH];
+  tiny_member_t *members;
+  uint32_t member_count;
+  uint32_t member_capacity;
+  tiny_function_t *functions;
+  uint32_t function_count;
+  uint32_t function_capacity;
+  tiny_value_t *constants;
+  uint32_t constant_count;
+  uint32_t constant_capacity;
+  tiny_site_t *sites;
+  uint32_t site_count;
+  uint32_t site_capacity;
+} tiny_program_t;
+
+void tiny_program_release(tiny_program_t *program) {
+  if (program == NULL || --program->refcount > 0) return;
+
+  for (uint32_t i = 0; i < program->member_count; i++) {
+    free(program->members[i].name);
+    destruct_string_name(program->members[i].string_name);
+  }
+  for (uint32_t i = 0; i < program->function_count; i++) {
+    free(program->functions[i].name);
+    free(program->functions[i].code);
+    destruct_string_name(program->functions[i].string_name);
+  }
+  for (uint32_t i = 0; i < program->site_count; i++) {
+    destruct_string_name(program->sites[i].name);
+    if (program->sites[i].known_name != NULL) {
+      destruct_string_name(program->sites[i].known_name);
+    }
+  }
+  free(program->members);
+  free(program->functions);
+  free(program->constants);
+  free(program->sites);
+  free(program);
+}
+
+// ---------------------------------------------------------------------------
+// Lexer
+// ---------------------------------------------------------------------------
+
+typedef enum {
+  TOKEN_EOF,
+  TOKEN_ERROR,
+  TOKEN_NEWLINE,
+  TOKEN_IDENTIFIER,
+  TOKEN_INT,
+  TOKEN_FLOAT,
+  TOKEN_EXTENDS,
+  TOKEN_VAR,
+  TOKEN_FUNC,
+  TOKEN_END,
+  TOKEN_IF,
+  TOKEN_ELSE,
+  TOKEN_WHILE,
+  TOKEN_RETURN,
+  TOKEN_TRUE,
+  TOKEN_FALSE,
+  TOKEN_AND,
+  TOKEN_OR,
+  TOKEN_NOT,
+  TOKEN_LPAREN,
+  TOKEN_RPAREN,
+  TOKEN_COMMA,
+  TOKEN_DOT,
+  TOKEN_ASSIGN,
+  TOKEN_PLUS,
+  TOKEN_MINUS,
+  TOKEN_STAR,
+  TOKEN_SLASH,
+  TOKEN_PERCENT,
+  TOKEN_EQ,
+  TOKEN_NE,
+  TOKEN_LT,
+  TOKEN_LE,
+  TOKEN_GT,
+  TOKEN_GE,
+} tiny_token_type_t;
+
+struct {
+  const char *word;
+  tiny_token_type_t type;
+} tiny_keywords[] = {
+  { "extends", TOKEN_EXTENDS },
+  { "var", TOKEN_VAR },
+  { "func", TOKEN_FUNC },
+  { "end", TOKEN_END },
+  { "if", TOKEN_IF },
+  { "else", TOKEN_ELSE },
+  { "while", TOKEN_WHILE },
+  { "return", TOKEN_RETURN },
+  { "true", TOKEN_TRUE },
+  { "false", TOKEN_FALSE },
+  { "and", TOKEN_AND },
+  { "or", TOKEN_OR },
+  { "not", TOKEN_NOT },
+};
+
+typedef struct {
+  tiny_token_type_t type;
+  const char *start;
+  int length;
+  int line;
+  int64_t int_value;
+  double float_value;
+} tiny_token_t;
+
+typedef struct {
+  const char *p;
+  int line;
+} tiny_lexer_t;
+
+tiny_token_t tiny_lex(tiny_lexer_t *lexer) {
+  // Skip spaces and comments, newlines are tokens
+  for (;;) {
+    char ch = *lexer->p;
+    if (ch == ' ' || ch == '\t' || ch == '\r') {
+      lexer->p++;
+    } else if (ch == '#') {
+      while (*lexer->p != '\0' && *lexer->p != '\n') lexer->p++;
+    } else {
+      break;
+    }
+  }
+
+  tiny_token_t token = { .start = lexer->p, .length = 1, .line = lexer->line };
+  char ch = *lexer->p;
+
+  if (ch == '\0') {
+    token.type = TOKEN_EOF;
+    token.length = 0;
+    return token;
+  }
+
+  if (ch == '\n') {
+    lexer->p++;
+    lexer->line++;
+    token.type = TOKEN_NEWLINE;
+    return token;
+  }
+
+  if (ch == '_' || (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z')) {
+    const char *p = lexer->p;
+    while (*p == '_' || (*p >= 'a' && *p <= 'z') || (*p >= 'A' && *p <= 'Z') || (*p >= '0' && *p <= '9')) p++;
+    token.length = p - lexer->p;
+    token.type = TOKEN_IDENTIFIER;
+    lexer->p = p;
+
+    size_t n = sizeof(tiny_keywords) / sizeof(*tiny_keywords);
+    for (size_t i = 0; i < n; i++) {
+      if (strlen(tiny_keywords[i].word) == (size_t)token.length
+          && strncmp(tiny_keywords[i].word, token.start, token.length) == 0) {
+        token.type = tiny_keywords[i].type;
+      }
+    }
+    return token;
+  }
+
+  if (ch >= '0' && ch <= '9') {
+    char *end;
+    token.int_value = strtoll(lexer->p, &end, 10);
+    token.type = TOKEN_INT;
+    if (*end == '.' || *end == 'e' || *end == 'E') {
+      token.float_value = strtod(lexer->p, &end);
+      token.type = TOKEN_FLOAT;
+    }
+    token.length = end - lexer->p;
+    lexer->p = end;
+    return token;
+  }
+
+  lexer->p++;
+  char next = *lexer->p;
+  switch (ch) {
+    case '(': token.type = TOKEN_LPAREN; break;
+    case ')': token.type = TOKEN_RPAREN; break;
+    case ',': token.type = TOKEN_COMMA; break;
+    case '.': token.type = TOKEN_DOT; break;
+    case '+': token.type = TOKEN_PLUS; break;
+    case '-': token.type = TOKEN_MINUS; break;
+    case '*': token.type = TOKEN_STAR; break;
+    case '/': token.type = TOKEN_SLASH; break;
+    case '%': token.type = TOKEN_PERCENT; break;
+    case '=': token.type = next == '=' ? TOKEN_EQ : TOKEN_ASSIGN; break;
+    case '<': token.type = next == '=' ? TOKEN_LE : TOKEN_LT; break;
+    case '>': token.type = next == '=' ? TOKEN_GE : TOKEN_GT; break;
+    case '!': token.type = next == '=' ? TOKEN_NE : TOKEN_ERROR; break;
+    default: token.type = TOKEN_ERROR; break;
+  }
+  if (token.type == TOKEN_EQ || token.type == TOKEN_LE || token.type == TOKEN_GE || token.type == TOKEN_NE) {
+    lexer->p++;
+    token.length = 2;
+  }
+  return token;
+}
+
+// ---------------------------------------------------------------------------
+// Compiler
+// ---------------------------------------------------------------------------
+
+// Single pass, straight from tokens to bytecode. Locals live in the first
+// registers of a function (parameters first), temporaries are allocated
+// above them like a stack and freed at the end of every statement.
+
+typedef struct {
+  const char *start;
+  int length;
+} tiny_name_t;
+
+typedef struct {
+  tiny_lexer_t lexer;
+  tiny_token_t current;
+  tiny_token_t next;
+  tiny_program_t *program;
+  tiny_function_t *function;
+  tiny_name_t locals[TINY_MAX_REGISTERS];
+  int local_count;
+  int top;
+  bool failed;
+  char error[TINY_ERROR_SIZE];
+} tiny_compiler_t;
+
+void tiny_compile_error(tiny_compiler_t *c, const char *format, ...) {
+  if (c->failed) return;
+  c->failed = true;
+
+  int n = snprintf(c->error, TINY_ERROR_SIZE, "line %d: ", c->current.line);
+  va_list args;
+  va_start(args, format);
+  vsnprintf(c->error + n, TINY_ERROR_SIZE - n, format, args);
+  va_end(args);
+
+  // Pretend the file ended here so every loop stops
+  c->current.type = TOKEN_EOF;
+}
+
+void tiny_advance(tiny_compiler_t *c) {
+  if (c->failed) return;
+
+  c->current = c->next;
+  c->next = tiny_lex(&c->lexer);
+  if (c->current.type == TOKEN_ERROR) {
+    tiny_compile_error(c, "unexpected character '%c'", *c->current.start);
+  }
+}
+
+bool tiny_match(tiny_compiler_t *c, tiny_token_type_t type) {
+  if (c->current.type != type) return false;
+  tiny_advance(c);
+  return true;
+}
+
+void tiny_expect(tiny_compiler_t *c, tiny_token_type_t type, const char *what) {
+  if (!tiny_match(c, type)) tiny_compile_error(c, "expected %s", what);
+}
+
+void tiny_skip_newlines(tiny_compiler_t *c) {
+  while (c->current.type == TOKEN_NEWLINE) tiny_advance(c);
+}
+
+bool tiny_token_is(const tiny_token_t *token, const char *word) {
+  return strlen(word) == (size_t)token->length && strncmp(word, token->start, token->length) == 0;
+}
+
+char *tiny_token_copy(const tiny_token_t *token) {
+  char *res = malloc(token->length + 1);
+  memcpy(res, token->start, token->length);
+  res[token->length] = '\0';
+  return res;
+}
+
+int tiny_emit(tiny_compiler_t *c, tiny_opcode_t op, int a, int b, int cc, int32_t k) {
+  tiny_function_t *function = c->function;
+  function->code = grow_array(function->code, function->code_count, &function->code_capacity, sizeof(tiny_instruction_t));
+  function->code[function->code_count] = (tiny_instruction_t){
+    .op = op,
+    .a = a,
+    .b = b,
+    .c = cc,
+    .k = k,
+  };
+  return function->code_count++;
+}
+
+void tiny_patch_jump(tiny_compiler_t *c, int jump) {
+  c->function->code[jump].k = c->function->code_count;
+}
+
+int tiny_alloc_register(tiny_compiler_t *c) {
+  if (c->top >= TINY_MAX_REGISTERS) {
+    tiny_compile_error(c, "function needs more than %d registers", TINY_MAX_REGISTERS);
+    return 0;
+  }
+  int res = c->top++;
+  if ((uint32_t)c->top > c->function->register_count) c->function->register_count = c->top;
+  return res;
+}
+
+int tiny_add_constant(tiny_compiler_t *c, tiny_value_t value) {
+  tiny_program_t *program = c->program;
+  program->constants = grow_array(program->constants, program->constant_count, &program->constant_capacity, sizeof(tiny_value_t));
+  program->constants[program->constant_count] = value;
+  return program->constant_count++;
+}
+
+int tiny_add_site(tiny_compiler_t *c, tiny_site_kind_t kind, const tiny_token_t *name) {
+  tiny_program_t *program = c->program;
+  program->sites = grow_array(program->sites, program->site_count, &program->site_capacity, sizeof(tiny_site_t));
+
+  char *c_name = tiny_token_copy(name);
+  tiny_site_t *site = &program->sites[program->site_count];
+  memset(site, 0, sizeof(*site));
+  site->kind = kind;
+  site->name = construct_string_name(c_name);
+
+  // `position` is read with `get_position` and written with `set_position`
+  char known_name[TINY_MAX_NAME_LENGTH + 4];
+  snprintf(known_name, sizeof(known_name), "%s%s",
+           kind == TINY_SITE_GET ? "get_" : kind == TINY_SITE_SET ? "set_" : "",
+           c_name);
+  site->known = tiny_find_known_method(known_name);
+  site->known_name = site->known != NULL ? construct_string_name(known_name) : NULL;
+
+  free(c_name);
+  return program->site_count++;
+}
+
+int tiny_find_local(tiny_compiler_t *c, const tiny_token_t *name) {
+  for (int i = c->local_count - 1; i >= 0; i--) {
+    if (c->locals[i].length == name->length && strncmp(c->locals[i].start, name->start, name->length) == 0) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+int tiny_find_member(tiny_program_t *program, const tiny_token_t *name) {
+  for (uint32_t i = 0; i < program->member_count; i++) {
+    if (tiny_token_is(name, program->members[i].name)) return i;
+  }
+  return -1;
+}
+
+int tiny_find_function(tiny_program_t *program, const tiny_token_t *name) {
+  for (uint32_t i = 0; i < program->function_count; i++) {
+    if (tiny_token_is(name, program->functions[i].name)) return i;
+  }
+  return -1;
+}
+
+int tiny_compile_expression(tiny_compiler_t *c);
+
+// Arguments end up in consecutive registers starting at the returned one,
+// which is also where the result goes
+int tiny_compile_call(tiny_compiler_t *c, const tiny_token_t *name) {
+  int base = c->top;
+  int arg_count = 0;
+
+  tiny_expect(c, TOKEN_LPAREN, "'('");
+  if (c->current.type != TOKEN_RPAREN) {
+    do {
+      int slot = tiny_alloc_register(c);
+      int r = tiny_compile_expression(c);
+      if (r != slot) tiny_emit(c, OP_MOVE, slot, r, 0, 0);
+      c->top = slot + 1;
+      arg_count++;
+    } while (tiny_match(c, TOKEN_COMMA));
+  }
+  tiny_expect(c, TOKEN_RPAREN, "')'");
+  if (arg_count == 0) tiny_alloc_register(c);
+
+  struct {
+    const char *name;
+    tiny_opcode_t op;
+    int arg_count;
+  } builtins[] = {
+    { "sin", OP_SIN, 1 },
+    { "cos", OP_COS, 1 },
+    { "sqrt", OP_SQRT, 1 },
+    { "vec2", OP_VEC2, 2 },
+  };
+  for (size_t i = 0; i < sizeof(builtins) / sizeof(*builtins); i++) {
+    if (!tiny_token_is(name, builtins[i].name)) continue;
+    if (arg_count != builtins[i].arg_count) {
+      tiny_compile_error(c, "%s takes %d arguments", builtins[i].name, builtins[i].arg_count);
+    }
+    tiny_emit(c, builtins[i].op, base, base, base + 1, 0);
+    c->top = base + 1;
+    return base;
+  }
+
+  int function = tiny_find_function(c->program, name);
+  if (function >= 0) {
+    tiny_emit(c, OP_CALL_SCRIPT, base, base, arg_count, function);
+  } else {
+    tiny_emit(c, OP_CALL_ENGINE, base, base, arg_count, tiny_add_site(c, TINY_SITE_CALL, name));
+  }
+  c->top = base + 1;
+  return base;
+}
+
+int tiny_compile_primary(tiny_compiler_t *c) {
+  tiny_token_t token = c->current;
+
+  switch (token.type) {
+    case TOKEN_INT:
+    case TOKEN_FLOAT:
+    case TOKEN_TRUE:
+    case TOKEN_FALSE: {
+      tiny_advance(c);
+      tiny_value_t value;
+      if (token.type == TOKEN_INT) {
+        value = (tiny_value_t){ .type = TINY_INT, .i = token.int_value };
+      } else if (token.type == TOKEN_FLOAT) {
+        value = (tiny_value_t){ .type = TINY_FLOAT, .f = token.float_value };
+      } else {
+        value = (tiny_value_t){ .type = TINY_BOOL, .b = token.type == TOKEN_TRUE };
+      }
+      int dst = tiny_alloc_register(c);
+      tiny_emit(c, OP_LOADK, dst, 0, 0, tiny_add_constant(c, value));
+      return dst;
+    }
+    case TOKEN_LPAREN: {
+      tiny_advance(c);
+      int r = tiny_compile_expression(c);
+      tiny_expect(c, TOKEN_RPAREN, "')'");
+      return r;
+    }
+    case TOKEN_IDENTIFIER: {
+      tiny_advance(c);
+      if (c->current.type == TOKEN_LPAREN) return tiny_compile_call(c, &token);
+
+      // Locals, then members of the script, then properties of the owner
+      int local = tiny_find_local(c, &token);
+      if (local >= 0) return local;
+
+      int dst = tiny_alloc_register(c);
+      int member = tiny_find_member(c->program, &token);
+      if (member >= 0) {
+        tiny_emit(c, OP_GET_MEMBER, dst, 0, 0, member);
+      } else {
+        tiny_emit(c, OP_GET_PROPERTY, dst, 0, 0, tiny_add_site(c, TINY_SITE_GET, &token));
+      }
+      return dst;
+    }
+    default:
+      tiny_compile_error(c, "expected an expression");
+      return 0;
+  }
+}
+
+int tiny_compile_postfix(tiny_compiler_t *c) {
+  int mark = c->top;
+  int r = tiny_compile_primary(c);
+
+  while (tiny_match(c, TOKEN_DOT)) {
+    tiny_token_t field = c->current;
+    tiny_expect(c, TOKEN_IDENTIFIER, "x or y");
+    if (!tiny_token_is(&field, "x") && !tiny_token_is(&field, "y")) {
+      tiny_compile_error(c, "only .x and .y are supported");
+    }
+    c->top = mark;
+    int dst = tiny_alloc_register(c);
+    tiny_emit(c, tiny_token_is(&field, "x") ? OP_GET_X : OP_GET_Y, dst, r, 0, 0);
+    r = dst;
+  }
+  return r;
+}
+
+int tiny_compile_unary(tiny_compiler_t *c) {
+  if (c->current.type != TOKEN_MINUS && c->current.type != TOKEN_NOT) {
+    return tiny_compile_postfix(c);
+  }
+
+  tiny_opcode_t op = c->current.type == TOKEN_MINUS ? OP_NEG : OP_NOT;
+  tiny_advance(c);
+  int mark = c->top;
+  int r = tiny_compile_unary(c);
+  c->top = mark;
+  int dst = tiny_alloc_register(c);
+  tiny_emit(c, op, dst, r, 0, 0);
+  return dst;
+}
+
+int tiny_precedence(tiny_token_type_t type) {
+  switch (type) {
+    case TOKEN_OR: return 1;
+    case TOKEN_AND: return 2;
+    case TOKEN_EQ: case TOKEN_NE: case TOKEN_LT: case TOKEN_LE: case TOKEN_GT: case TOKEN_GE: return 3;
+    case TOKEN_PLUS: case TOKEN_MINUS: return 4;
+    case TOKEN_STAR: case TOKEN_SLASH: case TOKEN_PERCENT: return 5;
+    default: return 0;
+  }
+}
+
+int tiny_compile_binary(tiny_compiler_t *c, int min_precedence) {
+  int mark = c->top;
+  int left = tiny_compile_unary(c);
+
+  for (;;) {
+    tiny_token_type_t type = c->current.type;
+    int precedence = tiny_precedence(type);
+    if (precedence == 0 || precedence < min_precedence) break;
+    tiny_advance(c);
+
+    // `and`/`or` short-circuit and give back one of their operands
+    if (type == TOKEN_AND || type == TOKEN_OR) {
+      c->top = mark;
+      int dst = tiny_alloc_register(c);
+      if (left != dst) tiny_emit(c, OP_MOVE, dst, left, 0, 0);
+      int jump = tiny_emit(c, type == TOKEN_AND ? OP_JUMP_IF_FALSE : OP_JUMP_IF_TRUE, dst, 0, 0, 0);
+      int right = tiny_compile_binary(c, precedence + 1);
+      if (right != dst) tiny_emit(c, OP_MOVE, dst, right, 0, 0);
+      c->top = dst + 1;
+      tiny_patch_jump(c, jump);
+      left = dst;
+      continue;
+    }
+
+    int right = tiny_compile_binary(c, precedence + 1);
+    c->top = mark;
+    int dst = tiny_alloc_register(c);
+    switch (type) {
+      case TOKEN_PLUS: tiny_emit(c, OP_ADD, dst, left, right, 0); break;
+      case TOKEN_MINUS: tiny_emit(c, OP_SUB, dst, left, right, 0); break;
+      case TOKEN_STAR: tiny_emit(c, OP_MUL, dst, left, right, 0); break;
+      case TOKEN_SLASH: tiny_emit(c, OP_DIV, dst, left, right, 0); break;
+      case TOKEN_PERCENT: tiny_emit(c, OP_MOD, dst, left, right, 0); break;
+      case TOKEN_EQ: tiny_emit(c, OP_EQ, dst, left, right, 0); break;
+      case TOKEN_NE: tiny_emit(c, OP_NE, dst, left, right, 0); break;
+      case TOKEN_LT: tiny_emit(c, OP_LT, dst, left, right, 0); break;
+      case TOKEN_LE: tiny_emit(c, OP_LE, dst, left, right, 0); break;
+      // a > b is b < a
+      case TOKEN_GT: tiny_emit(c, OP_LT, dst, right, left, 0); break;
+      case TOKEN_GE: tiny_emit(c, OP_LE, dst, right, left, 0); break;
+      default: break;
+    }
+    left = dst;
+  }
+  return left;
+}
+
+int tiny_compile_expression(tiny_compiler_t *c) {
+  return tiny_compile_binary(c, 1);
+}
+
+void tiny_compile_block(tiny_compiler_t *c);
+
+void tiny_compile_statement_end(tiny_compiler_t *c) {
+  if (c->current.type != TOKEN_EOF) tiny_expect(c, TOKEN_NEWLINE, "end of line");
+}
+
+void tiny_compile_statement(tiny_compiler_t *c) {
+  tiny_token_t token = c->current;
+
+  if (tiny_match(c, TOKEN_VAR)) {
+    tiny_token_t name = c->current;
+    tiny_expect(c, TOKEN_IDENTIFIER, "a variable name");
+    tiny_expect(c, TOKEN_ASSIGN, "'='");
+    if (tiny_find_local(c, &name) >= 0) {
+      tiny_compile_error(c, "'%.*s' is already declared", name.length, name.start);
+    }
+    int r = tiny_compile_expression(c);
+    int local = c->local_count;
+    if (local >= TINY_MAX_REGISTERS) {
+      tiny_compile_error(c, "too many locals");
+      return;
+    }
+    if (r != local) tiny_emit(c, OP_MOVE, local, r, 0, 0);
+    c->locals[c->local_count++] = (tiny_name_t){ .start = name.start, .length = name.length };
+    c->top = c->local_count;
+    if ((uint32_t)c->top > c->function->register_count) c->function->register_count = c->top;
+    tiny_compile_statement_end(c);
+    return;
+  }
+
+  if (tiny_match(c, TOKEN_IF)) {
+    int condition = tiny_compile_expression(c);
+    int jump_over_then = tiny_emit(c, OP_JUMP_IF_FALSE, condition, 0, 0, 0);
+    c->top = c->local_count;
+    tiny_compile_statement_end(c);
+    tiny_compile_block(c);
+    if (tiny_match(c, TOKEN_ELSE)) {
+      int jump_over_else = tiny_emit(c, OP_JUMP, 0, 0, 0, 0);
+      tiny_patch_jump(c, jump_over_then);
+      tiny_compile_statement_end(c);
+      tiny_compile_block(c);
+      tiny_patch_jump(c, jump_over_else);
+    } else {
+      tiny_patch_jump(c, jump_over_then);
+    }
+    tiny_expect(c, TOKEN_END, "'end'");
+    tiny_compile_statement_end(c);
+    return;
+  }
+
+  if (tiny_match(c, TOKEN_WHILE)) {
+    int loop_start = c->function->code_count;
+    int condition = tiny_compile_expression(c);
+    int jump_out = tiny_emit(c, OP_JUMP_IF_FALSE, condition, 0, 0, 0);
+    c->top = c->local_count;
+    tiny_compile_statement_end(c);
+    tiny_compile_block(c);
+    tiny_emit(c, OP_JUMP, 0, 0, 0, loop_start);
+    tiny_patch_jump(c, jump_out);
+    tiny_expect(c, TOKEN_END, "'end'");
+    tiny_compile_statement_end(c);
+    return;
+  }
+
+  if (tiny_match(c, TOKEN_RETURN)) {
+    if (c->current.type == TOKEN_NEWLINE || c->current.type == TOKEN_EOF) {
+      tiny_emit(c, OP_RETURN_NIL, 0, 0, 0, 0);
+    } else {
+      tiny_emit(c, OP_RETURN, tiny_compile_expression(c), 0, 0, 0);
+    }
+    c->top = c->local_count;
+    tiny_compile_statement_end(c);
+    return;
+  }
+
+  if (token.type == TOKEN_IDENTIFIER && c->next.type == TOKEN_ASSIGN) {
+    tiny_advance(c);
+    tiny_advance(c);
+    int r = tiny_compile_expression(c);
+
+    int local = tiny_find_local(c, &token);
+    int member = tiny_find_member(c->program, &token);
+    if (local >= 0) {
+      if (r != local) tiny_emit(c, OP_MOVE, local, r, 0, 0);
+    } else if (member >= 0) {
+      tiny_emit(c, OP_SET_MEMBER, r, 0, 0, member);
+    } else {
+      tiny_emit(c, OP_SET_PROPERTY, r, 0, 0, tiny_add_site(c, TINY_SITE_SET, &token));
+    }
+    c->top = c->local_count;
+    tiny_compile_statement_end(c);
+    return;
+  }
+
+  // Anything else is an expression that's evaluated for its side effects
+  tiny_compile_expression(c);
+  c->top = c->local_count;
+  tiny_compile_statement_end(c);
+}
+
+// Runs until `end` or `else`, which are left for the caller
+void tiny_compile_block(tiny_compiler_t *c) {
+  for (;;) {
+    tiny_skip_newlines(c);
+    tiny_token_type_t type = c->current.type;
+    if (type == TOKEN_END || type == TOKEN_ELSE || type == TOKEN_EOF) return;
+    tiny_compile_statement(c);
+  }
+}
+
+void tiny_compile_function(tiny_compiler_t *c) {
+  tiny_token_t name = c->current;
+  tiny_expect(c, TOKEN_IDENTIFIER, "a function name");
+  if (c->failed) return;
+
+  c->function = &c->program->functions[tiny_find_function(c->program, &name)];
+  c->local_count = 0;
+
+  tiny_expect(c, TOKEN_LPAREN, "'('");
+  if (c->current.type != TOKEN_RPAREN) {
+    do {
+      tiny_token_t param = c->current;
+      tiny_expect(c, TOKEN_IDENTIFIER, "a parameter name");
+      if (c->local_count >= TINY_MAX_REGISTERS) {
+        tiny_compile_error(c, "too many parameters");
+        return;
+      }
+      c->locals[c->local_count++] = (tiny_name_t){ .start = param.start, .length = param.length };
+    } while (tiny_match(c, TOKEN_COMMA));
+  }
+  tiny_expect(c, TOKEN_RPAREN, "')'");
+  tiny_compile_statement_end(c);
+
+  c->function->arg_count = c->local_count;
+  c->function->register_count = c->local_count;
+  c->top = c->local_count;
+
+  tiny_compile_block(c);
+  tiny_emit(c, OP_RETURN_NIL, 0, 0, 0, 0);
+  tiny_expect(c, TOKEN_END, "'end'");
+  tiny_compile_statement_end(c);
+}
+
+void tiny_compile_member(tiny_compiler_t *c) {
+  tiny_token_t name = c->current;
+  tiny_expect(c, TOKEN_IDENTIFIER, "a member name");
+  tiny_expect(c, TOKEN_ASSIGN, "'='");
+
+  bool negative = tiny_match(c, TOKEN_MINUS);
+  tiny_value_t initial;
+  tiny_token_t literal = c->current;
+  if (tiny_match(c, TOKEN_INT)) {
+    initial = (tiny_value_t){ .type = TINY_INT, .i = negative ? -literal.int_value : literal.int_value };
+  } else if (tiny_match(c, TOKEN_FLOAT)) {
+    initial = (tiny_value_t){ .type = TINY_FLOAT, .f = negative ? -literal.float_value : literal.float_value };
+  } else if (!negative && (literal.type == TOKEN_TRUE || literal.type == TOKEN_FALSE)) {
+    tiny_advance(c);
+    initial = (tiny_value_t){ .type = TINY_BOOL, .b = literal.type == TOKEN_TRUE };
+  } else {
+    tiny_compile_error(c, "members must start out as a number or a bool");
+    return;
+  }
+  tiny_compile_statement_end(c);
+  if (c->failed) return;
+
+  if (tiny_find_member(c->program, &name) >= 0) {
+    tiny_compile_error(c, "member '%.*s' is already declared", name.length, name.start);
+    return;
+  }
+
+  tiny_program_t *program = c->program;
+  program->members = grow_array(program->members, program->member_count, &program->member_capacity, sizeof(tiny_member_t));
+  tiny_member_t *member = &program->members[program->member_count++];
+  member->name = tiny_token_copy(&name);
+  member->string_name = construct_string_name(member->name);
+  member->initial = initial;
+}
+
+// Functions can be called before they are defined, so all of them are
+// declared up front
+void tiny_declare_functions(tiny_compiler_t *c, const char *source) {
+  tiny_lexer_t lexer = { .p = source, .line = 1 };
+  tiny_token_t previous = { .type = TOKEN_NEWLINE };
+
+  for (tiny_token_t token = tiny_lex(&lexer); token.type != TOKEN_EOF; token = tiny_lex(&lexer)) {
+    if (previous.type == TOKEN_FUNC && token.type == TOKEN_IDENTIFIER) {
+      if (tiny_find_function(c->program, &token) >= 0) {
+        c->current = token;
+        tiny_compile_error(c, "function '%.*s' is already defined", token.length, token.start);
+        return;
+      }
+
+      tiny_program_t *program = c->program;
+      program->functions = grow_array(program->functions, program->function_count, &program->function_capacity, sizeof(tiny_function_t));
+      tiny_function_t *function = &program->functions[program->function_count++];
+      memset(function, 0, sizeof(*function));
+      function->name = tiny_token_copy(&token);
+      function->string_name = construct_string_name(function->name);
+    }
+    previous = token;
+  }
+}
+
+// Returns NULL and fills `r_error` if the source doesn't compile
+tiny_program_t *tiny_compile(const char *source, char *r_error) {
+  tiny_compiler_t *c = calloc(1, sizeof(tiny_compiler_t));
+  c->program = calloc(1, sizeof(tiny_program_t));
+  c->program->refcount = 1;
+  c->lexer = (tiny_lexer_t){ .p = source, .line = 1 };
+
+  tiny_declare_functions(c, source);
+  c->next = tiny_lex(&c->lexer);
+  tiny_advance(c);
+
+  tiny_skip_newlines(c);
+  tiny_expect(c, TOKEN_EXTENDS, "'extends' at the top");
+  tiny_token_t base_type = c->current;
+  tiny_expect(c, TOKEN_IDENTIFIER, "a class name after 'extends'");
+  if (base_type.length >= TINY_MAX_NAME_LENGTH) {
+    tiny_compile_error(c, "class name is too long");
+  }
+  snprintf(c->program->base_type, TINY_MAX_NAME_LENGTH, "%.*s", base_type.length, base_type.start);
+  tiny_compile_statement_end(c);
+
+  for (;;) {
+    tiny_skip_newlines(c);
+    if (tiny_match(c, TOKEN_VAR)) {
+      tiny_compile_member(c);
+    } else if (tiny_match(c, TOKEN_FUNC)) {
+      tiny_compile_function(c);
+    } else if (c->current.type == TOKEN_EOF) {
+      break;
+    } else {
+      tiny_compile_error(c, "expected 'var' or 'func'");
+    }
+  }
+
+  tiny_program_t *res = c->program;
+  if (c->failed) {
+    snprintf(r_error, TINY_ERROR_SIZE, "%s", c->error);
+    tiny_program_release(res);
+    res = NULL;
+  }
+  free(c);
+  return res;
+}
+
+// ---------------------------------------------------------------------------
+// VM
+// ---------------------------------------------------------------------------
+
+typedef struct {
+  GDExtensionObjectPtr godot_object;
+  char *source;
+  // NULL until the source compiles
+  tiny_program_t *program;
+} tiny_script_t;
+
+typedef struct {
+  tiny_script_t *script;
+  tiny_program_t *program;
+  GDExtensionObjectPtr owner;
+  // Identifies the owner's class in the inline caches
+  void *class_tag;
+  GDExtensionStringNamePtr class_name;
+  uint32_t call_depth;
+  tiny_value_t members[];
+} tiny_instance_t;
+
+void tiny_runtime_error(const tiny_function_t *function, const char *message) {
+  fprintf(stderr, "TinyScript error in %s(): %s\n", function->name, message);
+}
+
+bool tiny_is_truthy(const tiny_value_t *v) {
+  switch (v->type) {
+    case TINY_BOOL: return v->b;
+    case TINY_INT: return v->i != 0;
+    case TINY_FLOAT: return v->f != 0.0;
+    case TINY_VECTOR2: return v->v.x != 0 || v->v.y != 0;
+    default: return false;
+  }
+}
+
+bool tiny_to_float(const tiny_value_t *v, double *r_value) {
+  if (v->type == TINY_FLOAT) {
+    *r_value = v->f;
+    return true;
+  }
+  if (v->type == TINY_INT) {
+    *r_value = (double)v->i;
+    return true;
+  }
+  return false;
+}
+
+// The slow path of arithmetic. int and float together give a float, Vector2
+// works with Vector2 and with numbers (scaling).
+bool tiny_arithmetic(tiny_opcode_t op, const tiny_value_t *x, const tiny_value_t *y, tiny_value_t *r) {
+  double fx, fy;
+
+  if (x->type == TINY_INT && y->type == TINY_INT) {
+    int64_t a = x->i, b = y->i;
+    if ((op == OP_DIV || op == OP_MOD) && b == 0) return false;
+    int64_t res = op == OP_ADD ? a + b : op == OP_SUB ? a - b : op == OP_MUL ? a * b : op == OP_DIV ? a / b : a % b;
+    *r = (tiny_value_t){ .type = TINY_INT, .i = res };
+    return true;
+  }
+
+  if (tiny_to_float(x, &fx) && tiny_to_float(y, &fy)) {
+    double res = op == OP_ADD ? fx + fy : op == OP_SUB ? fx - fy : op == OP_MUL ? fx * fy : op == OP_DIV ? fx / fy : fmod(fx, fy);
+    *r = (tiny_value_t){ .type = TINY_FLOAT, .f = res };
+    return true;
+  }
+
+  if (x->type == TINY_VECTOR2 && y->type == TINY_VECTOR2 && op != OP_MOD) {
+    GDVector2 a = x->v, b = y->v;
+    GDVector2 res = op == OP_ADD ? (GDVector2){ a.x + b.x, a.y + b.y }
+      : op == OP_SUB ? (GDVector2){ a.x - b.x, a.y - b.y }
+      : op == OP_MUL ? (GDVector2){ a.x * b.x, a.y * b.y }
+      : (GDVector2){ a.x / b.x, a.y / b.y };
+    *r = (tiny_value_t){ .type = TINY_VECTOR2, .v = res };
+    return true;
+  }
+
+  if (x->type == TINY_VECTOR2 && tiny_to_float(y, &fy) && (op == OP_MUL || op == OP_DIV)) {
+    double s = op == OP_MUL ? fy : 1.0 / fy;
+    *r = (tiny_value_t){ .type = TINY_VECTOR2, .v = { x->v.x * s, x->v.y * s } };
+    return true;
+  }
+
+  if (tiny_to_float(x, &fx) && y->type == TINY_VECTOR2 && op == OP_MUL) {
+    *r = (tiny_value_t){ .type = TINY_VECTOR2, .v = { y->v.x * fx, y->v.y * fx } };
+    return true;
+  }
+
+  return false;
+}
+
+bool tiny_compare(tiny_opcode_t op, const tiny_value_t *x, const tiny_value_t *y, tiny_value_t *r) {
+  double fx, fy;
+  bool res;
+
+  if (op == OP_EQ || op == OP_NE) {
+    if (tiny_to_float(x, &fx) && tiny_to_float(y, &fy)) {
+      res = x->type == TINY_INT && y->type == TINY_INT ? x->i == y->i : fx == fy;
+    } else if (x->type != y->type) {
+      res = false;
+    } else if (x->type == TINY_BOOL) {
+      res = x->b == y->b;
+    } else if (x->type == TINY_VECTOR2) {
+      res = x->v.x == y->v.x && x->v.y == y->v.y;
+    } else {
+      res = true; // nil == nil
+    }
+    if (op == OP_NE) res = !res;
+  } else {
+    if (!tiny_to_float(x, &fx) || !tiny_to_float(y, &fy)) return false;
+    if (x->type == TINY_INT && y->type == TINY_INT) {
+      res = op == OP_LT ? x->i < y->i : x->i <= y->i;
+    } else {
+      res = op == OP_LT ? fx < fy : fx <= fy;
+    }
+  }
+
+  *r = (tiny_value_t){ .type = TINY_BOOL, .b = res };
+  return true;
+}
+
+void tiny_value_to_variant(const tiny_value_t *value, GDExtensionUninitializedVariantPtr r_variant) {
+  switch (value->type) {
+    case TINY_BOOL:
+      gd_extension_helper.wrap.type_bool(r_variant, (void *)&value->b);
+      break;
+    case TINY_INT:
+      gd_extension_helper.wrap.type_int(r_variant, (void *)&value->i);
+      break;
+    case TINY_FLOAT:
+      gd_extension_helper.wrap.type_double(r_variant, (void *)&value->f);
+      break;
+    case TINY_VECTOR2:
+      gd_extension_helper.wrap.type_vector2(r_variant, (void *)&value->v);
+      break;
+    default:
+      gd_extension.variant_new_nil(r_variant);
+      break;
+  }
+}
+
+// Types TinyScript doesn't have become nil
+bool tiny_value_from_variant(GDExtensionConstVariantPtr p_variant, tiny_value_t *r_value) {
+  GDExtensionVariantPtr variant = (GDExtensionVariantPtr)p_variant;
+  switch (gd_extension.variant_get_type(p_variant)) {
+    case GDEXTENSION_VARIANT_TYPE_NIL:
+      r_value->type = TINY_NIL;
+      return true;
+    case GDEXTENSION_VARIANT_TYPE_BOOL:
+      r_value->type = TINY_BOOL;
+      gd_extension_helper.unwrap.type_bool(&r_value->b, variant);
+      return true;
+    case GDEXTENSION_VARIANT_TYPE_INT:
+      r_value->type = TINY_INT;
+      gd_extension_helper.unwrap.type_int(&r_value->i, variant);
+      return true;
+    case GDEXTENSION_VARIANT_TYPE_FLOAT:
+      r_value->type = TINY_FLOAT;
+      gd_extension_helper.unwrap.type_double(&r_value->f, variant);
+      return true;
+    case GDEXTENSION_VARIANT_TYPE_VECTOR2:
+      r_value->type = TINY_VECTOR2;
+      gd_extension_helper.unwrap.type_vector2(&r_value->v, variant);
+      return true;
+    default:
+      r_value->type = TINY_NIL;
+      return false;
+  }
+}
+
+// Looks up the method bind of a known method for the owner's class. The first
+// few classes seen at a site are remembered, more than that (megamorphic)
+// asks ClassDB every time.
+GDExtensionMethodBindPtr tiny_site_bind(tiny_instance_t *instance, tiny_site_t *site) {
+  if (site->known == NULL) return NULL;
+
+  for (uint32_t i = 0; i < site->cache_count; i++) {
+    if (site->cache[i].class_tag == instance->class_tag) return site->cache[i].bind;
+  }
+
+  // ClassDB walks up the inheritance chain, so the owner's own class works
+  // for methods declared by one of its parents
+  GDExtensionMethodBindPtr bind = gd_extension.classdb_get_method_bind(instance->class_name,
+                                                                       site->known_name,
+                                                                       site->known->hash);
+  if (site->cache_count < TINY_CACHE_SIZE) {
+    site->cache[site->cache_count++] = (tiny_cache_entry_t){
+      .class_tag = instance->class_tag,
+      .bind = bind,
+    };
+  }
+  return bind;
+}
+
+// ptrcall for the known signatures. Returns false if the arguments don't fit,
+// then the caller uses the Variant fallback which reports the error.
+bool
+tiny_ptrcall(
+  tiny_instance_t *instance,
+  GDExtensionMethodBindPtr bind,
+  tiny_signature_t signature,
+  const tiny_value_t *args,
+  int arg_count,
+  tiny_value_t *r_result
+) {
+  double f;
+  GDExtensionConstTypePtr ptr_args[1];
+
+  switch (signature) {
+    case TINY_SIGNATURE_VOID:
+      if (arg_count != 0) return false;
+      gd_extension.object_method_bind_ptrcall(bind, instance->owner, NULL, NULL);
+      r_result->type = TINY_NIL;
+      return true;
+    case TINY_SIGNATURE_GET_FLOAT:
+      if (arg_count != 0) return false;
+      r_result->type = TINY_FLOAT;
+      gd_extension.object_method_bind_ptrcall(bind, instance->owner, NULL, &r_result->f);
+      return true;
+    case TINY_SIGNATURE_SET_FLOAT:
+      if (arg_count != 1 || !tiny_to_float(&args[0], &f)) return false;
+      ptr_args[0] = &f;
+      gd_extension.object_method_bind_ptrcall(bind, instance->owner, ptr_args, NULL);
+      r_result->type = TINY_NIL;
+      return true;
+    case TINY_SIGNATURE_GET_VECTOR2:
+      if (arg_count != 0) return false;
+      r_result->type = TINY_VECTOR2;
+      gd_extension.object_method_bind_ptrcall(bind, instance->owner, NULL, &r_result->v);
+      return true;
+    case TINY_SIGNATURE_SET_VECTOR2:
+      if (arg_count != 1 || args[0].type != TINY_VECTOR2) return false;
+      ptr_args[0] = &args[0].v;
+      gd_extension.object_method_bind_ptrcall(bind, instance->owner, ptr_args, NULL);
+      r_result->type = TINY_NIL;
+      return true;
+  }
+  return false;
+}
+
+// Everything that isn't a known method goes through Variants, like GDScript
+bool
+tiny_variant_fallback(
+  tiny_instance_t *instance,
+  const tiny_function_t *function,
+  tiny_site_t *site,
+  const tiny_value_t *args,
+  int arg_count,
+  tiny_value_t *r_result
+) {
+  uint8_t owner_variant[VARIANT_SIZE];
+  uint8_t ret[VARIANT_SIZE];
+  uint8_t arg_variants[arg_count > 0 ? arg_count : 1][VARIANT_SIZE];
+  GDExtensionConstVariantPtr arg_ptrs[arg_count > 0 ? arg_count : 1];
+  GDExtensionBool valid = true;
+
+  // Made on demand: keeping a Variant to the owner around would keep
+  // RefCounted owners alive forever
+  gd_extension_helper.wrap.type_object(owner_variant, &instance->owner);
+  for (int i = 0; i < arg_count; i++) {
+    tiny_value_to_variant(&args[i], arg_variants[i]);
+    arg_ptrs[i] = arg_variants[i];
+  }
+
+  switch (site->kind) {
+    case TINY_SITE_GET:
+      gd_extension.variant_get_named(owner_variant, site->name, ret, &valid);
+      break;
+    case TINY_SITE_SET:
+      gd_extension.variant_set_named(owner_variant, site->name, arg_ptrs[0], &valid);
+      gd_extension.variant_new_nil(ret);
+      break;
+    case TINY_SITE_CALL: {
+      GDExtensionCallError error;
+      gd_extension.variant_call(owner_variant, site->name, arg_ptrs, arg_count, ret, &error);
+      valid = error.error == GDEXTENSION_CALL_OK;
+      break;
+    }
+  }
+
+  if (valid) tiny_value_from_variant(ret, r_result);
+
+  gd_extension.variant_destroy(ret);
+  for (int i = 0; i < arg_count; i++) {
+    gd_extension.variant_destroy(arg_variants[i]);
+  }
+  gd_extension.variant_destroy(owner_variant);
+
+  if (!valid) tiny_runtime_error(function, "invalid property access or method call on the owner");
+  return valid;
+}
+
+bool
+tiny_engine_access(
+  tiny_instance_t *instance,
+  const tiny_function_t *function,
+  tiny_site_t *site,
+  const tiny_value_t *args,
+  int arg_count,
+  tiny_value_t *r_result
+) {
+  GDExtensionMethodBindPtr bind = tiny_site_bind(instance, site);
+  if (bind != NULL && tiny_ptrcall(instance, bind, site->known->signature, args, arg_count, r_result)) {
+    return true;
+  }
+  return tiny_variant_fallback(instance, function, site, args, arg_count, r_result);
+}
+
+bool tiny_execute(tiny_instance_t *instance, const tiny_function_t *function, tiny_value_t *regs, tiny_value_t *r_result);
+
+bool
+tiny_call_function(
+  tiny_instance_t *instance,
+  const tiny_function_t *function,
+  const tiny_value_t *args,
+  int arg_count,
+  tiny_value_t *r_result
+) {
+  if ((uint32_t)arg_count != function->arg_count) {
+    tiny_runtime_error(function, "wrong number of arguments");
+    return false;
+  }
+  if (instance->call_depth >= TINY_MAX_CALL_DEPTH) {
+    tiny_runtime_error(function, "stack overflow");
+    return false;
+  }
+
+  // `r_result` may point into the caller's registers next to `args`, so the
+  // arguments are copied before anything is written
+  tiny_value_t regs[function->register_count > 0 ? function->register_count : 1];
+  memcpy(regs, args, arg_count * sizeof(tiny_value_t));
+  for (uint32_t i = arg_count; i < function->register_count; i++) {
+    regs[i].type = TINY_NIL;
+  }
+
+  instance->call_depth++;
+  bool ok = tiny_execute(instance, function, regs, r_result);
+  instance->call_depth--;
+  return ok;
+}
+
+// Fast paths for int and float are inlined, everything else goes through
+// `tiny_arithmetic`
+#define TINY_ARITHMETIC_CASE(opcode, operator)                                   \
+  case opcode: {                                                                 \
+    const tiny_value_t *x = &regs[ins->b], *y = &regs[ins->c];                   \
+    if (x->type == TINY_FLOAT && y->type == TINY_FLOAT) {                        \
+      regs[ins->a] = (tiny_value_t){ .type = TINY_FLOAT, .f = x->f operator y->f }; \
+    } else if (x->type == TINY_INT && y->type == TINY_INT) {                     \
+      regs[ins->a] = (tiny_value_t){ .type = TINY_INT, .i = x->i operator y->i }; \
+    } else if (!tiny_arithmetic(opcode, x, y, &regs[ins->a])) {                  \
+      tiny_runtime_error(function, "invalid operands");                          \
+      return false;                                                              \
+    }                                                                            \
+    break;                                                                       \
+  }
+
+bool tiny_execute(tiny_instance_t *instance, const tiny_function_t *function, tiny_value_t *regs, tiny_value_t *r_result) {
+  tiny_program_t *program = instance->program;
+  const tiny_instruction_t *code = function->code;
+  uint32_t pc = 0;
+
+  for (;;) {
+    const tiny_instruction_t *ins = &code[pc++];
+
+    switch ((tiny_opcode_t)ins->op) {
+      case OP_LOADK:
+        regs[ins->a] = program->constants[ins->k];
+        break;
+      case OP_MOVE:
+        regs[ins->a] = regs[ins->b];
+        break;
+      case OP_GET_MEMBER:
+        regs[ins->a] = instance->members[ins->k];
+        break;
+      case OP_SET_MEMBER:
+        instance->members[ins->k] = regs[ins->a];
+        break;
+
+      TINY_ARITHMETIC_CASE(OP_ADD, +)
+      TINY_ARITHMETIC_CASE(OP_SUB, -)
+      TINY_ARITHMETIC_CASE(OP_MUL, *)
+
+      case OP_DIV:
+      case OP_MOD:
+        if (!tiny_arithmetic(ins->op, &regs[ins->b], &regs[ins->c], &regs[ins->a])) {
+          tiny_runtime_error(function, "invalid operands or division by zero");
+          return false;
+        }
+        break;
+
+      case OP_LT:
+        if (regs[ins->b].type == TINY_FLOAT && regs[ins->c].type == TINY_FLOAT) {
+          regs[ins->a] = (tiny_value_t){ .type = TINY_BOOL, .b = regs[ins->b].f < regs[ins->c].f };
+          break;
+        }
+        if (regs[ins->b].type == TINY_INT && regs[ins->c].type == TINY_INT) {
+          regs[ins->a] = (tiny_value_t){ .type = TINY_BOOL, .b = regs[ins->b].i < regs[ins->c].i };
+          break;
+        }
+        // fallthrough
+      case OP_LE:
+      case OP_EQ:
+      case OP_NE:
+        if (!tiny_compare(ins->op, &regs[ins->b], &regs[ins->c], &regs[ins->a])) {
+          tiny_runtime_error(function, "can only compare numbers");
+          return false;
+        }
+        break;
+
+      case OP_NEG: {
+        const tiny_value_t *x = &regs[ins->b];
+        if (x->type == TINY_INT) {
+          regs[ins->a] = (tiny_value_t){ .type = TINY_INT, .i = -x->i };
+        } else if (x->type == TINY_FLOAT) {
+          regs[ins->a] = (tiny_value_t){ .type = TINY_FLOAT, .f = -x->f };
+        } else if (x->type == TINY_VECTOR2) {
+          regs[ins->a] = (tiny_value_t){ .type = TINY_VECTOR2, .v = { -x->v.x, -x->v.y } };
+        } else {
+          tiny_runtime_error(function, "invalid operand for -");
+          return false;
+        }
+        break;
+      }
+      case OP_NOT:
+        regs[ins->a] = (tiny_value_t){ .type = TINY_BOOL, .b = !tiny_is_truthy(&regs[ins->b]) };
+        break;
+
+      case OP_JUMP:
+        pc = ins->k;
+        break;
+      case OP_JUMP_IF_FALSE:
+        if (!tiny_is_truthy(&regs[ins->a])) pc = ins->k;
+        break;
+      case OP_JUMP_IF_TRUE:
+        if (tiny_is_truthy(&regs[ins->a])) pc = ins->k;
+        break;
+
+      case OP_SIN:
+      case OP_COS:
+      case OP_SQRT: {
+        double x;
+        if (!tiny_to_float(&regs[ins->b], &x)) {
+          tiny_runtime_error(function, "expected a number");
+          return false;
+        }
+        double res = ins->op == OP_SIN ? sin(x) : ins->op == OP_COS ? cos(x) : sqrt(x);
+        regs[ins->a] = (tiny_value_t){ .type = TINY_FLOAT, .f = res };
+        break;
+      }
+      case OP_VEC2: {
+        double x, y;
+        if (!tiny_to_float(&regs[ins->b], &x) || !tiny_to_float(&regs[ins->c], &y)) {
+          tiny_runtime_error(function, "vec2 expects numbers");
+          return false;
+        }
+        regs[ins->a] = (tiny_value_t){ .type = TINY_VECTOR2, .v = { x, y } };
+        break;
+      }
+      case OP_GET_X:
+      case OP_GET_Y: {
+        const tiny_value_t *v = &regs[ins->b];
+        if (v->type != TINY_VECTOR2) {
+          tiny_runtime_error(function, ".x and .y need a Vector2");
+          return false;
+        }
+        regs[ins->a] = (tiny_value_t){ .type = TINY_FLOAT, .f = ins->op == OP_GET_X ? v->v.x : v->v.y };
+        break;
+      }
+
+      case OP_GET_PROPERTY:
+        if (!tiny_engine_access(instance, function, &program->sites[ins->k], NULL, 0, &regs[ins->a])) {
+          return false;
+        }
+        break;
+      case OP_SET_PROPERTY: {
+        tiny_value_t unused;
+        if (!tiny_engine_access(instance, function, &program->sites[ins->k], &regs[ins->a], 1, &unused)) {
+          return false;
+        }
+        break;
+      }
+      case OP_CALL_ENGINE:
+        if (!tiny_engine_access(instance, function, &program->sites[ins->k], &regs[ins->b], ins->c, &regs[ins->a])) {
+          return false;
+        }
+        break;
+      case OP_CALL_SCRIPT:
+        if (!tiny_call_function(instance, &program->functions[ins->k], &regs[ins->b], ins->c, &regs[ins->a])) {
+          return false;
+        }
+        break;
+
+      case OP_RETURN:
+        *r_result = regs[ins->a];
+        return true;
+      case OP_RETURN_NIL:
+        r_result->type = TINY_NIL;
+        return true;
+    }
+  }
+}
+
+#undef TINY_ARITHMETIC_CASE
+
+// ---------------------------------------------------------------------------
+// Script instance
+// ---------------------------------------------------------------------------
+
+int tiny_instance_find_member(tiny_instance_t *instance, GDExtensionConstStringNamePtr p_name) {
+  for (uint32_t i = 0; i < instance->program->member_count; i++) {
+    if (string_name_eq(p_name, instance->program->members[i].string_name)) return i;
+  }
+  return -1;
+}
+
+const tiny_function_t *tiny_instance_find_function(tiny_instance_t *instance, GDExtensionConstStringNamePtr p_name) {
+  for (uint32_t i = 0; i < instance->program->function_count; i++) {
+    if (string_name_eq(p_name, instance->program->functions[i].string_name)) {
+      return &instance->program->functions[i];
+    }
+  }
+  return NULL;
+}
+
+GDExtensionBool
+tiny_instance_set(
+  GDExtensionScriptInstanceDataPtr p_instance,
+  GDExtensionConstStringNamePtr p_name,
+  GDExtensionConstVariantPtr p_value
+) {
+  tiny_instance_t *instance = p_instance;
+  int member = tiny_instance_find_member(instance, p_name);
+  if (member < 0) return false;
+  return tiny_value_from_variant(p_value, &instance->members[member]);
+}
+
+GDExtensionBool
+tiny_instance_get(
+  GDExtensionScriptInstanceDataPtr p_instance,
+  GDExtensionConstStringNamePtr p_name,
+  GDExtensionVariantPtr r_ret
+) {
+  tiny_instance_t *instance = p_instance;
+  int member = tiny_instance_find_member(instance, p_name);
+  if (member < 0) return false;
+  tiny_value_to_variant(&instance->members[member], r_ret);
+  return true;
+}
+
+GDExtensionVariantType tiny_type_to_variant_type(tiny_type_t type) {
+  switch (type) {
+    case TINY_BOOL: return GDEXTENSION_VARIANT_TYPE_BOOL;
+    case TINY_INT: return GDEXTENSION_VARIANT_TYPE_INT;
+    case TINY_FLOAT: return GDEXTENSION_VARIANT_TYPE_FLOAT;
+    case TINY_VECTOR2: return GDEXTENSION_VARIANT_TYPE_VECTOR2;
+    default: return GDEXTENSION_VARIANT_TYPE_NIL;
+  }
+}
+
+const GDExtensionPropertyInfo *
+tiny_instance_get_property_list(
+  GDExtensionScriptInstanceDataPtr p_instance,
+  uint32_t *r_count
+) {
+  tiny_instance_t *instance = p_instance;
+  uint32_t n = instance->program->member_count;
+  *r_count = n;
+
+  GDExtensionPropertyInfo *res = malloc((n > 0 ? n : 1) * sizeof(GDExtensionPropertyInfo));
+  for (uint32_t i = 0; i < n; i++) {
+    res[i].type = tiny_type_to_variant_type(instance->program->members[i].initial.type);
+    res[i].name = construct_string_name(instance->program->members[i].name);
+    res[i].class_name = construct_string_name("");
+    res[i].hint = 0; // Corresponds to no hints
+    res[i].hint_string = construct_string("");
+    res[i].usage = 6; // Corresponds to default usage flags
+  }
+  return res;
+}
+
+void
+tiny_instance_free_property_list(
+  GDExtensionScriptInstanceDataPtr p_instance,
+  const GDExtensionPropertyInfo *p_list
+) {
+  tiny_instance_t *instance = p_instance;
+  for (uint32_t i = 0; i < instance->program->member_count; i++) {
+    destruct_string_name((void *)p_list[i].name);
+    destruct_string_name((void *)p_list[i].class_name);
+    destruct_string((void *)p_list[i].hint_string);
+  }
+  free((void *)p_list);
+}
+
+GDExtensionBool tiny_instance_has_method(GDExtensionScriptInstanceDataPtr p_instance, GDExtensionConstStringNamePtr p_name) {
+  return tiny_instance_find_function(p_instance, p_name) != NULL;
+}
+
+// Every call from Godot lands here (`_process` included): unbox the
+// arguments, run the function, box the result
+void
+tiny_instance_call(
+  GDExtensionScriptInstanceDataPtr p_instance,
+  GDExtensionConstStringNamePtr p_method,
+  const GDExtensionConstVariantPtr *p_args,
+  GDExtensionInt p_argument_count,
+  GDExtensionVariantPtr r_return,
+  GDExtensionCallError *r_error
+) {
+  tiny_instance_t *instance = p_instance;
+  const tiny_function_t *function = tiny_instance_find_function(instance, p_method);
+
+  // Godot tries the owner's own methods next
+  if (function == NULL) {
+    r_error->error = GDEXTENSION_CALL_ERROR_INVALID_METHOD;
+    return;
+  }
+
+  if ((uint32_t)p_argument_count != function->arg_count) {
+    r_error->error = (uint32_t)p_argument_count < function->arg_count
+      ? GDEXTENSION_CALL_ERROR_TOO_FEW_ARGUMENTS
+      : GDEXTENSION_CALL_ERROR_TOO_MANY_ARGUMENTS;
+    r_error->argument = 0;
+    r_error->expected = function->arg_count;
+    return;
+  }
+
+  tiny_value_t args[p_argument_count > 0 ? p_argument_count : 1];
+  for (GDExtensionInt i = 0; i < p_argument_count; i++) {
+    if (!tiny_value_from_variant(p_args[i], &args[i])) {
+      r_error->error = GDEXTENSION_CALL_ERROR_INVALID_ARGUMENT;
+      r_error->argument = i;
+      r_error->expected = GDEXTENSION_VARIANT_TYPE_FLOAT;
+      return;
+    }
+  }
+
+  tiny_value_t result = { .type = TINY_NIL };
+  if (!tiny_call_function(instance, function, args, p_argument_count, &result)) {
+    // The runtime error is already printed. GDExtension has no "script
+    // failed" error, and INVALID_METHOD is what makes the engine report the
+    // call as failed instead of using a nil return.
+    r_error->error = GDEXTENSION_CALL_ERROR_INVALID_METHOD;
+    return;
+  }
+
+  // `r_return` is a nil Variant, nothing to destroy before overwriting it
+  tiny_value_to_variant(&result, r_return);
+  r_error->error = GDEXTENSION_CALL_OK;
+}
+
+void tiny_instance_notification(GDExtensionScriptInstanceDataPtr p_instance, int32_t p_what, GDExtensionBool p_reversed) {
+  // Nothing to do, TinyScript has no `_notification`
+}
+
+GDExtensionObjectPtr tiny_instance_get_script(GDExtensionScriptInstanceDataPtr p_instance) {
+  tiny_instance_t *instance = p_instance;
+  return instance->script->godot_object;
+}
+
+GDExtensionBool tiny_instance_is_placeholder(GDExtensionScriptInstanceDataPtr p_instance) {
+  return false;
+}
+
+GDExtensionScriptLanguagePtr tiny_instance_get_language(GDExtensionScriptInstanceDataPtr p_instance) {
+  return gd_extension_helper.misc.language;
+}
+
+void tiny_instance_free(GDExtensionScriptInstanceDataPtr p_instance) {
+  tiny_instance_t *instance = p_instance;
+  tiny_program_release(instance->program);
+  destruct_string_name(instance->class_name);
+  free(instance);
+}
+
+const GDExtensionScriptInstanceInfo2 tiny_instance_info = {
+  .set_func = tiny_instance_set,
+  .get_func = tiny_instance_get,
+  .get_property_list_func = tiny_instance_get_property_list,
+  .free_property_list_func = tiny_instance_free_property_list,
+  .property_can_revert_func = NULL,
+  .property_get_revert_func = NULL,
+  .get_owner_func = NULL,
+  .get_property_state_func = NULL,
+  .get_method_list_func = NULL,
+  .free_method_list_func = NULL,
+  .get_property_type_func = NULL,
+  .has_method_func = tiny_instance_has_method,
+  .call_func = tiny_instance_call,
+  .notification_func = tiny_instance_notification,
+  .to_string_func = NULL,
+  .refcount_incremented_func = NULL,
+  .refcount_decremented_func = NULL,
+  .get_script_func = tiny_instance_get_script,
+  .is_placeholder_func = tiny_instance_is_placeholder,
+  .set_fallback_func = NULL,
+  .get_fallback_func = NULL,
+  .get_language_func = tiny_instance_get_language,
+  .free_func = tiny_instance_free,
+};
+
+GDExtensionScriptInstancePtr tiny_instance_create(tiny_script_t *script, GDExtensionObjectPtr p_owner) {
+  tiny_program_t *program = script->program;
+  if (program == NULL) return NULL;
+
+  tiny_instance_t *instance = malloc(sizeof(tiny_instance_t) + program->member_count * sizeof(tiny_value_t));
+  instance->script = script;
+  instance->program = program;
+  program->refcount++;
+  instance->owner = p_owner;
+  instance->call_depth = 0;
+
+  // The class never changes, so it's looked up once here and not per call
+  instance->class_name = malloc(IS_GODOT_64_BIT ? 8 : 4);
+  gd_extension.object_get_class_name(p_owner, gd_extension_helper.misc.p_library, instance->class_name);
+  instance->class_tag = gd_extension.classdb_get_class_tag(instance->class_name);
+
+  for (uint32_t i = 0; i < program->member_count; i++) {
+    instance->members[i] = program->members[i].initial;
+  }
+
+  return gd_extension.script_instance_create2(&tiny_instance_info, instance);
+}
+
+// ---------------------------------------------------------------------------
+// Virtual methods of TinyScript and TinyScriptLanguage
+// ---------------------------------------------------------------------------
+
+// Both classes dispatch their virtual methods through tables. Godot asks for
+// the userdata of a method once (`get_virtual_call_data_func`), we hand out
+// the table entry, and every call afterwards goes straight to it
+// (`call_virtual_with_data_func`) without comparing names again.
+
+typedef void (*tiny_virtual_func_t)(void *p_instance, const GDExtensionConstTypePtr *p_args, GDExtensionTypePtr r_ret);
+
+typedef struct {
+  const char *name;
+  tiny_virtual_func_t func;
+  GDExtensionStringNamePtr string_name;
+} tiny_virtual_t;
+
+typedef struct {
+  tiny_virtual_t *virtuals;
+  size_t count;
+} tiny_virtual_table_t;
+
+void *tiny_get_virtual_call_data(void *p_class_userdata, GDExtensionConstStringNamePtr p_name) {
+  tiny_virtual_table_t *table = p_class_userdata;
+  for (size_t i = 0; i < table->count; i++) {
+    if (string_name_eq(p_name, table->virtuals[i].string_name)) return &table->virtuals[i];
+  }
+  return NULL;
+}
+
+void
+tiny_call_virtual_with_data(
+  GDExtensionClassInstancePtr p_instance,
+  GDExtensionConstStringNamePtr p_name,
+  void *p_virtual_call_userdata,
+  const GDExtensionConstTypePtr *p_args,
+  GDExtensionTypePtr r_ret
+) {
+  const tiny_virtual_t *virtual = p_virtual_call_userdata;
+  virtual->func(p_instance, p_args, r_ret);
+}
+
+// Typed defaults for the virtuals TinyScript doesn't care about. Only
+// builtin return types (String, Array, Dictionary, Variant...) arrive
+// constructed, so for those, and for void, there's nothing to do. bool, int
+// and pointer returns are raw slots the engine reads back, they have to be
+// written.
+void tiny_virtual_nothing(void *p_instance, const GDExtensionConstTypePtr *p_args, GDExtensionTypePtr r_ret) {}
+
+void tiny_virtual_return_false(void *p_instance, const GDExtensionConstTypePtr *p_args, GDExtensionTypePtr r_ret) {
+  *(GDExtensionBool *)r_ret = false;
+}
+
+void tiny_virtual_return_zero(void *p_instance, const GDExtensionConstTypePtr *p_args, GDExtensionTypePtr r_ret) {
+  *(GDExtensionInt *)r_ret = 0;
+}
+
+// Objects (a null Ref<Script>) and raw pointers
+void tiny_virtual_return_null(void *p_instance, const GDExtensionConstTypePtr *p_args, GDExtensionTypePtr r_ret) {
+  *(void **)r_ret = NULL;
+}
+
+void tiny_virtual_return_true(void *p_instance, const GDExtensionConstTypePtr *p_args, GDExtensionTypePtr r_ret) {
+  *(GDExtensionBool *)r_ret = true;
+}
+
+// `r_ret` points to an empty String, which owns nothing, so we can construct
+// over it
+void tiny_return_string(GDExtensionTypePtr r_ret, const char *c_string) {
+  gd_extension.string_new_with_utf8_chars(r_ret, c_string);
+}
+
+void tiny_return_packed_strings(GDExtensionTypePtr r_ret, const char **c_strings, GDExtensionInt count) {
+  GDExtensionInt err;
+  const GDExtensionConstTypePtr args[] = { &count };
+  gd_extension_helper.misc.packed_string_array_resize(r_ret, args, &err, 1);
+  for (GDExtensionInt i = 0; i < count; i++) {
+    GDExtensionStringPtr element = gd_extension.packed_string_array_operator_index(r_ret, i);
+    gd_extension_helper.destructor.string(element);
+    gd_extension.string_new_with_utf8_chars(element, c_strings[i]);
+  }
+}
+
+// TinyScript (ScriptExtension)
+
+void tiny_script_can_instantiate(void *p_instance, const GDExtensionConstTypePtr *p_args, GDExtensionTypePtr r_ret) {
+  tiny_script_t *script = p_instance;
+  *(GDExtensionBool *)r_ret = script->program != NULL;
+}
+
+void tiny_script_instance_create(void *p_instance, const GDExtensionConstTypePtr *p_args, GDExtensionTypePtr r_ret) {
+  tiny_script_t *script = p_instance;
+  GDExtensionObjectPtr owner = *(const GDExtensionObjectPtr *)p_args[0];
+  *(GDExtensionScriptInstancePtr *)r_ret = tiny_instance_create(script, owner);
+}
+
+void tiny_script_get_instance_base_type(void *p_instance, const GDExtensionConstTypePtr *p_args, GDExtensionTypePtr r_ret) {
+  tiny_script_t *script = p_instance;
+  gd_extension.string_name_new_with_utf8_chars(r_ret, script->program != NULL ? script->program->base_type : "Object");
+}
+
+void tiny_script_get_source_code(void *p_instance, const GDExtensionConstTypePtr *p_args, GDExtensionTypePtr r_ret) {
+  tiny_script_t *script = p_instance;
+  tiny_return_string(r_ret, script->source);
+}
+
+void tiny_script_set_source_code(void *p_instance, const GDExtensionConstTypePtr *p_args, GDExtensionTypePtr r_ret) {
+  tiny_script_t *script = p_instance;
+  free(script->source);
+  script->source = string_to_c_string(p_args[0]);
+}
+
+void tiny_script_reload(void *p_instance, const GDExtensionConstTypePtr *p_args, GDExtensionTypePtr r_ret) {
+  tiny_script_t *script = p_instance;
+  char error[TINY_ERROR_SIZE];
+
+  tiny_program_release(script->program);
+  script->program = tiny_compile(script->source, error);
+  if (script->program == NULL) {
+    fprintf(stderr, "TinyScript: %s\n", error);
+  }
+  *(GDExtensionInt *)r_ret = script->program != NULL ? GODOT_OK : GODOT_ERR_PARSE_ERROR;
+}
+
+void tiny_script_has_method(void *p_instance, const GDExtensionConstTypePtr *p_args, GDExtensionTypePtr r_ret) {
+  tiny_script_t *script = p_instance;
+  GDExtensionBool res = false;
+  for (uint32_t i = 0; script->program != NULL && i < script->program->function_count; i++) {
+    if (string_name_eq(p_args[0], script->program->functions[i].string_name)) res = true;
+  }
+  *(GDExtensionBool *)r_ret = res;
+}
+
+void tiny_script_get_language(void *p_instance, const GDExtensionConstTypePtr *p_args, GDExtensionTypePtr r_ret) {
+  *(GDExtensionObjectPtr *)r_ret = gd_extension_helper.misc.language;
+}
+
+tiny_virtual_t tiny_script_virtuals[] = {
+  { "_can_instantiate", tiny_script_can_instantiate },
+  { "_instance_create", tiny_script_instance_create },
+  { "_get_instance_base_type", tiny_script_get_instance_base_type },
+  { "_has_source_code", tiny_virtual_return_true },
+  { "_get_source_code", tiny_script_get_source_code },
+  { "_set_source_code", tiny_script_set_source_code },
+  { "_reload", tiny_script_reload },
+  { "_has_method", tiny_script_has_method },
+  { "_is_valid", tiny_script_can_instantiate },
+  { "_get_language", tiny_script_get_language },
+  { "_is_tool", tiny_virtual_return_false },
+  { "_editor_can_reload_from_file", tiny_virtual_return_false },
+  { "_placeholder_instance_create", tiny_virtual_return_null },
+  { "_instance_has", tiny_virtual_return_false },
+  { "_get_base_script", tiny_virtual_return_null },
+  { "_get_global_name", tiny_virtual_nothing },
+  { "_inherits_script", tiny_virtual_return_false },
+  { "_get_documentation", tiny_virtual_nothing },
+  { "_get_method_info", tiny_virtual_nothing },
+  { "_has_script_signal", tiny_virtual_return_false },
+  { "_get_script_signal_list", tiny_virtual_nothing },
+  { "_has_property_default_value", tiny_virtual_return_false },
+  { "_get_property_default_value", tiny_virtual_nothing },
+  { "_update_exports", tiny_virtual_nothing },
+  { "_get_script_method_list", tiny_virtual_nothing },
+  { "_get_script_property_list", tiny_virtual_nothing },
+  { "_get_member_line", tiny_virtual_return_zero },
+  { "_get_constants", tiny_virtual_nothing },
+  { "_get_members", tiny_virtual_nothing },
+  { "_is_placeholder_fallback_enabled", tiny_virtual_return_false },
+  { "_get_rpc_config", tiny_virtual_nothing },
+};
+
+tiny_virtual_table_t tiny_script_virtual_table = {
+  .virtuals = tiny_script_virtuals,
+  .count = sizeof(tiny_script_virtuals) / sizeof(*tiny_script_virtuals),
+};
+
+// TinyScriptLanguage (ScriptLanguageExtension)
+
+const char *tiny_reserved_words[] = {
+  "extends", "var", "func", "end", "if", "else", "while", "return", "true", "false", "and", "or", "not",
+};
+
+void tiny_language_get_name(void *p_instance, const GDExtensionConstTypePtr *p_args, GDExtensionTypePtr r_ret) {
+  tiny_return_string(r_ret, TINY_LANGUAGE_NAME);
+}
+
+void tiny_language_get_type(void *p_instance, const GDExtensionConstTypePtr *p_args, GDExtensionTypePtr r_ret) {
+  tiny_return_string(r_ret, SCRIPT_CLASS_NAME);
+}
+
+void tiny_language_get_extension(void *p_instance, const GDExtensionConstTypePtr *p_args, GDExtensionTypePtr r_ret) {
+  tiny_return_string(r_ret, TINY_FILE_EXTENSION);
+}
+
+void tiny_language_get_recognized_extensions(void *p_instance, const GDExtensionConstTypePtr *p_args, GDExtensionTypePtr r_ret) {
+  const char *extensions[] = { TINY_FILE_EXTENSION };
+  tiny_return_packed_strings(r_ret, extensions, 1);
+}
+
+void tiny_language_get_reserved_words(void *p_instance, const GDExtensionConstTypePtr *p_args, GDExtensionTypePtr r_ret) {
+  tiny_return_packed_strings(r_ret, tiny_reserved_words, sizeof(tiny_reserved_words) / sizeof(*tiny_reserved_words));
+}
+
+void tiny_language_get_comment_delimiters(void *p_instance, const GDExtensionConstTypePtr *p_args, GDExtensionTypePtr r_ret) {
+  const char *delimiters[] = { "#" };
+  tiny_return_packed_strings(r_ret, delimiters, 1);
+}
+
+void tiny_language_create_script(void *p_instance, const GDExtensionConstTypePtr *p_args, GDExtensionTypePtr r_ret) {
+  void *script_class_string_name = construct_string_name(SCRIPT_CLASS_NAME);
+  *(GDExtensionObjectPtr *)r_ret = gd_extension.classdb_construct_object(script_class_string_name);
+  destruct_string_name(script_class_string_name);
+}
+
+tiny_virtual_t tiny_language_virtuals[] = {
+  { "_get_name", tiny_language_get_name },
+  { "_get_type", tiny_language_get_type },
+  { "_get_extension", tiny_language_get_extension },
+  { "_get_recognized_extensions", tiny_language_get_recognized_extensions },
+  { "_get_reserved_words", tiny_language_get_reserved_words },
+  { "_get_comment_delimiters", tiny_language_get_comment_delimiters },
+  { "_create_script", tiny_language_create_script },
+  { "_init", tiny_virtual_nothing },
+  { "_finish", tiny_virtual_nothing },
+  { "_frame", tiny_virtual_nothing },
+  { "_thread_enter", tiny_virtual_nothing },
+  { "_thread_exit", tiny_virtual_nothing },
+  { "_get_string_delimiters", tiny_virtual_nothing },
+  { "_is_control_flow_keyword", tiny_virtual_return_false },
+  { "_make_template", tiny_virtual_return_null },
+  { "_get_built_in_templates", tiny_virtual_nothing },
+  { "_is_using_templates", tiny_virtual_return_false },
+  { "_validate", tiny_virtual_nothing },
+  { "_validate_path", tiny_virtual_nothing },
+  { "_has_named_classes", tiny_virtual_return_false },
+  { "_supports_builtin_mode", tiny_virtual_return_false },
+  { "_supports_documentation", tiny_virtual_return_false },
+  { "_can_inherit_from_file", tiny_virtual_return_false },
+  { "_find_function", tiny_virtual_return_zero },
+  { "_make_function", tiny_virtual_nothing },
+  { "_open_in_external_editor", tiny_virtual_return_zero },
+  { "_overrides_external_editor", tiny_virtual_return_false },
+  { "_complete_code", tiny_virtual_nothing },
+  { "_lookup_code", tiny_virtual_nothing },
+  { "_auto_indent_code", tiny_virtual_nothing },
+  { "_add_global_constant", tiny_virtual_nothing },
+  { "_add_named_global_constant", tiny_virtual_nothing },
+  { "_remove_named_global_constant", tiny_virtual_nothing },
+  { "_debug_get_error", tiny_virtual_nothing },
+  { "_debug_get_stack_level_count", tiny_virtual_return_zero },
+  { "_debug_get_stack_level_line", tiny_virtual_return_zero },
+  { "_debug_get_stack_level_function", tiny_virtual_nothing },
+  { "_debug_get_stack_level_locals", tiny_virtual_nothing },
+  { "_debug_get_stack_level_members", tiny_virtual_nothing },
+  { "_debug_get_stack_level_instance", tiny_virtual_return_null },
+  { "_debug_get_globals", tiny_virtual_nothing },
+  { "_debug_parse_stack_level_expression", tiny_virtual_nothing },
+  { "_debug_get_current_stack_info", tiny_virtual_nothing },
+  { "_reload_all_scripts", tiny_virtual_nothing },
+  { "_reload_tool_script", tiny_virtual_nothing },
+  { "_get_public_functions", tiny_virtual_nothing },
+  { "_get_public_constants", tiny_virtual_nothing },
+  { "_get_public_annotations", tiny_virtual_nothing },
+  { "_profiling_start", tiny_virtual_nothing },
+  { "_profiling_stop", tiny_virtual_nothing },
+  { "_profiling_get_accumulated_data", tiny_virtual_return_zero },
+  { "_profiling_get_frame_data", tiny_virtual_return_zero },
+  { "_handles_global_class_type", tiny_virtual_return_false },
+  { "_get_global_class_name", tiny_virtual_nothing },
+};
+
+tiny_virtual_table_t tiny_language_virtual_table = {
+  .virtuals = tiny_language_virtuals,
+  .count = sizeof(tiny_language_virtuals) / sizeof(*tiny_language_virtuals),
+};
+
+void tiny_virtual_table_init(tiny_virtual_table_t *table) {
+  for (size_t i = 0; i < table->count; i++) {
+    table->virtuals[i].string_name = construct_string_name(table->virtuals[i].name);
+  }
+}
+
+void tiny_virtual_table_deinit(tiny_virtual_table_t *table) {
+  for (size_t i = 0; i < table->count; i++) {
+    destruct_string_name(table->virtuals[i].string_name);
+  }
+}
+
+// ---------------------------------------------------------------------------
+// Classes
+// ---------------------------------------------------------------------------
+
+GDExtensionObjectPtr tiny_script_init(void *userdata) {
+  tiny_script_t *script = malloc(sizeof(tiny_script_t));
+
+  void *my_class_string_name = construct_string_name(SCRIPT_CLASS_NAME);
+  void *parent_class_string_name = construct_string_name(SCRIPT_CLASS_PARENT);
+
+  script->godot_object = gd_extension.classdb_construct_object(parent_class_string_name);
+  script->source = calloc(1, 1);
+  script->program = NULL;
+  gd_extension.object_set_instance(script->godot_object, my_class_string_name, script);
+
+  destruct_string_name(my_class_string_name);
+  destruct_string_name(parent_class_string_name);
+
+  return script->godot_object;
+}
+
+void tiny_script_deinit(void *userdata, GDExtensionClassInstancePtr p_instance) {
+  if (p_instance == NULL) return;
+
+  tiny_script_t *script = p_instance;
+  tiny_program_release(script->program);
+  free(script->source);
+  free(script);
+}
+
+// The language has no state of its own, the instance only remembers its object
+GDExtensionObjectPtr tiny_language_init(void *userdata) {
+  GDExtensionObjectPtr *language = malloc(sizeof(GDExtensionObjectPtr));
+
+  void *my_class_string_name = construct_string_name(LANGUAGE_CLASS_NAME);
+  void *parent_class_string_name = construct_string_name(LANGUAGE_CLASS_PARENT);
+
+  *language = gd_extension.classdb_construct_object(parent_class_string_name);
+  gd_extension.object_set_instance(*language, my_class_string_name, language);
+
+  destruct_string_name(my_class_string_name);
+  destruct_string_name(parent_class_string_name);
+
+  return *language;
+}
+
+void tiny_language_deinit(void *userdata, GDExtensionClassInstancePtr p_instance) {
+  free(p_instance);
+}
+
+void
+register_tiny_class(
+  const char *class_name,
+  const char *parent_class_name,
+  GDExtensionClassCreateInstance create_instance_func,
+  GDExtensionClassFreeInstance free_instance_func,
+  tiny_virtual_table_t *virtual_table
+) {
+  GDExtensionClassCreationInfo2 class_info = {
+    .is_virtual = false,
+    .is_abstract = false,
+    .is_exposed = true,
+    .set_func = NULL,
+    .get_func = NULL,
+    .get_property_list_func = NULL,
+    .free_property_list_func = NULL,
+    .property_can_revert_func = NULL,
+    .property_get_revert_func = NULL,
+    .validate_property_func = NULL,
+    .notification_func = NULL,
+    .to_string_func = NULL,
+    .reference_func = NULL,
+    .unreference_func = NULL,
+    .create_instance_func = create_instance_func,
+    .free_instance_func = free_instance_func,
+    .recreate_instance_func = NULL,
+    .get_virtual_func = NULL,
+    .get_virtual_call_data_func = tiny_get_virtual_call_data,
+    .call_virtual_with_data_func = tiny_call_virtual_with_data,
+    .get_rid_func = NULL,
+    .class_userdata = virtual_table,
+  };
+
+  void *my_class_string_name = construct_string_name(class_name);
+  void *parent_class_string_name = construct_string_name(parent_class_name);
+
+  gd_extension.classdb_register_extension_class2(gd_extension_helper.misc.p_library,
+                                                 my_class_string_name,
+                                                 parent_class_string_name,
+                                                 &class_info);
+
+  destruct_string_name(my_class_string_name);
+  destruct_string_name(parent_class_string_name);
+}
+
+// `Engine.register_script_language` and `unregister_script_language`. They
+// are called once, so a Variant call is good enough.
+void engine_call_with_language(const char *method) {
+  void *engine_string_name = construct_string_name("Engine");
+  void *method_string_name = construct_string_name(method);
+  GDExtensionObjectPtr engine = gd_extension.global_get_singleton(engine_string_name);
+
+  uint8_t engine_variant[VARIANT_SIZE];
+  uint8_t language_variant[VARIANT_SIZE];
+  uint8_t ret[VARIANT_SIZE];
+  gd_extension_helper.wrap.type_object(engine_variant, &engine);
+  gd_extension_helper.wrap.type_object(language_variant, &gd_extension_helper.misc.language);
+
+  const GDExtensionConstVariantPtr args[] = { language_variant };
+  GDExtensionCallError error;
+  gd_extension.variant_call(engine_variant, method_string_name, args, 1, ret, &error);
+
+  GDExtensionInt err = -1;
+  if (error.error == GDEXTENSION_CALL_OK) {
+    gd_extension_helper.unwrap.type_int(&err, ret);
+  }
+  if (err != GODOT_OK) {
+    fprintf(stderr, "Engine.%s failed (call error %d, error %ld)\n", method, error.error, (long)err);
+  }
+
+  gd_extension.variant_destroy(ret);
+  gd_extension.variant_destroy(language_variant);
+  gd_extension.variant_destroy(engine_variant);
+  destruct_string_name(engine_string_name);
+  destruct_string_name(method_string_name);
+}
+
+uint64_t now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+const char *tiny_benchmark_source =
+  "extends Object\n"
+  "func sum_to(n)\n"
+  "  var total = 0\n"
+  "  var i = 0\n"
+  "  while i < n\n"
+  "    total = total + i\n"
+  "    i = i + 1\n"
+  "  end\n"
+  "  return total\n"
+  "end\n";
+
+// The same loop with every operation boxed into Variants and dispatched by
+// `variant_evaluate`, which is what TinyScript's registers avoid
+int64_t tiny_benchmark_boxed_sum_to(int64_t n) {
+  uint8_t total[VARIANT_SIZE];
+  uint8_t i[VARIANT_SIZE];
+  uint8_t limit[VARIANT_SIZE];
+  uint8_t one[VARIANT_SIZE];
+  uint8_t tmp[VARIANT_SIZE];
+  int64_t zero_value = 0;
+  int64_t one_value = 1;
+  gd_extension_helper.wrap.type_int(total, &zero_value);
+  gd_extension_helper.wrap.type_int(i, &zero_value);
+  gd_extension_helper.wrap.type_int(limit, &n);
+  gd_extension_helper.wrap.type_int(one, &one_value);
+
+  // Int Variants own nothing, so results are copied over without destroying
+  GDExtensionBool valid;
+  for (;;) {
+    GDExtensionBool less;
+    gd_extension.variant_evaluate(GDEXTENSION_VARIANT_OP_LESS, i, limit, tmp, &valid);
+    gd_extension_helper.unwrap.type_bool(&less, tmp);
+    if (!less) break;
+    gd_extension.variant_evaluate(GDEXTENSION_VARIANT_OP_ADD, total, i, tmp, &valid);
+    memcpy(total, tmp, VARIANT_SIZE);
+    gd_extension.variant_evaluate(GDEXTENSION_VARIANT_OP_ADD, i, one, tmp, &valid);
+    memcpy(i, tmp, VARIANT_SIZE);
+  }
+
+  int64_t res;
+  gd_extension_helper.unwrap.type_int(&res, total);
+  return res;
+}
+
+const char *gdscript_benchmark_source =
+  "static func sum_to(n):\n"
+  "\tvar total = 0\n"
+  "\tvar i = 0\n"
+  "\twhile i < n:\n"
+  "\t\ttotal = total + i\n"
+  "\t\ti = i + 1\n"
+  "\treturn total\n";
+
+// Calls `method` on the Variant and checks the call went through
+bool gdscript_benchmark_call(GDExtensionVariantPtr p_self,
+                             const char *method,
+                             const GDExtensionConstVariantPtr *p_args,
+                             GDExtensionInt p_arg_count,
+                             GDExtensionUninitializedVariantPtr r_ret) {
+  void *method_string_name = construct_string_name(method);
+  GDExtensionCallError error;
+  gd_extension.variant_call(p_self, method_string_name, p_args, p_arg_count, r_ret, &error);
+  destruct_string_name(method_string_name);
+  if (error.error != GDEXTENSION_CALL_OK) {
+    fprintf(stderr, "GDScript benchmark: %s failed (call error %d)\n", method, error.error);
+    return false;
+  }
+  return true;
+}
+
+// The same `sum_to` in GDScript, made the way a script does it with
+// `GDScript.new()`, `source_code` and `reload()`. It's static, so it's called
+// on the script itself and needs no instance. Returns false when GDScript
+// isn't there (a build without the module) or something fails on the way.
+bool gdscript_benchmark_sum_to(int64_t n, int64_t *r_total, uint64_t *r_ns) {
+  void *class_string_name = construct_string_name("GDScript");
+  GDExtensionObjectPtr script = gd_extension.classdb_construct_object(class_string_name);
+  destruct_string_name(class_string_name);
+  if (script == NULL) return false;
+
+  // The Variant holds the only reference, destroying it frees the script
+  uint8_t script_variant[VARIANT_SIZE];
+  uint8_t source_variant[VARIANT_SIZE];
+  uint8_t n_variant[VARIANT_SIZE];
+  uint8_t ret[VARIANT_SIZE];
+  gd_extension_helper.wrap.type_object(script_variant, &script);
+  GDExtensionStringPtr source = construct_string(gdscript_benchmark_source);
+  gd_extension_helper.wrap.type_string(source_variant, source);
+  destruct_string(source);
+  gd_extension_helper.wrap.type_int(n_variant, &n);
+
+  const GDExtensionConstVariantPtr source_args[] = { source_variant };
+  bool ok = gdscript_benchmark_call(script_variant, "set_source_code", source_args, 1, ret);
+  if (ok) gd_extension.variant_destroy(ret);
+
+  GDExtensionInt err = -1;
+  if (ok && gdscript_benchmark_call(script_variant, "reload", NULL, 0, ret)) {
+    gd_extension_helper.unwrap.type_int(&err, ret);
+    gd_extension.variant_destroy(ret);
+  }
+  ok = err == GODOT_OK;
+
+  if (ok) {
+    const GDExtensionConstVariantPtr sum_args[] = { n_variant };
+    uint64_t start = now_ns();
+    ok = gdscript_benchmark_call(script_variant, "sum_to", sum_args, 1, ret);
+    *r_ns = now_ns() - start;
+    if (ok) {
+      ok = gd_extension.variant_get_type(ret) == GDEXTENSION_VARIANT_TYPE_INT;
+      if (ok) gd_extension_helper.unwrap.type_int(r_total, ret);
+      gd_extension.variant_destroy(ret);
+    }
+  }
+
+  gd_extension.variant_destroy(n_variant);
+  gd_extension.variant_destroy(source_variant);
+  gd_extension.variant_destroy(script_variant);
+  return ok;
+}
+
+// Runs `sum_to` compiled by TinyScript and by GDScript, boxed through
+// Variants and as plain C, and prints how long each one took
+void print_interpreter_benchmark() {
+  char error[TINY_ERROR_SIZE];
+  tiny_program_t *program = tiny_compile(tiny_benchmark_source, error);
+  if (program == NULL) {
+    fprintf(stderr, "TinyScript benchmark: %s\n", error);
+    return;
+  }
+
+  // `sum_to` never touches its owner, so the instance doesn't need one
+  tiny_instance_t *instance = calloc(1, sizeof(tiny_instance_t));
+  instance->program = program;
+  const tiny_function_t *function = &program->functions[0];
+
+  int64_t n = TINY_BENCHMARK_ITERATIONS;
+  tiny_value_t arg = { .type = TINY_INT, .i = n };
+  tiny_value_t result = { .type = TINY_NIL };
+
+  uint64_t start = now_ns();
+  bool ok = tiny_call_function(instance, function, &arg, 1, &result);
+  uint64_t vm_ns = now_ns() - start;
+
+  int64_t gdscript_total = 0;
+  uint64_t gdscript_ns = 0;
+  bool gdscript_ok = gdscript_benchmark_sum_to(n, &gdscript_total, &gdscript_ns);
+
+  start = now_ns();
+  int64_t boxed_total = tiny_benchmark_boxed_sum_to(n);
+  uint64_t boxed_ns = now_ns() - start;
+
+  // `volatile` keeps the compiler from replacing the loop with n * (n - 1) / 2
+  start = now_ns();
+  volatile int64_t native_total = 0;
+  for (int64_t i = 0; i < n; i++) {
+    native_total = native_total + i;
+  }
+  uint64_t native_ns = now_ns() - start;
+
+  bool same = ok && result.type == TINY_INT && result.i == native_total && boxed_total == native_total
+              && (!gdscript_ok || gdscript_total == native_total);
+  char gdscript_time[32] = "n/a";
+  if (gdscript_ok) snprintf(gdscript_time, sizeof(gdscript_time), "%.1f ns", (double)gdscript_ns / n);
+  printf("sum_to(%ld): TinyScript %.1f ns, GDScript %s, boxed Variants %.1f ns, native C %.1f ns per iteration (%s)\n",
+         (long)n,
+         (double)vm_ns / n,
+         gdscript_time,
+         (double)boxed_ns / n,
+         (double)native_ns / n,
+         same ? "same totals" : "DIFFERENT totals");
+
+  free(instance);
+  tiny_program_release(program);
+}
+
+void godot_initialize(void *userdata, GDExtensionInitializationLevel p_level) {
+  if (p_level == GDEXTENSION_INITIALIZATION_SCENE) {
+    tiny_virtual_table_init(&tiny_script_virtual_table);
+    tiny_virtual_table_init(&tiny_language_virtual_table);
+
+    void *resize_string_name = construct_string_name("resize");
+    gd_extension_helper.misc.packed_string_array_resize
+      = gd_extension.variant_get_ptr_builtin_method(GDEXTENSION_VARIANT_TYPE_PACKED_STRING_ARRAY,
+                                                    resize_string_name,
+                                                    848867239);
+    destruct_string_name(resize_string_name);
+
+    register_tiny_class(SCRIPT_CLASS_NAME,
+                        SCRIPT_CLASS_PARENT,
+                        tiny_script_init,
+                        tiny_script_deinit,
+                        &tiny_script_virtual_table);
+    register_tiny_class(LANGUAGE_CLASS_NAME,
+                        LANGUAGE_CLASS_PARENT,
+                        tiny_language_init,
+                        tiny_language_deinit,
+                        &tiny_language_virtual_table);
+
+    void *language_string_name = construct_string_name(LANGUAGE_CLASS_NAME);
+    gd_extension_helper.misc.language = gd_extension.classdb_construct_object(language_string_name);
+    destruct_string_name(language_string_name);
+
+    engine_call_with_language("register_script_language");
+    print_interpreter_benchmark();
+    return;
+  }
+}
+
+void godot_deinitialize(void *userdata, GDExtensionInitializationLevel p_level) {
+  if (p_level == GDEXTENSION_INITIALIZATION_SCENE) {
+    engine_call_with_language("unregister_script_language");
+    gd_extension.object_destroy(gd_extension_helper.misc.language);
+    gd_extension_helper.misc.language = NULL;
+
+    tiny_virtual_table_deinit(&tiny_script_virtual_table);
+    tiny_virtual_table_deinit(&tiny_language_virtual_table);
+  }
+}
+
+GDExtensionBool
+godot_entry(
+  GDExtensionInterfaceGetProcAddress p_get_proc_address,
+  const GDExtensionClassLibraryPtr p_library,
+  GDExtensionInitialization *r_initialization
+) {
+  r_initialization->minimum_initialization_level = GDEXTENSION_INITIALIZATION_SCENE;
+  r_initialization->userdata = NULL;
+  r_initialization->initialize = godot_initialize;
+  r_initialization->deinitialize = godot_deinitialize;
+
+  STORE_GD_EXTENSION(classdb_construct_object);
+  STORE_GD_EXTENSION(classdb_register_extension_class2);
+  STORE_GD_EXTENSION(classdb_get_method_bind);
+  STORE_GD_EXTENSION(classdb_get_class_tag);
+  STORE_GD_EXTENSION(string_name_new_with_utf8_chars);
+  STORE_GD_EXTENSION(string_new_with_utf8_chars);
+  STORE_GD_EXTENSION(string_to_utf8_chars);
+  STORE_GD_EXTENSION(object_set_instance);
+  STORE_GD_EXTENSION(object_destroy);
+  STORE_GD_EXTENSION(object_get_class_name);
+  STORE_GD_EXTENSION(object_method_bind_ptrcall);
+  STORE_GD_EXTENSION(global_get_singleton);
+  STORE_GD_EXTENSION(script_instance_create2);
+  STORE_GD_EXTENSION(variant_get_ptr_destructor);
+  STORE_GD_EXTENSION(variant_get_ptr_operator_evaluator);
+  STORE_GD_EXTENSION(variant_get_ptr_builtin_method);
+  STORE_GD_EXTENSION(get_variant_from_type_constructor);
+  STORE_GD_EXTENSION(get_variant_to_type_constructor);
+  STORE_GD_EXTENSION(variant_get_type);
+  STORE_GD_EXTENSION(variant_new_nil);
+  STORE_GD_EXTENSION(variant_destroy);
+  STORE_GD_EXTENSION(variant_call);
+  STORE_GD_EXTENSION(variant_evaluate);
+  STORE_GD_EXTENSION(variant_get_named);
+  STORE_GD_EXTENSION(variant_set_named);
+  STORE_GD_EXTENSION(packed_string_array_operator_index);
+
+  gd_extension_helper.destructor.string_name
+    = gd_extension.variant_get_ptr_destructor(GDEXTENSION_VARIANT_TYPE_STRING_NAME);
+  gd_extension_helper.destructor.string
+    = gd_extension.variant_get_ptr_destructor(GDEXTENSION_VARIANT_TYPE_STRING);
+
+  gd_extension_helper.wrap.type_bool
+    = gd_extension.get_variant_from_type_constructor(GDEXTENSION_VARIANT_TYPE_BOOL);
+  gd_extension_helper.wrap.type_int
+    = gd_extension.get_variant_from_type_constructor(GDEXTENSION_VARIANT_TYPE_INT);
+  gd_extension_helper.wrap.type_double
+    = gd_extension.get_variant_from_type_constructor(GDEXTENSION_VARIANT_TYPE_FLOAT);
+  gd_extension_helper.wrap.type_vector2
+    = gd_extension.get_variant_from_type_constructor(GDEXTENSION_VARIANT_TYPE_VECTOR2);
+  gd_extension_helper.wrap.type_object
+    = gd_extension.get_variant_from_type_constructor(GDEXTENSION_VARIANT_TYPE_OBJECT);
+  gd_extension_helper.wrap.type_string
+    = gd_extension.get_variant_from_type_constructor(GDEXTENSION_VARIANT_TYPE_STRING);
+
+  gd_extension_helper.unwrap.type_bool
+    = gd_extension.get_variant_to_type_constructor(GDEXTENSION_VARIANT_TYPE_BOOL);
+  gd_extension_helper.unwrap.type_int
+    = gd_extension.get_variant_to_type_constructor(GDEXTENSION_VARIANT_TYPE_INT);
+  gd_extension_helper.unwrap.type_double
+    = gd_extension.get_variant_to_type_constructor(GDEXTENSION_VARIANT_TYPE_FLOAT);
+  gd_extension_helper.unwrap.type_vector2
+    = gd_extension.get_variant_to_type_constructor(GDEXTENSION_VARIANT_TYPE_VECTOR2);
+
+  gd_extension_helper.misc.p_library = p_library;
+  gd_extension_helper.misc.string_name_eq_op
+    = gd_extension.variant_get_ptr_operator_evaluator(GDEXTENSION_VARIANT_OP_EQUAL,
+                                                      GDEXTENSION_VARIANT_TYPE_STRING_NAME,
+                                                      GDEXTENSION_VARIANT_TYPE_STRING_NAME);
+
+  return true;
+}
@@ -0,0 +1,195 @@
+#include "../godot-headers/gdextension_interface.h"
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define STORE_GD_EXTENSION(str_name) gd_extension.str_name = (void *)p_get_proc_address(#str_name);
+#define IS_GODOT_64_BIT (true)
+#define BENCHMARK_STRING_COUNT (100000)
+#define LONG_TEXT_REPEAT (2000)
+
+#include "../util/gd_string.h"
+
+struct {
+  GDExtensionInterfaceStringNewWithUtf8Chars string_new_with_utf8_chars;
+  GDExtensionInterfaceVariantGetPtrDestructor variant_get_ptr_destructor;
+} gd_extension;
+
+struct {
+  struct {
+    GDExtensionPtrDestructor string;
+  } destructor;
+} gd_extension_helper;
+
+uint64_t now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+void print_construction_benchmark() {
+  uint8_t string[IS_GODOT_64_BIT ? 8 : 4];
+
+  uint64_t start = now_ns();
+  for (int i = 0; i < BENCHMARK_STRING_COUNT; i++) {
+    gd_extension.string_new_with_utf8_chars(string, "The example was successful.");
+    gd_extension_helper.destructor.string(string);
+  }
+  uint64_t utf8_ns = now_ns() - start;
+
+  start = now_ns();
+  for (int i = 0; i < BENCHMARK_STRING_COUNT; i++) {
+    GD_STRING_NEW_LITERAL(string, "The example was successful.");
+    gd_extension_helper.destructor.string(string);
+  }
+  uint64_t latin1_ns = now_ns() - start;
+
+  uintptr_t checksum = 0;
+  start = now_ns();
+  for (int i = 0; i < BENCHMARK_STRING_COUNT; i++) {
+    checksum += (uintptr_t)GD_STRING_CACHED("The example was successful.");
+  }
+  uint64_t cached_ns = now_ns() - start;
+
+  printf("ASCII literal to String: utf8 %.1f ns, latin1 %.1f ns, cached %.1f ns (%s)\n",
+         (double)utf8_ns / BENCHMARK_STRING_COUNT,
+         (double)latin1_ns / BENCHMARK_STRING_COUNT,
+         (double)cached_ns / BENCHMARK_STRING_COUNT,
+         checksum != 0 ? "ok" : "?");
+}
+
+// Both are "Grüße, Godot!", the first is decoded by Godot, the second by the
+// compiler
+void print_non_ascii_literals() {
+  uint8_t from_utf8[IS_GODOT_64_BIT ? 8 : 4];
+  uint8_t from_utf32[IS_GODOT_64_BIT ? 8 : 4];
+  GD_STRING_NEW_LITERAL(from_utf8, "Grüße, Godot!");
+  GD_STRING_NEW_UTF32(from_utf32, "Grüße, Godot!");
+
+  gd_string_view_t a = gd_string_view(from_utf8);
+  gd_string_view_t b = gd_string_view(from_utf32);
+  bool same = a.length == b.length;
+  for (int64_t i = 0; same && i < a.length; i++) {
+    same = a.data[i] == b.data[i];
+  }
+  printf("non-ASCII literal: %ld characters, UTF-8 and UTF-32 versions %s\n",
+         (long)a.length,
+         same ? "match" : "DIFFER");
+
+  gd_extension_helper.destructor.string(from_utf8);
+  gd_extension_helper.destructor.string(from_utf32);
+}
+
+int64_t count_words_in_utf8_copy(GDExtensionConstStringPtr text) {
+  char *utf8 = gd_string_utf8_copy(text, NULL);
+  int64_t res = 0;
+  bool in_word = false;
+  for (char *p = utf8; *p != '\0'; p++) {
+    bool space = *p == ' ';
+    if (!space && !in_word) res++;
+    in_word = !space;
+  }
+  free(utf8);
+  return res;
+}
+
+int64_t count_words_in_view(GDExtensionConstStringPtr text) {
+  gd_string_view_t view = gd_string_view(text);
+  int64_t res = 0;
+  bool in_word = false;
+  GD_STRING_VIEW_FOREACH(view, ch) {
+    bool space = *ch == ' ';
+    if (!space && !in_word) res++;
+    in_word = !space;
+  }
+  return res;
+}
+
+// Same as `gd_string_view_find` from 0, written with GD_STRING_VIEW_FOREACH
+// to check that `break` leaves the whole loop
+int64_t find_with_foreach(gd_string_view_t view, char32_t p_char) {
+  int64_t res = -1;
+  int64_t visited = 0;
+  GD_STRING_VIEW_FOREACH(view, ch) {
+    if (*ch == p_char) {
+      res = ch - view.data;
+      break;
+    }
+    visited++;
+  }
+  return visited == res ? res : -2;
+}
+
+void print_view_benchmark() {
+  const char *sentence = "the quick brown fox jumps over the lazy dog ";
+  size_t sentence_length = strlen(sentence);
+  char *long_text = malloc(sentence_length * LONG_TEXT_REPEAT + 1);
+  for (int i = 0; i < LONG_TEXT_REPEAT; i++) {
+    memcpy(long_text + i * sentence_length, sentence, sentence_length);
+  }
+  long_text[sentence_length * LONG_TEXT_REPEAT] = '\0';
+
+  uint8_t text[IS_GODOT_64_BIT ? 8 : 4];
+  gd_string_new(text, long_text, sentence_length * LONG_TEXT_REPEAT);
+  free(long_text);
+
+  uint64_t start = now_ns();
+  int64_t copy_words = count_words_in_utf8_copy(text);
+  uint64_t copy_ns = now_ns() - start;
+
+  start = now_ns();
+  int64_t view_words = count_words_in_view(text);
+  uint64_t view_ns = now_ns() - start;
+
+  gd_string_view_t view = gd_string_view(text);
+  gd_string_view_t first_word = gd_string_view_slice(view, 0, gd_string_view_find(view, ' ', 0));
+  printf("%ld/%ld words: UTF-8 copy %.1f us, view %.1f us, first word is \"the\": %s, break stops at the first space: %s\n",
+         (long)copy_words,
+         (long)view_words,
+         copy_ns / 1000.0,
+         view_ns / 1000.0,
+         gd_string_view_equals_ascii(first_word, "the") ? "yes" : "no",
+         find_with_foreach(view, ' ') == gd_string_view_find(view, ' ', 0) ? "yes" : "no");
+
+  gd_extension_helper.destructor.string(text);
+}
+
+void godot_initialize(void *userdata, GDExtensionInitializationLevel p_level) {
+  if (p_level == GDEXTENSION_INITIALIZATION_SCENE) {
+    print_construction_benchmark();
+    print_non_ascii_literals();
+    print_view_benchmark();
+    return;
+  }
+}
+
+void godot_deinitialize(void *userdata, GDExtensionInitializationLevel p_level) {
+  if (p_level == GDEXTENSION_INITIALIZATION_SCENE) {
+    gd_string_cache_clear();
+  }
+}
+
+GDExtensionBool
+godot_entry(
+  GDExtensionInterfaceGetProcAddress p_get_proc_address,
+  const GDExtensionClassLibraryPtr _p_library,
+  GDExtensionInitialization *r_initialization
+) {
+  r_initialization->minimum_initialization_level = GDEXTENSION_INITIALIZATION_SCENE;
+  r_initialization->userdata = NULL;
+  r_initialization->initialize = godot_initialize;
+  r_initialization->deinitialize = godot_deinitialize;
+
+  STORE_GD_EXTENSION(string_new_with_utf8_chars);
+  STORE_GD_EXTENSION(variant_get_ptr_destructor);
+
+  gd_extension_helper.destructor.string
+    = gd_extension.variant_get_ptr_destructor(GDEXTENSION_VARIANT_TYPE_STRING);
+
+  gd_string_init(p_get_proc_address);
+
+  return true;
+}
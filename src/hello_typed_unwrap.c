@@ -0,0 +1,271 @@
+#include "../godot-headers/gdextension_interface.h"
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define STORE_GD_EXTENSION(str_name) gd_extension.str_name = (void *)p_get_proc_address(#str_name);
+#define IS_GODOT_64_BIT (true)
+#define IS_GODOT_USING_LARGE_WORLD_COORDINATES (false)
+#define VARIANT_SIZE (IS_GODOT_USING_LARGE_WORLD_COORDINATES ? 40 : 24)
+#define INPUT_COUNT (1024)
+#define BENCHMARK_ROUNDS (200)
+
+#include "../util/variant_unwrap.h"
+#include "../util/gd_string.h"
+
+struct {
+  GDExtensionInterfaceVariantGetType variant_get_type;
+  GDExtensionInterfaceVariantNewNil variant_new_nil;
+  GDExtensionInterfaceVariantDestroy variant_destroy;
+  GDExtensionInterfaceVariantConstruct variant_construct;
+  GDExtensionInterfaceVariantEvaluate variant_evaluate;
+  GDExtensionInterfaceVariantBooleanize variant_booleanize;
+  GDExtensionInterfaceGetVariantFromTypeConstructor get_variant_from_type_constructor;
+  GDExtensionInterfaceGetVariantToTypeConstructor get_variant_to_type_constructor;
+  GDExtensionInterfaceVariantGetPtrDestructor variant_get_ptr_destructor;
+} gd_extension;
+
+struct {
+  struct {
+    GDExtensionPtrDestructor string;
+    GDExtensionPtrDestructor string_name;
+  } destructor;
+  struct {
+    GDExtensionVariantFromTypeConstructorFunc type_bool;
+    GDExtensionVariantFromTypeConstructorFunc type_int;
+    GDExtensionVariantFromTypeConstructorFunc type_double;
+    GDExtensionVariantFromTypeConstructorFunc vector2i;
+    GDExtensionVariantFromTypeConstructorFunc string;
+    GDExtensionVariantFromTypeConstructorFunc string_name;
+  } wrap;
+  struct {
+    GDExtensionTypeFromVariantConstructorFunc type_double;
+  } unwrap;
+} gd_extension_helper;
+
+typedef struct {
+  int32_t x;
+  int32_t y;
+} GDVector2i;
+
+uint64_t now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// The setter every example had before: floats only
+bool set_amplitude_checked(double *r_amplitude, GDExtensionConstVariantPtr p_value) {
+  if (gd_extension.variant_get_type(p_value) == GDEXTENSION_VARIANT_TYPE_FLOAT) {
+    gd_extension_helper.unwrap.type_double(r_amplitude, (void *)p_value);
+    return true;
+  } else {
+    return false;
+  }
+}
+
+bool set_amplitude_converting(double *r_amplitude, GDExtensionConstVariantPtr p_value) {
+  return variant_unwrap_float(p_value, r_amplitude);
+}
+
+// Half floats, half ints, the way values arrive from GDScript that doesn't
+// care to write `2.0`
+void make_number_inputs(uint8_t (*inputs)[VARIANT_SIZE]) {
+  for (int i = 0; i < INPUT_COUNT; i++) {
+    if (i & 1) {
+      GDExtensionInt value = i;
+      gd_extension_helper.wrap.type_int(inputs[i], &value);
+    } else {
+      double value = i;
+      gd_extension_helper.wrap.type_double(inputs[i], &value);
+    }
+  }
+}
+
+void print_setter_benchmark() {
+  uint8_t (*inputs)[VARIANT_SIZE] = malloc(INPUT_COUNT * VARIANT_SIZE);
+  make_number_inputs(inputs);
+
+  double amplitude = 0;
+  int checked_accepted = 0;
+  uint64_t start = now_ns();
+  for (int round = 0; round < BENCHMARK_ROUNDS; round++) {
+    for (int i = 0; i < INPUT_COUNT; i++) {
+      if (set_amplitude_checked(&amplitude, inputs[i])) {
+        checked_accepted++;
+      }
+    }
+  }
+  uint64_t checked_ns = now_ns() - start;
+
+  double converting_sum = 0;
+  int converting_accepted = 0;
+  start = now_ns();
+  for (int round = 0; round < BENCHMARK_ROUNDS; round++) {
+    for (int i = 0; i < INPUT_COUNT; i++) {
+      if (set_amplitude_converting(&amplitude, inputs[i])) {
+        converting_accepted++;
+        converting_sum += amplitude;
+      }
+    }
+  }
+  uint64_t converting_ns = now_ns() - start;
+
+  // Every input is its own index, so the expected sum is known
+  double expected_sum = (double)INPUT_COUNT * (INPUT_COUNT - 1) / 2 * BENCHMARK_ROUNDS;
+  int total = INPUT_COUNT * BENCHMARK_ROUNDS;
+  printf("float setter, half ints: checked %.1f ns (%d/%d accepted), converting %.1f ns (%d/%d accepted, sum %s)\n",
+         (double)checked_ns / total, checked_accepted, total,
+         (double)converting_ns / total, converting_accepted, total,
+         converting_sum == expected_sum ? "ok" : "WRONG");
+
+  for (int i = 0; i < INPUT_COUNT; i++) {
+    gd_extension.variant_destroy(inputs[i]);
+  }
+  free(inputs);
+}
+
+// Godot's own Variant constructors convert too, only slower. Whatever we
+// accept has to come out the same as theirs.
+bool matches_godot(GDExtensionVariantType p_type, GDExtensionConstVariantPtr p_value, const void *p_ours) {
+  // `theirs` is a Variant even when the construction fails, Nil then
+  uint8_t theirs[VARIANT_SIZE];
+  GDExtensionCallError error;
+  gd_extension.variant_construct(p_type, theirs, &p_value, 1, &error);
+  bool res = false;
+  if (error.error == GDEXTENSION_CALL_OK) {
+    uint8_t ours[VARIANT_SIZE];
+    gd_extension.get_variant_from_type_constructor(p_type)(ours, (void *)p_ours);
+
+    uint8_t equal[VARIANT_SIZE];
+    GDExtensionBool valid;
+    gd_extension.variant_evaluate(GDEXTENSION_VARIANT_OP_EQUAL, ours, theirs, equal, &valid);
+    res = valid && gd_extension.variant_booleanize(equal);
+
+    gd_extension.variant_destroy(equal);
+    gd_extension.variant_destroy(ours);
+  }
+
+  gd_extension.variant_destroy(theirs);
+  return res;
+}
+
+void print_mixed_type_check() {
+  enum { MIXED_COUNT = 7 };
+  uint8_t inputs[MIXED_COUNT][VARIANT_SIZE];
+  GDExtensionBool flag = true;
+  GDExtensionInt number = -7;
+  double real = 2.75;
+  GDVector2i cell = { .x = 3, .y = -4 };
+  uint8_t string[GD_STRING_SIZE];
+  uint8_t string_name[GD_STRING_SIZE];
+  GD_STRING_NEW_LITERAL(string, "amplitude");
+  GD_STRING_NAME_NEW_LITERAL(string_name, "amplitude");
+
+  gd_extension.variant_new_nil(inputs[0]);
+  gd_extension_helper.wrap.type_bool(inputs[1], &flag);
+  gd_extension_helper.wrap.type_int(inputs[2], &number);
+  gd_extension_helper.wrap.type_double(inputs[3], &real);
+  gd_extension_helper.wrap.vector2i(inputs[4], &cell);
+  gd_extension_helper.wrap.string(inputs[5], string);
+  gd_extension_helper.wrap.string_name(inputs[6], string_name);
+  gd_extension_helper.destructor.string(string);
+  gd_extension_helper.destructor.string_name(string_name);
+
+  const GDExtensionVariantType targets[] = {
+    GDEXTENSION_VARIANT_TYPE_BOOL,
+    GDEXTENSION_VARIANT_TYPE_INT,
+    GDEXTENSION_VARIANT_TYPE_FLOAT,
+    GDEXTENSION_VARIANT_TYPE_VECTOR2,
+    GDEXTENSION_VARIANT_TYPE_STRING,
+    GDEXTENSION_VARIANT_TYPE_STRING_NAME,
+  };
+  int converted = 0;
+  int matching = 0;
+  int rejected = 0;
+  for (size_t t = 0; t < sizeof(targets) / sizeof(targets[0]); t++) {
+    for (int i = 0; i < MIXED_COUNT; i++) {
+      _Alignas(8) uint8_t value[VARIANT_UNWRAP_SCRATCH_SIZE];
+      if (!variant_unwrap_as(targets[t], inputs[i], value)) {
+        rejected++;
+        continue;
+      }
+      converted++;
+      if (matches_godot(targets[t], inputs[i], value)) {
+        matching++;
+      } else {
+        printf("Variant type %d as %d doesn't match Godot's conversion\n",
+               (int)gd_extension.variant_get_type(inputs[i]), (int)targets[t]);
+      }
+      GDExtensionPtrDestructor destructor = gd_extension.variant_get_ptr_destructor(targets[t]);
+      if (destructor != NULL) destructor(value);
+    }
+  }
+  printf("mixed types: %d converted (%d match Godot), %d rejected\n", converted, matching, rejected);
+
+  for (int i = 0; i < MIXED_COUNT; i++) {
+    gd_extension.variant_destroy(inputs[i]);
+  }
+}
+
+void godot_initialize(void *userdata, GDExtensionInitializationLevel p_level) {
+  if (p_level == GDEXTENSION_INITIALIZATION_SCENE) {
+    print_setter_benchmark();
+    print_mixed_type_check();
+    return;
+  }
+}
+
+void godot_deinitialize(void *userdata, GDExtensionInitializationLevel p_level) {
+}
+
+GDExtensionBool
+godot_entry(
+  GDExtensionInterfaceGetProcAddress p_get_proc_address,
+  const GDExtensionClassLibraryPtr _p_library,
+  GDExtensionInitialization *r_initialization
+) {
+  r_initialization->minimum_initialization_level = GDEXTENSION_INITIALIZATION_SCENE;
+  r_initialization->userdata = NULL;
+  r_initialization->initialize = godot_initialize;
+  r_initialization->deinitialize = godot_deinitialize;
+
+  STORE_GD_EXTENSION(variant_get_type);
+  STORE_GD_EXTENSION(variant_new_nil);
+  STORE_GD_EXTENSION(variant_destroy);
+  STORE_GD_EXTENSION(variant_construct);
+  STORE_GD_EXTENSION(variant_evaluate);
+  STORE_GD_EXTENSION(variant_booleanize);
+  STORE_GD_EXTENSION(get_variant_from_type_constructor);
+  STORE_GD_EXTENSION(get_variant_to_type_constructor);
+  STORE_GD_EXTENSION(variant_get_ptr_destructor);
+
+  gd_extension_helper.destructor.string
+    = gd_extension.variant_get_ptr_destructor(GDEXTENSION_VARIANT_TYPE_STRING);
+  gd_extension_helper.destructor.string_name
+    = gd_extension.variant_get_ptr_destructor(GDEXTENSION_VARIANT_TYPE_STRING_NAME);
+
+  gd_extension_helper.wrap.type_bool
+    = gd_extension.get_variant_from_type_constructor(GDEXTENSION_VARIANT_TYPE_BOOL);
+  gd_extension_helper.wrap.type_int
+    = gd_extension.get_variant_from_type_constructor(GDEXTENSION_VARIANT_TYPE_INT);
+  gd_extension_helper.wrap.type_double
+    = gd_extension.get_variant_from_type_constructor(GDEXTENSION_VARIANT_TYPE_FLOAT);
+  gd_extension_helper.wrap.vector2i
+    = gd_extension.get_variant_from_type_constructor(GDEXTENSION_VARIANT_TYPE_VECTOR2I);
+  gd_extension_helper.wrap.string
+    = gd_extension.get_variant_from_type_constructor(GDEXTENSION_VARIANT_TYPE_STRING);
+  gd_extension_helper.wrap.string_name
+    = gd_extension.get_variant_from_type_constructor(GDEXTENSION_VARIANT_TYPE_STRING_NAME);
+
+  gd_extension_helper.unwrap.type_double
+    = gd_extension.get_variant_to_type_constructor(GDEXTENSION_VARIANT_TYPE_FLOAT);
+
+  variant_unwrap_init(p_get_proc_address);
+  gd_string_init(p_get_proc_address);
+
+  return true;
+}
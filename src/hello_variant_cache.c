@@ -0,0 +1,154 @@
+#include "../godot-headers/gdextension_interface.h"
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define STORE_GD_EXTENSION(str_name) gd_extension.str_name = (void *)p_get_proc_address(#str_name);
+#define IS_GODOT_64_BIT (true)
+#define IS_GODOT_USING_LARGE_WORLD_COORDINATES (false)
+#define BENCHMARK_LOOKUP_COUNT (1000000)
+
+#include "../util/variant_cache.h"
+
+struct {
+  GDExtensionInterfaceStringNameNewWithUtf8Chars string_name_new_with_utf8_chars;
+  GDExtensionInterfaceVariantGetPtrOperatorEvaluator variant_get_ptr_operator_evaluator;
+} gd_extension;
+
+#if (IS_GODOT_USING_LARGE_WORLD_COORDINATES)
+typedef struct {
+  double x;
+  double y;
+} GDVector2;
+#else
+typedef struct {
+  float x;
+  float y;
+} GDVector2;
+#endif
+
+GDExtensionStringNamePtr construct_string_name(const char *c_string) {
+  void *res = malloc(IS_GODOT_64_BIT ? 8 : 4);
+  gd_extension.string_name_new_with_utf8_chars(res, c_string);
+  return res;
+}
+
+// No more `gd_extension_helper.destructor`, the cache hands it out on demand
+void destruct_string_name(GDExtensionStringNamePtr p) {
+  variant_cache_destructor(GDEXTENSION_VARIANT_TYPE_STRING_NAME)(p);
+}
+
+uint64_t now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+void print_operator_results() {
+  GDExtensionInt a = 40, b = 2, int_sum;
+  variant_cache_evaluate(GDEXTENSION_VARIANT_OP_ADD,
+                         GDEXTENSION_VARIANT_TYPE_INT, &a,
+                         GDEXTENSION_VARIANT_TYPE_INT, &b,
+                         &int_sum);
+  printf("40 + 2 = %ld\n", (long)int_sum);
+
+  // Mixed types have their own evaluators, int * float gives a float
+  double x = 1.5, product;
+  variant_cache_evaluate(GDEXTENSION_VARIANT_OP_MULTIPLY,
+                         GDEXTENSION_VARIANT_TYPE_INT, &a,
+                         GDEXTENSION_VARIANT_TYPE_FLOAT, &x,
+                         &product);
+  printf("40 * 1.5 = %f\n", product);
+
+  GDVector2 u = { .x = 1, .y = 2 }, v = { .x = 10, .y = 20 }, vector_sum;
+  variant_cache_evaluate(GDEXTENSION_VARIANT_OP_ADD,
+                         GDEXTENSION_VARIANT_TYPE_VECTOR2, &u,
+                         GDEXTENSION_VARIANT_TYPE_VECTOR2, &v,
+                         &vector_sum);
+  printf("(1, 2) + (10, 20) = (%f, %f)\n", vector_sum.x, vector_sum.y);
+
+  GDExtensionStringNamePtr hello = construct_string_name("hello");
+  GDExtensionStringNamePtr hello_again = construct_string_name("hello");
+  GDExtensionBool eq;
+  variant_cache_evaluate(GDEXTENSION_VARIANT_OP_EQUAL,
+                         GDEXTENSION_VARIANT_TYPE_STRING_NAME, hello,
+                         GDEXTENSION_VARIANT_TYPE_STRING_NAME, hello_again,
+                         &eq);
+  printf("&\"hello\" == &\"hello\" is %s\n", eq ? "true" : "false");
+  destruct_string_name(hello);
+  destruct_string_name(hello_again);
+
+  // Godot doesn't define bool + bool, the cache remembers that as well
+  GDExtensionBool t = true;
+  GDExtensionBool unused;
+  bool ok = variant_cache_evaluate(GDEXTENSION_VARIANT_OP_ADD,
+                                   GDEXTENSION_VARIANT_TYPE_BOOL, &t,
+                                   GDEXTENSION_VARIANT_TYPE_BOOL, &t,
+                                   &unused);
+  printf("true + true is %s\n", ok ? "defined" : "not defined");
+}
+
+void print_lookup_benchmark() {
+  // Cycle through a few pairs so neither side gets to reuse one pointer
+  const GDExtensionVariantType types[] = {
+    GDEXTENSION_VARIANT_TYPE_INT,
+    GDEXTENSION_VARIANT_TYPE_FLOAT,
+    GDEXTENSION_VARIANT_TYPE_VECTOR2,
+    GDEXTENSION_VARIANT_TYPE_VECTOR3,
+  };
+  uintptr_t checksum = 0;
+
+  uint64_t start = now_ns();
+  for (int i = 0; i < BENCHMARK_LOOKUP_COUNT; i++) {
+    GDExtensionVariantType type = types[i & 3];
+    checksum += (uintptr_t)gd_extension.variant_get_ptr_operator_evaluator(GDEXTENSION_VARIANT_OP_ADD,
+                                                                           type,
+                                                                           type);
+  }
+  uint64_t interface_ns = now_ns() - start;
+
+  start = now_ns();
+  for (int i = 0; i < BENCHMARK_LOOKUP_COUNT; i++) {
+    GDExtensionVariantType type = types[i & 3];
+    checksum -= (uintptr_t)variant_cache_operator_evaluator(GDEXTENSION_VARIANT_OP_ADD, type, type);
+  }
+  uint64_t cache_ns = now_ns() - start;
+
+  printf("operator evaluator lookup: interface %.2f ns, cache %.2f ns (checksum %s)\n",
+         (double)interface_ns / BENCHMARK_LOOKUP_COUNT,
+         (double)cache_ns / BENCHMARK_LOOKUP_COUNT,
+         checksum == 0 ? "ok" : "MISMATCH");
+}
+
+void godot_initialize(void *userdata, GDExtensionInitializationLevel p_level) {
+  if (p_level == GDEXTENSION_INITIALIZATION_SCENE) {
+    print_operator_results();
+    print_lookup_benchmark();
+    return;
+  }
+}
+
+void godot_deinitialize(void *userdata, GDExtensionInitializationLevel p_level) {
+  return;
+}
+
+GDExtensionBool
+godot_entry(
+  GDExtensionInterfaceGetProcAddress p_get_proc_address,
+  const GDExtensionClassLibraryPtr _p_library,
+  GDExtensionInitialization *r_initialization
+) {
+  r_initialization->minimum_initialization_level = GDEXTENSION_INITIALIZATION_SCENE;
+  r_initialization->userdata = NULL;
+  r_initialization->initialize = godot_initialize;
+  r_initialization->deinitialize = godot_deinitialize;
+
+  STORE_GD_EXTENSION(string_name_new_with_utf8_chars);
+  STORE_GD_EXTENSION(variant_get_ptr_operator_evaluator);
+
+  variant_cache_init(p_get_proc_address);
+
+  return true;
+}
@@ -0,0 +1,1197 @@
+#include "../godot-headers/gdextension_interface.h"
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define STORE_GD_EXTENSION(str_name) gd_extension.str_name = (void *)p_get_proc_address(#str_name);
+#define IS_GODOT_64_BIT (true)
+#define IS_GODOT_USING_LARGE_WORLD_COORDINATES (false)
+#define VARIANT_SIZE (IS_GODOT_USING_LARGE_WORLD_COORDINATES ? 40 : 24)
+#define PACKED_ARRAY_SIZE (16)
+#define CODEC_CLASS_NAME ("VariantCodec")
+#define CODEC_CLASS_PARENT ("RefCounted")
+#define CODEC_DEFAULT_CAPACITY (4096)
+#define CODEC_MAX_ARGUMENTS (3)
+// Marks an argument or return value that takes any Variant
+#define CODEC_ANY (GDEXTENSION_VARIANT_TYPE_VARIANT_MAX)
+#define PROPERTY_USAGE_DEFAULT (6)
+#define PROPERTY_USAGE_NIL_IS_VARIANT (131072)
+#define PACKED_SIZE_HASH (3173160232)
+#define PACKED_RESIZE_HASH (848867239)
+#define VAR_TO_BYTES_HASH (2947269930)
+#define BYTES_TO_VAR_HASH (4249819452)
+#define FUZZ_ROUNDS (2000)
+#define FUZZ_MAX_DEPTH (4)
+#define FUZZ_MUTATIONS (4)
+#define SNAPSHOT_ENTITIES (256)
+#define BENCHMARK_ROUNDS (200)
+
+#include "../util/variant_codec.h"
+
+struct {
+  GDExtensionInterfaceClassdbConstructObject classdb_construct_object;
+  GDExtensionInterfaceClassdbRegisterExtensionClass2 classdb_register_extension_class2;
+  GDExtensionInterfaceClassdbRegisterExtensionClassMethod classdb_register_extension_class_method;
+  GDExtensionInterfaceStringNameNewWithUtf8Chars string_name_new_with_utf8_chars;
+  GDExtensionInterfaceStringNewWithUtf8Chars string_new_with_utf8_chars;
+  GDExtensionInterfaceStringNewWithUtf32CharsAndLen string_new_with_utf32_chars_and_len;
+  GDExtensionInterfaceObjectSetInstance object_set_instance;
+  GDExtensionInterfaceVariantGetPtrDestructor variant_get_ptr_destructor;
+  GDExtensionInterfaceVariantGetPtrConstructor variant_get_ptr_constructor;
+  GDExtensionInterfaceVariantGetPtrBuiltinMethod variant_get_ptr_builtin_method;
+  GDExtensionInterfaceVariantGetPtrUtilityFunction variant_get_ptr_utility_function;
+  GDExtensionInterfaceGetVariantFromTypeConstructor get_variant_from_type_constructor;
+  GDExtensionInterfaceGetVariantToTypeConstructor get_variant_to_type_constructor;
+  GDExtensionInterfaceVariantGetType variant_get_type;
+  GDExtensionInterfaceVariantNewCopy variant_new_copy;
+  GDExtensionInterfaceVariantNewNil variant_new_nil;
+  GDExtensionInterfaceVariantDestroy variant_destroy;
+  GDExtensionInterfaceVariantEvaluate variant_evaluate;
+  GDExtensionInterfaceArrayOperatorIndex array_operator_index;
+  GDExtensionInterfaceDictionaryOperatorIndex dictionary_operator_index;
+  GDExtensionInterfacePackedByteArrayOperatorIndex packed_byte_array_operator_index;
+  GDExtensionInterfacePackedByteArrayOperatorIndexConst packed_byte_array_operator_index_const;
+} gd_extension;
+
+struct {
+  struct {
+    GDExtensionPtrDestructor string_name;
+    GDExtensionPtrDestructor string;
+    GDExtensionPtrDestructor packed_byte_array;
+  } destructor;
+  struct {
+    GDExtensionPtrConstructor packed_byte_array;
+  } constructor;
+  struct {
+    GDExtensionPtrBuiltInMethod packed_byte_array_size;
+    GDExtensionPtrBuiltInMethod packed_byte_array_resize;
+  } builtin_method;
+  struct {
+    GDExtensionVariantFromTypeConstructorFunc type_int;
+    GDExtensionVariantFromTypeConstructorFunc packed_byte_array;
+  } wrap;
+  struct {
+    GDExtensionTypeFromVariantConstructorFunc type_int;
+    GDExtensionTypeFromVariantConstructorFunc packed_byte_array;
+  } unwrap;
+  struct {
+    GDExtensionPtrUtilityFunction var_to_bytes;
+    GDExtensionPtrUtilityFunction bytes_to_var;
+  } utility;
+  struct {
+    GDExtensionClassLibraryPtr p_library;
+  } misc;
+} gd_extension_helper;
+
+GDExtensionStringNamePtr construct_string_name(const char *c_string) {
+  void *res = malloc(IS_GODOT_64_BIT ? 8 : 4);
+  gd_extension.string_name_new_with_utf8_chars(res, c_string);
+  return res;
+}
+
+GDExtensionStringPtr construct_string(const char *c_string) {
+  void *res = malloc(IS_GODOT_64_BIT ? 8 : 4);
+  gd_extension.string_new_with_utf8_chars(res, c_string);
+  return res;
+}
+
+void destruct_string_name(GDExtensionStringNamePtr p) {
+  gd_extension_helper.destructor.string_name(p);
+  free(p);
+}
+
+void destruct_string(GDExtensionStringPtr p) {
+  gd_extension_helper.destructor.string(p);
+  free(p);
+}
+
+uint64_t now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+GDExtensionInt packed_byte_array_size(GDExtensionConstTypePtr p_array) {
+  GDExtensionInt res;
+  gd_extension_helper.builtin_method.packed_byte_array_size((void *)p_array, NULL, &res, 0);
+  return res;
+}
+
+void packed_byte_array_resize(GDExtensionTypePtr p_array, GDExtensionInt p_size) {
+  GDExtensionConstTypePtr args[] = { &p_size };
+  GDExtensionInt error;
+  gd_extension_helper.builtin_method.packed_byte_array_resize(p_array, args, &error, 1);
+}
+
+// ---------------------------------------------------------------------------
+// VariantCodec
+// ---------------------------------------------------------------------------
+
+// Values are encoded into a PackedByteArray the codec owns. Writing into an
+// array that came in as an argument would copy it first, GDScript still holds
+// a reference to it. Ours is never shared, so it's written in place and only
+// grows.
+typedef struct {
+  GDExtensionObjectPtr godot_object;
+  unsigned char buffer[PACKED_ARRAY_SIZE];
+  // Bytes of `buffer` holding encoded values
+  GDExtensionInt size;
+  // Where the value after the last decoded one starts
+  GDExtensionInt next_offset;
+  variant_codec_error_t error;
+} codec_t;
+
+GDExtensionObjectPtr codec_init(void *userdata) {
+  codec_t *codec = malloc(sizeof(codec_t));
+
+  void *my_class_string_name = construct_string_name(CODEC_CLASS_NAME);
+  void *parent_class_string_name = construct_string_name(CODEC_CLASS_PARENT);
+
+  codec->godot_object = gd_extension.classdb_construct_object(parent_class_string_name);
+  gd_extension_helper.constructor.packed_byte_array(&codec->buffer, NULL);
+  packed_byte_array_resize(&codec->buffer, CODEC_DEFAULT_CAPACITY);
+  codec->size = 0;
+  codec->next_offset = 0;
+  codec->error = VARIANT_CODEC_OK;
+  gd_extension.object_set_instance(codec->godot_object, my_class_string_name, codec);
+
+  destruct_string_name(my_class_string_name);
+  destruct_string_name(parent_class_string_name);
+
+  return codec->godot_object;
+}
+
+void codec_deinit(void *userdata, GDExtensionClassInstancePtr p_instance) {
+  if (p_instance == NULL) return;
+
+  codec_t *codec = p_instance;
+  gd_extension_helper.destructor.packed_byte_array(&codec->buffer);
+  free(codec);
+}
+
+// Appends `p_value` to the buffer, doubling it until the value fits
+void codec_put(codec_t *codec, GDExtensionConstVariantPtr p_value, GDExtensionConstVariantPtr p_baseline) {
+  for (;;) {
+    GDExtensionInt capacity = packed_byte_array_size(&codec->buffer);
+    uint8_t *data = capacity > 0 ? gd_extension.packed_byte_array_operator_index(&codec->buffer, 0) : NULL;
+    variant_codec_writer_t writer = variant_codec_writer(data, capacity);
+    writer.size = codec->size;
+
+    bool ok = variant_codec_encode(&writer, p_value, p_baseline);
+    codec->error = writer.error;
+    if (ok) {
+      codec->size = writer.size;
+      return;
+    }
+    if (writer.error != VARIANT_CODEC_ERROR_FULL) return;
+    packed_byte_array_resize(&codec->buffer, capacity < CODEC_DEFAULT_CAPACITY ? CODEC_DEFAULT_CAPACITY : capacity * 2);
+  }
+}
+
+void
+codec_get(
+  codec_t *codec,
+  GDExtensionConstTypePtr p_buffer,
+  GDExtensionInt p_offset,
+  GDExtensionConstVariantPtr p_baseline,
+  GDExtensionUninitializedVariantPtr r_value
+) {
+  GDExtensionInt size = packed_byte_array_size(p_buffer);
+  if (p_offset < 0 || p_offset > size) {
+    gd_extension.variant_new_nil(r_value);
+    codec->error = VARIANT_CODEC_ERROR_CORRUPT;
+    return;
+  }
+
+  const uint8_t *data = size > 0 ? gd_extension.packed_byte_array_operator_index_const(p_buffer, 0) : NULL;
+  variant_codec_reader_t reader = variant_codec_reader(data, size);
+  reader.position = p_offset;
+  variant_codec_decode(&reader, r_value, p_baseline);
+  codec->error = reader.error;
+  codec->next_offset = reader.position;
+}
+
+// The methods take their arguments as Variants. `r_ret` is written over
+// without destroying it, methods without a return value leave it alone.
+typedef void (*codec_method_func_t)(codec_t *codec, const GDExtensionConstVariantPtr *p_args, GDExtensionVariantPtr r_ret);
+
+void codec_reserve(codec_t *codec, const GDExtensionConstVariantPtr *p_args, GDExtensionVariantPtr r_ret) {
+  GDExtensionInt capacity;
+  gd_extension_helper.unwrap.type_int(&capacity, (void *)p_args[0]);
+  if (capacity > packed_byte_array_size(&codec->buffer)) packed_byte_array_resize(&codec->buffer, capacity);
+}
+
+void codec_clear(codec_t *codec, const GDExtensionConstVariantPtr *p_args, GDExtensionVariantPtr r_ret) {
+  codec->size = 0;
+}
+
+void codec_put_var(codec_t *codec, const GDExtensionConstVariantPtr *p_args, GDExtensionVariantPtr r_ret) {
+  codec_put(codec, p_args[0], NULL);
+  GDExtensionInt error = codec->error;
+  gd_extension_helper.wrap.type_int(r_ret, &error);
+}
+
+void codec_put_delta(codec_t *codec, const GDExtensionConstVariantPtr *p_args, GDExtensionVariantPtr r_ret) {
+  codec_put(codec, p_args[0], p_args[1]);
+  GDExtensionInt error = codec->error;
+  gd_extension_helper.wrap.type_int(r_ret, &error);
+}
+
+void codec_get_size(codec_t *codec, const GDExtensionConstVariantPtr *p_args, GDExtensionVariantPtr r_ret) {
+  gd_extension_helper.wrap.type_int(r_ret, &codec->size);
+}
+
+// The one copy in the round trip: the encoded bytes, not the spare capacity
+void codec_get_buffer(codec_t *codec, const GDExtensionConstVariantPtr *p_args, GDExtensionVariantPtr r_ret) {
+  unsigned char res[PACKED_ARRAY_SIZE];
+  gd_extension_helper.constructor.packed_byte_array(&res, NULL);
+  packed_byte_array_resize(&res, codec->size);
+  if (codec->size > 0) {
+    memcpy(gd_extension.packed_byte_array_operator_index(&res, 0),
+           gd_extension.packed_byte_array_operator_index_const(&codec->buffer, 0),
+           codec->size);
+  }
+  gd_extension_helper.wrap.packed_byte_array(r_ret, &res);
+  gd_extension_helper.destructor.packed_byte_array(&res);
+}
+
+void codec_get_var(codec_t *codec, const GDExtensionConstVariantPtr *p_args, GDExtensionVariantPtr r_ret) {
+  unsigned char buffer[PACKED_ARRAY_SIZE];
+  GDExtensionInt offset;
+  gd_extension_helper.unwrap.packed_byte_array(&buffer, (void *)p_args[0]);
+  gd_extension_helper.unwrap.type_int(&offset, (void *)p_args[1]);
+  codec_get(codec, &buffer, offset, NULL, r_ret);
+  gd_extension_helper.destructor.packed_byte_array(&buffer);
+}
+
+void codec_get_delta(codec_t *codec, const GDExtensionConstVariantPtr *p_args, GDExtensionVariantPtr r_ret) {
+  unsigned char buffer[PACKED_ARRAY_SIZE];
+  GDExtensionInt offset;
+  gd_extension_helper.unwrap.packed_byte_array(&buffer, (void *)p_args[0]);
+  gd_extension_helper.unwrap.type_int(&offset, (void *)p_args[1]);
+  codec_get(codec, &buffer, offset, p_args[2], r_ret);
+  gd_extension_helper.destructor.packed_byte_array(&buffer);
+}
+
+void codec_get_next_offset(codec_t *codec, const GDExtensionConstVariantPtr *p_args, GDExtensionVariantPtr r_ret) {
+  gd_extension_helper.wrap.type_int(r_ret, &codec->next_offset);
+}
+
+void codec_get_error(codec_t *codec, const GDExtensionConstVariantPtr *p_args, GDExtensionVariantPtr r_ret) {
+  GDExtensionInt error = codec->error;
+  gd_extension_helper.wrap.type_int(r_ret, &error);
+}
+
+typedef struct {
+  const char *name;
+  codec_method_func_t func;
+  // NIL for no return value
+  GDExtensionVariantType return_type;
+  int argument_count;
+  struct {
+    const char *name;
+    GDExtensionVariantType type;
+  } arguments[CODEC_MAX_ARGUMENTS];
+} codec_method_t;
+
+const codec_method_t codec_methods[] = {
+  {
+    .name = "reserve",
+    .func = codec_reserve,
+    .return_type = GDEXTENSION_VARIANT_TYPE_NIL,
+    .argument_count = 1,
+    .arguments = { { "capacity", GDEXTENSION_VARIANT_TYPE_INT } },
+  },
+  {
+    .name = "clear",
+    .func = codec_clear,
+    .return_type = GDEXTENSION_VARIANT_TYPE_NIL,
+    .argument_count = 0,
+  },
+  {
+    .name = "put_var",
+    .func = codec_put_var,
+    .return_type = GDEXTENSION_VARIANT_TYPE_INT,
+    .argument_count = 1,
+    .arguments = { { "value", CODEC_ANY } },
+  },
+  {
+    .name = "put_delta",
+    .func = codec_put_delta,
+    .return_type = GDEXTENSION_VARIANT_TYPE_INT,
+    .argument_count = 2,
+    .arguments = { { "value", CODEC_ANY }, { "baseline", CODEC_ANY } },
+  },
+  {
+    .name = "get_size",
+    .func = codec_get_size,
+    .return_type = GDEXTENSION_VARIANT_TYPE_INT,
+    .argument_count = 0,
+  },
+  {
+    .name = "get_buffer",
+    .func = codec_get_buffer,
+    .return_type = GDEXTENSION_VARIANT_TYPE_PACKED_BYTE_ARRAY,
+    .argument_count = 0,
+  },
+  {
+    .name = "get_var",
+    .func = codec_get_var,
+    .return_type = CODEC_ANY,
+    .argument_count = 2,
+    .arguments = {
+      { "buffer", GDEXTENSION_VARIANT_TYPE_PACKED_BYTE_ARRAY },
+      { "offset", GDEXTENSION_VARIANT_TYPE_INT },
+    },
+  },
+  {
+    .name = "get_delta",
+    .func = codec_get_delta,
+    .return_type = CODEC_ANY,
+    .argument_count = 3,
+    .arguments = {
+      { "buffer", GDEXTENSION_VARIANT_TYPE_PACKED_BYTE_ARRAY },
+      { "offset", GDEXTENSION_VARIANT_TYPE_INT },
+      { "baseline", CODEC_ANY },
+    },
+  },
+  {
+    .name = "get_next_offset",
+    .func = codec_get_next_offset,
+    .return_type = GDEXTENSION_VARIANT_TYPE_INT,
+    .argument_count = 0,
+  },
+  {
+    .name = "get_error",
+    .func = codec_get_error,
+    .return_type = GDEXTENSION_VARIANT_TYPE_INT,
+    .argument_count = 0,
+  },
+};
+
+#define CODEC_METHOD_COUNT (sizeof(codec_methods) / sizeof(codec_methods[0]))
+
+void
+codec_method_call(
+  void *method_userdata,
+  GDExtensionClassInstancePtr p_instance,
+  const GDExtensionConstVariantPtr *p_args,
+  GDExtensionInt p_argument_count,
+  GDExtensionVariantPtr r_return,
+  GDExtensionCallError *r_error
+) {
+  const codec_method_t *method = method_userdata;
+  if (p_argument_count != method->argument_count) {
+    r_error->error = p_argument_count < method->argument_count
+      ? GDEXTENSION_CALL_ERROR_TOO_FEW_ARGUMENTS
+      : GDEXTENSION_CALL_ERROR_TOO_MANY_ARGUMENTS;
+    r_error->argument = 0;
+    r_error->expected = method->argument_count;
+    return;
+  }
+
+  for (int i = 0; i < method->argument_count; i++) {
+    GDExtensionVariantType type = method->arguments[i].type;
+    if (type != CODEC_ANY && gd_extension.variant_get_type(p_args[i]) != type) {
+      r_error->error = GDEXTENSION_CALL_ERROR_INVALID_ARGUMENT;
+      r_error->argument = i;
+      r_error->expected = type;
+      return;
+    }
+  }
+
+  r_error->error = GDEXTENSION_CALL_OK;
+  method->func(p_instance, p_args, r_return);
+}
+
+// NOTE: ptrcall passes arguments as their types, except the Variant ones. We
+// box the others, that's a refcount bump for the PackedByteArray and nothing
+// next to the encoding itself.
+void
+codec_method_ptrcall(
+  void *method_userdata,
+  GDExtensionClassInstancePtr p_instance,
+  const GDExtensionConstTypePtr *p_args,
+  GDExtensionTypePtr r_ret
+) {
+  const codec_method_t *method = method_userdata;
+  unsigned char boxed[CODEC_MAX_ARGUMENTS][VARIANT_SIZE];
+  GDExtensionConstVariantPtr args[CODEC_MAX_ARGUMENTS];
+
+  for (int i = 0; i < method->argument_count; i++) {
+    switch (method->arguments[i].type) {
+      case GDEXTENSION_VARIANT_TYPE_INT:
+        gd_extension_helper.wrap.type_int(boxed[i], (void *)p_args[i]);
+        args[i] = boxed[i];
+        break;
+      case GDEXTENSION_VARIANT_TYPE_PACKED_BYTE_ARRAY:
+        gd_extension_helper.wrap.packed_byte_array(boxed[i], (void *)p_args[i]);
+        args[i] = boxed[i];
+        break;
+      default:
+        args[i] = p_args[i];
+        break;
+    }
+  }
+
+  unsigned char ret[VARIANT_SIZE];
+  gd_extension.variant_new_nil(ret);
+  method->func(p_instance, args, ret);
+
+  // `r_ret` is already constructed
+  switch (method->return_type) {
+    case GDEXTENSION_VARIANT_TYPE_INT:
+      gd_extension_helper.unwrap.type_int(r_ret, ret);
+      break;
+    case GDEXTENSION_VARIANT_TYPE_PACKED_BYTE_ARRAY:
+      gd_extension_helper.destructor.packed_byte_array(r_ret);
+      gd_extension_helper.unwrap.packed_byte_array(r_ret, ret);
+      break;
+    case CODEC_ANY:
+      gd_extension.variant_destroy(r_ret);
+      gd_extension.variant_new_copy(r_ret, ret);
+      break;
+    default:
+      break;
+  }
+  gd_extension.variant_destroy(ret);
+
+  for (int i = 0; i < method->argument_count; i++) {
+    if (args[i] == boxed[i]) gd_extension.variant_destroy(boxed[i]);
+  }
+}
+
+// Variant arguments and return values are NIL with the NIL_IS_VARIANT usage
+GDExtensionPropertyInfo make_property_info(GDExtensionVariantType type, const char *name) {
+  GDExtensionPropertyInfo res = {
+    .type = type == CODEC_ANY ? GDEXTENSION_VARIANT_TYPE_NIL : type,
+    .name = construct_string_name(name),
+    .class_name = construct_string_name(""),
+    .hint = 0, // Corresponds to no hints
+    .hint_string = construct_string(""),
+    .usage = type == CODEC_ANY ? PROPERTY_USAGE_DEFAULT | PROPERTY_USAGE_NIL_IS_VARIANT : PROPERTY_USAGE_DEFAULT,
+  };
+  return res;
+}
+
+void destruct_property_info(GDExtensionPropertyInfo *p_info) {
+  destruct_string_name(p_info->name);
+  destruct_string_name(p_info->class_name);
+  destruct_string(p_info->hint_string);
+}
+
+void register_codec_methods(GDExtensionConstStringNamePtr class_string_name) {
+  for (size_t m = 0; m < CODEC_METHOD_COUNT; m++) {
+    const codec_method_t *method = &codec_methods[m];
+    GDExtensionPropertyInfo arguments[CODEC_MAX_ARGUMENTS];
+    GDExtensionClassMethodArgumentMetadata arguments_metadata[CODEC_MAX_ARGUMENTS];
+    for (int i = 0; i < method->argument_count; i++) {
+      arguments[i] = make_property_info(method->arguments[i].type, method->arguments[i].name);
+      arguments_metadata[i] = method->arguments[i].type == GDEXTENSION_VARIANT_TYPE_INT
+        ? GDEXTENSION_METHOD_ARGUMENT_METADATA_INT_IS_INT64
+        : GDEXTENSION_METHOD_ARGUMENT_METADATA_NONE;
+    }
+    GDExtensionPropertyInfo return_value = make_property_info(method->return_type, "");
+
+    GDExtensionClassMethodInfo info = {
+      .name = construct_string_name(method->name),
+      .method_userdata = (void *)method,
+      .call_func = codec_method_call,
+      .ptrcall_func = codec_method_ptrcall,
+      .method_flags = GDEXTENSION_METHOD_FLAG_NORMAL,
+      .has_return_value = method->return_type != GDEXTENSION_VARIANT_TYPE_NIL,
+      .return_value_info = method->return_type != GDEXTENSION_VARIANT_TYPE_NIL ? &return_value : NULL,
+      .return_value_metadata = method->return_type == GDEXTENSION_VARIANT_TYPE_INT
+        ? GDEXTENSION_METHOD_ARGUMENT_METADATA_INT_IS_INT64
+        : GDEXTENSION_METHOD_ARGUMENT_METADATA_NONE,
+      .argument_count = method->argument_count,
+      .arguments_info = arguments,
+      .arguments_metadata = arguments_metadata,
+      .default_argument_count = 0,
+      .default_arguments = NULL,
+    };
+    gd_extension.classdb_register_extension_class_method(gd_extension_helper.misc.p_library,
+                                                         class_string_name,
+                                                         &info);
+
+    for (int i = 0; i < method->argument_count; i++) destruct_property_info(&arguments[i]);
+    destruct_property_info(&return_value);
+    destruct_string_name(info.name);
+  }
+}
+
+void register_codec_class() {
+  GDExtensionClassCreationInfo2 class_info = {
+    .is_virtual = false,
+    .is_abstract = false,
+    .is_exposed = true,
+    .set_func = NULL,
+    .get_func = NULL,
+    .get_property_list_func = NULL,
+    .free_property_list_func = NULL,
+    .property_can_revert_func = NULL,
+    .property_get_revert_func = NULL,
+    .validate_property_func = NULL,
+    .notification_func = NULL,
+    .to_string_func = NULL,
+    .reference_func = NULL,
+    .unreference_func = NULL,
+    .create_instance_func = codec_init,
+    .free_instance_func = codec_deinit,
+    .recreate_instance_func = NULL,
+    .get_virtual_func = NULL,
+    .get_virtual_call_data_func = NULL,
+    .call_virtual_with_data_func = NULL,
+    .get_rid_func = NULL,
+    .class_userdata = NULL,
+  };
+
+  void *my_class_string_name = construct_string_name(CODEC_CLASS_NAME);
+  void *parent_class_string_name = construct_string_name(CODEC_CLASS_PARENT);
+
+  gd_extension.classdb_register_extension_class2(gd_extension_helper.misc.p_library,
+                                                 my_class_string_name,
+                                                 parent_class_string_name,
+                                                 &class_info);
+  register_codec_methods(my_class_string_name);
+
+  destruct_string_name(my_class_string_name);
+  destruct_string_name(parent_class_string_name);
+}
+
+// ---------------------------------------------------------------------------
+// Round-trip fuzzing
+// ---------------------------------------------------------------------------
+
+uint64_t fuzz_state = 0x9e3779b97f4a7c15ull;
+
+uint64_t fuzz_next() {
+  // xorshift64
+  fuzz_state ^= fuzz_state << 13;
+  fuzz_state ^= fuzz_state >> 7;
+  fuzz_state ^= fuzz_state << 17;
+  return fuzz_state;
+}
+
+static const GDExtensionVariantType fuzz_raw_types[] = {
+  GDEXTENSION_VARIANT_TYPE_VECTOR2,
+  GDEXTENSION_VARIANT_TYPE_VECTOR2I,
+  GDEXTENSION_VARIANT_TYPE_RECT2,
+  GDEXTENSION_VARIANT_TYPE_VECTOR3,
+  GDEXTENSION_VARIANT_TYPE_VECTOR3I,
+  GDEXTENSION_VARIANT_TYPE_TRANSFORM2D,
+  GDEXTENSION_VARIANT_TYPE_VECTOR4,
+  GDEXTENSION_VARIANT_TYPE_QUATERNION,
+  GDEXTENSION_VARIANT_TYPE_BASIS,
+  GDEXTENSION_VARIANT_TYPE_TRANSFORM3D,
+  GDEXTENSION_VARIANT_TYPE_COLOR,
+};
+
+static const GDExtensionVariantType fuzz_packed_types[] = {
+  GDEXTENSION_VARIANT_TYPE_PACKED_BYTE_ARRAY,
+  GDEXTENSION_VARIANT_TYPE_PACKED_INT32_ARRAY,
+  GDEXTENSION_VARIANT_TYPE_PACKED_INT64_ARRAY,
+  GDEXTENSION_VARIANT_TYPE_PACKED_FLOAT32_ARRAY,
+  GDEXTENSION_VARIANT_TYPE_PACKED_FLOAT64_ARRAY,
+  GDEXTENSION_VARIANT_TYPE_PACKED_VECTOR2_ARRAY,
+  GDEXTENSION_VARIANT_TYPE_PACKED_VECTOR3_ARRAY,
+  GDEXTENSION_VARIANT_TYPE_PACKED_COLOR_ARRAY,
+};
+
+// Multi-byte UTF-8 on purpose, the encoder converts from UTF-32 by hand
+static const char32_t fuzz_chars[] = U"abcxyz_09 éß€中😀";
+static const char *fuzz_names[] = { "position", "velocity", "health", "name", "state", "target", "ammo", "flags" };
+
+#define FUZZ_COUNT(array) (sizeof(array) / sizeof(array[0]))
+
+// Random contents that equal themselves: integer types get any bits, float
+// types small exact values, never NaN
+void fuzz_fill(uint8_t *r_data, size_t p_size, bool p_floats, bool p_doubles) {
+  for (size_t i = 0; i < p_size;) {
+    if (p_doubles && p_size - i >= sizeof(double)) {
+      double value = (double)((int64_t)(fuzz_next() % 2000001) - 1000000) / 64.0;
+      memcpy(r_data + i, &value, sizeof(value));
+      i += sizeof(value);
+    } else if (p_floats && p_size - i >= sizeof(float)) {
+      float value = (float)((int32_t)(fuzz_next() % 20001) - 10000) / 8.0f;
+      memcpy(r_data + i, &value, sizeof(value));
+      i += sizeof(value);
+    } else {
+      r_data[i++] = fuzz_next();
+    }
+  }
+}
+
+void fuzz_string(GDExtensionUninitializedStringPtr r_string) {
+  char32_t chars[12];
+  int length = fuzz_next() % 12;
+  for (int i = 0; i < length; i++) chars[i] = fuzz_chars[fuzz_next() % (FUZZ_COUNT(fuzz_chars) - 1)];
+  gd_extension.string_new_with_utf32_chars_and_len(r_string, chars, length);
+}
+
+void fuzz_value(GDExtensionUninitializedVariantPtr r_value, GDExtensionConstVariantPtr p_previous, int depth);
+
+void fuzz_key(GDExtensionUninitializedVariantPtr r_key) {
+  if (fuzz_next() % 4 == 0) {
+    GDExtensionInt key = fuzz_next() % 100;
+    variant_codec.from_type[GDEXTENSION_VARIANT_TYPE_INT](r_key, &key);
+    return;
+  }
+  uint8_t name[GD_BUILTIN_SIZE_STRING];
+  const char *utf8 = fuzz_names[fuzz_next() % FUZZ_COUNT(fuzz_names)];
+  gd_string_new(name, utf8, strlen(utf8));
+  variant_codec_wrap(GDEXTENSION_VARIANT_TYPE_STRING, r_key, name);
+}
+
+void fuzz_packed(GDExtensionUninitializedVariantPtr r_value, GDExtensionVariantType p_type, GDExtensionConstVariantPtr p_previous) {
+  uint8_t array[GD_BUILTIN_SIZE_PACKED_BYTE_ARRAY];
+  GDExtensionInt count;
+  if (p_previous != NULL) {
+    // Mostly the same size with a few elements changed, like a path that moved
+    variant_codec.to_type[p_type](array, (void *)p_previous);
+    variant_codec.size[p_type](array, NULL, &count, 0);
+    if (fuzz_next() % 4 == 0) count = fuzz_next() % 40;
+  } else {
+    variant_codec.default_constructor[p_type](array, NULL);
+    count = fuzz_next() % 40;
+  }
+  variant_codec_resize(p_type, array, count);
+
+  size_t element_size = variant_codec_element_size[p_type];
+  bool floats = p_type != GDEXTENSION_VARIANT_TYPE_PACKED_BYTE_ARRAY
+                && p_type != GDEXTENSION_VARIANT_TYPE_PACKED_INT32_ARRAY
+                && p_type != GDEXTENSION_VARIANT_TYPE_PACKED_INT64_ARRAY;
+  bool doubles = p_type == GDEXTENSION_VARIANT_TYPE_PACKED_FLOAT64_ARRAY;
+  GDExtensionInt changes = p_previous != NULL ? (GDExtensionInt)(fuzz_next() % 4) : count;
+  for (GDExtensionInt i = 0; i < changes && count > 0; i++) {
+    GDExtensionInt index = p_previous != NULL ? (GDExtensionInt)(fuzz_next() % count) : i;
+    fuzz_fill(variant_codec.packed_index[p_type](array, index), element_size, floats, doubles);
+  }
+  variant_codec_wrap(p_type, r_value, array);
+}
+
+void fuzz_array(GDExtensionUninitializedVariantPtr r_value, GDExtensionConstVariantPtr p_previous, int depth) {
+  uint8_t previous[GD_BUILTIN_SIZE_ARRAY];
+  gd_array_view_t view = { 0 };
+  if (p_previous != NULL) {
+    variant_codec.to_type[GDEXTENSION_VARIANT_TYPE_ARRAY](previous, (void *)p_previous);
+    view = gd_array_view(previous);
+  }
+  GDExtensionInt count = p_previous != NULL && fuzz_next() % 4 != 0 ? view.size : (GDExtensionInt)(fuzz_next() % 6);
+
+  uint8_t array[GD_BUILTIN_SIZE_ARRAY];
+  gd_container.array_constructor(array, NULL);
+  variant_codec_resize(GDEXTENSION_VARIANT_TYPE_ARRAY, array, count);
+  for (GDExtensionInt i = 0; i < count; i++) {
+    fuzz_value(gd_array_at(array, i), gd_array_view_at(view, i), depth + 1);
+  }
+  variant_codec_wrap(GDEXTENSION_VARIANT_TYPE_ARRAY, r_value, array);
+  if (p_previous != NULL) gd_container.array_destructor(previous);
+}
+
+void fuzz_dictionary(GDExtensionUninitializedVariantPtr r_value, GDExtensionConstVariantPtr p_previous, int depth) {
+  uint8_t dictionary[GD_BUILTIN_SIZE_DICTIONARY];
+  variant_codec.default_constructor[GDEXTENSION_VARIANT_TYPE_DICTIONARY](dictionary, NULL);
+
+  // Sometimes a new key goes first, so the previous keys all move
+  int added = fuzz_next() % 4 == 0 ? 1 : 0;
+  if (p_previous == NULL) added = fuzz_next() % 6;
+  for (int i = 0; i < added; i++) {
+    uint8_t key[GD_BUILTIN_SIZE_VARIANT];
+    fuzz_key(key);
+    GDExtensionVariantPtr value = gd_extension.dictionary_operator_index(dictionary, key);
+    gd_extension.variant_destroy(value);
+    fuzz_value(value, NULL, depth + 1);
+    gd_extension.variant_destroy(key);
+  }
+
+  if (p_previous != NULL) {
+    uint8_t previous[GD_BUILTIN_SIZE_DICTIONARY];
+    uint8_t keys[GD_BUILTIN_SIZE_ARRAY];
+    variant_codec.to_type[GDEXTENSION_VARIANT_TYPE_DICTIONARY](previous, (void *)p_previous);
+    gd_container.array_constructor(keys, NULL);
+    gd_container.dictionary_keys(previous, NULL, keys, 0);
+    gd_array_view_t view = gd_array_view(keys);
+    for (int64_t i = 0; i < view.size; i++) {
+      if (fuzz_next() % 8 == 0) continue;
+      GDExtensionConstVariantPtr key = gd_array_view_at(view, i);
+      GDExtensionVariantPtr value = gd_extension.dictionary_operator_index(dictionary, key);
+      gd_extension.variant_destroy(value);
+      fuzz_value(value, gd_container.interface.dictionary_operator_index_const(previous, key), depth + 1);
+    }
+    gd_container.array_destructor(keys);
+    gd_container.dictionary_destructor(previous);
+  }
+  variant_codec_wrap(GDEXTENSION_VARIANT_TYPE_DICTIONARY, r_value, dictionary);
+}
+
+// A random value, usually a variation of `p_previous` when there is one, the
+// way game state changes from one snapshot to the next
+void fuzz_value(GDExtensionUninitializedVariantPtr r_value, GDExtensionConstVariantPtr p_previous, int depth) {
+  if (p_previous != NULL && fuzz_next() % 4 != 0) {
+    GDExtensionVariantType type = gd_extension.variant_get_type(p_previous);
+    if (type == GDEXTENSION_VARIANT_TYPE_ARRAY) {
+      fuzz_array(r_value, p_previous, depth);
+      return;
+    }
+    if (type == GDEXTENSION_VARIANT_TYPE_DICTIONARY) {
+      fuzz_dictionary(r_value, p_previous, depth);
+      return;
+    }
+    if (variant_codec_element_size[type] > 0) {
+      fuzz_packed(r_value, type, p_previous);
+      return;
+    }
+    if (fuzz_next() % 2 == 0) {
+      gd_extension.variant_new_copy(r_value, p_previous);
+      return;
+    }
+  }
+
+  int kinds = depth < FUZZ_MAX_DEPTH ? 11 : 9;
+  switch (fuzz_next() % kinds) {
+    case 0:
+      gd_extension.variant_new_nil(r_value);
+      break;
+    case 1: {
+      GDExtensionBool value = fuzz_next() & 1;
+      variant_codec.from_type[GDEXTENSION_VARIANT_TYPE_BOOL](r_value, &value);
+      break;
+    }
+    case 2: {
+      // Every varint length
+      GDExtensionInt value = (GDExtensionInt)fuzz_next() >> (fuzz_next() % 64);
+      variant_codec.from_type[GDEXTENSION_VARIANT_TYPE_INT](r_value, &value);
+      break;
+    }
+    case 3: {
+      // Half of them fit a float, half need a double
+      double value = (double)((int64_t)(fuzz_next() % 2000001) - 1000000) / (fuzz_next() & 1 ? 8.0 : 3.0);
+      variant_codec.from_type[GDEXTENSION_VARIANT_TYPE_FLOAT](r_value, &value);
+      break;
+    }
+    case 4: {
+      uint8_t string[GD_BUILTIN_SIZE_STRING];
+      fuzz_string(string);
+      variant_codec_wrap(GDEXTENSION_VARIANT_TYPE_STRING, r_value, string);
+      break;
+    }
+    case 5: {
+      uint8_t name[GD_BUILTIN_SIZE_STRING_NAME];
+      const char *utf8 = fuzz_names[fuzz_next() % FUZZ_COUNT(fuzz_names)];
+      gd_string_name_new(name, utf8, strlen(utf8));
+      variant_codec_wrap(GDEXTENSION_VARIANT_TYPE_STRING_NAME, r_value, name);
+      break;
+    }
+    case 6: {
+      GDExtensionVariantType type = fuzz_raw_types[fuzz_next() % FUZZ_COUNT(fuzz_raw_types)];
+      bool floats = type != GDEXTENSION_VARIANT_TYPE_VECTOR2I && type != GDEXTENSION_VARIANT_TYPE_VECTOR3I;
+      uint8_t value[GD_BUILTIN_SIZE_PROJECTION];
+      fuzz_fill(value, variant_codec_raw_size[type], floats, floats && GD_BUILTIN_SIZE_VECTOR2 == 16);
+      variant_codec.from_type[type](r_value, value);
+      break;
+    }
+    case 7:
+      fuzz_packed(r_value, fuzz_packed_types[fuzz_next() % FUZZ_COUNT(fuzz_packed_types)], NULL);
+      break;
+    case 8: {
+      GDExtensionVariantType type = GDEXTENSION_VARIANT_TYPE_PACKED_STRING_ARRAY;
+      uint8_t array[GD_BUILTIN_SIZE_PACKED_STRING_ARRAY];
+      GDExtensionInt count = fuzz_next() % 5;
+      variant_codec.default_constructor[type](array, NULL);
+      variant_codec_resize(type, array, count);
+      for (GDExtensionInt i = 0; i < count; i++) {
+        GDExtensionTypePtr string = variant_codec.packed_index[type](array, i);
+        variant_codec.destructor[GDEXTENSION_VARIANT_TYPE_STRING](string);
+        fuzz_string(string);
+      }
+      variant_codec_wrap(type, r_value, array);
+      break;
+    }
+    case 9:
+      fuzz_array(r_value, NULL, depth);
+      break;
+    default:
+      fuzz_dictionary(r_value, NULL, depth);
+      break;
+  }
+}
+
+// Same type and equal by Godot's own ==, which compares containers deeply
+bool variants_equal(GDExtensionConstVariantPtr p_a, GDExtensionConstVariantPtr p_b) {
+  if (gd_extension.variant_get_type(p_a) != gd_extension.variant_get_type(p_b)) return false;
+  uint8_t res[VARIANT_SIZE];
+  GDExtensionBool valid;
+  gd_extension.variant_evaluate(GDEXTENSION_VARIANT_OP_EQUAL, p_a, p_b, res, &valid);
+  GDExtensionBool equal = false;
+  if (valid) variant_codec.to_type[GDEXTENSION_VARIANT_TYPE_BOOL](&equal, res);
+  gd_extension.variant_destroy(res);
+  return valid && equal;
+}
+
+// Decodes `p_data` and compares the result with `p_expected`
+bool fuzz_check(const uint8_t *p_data, size_t p_size, GDExtensionConstVariantPtr p_expected, GDExtensionConstVariantPtr p_baseline) {
+  variant_codec_reader_t reader = variant_codec_reader(p_data, p_size);
+  uint8_t decoded[GD_BUILTIN_SIZE_VARIANT];
+  bool ok = variant_codec_decode(&reader, decoded, p_baseline)
+            && reader.position == p_size
+            && variants_equal(decoded, p_expected);
+  gd_extension.variant_destroy(decoded);
+  return ok;
+}
+
+typedef struct {
+  int decodes;
+  // Malformed data the decoder turned down, and mutations that happened to
+  // be valid data
+  int refused;
+  int accepted;
+  // Read past the end, accepted data that must be refused, or failed without
+  // an error or without leaving Nil behind
+  int broken;
+} fuzz_malformed_t;
+
+// Decodes from a copy of exactly `p_size` bytes, so a read past the end
+// lands outside the allocation where sanitizers see it
+void fuzz_decode_exact(const uint8_t *p_data, size_t p_size, GDExtensionConstVariantPtr p_baseline, bool p_must_fail, fuzz_malformed_t *stats) {
+  uint8_t *copy = malloc(p_size > 0 ? p_size : 1);
+  memcpy(copy, p_data, p_size);
+
+  variant_codec_reader_t reader = variant_codec_reader(copy, p_size);
+  uint8_t decoded[GD_BUILTIN_SIZE_VARIANT];
+  bool ok = variant_codec_decode(&reader, decoded, p_baseline);
+  bool clean = reader.position <= p_size
+    && (ok ? reader.error == VARIANT_CODEC_OK && !p_must_fail
+           : reader.error != VARIANT_CODEC_OK
+             && gd_extension.variant_get_type(decoded) == GDEXTENSION_VARIANT_TYPE_NIL);
+  gd_extension.variant_destroy(decoded);
+  free(copy);
+
+  stats->decodes++;
+  if (ok) {
+    stats->accepted++;
+  } else {
+    stats->refused++;
+  }
+  if (!clean) stats->broken++;
+}
+
+// Feeds the decoder broken copies of a valid encoding: cut short, with random
+// bytes changed, and with the length of a String or container made bigger
+// than the data
+void fuzz_malformed(const uint8_t *p_data, size_t p_size, GDExtensionConstVariantPtr p_baseline, fuzz_malformed_t *stats) {
+  for (size_t cut = 0; cut < p_size; cut += 1 + p_size / 16) {
+    fuzz_decode_exact(p_data, cut, p_baseline, true, stats);
+  }
+
+  uint8_t *mutated = malloc(p_size);
+  for (int i = 0; i < FUZZ_MUTATIONS && p_size > VARIANT_CODEC_HEADER_SIZE; i++) {
+    memcpy(mutated, p_data, p_size);
+    // The header is left alone, most changes to it are refused right away
+    int changes = 1 + fuzz_next() % 3;
+    for (int j = 0; j < changes; j++) {
+      size_t at = VARIANT_CODEC_HEADER_SIZE + fuzz_next() % (p_size - VARIANT_CODEC_HEADER_SIZE);
+      mutated[at] ^= (uint8_t)(1 + fuzz_next() % 255);
+    }
+    fuzz_decode_exact(mutated, p_size, p_baseline, false, stats);
+  }
+  free(mutated);
+
+  // Only full encodings, where the length follows the value's tag (and the
+  // packed array's type) right after the header
+  size_t at = VARIANT_CODEC_HEADER_SIZE;
+  if (p_baseline != NULL || p_size <= at) return;
+  uint8_t tag = p_data[at++];
+  if (tag == VARIANT_CODEC_TAG_PACKED) at++;
+  if (tag != VARIANT_CODEC_TAG_STRING && tag != VARIANT_CODEC_TAG_STRING_NAME && tag != VARIANT_CODEC_TAG_PACKED
+      && tag != VARIANT_CODEC_TAG_PACKED_STRINGS && tag != VARIANT_CODEC_TAG_ARRAY && tag != VARIANT_CODEC_TAG_DICTIONARY) {
+    return;
+  }
+
+  variant_codec_reader_t reader = variant_codec_reader(p_data, p_size);
+  reader.position = at;
+  uint64_t length;
+  if (!variant_codec_take_varint(&reader, &length)) return;
+
+  const uint64_t extra[] = { 1, (uint64_t)1 << 40 };
+  uint8_t *inflated = malloc(p_size + 16);
+  for (size_t i = 0; i < sizeof(extra) / sizeof(extra[0]); i++) {
+    memcpy(inflated, p_data, at);
+    variant_codec_writer_t writer = variant_codec_writer(inflated + at, 16);
+    variant_codec_put_varint(&writer, length + extra[i]);
+    memcpy(inflated + at + writer.size, p_data + reader.position, p_size - reader.position);
+    fuzz_decode_exact(inflated, at + writer.size + p_size - reader.position, NULL, true, stats);
+  }
+  free(inflated);
+}
+
+void print_fuzz_results() {
+  size_t capacity = 1 << 20;
+  uint8_t *data = malloc(capacity);
+  uint8_t previous[GD_BUILTIN_SIZE_VARIANT];
+  gd_extension.variant_new_nil(previous);
+
+  int failures = 0;
+  size_t full_bytes = 0;
+  size_t delta_bytes = 0;
+  fuzz_malformed_t malformed = { 0 };
+  for (int round = 0; round < FUZZ_ROUNDS; round++) {
+    uint8_t value[GD_BUILTIN_SIZE_VARIANT];
+    // Start over now and then, so deltas against Nil get tested too
+    fuzz_value(value, round % 100 == 0 ? NULL : previous, 0);
+
+    variant_codec_writer_t writer = variant_codec_writer(data, capacity);
+    bool ok = variant_codec_encode(&writer, value, NULL) && fuzz_check(data, writer.size, value, NULL);
+    if (ok) fuzz_malformed(data, writer.size, NULL, &malformed);
+    full_bytes += writer.size;
+
+    writer = variant_codec_writer(data, capacity);
+    ok = ok && variant_codec_encode(&writer, value, previous) && fuzz_check(data, writer.size, value, previous);
+    if (ok) fuzz_malformed(data, writer.size, previous, &malformed);
+    delta_bytes += writer.size;
+
+    if (!ok && failures++ < 5) {
+      printf("variant codec fuzz: round %d failed (%s)\n", round, variant_codec_error_name(writer.error));
+    }
+    gd_extension.variant_destroy(previous);
+    gd_extension.variant_new_copy(previous, value);
+    gd_extension.variant_destroy(value);
+  }
+
+  // Data the decoder must refuse: another version, and a delta without its baseline
+  variant_codec_writer_t writer = variant_codec_writer(data, capacity);
+  variant_codec_encode(&writer, previous, previous);
+  variant_codec_reader_t reader = variant_codec_reader(data, writer.size);
+  uint8_t decoded[GD_BUILTIN_SIZE_VARIANT];
+  variant_codec_decode(&reader, decoded, NULL);
+  bool refused = reader.error == VARIANT_CODEC_ERROR_BASELINE;
+  gd_extension.variant_destroy(decoded);
+  data[2] = VARIANT_CODEC_VERSION + 1;
+  reader = variant_codec_reader(data, writer.size);
+  variant_codec_decode(&reader, decoded, previous);
+  refused = refused && reader.error == VARIANT_CODEC_ERROR_VERSION;
+  gd_extension.variant_destroy(decoded);
+
+  printf("variant codec fuzz: %d round trips, %d failed, bad headers %s, average %.1f bytes full, %.1f bytes delta\n",
+         FUZZ_ROUNDS, failures, refused ? "refused" : "NOT refused",
+         (double)full_bytes / FUZZ_ROUNDS, (double)delta_bytes / FUZZ_ROUNDS);
+  printf("variant codec fuzz: %d malformed decodes (cut short, mutated, lengths inflated), %d refused, %d mutations still valid, %d broken\n",
+         malformed.decodes, malformed.refused, malformed.accepted, malformed.broken);
+
+  gd_extension.variant_destroy(previous);
+  free(data);
+}
+
+// ---------------------------------------------------------------------------
+// Throughput against var_to_bytes
+// ---------------------------------------------------------------------------
+
+void set_entry(GDExtensionTypePtr p_dictionary, const char *p_key, GDExtensionVariantType p_type, const void *p_value) {
+  uint8_t key[GD_BUILTIN_SIZE_VARIANT];
+  uint8_t key_string[GD_BUILTIN_SIZE_STRING];
+  gd_string_new(key_string, p_key, strlen(p_key));
+  variant_codec_wrap(GDEXTENSION_VARIANT_TYPE_STRING, key, key_string);
+  GDExtensionVariantPtr value = gd_extension.dictionary_operator_index(p_dictionary, key);
+  gd_extension.variant_destroy(value);
+  variant_codec.from_type[p_type](value, (void *)p_value);
+  gd_extension.variant_destroy(key);
+}
+
+// What a server sends every tick: an Array of entity Dictionaries. On every
+// tick a quarter of the entities move.
+void make_snapshot(GDExtensionUninitializedVariantPtr r_snapshot, int p_tick) {
+  uint8_t entities[GD_BUILTIN_SIZE_ARRAY];
+  gd_container.array_constructor(entities, NULL);
+  variant_codec_resize(GDEXTENSION_VARIANT_TYPE_ARRAY, entities, SNAPSHOT_ENTITIES);
+
+  for (int i = 0; i < SNAPSHOT_ENTITIES; i++) {
+    int moves = (p_tick + (i % 4 == 0 ? 1 : 0)) / 2;
+    float position[2] = { i * 16.0f + moves, 100.0f + moves * 0.5f };
+    float velocity[2] = { 1.0f, 0.5f };
+    GDExtensionInt health = 100 - i % 7;
+    uint8_t name[GD_BUILTIN_SIZE_STRING];
+    char utf8[32];
+    int length = snprintf(utf8, sizeof(utf8), "enemy_%d", i);
+    gd_string_new(name, utf8, length);
+
+    uint8_t path[GD_BUILTIN_SIZE_PACKED_VECTOR2_ARRAY];
+    variant_codec.default_constructor[GDEXTENSION_VARIANT_TYPE_PACKED_VECTOR2_ARRAY](path, NULL);
+    variant_codec_resize(GDEXTENSION_VARIANT_TYPE_PACKED_VECTOR2_ARRAY, path, 8);
+    float *points = variant_codec.packed_index[GDEXTENSION_VARIANT_TYPE_PACKED_VECTOR2_ARRAY](path, 0);
+    for (int p = 0; p < 16; p++) points[p] = position[p % 2] + p * 8.0f;
+
+    uint8_t dictionary[GD_BUILTIN_SIZE_DICTIONARY];
+    variant_codec.default_constructor[GDEXTENSION_VARIANT_TYPE_DICTIONARY](dictionary, NULL);
+    set_entry(dictionary, "position", GDEXTENSION_VARIANT_TYPE_VECTOR2, position);
+    set_entry(dictionary, "velocity", GDEXTENSION_VARIANT_TYPE_VECTOR2, velocity);
+    set_entry(dictionary, "health", GDEXTENSION_VARIANT_TYPE_INT, &health);
+    set_entry(dictionary, "name", GDEXTENSION_VARIANT_TYPE_STRING, name);
+    set_entry(dictionary, "path", GDEXTENSION_VARIANT_TYPE_PACKED_VECTOR2_ARRAY, path);
+    variant_codec.from_type[GDEXTENSION_VARIANT_TYPE_DICTIONARY](gd_array_at(entities, i), dictionary);
+
+    variant_codec.destructor[GDEXTENSION_VARIANT_TYPE_DICTIONARY](dictionary);
+    variant_codec.destructor[GDEXTENSION_VARIANT_TYPE_PACKED_VECTOR2_ARRAY](path);
+    variant_codec.destructor[GDEXTENSION_VARIANT_TYPE_STRING](name);
+  }
+  variant_codec_wrap(GDEXTENSION_VARIANT_TYPE_ARRAY, r_snapshot, entities);
+}
+
+void print_throughput() {
+  uint8_t previous[GD_BUILTIN_SIZE_VARIANT];
+  uint8_t snapshot[GD_BUILTIN_SIZE_VARIANT];
+  make_snapshot(previous, 0);
+  make_snapshot(snapshot, 1);
+
+  // var_to_bytes and bytes_to_var, the way GDScript would send it
+  unsigned char bytes[PACKED_ARRAY_SIZE];
+  gd_extension_helper.constructor.packed_byte_array(&bytes, NULL);
+  GDExtensionConstTypePtr var_args[] = { snapshot };
+  GDExtensionConstTypePtr bytes_args[] = { &bytes };
+  uint8_t decoded[GD_BUILTIN_SIZE_VARIANT];
+  bool godot_ok = true;
+  uint64_t start = now_ns();
+  for (int round = 0; round < BENCHMARK_ROUNDS; round++) {
+    // `bytes` is already constructed, the utility function assigns to it
+    gd_extension_helper.utility.var_to_bytes(&bytes, var_args, 1);
+    gd_extension.variant_new_nil(decoded);
+    gd_extension_helper.utility.bytes_to_var(decoded, bytes_args, 1);
+    if (round == 0) godot_ok = variants_equal(decoded, snapshot);
+    gd_extension.variant_destroy(decoded);
+  }
+  uint64_t godot_ns = now_ns() - start;
+  GDExtensionInt godot_size = packed_byte_array_size(&bytes);
+  gd_extension_helper.destructor.packed_byte_array(&bytes);
+
+  size_t capacity = 1 << 20;
+  uint8_t *data = malloc(capacity);
+  size_t sizes[2] = { 0, 0 };
+  uint64_t codec_ns[2] = { 0, 0 };
+  bool codec_ok[2] = { true, true };
+  for (int delta = 0; delta < 2; delta++) {
+    GDExtensionConstVariantPtr baseline = delta ? previous : NULL;
+    start = now_ns();
+    for (int round = 0; round < BENCHMARK_ROUNDS; round++) {
+      variant_codec_writer_t writer = variant_codec_writer(data, capacity);
+      variant_codec_encode(&writer, snapshot, baseline);
+      variant_codec_reader_t reader = variant_codec_reader(data, writer.size);
+      variant_codec_decode(&reader, decoded, baseline);
+      if (round == 0) {
+        codec_ok[delta] = writer.error == VARIANT_CODEC_OK && variants_equal(decoded, snapshot);
+        sizes[delta] = writer.size;
+      }
+      gd_extension.variant_destroy(decoded);
+    }
+    codec_ns[delta] = now_ns() - start;
+  }
+  free(data);
+
+  printf("snapshot of %d entities, encode + decode per tick:\n", SNAPSHOT_ENTITIES);
+  printf("  var_to_bytes:       %6lld bytes, %8.1f us (%s)\n",
+         (long long)godot_size, godot_ns / 1000.0 / BENCHMARK_ROUNDS, godot_ok ? "ok" : "WRONG");
+  printf("  variant codec:      %6zu bytes, %8.1f us (%s)\n",
+         sizes[0], codec_ns[0] / 1000.0 / BENCHMARK_ROUNDS, codec_ok[0] ? "ok" : "WRONG");
+  printf("  variant codec delta:%6zu bytes, %8.1f us (%s)\n",
+         sizes[1], codec_ns[1] / 1000.0 / BENCHMARK_ROUNDS, codec_ok[1] ? "ok" : "WRONG");
+
+  gd_extension.variant_destroy(previous);
+  gd_extension.variant_destroy(snapshot);
+}
+
+void godot_initialize(void *userdata, GDExtensionInitializationLevel p_level) {
+  if (p_level == GDEXTENSION_INITIALIZATION_SCENE) {
+    void *size_string_name = construct_string_name("size");
+    void *resize_string_name = construct_string_name("resize");
+    gd_extension_helper.builtin_method.packed_byte_array_size
+      = gd_extension.variant_get_ptr_builtin_method(GDEXTENSION_VARIANT_TYPE_PACKED_BYTE_ARRAY,
+                                                    size_string_name,
+                                                    PACKED_SIZE_HASH);
+    gd_extension_helper.builtin_method.packed_byte_array_resize
+      = gd_extension.variant_get_ptr_builtin_method(GDEXTENSION_VARIANT_TYPE_PACKED_BYTE_ARRAY,
+                                                    resize_string_name,
+                                                    PACKED_RESIZE_HASH);
+    destruct_string_name(size_string_name);
+    destruct_string_name(resize_string_name);
+
+    void *var_to_bytes_string_name = construct_string_name("var_to_bytes");
+    void *bytes_to_var_string_name = construct_string_name("bytes_to_var");
+    gd_extension_helper.utility.var_to_bytes
+      = gd_extension.variant_get_ptr_utility_function(var_to_bytes_string_name, VAR_TO_BYTES_HASH);
+    gd_extension_helper.utility.bytes_to_var
+      = gd_extension.variant_get_ptr_utility_function(bytes_to_var_string_name, BYTES_TO_VAR_HASH);
+    destruct_string_name(var_to_bytes_string_name);
+    destruct_string_name(bytes_to_var_string_name);
+
+    register_codec_class();
+
+    print_fuzz_results();
+    print_throughput();
+    return;
+  }
+}
+
+void godot_deinitialize(void *userdata, GDExtensionInitializationLevel p_level) {
+}
+
+GDExtensionBool
+godot_entry(
+  GDExtensionInterfaceGetProcAddress p_get_proc_address,
+  const GDExtensionClassLibraryPtr p_library,
+  GDExtensionInitialization *r_initialization
+) {
+  r_initialization->minimum_initialization_level = GDEXTENSION_INITIALIZATION_SCENE;
+  r_initialization->userdata = NULL;
+  r_initialization->initialize = godot_initialize;
+  r_initialization->deinitialize = godot_deinitialize;
+
+  STORE_GD_EXTENSION(classdb_construct_object);
+  STORE_GD_EXTENSION(classdb_register_extension_class2);
+  STORE_GD_EXTENSION(classdb_register_extension_class_method);
+  STORE_GD_EXTENSION(string_name_new_with_utf8_chars);
+  STORE_GD_EXTENSION(string_new_with_utf8_chars);
+  STORE_GD_EXTENSION(string_new_with_utf32_chars_and_len);
+  STORE_GD_EXTENSION(object_set_instance);
+  STORE_GD_EXTENSION(variant_get_ptr_destructor);
+  STORE_GD_EXTENSION(variant_get_ptr_constructor);
+  STORE_GD_EXTENSION(variant_get_ptr_builtin_method);
+  STORE_GD_EXTENSION(variant_get_ptr_utility_function);
+  STORE_GD_EXTENSION(get_variant_from_type_constructor);
+  STORE_GD_EXTENSION(get_variant_to_type_constructor);
+  STORE_GD_EXTENSION(variant_get_type);
+  STORE_GD_EXTENSION(variant_new_copy);
+  STORE_GD_EXTENSION(variant_new_nil);
+  STORE_GD_EXTENSION(variant_destroy);
+  STORE_GD_EXTENSION(variant_evaluate);
+  STORE_GD_EXTENSION(array_operator_index);
+  STORE_GD_EXTENSION(dictionary_operator_index);
+  STORE_GD_EXTENSION(packed_byte_array_operator_index);
+  STORE_GD_EXTENSION(packed_byte_array_operator_index_const);
+
+  gd_extension_helper.misc.p_library = p_library;
+
+  gd_extension_helper.destructor.string_name
+    = gd_extension.variant_get_ptr_destructor(GDEXTENSION_VARIANT_TYPE_STRING_NAME);
+  gd_extension_helper.destructor.string
+    = gd_extension.variant_get_ptr_destructor(GDEXTENSION_VARIANT_TYPE_STRING);
+  gd_extension_helper.destructor.packed_byte_array
+    = gd_extension.variant_get_ptr_destructor(GDEXTENSION_VARIANT_TYPE_PACKED_BYTE_ARRAY);
+
+  gd_extension_helper.constructor.packed_byte_array
+    = gd_extension.variant_get_ptr_constructor(GDEXTENSION_VARIANT_TYPE_PACKED_BYTE_ARRAY, 0);
+
+  gd_extension_helper.wrap.type_int
+    = gd_extension.get_variant_from_type_constructor(GDEXTENSION_VARIANT_TYPE_INT);
+  gd_extension_helper.wrap.packed_byte_array
+    = gd_extension.get_variant_from_type_constructor(GDEXTENSION_VARIANT_TYPE_PACKED_BYTE_ARRAY);
+
+  gd_extension_helper.unwrap.type_int
+    = gd_extension.get_variant_to_type_constructor(GDEXTENSION_VARIANT_TYPE_INT);
+  gd_extension_helper.unwrap.packed_byte_array
+    = gd_extension.get_variant_to_type_constructor(GDEXTENSION_VARIANT_TYPE_PACKED_BYTE_ARRAY);
+
+  variant_codec_init(p_get_proc_address);
+
+  return true;
+}
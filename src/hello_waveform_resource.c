@@ -0,0 +1,956 @@
+#include "../godot-headers/gdextension_interface.h"
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <math.h>
+
+#define STORE_GD_EXTENSION(str_name) gd_extension.str_name = (void *)p_get_proc_address(#str_name);
+#define IS_GODOT_64_BIT (true)
+#define IS_GODOT_USING_LARGE_WORLD_COORDINATES (false)
+#define VARIANT_SIZE (IS_GODOT_USING_LARGE_WORLD_COORDINATES ? 40 : 24)
+#define PACKED_ARRAY_SIZE (16)
+#define MY_CUSTOM_CLASS_NAME ("MyCustomNode")
+#define MY_CUSTOM_CLASS_PARENT ("Sprite2D")
+#define WAVEFORM_CLASS_NAME ("Waveform")
+#define WAVEFORM_CLASS_PARENT ("Resource")
+#define WAVEFORM_DEFAULT_RESOLUTION (256)
+#define WAVEFORM_MAX_RESOLUTION (65536)
+#define PROPERTY_HINT_RANGE (1)
+#define PROPERTY_HINT_ENUM (2)
+#define PROPERTY_HINT_RESOURCE_TYPE (17)
+
+#include "../util/variant_unwrap.h"
+
+struct {
+  GDExtensionInterfaceClassdbConstructObject classdb_construct_object;
+  GDExtensionInterfaceClassdbRegisterExtensionClass2 classdb_register_extension_class2;
+  GDExtensionInterfaceClassdbGetMethodBind classdb_get_method_bind;
+  GDExtensionInterfaceClassdbGetClassTag classdb_get_class_tag;
+  GDExtensionInterfaceStringNameNewWithUtf8Chars string_name_new_with_utf8_chars;
+  GDExtensionInterfaceStringNewWithUtf8Chars string_new_with_utf8_chars;
+  GDExtensionInterfaceObjectSetInstance object_set_instance;
+  GDExtensionInterfaceObjectSetInstanceBinding object_set_instance_binding;
+  GDExtensionInterfaceObjectGetInstanceBinding object_get_instance_binding;
+  GDExtensionInterfaceObjectCastTo object_cast_to;
+  GDExtensionInterfaceObjectDestroy object_destroy;
+  GDExtensionInterfaceVariantGetPtrDestructor variant_get_ptr_destructor;
+  GDExtensionInterfaceVariantGetPtrConstructor variant_get_ptr_constructor;
+  GDExtensionInterfaceVariantGetPtrBuiltinMethod variant_get_ptr_builtin_method;
+  GDExtensionInterfaceGetVariantFromTypeConstructor get_variant_from_type_constructor;
+  GDExtensionInterfaceGetVariantToTypeConstructor get_variant_to_type_constructor;
+  GDExtensionInterfaceVariantGetPtrOperatorEvaluator variant_get_ptr_operator_evaluator;
+  GDExtensionInterfaceVariantGetType variant_get_type;
+  GDExtensionInterfaceObjectMethodBindPtrcall object_method_bind_ptrcall;
+  GDExtensionInterfacePackedFloat32ArrayOperatorIndexConst packed_float32_array_operator_index_const;
+} gd_extension;
+
+struct {
+  struct {
+    GDExtensionPtrDestructor string_name;
+    GDExtensionPtrDestructor string;
+    GDExtensionPtrDestructor packed_float32_array;
+  } destructor;
+  struct {
+    GDExtensionPtrConstructor packed_float32_array;
+  } constructor;
+  struct {
+    GDExtensionPtrBuiltInMethod packed_float32_array_size;
+  } builtin_method;
+  struct {
+    GDExtensionVariantFromTypeConstructorFunc type_double;
+    GDExtensionVariantFromTypeConstructorFunc type_int;
+    GDExtensionVariantFromTypeConstructorFunc object;
+    GDExtensionVariantFromTypeConstructorFunc packed_float32_array;
+  } wrap;
+  struct {
+    GDExtensionTypeFromVariantConstructorFunc packed_float32_array;
+  } unwrap;
+  struct {
+    GDExtensionStringNamePtr amplitude;
+    GDExtensionStringNamePtr frequency;
+    GDExtensionStringNamePtr waveform;
+    GDExtensionStringNamePtr shape;
+    GDExtensionStringNamePtr resolution;
+    GDExtensionStringNamePtr custom_samples;
+    GDExtensionStringNamePtr _process;
+  } string_name;
+  struct {
+    GDExtensionClassLibraryPtr p_library;
+    GDExtensionPtrOperatorEvaluator string_name_eq_op;
+    GDExtensionMethodBindPtr node2d_set_position;
+    GDExtensionMethodBindPtr ref_counted_reference;
+    GDExtensionMethodBindPtr ref_counted_unreference;
+    void *waveform_class_tag;
+  } misc;
+} gd_extension_helper;
+
+#if (IS_GODOT_USING_LARGE_WORLD_COORDINATES)
+typedef struct {
+  double x;
+  double y;
+} GDVector2;
+#else
+typedef struct {
+  float x;
+  float y;
+} GDVector2;
+#endif
+
+GDExtensionStringNamePtr construct_string_name(const char *c_string) {
+  void *res = malloc(IS_GODOT_64_BIT ? 8 : 4);
+  gd_extension.string_name_new_with_utf8_chars(res, c_string);
+  return res;
+}
+
+GDExtensionStringPtr construct_string(const char *c_string) {
+  void *res = malloc(IS_GODOT_64_BIT ? 8 : 4);
+  gd_extension.string_new_with_utf8_chars(res, c_string);
+  return res;
+}
+
+void destruct_string_name(GDExtensionStringNamePtr p) {
+  gd_extension_helper.destructor.string_name(p);
+}
+
+void destruct_string(GDExtensionStringPtr p) {
+  gd_extension_helper.destructor.string(p);
+}
+
+bool string_name_eq(const void *a, const void *b) {
+  GDExtensionBool res;
+  gd_extension_helper.misc.string_name_eq_op(a, b, &res);
+  return res;
+}
+
+// Used by both classes to find their instance struct from a Godot object
+void *binding_create(void *p_token, void *p_instance) {
+  return NULL;
+}
+
+void binding_free(void *p_token, void *p_instance, void *p_binding) {
+}
+
+GDExtensionBool binding_reference(void *p_token, void *p_binding, GDExtensionBool p_reference) {
+  return true;
+}
+
+const GDExtensionInstanceBindingCallbacks binding_callbacks = {
+  .create_callback = binding_create,
+  .free_callback = binding_free,
+  .reference_callback = binding_reference,
+};
+
+// ---------------------------------------------------------------------------
+// Waveform tables
+// ---------------------------------------------------------------------------
+
+typedef enum {
+  WAVEFORM_SHAPE_SINE,
+  WAVEFORM_SHAPE_TRIANGLE,
+  WAVEFORM_SHAPE_SQUARE,
+  WAVEFORM_SHAPE_SAW,
+  WAVEFORM_SHAPE_CUSTOM,
+  WAVEFORM_SHAPE_COUNT,
+} waveform_shape_t;
+
+// A table is immutable while it's shared. Changing the waveform refills the
+// table in place only when the resource holds the sole reference, otherwise
+// it builds a new one and swaps it in (copy-on-write), so readers never see a
+// half-built table. The refcount is atomic because the last reference may be
+// dropped from any thread.
+typedef struct {
+  atomic_uint refcount;
+  uint32_t resolution;
+  // `resolution + 1` samples over one period, the last one repeats the first so
+  // that interpolation never has to wrap the index.
+  float samples[];
+} waveform_table_t;
+
+waveform_table_t *waveform_table_alloc(uint32_t resolution) {
+  waveform_table_t *table = malloc(sizeof(waveform_table_t) + (resolution + 1) * sizeof(float));
+  atomic_init(&table->refcount, 1);
+  table->resolution = resolution;
+  return table;
+}
+
+waveform_table_t *waveform_table_acquire(waveform_table_t *table) {
+  atomic_fetch_add_explicit(&table->refcount, 1, memory_order_relaxed);
+  return table;
+}
+
+void waveform_table_release(waveform_table_t *table) {
+  if (table == NULL) return;
+  if (atomic_fetch_sub_explicit(&table->refcount, 1, memory_order_acq_rel) == 1) {
+    free(table);
+  }
+}
+
+// Evaluates one period of the shape at `phase` in [0, 1)
+float waveform_shape_eval(waveform_shape_t shape,
+                          double phase,
+                          const float *custom,
+                          size_t custom_count) {
+  switch (shape) {
+  case WAVEFORM_SHAPE_SINE:
+    return sin(phase * 2.0 * M_PI);
+  case WAVEFORM_SHAPE_TRIANGLE:
+    return phase < 0.25 ? 4.0 * phase
+      : phase < 0.75 ? 2.0 - 4.0 * phase
+      : 4.0 * phase - 4.0;
+  case WAVEFORM_SHAPE_SQUARE:
+    return phase < 0.5 ? 1.0 : -1.0;
+  case WAVEFORM_SHAPE_SAW:
+    return phase < 0.5 ? 2.0 * phase : 2.0 * phase - 2.0;
+  case WAVEFORM_SHAPE_CUSTOM: {
+    // Custom samples are one evenly spaced period, resampled linearly
+    if (custom_count == 0) return 0.0;
+    double x = phase * custom_count;
+    size_t i = (size_t)x;
+    double t = x - i;
+    float a = custom[i % custom_count];
+    float b = custom[(i + 1) % custom_count];
+    return a + (b - a) * t;
+  }
+  default:
+    return 0.0;
+  }
+}
+
+// Fills `table` in place. Only call this on a table nobody else can read.
+void waveform_table_fill(waveform_table_t *table,
+                         waveform_shape_t shape,
+                         const float *custom,
+                         size_t custom_count) {
+  for (uint32_t i = 0; i < table->resolution; i++) {
+    double phase = (double)i / table->resolution;
+    table->samples[i] = waveform_shape_eval(shape, phase, custom, custom_count);
+  }
+  table->samples[table->resolution] = table->samples[0];
+}
+
+// Hot path: one multiply, one floor and two neighbouring loads instead of `sin`
+static inline float waveform_table_sample(const waveform_table_t *table, double phase) {
+  phase -= floor(phase);
+  double x = phase * table->resolution;
+  uint32_t i = (uint32_t)x;
+  if (i >= table->resolution) i = table->resolution - 1;
+  float t = x - i;
+  float a = table->samples[i];
+  float b = table->samples[i + 1];
+  return a + (b - a) * t;
+}
+
+// ---------------------------------------------------------------------------
+// Waveform resource
+// ---------------------------------------------------------------------------
+
+typedef struct {
+  GDExtensionObjectPtr godot_object;
+  // Mirrors the engine refcount through `reference_func`/`unreference_func`.
+  // RefCounted can be referenced from any thread, hence the atomic.
+  atomic_uint engine_refcount;
+  waveform_shape_t shape;
+  uint32_t resolution;
+  unsigned char custom_samples[PACKED_ARRAY_SIZE];
+  // Never NULL. Nodes compare against it every frame without locking, but
+  // only take a reference with `table_lock` held, see `waveform_acquire_table`.
+  _Atomic(waveform_table_t *) table;
+  // Orders a reader's load + acquire against the swap + release of the old
+  // table, so the table can't be freed between the two. Since references are
+  // only ever taken with it held, a refcount of 1 seen under the lock stays 1
+  // until it's unlocked.
+  pthread_mutex_t table_lock;
+} waveform_t;
+
+// Returns a new reference to the current table, for the caller to release
+waveform_table_t *waveform_acquire_table(waveform_t *waveform) {
+  pthread_mutex_lock(&waveform->table_lock);
+  waveform_table_t *table = atomic_load_explicit(&waveform->table, memory_order_relaxed);
+  waveform_table_acquire(table);
+  pthread_mutex_unlock(&waveform->table_lock);
+  return table;
+}
+
+void waveform_rebuild_table(waveform_t *waveform) {
+  GDExtensionInt custom_count = 0;
+  const float *custom = NULL;
+
+  if (waveform->shape == WAVEFORM_SHAPE_CUSTOM) {
+    gd_extension_helper.builtin_method.packed_float32_array_size(&waveform->custom_samples,
+                                                                 NULL,
+                                                                 &custom_count,
+                                                                 0);
+    if (custom_count > 0) {
+      custom = gd_extension.packed_float32_array_operator_index_const(&waveform->custom_samples, 0);
+    }
+  }
+
+  // When no node holds the current table and the size still fits, refill it.
+  // The acquire pairs with the release of the last node that let go of it.
+  pthread_mutex_lock(&waveform->table_lock);
+  waveform_table_t *current = atomic_load_explicit(&waveform->table, memory_order_relaxed);
+  if (current != NULL
+      && current->resolution == waveform->resolution
+      && atomic_load_explicit(&current->refcount, memory_order_acquire) == 1) {
+    waveform_table_fill(current, waveform->shape, custom, custom_count);
+    pthread_mutex_unlock(&waveform->table_lock);
+    return;
+  }
+  pthread_mutex_unlock(&waveform->table_lock);
+
+  // Shared, a node may be sampling it right now, so fill a copy
+  waveform_table_t *table = waveform_table_alloc(waveform->resolution);
+  waveform_table_fill(table, waveform->shape, custom, custom_count);
+
+  pthread_mutex_lock(&waveform->table_lock);
+  waveform_table_t *old = atomic_exchange_explicit(&waveform->table, table, memory_order_release);
+  pthread_mutex_unlock(&waveform->table_lock);
+  // Nodes that already took a reference keep the old table alive
+  waveform_table_release(old);
+}
+
+struct {
+  const char *name;
+  const GDExtensionVariantType type;
+  const uint32_t hint;
+  const char *hint_string;
+} waveform_props[] = {
+  {
+    .name = "shape",
+    .type = GDEXTENSION_VARIANT_TYPE_INT,
+    .hint = PROPERTY_HINT_ENUM,
+    .hint_string = "Sine,Triangle,Square,Saw,Custom",
+  },
+  {
+    .name = "resolution",
+    .type = GDEXTENSION_VARIANT_TYPE_INT,
+    .hint = PROPERTY_HINT_RANGE,
+    .hint_string = "2,65536",
+  },
+  {
+    .name = "custom_samples",
+    .type = GDEXTENSION_VARIANT_TYPE_PACKED_FLOAT32_ARRAY,
+    .hint = 0,
+    .hint_string = "",
+  },
+};
+
+const GDExtensionPropertyInfo *
+waveform_get_property_list(
+  GDExtensionClassInstancePtr p_instance,
+  uint32_t *r_count
+) {
+  size_t n = sizeof(waveform_props) / sizeof(*waveform_props);
+  *r_count = n;
+
+  GDExtensionPropertyInfo *res = malloc(n * sizeof(GDExtensionPropertyInfo));
+
+  for (size_t i = 0; i < n; i++) {
+    res[i].type = waveform_props[i].type;
+    res[i].name = construct_string_name(waveform_props[i].name);
+    res[i].class_name = construct_string_name(WAVEFORM_CLASS_NAME);
+    res[i].hint = waveform_props[i].hint;
+    res[i].hint_string = construct_string(waveform_props[i].hint_string);
+    res[i].usage = 6; // Corresponds to default usage flags
+  }
+
+  return res;
+}
+
+void
+waveform_free_property_list(
+  GDExtensionClassInstancePtr p_instance,
+  const GDExtensionPropertyInfo *p_list
+) {
+  size_t n = sizeof(waveform_props) / sizeof(*waveform_props);
+
+  for (size_t i = 0; i < n; i++) {
+    destruct_string_name((void*)p_list[i].name);
+    destruct_string((void*)p_list[i].hint_string);
+    destruct_string_name((void*)p_list[i].class_name);
+  }
+
+  free((void*)p_list);
+}
+
+GDExtensionBool
+waveform_set_func(
+  GDExtensionClassInstancePtr p_instance,
+  GDExtensionConstStringNamePtr p_name,
+  GDExtensionConstVariantPtr p_value
+) {
+  waveform_t *waveform = p_instance;
+
+  if (string_name_eq(p_name, gd_extension_helper.string_name.shape)) {
+    GDExtensionInt shape;
+    if (!variant_unwrap_int(p_value, &shape)) return false;
+    if (shape < 0 || shape >= WAVEFORM_SHAPE_COUNT) return false;
+
+    waveform->shape = shape;
+    waveform_rebuild_table(waveform);
+    return true;
+  }
+
+  if (string_name_eq(p_name, gd_extension_helper.string_name.resolution)) {
+    GDExtensionInt resolution;
+    if (!variant_unwrap_int(p_value, &resolution)) return false;
+    if (resolution < 2 || resolution > WAVEFORM_MAX_RESOLUTION) return false;
+
+    waveform->resolution = resolution;
+    waveform_rebuild_table(waveform);
+    return true;
+  }
+
+  if (string_name_eq(p_name, gd_extension_helper.string_name.custom_samples)) {
+    if (gd_extension.variant_get_type(p_value) != GDEXTENSION_VARIANT_TYPE_PACKED_FLOAT32_ARRAY) {
+      return false;
+    }
+
+    gd_extension_helper.destructor.packed_float32_array(&waveform->custom_samples);
+    gd_extension_helper.unwrap.packed_float32_array(&waveform->custom_samples, (void *)p_value);
+    if (waveform->shape == WAVEFORM_SHAPE_CUSTOM) {
+      waveform_rebuild_table(waveform);
+    }
+    return true;
+  }
+
+  return false;
+}
+
+GDExtensionBool
+waveform_get_func(
+  GDExtensionClassInstancePtr p_instance,
+  GDExtensionConstStringNamePtr p_name,
+  GDExtensionVariantPtr r_ret
+) {
+  waveform_t *waveform = p_instance;
+
+  if (string_name_eq(p_name, gd_extension_helper.string_name.shape)) {
+    GDExtensionInt shape = waveform->shape;
+    gd_extension_helper.wrap.type_int(r_ret, &shape);
+    return true;
+  }
+
+  if (string_name_eq(p_name, gd_extension_helper.string_name.resolution)) {
+    GDExtensionInt resolution = waveform->resolution;
+    gd_extension_helper.wrap.type_int(r_ret, &resolution);
+    return true;
+  }
+
+  if (string_name_eq(p_name, gd_extension_helper.string_name.custom_samples)) {
+    gd_extension_helper.wrap.packed_float32_array(r_ret, &waveform->custom_samples);
+    return true;
+  }
+
+  return false;
+}
+
+GDExtensionObjectPtr waveform_init(void *userdata) {
+  waveform_t *waveform = malloc(sizeof(waveform_t));
+
+  void *my_class_string_name = construct_string_name(WAVEFORM_CLASS_NAME);
+  void *parent_class_string_name = construct_string_name(WAVEFORM_CLASS_PARENT);
+
+  waveform->godot_object = gd_extension.classdb_construct_object(parent_class_string_name);
+  atomic_init(&waveform->engine_refcount, 0);
+  waveform->shape = WAVEFORM_SHAPE_SINE;
+  waveform->resolution = WAVEFORM_DEFAULT_RESOLUTION;
+  gd_extension_helper.constructor.packed_float32_array(&waveform->custom_samples, NULL);
+  atomic_init(&waveform->table, NULL);
+  pthread_mutex_init(&waveform->table_lock, NULL);
+  waveform_rebuild_table(waveform);
+
+  gd_extension.object_set_instance(waveform->godot_object, my_class_string_name, waveform);
+  gd_extension.object_set_instance_binding(waveform->godot_object,
+                                           gd_extension_helper.misc.p_library,
+                                           waveform,
+                                           &binding_callbacks);
+
+  destruct_string_name(my_class_string_name);
+  destruct_string_name(parent_class_string_name);
+
+  return waveform->godot_object;
+}
+
+void waveform_deinit(void *userdata, GDExtensionClassInstancePtr p_instance) {
+  if (p_instance == NULL) return;
+
+  waveform_t *waveform = p_instance;
+  // Nodes that still hold the table keep it alive
+  waveform_table_release(atomic_load_explicit(&waveform->table, memory_order_relaxed));
+  pthread_mutex_destroy(&waveform->table_lock);
+  gd_extension_helper.destructor.packed_float32_array(&waveform->custom_samples);
+  free(waveform);
+}
+
+void waveform_reference(GDExtensionClassInstancePtr p_instance) {
+  waveform_t *waveform = p_instance;
+  atomic_fetch_add_explicit(&waveform->engine_refcount, 1, memory_order_relaxed);
+}
+
+void waveform_unreference(GDExtensionClassInstancePtr p_instance) {
+  waveform_t *waveform = p_instance;
+  atomic_fetch_sub_explicit(&waveform->engine_refcount, 1, memory_order_relaxed);
+}
+
+void register_waveform_class() {
+  GDExtensionClassCreationInfo2 class_info = {
+    .is_virtual = false,
+    .is_abstract = false,
+    .is_exposed = true,
+    .set_func = waveform_set_func,
+    .get_func = waveform_get_func,
+    .get_property_list_func = waveform_get_property_list,
+    .free_property_list_func = waveform_free_property_list,
+    .property_can_revert_func = NULL,
+    .property_get_revert_func = NULL,
+    .validate_property_func = NULL,
+    .notification_func = NULL,
+    .to_string_func = NULL,
+    .reference_func = waveform_reference,
+    .unreference_func = waveform_unreference,
+    .create_instance_func = waveform_init,
+    .free_instance_func = waveform_deinit,
+    .recreate_instance_func = NULL,
+    .get_virtual_func = NULL,
+    .get_virtual_call_data_func = NULL,
+    .call_virtual_with_data_func = NULL,
+    .get_rid_func = NULL,
+    .class_userdata = NULL,
+  };
+
+  void *my_class_string_name = construct_string_name(WAVEFORM_CLASS_NAME);
+  void *parent_class_string_name = construct_string_name(WAVEFORM_CLASS_PARENT);
+
+  gd_extension.classdb_register_extension_class2(gd_extension_helper.misc.p_library,
+                                                 my_class_string_name,
+                                                 parent_class_string_name,
+                                                 &class_info);
+
+  gd_extension_helper.misc.waveform_class_tag = gd_extension.classdb_get_class_tag(my_class_string_name);
+
+  destruct_string_name(my_class_string_name);
+  destruct_string_name(parent_class_string_name);
+}
+
+// ---------------------------------------------------------------------------
+// MyCustomNode
+// ---------------------------------------------------------------------------
+
+typedef struct {
+  GDExtensionObjectPtr godot_object;
+  double time_elapsed;
+  struct {
+    double amplitude;
+    double frequency;
+    // The Waveform resource, we hold an engine reference to it
+    GDExtensionObjectPtr waveform;
+  } prop_state;
+  // Our own reference to the waveform's current table. It's refreshed when
+  // the resource swaps its table, so the resource can't free it under us.
+  waveform_t *waveform_instance;
+  waveform_table_t *table;
+} my_custom_class_t;
+
+void ref_counted_reference(GDExtensionObjectPtr object) {
+  GDExtensionBool res;
+  gd_extension.object_method_bind_ptrcall(gd_extension_helper.misc.ref_counted_reference,
+                                          object,
+                                          NULL,
+                                          &res);
+}
+
+void ref_counted_unreference(GDExtensionObjectPtr object) {
+  GDExtensionBool should_free;
+  gd_extension.object_method_bind_ptrcall(gd_extension_helper.misc.ref_counted_unreference,
+                                          object,
+                                          NULL,
+                                          &should_free);
+  if (should_free) {
+    gd_extension.object_destroy(object);
+  }
+}
+
+void my_custom_class_set_waveform(my_custom_class_t *my_instance, GDExtensionObjectPtr waveform) {
+  if (waveform != NULL) {
+    ref_counted_reference(waveform);
+  }
+
+  waveform_table_release(my_instance->table);
+  my_instance->table = NULL;
+  my_instance->waveform_instance = NULL;
+
+  if (my_instance->prop_state.waveform != NULL) {
+    ref_counted_unreference(my_instance->prop_state.waveform);
+  }
+
+  my_instance->prop_state.waveform = waveform;
+
+  if (waveform != NULL) {
+    my_instance->waveform_instance
+      = gd_extension.object_get_instance_binding(waveform,
+                                                 gd_extension_helper.misc.p_library,
+                                                 &binding_callbacks);
+    my_instance->table = waveform_acquire_table(my_instance->waveform_instance);
+  }
+}
+
+struct {
+  const char *name;
+  const GDExtensionVariantType type;
+  const uint32_t hint;
+  const char *hint_string;
+} my_custom_class_props[] = {
+  {
+    .name = "frequency",
+    .type = GDEXTENSION_VARIANT_TYPE_FLOAT,
+    .hint = 0,
+    .hint_string = "",
+  },
+  {
+    .name = "amplitude",
+    .type = GDEXTENSION_VARIANT_TYPE_FLOAT,
+    .hint = 0,
+    .hint_string = "",
+  },
+  {
+    .name = "waveform",
+    .type = GDEXTENSION_VARIANT_TYPE_OBJECT,
+    .hint = PROPERTY_HINT_RESOURCE_TYPE,
+    .hint_string = WAVEFORM_CLASS_NAME,
+  },
+};
+
+const GDExtensionPropertyInfo *
+my_custom_class_get_property_list(
+  GDExtensionClassInstancePtr p_instance,
+  uint32_t *r_count
+) {
+  size_t n = sizeof(my_custom_class_props) / sizeof(*my_custom_class_props);
+  *r_count = n;
+
+  GDExtensionPropertyInfo *res = malloc(n * sizeof(GDExtensionPropertyInfo));
+
+  for (size_t i = 0; i < n; i++) {
+    res[i].type = my_custom_class_props[i].type;
+    res[i].name = construct_string_name(my_custom_class_props[i].name);
+    res[i].class_name = construct_string_name(MY_CUSTOM_CLASS_NAME);
+    res[i].hint = my_custom_class_props[i].hint;
+    res[i].hint_string = construct_string(my_custom_class_props[i].hint_string);
+    res[i].usage = 6; // Corresponds to default usage flags
+  }
+
+  return res;
+}
+
+void
+my_custom_class_free_property_list(
+  GDExtensionClassInstancePtr p_instance,
+  const GDExtensionPropertyInfo *p_list
+) {
+  size_t n = sizeof(my_custom_class_props) / sizeof(*my_custom_class_props);
+
+  for (size_t i = 0; i < n; i++) {
+    destruct_string_name((void*)p_list[i].name);
+    destruct_string((void*)p_list[i].hint_string);
+    destruct_string_name((void*)p_list[i].class_name);
+  }
+
+  free((void*)p_list);
+}
+
+GDExtensionObjectPtr my_custom_class_init(void *userdata) {
+  my_custom_class_t *my_instance = malloc(sizeof(my_custom_class_t));
+
+  void *my_class_string_name = construct_string_name(MY_CUSTOM_CLASS_NAME);
+  void *parent_class_string_name = construct_string_name(MY_CUSTOM_CLASS_PARENT);
+
+  my_instance->godot_object = gd_extension.classdb_construct_object(parent_class_string_name);
+  my_instance->time_elapsed = 0.0;
+  my_instance->prop_state.amplitude = 1.23;
+  my_instance->prop_state.frequency = 2.45;
+  my_instance->prop_state.waveform = NULL;
+  my_instance->waveform_instance = NULL;
+  my_instance->table = NULL;
+  gd_extension.object_set_instance(my_instance->godot_object, my_class_string_name, my_instance);
+
+  destruct_string_name(my_class_string_name);
+  destruct_string_name(parent_class_string_name);
+
+  return my_instance->godot_object;
+}
+
+void my_custom_class_deinit(void *userdata, GDExtensionClassInstancePtr p_instance) {
+  if (p_instance == NULL) return;
+
+  my_custom_class_t *my_instance = p_instance;
+  my_custom_class_set_waveform(my_instance, NULL);
+  free(my_instance);
+}
+
+GDExtensionBool
+my_custom_class_set_func(
+  GDExtensionClassInstancePtr p_instance,
+  GDExtensionConstStringNamePtr p_name,
+  GDExtensionConstVariantPtr p_value
+) {
+  my_custom_class_t *my_instance = p_instance;
+
+  if (string_name_eq(p_name, gd_extension_helper.string_name.frequency)) {
+    return variant_unwrap_float(p_value, &my_instance->prop_state.frequency);
+  }
+
+  if (string_name_eq(p_name, gd_extension_helper.string_name.amplitude)) {
+    return variant_unwrap_float(p_value, &my_instance->prop_state.amplitude);
+  }
+
+  if (string_name_eq(p_name, gd_extension_helper.string_name.waveform)) {
+    // null unwraps as a NULL object, which clears the waveform
+    GDExtensionObjectPtr waveform;
+    if (!variant_unwrap_as(GDEXTENSION_VARIANT_TYPE_OBJECT, p_value, &waveform)) return false;
+    if (waveform != NULL
+        && gd_extension.object_cast_to(waveform, gd_extension_helper.misc.waveform_class_tag) == NULL) {
+      return false;
+    }
+
+    my_custom_class_set_waveform(my_instance, waveform);
+    return true;
+  }
+
+  return false;
+}
+
+GDExtensionBool
+my_custom_class_get_func(
+  GDExtensionClassInstancePtr p_instance,
+  GDExtensionConstStringNamePtr p_name,
+  GDExtensionVariantPtr r_ret
+) {
+  my_custom_class_t *my_instance = p_instance;
+
+  if (string_name_eq(p_name, gd_extension_helper.string_name.frequency)) {
+    gd_extension_helper.wrap.type_double(r_ret, &(my_instance->prop_state.frequency));
+    return true;
+  }
+
+  if (string_name_eq(p_name, gd_extension_helper.string_name.amplitude)) {
+    gd_extension_helper.wrap.type_double(r_ret, &(my_instance->prop_state.amplitude));
+    return true;
+  }
+
+  if (string_name_eq(p_name, gd_extension_helper.string_name.waveform)) {
+    gd_extension_helper.wrap.object(r_ret, &(my_instance->prop_state.waveform));
+    return true;
+  }
+
+  return false;
+}
+
+void
+my_custom_class__process_override(
+   GDExtensionClassInstancePtr p_instance,
+   const GDExtensionConstTypePtr *p_args,
+   GDExtensionTypePtr r_ret
+) {
+  my_custom_class_t *my_instance = p_instance;
+  my_instance->time_elapsed += *((double*)(p_args[0]));
+
+  double t = my_instance->time_elapsed;
+  double A = my_instance->prop_state.amplitude;
+  double w = my_instance->prop_state.frequency;
+
+  double y;
+  if (my_instance->waveform_instance != NULL) {
+    // The resource swapped its table (e.g. shape changed in the inspector).
+    // The unlocked load is only a cheap check, the reference is taken under
+    // the lock.
+    waveform_t *waveform = my_instance->waveform_instance;
+    if (atomic_load_explicit(&waveform->table, memory_order_relaxed) != my_instance->table) {
+      waveform_table_release(my_instance->table);
+      my_instance->table = waveform_acquire_table(waveform);
+    }
+    // `w * t` is an angle, the table covers one period
+    y = A * waveform_table_sample(my_instance->table, w * t / (2.0 * M_PI));
+  } else {
+    y = A * sin(w * t);
+  }
+
+  const GDVector2 new_position = {
+    .x = 0,
+    .y = y,
+  };
+
+  GDExtensionConstTypePtr args[] = { &new_position };
+
+  gd_extension.object_method_bind_ptrcall(gd_extension_helper.misc.node2d_set_position,
+                                          my_instance->godot_object,
+                                          args,
+                                          NULL);
+}
+
+GDExtensionClassCallVirtual
+my_custom_class_get_virtual(
+   void *p_class_userdata,
+   GDExtensionConstStringNamePtr p_name
+) {
+  if (string_name_eq(p_name, gd_extension_helper.string_name._process)) {
+    return my_custom_class__process_override;
+  }
+  return NULL;
+}
+
+void register_my_custom_class() {
+  GDExtensionClassCreationInfo2 class_info = {
+    .is_virtual = false,
+    .is_abstract = false,
+    .is_exposed = true,
+    .set_func = my_custom_class_set_func,
+    .get_func = my_custom_class_get_func,
+    .get_property_list_func = my_custom_class_get_property_list,
+    .free_property_list_func = my_custom_class_free_property_list,
+    .property_can_revert_func = NULL,
+    .property_get_revert_func = NULL,
+    .validate_property_func = NULL,
+    .notification_func = NULL,
+    .to_string_func = NULL,
+    .reference_func = NULL,
+    .unreference_func = NULL,
+    .create_instance_func = my_custom_class_init,
+    .free_instance_func = my_custom_class_deinit,
+    .recreate_instance_func = NULL,
+    .get_virtual_func = my_custom_class_get_virtual,
+    .get_virtual_call_data_func = NULL,
+    .call_virtual_with_data_func = NULL,
+    .get_rid_func = NULL,
+    .class_userdata = NULL,
+  };
+
+  void *my_class_string_name = construct_string_name(MY_CUSTOM_CLASS_NAME);
+  void *parent_class_string_name = construct_string_name(MY_CUSTOM_CLASS_PARENT);
+
+  gd_extension.classdb_register_extension_class2(gd_extension_helper.misc.p_library,
+                                                 my_class_string_name,
+                                                 parent_class_string_name,
+                                                 &class_info);
+
+  destruct_string_name(my_class_string_name);
+  destruct_string_name(parent_class_string_name);
+}
+
+GDExtensionMethodBindPtr get_method_bind(const char *class_name, const char *method_name, GDExtensionInt hash) {
+  void *class_string_name = construct_string_name(class_name);
+  void *method_string_name = construct_string_name(method_name);
+
+  GDExtensionMethodBindPtr res
+    = gd_extension.classdb_get_method_bind(class_string_name, method_string_name, hash);
+
+  destruct_string_name(class_string_name);
+  destruct_string_name(method_string_name);
+  return res;
+}
+
+void godot_initialize(void *userdata, GDExtensionInitializationLevel p_level) {
+  if (p_level == GDEXTENSION_INITIALIZATION_SCENE) {
+    gd_extension_helper.string_name.amplitude = construct_string_name("amplitude");
+    gd_extension_helper.string_name.frequency = construct_string_name("frequency");
+    gd_extension_helper.string_name.waveform = construct_string_name("waveform");
+    gd_extension_helper.string_name.shape = construct_string_name("shape");
+    gd_extension_helper.string_name.resolution = construct_string_name("resolution");
+    gd_extension_helper.string_name.custom_samples = construct_string_name("custom_samples");
+    gd_extension_helper.string_name._process = construct_string_name("_process");
+
+    gd_extension_helper.misc.node2d_set_position = get_method_bind("Node2D", "set_position", 743155724);
+    gd_extension_helper.misc.ref_counted_reference = get_method_bind("RefCounted", "reference", 2240911060);
+    gd_extension_helper.misc.ref_counted_unreference = get_method_bind("RefCounted", "unreference", 2240911060);
+
+    void *size_string_name = construct_string_name("size");
+    gd_extension_helper.builtin_method.packed_float32_array_size
+      = gd_extension.variant_get_ptr_builtin_method(GDEXTENSION_VARIANT_TYPE_PACKED_FLOAT32_ARRAY,
+                                                    size_string_name,
+                                                    3173160232);
+    destruct_string_name(size_string_name);
+
+    register_waveform_class();
+    register_my_custom_class();
+    return;
+  }
+}
+
+void godot_deinitialize(void *userdata, GDExtensionInitializationLevel p_level) {
+  if (p_level == GDEXTENSION_INITIALIZATION_SCENE) {
+    destruct_string_name(gd_extension_helper.string_name.amplitude);
+    destruct_string_name(gd_extension_helper.string_name.frequency);
+    destruct_string_name(gd_extension_helper.string_name.waveform);
+    destruct_string_name(gd_extension_helper.string_name.shape);
+    destruct_string_name(gd_extension_helper.string_name.resolution);
+    destruct_string_name(gd_extension_helper.string_name.custom_samples);
+    destruct_string_name(gd_extension_helper.string_name._process);
+  }
+}
+
+GDExtensionBool
+godot_entry(
+  GDExtensionInterfaceGetProcAddress p_get_proc_address,
+  const GDExtensionClassLibraryPtr p_library,
+  GDExtensionInitialization *r_initialization
+) {
+  r_initialization->minimum_initialization_level = GDEXTENSION_INITIALIZATION_SCENE;
+  r_initialization->userdata = NULL;
+  r_initialization->initialize = godot_initialize;
+  r_initialization->deinitialize = godot_deinitialize;
+
+  STORE_GD_EXTENSION(classdb_construct_object);
+  STORE_GD_EXTENSION(classdb_register_extension_class2);
+  STORE_GD_EXTENSION(classdb_get_method_bind);
+  STORE_GD_EXTENSION(classdb_get_class_tag);
+  STORE_GD_EXTENSION(string_name_new_with_utf8_chars);
+  STORE_GD_EXTENSION(string_new_with_utf8_chars);
+  STORE_GD_EXTENSION(object_set_instance);
+  STORE_GD_EXTENSION(object_set_instance_binding);
+  STORE_GD_EXTENSION(object_get_instance_binding);
+  STORE_GD_EXTENSION(object_cast_to);
+  STORE_GD_EXTENSION(object_destroy);
+  STORE_GD_EXTENSION(variant_get_ptr_destructor);
+  STORE_GD_EXTENSION(variant_get_ptr_constructor);
+  STORE_GD_EXTENSION(variant_get_ptr_builtin_method);
+  STORE_GD_EXTENSION(get_variant_from_type_constructor);
+  STORE_GD_EXTENSION(get_variant_to_type_constructor);
+  STORE_GD_EXTENSION(variant_get_ptr_operator_evaluator);
+  STORE_GD_EXTENSION(variant_get_type);
+  STORE_GD_EXTENSION(object_method_bind_ptrcall);
+  STORE_GD_EXTENSION(packed_float32_array_operator_index_const);
+
+  gd_extension_helper.wrap.type_double
+    = gd_extension.get_variant_from_type_constructor(GDEXTENSION_VARIANT_TYPE_FLOAT);
+  gd_extension_helper.wrap.type_int
+    = gd_extension.get_variant_from_type_constructor(GDEXTENSION_VARIANT_TYPE_INT);
+  gd_extension_helper.wrap.object
+    = gd_extension.get_variant_from_type_constructor(GDEXTENSION_VARIANT_TYPE_OBJECT);
+  gd_extension_helper.wrap.packed_float32_array
+    = gd_extension.get_variant_from_type_constructor(GDEXTENSION_VARIANT_TYPE_PACKED_FLOAT32_ARRAY);
+
+  gd_extension_helper.unwrap.packed_float32_array
+    = gd_extension.get_variant_to_type_constructor(GDEXTENSION_VARIANT_TYPE_PACKED_FLOAT32_ARRAY);
+
+  gd_extension_helper.misc.p_library = p_library;
+  gd_extension_helper.misc.string_name_eq_op
+    = gd_extension.variant_get_ptr_operator_evaluator(GDEXTENSION_VARIANT_OP_EQUAL,
+                                                      GDEXTENSION_VARIANT_TYPE_STRING_NAME,
+                                                      GDEXTENSION_VARIANT_TYPE_STRING_NAME);
+
+  gd_extension_helper.destructor.string_name
+    = gd_extension.variant_get_ptr_destructor(GDEXTENSION_VARIANT_TYPE_STRING_NAME);
+  gd_extension_helper.destructor.string
+    = gd_extension.variant_get_ptr_destructor(GDEXTENSION_VARIANT_TYPE_STRING);
+  gd_extension_helper.destructor.packed_float32_array
+    = gd_extension.variant_get_ptr_destructor(GDEXTENSION_VARIANT_TYPE_PACKED_FLOAT32_ARRAY);
+
+  gd_extension_helper.constructor.packed_float32_array
+    = gd_extension.variant_get_ptr_constructor(GDEXTENSION_VARIANT_TYPE_PACKED_FLOAT32_ARRAY, 0);
+
+  variant_unwrap_init(p_get_proc_address);
+
+  return true;
+}
@@ -0,0 +1,1091 @@
+// Loads a built example (`mvp-godot-project/build/entry.so` by default)
+// into a stub host, creates instances of one of its classes and drives their
+// `_process` override at a fixed frame rate, the way Godot's main loop would.
+// A `_physics_process` override runs before it at `--physics-hz` ticks per
+// second, as many ticks per frame as have come due. No engine runs, so the
+// frame cost is only the extension's own code plus the stub interface
+// functions it calls.
+//
+// With `--threads n` the instances are split into n groups that are created,
+// processed and freed on n threads at the same time, like nodes in a
+// sub-thread process group. Build the host and the example with
+// `-fsanitize=thread` to have ThreadSanitizer check the extension for races.
+//
+//   gcc -O2 -Wall stub-host/frame_sim.c -o frame_sim -ldl -lpthread
+//   ./frame_sim [--library path] [--class MyCustomNode] [--instances 1000]
+//               [--hz 60|144] [--physics-hz 60] [--frames 5000] [--realtime]
+//               [--threads 1] [--set property=value] [--set-share percent]
+//               [--get property]
+//
+// The stub host implements the interface functions the custom node examples
+// use. Anything else is reported when the extension asks for it and comes
+// back as NULL.
+
+#define _GNU_SOURCE
+#include "../godot-headers/gdextension_interface.h"
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <dlfcn.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+#define IS_GODOT_64_BIT (true)
+#define IS_GODOT_USING_LARGE_WORLD_COORDINATES (false)
+#include "../util/builtin_sizes.h"
+
+#define DEFAULT_LIBRARY ("mvp-godot-project/build/entry.so")
+#define DEFAULT_CLASS ("MyCustomNode")
+#define DEFAULT_INSTANCES (1000)
+#define DEFAULT_HZ (60)
+// Godot's physics/common/physics_ticks_per_second and
+// max_physics_steps_per_frame
+#define DEFAULT_PHYSICS_HZ (60)
+#define MAX_PHYSICS_STEPS (8)
+#define DEFAULT_FRAMES (5000)
+#define WARMUP_FRAMES (120)
+#define MAX_CLASSES (64)
+#define MAX_INTERNED_NAMES (4096)
+#define MAX_THREADS (64)
+// From Node, see `NOTIFICATION_READY` in the Node docs
+#define NOTIFICATION_READY (13)
+
+uint64_t now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+int compare_u64(const void *a, const void *b) {
+  uint64_t x = *(const uint64_t *)a;
+  uint64_t y = *(const uint64_t *)b;
+  return x < y ? -1 : x > y;
+}
+
+// ---------------------------------------------------------------------------
+// Allocation counting
+// ---------------------------------------------------------------------------
+
+// ThreadSanitizer brings its own malloc, which these would go around
+#if defined(__SANITIZE_THREAD__)
+#define COUNT_ALLOCATIONS (0)
+#elif defined(__has_feature)
+#if __has_feature(thread_sanitizer)
+#define COUNT_ALLOCATIONS (0)
+#endif
+#endif
+#ifndef COUNT_ALLOCATIONS
+#define COUNT_ALLOCATIONS (1)
+#endif
+
+struct {
+  bool counting;
+  uint64_t allocations;
+} alloc_counter;
+
+#if COUNT_ALLOCATIONS
+// The host executable defines malloc, calloc and realloc, so the dynamic
+// linker binds the extension's calls (and libc's) to these. They forward to
+// glibc and count while a frame is running.
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t count, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+
+void count_allocation() {
+  if (alloc_counter.counting) __atomic_add_fetch(&alloc_counter.allocations, 1, __ATOMIC_RELAXED);
+}
+
+void *malloc(size_t size) {
+  count_allocation();
+  return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size) {
+  count_allocation();
+  return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, size_t size) {
+  count_allocation();
+  return __libc_realloc(ptr, size);
+}
+#endif
+
+// ---------------------------------------------------------------------------
+// Hardware counters
+// ---------------------------------------------------------------------------
+
+enum {
+  COUNTER_CYCLES,
+  COUNTER_INSTRUCTIONS,
+  COUNTER_CACHE_REFERENCES,
+  COUNTER_CACHE_MISSES,
+  COUNTER_COUNT,
+};
+
+const struct {
+  const char *name;
+  uint64_t config;
+} counter_info[COUNTER_COUNT] = {
+  [COUNTER_CYCLES] = { "cycles", PERF_COUNT_HW_CPU_CYCLES },
+  [COUNTER_INSTRUCTIONS] = { "instructions", PERF_COUNT_HW_INSTRUCTIONS },
+  [COUNTER_CACHE_REFERENCES] = { "cache references", PERF_COUNT_HW_CACHE_REFERENCES },
+  [COUNTER_CACHE_MISSES] = { "cache misses", PERF_COUNT_HW_CACHE_MISSES },
+};
+
+int counter_fds[COUNTER_COUNT];
+
+// NOTE: Containers and VMs often don't expose the PMU, or
+// perf_event_paranoid forbids it. Counters that can't be opened are left out
+// of the report.
+void counters_open() {
+  for (int i = 0; i < COUNTER_COUNT; i++) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = counter_info[i].config;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    counter_fds[i] = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+  }
+}
+
+void counters_read(uint64_t *r_values) {
+  for (int i = 0; i < COUNTER_COUNT; i++) {
+    r_values[i] = 0;
+    if (counter_fds[i] >= 0 && read(counter_fds[i], &r_values[i], sizeof(uint64_t)) != sizeof(uint64_t)) {
+      r_values[i] = 0;
+    }
+  }
+}
+
+void counters_close() {
+  for (int i = 0; i < COUNTER_COUNT; i++) {
+    if (counter_fds[i] >= 0) close(counter_fds[i]);
+  }
+}
+
+// ---------------------------------------------------------------------------
+// Stub host
+// ---------------------------------------------------------------------------
+
+// A StringName is a pointer to an interned C string, so equal names are equal
+// pointers, the same as in Godot
+const char *interned_names[MAX_INTERNED_NAMES];
+int interned_name_count;
+// Godot's StringName table takes a lock too
+pthread_mutex_t intern_lock = PTHREAD_MUTEX_INITIALIZER;
+
+const char *intern(const char *name) {
+  pthread_mutex_lock(&intern_lock);
+  const char *res = NULL;
+  for (int i = 0; i < interned_name_count && res == NULL; i++) {
+    if (strcmp(interned_names[i], name) == 0) res = interned_names[i];
+  }
+  if (res == NULL && interned_name_count == MAX_INTERNED_NAMES) {
+    fprintf(stderr, "stub host: too many StringNames\n");
+    exit(1);
+  }
+  if (res == NULL) res = interned_names[interned_name_count++] = strdup(name);
+  pthread_mutex_unlock(&intern_lock);
+  return res;
+}
+
+const char *string_name_of(GDExtensionConstStringNamePtr p_name) {
+  return *(const char *const *)p_name;
+}
+
+typedef struct {
+  const char *name;
+  GDExtensionClassCreationInfo2 info;
+} stub_class_t;
+
+stub_class_t classes[MAX_CLASSES];
+int class_count;
+
+stub_class_t *find_class(const char *name) {
+  for (int i = 0; i < class_count; i++) {
+    if (classes[i].name == name) return &classes[i];
+  }
+  return NULL;
+}
+
+typedef struct {
+  const char *class_name;
+  GDObjectInstanceID instance_id;
+  stub_class_t *extension_class;
+  GDExtensionClassInstancePtr instance;
+  float position[2];
+  bool processing;
+  bool physics_processing;
+} stub_object_t;
+
+GDObjectInstanceID next_instance_id = 1;
+uint64_t ptrcall_count;
+
+typedef struct {
+  const char *name;
+  void (*ptrcall)(stub_object_t *object, const GDExtensionConstTypePtr *p_args, GDExtensionTypePtr r_ret);
+} stub_method_bind_t;
+
+void node2d_set_position(stub_object_t *object, const GDExtensionConstTypePtr *p_args, GDExtensionTypePtr r_ret) {
+  memcpy(object->position, p_args[0], sizeof(object->position));
+}
+
+void node2d_get_position(stub_object_t *object, const GDExtensionConstTypePtr *p_args, GDExtensionTypePtr r_ret) {
+  memcpy(r_ret, object->position, sizeof(object->position));
+}
+
+void node_set_process(stub_object_t *object, const GDExtensionConstTypePtr *p_args, GDExtensionTypePtr r_ret) {
+  object->processing = *(const GDExtensionBool *)p_args[0];
+}
+
+void node_is_processing(stub_object_t *object, const GDExtensionConstTypePtr *p_args, GDExtensionTypePtr r_ret) {
+  *(GDExtensionBool *)r_ret = object->processing;
+}
+
+void node_set_physics_process(stub_object_t *object, const GDExtensionConstTypePtr *p_args, GDExtensionTypePtr r_ret) {
+  object->physics_processing = *(const GDExtensionBool *)p_args[0];
+}
+
+void node_is_physics_processing(stub_object_t *object, const GDExtensionConstTypePtr *p_args, GDExtensionTypePtr r_ret) {
+  *(GDExtensionBool *)r_ret = object->physics_processing;
+}
+
+void ignore_call(stub_object_t *object, const GDExtensionConstTypePtr *p_args, GDExtensionTypePtr r_ret) {
+}
+
+stub_method_bind_t method_binds[] = {
+  { "set_position", node2d_set_position },
+  { "get_position", node2d_get_position },
+  { "set_process", node_set_process },
+  { "is_processing", node_is_processing },
+  { "set_physics_process", node_set_physics_process },
+  { "is_physics_processing", node_is_physics_processing },
+};
+
+stub_method_bind_t ignored_method_bind = { "(ignored)", ignore_call };
+
+// A Variant is its type and either the value itself or, for values that
+// don't fit, a pointer to a copy
+typedef struct {
+  int32_t type;
+  int32_t padding;
+  union {
+    uint8_t value[16];
+    void *boxed;
+  };
+} stub_variant_t;
+
+const size_t variant_value_size[GDEXTENSION_VARIANT_TYPE_VARIANT_MAX] = {
+#define VARIANT_VALUE_SIZE(NAME, Name, name) [GDEXTENSION_VARIANT_TYPE_##NAME] = GD_BUILTIN_SIZE_##NAME,
+  GD_BUILTIN_TYPES(VARIANT_VALUE_SIZE)
+#undef VARIANT_VALUE_SIZE
+};
+
+bool is_boxed(GDExtensionVariantType p_type) {
+  return variant_value_size[p_type] > sizeof(((stub_variant_t *)NULL)->value);
+}
+
+void *variant_value(stub_variant_t *variant) {
+  return is_boxed(variant->type) ? variant->boxed : variant->value;
+}
+
+void string_destroy(GDExtensionTypePtr p_base) {
+  free(*(char **)p_base);
+}
+
+void value_destroy_nothing(GDExtensionTypePtr p_base) {
+}
+
+void variant_wrap(GDExtensionVariantType p_type, GDExtensionUninitializedVariantPtr r_variant, GDExtensionTypePtr p_value) {
+  stub_variant_t *variant = r_variant;
+  variant->type = p_type;
+  if (is_boxed(p_type)) variant->boxed = malloc(variant_value_size[p_type]);
+  memcpy(variant_value(variant), p_value, variant_value_size[p_type]);
+  if (p_type == GDEXTENSION_VARIANT_TYPE_STRING) {
+    *(char **)variant_value(variant) = strdup(*(char **)p_value);
+  }
+}
+
+void variant_unwrap(GDExtensionVariantType p_type, GDExtensionUninitializedTypePtr r_value, GDExtensionVariantPtr p_variant) {
+  stub_variant_t *variant = p_variant;
+  memcpy(r_value, variant_value(variant), variant_value_size[p_type]);
+  if (p_type == GDEXTENSION_VARIANT_TYPE_STRING) {
+    *(char **)r_value = strdup(*(char **)r_value);
+  }
+}
+
+// C has no closures, so there is one wrap and one unwrap function per type
+#define DEFINE_VARIANT_CONVERTERS(NAME, Name, name) \
+  void wrap_##name(GDExtensionUninitializedVariantPtr r_variant, GDExtensionTypePtr p_value) { \
+    variant_wrap(GDEXTENSION_VARIANT_TYPE_##NAME, r_variant, p_value); \
+  } \
+  void unwrap_##name(GDExtensionUninitializedTypePtr r_value, GDExtensionVariantPtr p_variant) { \
+    variant_unwrap(GDEXTENSION_VARIANT_TYPE_##NAME, r_value, p_variant); \
+  }
+GD_BUILTIN_TYPES(DEFINE_VARIANT_CONVERTERS)
+#undef DEFINE_VARIANT_CONVERTERS
+
+const GDExtensionVariantFromTypeConstructorFunc variant_wrappers[GDEXTENSION_VARIANT_TYPE_VARIANT_MAX] = {
+#define VARIANT_WRAPPER(NAME, Name, name) [GDEXTENSION_VARIANT_TYPE_##NAME] = wrap_##name,
+  GD_BUILTIN_TYPES(VARIANT_WRAPPER)
+#undef VARIANT_WRAPPER
+};
+
+const GDExtensionTypeFromVariantConstructorFunc variant_unwrappers[GDEXTENSION_VARIANT_TYPE_VARIANT_MAX] = {
+#define VARIANT_UNWRAPPER(NAME, Name, name) [GDEXTENSION_VARIANT_TYPE_##NAME] = unwrap_##name,
+  GD_BUILTIN_TYPES(VARIANT_UNWRAPPER)
+#undef VARIANT_UNWRAPPER
+};
+
+void equal_string_names(GDExtensionConstTypePtr p_left, GDExtensionConstTypePtr p_right, GDExtensionTypePtr r_result) {
+  *(GDExtensionBool *)r_result = string_name_of(p_left) == string_name_of(p_right);
+}
+
+void equal_strings(GDExtensionConstTypePtr p_left, GDExtensionConstTypePtr p_right, GDExtensionTypePtr r_result) {
+  *(GDExtensionBool *)r_result = strcmp(*(const char *const *)p_left, *(const char *const *)p_right) == 0;
+}
+
+void equal_floats(GDExtensionConstTypePtr p_left, GDExtensionConstTypePtr p_right, GDExtensionTypePtr r_result) {
+  *(GDExtensionBool *)r_result = *(const double *)p_left == *(const double *)p_right;
+}
+
+void equal_ints(GDExtensionConstTypePtr p_left, GDExtensionConstTypePtr p_right, GDExtensionTypePtr r_result) {
+  *(GDExtensionBool *)r_result = *(const int64_t *)p_left == *(const int64_t *)p_right;
+}
+
+GDExtensionPtrOperatorEvaluator
+stub_variant_get_ptr_operator_evaluator(
+  GDExtensionVariantOperator p_operator,
+  GDExtensionVariantType p_type_a,
+  GDExtensionVariantType p_type_b
+) {
+  if (p_operator != GDEXTENSION_VARIANT_OP_EQUAL || p_type_a != p_type_b) return NULL;
+  switch (p_type_a) {
+    case GDEXTENSION_VARIANT_TYPE_STRING_NAME: return equal_string_names;
+    case GDEXTENSION_VARIANT_TYPE_STRING: return equal_strings;
+    case GDEXTENSION_VARIANT_TYPE_FLOAT: return equal_floats;
+    case GDEXTENSION_VARIANT_TYPE_INT: return equal_ints;
+    default: return NULL;
+  }
+}
+
+void
+stub_variant_evaluate(
+  GDExtensionVariantOperator p_op,
+  GDExtensionConstVariantPtr p_a,
+  GDExtensionConstVariantPtr p_b,
+  GDExtensionUninitializedVariantPtr r_return,
+  GDExtensionBool *r_valid
+) {
+  stub_variant_t *a = (stub_variant_t *)p_a;
+  stub_variant_t *b = (stub_variant_t *)p_b;
+  GDExtensionPtrOperatorEvaluator evaluator = stub_variant_get_ptr_operator_evaluator(p_op, a->type, b->type);
+  *r_valid = evaluator != NULL;
+  if (evaluator == NULL) return;
+  GDExtensionBool res;
+  evaluator(variant_value(a), variant_value(b), &res);
+  variant_wrap(GDEXTENSION_VARIANT_TYPE_BOOL, r_return, &res);
+}
+
+GDExtensionVariantType stub_variant_get_type(GDExtensionConstVariantPtr p_self) {
+  return ((const stub_variant_t *)p_self)->type;
+}
+
+void stub_variant_new_nil(GDExtensionUninitializedVariantPtr r_dest) {
+  memset(r_dest, 0, sizeof(stub_variant_t));
+}
+
+void stub_variant_destroy(GDExtensionVariantPtr p_self) {
+  stub_variant_t *variant = p_self;
+  if (variant->type == GDEXTENSION_VARIANT_TYPE_STRING) string_destroy(variant_value(variant));
+  if (is_boxed(variant->type)) free(variant->boxed);
+}
+
+GDExtensionVariantFromTypeConstructorFunc stub_get_variant_from_type_constructor(GDExtensionVariantType p_type) {
+  return variant_wrappers[p_type];
+}
+
+GDExtensionTypeFromVariantConstructorFunc stub_get_variant_to_type_constructor(GDExtensionVariantType p_type) {
+  return variant_unwrappers[p_type];
+}
+
+GDExtensionPtrDestructor stub_variant_get_ptr_destructor(GDExtensionVariantType p_type) {
+  return p_type == GDEXTENSION_VARIANT_TYPE_STRING ? string_destroy : value_destroy_nothing;
+}
+
+// Builtin constructors are only needed for conversions the frame loop never
+// does
+GDExtensionPtrConstructor stub_variant_get_ptr_constructor(GDExtensionVariantType p_type, int32_t p_constructor) {
+  return NULL;
+}
+
+void stub_string_name_new_with_utf8_chars(GDExtensionUninitializedStringNamePtr r_dest, const char *p_contents) {
+  *(const char **)r_dest = intern(p_contents);
+}
+
+void stub_string_new_with_utf8_chars(GDExtensionUninitializedStringPtr r_dest, const char *p_contents) {
+  *(char **)r_dest = strdup(p_contents);
+}
+
+GDExtensionObjectPtr stub_classdb_construct_object(GDExtensionConstStringNamePtr p_classname) {
+  stub_object_t *object = calloc(1, sizeof(stub_object_t));
+  object->class_name = string_name_of(p_classname);
+  object->instance_id = __atomic_fetch_add(&next_instance_id, 1, __ATOMIC_RELAXED);
+  return object;
+}
+
+void stub_object_set_instance(GDExtensionObjectPtr p_o, GDExtensionConstStringNamePtr p_classname, GDExtensionClassInstancePtr p_instance) {
+  stub_object_t *object = p_o;
+  object->extension_class = find_class(string_name_of(p_classname));
+  object->instance = p_instance;
+}
+
+void stub_object_destroy(GDExtensionObjectPtr p_o) {
+  stub_object_t *object = p_o;
+  stub_class_t *extension_class = object->extension_class;
+  if (extension_class != NULL && extension_class->info.free_instance_func != NULL) {
+    extension_class->info.free_instance_func(extension_class->info.class_userdata, object->instance);
+  }
+  free(object);
+}
+
+GDObjectInstanceID stub_object_get_instance_id(GDExtensionConstObjectPtr p_object) {
+  return ((const stub_object_t *)p_object)->instance_id;
+}
+
+void
+stub_classdb_register_extension_class2(
+  GDExtensionClassLibraryPtr p_library,
+  GDExtensionConstStringNamePtr p_class_name,
+  GDExtensionConstStringNamePtr p_parent_class_name,
+  const GDExtensionClassCreationInfo2 *p_extension_funcs
+) {
+  if (class_count == MAX_CLASSES) {
+    fprintf(stderr, "stub host: too many classes\n");
+    return;
+  }
+  classes[class_count++] = (stub_class_t){
+    .name = string_name_of(p_class_name),
+    .info = *p_extension_funcs,
+  };
+}
+
+GDExtensionMethodBindPtr
+stub_classdb_get_method_bind(
+  GDExtensionConstStringNamePtr p_classname,
+  GDExtensionConstStringNamePtr p_methodname,
+  GDExtensionInt p_hash
+) {
+  const char *name = string_name_of(p_methodname);
+  for (size_t i = 0; i < sizeof(method_binds) / sizeof(method_binds[0]); i++) {
+    if (strcmp(method_binds[i].name, name) == 0) return &method_binds[i];
+  }
+  fprintf(stderr, "stub host: %s.%s does nothing\n", string_name_of(p_classname), name);
+  return &ignored_method_bind;
+}
+
+void
+stub_object_method_bind_ptrcall(
+  GDExtensionMethodBindPtr p_method_bind,
+  GDExtensionObjectPtr p_instance,
+  const GDExtensionConstTypePtr *p_args,
+  GDExtensionTypePtr r_ret
+) {
+  const stub_method_bind_t *method_bind = p_method_bind;
+  __atomic_add_fetch(&ptrcall_count, 1, __ATOMIC_RELAXED);
+  method_bind->ptrcall(p_instance, p_args, r_ret);
+}
+
+void *stub_mem_alloc(size_t p_bytes) {
+  return malloc(p_bytes);
+}
+
+void *stub_mem_realloc(void *p_ptr, size_t p_bytes) {
+  return realloc(p_ptr, p_bytes);
+}
+
+void stub_mem_free(void *p_ptr) {
+  free(p_ptr);
+}
+
+void stub_print_error(const char *p_description, const char *p_function, const char *p_file, int32_t p_line, GDExtensionBool p_editor_notify) {
+  fprintf(stderr, "ERROR: %s (%s, %s:%d)\n", p_description, p_function, p_file, p_line);
+}
+
+void stub_get_godot_version(GDExtensionGodotVersion *r_godot_version) {
+  *r_godot_version = (GDExtensionGodotVersion){
+    .major = 4,
+    .minor = 2,
+    .patch = 0,
+    .string = "Godot Engine v4.2.stub (frame_sim)",
+  };
+}
+
+// NOTE: The registration functions for methods, properties and signals are
+// called with all kinds of arguments. Nothing in the frame loop needs them,
+// so they share a single function that ignores them.
+void stub_ignore_registration() {
+}
+
+const struct {
+  const char *name;
+  GDExtensionInterfaceFunctionPtr function;
+} stub_functions[] = {
+  { "variant_get_ptr_operator_evaluator", (GDExtensionInterfaceFunctionPtr)stub_variant_get_ptr_operator_evaluator },
+  { "variant_evaluate", (GDExtensionInterfaceFunctionPtr)stub_variant_evaluate },
+  { "variant_get_type", (GDExtensionInterfaceFunctionPtr)stub_variant_get_type },
+  { "variant_new_nil", (GDExtensionInterfaceFunctionPtr)stub_variant_new_nil },
+  { "variant_destroy", (GDExtensionInterfaceFunctionPtr)stub_variant_destroy },
+  { "get_variant_from_type_constructor", (GDExtensionInterfaceFunctionPtr)stub_get_variant_from_type_constructor },
+  { "get_variant_to_type_constructor", (GDExtensionInterfaceFunctionPtr)stub_get_variant_to_type_constructor },
+  { "variant_get_ptr_destructor", (GDExtensionInterfaceFunctionPtr)stub_variant_get_ptr_destructor },
+  { "variant_get_ptr_constructor", (GDExtensionInterfaceFunctionPtr)stub_variant_get_ptr_constructor },
+  { "string_name_new_with_utf8_chars", (GDExtensionInterfaceFunctionPtr)stub_string_name_new_with_utf8_chars },
+  { "string_new_with_utf8_chars", (GDExtensionInterfaceFunctionPtr)stub_string_new_with_utf8_chars },
+  { "classdb_construct_object", (GDExtensionInterfaceFunctionPtr)stub_classdb_construct_object },
+  { "classdb_register_extension_class2", (GDExtensionInterfaceFunctionPtr)stub_classdb_register_extension_class2 },
+  { "classdb_get_method_bind", (GDExtensionInterfaceFunctionPtr)stub_classdb_get_method_bind },
+  { "object_set_instance", (GDExtensionInterfaceFunctionPtr)stub_object_set_instance },
+  { "object_destroy", (GDExtensionInterfaceFunctionPtr)stub_object_destroy },
+  { "object_get_instance_id", (GDExtensionInterfaceFunctionPtr)stub_object_get_instance_id },
+  { "object_method_bind_ptrcall", (GDExtensionInterfaceFunctionPtr)stub_object_method_bind_ptrcall },
+  { "mem_alloc", (GDExtensionInterfaceFunctionPtr)stub_mem_alloc },
+  { "mem_realloc", (GDExtensionInterfaceFunctionPtr)stub_mem_realloc },
+  { "mem_free", (GDExtensionInterfaceFunctionPtr)stub_mem_free },
+  { "print_error", (GDExtensionInterfaceFunctionPtr)stub_print_error },
+  { "get_godot_version", (GDExtensionInterfaceFunctionPtr)stub_get_godot_version },
+  { "classdb_register_extension_class_method", (GDExtensionInterfaceFunctionPtr)stub_ignore_registration },
+  { "classdb_register_extension_class_property", (GDExtensionInterfaceFunctionPtr)stub_ignore_registration },
+  { "classdb_register_extension_class_signal", (GDExtensionInterfaceFunctionPtr)stub_ignore_registration },
+  { "classdb_register_extension_class_integer_constant", (GDExtensionInterfaceFunctionPtr)stub_ignore_registration },
+  { "classdb_unregister_extension_class", (GDExtensionInterfaceFunctionPtr)stub_ignore_registration },
+};
+
+GDExtensionInterfaceFunctionPtr stub_get_proc_address(const char *p_function_name) {
+  for (size_t i = 0; i < sizeof(stub_functions) / sizeof(stub_functions[0]); i++) {
+    if (strcmp(stub_functions[i].name, p_function_name) == 0) return stub_functions[i].function;
+  }
+  fprintf(stderr, "stub host: %s is not implemented, the extension gets NULL\n", p_function_name);
+  return NULL;
+}
+
+// ---------------------------------------------------------------------------
+// Frame loop
+// ---------------------------------------------------------------------------
+
+typedef struct {
+  const char *library_path;
+  const char *class_name;
+  int instances;
+  int hz;
+  int physics_hz;
+  int frames;
+  bool realtime;
+  int threads;
+  const char *set_property;
+  const char *set_value;
+  int set_share;
+  const char *get_property;
+} options_t;
+
+typedef struct {
+  uint64_t *cost_ns;
+  uint64_t *allocations;
+  uint64_t *processed;
+  uint64_t *ptrcalls;
+  uint64_t *physics_ticks;
+  uint64_t *physics_ns;
+  uint64_t (*counters)[COUNTER_COUNT];
+} frame_stats_t;
+
+bool parse_options(int argc, char **argv, options_t *r_options) {
+  *r_options = (options_t){
+    .library_path = DEFAULT_LIBRARY,
+    .class_name = DEFAULT_CLASS,
+    .instances = DEFAULT_INSTANCES,
+    .hz = DEFAULT_HZ,
+    .physics_hz = DEFAULT_PHYSICS_HZ,
+    .frames = DEFAULT_FRAMES,
+    .realtime = false,
+    .threads = 1,
+    .set_property = NULL,
+    .set_value = NULL,
+    .set_share = 100,
+    .get_property = NULL,
+  };
+  for (int i = 1; i < argc; i++) {
+    bool has_value = i + 1 < argc;
+    if (strcmp(argv[i], "--realtime") == 0) {
+      r_options->realtime = true;
+    } else if (strcmp(argv[i], "--library") == 0 && has_value) {
+      r_options->library_path = argv[++i];
+    } else if (strcmp(argv[i], "--class") == 0 && has_value) {
+      r_options->class_name = argv[++i];
+    } else if (strcmp(argv[i], "--instances") == 0 && has_value) {
+      r_options->instances = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--hz") == 0 && has_value) {
+      r_options->hz = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--physics-hz") == 0 && has_value) {
+      r_options->physics_hz = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--frames") == 0 && has_value) {
+      r_options->frames = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--threads") == 0 && has_value) {
+      r_options->threads = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--set") == 0 && has_value && strchr(argv[i + 1], '=') != NULL) {
+      char *assignment = argv[++i];
+      char *equals = strchr(assignment, '=');
+      *equals = '\0';
+      r_options->set_property = assignment;
+      r_options->set_value = equals + 1;
+    } else if (strcmp(argv[i], "--set-share") == 0 && has_value) {
+      r_options->set_share = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--get") == 0 && has_value) {
+      r_options->get_property = argv[++i];
+    } else {
+      fprintf(stderr, "unknown option %s\n", argv[i]);
+      return false;
+    }
+  }
+  return r_options->instances > 0 && r_options->hz > 0 && r_options->physics_hz > 0 && r_options->frames > 0
+         && r_options->threads > 0 && r_options->threads <= MAX_THREADS;
+}
+
+void sleep_until(uint64_t deadline_ns) {
+  struct timespec ts = {
+    .tv_sec = deadline_ns / 1000000000ull,
+    .tv_nsec = deadline_ns % 1000000000ull,
+  };
+  while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) != 0) {
+  }
+}
+
+// The node enters the tree: Node turns processing on because `_process` is
+// overridden, and physics processing if `_physics_process` is, then the
+// extension gets the notification
+void make_ready(stub_object_t *object, bool physics_processing) {
+  object->processing = true;
+  object->physics_processing = physics_processing;
+  GDExtensionClassNotification2 notification = object->extension_class->info.notification_func;
+  if (notification != NULL) {
+    notification(object->instance, NOTIFICATION_READY, false);
+  }
+}
+
+// ---------------------------------------------------------------------------
+// Thread groups
+// ---------------------------------------------------------------------------
+
+// Every job runs over all instances, split into one contiguous group per
+// thread. The main thread does the first group itself and waits for the
+// others, like Godot's main thread waits for its sub-thread groups.
+typedef enum {
+  JOB_CREATE,
+  JOB_PHYSICS_PROCESS,
+  JOB_PROCESS,
+  JOB_DESTROY,
+  JOB_EXIT,
+} job_kind_t;
+
+struct {
+  int threads;
+  int instances;
+  stub_object_t **objects;
+  stub_class_t *extension_class;
+  GDExtensionClassCallVirtual process;
+  GDExtensionClassCallVirtual physics_process;
+  bool physics_processing;
+  const GDExtensionConstTypePtr *args;
+
+  job_kind_t kind;
+  uint64_t processed[MAX_THREADS];
+  pthread_t workers[MAX_THREADS];
+  pthread_barrier_t start;
+  pthread_barrier_t done;
+} jobs;
+
+void run_group(int group) {
+  int begin = (int)((int64_t)jobs.instances * group / jobs.threads);
+  int end = (int)((int64_t)jobs.instances * (group + 1) / jobs.threads);
+  uint64_t processed = 0;
+
+  for (int i = begin; i < end; i++) {
+    switch (jobs.kind) {
+      case JOB_CREATE:
+        jobs.objects[i] = jobs.extension_class->info.create_instance_func(jobs.extension_class->info.class_userdata);
+        make_ready(jobs.objects[i], jobs.physics_processing);
+        break;
+      case JOB_PHYSICS_PROCESS:
+        if (!jobs.objects[i]->physics_processing) break;
+        jobs.physics_process(jobs.objects[i]->instance, jobs.args, NULL);
+        break;
+      case JOB_PROCESS:
+        // Godot walks a list of the nodes that have processing on. Skipping
+        // the others here costs a load per node, close enough.
+        if (!jobs.objects[i]->processing) break;
+        jobs.process(jobs.objects[i]->instance, jobs.args, NULL);
+        processed++;
+        break;
+      case JOB_DESTROY:
+        stub_object_destroy(jobs.objects[i]);
+        break;
+      case JOB_EXIT:
+        break;
+    }
+  }
+  jobs.processed[group] = processed;
+}
+
+void *worker_main(void *p_group) {
+  int group = (int)(intptr_t)p_group;
+  for (;;) {
+    pthread_barrier_wait(&jobs.start);
+    if (jobs.kind == JOB_EXIT) return NULL;
+    run_group(group);
+    pthread_barrier_wait(&jobs.done);
+  }
+}
+
+// Returns how many instances were processed
+uint64_t run_job(job_kind_t kind, const GDExtensionConstTypePtr *args) {
+  jobs.kind = kind;
+  jobs.args = args;
+  if (jobs.threads > 1) pthread_barrier_wait(&jobs.start);
+  run_group(0);
+  if (jobs.threads > 1) pthread_barrier_wait(&jobs.done);
+
+  uint64_t processed = 0;
+  for (int group = 0; group < jobs.threads; group++) processed += jobs.processed[group];
+  return processed;
+}
+
+void start_workers(int threads) {
+  jobs.threads = threads;
+  if (threads == 1) return;
+  pthread_barrier_init(&jobs.start, NULL, threads);
+  pthread_barrier_init(&jobs.done, NULL, threads);
+  for (int group = 1; group < threads; group++) {
+    pthread_create(&jobs.workers[group], NULL, worker_main, (void *)(intptr_t)group);
+  }
+}
+
+void stop_workers() {
+  if (jobs.threads == 1) return;
+  jobs.kind = JOB_EXIT;
+  pthread_barrier_wait(&jobs.start);
+  for (int group = 1; group < jobs.threads; group++) {
+    pthread_join(jobs.workers[group], NULL);
+  }
+  pthread_barrier_destroy(&jobs.start);
+  pthread_barrier_destroy(&jobs.done);
+}
+
+void
+run_frames(
+  const options_t *options,
+  GDExtensionClassCallVirtual physics_process,
+  frame_stats_t *stats
+) {
+  // Godot passes the delta of the last frame, with a fixed cadence it's
+  // always the budget
+  double delta = 1.0 / options->hz;
+  uint64_t budget_ns = 1000000000ull / options->hz;
+  GDExtensionConstTypePtr args[] = { &delta };
+  double physics_delta = 1.0 / options->physics_hz;
+  GDExtensionConstTypePtr physics_args[] = { &physics_delta };
+  // Counted in whole ticks, so no rounding error builds up over the frames
+  int64_t ticks_done = 0;
+
+  uint64_t deadline = now_ns();
+  for (int frame = -WARMUP_FRAMES; frame < options->frames; frame++) {
+    if (options->realtime) {
+      deadline += budget_ns;
+      sleep_until(deadline);
+    }
+
+    uint64_t counters_before[COUNTER_COUNT];
+    counters_read(counters_before);
+    alloc_counter.allocations = 0;
+    alloc_counter.counting = true;
+    ptrcall_count = 0;
+    uint64_t processed = 0;
+    uint64_t start = now_ns();
+
+    // Physics ticks come first, like in Godot's Main::iteration. When more
+    // than MAX_PHYSICS_STEPS are due, the rest are dropped.
+    int64_t ticks_due = (int64_t)(frame + WARMUP_FRAMES + 1) * options->physics_hz / options->hz;
+    uint64_t physics_ticks = ticks_due - ticks_done;
+    if (physics_ticks > MAX_PHYSICS_STEPS) physics_ticks = MAX_PHYSICS_STEPS;
+    ticks_done = ticks_due;
+    for (uint64_t tick = 0; tick < physics_ticks && physics_process != NULL; tick++) {
+      run_job(JOB_PHYSICS_PROCESS, physics_args);
+    }
+    uint64_t physics_cost = now_ns() - start;
+
+    processed = run_job(JOB_PROCESS, args);
+
+    uint64_t cost = now_ns() - start;
+    alloc_counter.counting = false;
+    uint64_t counters_after[COUNTER_COUNT];
+    counters_read(counters_after);
+
+    if (frame < 0) continue;
+    stats->cost_ns[frame] = cost;
+    stats->allocations[frame] = alloc_counter.allocations;
+    stats->processed[frame] = processed;
+    stats->ptrcalls[frame] = ptrcall_count;
+    stats->physics_ticks[frame] = physics_ticks;
+    stats->physics_ns[frame] = physics_cost;
+    for (int c = 0; c < COUNTER_COUNT; c++) {
+      stats->counters[frame][c] = counters_after[c] - counters_before[c];
+    }
+  }
+}
+
+// Numbers become floats, true and false bools, like in the inspector
+bool set_property(const options_t *options, stub_object_t **objects) {
+  stub_variant_t value;
+  if (strcmp(options->set_value, "true") == 0 || strcmp(options->set_value, "false") == 0) {
+    GDExtensionBool flag = options->set_value[0] == 't';
+    variant_wrap(GDEXTENSION_VARIANT_TYPE_BOOL, &value, &flag);
+  } else {
+    double number = atof(options->set_value);
+    variant_wrap(GDEXTENSION_VARIANT_TYPE_FLOAT, &value, &number);
+  }
+
+  uint8_t name[8];
+  stub_string_name_new_with_utf8_chars(name, options->set_property);
+  int count = (int)((int64_t)options->instances * options->set_share / 100);
+  for (int i = 0; i < count; i++) {
+    GDExtensionClassSet set = objects[i]->extension_class->info.set_func;
+    if (set == NULL || !set(objects[i]->instance, name, &value)) {
+      fprintf(stderr, "%s can't set %s to %s\n", options->class_name, options->set_property, options->set_value);
+      return false;
+    }
+  }
+  stub_variant_destroy(&value);
+  return true;
+}
+
+// Prints the property of the first instance, after all frames including the
+// warmup
+void print_property(const options_t *options, stub_object_t **objects) {
+  uint8_t name[8];
+  stub_string_name_new_with_utf8_chars(name, options->get_property);
+  GDExtensionClassGet get = objects[0]->extension_class->info.get_func;
+  stub_variant_t value;
+  if (get == NULL || !get(objects[0]->instance, name, &value)) {
+    printf("%s has no property %s\n", options->class_name, options->get_property);
+    return;
+  }
+
+  printf("%s of the first instance after %.2f s of game time: ",
+         options->get_property, (double)(WARMUP_FRAMES + options->frames) / options->hz);
+  switch (value.type) {
+    case GDEXTENSION_VARIANT_TYPE_BOOL:
+      printf("%s\n", *(GDExtensionBool *)variant_value(&value) ? "true" : "false");
+      break;
+    case GDEXTENSION_VARIANT_TYPE_INT:
+      printf("%ld\n", (long)*(GDExtensionInt *)variant_value(&value));
+      break;
+    case GDEXTENSION_VARIANT_TYPE_FLOAT:
+      printf("%g\n", *(double *)variant_value(&value));
+      break;
+    default:
+      printf("a Variant of type %d\n", (int)value.type);
+      break;
+  }
+  stub_variant_destroy(&value);
+}
+
+uint64_t percentile(const uint64_t *sorted, int count, int p) {
+  return sorted[(int64_t)(count - 1) * p / 100];
+}
+
+void print_report(const options_t *options, const frame_stats_t *stats, bool physics) {
+  int count = options->frames;
+  double budget_us = 1000000.0 / options->hz;
+
+  uint64_t *sorted = malloc(count * sizeof(uint64_t));
+  memcpy(sorted, stats->cost_ns, count * sizeof(uint64_t));
+  qsort(sorted, count, sizeof(uint64_t), compare_u64);
+
+  int over_budget = 0;
+  for (int i = 0; i < count; i++) {
+    if (stats->cost_ns[i] / 1000.0 > budget_us) over_budget++;
+  }
+
+  printf("%d frames at %d Hz (%.0f us budget), %d instances of %s on %d thread%s\n",
+         count, options->hz, budget_us, options->instances, options->class_name,
+         options->threads, options->threads == 1 ? "" : "s");
+  const int percentiles[] = { 50, 95, 99, 100 };
+  const char *labels[] = { "p50", "p95", "p99", "max" };
+  for (int i = 0; i < 4; i++) {
+    double cost_us = percentile(sorted, count, percentiles[i]) / 1000.0;
+    printf("  %s %10.1f us  %6.2f%% of budget  %8.1f ns per instance\n",
+           labels[i], cost_us, cost_us / budget_us * 100, cost_us * 1000 / options->instances);
+  }
+  printf("  %d frames over budget\n", over_budget);
+
+  uint64_t processed = 0;
+  uint64_t ptrcalls = 0;
+  for (int i = 0; i < count; i++) {
+    processed += stats->processed[i];
+    ptrcalls += stats->ptrcalls[i];
+  }
+  printf("processing: %.1f instances and %.1f ptrcalls per frame\n",
+         (double)processed / count, (double)ptrcalls / count);
+
+  // With frame rates that differ, compare this one: it's the cost of one
+  // second of game time
+  uint64_t cost = 0;
+  uint64_t physics_ticks = 0;
+  uint64_t physics_cost = 0;
+  for (int i = 0; i < count; i++) {
+    cost += stats->cost_ns[i];
+    physics_ticks += stats->physics_ticks[i];
+    physics_cost += stats->physics_ns[i];
+  }
+  printf("cpu: %.2f ms per second of game time\n", (double)cost / count * options->hz / 1000000.0);
+  if (physics) {
+    printf("physics: %.2f ticks per frame at %d Hz, %.2f ms per second of game time\n",
+           (double)physics_ticks / count, options->physics_hz,
+           (double)physics_cost / count * options->hz / 1000000.0);
+  }
+
+  uint64_t allocations = 0;
+  uint64_t max_allocations = 0;
+  int allocating_frames = 0;
+  for (int i = 0; i < count; i++) {
+    allocations += stats->allocations[i];
+    if (stats->allocations[i] > max_allocations) max_allocations = stats->allocations[i];
+    if (stats->allocations[i] > 0) allocating_frames++;
+  }
+  if (COUNT_ALLOCATIONS) {
+    printf("allocations: %.1f per frame, %lu max, %d/%d frames allocate\n",
+           (double)allocations / count, (unsigned long)max_allocations, allocating_frames, count);
+  } else {
+    printf("allocations: not counted with ThreadSanitizer\n");
+  }
+
+  for (int c = 0; c < COUNTER_COUNT; c++) {
+    if (counter_fds[c] < 0) {
+      printf("%s: not available\n", counter_info[c].name);
+      continue;
+    }
+    for (int i = 0; i < count; i++) sorted[i] = stats->counters[i][c];
+    qsort(sorted, count, sizeof(uint64_t), compare_u64);
+    printf("%s: p50 %lu, p99 %lu per frame, %.1f per instance\n",
+           counter_info[c].name,
+           (unsigned long)percentile(sorted, count, 50),
+           (unsigned long)percentile(sorted, count, 99),
+           (double)percentile(sorted, count, 50) / options->instances);
+  }
+
+  free(sorted);
+}
+
+int main(int argc, char **argv) {
+  options_t options;
+  if (!parse_options(argc, argv, &options)) {
+    fprintf(stderr, "usage: %s [--library path] [--class name] [--instances n] [--hz n] [--physics-hz n] [--frames n] [--realtime] [--threads n] [--set property=value] [--set-share percent] [--get property]\n", argv[0]);
+    return 1;
+  }
+
+  void *library = dlopen(options.library_path, RTLD_NOW | RTLD_LOCAL);
+  if (library == NULL) {
+    fprintf(stderr, "%s\n", dlerror());
+    return 1;
+  }
+  GDExtensionInitializationFunction entry = (GDExtensionInitializationFunction)dlsym(library, "godot_entry");
+  if (entry == NULL) {
+    fprintf(stderr, "%s has no godot_entry\n", options.library_path);
+    return 1;
+  }
+
+  GDExtensionInitialization initialization;
+  if (!entry(stub_get_proc_address, NULL, &initialization)) {
+    fprintf(stderr, "godot_entry failed\n");
+    return 1;
+  }
+  // Like Godot, skip the editor level: we are a running game
+  for (int level = initialization.minimum_initialization_level; level <= GDEXTENSION_INITIALIZATION_SCENE; level++) {
+    initialization.initialize(initialization.userdata, level);
+  }
+
+  stub_class_t *extension_class = find_class(intern(options.class_name));
+  if (extension_class == NULL) {
+    fprintf(stderr, "%s didn't register %s\n", options.library_path, options.class_name);
+    return 1;
+  }
+
+  uint8_t process_name[8];
+  stub_string_name_new_with_utf8_chars(process_name, "_process");
+  GDExtensionClassCallVirtual process = NULL;
+  if (extension_class->info.get_virtual_func != NULL) {
+    process = extension_class->info.get_virtual_func(extension_class->info.class_userdata, process_name);
+  }
+  if (process == NULL) {
+    fprintf(stderr, "%s doesn't override _process\n", options.class_name);
+    return 1;
+  }
+  uint8_t physics_process_name[8];
+  stub_string_name_new_with_utf8_chars(physics_process_name, "_physics_process");
+  GDExtensionClassCallVirtual physics_process
+    = extension_class->info.get_virtual_func(extension_class->info.class_userdata, physics_process_name);
+
+  stub_object_t **objects = malloc(options.instances * sizeof(stub_object_t *));
+  jobs.instances = options.instances;
+  jobs.objects = objects;
+  jobs.extension_class = extension_class;
+  jobs.process = process;
+  jobs.physics_process = physics_process;
+  jobs.physics_processing = physics_process != NULL;
+  start_workers(options.threads);
+  run_job(JOB_CREATE, NULL);
+  if (options.set_property != NULL && !set_property(&options, objects)) {
+    return 1;
+  }
+
+  frame_stats_t stats = {
+    .cost_ns = malloc(options.frames * sizeof(uint64_t)),
+    .allocations = malloc(options.frames * sizeof(uint64_t)),
+    .processed = malloc(options.frames * sizeof(uint64_t)),
+    .ptrcalls = malloc(options.frames * sizeof(uint64_t)),
+    .physics_ticks = malloc(options.frames * sizeof(uint64_t)),
+    .physics_ns = malloc(options.frames * sizeof(uint64_t)),
+    .counters = malloc(options.frames * sizeof(stats.counters[0])),
+  };
+  counters_open();
+  run_frames(&options, physics_process, &stats);
+  counters_close();
+  print_report(&options, &stats, physics_process != NULL);
+  if (options.get_property != NULL) {
+    print_property(&options, objects);
+  }
+
+  run_job(JOB_DESTROY, NULL);
+  stop_workers();
+  for (int level = GDEXTENSION_INITIALIZATION_SCENE; level >= (int)initialization.minimum_initialization_level; level--) {
+    initialization.deinitialize(initialization.userdata, level);
+  }
+
+  free(stats.counters);
+  free(stats.physics_ns);
+  free(stats.physics_ticks);
+  free(stats.ptrcalls);
+  free(stats.processed);
+  free(stats.allocations);
+  free(stats.cost_ns);
+  free(objects);
+  dlclose(library);
+  return 0;
+}
@@ -0,0 +1,66 @@
+#ifndef INTERFACE_LOG_H
+#define INTERFACE_LOG_H
+
+#include <stdint.h>
+
+// Binary log of GDExtension interface calls, written by
+// `src/hello_call_recorder.c` and read by `stub-host/replay_interface_log.c`.
+//
+// Layout (host byte order):
+//
+//   interface_log_header_t
+//   char function_names[function_count][INTERFACE_LOG_NAME_SIZE]
+//   interface_log_record_t records[]  (until the end of the file)
+
+#define INTERFACE_LOG_MAGIC ("GDXR")
+#define INTERFACE_LOG_VERSION (1)
+#define INTERFACE_LOG_NAME_SIZE (48)
+// A record with this function id marks the start of a new frame
+#define INTERFACE_LOG_FRAME_MARKER (0xFFFF)
+
+// Function ids are indices into this list, keep the order stable
+#define INTERFACE_LOG_FUNCTIONS(X)              \
+  X(classdb_construct_object)                   \
+  X(classdb_register_extension_class2)          \
+  X(classdb_get_method_bind)                    \
+  X(string_name_new_with_utf8_chars)            \
+  X(string_new_with_utf8_chars)                 \
+  X(object_set_instance)                        \
+  X(variant_get_ptr_destructor)                 \
+  X(get_variant_from_type_constructor)          \
+  X(get_variant_to_type_constructor)            \
+  X(variant_get_ptr_operator_evaluator)         \
+  X(variant_get_type)                           \
+  X(object_method_bind_ptrcall)                 \
+  X(destructor_call)                            \
+  X(variant_from_type_call)                     \
+  X(variant_to_type_call)                       \
+  X(operator_evaluator_call)
+
+#define INTERFACE_LOG_FUNCTION_ID(name) INTERFACE_LOG_FN_##name,
+typedef enum {
+  INTERFACE_LOG_FUNCTIONS(INTERFACE_LOG_FUNCTION_ID)
+  INTERFACE_LOG_FUNCTION_COUNT,
+} interface_log_function_id_t;
+#undef INTERFACE_LOG_FUNCTION_ID
+
+typedef struct {
+  char magic[4];
+  uint32_t version;
+  uint32_t function_count;
+  uint32_t record_size;
+} interface_log_header_t;
+
+typedef struct {
+  uint16_t function_id;
+  uint16_t reserved;
+  // Bytes the call reads or writes through its pointer arguments, 0 if unknown
+  // (for example ptrcall arguments, whose types only the method bind knows)
+  uint32_t arg_bytes;
+  // Nanoseconds since recording started
+  uint64_t timestamp_ns;
+  // Object the call operates on, if any. Only useful for telling objects apart.
+  uint64_t object;
+} interface_log_record_t;
+
+#endif
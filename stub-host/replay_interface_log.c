@@ -0,0 +1,260 @@
+// Replays a log written by `src/hello_call_recorder.c` against stub interface
+// functions. There is no Godot involved, so the numbers only depend on the
+// call pattern: how many crossings happen per frame, in which order and how
+// many bytes they move.
+//
+//   gcc -O2 -Wall stub-host/replay_interface_log.c -o replay_interface_log
+//   ./replay_interface_log interface_calls.gdxr [iterations]
+
+#include "interface_log.h"
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define DEFAULT_ITERATIONS (20)
+#define SCRATCH_SIZE (4096)
+
+typedef struct {
+  interface_log_header_t header;
+  char (*function_names)[INTERFACE_LOG_NAME_SIZE];
+  interface_log_record_t *records;
+  size_t record_count;
+} interface_log_t;
+
+uint64_t now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+bool interface_log_read(const char *path, interface_log_t *r_log) {
+  FILE *f = fopen(path, "rb");
+  if (f == NULL) {
+    fprintf(stderr, "can't open %s\n", path);
+    return false;
+  }
+
+  interface_log_header_t *header = &r_log->header;
+  if (fread(header, sizeof(*header), 1, f) != 1
+      || memcmp(header->magic, INTERFACE_LOG_MAGIC, 4) != 0
+      || header->version != INTERFACE_LOG_VERSION
+      || header->record_size != sizeof(interface_log_record_t)) {
+    fprintf(stderr, "%s is not a version %d interface log\n", path, INTERFACE_LOG_VERSION);
+    fclose(f);
+    return false;
+  }
+
+  // One block holds every fixed size name, so one free releases all of them
+  r_log->function_names = malloc((size_t)header->function_count * INTERFACE_LOG_NAME_SIZE + 1);
+  if (r_log->function_names == NULL
+      || fread(r_log->function_names, INTERFACE_LOG_NAME_SIZE, header->function_count, f)
+           != header->function_count) {
+    fprintf(stderr, "%s is truncated\n", path);
+    free(r_log->function_names);
+    r_log->function_names = NULL;
+    fclose(f);
+    return false;
+  }
+
+  long records_start = ftell(f);
+  fseek(f, 0, SEEK_END);
+  long records_end = ftell(f);
+  fseek(f, records_start, SEEK_SET);
+
+  r_log->record_count = (records_end - records_start) / sizeof(interface_log_record_t);
+  r_log->records = malloc(r_log->record_count * sizeof(interface_log_record_t) + 1);
+  if (r_log->records == NULL) {
+    fprintf(stderr, "out of memory reading %s\n", path);
+    free(r_log->function_names);
+    r_log->function_names = NULL;
+    fclose(f);
+    return false;
+  }
+  r_log->record_count = fread(r_log->records, sizeof(interface_log_record_t), r_log->record_count, f);
+
+  fclose(f);
+  return true;
+}
+
+bool is_known_function(const interface_log_t *log, uint16_t function_id) {
+  return function_id < log->header.function_count && function_id < INTERFACE_LOG_FUNCTION_COUNT;
+}
+
+// ---------------------------------------------------------------------------
+// Summary of the recording itself
+// ---------------------------------------------------------------------------
+
+void print_summary(const interface_log_t *log) {
+  uint64_t counts[INTERFACE_LOG_FUNCTION_COUNT] = { 0 };
+  uint64_t bytes[INTERFACE_LOG_FUNCTION_COUNT] = { 0 };
+
+  // Calls before the first frame marker are initialization
+  uint64_t init_calls = 0;
+  uint64_t frame_count = 0;
+  uint64_t calls_in_frame = 0;
+  uint64_t min_calls = UINT64_MAX, max_calls = 0, frame_calls_total = 0;
+  uint64_t first_frame_ns = 0, last_frame_ns = 0;
+
+  for (size_t i = 0; i < log->record_count; i++) {
+    const interface_log_record_t *record = &log->records[i];
+
+    if (record->function_id == INTERFACE_LOG_FRAME_MARKER) {
+      if (frame_count > 0) {
+        if (calls_in_frame < min_calls) min_calls = calls_in_frame;
+        if (calls_in_frame > max_calls) max_calls = calls_in_frame;
+        frame_calls_total += calls_in_frame;
+      } else {
+        first_frame_ns = record->timestamp_ns;
+      }
+      last_frame_ns = record->timestamp_ns;
+      frame_count++;
+      calls_in_frame = 0;
+      continue;
+    }
+
+    if (frame_count == 0) {
+      init_calls++;
+    } else {
+      calls_in_frame++;
+    }
+
+    if (is_known_function(log, record->function_id)) {
+      counts[record->function_id]++;
+      bytes[record->function_id] += record->arg_bytes;
+    }
+  }
+
+  printf("%zu records, %lu during initialization, %lu frames\n",
+         log->record_count,
+         (unsigned long)init_calls,
+         (unsigned long)frame_count);
+
+  // The last frame is usually cut short by shutdown, so it's left out
+  if (frame_count > 1) {
+    printf("calls per frame: avg %.1f, min %lu, max %lu\n",
+           (double)frame_calls_total / (frame_count - 1),
+           (unsigned long)min_calls,
+           (unsigned long)max_calls);
+    printf("recorded frame length: avg %.3f ms\n",
+           (last_frame_ns - first_frame_ns) / 1e6 / (frame_count - 1));
+  }
+
+  printf("\n%-40s %12s %14s\n", "function", "calls", "arg bytes");
+  for (int i = 0; i < INTERFACE_LOG_FUNCTION_COUNT && i < (int)log->header.function_count; i++) {
+    if (counts[i] == 0) continue;
+    printf("%-40s %12lu %14lu\n",
+           log->function_names[i],
+           (unsigned long)counts[i],
+           (unsigned long)bytes[i]);
+  }
+}
+
+// ---------------------------------------------------------------------------
+// Stub host
+// ---------------------------------------------------------------------------
+
+// Each interface function gets its own stub so that the replay goes through
+// distinct indirect call targets like the real thing. A stub copies as many
+// bytes as the real call touched and folds in the object pointer.
+
+unsigned char scratch_src[SCRATCH_SIZE];
+unsigned char scratch_dst[SCRATCH_SIZE];
+volatile uint64_t sink;
+
+typedef void (*stub_func_t)(uint32_t arg_bytes, uint64_t object);
+
+#define DEFINE_STUB(name)                                                 \
+  __attribute__((noinline)) void stub_##name(uint32_t arg_bytes, uint64_t object) { \
+    size_t n = arg_bytes < SCRATCH_SIZE ? arg_bytes : SCRATCH_SIZE;       \
+    memcpy(scratch_dst, scratch_src, n);                                  \
+    sink ^= object + scratch_dst[0];                                      \
+  }
+INTERFACE_LOG_FUNCTIONS(DEFINE_STUB)
+#undef DEFINE_STUB
+
+#define STUB_ENTRY(name) stub_##name,
+const stub_func_t stubs[INTERFACE_LOG_FUNCTION_COUNT] = { INTERFACE_LOG_FUNCTIONS(STUB_ENTRY) };
+#undef STUB_ENTRY
+
+uint64_t replay_once(const interface_log_t *log) {
+  uint64_t start = now_ns();
+  for (size_t i = 0; i < log->record_count; i++) {
+    const interface_log_record_t *record = &log->records[i];
+    if (!is_known_function(log, record->function_id)) continue;
+    stubs[record->function_id](record->arg_bytes, record->object);
+  }
+  return now_ns() - start;
+}
+
+int compare_u64(const void *a, const void *b) {
+  uint64_t x = *(const uint64_t *)a;
+  uint64_t y = *(const uint64_t *)b;
+  return x < y ? -1 : x > y;
+}
+
+void print_replay(const interface_log_t *log, int iterations) {
+  uint64_t call_count = 0;
+  uint64_t frame_count = 0;
+  for (size_t i = 0; i < log->record_count; i++) {
+    if (log->records[i].function_id == INTERFACE_LOG_FRAME_MARKER) {
+      frame_count++;
+    } else if (is_known_function(log, log->records[i].function_id)) {
+      call_count++;
+    }
+  }
+
+  // Warm up caches and branch predictors once before measuring
+  replay_once(log);
+
+  uint64_t *times = malloc(iterations * sizeof(uint64_t));
+  for (int i = 0; i < iterations; i++) {
+    times[i] = replay_once(log);
+  }
+  qsort(times, iterations, sizeof(uint64_t), compare_u64);
+
+  uint64_t best = times[0];
+  uint64_t median = times[iterations / 2];
+
+  printf("\nreplay (%d iterations): min %.3f ms, median %.3f ms\n",
+         iterations,
+         best / 1e6,
+         median / 1e6);
+  if (call_count > 0) {
+    printf("stub cost per call: %.1f ns (min)\n", (double)best / call_count);
+  }
+  if (frame_count > 0) {
+    printf("stub cost per frame: %.3f us (min)\n", (double)best / frame_count / 1e3);
+  }
+
+  free(times);
+}
+
+int main(int argc, char **argv) {
+  if (argc < 2 || argc > 3) {
+    fprintf(stderr, "usage: %s [log-file] [iterations]\n", argv[0]);
+    return 1;
+  }
+
+  int iterations = argc == 3 ? atoi(argv[2]) : DEFAULT_ITERATIONS;
+  if (iterations <= 0) iterations = DEFAULT_ITERATIONS;
+
+  interface_log_t log;
+  if (!interface_log_read(argv[1], &log)) return 1;
+
+  if (log.header.function_count != INTERFACE_LOG_FUNCTION_COUNT) {
+    fprintf(stderr,
+            "warning: log has %u functions, this tool knows %d\n",
+            log.header.function_count,
+            INTERFACE_LOG_FUNCTION_COUNT);
+  }
+
+  print_summary(&log);
+  print_replay(&log, iterations);
+
+  free(log.records);
+  free(log.function_names);
+  return 0;
+}
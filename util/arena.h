@@ -0,0 +1,211 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+// Bump-pointer arenas, one per GDExtensionInitializationLevel.
+//
+// Everything a level allocates in `godot_initialize` comes from its arena
+// and is given back with a single `arena_reset` in the matching
+// `godot_deinitialize`. Allocating is a pointer bump, there is no per
+// allocation free. The first block is kept across resets, `arena_destroy`
+// frees it before the library is unloaded.
+//
+// Usage:
+//
+//   arena_t *arena = arena_for_level(p_level);
+//   void *p = ARENA_ALLOC(arena, 8);
+//   ...
+//   arena_release(arena, p); // after destructing whatever Godot value is in `p`
+//   ...
+//   arena_reset(arena); // in godot_deinitialize
+//
+// With ARENA_DEBUG (the default unless NDEBUG is defined) every allocation is
+// recorded with its call site, and `arena_reset` reports the ones that were
+// never released. The memory itself can't leak, but a StringName that was
+// never destructed leaks on Godot's side, and that's what this catches.
+//
+// NOTE: Arenas aren't thread safe, they are meant for initialization which
+// Godot runs on the main thread.
+
+#include "../godot-headers/gdextension_interface.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifndef ARENA_DEBUG
+#ifdef NDEBUG
+#define ARENA_DEBUG (0)
+#else
+#define ARENA_DEBUG (1)
+#endif
+#endif
+
+#define ARENA_BLOCK_SIZE (64 * 1024)
+#define ARENA_ALIGNMENT (16)
+
+typedef struct arena_block {
+  struct arena_block *next;
+  size_t size;
+  _Alignas(ARENA_ALIGNMENT) unsigned char data[];
+} arena_block_t;
+
+typedef struct {
+  void *p;
+  size_t size;
+  const char *file;
+  int line;
+  const char *function;
+  bool released;
+} arena_allocation_t;
+
+typedef struct {
+  const char *name;
+  // Newest block first, the oldest one survives resets
+  arena_block_t *blocks;
+  unsigned char *cursor;
+  unsigned char *end;
+  size_t allocated_bytes;
+  size_t allocation_count;
+#if ARENA_DEBUG
+  arena_allocation_t *allocations;
+  size_t allocations_capacity;
+#endif
+} arena_t;
+
+static arena_t arena_levels[GDEXTENSION_MAX_INITIALIZATION_LEVEL] = {
+  [GDEXTENSION_INITIALIZATION_CORE] = { .name = "core" },
+  [GDEXTENSION_INITIALIZATION_SERVERS] = { .name = "servers" },
+  [GDEXTENSION_INITIALIZATION_SCENE] = { .name = "scene" },
+  [GDEXTENSION_INITIALIZATION_EDITOR] = { .name = "editor" },
+};
+
+static inline arena_t *arena_for_level(GDExtensionInitializationLevel p_level) {
+  return &arena_levels[p_level];
+}
+
+static bool arena_grow(arena_t *arena, size_t size) {
+  size_t block_size = size > ARENA_BLOCK_SIZE ? size : ARENA_BLOCK_SIZE;
+  arena_block_t *block = malloc(sizeof(arena_block_t) + block_size);
+  if (block == NULL) return false;
+
+  block->next = arena->blocks;
+  block->size = block_size;
+  arena->blocks = block;
+  arena->cursor = block->data;
+  arena->end = block->data + block_size;
+  return true;
+}
+
+#if ARENA_DEBUG
+// Returns false if the allocation table can't grow, the table is left as is
+static bool arena_track(arena_t *arena, void *p, size_t size, const char *file, int line, const char *function) {
+  if (arena->allocation_count == arena->allocations_capacity) {
+    size_t capacity = arena->allocations_capacity > 0 ? arena->allocations_capacity * 2 : 64;
+    arena_allocation_t *allocations = realloc(arena->allocations, capacity * sizeof(arena_allocation_t));
+    if (allocations == NULL) return false;
+    arena->allocations = allocations;
+    arena->allocations_capacity = capacity;
+  }
+  arena->allocations[arena->allocation_count] = (arena_allocation_t){
+    .p = p,
+    .size = size,
+    .file = file,
+    .line = line,
+    .function = function,
+    .released = false,
+  };
+  return true;
+}
+#endif
+
+#define ARENA_ALLOC(arena, size) arena_alloc_at((arena), (size), __FILE__, __LINE__, __func__)
+
+static void *
+arena_alloc_at(
+  arena_t *arena,
+  size_t size,
+  const char *file,
+  int line,
+  const char *function
+) {
+  size_t padded = (size + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+  if (arena->cursor == NULL || (size_t)(arena->end - arena->cursor) < padded) {
+    if (!arena_grow(arena, padded)) return NULL;
+  }
+
+  void *res = arena->cursor;
+#if ARENA_DEBUG
+  // An allocation the leak report can't see would be reported wrongly, so
+  // it fails like an out of memory block
+  if (!arena_track(arena, res, size, file, line, function)) return NULL;
+#endif
+  arena->cursor += padded;
+  arena->allocated_bytes += size;
+  arena->allocation_count++;
+  return res;
+}
+
+// Marks `p` as done with. The memory stays until the next reset, this only
+// tells the leak report that whatever lived there was cleaned up.
+static inline void arena_release(arena_t *arena, void *p) {
+#if ARENA_DEBUG
+  // Most releases are of recent allocations, so search backwards
+  for (size_t i = arena->allocation_count; i > 0; i--) {
+    if (arena->allocations[i - 1].p == p && !arena->allocations[i - 1].released) {
+      arena->allocations[i - 1].released = true;
+      return;
+    }
+  }
+  fprintf(stderr, "arena %s: released %p which wasn't allocated here\n", arena->name, p);
+#endif
+}
+
+// Gives back everything allocated since the last reset. Returns the number of
+// allocations that weren't released, which is always 0 without ARENA_DEBUG.
+static size_t arena_reset(arena_t *arena) {
+  size_t leaks = 0;
+#if ARENA_DEBUG
+  for (size_t i = 0; i < arena->allocation_count; i++) {
+    const arena_allocation_t *allocation = &arena->allocations[i];
+    if (allocation->released) continue;
+    fprintf(stderr, "arena %s: %zu bytes allocated in %s (%s:%d) weren't released\n",
+            arena->name,
+            allocation->size,
+            allocation->function,
+            allocation->file,
+            allocation->line);
+    leaks++;
+  }
+#endif
+
+  // Keep the oldest block for the next initialization
+  arena_block_t *block = arena->blocks;
+  while (block != NULL && block->next != NULL) {
+    arena_block_t *next = block->next;
+    free(block);
+    block = next;
+  }
+  arena->blocks = block;
+  arena->cursor = block != NULL ? block->data : NULL;
+  arena->end = block != NULL ? block->data + block->size : NULL;
+  arena->allocated_bytes = 0;
+  arena->allocation_count = 0;
+  return leaks;
+}
+
+// Frees everything including the kept block, for when the library is unloaded
+static void arena_destroy(arena_t *arena) {
+  arena_reset(arena);
+  free(arena->blocks);
+  arena->blocks = NULL;
+  arena->cursor = NULL;
+  arena->end = NULL;
+#if ARENA_DEBUG
+  free(arena->allocations);
+  arena->allocations = NULL;
+  arena->allocations_capacity = 0;
+#endif
+}
+
+#endif
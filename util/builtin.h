@@ -0,0 +1,123 @@
+#ifndef BUILTIN_H
+#define BUILTIN_H
+
+// Inline storage for Godot's builtin types, for C.
+//
+// Every builtin type gets a `gd_<snake_name>_t` struct with the exact size and
+// alignment Godot uses (see `builtin_sizes.h`), so values can live on the
+// stack, in arrays or inside other structs instead of behind a malloc'd
+// pointer. Construction and destruction go through `variant_cache.h`.
+//
+// Usage:
+//
+//   builtin_init(p_get_proc_address); // in godot_entry
+//
+//   GD_SCOPED(string_name) name;
+//   gd_string_name_from_utf8(&name, "position");
+//   ... // `name` is destroyed when it goes out of scope
+//
+// There is no move function: a builtin value is just bytes that point at
+// Godot owned data, so moving is a plain struct assignment. Only destroy the
+// destination afterwards, never both.
+//
+// NOTE: The C++ version of this is `builtin.hpp`.
+
+#include "../godot-headers/gdextension_interface.h"
+#include "builtin_sizes.h"
+#include "variant_cache.h"
+#include <stddef.h>
+
+#define BUILTIN_DECLARE_STORAGE(SUFFIX, Name, snake)                   \
+  typedef struct {                                                     \
+    _Alignas(GD_BUILTIN_ALIGN_##SUFFIX) unsigned char data[GD_BUILTIN_SIZE_##SUFFIX]; \
+  } gd_##snake##_t;
+GD_BUILTIN_TYPES(BUILTIN_DECLARE_STORAGE)
+#undef BUILTIN_DECLARE_STORAGE
+
+typedef struct {
+  _Alignas(GD_BUILTIN_ALIGN_VARIANT) unsigned char data[GD_BUILTIN_SIZE_VARIANT];
+} gd_variant_t;
+
+static struct {
+  GDExtensionInterfaceStringNewWithUtf8Chars string_new_with_utf8_chars;
+  GDExtensionInterfaceStringNameNewWithUtf8Chars string_name_new_with_utf8_chars;
+  GDExtensionInterfaceVariantNewNil variant_new_nil;
+  GDExtensionInterfaceVariantNewCopy variant_new_copy;
+  GDExtensionInterfaceVariantDestroy variant_destroy;
+} builtin_interface;
+
+#define BUILTIN_STORE_INTERFACE(name) \
+  builtin_interface.name = (void *)p_get_proc_address(#name);
+
+// Also initializes the variant cache, don't call `variant_cache_init` again
+static void builtin_init(GDExtensionInterfaceGetProcAddress p_get_proc_address) {
+  variant_cache_init(p_get_proc_address);
+  BUILTIN_STORE_INTERFACE(string_new_with_utf8_chars);
+  BUILTIN_STORE_INTERFACE(string_name_new_with_utf8_chars);
+  BUILTIN_STORE_INTERFACE(variant_new_nil);
+  BUILTIN_STORE_INTERFACE(variant_new_copy);
+  BUILTIN_STORE_INTERFACE(variant_destroy);
+}
+
+#undef BUILTIN_STORE_INTERFACE
+
+// Constructor 0 is the default constructor of every builtin type
+static inline void builtin_construct(GDExtensionVariantType p_type, GDExtensionUninitializedTypePtr r_dest) {
+  variant_cache_constructor(p_type, 0)(r_dest, NULL);
+}
+
+// Constructor 1 is the copy constructor of every builtin type
+static inline void
+builtin_copy(
+  GDExtensionVariantType p_type,
+  GDExtensionUninitializedTypePtr r_dest,
+  GDExtensionConstTypePtr p_src
+) {
+  GDExtensionConstTypePtr args[1] = { p_src };
+  variant_cache_constructor(p_type, 1)(r_dest, args);
+}
+
+// Plain data types (bool, int, Vector2, ...) don't have a destructor
+static inline void builtin_destroy(GDExtensionVariantType p_type, GDExtensionTypePtr p_self) {
+  GDExtensionPtrDestructor destructor = variant_cache_destructor(p_type);
+  if (destructor != NULL) destructor(p_self);
+}
+
+#define BUILTIN_DECLARE_FUNCTIONS(SUFFIX, Name, snake)                             \
+  static inline void gd_##snake##_construct(gd_##snake##_t *r_dest) {              \
+    builtin_construct(GDEXTENSION_VARIANT_TYPE_##SUFFIX, r_dest);                  \
+  }                                                                                \
+  static inline void gd_##snake##_copy(gd_##snake##_t *r_dest, const gd_##snake##_t *p_src) { \
+    builtin_copy(GDEXTENSION_VARIANT_TYPE_##SUFFIX, r_dest, p_src);                \
+  }                                                                                \
+  static inline void gd_##snake##_destroy(gd_##snake##_t *p_self) {                \
+    builtin_destroy(GDEXTENSION_VARIANT_TYPE_##SUFFIX, p_self);                    \
+  }
+GD_BUILTIN_TYPES(BUILTIN_DECLARE_FUNCTIONS)
+#undef BUILTIN_DECLARE_FUNCTIONS
+
+static inline void gd_variant_construct(gd_variant_t *r_dest) {
+  builtin_interface.variant_new_nil(r_dest);
+}
+
+static inline void gd_variant_copy(gd_variant_t *r_dest, const gd_variant_t *p_src) {
+  builtin_interface.variant_new_copy(r_dest, p_src);
+}
+
+static inline void gd_variant_destroy(gd_variant_t *p_self) {
+  builtin_interface.variant_destroy(p_self);
+}
+
+static inline void gd_string_from_utf8(gd_string_t *r_dest, const char *p_contents) {
+  builtin_interface.string_new_with_utf8_chars(r_dest, p_contents);
+}
+
+static inline void gd_string_name_from_utf8(gd_string_name_t *r_dest, const char *p_contents) {
+  builtin_interface.string_name_new_with_utf8_chars(r_dest, p_contents);
+}
+
+// Declares a variable that gets destroyed when it goes out of scope. It still
+// has to be constructed by hand.
+#define GD_SCOPED(snake) __attribute__((cleanup(gd_##snake##_destroy))) gd_##snake##_t
+
+#endif
@@ -0,0 +1,285 @@
+#ifndef BUILTIN_HPP
+#define BUILTIN_HPP
+
+// RAII wrappers for Godot's builtin types, for C++ (17 or newer).
+//
+// `gd::Builtin<TYPE>` stores the value inline with the size and alignment
+// Godot uses (see `builtin_sizes.h`), constructs it with Godot's default or
+// copy constructor and destroys it in its destructor. Moving just takes over
+// the bytes, so returning or passing temporaries around never allocates or
+// calls into Godot.
+//
+// Usage:
+//
+//   gd::builtin_init(p_get_proc_address); // in godot_entry
+//
+//   gd::StringName name = gd::StringName::from_utf8("position");
+//   gd::Array nodes;
+//   some_method_ptrcall(..., nodes.ptr());
+//
+// The constructor and destructor pointers of every type are looked up once in
+// `builtin_init`, other constructors go through the interface on every call.
+//
+// NOTE: A moved-from wrapper must not be used anymore, it only remembers not
+// to destroy what it gave away.
+//
+// NOTE: The C version of this is `builtin.h`.
+
+#include "../godot-headers/gdextension_interface.h"
+#include "builtin_sizes.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+namespace gd {
+
+namespace detail {
+
+struct BuiltinInterface {
+  GDExtensionInterfaceVariantGetPtrConstructor variant_get_ptr_constructor;
+  GDExtensionInterfaceStringNewWithUtf8Chars string_new_with_utf8_chars;
+  GDExtensionInterfaceStringNameNewWithUtf8Chars string_name_new_with_utf8_chars;
+  GDExtensionInterfaceVariantNewNil variant_new_nil;
+  GDExtensionInterfaceVariantNewCopy variant_new_copy;
+  GDExtensionInterfaceVariantDestroy variant_destroy;
+
+  GDExtensionPtrConstructor default_constructor[GDEXTENSION_VARIANT_TYPE_VARIANT_MAX];
+  GDExtensionPtrConstructor copy_constructor[GDEXTENSION_VARIANT_TYPE_VARIANT_MAX];
+  GDExtensionPtrDestructor destructor[GDEXTENSION_VARIANT_TYPE_VARIANT_MAX];
+};
+
+inline BuiltinInterface builtin_interface;
+
+template <GDExtensionVariantType T>
+struct BuiltinLayout;
+
+#define BUILTIN_DECLARE_LAYOUT(SUFFIX, Name, snake)                 \
+  template <>                                                       \
+  struct BuiltinLayout<GDEXTENSION_VARIANT_TYPE_##SUFFIX> {         \
+    static constexpr size_t size = GD_BUILTIN_SIZE_##SUFFIX;        \
+    static constexpr size_t align = GD_BUILTIN_ALIGN_##SUFFIX;      \
+  };
+GD_BUILTIN_TYPES(BUILTIN_DECLARE_LAYOUT)
+#undef BUILTIN_DECLARE_LAYOUT
+
+} // namespace detail
+
+#define BUILTIN_STORE_INTERFACE(name)                               \
+  detail::builtin_interface.name                                    \
+    = reinterpret_cast<decltype(detail::builtin_interface.name)>(p_get_proc_address(#name));
+
+inline void builtin_init(GDExtensionInterfaceGetProcAddress p_get_proc_address) {
+  BUILTIN_STORE_INTERFACE(variant_get_ptr_constructor);
+  BUILTIN_STORE_INTERFACE(string_new_with_utf8_chars);
+  BUILTIN_STORE_INTERFACE(string_name_new_with_utf8_chars);
+  BUILTIN_STORE_INTERFACE(variant_new_nil);
+  BUILTIN_STORE_INTERFACE(variant_new_copy);
+  BUILTIN_STORE_INTERFACE(variant_destroy);
+
+  GDExtensionInterfaceVariantGetPtrDestructor variant_get_ptr_destructor
+    = reinterpret_cast<GDExtensionInterfaceVariantGetPtrDestructor>(p_get_proc_address("variant_get_ptr_destructor"));
+
+  // Nil and Object have no constructors of their own
+  for (int type = GDEXTENSION_VARIANT_TYPE_BOOL; type < GDEXTENSION_VARIANT_TYPE_VARIANT_MAX; type++) {
+    if (type == GDEXTENSION_VARIANT_TYPE_OBJECT) continue;
+    GDExtensionVariantType t = static_cast<GDExtensionVariantType>(type);
+    detail::builtin_interface.default_constructor[type] = detail::builtin_interface.variant_get_ptr_constructor(t, 0);
+    detail::builtin_interface.copy_constructor[type] = detail::builtin_interface.variant_get_ptr_constructor(t, 1);
+    detail::builtin_interface.destructor[type] = variant_get_ptr_destructor(t);
+  }
+}
+
+#undef BUILTIN_STORE_INTERFACE
+
+// Tag for wrappers that are filled by a Godot function taking an
+// `GDExtensionUninitialized*Ptr`, their constructor is skipped
+struct Uninitialized {};
+inline constexpr Uninitialized uninitialized{};
+
+template <GDExtensionVariantType T>
+class Builtin {
+public:
+  static constexpr GDExtensionVariantType type = T;
+  static constexpr size_t size = detail::BuiltinLayout<T>::size;
+
+  Builtin() {
+    detail::builtin_interface.default_constructor[T](data, nullptr);
+  }
+
+  explicit Builtin(Uninitialized) {}
+
+  Builtin(const Builtin &p_other) {
+    copy_from(p_other);
+  }
+
+  Builtin(Builtin &&p_other) noexcept : live(p_other.live) {
+    std::memcpy(data, p_other.data, size);
+    p_other.live = false;
+  }
+
+  Builtin &operator=(const Builtin &p_other) {
+    if (this != &p_other) {
+      destroy();
+      copy_from(p_other);
+    }
+    return *this;
+  }
+
+  Builtin &operator=(Builtin &&p_other) noexcept {
+    if (this != &p_other) {
+      destroy();
+      std::memcpy(data, p_other.data, size);
+      live = p_other.live;
+      p_other.live = false;
+    }
+    return *this;
+  }
+
+  ~Builtin() {
+    destroy();
+  }
+
+  // Any of the type's constructors, `p_index` as in "constructors" in
+  // `extension_api.json`. Not cached, keep it out of hot loops.
+  static Builtin construct(int32_t p_index, const GDExtensionConstTypePtr *p_args) {
+    Builtin res(uninitialized);
+    detail::builtin_interface.variant_get_ptr_constructor(T, p_index)(res.data, p_args);
+    return res;
+  }
+
+  template <GDExtensionVariantType U = T,
+            typename = std::enable_if_t<U == GDEXTENSION_VARIANT_TYPE_STRING>>
+  static Builtin from_utf8(const char *p_contents) {
+    Builtin res(uninitialized);
+    detail::builtin_interface.string_new_with_utf8_chars(res.data, p_contents);
+    return res;
+  }
+
+  template <GDExtensionVariantType U = T,
+            typename = std::enable_if_t<U == GDEXTENSION_VARIANT_TYPE_STRING_NAME>,
+            typename = void>
+  static Builtin from_utf8(const char *p_contents) {
+    Builtin res(uninitialized);
+    detail::builtin_interface.string_name_new_with_utf8_chars(res.data, p_contents);
+    return res;
+  }
+
+  GDExtensionTypePtr ptr() { return data; }
+  GDExtensionConstTypePtr ptr() const { return data; }
+
+  // Gives up ownership, the caller is now responsible for destroying the value
+  void release() { live = false; }
+
+private:
+  void copy_from(const Builtin &p_other) {
+    GDExtensionConstTypePtr args[1] = { p_other.data };
+    detail::builtin_interface.copy_constructor[T](data, args);
+    live = true;
+  }
+
+  void destroy() {
+    GDExtensionPtrDestructor destructor = detail::builtin_interface.destructor[T];
+    if (live && destructor != nullptr) destructor(data);
+    live = false;
+  }
+
+  alignas(detail::BuiltinLayout<T>::align) unsigned char data[size];
+  bool live = true;
+};
+
+class Variant {
+public:
+  static constexpr size_t size = GD_BUILTIN_SIZE_VARIANT;
+
+  Variant() {
+    detail::builtin_interface.variant_new_nil(data);
+  }
+
+  explicit Variant(Uninitialized) {}
+
+  Variant(const Variant &p_other) {
+    detail::builtin_interface.variant_new_copy(data, p_other.data);
+  }
+
+  Variant(Variant &&p_other) noexcept : live(p_other.live) {
+    std::memcpy(data, p_other.data, size);
+    p_other.live = false;
+  }
+
+  Variant &operator=(const Variant &p_other) {
+    if (this != &p_other) {
+      destroy();
+      detail::builtin_interface.variant_new_copy(data, p_other.data);
+      live = true;
+    }
+    return *this;
+  }
+
+  Variant &operator=(Variant &&p_other) noexcept {
+    if (this != &p_other) {
+      destroy();
+      std::memcpy(data, p_other.data, size);
+      live = p_other.live;
+      p_other.live = false;
+    }
+    return *this;
+  }
+
+  ~Variant() {
+    destroy();
+  }
+
+  GDExtensionVariantPtr ptr() { return data; }
+  GDExtensionConstVariantPtr ptr() const { return data; }
+
+  void release() { live = false; }
+
+private:
+  void destroy() {
+    if (live) detail::builtin_interface.variant_destroy(data);
+    live = false;
+  }
+
+  alignas(GD_BUILTIN_ALIGN_VARIANT) unsigned char data[size];
+  bool live = true;
+};
+
+// bool, int and float are plain C++ types already and Object isn't a value
+using String = Builtin<GDEXTENSION_VARIANT_TYPE_STRING>;
+using Vector2 = Builtin<GDEXTENSION_VARIANT_TYPE_VECTOR2>;
+using Vector2i = Builtin<GDEXTENSION_VARIANT_TYPE_VECTOR2I>;
+using Rect2 = Builtin<GDEXTENSION_VARIANT_TYPE_RECT2>;
+using Rect2i = Builtin<GDEXTENSION_VARIANT_TYPE_RECT2I>;
+using Vector3 = Builtin<GDEXTENSION_VARIANT_TYPE_VECTOR3>;
+using Vector3i = Builtin<GDEXTENSION_VARIANT_TYPE_VECTOR3I>;
+using Transform2D = Builtin<GDEXTENSION_VARIANT_TYPE_TRANSFORM2D>;
+using Vector4 = Builtin<GDEXTENSION_VARIANT_TYPE_VECTOR4>;
+using Vector4i = Builtin<GDEXTENSION_VARIANT_TYPE_VECTOR4I>;
+using Plane = Builtin<GDEXTENSION_VARIANT_TYPE_PLANE>;
+using Quaternion = Builtin<GDEXTENSION_VARIANT_TYPE_QUATERNION>;
+using AABB = Builtin<GDEXTENSION_VARIANT_TYPE_AABB>;
+using Basis = Builtin<GDEXTENSION_VARIANT_TYPE_BASIS>;
+using Transform3D = Builtin<GDEXTENSION_VARIANT_TYPE_TRANSFORM3D>;
+using Projection = Builtin<GDEXTENSION_VARIANT_TYPE_PROJECTION>;
+using Color = Builtin<GDEXTENSION_VARIANT_TYPE_COLOR>;
+using StringName = Builtin<GDEXTENSION_VARIANT_TYPE_STRING_NAME>;
+using NodePath = Builtin<GDEXTENSION_VARIANT_TYPE_NODE_PATH>;
+using RID = Builtin<GDEXTENSION_VARIANT_TYPE_RID>;
+using Callable = Builtin<GDEXTENSION_VARIANT_TYPE_CALLABLE>;
+using Signal = Builtin<GDEXTENSION_VARIANT_TYPE_SIGNAL>;
+using Dictionary = Builtin<GDEXTENSION_VARIANT_TYPE_DICTIONARY>;
+using Array = Builtin<GDEXTENSION_VARIANT_TYPE_ARRAY>;
+using PackedByteArray = Builtin<GDEXTENSION_VARIANT_TYPE_PACKED_BYTE_ARRAY>;
+using PackedInt32Array = Builtin<GDEXTENSION_VARIANT_TYPE_PACKED_INT32_ARRAY>;
+using PackedInt64Array = Builtin<GDEXTENSION_VARIANT_TYPE_PACKED_INT64_ARRAY>;
+using PackedFloat32Array = Builtin<GDEXTENSION_VARIANT_TYPE_PACKED_FLOAT32_ARRAY>;
+using PackedFloat64Array = Builtin<GDEXTENSION_VARIANT_TYPE_PACKED_FLOAT64_ARRAY>;
+using PackedStringArray = Builtin<GDEXTENSION_VARIANT_TYPE_PACKED_STRING_ARRAY>;
+using PackedVector2Array = Builtin<GDEXTENSION_VARIANT_TYPE_PACKED_VECTOR2_ARRAY>;
+using PackedVector3Array = Builtin<GDEXTENSION_VARIANT_TYPE_PACKED_VECTOR3_ARRAY>;
+using PackedColorArray = Builtin<GDEXTENSION_VARIANT_TYPE_PACKED_COLOR_ARRAY>;
+
+} // namespace gd
+
+#endif
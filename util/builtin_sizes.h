@@ -0,0 +1,371 @@
+#ifndef BUILTIN_SIZES_H
+#define BUILTIN_SIZES_H
+
+// Generated by util/generate_builtin_sizes.py from gde-api's
+// `builtin_class_sizes`, do not edit by hand.
+//
+// Define IS_GODOT_64_BIT and IS_GODOT_USING_LARGE_WORLD_COORDINATES before
+// including this header to pick a build configuration. There are no
+// defaults, a define that comes after the include would silently lose.
+
+// `true`/`false` have to be macros for the #if below to work in C
+#ifndef __cplusplus
+#include <stdbool.h>
+#endif
+
+#if !defined(IS_GODOT_64_BIT) || !defined(IS_GODOT_USING_LARGE_WORLD_COORDINATES)
+#error "define IS_GODOT_64_BIT / IS_GODOT_USING_LARGE_WORLD_COORDINATES before including builtin_sizes.h"
+#endif
+
+// X(ENUM_SUFFIX, GodotName, snake_name) for every builtin type but Nil and Object,
+// which have no constructors or destructor
+#define GD_BUILTIN_TYPES(X) \
+  X(BOOL, bool, bool) \
+  X(INT, int, int) \
+  X(FLOAT, float, float) \
+  X(STRING, String, string) \
+  X(VECTOR2, Vector2, vector2) \
+  X(VECTOR2I, Vector2i, vector2i) \
+  X(RECT2, Rect2, rect2) \
+  X(RECT2I, Rect2i, rect2i) \
+  X(VECTOR3, Vector3, vector3) \
+  X(VECTOR3I, Vector3i, vector3i) \
+  X(TRANSFORM2D, Transform2D, transform2d) \
+  X(VECTOR4, Vector4, vector4) \
+  X(VECTOR4I, Vector4i, vector4i) \
+  X(PLANE, Plane, plane) \
+  X(QUATERNION, Quaternion, quaternion) \
+  X(AABB, AABB, aabb) \
+  X(BASIS, Basis, basis) \
+  X(TRANSFORM3D, Transform3D, transform3d) \
+  X(PROJECTION, Projection, projection) \
+  X(COLOR, Color, color) \
+  X(STRING_NAME, StringName, string_name) \
+  X(NODE_PATH, NodePath, node_path) \
+  X(RID, RID, rid) \
+  X(CALLABLE, Callable, callable) \
+  X(SIGNAL, Signal, signal) \
+  X(DICTIONARY, Dictionary, dictionary) \
+  X(ARRAY, Array, array) \
+  X(PACKED_BYTE_ARRAY, PackedByteArray, packed_byte_array) \
+  X(PACKED_INT32_ARRAY, PackedInt32Array, packed_int32_array) \
+  X(PACKED_INT64_ARRAY, PackedInt64Array, packed_int64_array) \
+  X(PACKED_FLOAT32_ARRAY, PackedFloat32Array, packed_float32_array) \
+  X(PACKED_FLOAT64_ARRAY, PackedFloat64Array, packed_float64_array) \
+  X(PACKED_STRING_ARRAY, PackedStringArray, packed_string_array) \
+  X(PACKED_VECTOR2_ARRAY, PackedVector2Array, packed_vector2_array) \
+  X(PACKED_VECTOR3_ARRAY, PackedVector3Array, packed_vector3_array) \
+  X(PACKED_COLOR_ARRAY, PackedColorArray, packed_color_array) \
+
+
+#if (!IS_GODOT_64_BIT && !IS_GODOT_USING_LARGE_WORLD_COORDINATES) // float_32
+#define GD_BUILTIN_SIZE_BOOL (1)
+#define GD_BUILTIN_ALIGN_BOOL (1)
+#define GD_BUILTIN_SIZE_INT (8)
+#define GD_BUILTIN_ALIGN_INT (8)
+#define GD_BUILTIN_SIZE_FLOAT (8)
+#define GD_BUILTIN_ALIGN_FLOAT (8)
+#define GD_BUILTIN_SIZE_STRING (4)
+#define GD_BUILTIN_ALIGN_STRING (4)
+#define GD_BUILTIN_SIZE_VECTOR2 (8)
+#define GD_BUILTIN_ALIGN_VECTOR2 (4)
+#define GD_BUILTIN_SIZE_VECTOR2I (8)
+#define GD_BUILTIN_ALIGN_VECTOR2I (4)
+#define GD_BUILTIN_SIZE_RECT2 (16)
+#define GD_BUILTIN_ALIGN_RECT2 (4)
+#define GD_BUILTIN_SIZE_RECT2I (16)
+#define GD_BUILTIN_ALIGN_RECT2I (4)
+#define GD_BUILTIN_SIZE_VECTOR3 (12)
+#define GD_BUILTIN_ALIGN_VECTOR3 (4)
+#define GD_BUILTIN_SIZE_VECTOR3I (12)
+#define GD_BUILTIN_ALIGN_VECTOR3I (4)
+#define GD_BUILTIN_SIZE_TRANSFORM2D (24)
+#define GD_BUILTIN_ALIGN_TRANSFORM2D (4)
+#define GD_BUILTIN_SIZE_VECTOR4 (16)
+#define GD_BUILTIN_ALIGN_VECTOR4 (4)
+#define GD_BUILTIN_SIZE_VECTOR4I (16)
+#define GD_BUILTIN_ALIGN_VECTOR4I (4)
+#define GD_BUILTIN_SIZE_PLANE (16)
+#define GD_BUILTIN_ALIGN_PLANE (4)
+#define GD_BUILTIN_SIZE_QUATERNION (16)
+#define GD_BUILTIN_ALIGN_QUATERNION (4)
+#define GD_BUILTIN_SIZE_AABB (24)
+#define GD_BUILTIN_ALIGN_AABB (4)
+#define GD_BUILTIN_SIZE_BASIS (36)
+#define GD_BUILTIN_ALIGN_BASIS (4)
+#define GD_BUILTIN_SIZE_TRANSFORM3D (48)
+#define GD_BUILTIN_ALIGN_TRANSFORM3D (4)
+#define GD_BUILTIN_SIZE_PROJECTION (64)
+#define GD_BUILTIN_ALIGN_PROJECTION (4)
+#define GD_BUILTIN_SIZE_COLOR (16)
+#define GD_BUILTIN_ALIGN_COLOR (4)
+#define GD_BUILTIN_SIZE_STRING_NAME (4)
+#define GD_BUILTIN_ALIGN_STRING_NAME (4)
+#define GD_BUILTIN_SIZE_NODE_PATH (4)
+#define GD_BUILTIN_ALIGN_NODE_PATH (4)
+#define GD_BUILTIN_SIZE_RID (8)
+#define GD_BUILTIN_ALIGN_RID (8)
+#define GD_BUILTIN_SIZE_OBJECT (4)
+#define GD_BUILTIN_ALIGN_OBJECT (4)
+#define GD_BUILTIN_SIZE_CALLABLE (16)
+#define GD_BUILTIN_ALIGN_CALLABLE (8)
+#define GD_BUILTIN_SIZE_SIGNAL (16)
+#define GD_BUILTIN_ALIGN_SIGNAL (8)
+#define GD_BUILTIN_SIZE_DICTIONARY (4)
+#define GD_BUILTIN_ALIGN_DICTIONARY (4)
+#define GD_BUILTIN_SIZE_ARRAY (4)
+#define GD_BUILTIN_ALIGN_ARRAY (4)
+#define GD_BUILTIN_SIZE_PACKED_BYTE_ARRAY (8)
+#define GD_BUILTIN_ALIGN_PACKED_BYTE_ARRAY (4)
+#define GD_BUILTIN_SIZE_PACKED_INT32_ARRAY (8)
+#define GD_BUILTIN_ALIGN_PACKED_INT32_ARRAY (4)
+#define GD_BUILTIN_SIZE_PACKED_INT64_ARRAY (8)
+#define GD_BUILTIN_ALIGN_PACKED_INT64_ARRAY (4)
+#define GD_BUILTIN_SIZE_PACKED_FLOAT32_ARRAY (8)
+#define GD_BUILTIN_ALIGN_PACKED_FLOAT32_ARRAY (4)
+#define GD_BUILTIN_SIZE_PACKED_FLOAT64_ARRAY (8)
+#define GD_BUILTIN_ALIGN_PACKED_FLOAT64_ARRAY (4)
+#define GD_BUILTIN_SIZE_PACKED_STRING_ARRAY (8)
+#define GD_BUILTIN_ALIGN_PACKED_STRING_ARRAY (4)
+#define GD_BUILTIN_SIZE_PACKED_VECTOR2_ARRAY (8)
+#define GD_BUILTIN_ALIGN_PACKED_VECTOR2_ARRAY (4)
+#define GD_BUILTIN_SIZE_PACKED_VECTOR3_ARRAY (8)
+#define GD_BUILTIN_ALIGN_PACKED_VECTOR3_ARRAY (4)
+#define GD_BUILTIN_SIZE_PACKED_COLOR_ARRAY (8)
+#define GD_BUILTIN_ALIGN_PACKED_COLOR_ARRAY (4)
+#define GD_BUILTIN_SIZE_VARIANT (24)
+#define GD_BUILTIN_ALIGN_VARIANT (8)
+#elif (IS_GODOT_64_BIT && !IS_GODOT_USING_LARGE_WORLD_COORDINATES) // float_64
+#define GD_BUILTIN_SIZE_BOOL (1)
+#define GD_BUILTIN_ALIGN_BOOL (1)
+#define GD_BUILTIN_SIZE_INT (8)
+#define GD_BUILTIN_ALIGN_INT (8)
+#define GD_BUILTIN_SIZE_FLOAT (8)
+#define GD_BUILTIN_ALIGN_FLOAT (8)
+#define GD_BUILTIN_SIZE_STRING (8)
+#define GD_BUILTIN_ALIGN_STRING (8)
+#define GD_BUILTIN_SIZE_VECTOR2 (8)
+#define GD_BUILTIN_ALIGN_VECTOR2 (4)
+#define GD_BUILTIN_SIZE_VECTOR2I (8)
+#define GD_BUILTIN_ALIGN_VECTOR2I (4)
+#define GD_BUILTIN_SIZE_RECT2 (16)
+#define GD_BUILTIN_ALIGN_RECT2 (4)
+#define GD_BUILTIN_SIZE_RECT2I (16)
+#define GD_BUILTIN_ALIGN_RECT2I (4)
+#define GD_BUILTIN_SIZE_VECTOR3 (12)
+#define GD_BUILTIN_ALIGN_VECTOR3 (4)
+#define GD_BUILTIN_SIZE_VECTOR3I (12)
+#define GD_BUILTIN_ALIGN_VECTOR3I (4)
+#define GD_BUILTIN_SIZE_TRANSFORM2D (24)
+#define GD_BUILTIN_ALIGN_TRANSFORM2D (4)
+#define GD_BUILTIN_SIZE_VECTOR4 (16)
+#define GD_BUILTIN_ALIGN_VECTOR4 (4)
+#define GD_BUILTIN_SIZE_VECTOR4I (16)
+#define GD_BUILTIN_ALIGN_VECTOR4I (4)
+#define GD_BUILTIN_SIZE_PLANE (16)
+#define GD_BUILTIN_ALIGN_PLANE (4)
+#define GD_BUILTIN_SIZE_QUATERNION (16)
+#define GD_BUILTIN_ALIGN_QUATERNION (4)
+#define GD_BUILTIN_SIZE_AABB (24)
+#define GD_BUILTIN_ALIGN_AABB (4)
+#define GD_BUILTIN_SIZE_BASIS (36)
+#define GD_BUILTIN_ALIGN_BASIS (4)
+#define GD_BUILTIN_SIZE_TRANSFORM3D (48)
+#define GD_BUILTIN_ALIGN_TRANSFORM3D (4)
+#define GD_BUILTIN_SIZE_PROJECTION (64)
+#define GD_BUILTIN_ALIGN_PROJECTION (4)
+#define GD_BUILTIN_SIZE_COLOR (16)
+#define GD_BUILTIN_ALIGN_COLOR (4)
+#define GD_BUILTIN_SIZE_STRING_NAME (8)
+#define GD_BUILTIN_ALIGN_STRING_NAME (8)
+#define GD_BUILTIN_SIZE_NODE_PATH (8)
+#define GD_BUILTIN_ALIGN_NODE_PATH (8)
+#define GD_BUILTIN_SIZE_RID (8)
+#define GD_BUILTIN_ALIGN_RID (8)
+#define GD_BUILTIN_SIZE_OBJECT (8)
+#define GD_BUILTIN_ALIGN_OBJECT (8)
+#define GD_BUILTIN_SIZE_CALLABLE (16)
+#define GD_BUILTIN_ALIGN_CALLABLE (8)
+#define GD_BUILTIN_SIZE_SIGNAL (16)
+#define GD_BUILTIN_ALIGN_SIGNAL (8)
+#define GD_BUILTIN_SIZE_DICTIONARY (8)
+#define GD_BUILTIN_ALIGN_DICTIONARY (8)
+#define GD_BUILTIN_SIZE_ARRAY (8)
+#define GD_BUILTIN_ALIGN_ARRAY (8)
+#define GD_BUILTIN_SIZE_PACKED_BYTE_ARRAY (16)
+#define GD_BUILTIN_ALIGN_PACKED_BYTE_ARRAY (8)
+#define GD_BUILTIN_SIZE_PACKED_INT32_ARRAY (16)
+#define GD_BUILTIN_ALIGN_PACKED_INT32_ARRAY (8)
+#define GD_BUILTIN_SIZE_PACKED_INT64_ARRAY (16)
+#define GD_BUILTIN_ALIGN_PACKED_INT64_ARRAY (8)
+#define GD_BUILTIN_SIZE_PACKED_FLOAT32_ARRAY (16)
+#define GD_BUILTIN_ALIGN_PACKED_FLOAT32_ARRAY (8)
+#define GD_BUILTIN_SIZE_PACKED_FLOAT64_ARRAY (16)
+#define GD_BUILTIN_ALIGN_PACKED_FLOAT64_ARRAY (8)
+#define GD_BUILTIN_SIZE_PACKED_STRING_ARRAY (16)
+#define GD_BUILTIN_ALIGN_PACKED_STRING_ARRAY (8)
+#define GD_BUILTIN_SIZE_PACKED_VECTOR2_ARRAY (16)
+#define GD_BUILTIN_ALIGN_PACKED_VECTOR2_ARRAY (8)
+#define GD_BUILTIN_SIZE_PACKED_VECTOR3_ARRAY (16)
+#define GD_BUILTIN_ALIGN_PACKED_VECTOR3_ARRAY (8)
+#define GD_BUILTIN_SIZE_PACKED_COLOR_ARRAY (16)
+#define GD_BUILTIN_ALIGN_PACKED_COLOR_ARRAY (8)
+#define GD_BUILTIN_SIZE_VARIANT (24)
+#define GD_BUILTIN_ALIGN_VARIANT (8)
+#elif (!IS_GODOT_64_BIT && IS_GODOT_USING_LARGE_WORLD_COORDINATES) // double_32
+#define GD_BUILTIN_SIZE_BOOL (1)
+#define GD_BUILTIN_ALIGN_BOOL (1)
+#define GD_BUILTIN_SIZE_INT (8)
+#define GD_BUILTIN_ALIGN_INT (8)
+#define GD_BUILTIN_SIZE_FLOAT (8)
+#define GD_BUILTIN_ALIGN_FLOAT (8)
+#define GD_BUILTIN_SIZE_STRING (4)
+#define GD_BUILTIN_ALIGN_STRING (4)
+#define GD_BUILTIN_SIZE_VECTOR2 (16)
+#define GD_BUILTIN_ALIGN_VECTOR2 (8)
+#define GD_BUILTIN_SIZE_VECTOR2I (8)
+#define GD_BUILTIN_ALIGN_VECTOR2I (4)
+#define GD_BUILTIN_SIZE_RECT2 (32)
+#define GD_BUILTIN_ALIGN_RECT2 (8)
+#define GD_BUILTIN_SIZE_RECT2I (16)
+#define GD_BUILTIN_ALIGN_RECT2I (4)
+#define GD_BUILTIN_SIZE_VECTOR3 (24)
+#define GD_BUILTIN_ALIGN_VECTOR3 (8)
+#define GD_BUILTIN_SIZE_VECTOR3I (12)
+#define GD_BUILTIN_ALIGN_VECTOR3I (4)
+#define GD_BUILTIN_SIZE_TRANSFORM2D (48)
+#define GD_BUILTIN_ALIGN_TRANSFORM2D (8)
+#define GD_BUILTIN_SIZE_VECTOR4 (32)
+#define GD_BUILTIN_ALIGN_VECTOR4 (8)
+#define GD_BUILTIN_SIZE_VECTOR4I (16)
+#define GD_BUILTIN_ALIGN_VECTOR4I (4)
+#define GD_BUILTIN_SIZE_PLANE (32)
+#define GD_BUILTIN_ALIGN_PLANE (8)
+#define GD_BUILTIN_SIZE_QUATERNION (32)
+#define GD_BUILTIN_ALIGN_QUATERNION (8)
+#define GD_BUILTIN_SIZE_AABB (48)
+#define GD_BUILTIN_ALIGN_AABB (8)
+#define GD_BUILTIN_SIZE_BASIS (72)
+#define GD_BUILTIN_ALIGN_BASIS (8)
+#define GD_BUILTIN_SIZE_TRANSFORM3D (96)
+#define GD_BUILTIN_ALIGN_TRANSFORM3D (8)
+#define GD_BUILTIN_SIZE_PROJECTION (128)
+#define GD_BUILTIN_ALIGN_PROJECTION (8)
+#define GD_BUILTIN_SIZE_COLOR (16)
+#define GD_BUILTIN_ALIGN_COLOR (4)
+#define GD_BUILTIN_SIZE_STRING_NAME (4)
+#define GD_BUILTIN_ALIGN_STRING_NAME (4)
+#define GD_BUILTIN_SIZE_NODE_PATH (4)
+#define GD_BUILTIN_ALIGN_NODE_PATH (4)
+#define GD_BUILTIN_SIZE_RID (8)
+#define GD_BUILTIN_ALIGN_RID (8)
+#define GD_BUILTIN_SIZE_OBJECT (4)
+#define GD_BUILTIN_ALIGN_OBJECT (4)
+#define GD_BUILTIN_SIZE_CALLABLE (16)
+#define GD_BUILTIN_ALIGN_CALLABLE (8)
+#define GD_BUILTIN_SIZE_SIGNAL (16)
+#define GD_BUILTIN_ALIGN_SIGNAL (8)
+#define GD_BUILTIN_SIZE_DICTIONARY (4)
+#define GD_BUILTIN_ALIGN_DICTIONARY (4)
+#define GD_BUILTIN_SIZE_ARRAY (4)
+#define GD_BUILTIN_ALIGN_ARRAY (4)
+#define GD_BUILTIN_SIZE_PACKED_BYTE_ARRAY (8)
+#define GD_BUILTIN_ALIGN_PACKED_BYTE_ARRAY (4)
+#define GD_BUILTIN_SIZE_PACKED_INT32_ARRAY (8)
+#define GD_BUILTIN_ALIGN_PACKED_INT32_ARRAY (4)
+#define GD_BUILTIN_SIZE_PACKED_INT64_ARRAY (8)
+#define GD_BUILTIN_ALIGN_PACKED_INT64_ARRAY (4)
+#define GD_BUILTIN_SIZE_PACKED_FLOAT32_ARRAY (8)
+#define GD_BUILTIN_ALIGN_PACKED_FLOAT32_ARRAY (4)
+#define GD_BUILTIN_SIZE_PACKED_FLOAT64_ARRAY (8)
+#define GD_BUILTIN_ALIGN_PACKED_FLOAT64_ARRAY (4)
+#define GD_BUILTIN_SIZE_PACKED_STRING_ARRAY (8)
+#define GD_BUILTIN_ALIGN_PACKED_STRING_ARRAY (4)
+#define GD_BUILTIN_SIZE_PACKED_VECTOR2_ARRAY (8)
+#define GD_BUILTIN_ALIGN_PACKED_VECTOR2_ARRAY (4)
+#define GD_BUILTIN_SIZE_PACKED_VECTOR3_ARRAY (8)
+#define GD_BUILTIN_ALIGN_PACKED_VECTOR3_ARRAY (4)
+#define GD_BUILTIN_SIZE_PACKED_COLOR_ARRAY (8)
+#define GD_BUILTIN_ALIGN_PACKED_COLOR_ARRAY (4)
+#define GD_BUILTIN_SIZE_VARIANT (40)
+#define GD_BUILTIN_ALIGN_VARIANT (8)
+#elif (IS_GODOT_64_BIT && IS_GODOT_USING_LARGE_WORLD_COORDINATES) // double_64
+#define GD_BUILTIN_SIZE_BOOL (1)
+#define GD_BUILTIN_ALIGN_BOOL (1)
+#define GD_BUILTIN_SIZE_INT (8)
+#define GD_BUILTIN_ALIGN_INT (8)
+#define GD_BUILTIN_SIZE_FLOAT (8)
+#define GD_BUILTIN_ALIGN_FLOAT (8)
+#define GD_BUILTIN_SIZE_STRING (8)
+#define GD_BUILTIN_ALIGN_STRING (8)
+#define GD_BUILTIN_SIZE_VECTOR2 (16)
+#define GD_BUILTIN_ALIGN_VECTOR2 (8)
+#define GD_BUILTIN_SIZE_VECTOR2I (8)
+#define GD_BUILTIN_ALIGN_VECTOR2I (4)
+#define GD_BUILTIN_SIZE_RECT2 (32)
+#define GD_BUILTIN_ALIGN_RECT2 (8)
+#define GD_BUILTIN_SIZE_RECT2I (16)
+#define GD_BUILTIN_ALIGN_RECT2I (4)
+#define GD_BUILTIN_SIZE_VECTOR3 (24)
+#define GD_BUILTIN_ALIGN_VECTOR3 (8)
+#define GD_BUILTIN_SIZE_VECTOR3I (12)
+#define GD_BUILTIN_ALIGN_VECTOR3I (4)
+#define GD_BUILTIN_SIZE_TRANSFORM2D (48)
+#define GD_BUILTIN_ALIGN_TRANSFORM2D (8)
+#define GD_BUILTIN_SIZE_VECTOR4 (32)
+#define GD_BUILTIN_ALIGN_VECTOR4 (8)
+#define GD_BUILTIN_SIZE_VECTOR4I (16)
+#define GD_BUILTIN_ALIGN_VECTOR4I (4)
+#define GD_BUILTIN_SIZE_PLANE (32)
+#define GD_BUILTIN_ALIGN_PLANE (8)
+#define GD_BUILTIN_SIZE_QUATERNION (32)
+#define GD_BUILTIN_ALIGN_QUATERNION (8)
+#define GD_BUILTIN_SIZE_AABB (48)
+#define GD_BUILTIN_ALIGN_AABB (8)
+#define GD_BUILTIN_SIZE_BASIS (72)
+#define GD_BUILTIN_ALIGN_BASIS (8)
+#define GD_BUILTIN_SIZE_TRANSFORM3D (96)
+#define GD_BUILTIN_ALIGN_TRANSFORM3D (8)
+#define GD_BUILTIN_SIZE_PROJECTION (128)
+#define GD_BUILTIN_ALIGN_PROJECTION (8)
+#define GD_BUILTIN_SIZE_COLOR (16)
+#define GD_BUILTIN_ALIGN_COLOR (4)
+#define GD_BUILTIN_SIZE_STRING_NAME (8)
+#define GD_BUILTIN_ALIGN_STRING_NAME (8)
+#define GD_BUILTIN_SIZE_NODE_PATH (8)
+#define GD_BUILTIN_ALIGN_NODE_PATH (8)
+#define GD_BUILTIN_SIZE_RID (8)
+#define GD_BUILTIN_ALIGN_RID (8)
+#define GD_BUILTIN_SIZE_OBJECT (8)
+#define GD_BUILTIN_ALIGN_OBJECT (8)
+#define GD_BUILTIN_SIZE_CALLABLE (16)
+#define GD_BUILTIN_ALIGN_CALLABLE (8)
+#define GD_BUILTIN_SIZE_SIGNAL (16)
+#define GD_BUILTIN_ALIGN_SIGNAL (8)
+#define GD_BUILTIN_SIZE_DICTIONARY (8)
+#define GD_BUILTIN_ALIGN_DICTIONARY (8)
+#define GD_BUILTIN_SIZE_ARRAY (8)
+#define GD_BUILTIN_ALIGN_ARRAY (8)
+#define GD_BUILTIN_SIZE_PACKED_BYTE_ARRAY (16)
+#define GD_BUILTIN_ALIGN_PACKED_BYTE_ARRAY (8)
+#define GD_BUILTIN_SIZE_PACKED_INT32_ARRAY (16)
+#define GD_BUILTIN_ALIGN_PACKED_INT32_ARRAY (8)
+#define GD_BUILTIN_SIZE_PACKED_INT64_ARRAY (16)
+#define GD_BUILTIN_ALIGN_PACKED_INT64_ARRAY (8)
+#define GD_BUILTIN_SIZE_PACKED_FLOAT32_ARRAY (16)
+#define GD_BUILTIN_ALIGN_PACKED_FLOAT32_ARRAY (8)
+#define GD_BUILTIN_SIZE_PACKED_FLOAT64_ARRAY (16)
+#define GD_BUILTIN_ALIGN_PACKED_FLOAT64_ARRAY (8)
+#define GD_BUILTIN_SIZE_PACKED_STRING_ARRAY (16)
+#define GD_BUILTIN_ALIGN_PACKED_STRING_ARRAY (8)
+#define GD_BUILTIN_SIZE_PACKED_VECTOR2_ARRAY (16)
+#define GD_BUILTIN_ALIGN_PACKED_VECTOR2_ARRAY (8)
+#define GD_BUILTIN_SIZE_PACKED_VECTOR3_ARRAY (16)
+#define GD_BUILTIN_ALIGN_PACKED_VECTOR3_ARRAY (8)
+#define GD_BUILTIN_SIZE_PACKED_COLOR_ARRAY (16)
+#define GD_BUILTIN_ALIGN_PACKED_COLOR_ARRAY (8)
+#define GD_BUILTIN_SIZE_VARIANT (40)
+#define GD_BUILTIN_ALIGN_VARIANT (8)
+#endif
+
+#endif
@@ -0,0 +1,419 @@
+#ifndef DYNAMIC_CALL_H
+#define DYNAMIC_CALL_H
+
+// Calls engine methods by name, with inline caches in front of ClassDB.
+//
+// `classdb_get_method_bind` wants the class, the method name and the hash of
+// the method's signature, which is fine when the call is written by hand (see
+// `OS.alert` in `hello_ptrcall_os_alert.c`) but not when the name only shows
+// up at runtime, like in bindings for dynamic languages. Here the hashes are
+// registered once with `dynamic_call_register` (a binding would generate them
+// from `extension_api.json`), and calls only pass an object and a method
+// StringName.
+//
+// Usage:
+//
+//   dynamic_call_init(p_get_proc_address, p_library); // in godot_entry
+//   dynamic_call_register("Node2D", "set_position", 743155724);
+//   ...
+//   GDExtensionCallError error;
+//   DYNAMIC_CALL(object, method_string_name, args, 1, &ret, &error);
+//   ...
+//   dynamic_call_deinit(); // on deinitialization
+//
+// Resolving (object class, method) to a method bind happens in three steps:
+//
+// 1. Every DYNAMIC_CALL has its own static cache with DYNAMIC_CALL_SITE_WAYS
+//    entries. Most sites only ever see one class (monomorphic), some see a
+//    few (polymorphic). A hit costs a couple of compares.
+// 2. A global open-addressing hash table of every pair resolved so far.
+//    Sites that see more classes than they can remember (megamorphic) end up
+//    here every time.
+// 3. A miss walks up the class hierarchy (`ClassDB.get_parent_class`) until
+//    it finds a registered hash for the method, then asks
+//    `classdb_get_method_bind`. Pairs without a registered hash (script
+//    methods, or methods nobody registered) are remembered too, and go
+//    through `variant_call` on the object, which also finds script methods.
+//
+// Classes and methods are keyed by the identity of their StringName. Godot
+// interns StringNames: two StringNames are equal exactly when they point at
+// the same data, which is also all that Godot's operator== compares. The
+// global table holds a reference to every key it stores, so a key can't be
+// freed and reused for another name while it's cached.
+//
+// NOTE: Not thread safe, the caches are meant to be used from the main
+// thread.
+
+#include "../godot-headers/gdextension_interface.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DYNAMIC_CALL_SITE_WAYS (4)
+#define DYNAMIC_CALL_TABLE_INITIAL_CAPACITY (64)
+#define DYNAMIC_CALL_STRING_NAME_SIZE (sizeof(void *))
+// Big enough for a Variant with and without large world coordinates
+#define DYNAMIC_CALL_VARIANT_SIZE (40)
+// Deeper than any class hierarchy in Godot, guards against a broken ClassDB
+#define DYNAMIC_CALL_MAX_CLASS_DEPTH (64)
+
+typedef struct {
+  void *class_key;
+  void *method_key;
+  // NULL: call through `variant_call`
+  GDExtensionMethodBindPtr bind;
+} dynamic_call_way_t;
+
+typedef struct {
+  uint32_t count;
+  dynamic_call_way_t ways[DYNAMIC_CALL_SITE_WAYS];
+} dynamic_call_site_t;
+
+typedef struct {
+  // References that keep the keys alive
+  uint8_t class_name[DYNAMIC_CALL_STRING_NAME_SIZE];
+  uint8_t method_name[DYNAMIC_CALL_STRING_NAME_SIZE];
+  dynamic_call_way_t way;
+} dynamic_call_entry_t;
+
+typedef struct {
+  uint8_t class_name[DYNAMIC_CALL_STRING_NAME_SIZE];
+  uint8_t method_name[DYNAMIC_CALL_STRING_NAME_SIZE];
+  GDExtensionInt hash;
+} dynamic_call_known_t;
+
+typedef struct {
+  uint64_t site_hits;
+  uint64_t table_hits;
+  uint64_t misses;
+  uint64_t megamorphic;
+  uint64_t fallback_calls;
+} dynamic_call_stats_t;
+
+static struct {
+  struct {
+    GDExtensionInterfaceStringNameNewWithUtf8Chars string_name_new_with_utf8_chars;
+    GDExtensionInterfaceVariantGetPtrConstructor variant_get_ptr_constructor;
+    GDExtensionInterfaceVariantGetPtrDestructor variant_get_ptr_destructor;
+    GDExtensionInterfaceGetVariantFromTypeConstructor get_variant_from_type_constructor;
+    GDExtensionInterfaceGetVariantToTypeConstructor get_variant_to_type_constructor;
+    GDExtensionInterfaceVariantCall variant_call;
+    GDExtensionInterfaceVariantDestroy variant_destroy;
+    GDExtensionInterfaceGlobalGetSingleton global_get_singleton;
+    GDExtensionInterfaceObjectGetClassName object_get_class_name;
+    GDExtensionInterfaceObjectMethodBindCall object_method_bind_call;
+    GDExtensionInterfaceClassdbGetMethodBind classdb_get_method_bind;
+  } interface;
+
+  GDExtensionClassLibraryPtr library;
+  GDExtensionPtrConstructor string_name_copy;
+  GDExtensionPtrDestructor string_name_destructor;
+  GDExtensionVariantFromTypeConstructorFunc object_to_variant;
+  GDExtensionVariantFromTypeConstructorFunc string_name_to_variant;
+  GDExtensionTypeFromVariantConstructorFunc variant_to_string_name;
+
+  // Only searched on a miss, so a plain array is good enough
+  dynamic_call_known_t *known;
+  uint32_t known_count;
+  uint32_t known_capacity;
+
+  // Power of two capacity, never more than half full
+  dynamic_call_entry_t *entries;
+  uint32_t entry_count;
+  uint32_t entry_capacity;
+
+  dynamic_call_stats_t stats;
+} dynamic_call;
+
+#define DYNAMIC_CALL_STORE_INTERFACE(name) \
+  dynamic_call.interface.name = (void *)p_get_proc_address(#name);
+
+static void
+dynamic_call_init(
+  GDExtensionInterfaceGetProcAddress p_get_proc_address,
+  GDExtensionClassLibraryPtr p_library
+) {
+  DYNAMIC_CALL_STORE_INTERFACE(string_name_new_with_utf8_chars);
+  DYNAMIC_CALL_STORE_INTERFACE(variant_get_ptr_constructor);
+  DYNAMIC_CALL_STORE_INTERFACE(variant_get_ptr_destructor);
+  DYNAMIC_CALL_STORE_INTERFACE(get_variant_from_type_constructor);
+  DYNAMIC_CALL_STORE_INTERFACE(get_variant_to_type_constructor);
+  DYNAMIC_CALL_STORE_INTERFACE(variant_call);
+  DYNAMIC_CALL_STORE_INTERFACE(variant_destroy);
+  DYNAMIC_CALL_STORE_INTERFACE(global_get_singleton);
+  DYNAMIC_CALL_STORE_INTERFACE(object_get_class_name);
+  DYNAMIC_CALL_STORE_INTERFACE(object_method_bind_call);
+  DYNAMIC_CALL_STORE_INTERFACE(classdb_get_method_bind);
+
+  dynamic_call.library = p_library;
+  // Constructor 1 of every builtin type is the copy constructor
+  dynamic_call.string_name_copy
+    = dynamic_call.interface.variant_get_ptr_constructor(GDEXTENSION_VARIANT_TYPE_STRING_NAME, 1);
+  dynamic_call.string_name_destructor
+    = dynamic_call.interface.variant_get_ptr_destructor(GDEXTENSION_VARIANT_TYPE_STRING_NAME);
+  dynamic_call.object_to_variant
+    = dynamic_call.interface.get_variant_from_type_constructor(GDEXTENSION_VARIANT_TYPE_OBJECT);
+  dynamic_call.string_name_to_variant
+    = dynamic_call.interface.get_variant_from_type_constructor(GDEXTENSION_VARIANT_TYPE_STRING_NAME);
+  dynamic_call.variant_to_string_name
+    = dynamic_call.interface.get_variant_to_type_constructor(GDEXTENSION_VARIANT_TYPE_STRING_NAME);
+}
+
+static inline void *dynamic_call_key(GDExtensionConstStringNamePtr p_string_name) {
+  void *res;
+  memcpy(&res, p_string_name, sizeof(res));
+  return res;
+}
+
+static inline void dynamic_call_copy_string_name(void *r_dest, GDExtensionConstStringNamePtr p_src) {
+  const GDExtensionConstTypePtr args[1] = { p_src };
+  dynamic_call.string_name_copy(r_dest, args);
+}
+
+// `hash` is the "hash" of the method in `extension_api.json`. Registering a
+// method of a parent class covers all classes that inherit it.
+static void dynamic_call_register(const char *class_name, const char *method, GDExtensionInt hash) {
+  if (dynamic_call.known_count == dynamic_call.known_capacity) {
+    uint32_t capacity = dynamic_call.known_capacity > 0 ? dynamic_call.known_capacity * 2 : 64;
+    dynamic_call.known = realloc(dynamic_call.known, capacity * sizeof(dynamic_call_known_t));
+    dynamic_call.known_capacity = capacity;
+  }
+  dynamic_call_known_t *known = &dynamic_call.known[dynamic_call.known_count++];
+  dynamic_call.interface.string_name_new_with_utf8_chars(known->class_name, class_name);
+  dynamic_call.interface.string_name_new_with_utf8_chars(known->method_name, method);
+  known->hash = hash;
+}
+
+static const dynamic_call_known_t *dynamic_call_find_known(void *class_key, void *method_key) {
+  for (uint32_t i = 0; i < dynamic_call.known_count; i++) {
+    const dynamic_call_known_t *known = &dynamic_call.known[i];
+    if (dynamic_call_key(known->class_name) == class_key && dynamic_call_key(known->method_name) == method_key) {
+      return known;
+    }
+  }
+  return NULL;
+}
+
+static inline uint32_t dynamic_call_hash(void *class_key, void *method_key) {
+  // Pointers are at least 8-byte aligned, mix the bits so the low ones
+  // aren't always zero
+  uint64_t h = (uint64_t)(uintptr_t)class_key * 0x9E3779B97F4A7C15ull;
+  h ^= (uint64_t)(uintptr_t)method_key + 0x632BE59BD9B4E019ull + (h << 6) + (h >> 2);
+  h ^= h >> 29;
+  return (uint32_t)h;
+}
+
+static dynamic_call_entry_t *dynamic_call_table_find(void *class_key, void *method_key) {
+  if (dynamic_call.entry_capacity == 0) return NULL;
+
+  uint32_t mask = dynamic_call.entry_capacity - 1;
+  for (uint32_t i = dynamic_call_hash(class_key, method_key) & mask;; i = (i + 1) & mask) {
+    dynamic_call_entry_t *entry = &dynamic_call.entries[i];
+    if (entry->way.class_key == NULL) return NULL;
+    if (entry->way.class_key == class_key && entry->way.method_key == method_key) return entry;
+  }
+}
+
+// Returns the empty slot for a key that isn't in the table
+static dynamic_call_entry_t *dynamic_call_table_slot(dynamic_call_entry_t *entries, uint32_t capacity, void *class_key, void *method_key) {
+  uint32_t mask = capacity - 1;
+  uint32_t i = dynamic_call_hash(class_key, method_key) & mask;
+  while (entries[i].way.class_key != NULL) i = (i + 1) & mask;
+  return &entries[i];
+}
+
+static void dynamic_call_table_grow(void) {
+  uint32_t capacity = dynamic_call.entry_capacity > 0
+    ? dynamic_call.entry_capacity * 2
+    : DYNAMIC_CALL_TABLE_INITIAL_CAPACITY;
+  dynamic_call_entry_t *entries = calloc(capacity, sizeof(dynamic_call_entry_t));
+
+  // StringNames are moved bitwise, their reference stays with the entry
+  for (uint32_t i = 0; i < dynamic_call.entry_capacity; i++) {
+    dynamic_call_entry_t *entry = &dynamic_call.entries[i];
+    if (entry->way.class_key == NULL) continue;
+    *dynamic_call_table_slot(entries, capacity, entry->way.class_key, entry->way.method_key) = *entry;
+  }
+
+  free(dynamic_call.entries);
+  dynamic_call.entries = entries;
+  dynamic_call.entry_capacity = capacity;
+}
+
+// `ClassDB.get_parent_class(p_class)` into `r_parent`, which is empty for
+// `Object`. Only used on a miss, so going through a Variant call is fine.
+static void dynamic_call_get_parent_class(GDExtensionConstStringNamePtr p_class, GDExtensionUninitializedStringNamePtr r_parent) {
+  uint8_t class_db_name[DYNAMIC_CALL_STRING_NAME_SIZE];
+  uint8_t method_name[DYNAMIC_CALL_STRING_NAME_SIZE];
+  uint8_t class_db[DYNAMIC_CALL_VARIANT_SIZE];
+  uint8_t arg[DYNAMIC_CALL_VARIANT_SIZE];
+  uint8_t ret[DYNAMIC_CALL_VARIANT_SIZE];
+
+  dynamic_call.interface.string_name_new_with_utf8_chars(class_db_name, "ClassDB");
+  dynamic_call.interface.string_name_new_with_utf8_chars(method_name, "get_parent_class");
+  GDExtensionObjectPtr class_db_object = dynamic_call.interface.global_get_singleton(class_db_name);
+  dynamic_call.object_to_variant(class_db, &class_db_object);
+  dynamic_call.string_name_to_variant(arg, (GDExtensionTypePtr)p_class);
+
+  const GDExtensionConstVariantPtr args[1] = { arg };
+  GDExtensionCallError error;
+  dynamic_call.interface.variant_call(class_db, method_name, args, 1, ret, &error);
+  if (error.error == GDEXTENSION_CALL_OK) {
+    dynamic_call.variant_to_string_name(r_parent, ret);
+  } else {
+    dynamic_call.interface.string_name_new_with_utf8_chars(r_parent, "");
+  }
+
+  dynamic_call.interface.variant_destroy(ret);
+  dynamic_call.interface.variant_destroy(arg);
+  dynamic_call.interface.variant_destroy(class_db);
+  dynamic_call.string_name_destructor(method_name);
+  dynamic_call.string_name_destructor(class_db_name);
+}
+
+static GDExtensionMethodBindPtr dynamic_call_resolve(GDExtensionConstStringNamePtr p_class, GDExtensionConstStringNamePtr p_method) {
+  void *method_key = dynamic_call_key(p_method);
+  uint8_t class_name[DYNAMIC_CALL_STRING_NAME_SIZE];
+  GDExtensionMethodBindPtr res = NULL;
+
+  dynamic_call_copy_string_name(class_name, p_class);
+  for (int depth = 0; depth < DYNAMIC_CALL_MAX_CLASS_DEPTH && dynamic_call_key(class_name) != NULL; depth++) {
+    const dynamic_call_known_t *known = dynamic_call_find_known(dynamic_call_key(class_name), method_key);
+    if (known != NULL) {
+      res = dynamic_call.interface.classdb_get_method_bind(class_name, p_method, known->hash);
+      break;
+    }
+
+    uint8_t parent[DYNAMIC_CALL_STRING_NAME_SIZE];
+    dynamic_call_get_parent_class(class_name, parent);
+    dynamic_call.string_name_destructor(class_name);
+    memcpy(class_name, parent, sizeof(class_name));
+  }
+  dynamic_call.string_name_destructor(class_name);
+  return res;
+}
+
+static dynamic_call_entry_t *dynamic_call_table_insert(GDExtensionConstStringNamePtr p_class, GDExtensionConstStringNamePtr p_method) {
+  if ((dynamic_call.entry_count + 1) * 2 > dynamic_call.entry_capacity) {
+    dynamic_call_table_grow();
+  }
+
+  void *class_key = dynamic_call_key(p_class);
+  void *method_key = dynamic_call_key(p_method);
+  GDExtensionMethodBindPtr bind = dynamic_call_resolve(p_class, p_method);
+
+  dynamic_call_entry_t *entry = dynamic_call_table_slot(dynamic_call.entries, dynamic_call.entry_capacity, class_key, method_key);
+  dynamic_call_copy_string_name(entry->class_name, p_class);
+  dynamic_call_copy_string_name(entry->method_name, p_method);
+  entry->way = (dynamic_call_way_t){
+    .class_key = class_key,
+    .method_key = method_key,
+    .bind = bind,
+  };
+  dynamic_call.entry_count++;
+  return entry;
+}
+
+static GDExtensionMethodBindPtr
+dynamic_call_lookup(
+  dynamic_call_site_t *site,
+  GDExtensionConstStringNamePtr p_class,
+  GDExtensionConstStringNamePtr p_method
+) {
+  void *class_key = dynamic_call_key(p_class);
+  void *method_key = dynamic_call_key(p_method);
+
+  for (uint32_t i = 0; i < site->count; i++) {
+    if (site->ways[i].class_key == class_key && site->ways[i].method_key == method_key) {
+      dynamic_call.stats.site_hits++;
+      return site->ways[i].bind;
+    }
+  }
+
+  dynamic_call_entry_t *entry = dynamic_call_table_find(class_key, method_key);
+  if (entry != NULL) {
+    dynamic_call.stats.table_hits++;
+  } else {
+    dynamic_call.stats.misses++;
+    entry = dynamic_call_table_insert(p_class, p_method);
+  }
+
+  if (site->count < DYNAMIC_CALL_SITE_WAYS) {
+    site->ways[site->count++] = entry->way;
+  } else {
+    dynamic_call.stats.megamorphic++;
+  }
+  return entry->way.bind;
+}
+
+// Calls `p_method` on `p_object` like `Object.call` would. `r_ret` is
+// uninitialized and always gets constructed, errors are reported in
+// `r_error`.
+static void
+dynamic_call_at(
+  dynamic_call_site_t *site,
+  GDExtensionObjectPtr p_object,
+  GDExtensionConstStringNamePtr p_method,
+  const GDExtensionConstVariantPtr *p_args,
+  GDExtensionInt p_argument_count,
+  GDExtensionUninitializedVariantPtr r_ret,
+  GDExtensionCallError *r_error
+) {
+  uint8_t class_name[DYNAMIC_CALL_STRING_NAME_SIZE];
+  dynamic_call.interface.object_get_class_name(p_object, dynamic_call.library, class_name);
+  GDExtensionMethodBindPtr bind = dynamic_call_lookup(site, class_name, p_method);
+  dynamic_call.string_name_destructor(class_name);
+
+  if (bind != NULL) {
+    dynamic_call.interface.object_method_bind_call(bind, p_object, p_args, p_argument_count, r_ret, r_error);
+    return;
+  }
+
+  uint8_t self[DYNAMIC_CALL_VARIANT_SIZE];
+  dynamic_call.object_to_variant(self, &p_object);
+  dynamic_call.interface.variant_call(self, p_method, p_args, p_argument_count, r_ret, r_error);
+  dynamic_call.interface.variant_destroy(self);
+  dynamic_call.stats.fallback_calls++;
+}
+
+#define DYNAMIC_CALL(p_object, p_method, p_args, p_argument_count, r_ret, r_error) do {          \
+    static dynamic_call_site_t dynamic_call_site_;                                                \
+    dynamic_call_at(&dynamic_call_site_, (p_object), (p_method), (p_args), (p_argument_count),   \
+                    (r_ret), (r_error));                                                          \
+  } while (0)
+
+static void dynamic_call_print_stats(void) {
+  const dynamic_call_stats_t *stats = &dynamic_call.stats;
+  printf("dynamic calls: %lu site hits, %lu table hits, %lu misses, %lu megamorphic, %lu through variant_call, %u pairs cached\n",
+         (unsigned long)stats->site_hits,
+         (unsigned long)stats->table_hits,
+         (unsigned long)stats->misses,
+         (unsigned long)stats->megamorphic,
+         (unsigned long)stats->fallback_calls,
+         dynamic_call.entry_count);
+}
+
+// Sites remember binds on their own and don't know about this, so only call it
+// when the library is about to go away.
+static void dynamic_call_deinit(void) {
+  for (uint32_t i = 0; i < dynamic_call.entry_capacity; i++) {
+    dynamic_call_entry_t *entry = &dynamic_call.entries[i];
+    if (entry->way.class_key == NULL) continue;
+    dynamic_call.string_name_destructor(entry->class_name);
+    dynamic_call.string_name_destructor(entry->method_name);
+  }
+  for (uint32_t i = 0; i < dynamic_call.known_count; i++) {
+    dynamic_call.string_name_destructor(dynamic_call.known[i].class_name);
+    dynamic_call.string_name_destructor(dynamic_call.known[i].method_name);
+  }
+  free(dynamic_call.entries);
+  free(dynamic_call.known);
+  dynamic_call.entries = NULL;
+  dynamic_call.known = NULL;
+  dynamic_call.entry_count = dynamic_call.entry_capacity = 0;
+  dynamic_call.known_count = dynamic_call.known_capacity = 0;
+}
+
+#endif
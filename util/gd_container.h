@@ -0,0 +1,389 @@
+#ifndef GD_CONTAINER_H
+#define GD_CONTAINER_H
+
+// Reading Arrays and Dictionaries in place, without boxing every access
+// through `variant_call`.
+//
+// - `gd_array_view` gets a pointer to an Array's Variants with one
+//   `array_operator_index_const` call. Elements are read straight from
+//   Godot's buffer, and `gd_array_view_get_float` and friends unwrap them
+//   with the conversions of `variant_unwrap.h`, so an int in a float column
+//   is fine. `gd_array_view_to_floats` and `gd_array_view_to_ints` convert a
+//   whole Array in one go.
+// - `gd_dictionary_get` returns a pointer to a Dictionary's value, or NULL
+//   when the key isn't there.
+// - For the same keys over and over (config, spawn tables), make the keys
+//   once with `gd_dictionary_key_new` and index the Dictionary once with
+//   `gd_dictionary_lookup_build`. Lookups are then a hash and a probe in our
+//   own table, with no interface calls at all.
+//
+// Usage:
+//
+//   gd_container_init(p_get_proc_address); // in godot_entry
+//   gd_dictionary_key_t speed_key;
+//   gd_dictionary_key_new(&speed_key, "speed");
+//   ...
+//   gd_dictionary_lookup_t config;
+//   if (gd_dictionary_lookup_build(&config, p_dictionary)) {
+//     double speed;
+//     if (gd_dictionary_lookup_get_float(&config, &speed_key, &speed)) { ... }
+//     gd_dictionary_lookup_destroy(&config);
+//   }
+//   ...
+//   gd_dictionary_key_destroy(&speed_key); // on deinitialization
+//
+// NOTE: A view, and every pointer returned here, points into the container.
+// An Array view is only valid until the Array is resized or destroyed. A
+// value pointer is only valid until its key is erased. Godot allocates each
+// Dictionary entry on its own, so inserting other keys doesn't move it.
+//
+// NOTE: The lookup only indexes String and StringName keys, that's what
+// configs use. Other keys still work with `gd_dictionary_get`. Keys added
+// after `gd_dictionary_lookup_build` are not in the lookup.
+//
+// NOTE: `gd_container_init` also calls `variant_unwrap_init`.
+
+#include "../godot-headers/gdextension_interface.h"
+#include "builtin_sizes.h"
+#include "variant_unwrap.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Builtin method hashes from `extension_api.json`
+#define GD_CONTAINER_SIZE_HASH (3173160232)
+#define GD_CONTAINER_DICTIONARY_HAS_HASH (3680194679)
+#define GD_CONTAINER_DICTIONARY_KEYS_HASH (4144163970)
+
+// Builtin constructor indices from `extension_api.json`
+#define GD_CONTAINER_DEFAULT_CONSTRUCTOR (0)
+#define GD_CONTAINER_COPY_CONSTRUCTOR (1)
+
+static struct {
+  struct {
+    GDExtensionInterfaceArrayOperatorIndex array_operator_index;
+    GDExtensionInterfaceArrayOperatorIndexConst array_operator_index_const;
+    GDExtensionInterfaceDictionaryOperatorIndexConst dictionary_operator_index_const;
+    GDExtensionInterfaceVariantGetType variant_get_type;
+    GDExtensionInterfaceVariantDestroy variant_destroy;
+    GDExtensionInterfaceVariantGetPtrBuiltinMethod variant_get_ptr_builtin_method;
+    GDExtensionInterfaceVariantGetPtrConstructor variant_get_ptr_constructor;
+    GDExtensionInterfaceVariantGetPtrDestructor variant_get_ptr_destructor;
+    GDExtensionInterfaceGetVariantFromTypeConstructor get_variant_from_type_constructor;
+    GDExtensionInterfaceStringNameNewWithUtf8Chars string_name_new_with_utf8_chars;
+    GDExtensionInterfaceStringNewWithUtf8CharsAndLen string_new_with_utf8_chars_and_len;
+    GDExtensionInterfaceStringToUtf32Chars string_to_utf32_chars;
+    GDExtensionInterfaceStringOperatorIndexConst string_operator_index_const;
+  } interface;
+
+  GDExtensionPtrBuiltInMethod array_size;
+  GDExtensionPtrBuiltInMethod dictionary_size;
+  GDExtensionPtrBuiltInMethod dictionary_has;
+  GDExtensionPtrBuiltInMethod dictionary_keys;
+  GDExtensionPtrConstructor array_constructor;
+  GDExtensionPtrConstructor dictionary_copy_constructor;
+  GDExtensionPtrDestructor array_destructor;
+  GDExtensionPtrDestructor dictionary_destructor;
+  GDExtensionPtrDestructor string_destructor;
+  GDExtensionVariantFromTypeConstructorFunc string_to_variant;
+} gd_container;
+
+#define GD_CONTAINER_STORE_INTERFACE(name) \
+  gd_container.interface.name = (void *)p_get_proc_address(#name);
+
+static GDExtensionPtrBuiltInMethod
+gd_container_builtin_method(GDExtensionVariantType p_type, const char *p_name, GDExtensionInt p_hash) {
+  uint8_t name[GD_BUILTIN_SIZE_STRING_NAME];
+  gd_container.interface.string_name_new_with_utf8_chars(name, p_name);
+  GDExtensionPtrBuiltInMethod res = gd_container.interface.variant_get_ptr_builtin_method(p_type, name, p_hash);
+  gd_container.interface.variant_get_ptr_destructor(GDEXTENSION_VARIANT_TYPE_STRING_NAME)(name);
+  return res;
+}
+
+static void gd_container_init(GDExtensionInterfaceGetProcAddress p_get_proc_address) {
+  GD_CONTAINER_STORE_INTERFACE(array_operator_index);
+  GD_CONTAINER_STORE_INTERFACE(array_operator_index_const);
+  GD_CONTAINER_STORE_INTERFACE(dictionary_operator_index_const);
+  GD_CONTAINER_STORE_INTERFACE(variant_get_type);
+  GD_CONTAINER_STORE_INTERFACE(variant_destroy);
+  GD_CONTAINER_STORE_INTERFACE(variant_get_ptr_builtin_method);
+  GD_CONTAINER_STORE_INTERFACE(variant_get_ptr_constructor);
+  GD_CONTAINER_STORE_INTERFACE(variant_get_ptr_destructor);
+  GD_CONTAINER_STORE_INTERFACE(get_variant_from_type_constructor);
+  GD_CONTAINER_STORE_INTERFACE(string_name_new_with_utf8_chars);
+  GD_CONTAINER_STORE_INTERFACE(string_new_with_utf8_chars_and_len);
+  GD_CONTAINER_STORE_INTERFACE(string_to_utf32_chars);
+  GD_CONTAINER_STORE_INTERFACE(string_operator_index_const);
+
+  gd_container.array_size
+    = gd_container_builtin_method(GDEXTENSION_VARIANT_TYPE_ARRAY, "size", GD_CONTAINER_SIZE_HASH);
+  gd_container.dictionary_size
+    = gd_container_builtin_method(GDEXTENSION_VARIANT_TYPE_DICTIONARY, "size", GD_CONTAINER_SIZE_HASH);
+  gd_container.dictionary_has
+    = gd_container_builtin_method(GDEXTENSION_VARIANT_TYPE_DICTIONARY, "has", GD_CONTAINER_DICTIONARY_HAS_HASH);
+  gd_container.dictionary_keys
+    = gd_container_builtin_method(GDEXTENSION_VARIANT_TYPE_DICTIONARY, "keys", GD_CONTAINER_DICTIONARY_KEYS_HASH);
+
+  gd_container.array_constructor
+    = gd_container.interface.variant_get_ptr_constructor(GDEXTENSION_VARIANT_TYPE_ARRAY, GD_CONTAINER_DEFAULT_CONSTRUCTOR);
+  gd_container.dictionary_copy_constructor
+    = gd_container.interface.variant_get_ptr_constructor(GDEXTENSION_VARIANT_TYPE_DICTIONARY, GD_CONTAINER_COPY_CONSTRUCTOR);
+  gd_container.array_destructor
+    = gd_container.interface.variant_get_ptr_destructor(GDEXTENSION_VARIANT_TYPE_ARRAY);
+  gd_container.dictionary_destructor
+    = gd_container.interface.variant_get_ptr_destructor(GDEXTENSION_VARIANT_TYPE_DICTIONARY);
+  gd_container.string_destructor
+    = gd_container.interface.variant_get_ptr_destructor(GDEXTENSION_VARIANT_TYPE_STRING);
+  gd_container.string_to_variant
+    = gd_container.interface.get_variant_from_type_constructor(GDEXTENSION_VARIANT_TYPE_STRING);
+
+  variant_unwrap_init(p_get_proc_address);
+}
+
+// ---------------------------------------------------------------------------
+// Array
+// ---------------------------------------------------------------------------
+
+static inline int64_t gd_array_size(GDExtensionConstTypePtr p_array) {
+  GDExtensionInt res;
+  gd_container.array_size((void *)p_array, NULL, &res, 0);
+  return res;
+}
+
+// NULL when `p_index` is out of range. The Variant can be changed in place.
+static inline GDExtensionVariantPtr gd_array_at(GDExtensionTypePtr p_array, int64_t p_index) {
+  return gd_container.interface.array_operator_index(p_array, p_index);
+}
+
+// An Array keeps its Variants in one buffer, `data` points at the first one
+typedef struct {
+  const uint8_t *data;
+  int64_t size;
+} gd_array_view_t;
+
+static inline gd_array_view_t gd_array_view(GDExtensionConstTypePtr p_array) {
+  gd_array_view_t res = { .data = NULL, .size = 0 };
+  int64_t size = gd_array_size(p_array);
+  if (size > 0) {
+    res.data = gd_container.interface.array_operator_index_const(p_array, 0);
+    res.size = size;
+  }
+  return res;
+}
+
+static inline GDExtensionConstVariantPtr gd_array_view_at(gd_array_view_t view, int64_t p_index) {
+  if (p_index < 0 || p_index >= view.size) return NULL;
+  return view.data + p_index * GD_BUILTIN_SIZE_VARIANT;
+}
+
+#define GD_ARRAY_VIEW_FOREACH(view, element)                                                         \
+  for (int64_t element##_index_ = 0; element##_index_ < (view).size; element##_index_++)             \
+    for (GDExtensionConstVariantPtr element = (view).data + element##_index_ * GD_BUILTIN_SIZE_VARIANT, \
+         element##_once_ = element;                                                                  \
+         element##_once_ != NULL; element##_once_ = NULL)
+
+// The typed getters return false when the element is out of range or
+// doesn't convert, and leave `r_value` alone then
+static inline bool gd_array_view_get_float(gd_array_view_t view, int64_t p_index, double *r_value) {
+  GDExtensionConstVariantPtr element = gd_array_view_at(view, p_index);
+  return element != NULL && variant_unwrap_float(element, r_value);
+}
+
+static inline bool gd_array_view_get_int(gd_array_view_t view, int64_t p_index, GDExtensionInt *r_value) {
+  GDExtensionConstVariantPtr element = gd_array_view_at(view, p_index);
+  return element != NULL && variant_unwrap_int(element, r_value);
+}
+
+static inline bool gd_array_view_get_bool(gd_array_view_t view, int64_t p_index, GDExtensionBool *r_value) {
+  GDExtensionConstVariantPtr element = gd_array_view_at(view, p_index);
+  return element != NULL && variant_unwrap_bool(element, r_value);
+}
+
+static inline bool
+gd_array_view_get_as(gd_array_view_t view, int64_t p_index, GDExtensionVariantType p_type, GDExtensionUninitializedTypePtr r_value) {
+  GDExtensionConstVariantPtr element = gd_array_view_at(view, p_index);
+  return element != NULL && variant_unwrap_as(p_type, element, r_value);
+}
+
+// Fills `r_values` (room for `view.size`) and returns the number of elements
+// converted. Stops at the first element that doesn't convert.
+static inline int64_t gd_array_view_to_floats(gd_array_view_t view, double *r_values) {
+  int64_t i = 0;
+  for (; i < view.size; i++) {
+    if (!variant_unwrap_float(view.data + i * GD_BUILTIN_SIZE_VARIANT, &r_values[i])) break;
+  }
+  return i;
+}
+
+static inline int64_t gd_array_view_to_ints(gd_array_view_t view, GDExtensionInt *r_values) {
+  int64_t i = 0;
+  for (; i < view.size; i++) {
+    if (!variant_unwrap_int(view.data + i * GD_BUILTIN_SIZE_VARIANT, &r_values[i])) break;
+  }
+  return i;
+}
+
+// ---------------------------------------------------------------------------
+// Dictionary
+// ---------------------------------------------------------------------------
+
+static inline int64_t gd_dictionary_size(GDExtensionConstTypePtr p_dictionary) {
+  GDExtensionInt res;
+  gd_container.dictionary_size((void *)p_dictionary, NULL, &res, 0);
+  return res;
+}
+
+// NULL when the key isn't there. `dictionary_operator_index_const` alone
+// can't be used for that: Godot fails hard on a missing key.
+static inline GDExtensionConstVariantPtr
+gd_dictionary_get(GDExtensionConstTypePtr p_dictionary, GDExtensionConstVariantPtr p_key) {
+  GDExtensionBool has;
+  GDExtensionConstTypePtr args[] = { p_key };
+  gd_container.dictionary_has((void *)p_dictionary, args, &has, 1);
+  if (!has) return NULL;
+  return gd_container.interface.dictionary_operator_index_const(p_dictionary, p_key);
+}
+
+// A key made once, with its hash, for `gd_dictionary_lookup_get`. `variant`
+// is the key as a String Variant, for `gd_dictionary_get`.
+typedef struct {
+  _Alignas(GD_BUILTIN_ALIGN_VARIANT) uint8_t variant[GD_BUILTIN_SIZE_VARIANT];
+  uint8_t string[GD_BUILTIN_SIZE_STRING];
+  const char32_t *data;
+  int64_t length;
+  uint32_t hash;
+} gd_dictionary_key_t;
+
+// FNV-1a over the code points
+static inline uint32_t gd_dictionary_hash(const char32_t *p_data, int64_t p_length) {
+  uint32_t res = 2166136261u;
+  for (int64_t i = 0; i < p_length; i++) {
+    res = (res ^ p_data[i]) * 16777619u;
+  }
+  return res;
+}
+
+// Points `r_data` and `r_length` at the String's code points
+static inline void gd_dictionary_string_view(GDExtensionConstStringPtr p_string, const char32_t **r_data, int64_t *r_length) {
+  *r_length = gd_container.interface.string_to_utf32_chars(p_string, NULL, 0);
+  *r_data = *r_length > 0 ? gd_container.interface.string_operator_index_const(p_string, 0) : NULL;
+}
+
+static inline void gd_dictionary_key_new(gd_dictionary_key_t *r_key, const char *p_utf8) {
+  gd_container.interface.string_new_with_utf8_chars_and_len(r_key->string, p_utf8, strlen(p_utf8));
+  gd_container.string_to_variant(r_key->variant, r_key->string);
+  gd_dictionary_string_view(r_key->string, &r_key->data, &r_key->length);
+  r_key->hash = gd_dictionary_hash(r_key->data, r_key->length);
+}
+
+static inline void gd_dictionary_key_destroy(gd_dictionary_key_t *p_key) {
+  gd_container.interface.variant_destroy(p_key->variant);
+  gd_container.string_destructor(p_key->string);
+}
+
+// An empty slot has no value
+typedef struct {
+  uint8_t key[GD_BUILTIN_SIZE_STRING];
+  const char32_t *data;
+  int64_t length;
+  uint32_t hash;
+  GDExtensionConstVariantPtr value;
+} gd_dictionary_slot_t;
+
+// Our own open addressing table over a Dictionary's String keys. It holds a
+// reference to the Dictionary, so the values stay alive as long as it does.
+typedef struct {
+  uint8_t dictionary[GD_BUILTIN_SIZE_DICTIONARY];
+  gd_dictionary_slot_t *slots;
+  uint32_t mask;
+  int64_t count;
+} gd_dictionary_lookup_t;
+
+// Returns false if the table can't be allocated, the lookup must not be used
+// or destroyed then
+static inline bool gd_dictionary_lookup_build(gd_dictionary_lookup_t *r_lookup, GDExtensionConstTypePtr p_dictionary) {
+  GDExtensionConstTypePtr copy_args[] = { p_dictionary };
+  gd_container.dictionary_copy_constructor(r_lookup->dictionary, copy_args);
+
+  uint8_t keys[GD_BUILTIN_SIZE_ARRAY];
+  gd_container.array_constructor(keys, NULL);
+  gd_container.dictionary_keys(r_lookup->dictionary, NULL, keys, 0);
+  gd_array_view_t view = gd_array_view(keys);
+
+  // At most half full, so probes stay short
+  uint32_t capacity = 8;
+  while (capacity < view.size * 2) capacity *= 2;
+  r_lookup->slots = calloc(capacity, sizeof(gd_dictionary_slot_t));
+  if (r_lookup->slots == NULL) {
+    gd_container.array_destructor(keys);
+    gd_container.dictionary_destructor(r_lookup->dictionary);
+    return false;
+  }
+  r_lookup->mask = capacity - 1;
+  r_lookup->count = 0;
+
+  GD_ARRAY_VIEW_FOREACH(view, key) {
+    GDExtensionVariantType type = gd_container.interface.variant_get_type(key);
+    if (type != GDEXTENSION_VARIANT_TYPE_STRING && type != GDEXTENSION_VARIANT_TYPE_STRING_NAME) continue;
+
+    gd_dictionary_slot_t slot;
+    variant_unwrap_as(GDEXTENSION_VARIANT_TYPE_STRING, key, slot.key);
+    gd_dictionary_string_view(slot.key, &slot.data, &slot.length);
+    slot.hash = gd_dictionary_hash(slot.data, slot.length);
+    slot.value = gd_container.interface.dictionary_operator_index_const(r_lookup->dictionary, key);
+
+    uint32_t i = slot.hash & r_lookup->mask;
+    while (r_lookup->slots[i].value != NULL) i = (i + 1) & r_lookup->mask;
+    r_lookup->slots[i] = slot;
+    r_lookup->count++;
+  }
+
+  gd_container.array_destructor(keys);
+  return true;
+}
+
+// NULL when the key isn't there
+static inline GDExtensionConstVariantPtr
+gd_dictionary_lookup_get(const gd_dictionary_lookup_t *p_lookup, const gd_dictionary_key_t *p_key) {
+  uint32_t i = p_key->hash & p_lookup->mask;
+  for (;;) {
+    const gd_dictionary_slot_t *slot = &p_lookup->slots[i];
+    if (slot->value == NULL) return NULL;
+    if (slot->hash == p_key->hash && slot->length == p_key->length
+        && memcmp(slot->data, p_key->data, p_key->length * sizeof(char32_t)) == 0) {
+      return slot->value;
+    }
+    i = (i + 1) & p_lookup->mask;
+  }
+}
+
+static inline bool
+gd_dictionary_lookup_get_float(const gd_dictionary_lookup_t *p_lookup, const gd_dictionary_key_t *p_key, double *r_value) {
+  GDExtensionConstVariantPtr value = gd_dictionary_lookup_get(p_lookup, p_key);
+  return value != NULL && variant_unwrap_float(value, r_value);
+}
+
+static inline bool
+gd_dictionary_lookup_get_int(const gd_dictionary_lookup_t *p_lookup, const gd_dictionary_key_t *p_key, GDExtensionInt *r_value) {
+  GDExtensionConstVariantPtr value = gd_dictionary_lookup_get(p_lookup, p_key);
+  return value != NULL && variant_unwrap_int(value, r_value);
+}
+
+static inline bool
+gd_dictionary_lookup_get_bool(const gd_dictionary_lookup_t *p_lookup, const gd_dictionary_key_t *p_key, GDExtensionBool *r_value) {
+  GDExtensionConstVariantPtr value = gd_dictionary_lookup_get(p_lookup, p_key);
+  return value != NULL && variant_unwrap_bool(value, r_value);
+}
+
+static inline void gd_dictionary_lookup_destroy(gd_dictionary_lookup_t *p_lookup) {
+  for (uint32_t i = 0; i <= p_lookup->mask; i++) {
+    if (p_lookup->slots[i].value != NULL) gd_container.string_destructor(p_lookup->slots[i].key);
+  }
+  free(p_lookup->slots);
+  p_lookup->slots = NULL;
+  gd_container.dictionary_destructor(p_lookup->dictionary);
+}
+
+#endif
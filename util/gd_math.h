@@ -0,0 +1,944 @@
+#ifndef GD_MATH_H
+#define GD_MATH_H
+
+// Batch math on arrays of Godot's math types, without calling into Godot.
+//
+// The structs have Godot's memory layout (`real_t` is float, or double with
+// large world coordinates), so arrays can be filled from and copied into
+// Packed*Arrays or the members of builtin types as they are. Every function
+// takes a source, a destination (which may be the source) and a count:
+//
+// - Transform2D * Vector2, Transform3D * Vector3, Basis * Vector3
+// - normalization of Vector2/3/4 and Quaternion
+// - lerp of Vector2/3/4, slerp of Quaternion
+// - merging an array of AABBs into one
+//
+// Each operation does the same arithmetic in the same order as Godot's own
+// math (`core/math`), so results match up to rounding and usually exactly.
+//
+// Usage:
+//
+//   gd_math_init(); // in godot_entry, picks the best kernels for the CPU
+//   gd_math_transform3d_xform_vector3(&transform, points, points, count);
+//
+// On x86 there are SSE2 and AVX kernels, picked at runtime with
+// `__builtin_cpu_supports`. Everything else, slerp (it's all trigonometry)
+// and other CPUs use the scalar kernels. Before `gd_math_init` the scalar
+// kernels are used too. `gd_math_set_level` switches kernels by hand, for
+// benchmarks.
+//
+// NOTE: Define IS_GODOT_USING_LARGE_WORLD_COORDINATES before including this
+// header, the same as for `builtin_sizes.h`.
+//
+// NOTE: No FMA. A fused multiply-add rounds once instead of twice, and
+// Godot's official builds don't use it.
+
+#include "builtin_sizes.h"
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define GD_MATH_X86 (1)
+#include <immintrin.h>
+#define GD_MATH_TARGET_SSE2 __attribute__((target("sse2")))
+#define GD_MATH_TARGET_AVX __attribute__((target("avx")))
+#else
+#define GD_MATH_X86 (0)
+#endif
+
+#if (IS_GODOT_USING_LARGE_WORLD_COORDINATES)
+typedef double gd_real_t;
+#define GD_MATH_SQRT(x) sqrt(x)
+#define GD_MATH_SIN(x) sin(x)
+#define GD_MATH_ACOS(x) acos(x)
+#else
+typedef float gd_real_t;
+#define GD_MATH_SQRT(x) sqrtf(x)
+#define GD_MATH_SIN(x) sinf(x)
+#define GD_MATH_ACOS(x) acosf(x)
+#endif
+
+// Godot's CMP_EPSILON
+#define GD_MATH_CMP_EPSILON (0.00001)
+
+typedef struct {
+  gd_real_t x;
+  gd_real_t y;
+} gd_math_vector2_t;
+
+typedef struct {
+  gd_real_t x;
+  gd_real_t y;
+  gd_real_t z;
+} gd_math_vector3_t;
+
+typedef struct {
+  gd_real_t x;
+  gd_real_t y;
+  gd_real_t z;
+  gd_real_t w;
+} gd_math_vector4_t;
+
+typedef struct {
+  gd_real_t x;
+  gd_real_t y;
+  gd_real_t z;
+  gd_real_t w;
+} gd_math_quaternion_t;
+
+// Row-major like Godot: `rows[0]` is (xx, xy, xz)
+typedef struct {
+  gd_math_vector3_t rows[3];
+} gd_math_basis_t;
+
+typedef struct {
+  gd_math_basis_t basis;
+  gd_math_vector3_t origin;
+} gd_math_transform3d_t;
+
+// Column-major like Godot: x axis, y axis, origin
+typedef struct {
+  gd_math_vector2_t columns[3];
+} gd_math_transform2d_t;
+
+typedef struct {
+  gd_math_vector3_t position;
+  gd_math_vector3_t size;
+} gd_math_aabb_t;
+
+_Static_assert(sizeof(gd_math_vector2_t) == GD_BUILTIN_SIZE_VECTOR2, "Vector2 layout");
+_Static_assert(sizeof(gd_math_vector3_t) == GD_BUILTIN_SIZE_VECTOR3, "Vector3 layout");
+_Static_assert(sizeof(gd_math_vector4_t) == GD_BUILTIN_SIZE_VECTOR4, "Vector4 layout");
+_Static_assert(sizeof(gd_math_quaternion_t) == GD_BUILTIN_SIZE_QUATERNION, "Quaternion layout");
+_Static_assert(sizeof(gd_math_basis_t) == GD_BUILTIN_SIZE_BASIS, "Basis layout");
+_Static_assert(sizeof(gd_math_transform3d_t) == GD_BUILTIN_SIZE_TRANSFORM3D, "Transform3D layout");
+_Static_assert(sizeof(gd_math_transform2d_t) == GD_BUILTIN_SIZE_TRANSFORM2D, "Transform2D layout");
+_Static_assert(sizeof(gd_math_aabb_t) == GD_BUILTIN_SIZE_AABB, "AABB layout");
+
+typedef enum {
+  GD_MATH_LEVEL_SCALAR,
+  GD_MATH_LEVEL_SSE2,
+  GD_MATH_LEVEL_AVX,
+  GD_MATH_LEVEL_MAX,
+} gd_math_level_t;
+
+static const char *const gd_math_level_names[GD_MATH_LEVEL_MAX] = { "scalar", "sse2", "avx" };
+
+// Kernels work on flat arrays of reals, `p_count` is the number of elements
+// (vectors, boxes) and not of reals
+typedef struct {
+  void (*xform2)(const gd_real_t *p_columns, const gd_real_t *p_src, gd_real_t *r_dst, int64_t p_count);
+  // `p_origin` is NULL for a Basis
+  void (*xform3)(const gd_real_t *p_rows, const gd_real_t *p_origin, const gd_real_t *p_src, gd_real_t *r_dst, int64_t p_count);
+  void (*normalize2)(const gd_real_t *p_src, gd_real_t *r_dst, int64_t p_count);
+  void (*normalize3)(const gd_real_t *p_src, gd_real_t *r_dst, int64_t p_count);
+  // Quaternions multiply by 1/length and don't check for zero, vectors
+  // divide by the length and turn zero into zero
+  void (*normalize4)(const gd_real_t *p_src, gd_real_t *r_dst, int64_t p_count, bool p_quaternion);
+  // Here `p_count` is the number of reals
+  void (*lerp)(const gd_real_t *p_from, const gd_real_t *p_to, gd_real_t p_weight, gd_real_t *r_dst, int64_t p_count);
+  void (*aabb_merge)(const gd_real_t *p_boxes, int64_t p_count, gd_real_t *r_begin, gd_real_t *r_end);
+} gd_math_kernels_t;
+
+// ---------------------------------------------------------------------------
+// Scalar kernels, the reference for the others
+// ---------------------------------------------------------------------------
+
+static void gd_math_xform2_scalar(const gd_real_t *p_columns, const gd_real_t *p_src, gd_real_t *r_dst, int64_t p_count) {
+  const gd_real_t *c = p_columns;
+  for (int64_t i = 0; i < p_count; i++) {
+    gd_real_t x = p_src[2 * i];
+    gd_real_t y = p_src[2 * i + 1];
+    r_dst[2 * i] = (c[0] * x + c[2] * y) + c[4];
+    r_dst[2 * i + 1] = (c[1] * x + c[3] * y) + c[5];
+  }
+}
+
+static void gd_math_xform3_scalar(const gd_real_t *p_rows, const gd_real_t *p_origin, const gd_real_t *p_src, gd_real_t *r_dst, int64_t p_count) {
+  const gd_real_t *r = p_rows;
+  for (int64_t i = 0; i < p_count; i++) {
+    gd_real_t x = p_src[3 * i];
+    gd_real_t y = p_src[3 * i + 1];
+    gd_real_t z = p_src[3 * i + 2];
+    gd_real_t rx = r[0] * x + r[1] * y + r[2] * z;
+    gd_real_t ry = r[3] * x + r[4] * y + r[5] * z;
+    gd_real_t rz = r[6] * x + r[7] * y + r[8] * z;
+    if (p_origin != NULL) {
+      rx += p_origin[0];
+      ry += p_origin[1];
+      rz += p_origin[2];
+    }
+    r_dst[3 * i] = rx;
+    r_dst[3 * i + 1] = ry;
+    r_dst[3 * i + 2] = rz;
+  }
+}
+
+static void gd_math_normalize2_scalar(const gd_real_t *p_src, gd_real_t *r_dst, int64_t p_count) {
+  for (int64_t i = 0; i < p_count; i++) {
+    gd_real_t x = p_src[2 * i];
+    gd_real_t y = p_src[2 * i + 1];
+    gd_real_t length_squared = x * x + y * y;
+    if (length_squared != 0) {
+      gd_real_t length = GD_MATH_SQRT(length_squared);
+      x /= length;
+      y /= length;
+    }
+    r_dst[2 * i] = x;
+    r_dst[2 * i + 1] = y;
+  }
+}
+
+static void gd_math_normalize3_scalar(const gd_real_t *p_src, gd_real_t *r_dst, int64_t p_count) {
+  for (int64_t i = 0; i < p_count; i++) {
+    gd_real_t x = p_src[3 * i];
+    gd_real_t y = p_src[3 * i + 1];
+    gd_real_t z = p_src[3 * i + 2];
+    gd_real_t length_squared = x * x + y * y + z * z;
+    if (length_squared == 0) {
+      x = y = z = 0;
+    } else {
+      gd_real_t length = GD_MATH_SQRT(length_squared);
+      x /= length;
+      y /= length;
+      z /= length;
+    }
+    r_dst[3 * i] = x;
+    r_dst[3 * i + 1] = y;
+    r_dst[3 * i + 2] = z;
+  }
+}
+
+static void gd_math_normalize4_scalar(const gd_real_t *p_src, gd_real_t *r_dst, int64_t p_count, bool p_quaternion) {
+  for (int64_t i = 0; i < p_count; i++) {
+    const gd_real_t *v = p_src + 4 * i;
+    gd_real_t *d = r_dst + 4 * i;
+    gd_real_t length_squared = v[0] * v[0] + v[1] * v[1] + v[2] * v[2] + v[3] * v[3];
+    if (p_quaternion) {
+      gd_real_t inverse = (gd_real_t)1 / GD_MATH_SQRT(length_squared);
+      for (int c = 0; c < 4; c++) d[c] = v[c] * inverse;
+    } else if (length_squared == 0) {
+      for (int c = 0; c < 4; c++) d[c] = 0;
+    } else {
+      gd_real_t length = GD_MATH_SQRT(length_squared);
+      for (int c = 0; c < 4; c++) d[c] = v[c] / length;
+    }
+  }
+}
+
+static void gd_math_lerp_scalar(const gd_real_t *p_from, const gd_real_t *p_to, gd_real_t p_weight, gd_real_t *r_dst, int64_t p_count) {
+  for (int64_t i = 0; i < p_count; i++) {
+    r_dst[i] = p_from[i] + (p_to[i] - p_from[i]) * p_weight;
+  }
+}
+
+static void gd_math_aabb_merge_scalar(const gd_real_t *p_boxes, int64_t p_count, gd_real_t *r_begin, gd_real_t *r_end) {
+  for (int c = 0; c < 3; c++) {
+    r_begin[c] = p_boxes[c];
+    r_end[c] = p_boxes[c] + p_boxes[3 + c];
+  }
+  for (int64_t i = 1; i < p_count; i++) {
+    const gd_real_t *box = p_boxes + 6 * i;
+    for (int c = 0; c < 3; c++) {
+      gd_real_t begin = box[c];
+      gd_real_t end = box[c] + box[3 + c];
+      if (begin < r_begin[c]) r_begin[c] = begin;
+      if (end > r_end[c]) r_end[c] = end;
+    }
+  }
+}
+
+static const gd_math_kernels_t gd_math_kernels_scalar = {
+  .xform2 = gd_math_xform2_scalar,
+  .xform3 = gd_math_xform3_scalar,
+  .normalize2 = gd_math_normalize2_scalar,
+  .normalize3 = gd_math_normalize3_scalar,
+  .normalize4 = gd_math_normalize4_scalar,
+  .lerp = gd_math_lerp_scalar,
+  .aabb_merge = gd_math_aabb_merge_scalar,
+};
+
+// ---------------------------------------------------------------------------
+// x86 kernels
+// ---------------------------------------------------------------------------
+//
+// Vectors of 3 don't fill a register, so Vector3 kernels keep one vector per
+// 128-bit lane as (x, y, z, unused) and multiply by the transform's columns.
+// That's the same sums in the same order as Godot's row dot products. Loads
+// of all inputs of an iteration come before its stores, so in-place calls
+// are fine. Leftover elements go through the scalar kernel.
+
+#if (GD_MATH_X86 && !IS_GODOT_USING_LARGE_WORLD_COORDINATES)
+
+GD_MATH_TARGET_SSE2
+static void gd_math_xform2_sse2(const gd_real_t *p_columns, const gd_real_t *p_src, gd_real_t *r_dst, int64_t p_count) {
+  const gd_real_t *c = p_columns;
+  const __m128 column_x = _mm_setr_ps(c[0], c[1], c[0], c[1]);
+  const __m128 column_y = _mm_setr_ps(c[2], c[3], c[2], c[3]);
+  const __m128 origin = _mm_setr_ps(c[4], c[5], c[4], c[5]);
+  int64_t i = 0;
+  for (; i + 2 <= p_count; i += 2) {
+    __m128 v = _mm_loadu_ps(p_src + 2 * i);
+    __m128 x = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 0, 0));
+    __m128 y = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 1, 1));
+    __m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(column_x, x), _mm_mul_ps(column_y, y)), origin);
+    _mm_storeu_ps(r_dst + 2 * i, r);
+  }
+  gd_math_xform2_scalar(p_columns, p_src + 2 * i, r_dst + 2 * i, p_count - i);
+}
+
+GD_MATH_TARGET_SSE2
+static void gd_math_xform3_sse2(const gd_real_t *p_rows, const gd_real_t *p_origin, const gd_real_t *p_src, gd_real_t *r_dst, int64_t p_count) {
+  const gd_real_t *r = p_rows;
+  const __m128 column_x = _mm_setr_ps(r[0], r[3], r[6], 0);
+  const __m128 column_y = _mm_setr_ps(r[1], r[4], r[7], 0);
+  const __m128 column_z = _mm_setr_ps(r[2], r[5], r[8], 0);
+  const bool has_origin = p_origin != NULL;
+  const __m128 origin = has_origin ? _mm_setr_ps(p_origin[0], p_origin[1], p_origin[2], 0) : _mm_setzero_ps();
+  for (int64_t i = 0; i < p_count; i++) {
+    const gd_real_t *v = p_src + 3 * i;
+    __m128 res = _mm_add_ps(_mm_add_ps(_mm_mul_ps(column_x, _mm_set1_ps(v[0])),
+                                       _mm_mul_ps(column_y, _mm_set1_ps(v[1]))),
+                            _mm_mul_ps(column_z, _mm_set1_ps(v[2])));
+    if (has_origin) res = _mm_add_ps(res, origin);
+    gd_real_t *d = r_dst + 3 * i;
+    _mm_storel_pi((__m64 *)d, res);
+    _mm_store_ss(d + 2, _mm_movehl_ps(res, res));
+  }
+}
+
+GD_MATH_TARGET_SSE2
+static void gd_math_normalize2_sse2(const gd_real_t *p_src, gd_real_t *r_dst, int64_t p_count) {
+  int64_t i = 0;
+  for (; i + 2 <= p_count; i += 2) {
+    __m128 v = _mm_loadu_ps(p_src + 2 * i);
+    __m128 squares = _mm_mul_ps(v, v);
+    __m128 length_squared = _mm_add_ps(squares, _mm_shuffle_ps(squares, squares, _MM_SHUFFLE(2, 3, 0, 1)));
+    __m128 res = _mm_div_ps(v, _mm_sqrt_ps(length_squared));
+    // Zero vectors stay as they are
+    __m128 zero = _mm_cmpeq_ps(length_squared, _mm_setzero_ps());
+    res = _mm_or_ps(_mm_and_ps(zero, v), _mm_andnot_ps(zero, res));
+    _mm_storeu_ps(r_dst + 2 * i, res);
+  }
+  gd_math_normalize2_scalar(p_src + 2 * i, r_dst + 2 * i, p_count - i);
+}
+
+GD_MATH_TARGET_SSE2
+static void gd_math_normalize3_sse2(const gd_real_t *p_src, gd_real_t *r_dst, int64_t p_count) {
+  for (int64_t i = 0; i < p_count; i++) {
+    const gd_real_t *s = p_src + 3 * i;
+    __m128 v = _mm_setr_ps(s[0], s[1], s[2], 0);
+    __m128 squares = _mm_mul_ps(v, v);
+    __m128 sum = _mm_add_ss(_mm_add_ss(squares, _mm_shuffle_ps(squares, squares, _MM_SHUFFLE(1, 1, 1, 1))),
+                            _mm_movehl_ps(squares, squares));
+    __m128 length = _mm_sqrt_ss(sum);
+    length = _mm_shuffle_ps(length, length, _MM_SHUFFLE(0, 0, 0, 0));
+    __m128 res = _mm_div_ps(v, length);
+    res = _mm_and_ps(res, _mm_cmpneq_ps(length, _mm_setzero_ps()));
+    gd_real_t *d = r_dst + 3 * i;
+    _mm_storel_pi((__m64 *)d, res);
+    _mm_store_ss(d + 2, _mm_movehl_ps(res, res));
+  }
+}
+
+GD_MATH_TARGET_SSE2
+static void gd_math_normalize4_sse2(const gd_real_t *p_src, gd_real_t *r_dst, int64_t p_count, bool p_quaternion) {
+  for (int64_t i = 0; i < p_count; i++) {
+    __m128 v = _mm_loadu_ps(p_src + 4 * i);
+    __m128 squares = _mm_mul_ps(v, v);
+    __m128 sum = _mm_add_ss(squares, _mm_shuffle_ps(squares, squares, _MM_SHUFFLE(1, 1, 1, 1)));
+    sum = _mm_add_ss(sum, _mm_movehl_ps(squares, squares));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(squares, squares, _MM_SHUFFLE(3, 3, 3, 3)));
+    __m128 length = _mm_sqrt_ss(sum);
+    __m128 res;
+    if (p_quaternion) {
+      __m128 inverse = _mm_div_ss(_mm_set_ss(1), length);
+      res = _mm_mul_ps(v, _mm_shuffle_ps(inverse, inverse, _MM_SHUFFLE(0, 0, 0, 0)));
+    } else {
+      length = _mm_shuffle_ps(length, length, _MM_SHUFFLE(0, 0, 0, 0));
+      res = _mm_div_ps(v, length);
+      res = _mm_and_ps(res, _mm_cmpneq_ps(length, _mm_setzero_ps()));
+    }
+    _mm_storeu_ps(r_dst + 4 * i, res);
+  }
+}
+
+GD_MATH_TARGET_SSE2
+static void gd_math_lerp_sse2(const gd_real_t *p_from, const gd_real_t *p_to, gd_real_t p_weight, gd_real_t *r_dst, int64_t p_count) {
+  const __m128 weight = _mm_set1_ps(p_weight);
+  int64_t i = 0;
+  for (; i + 4 <= p_count; i += 4) {
+    __m128 from = _mm_loadu_ps(p_from + i);
+    __m128 to = _mm_loadu_ps(p_to + i);
+    _mm_storeu_ps(r_dst + i, _mm_add_ps(from, _mm_mul_ps(_mm_sub_ps(to, from), weight)));
+  }
+  gd_math_lerp_scalar(p_from + i, p_to + i, p_weight, r_dst + i, p_count - i);
+}
+
+// Also the AVX kernel: it's bound by loads, wider registers don't help
+GD_MATH_TARGET_SSE2
+static void gd_math_aabb_merge_sse2(const gd_real_t *p_boxes, int64_t p_count, gd_real_t *r_begin, gd_real_t *r_end) {
+  __m128 begin = _mm_setr_ps(p_boxes[0], p_boxes[1], p_boxes[2], 0);
+  __m128 end = _mm_add_ps(begin, _mm_setr_ps(p_boxes[3], p_boxes[4], p_boxes[5], 0));
+  for (int64_t i = 1; i < p_count; i++) {
+    const gd_real_t *box = p_boxes + 6 * i;
+    // Both loads stay inside the box: (x, y, z, size.x) and (z, size.x, size.y, size.z)
+    __m128 position = _mm_loadu_ps(box);
+    __m128 size = _mm_loadu_ps(box + 2);
+    size = _mm_shuffle_ps(size, size, _MM_SHUFFLE(3, 3, 2, 1));
+    begin = _mm_min_ps(begin, position);
+    end = _mm_max_ps(end, _mm_add_ps(position, size));
+  }
+  float begin_out[4];
+  float end_out[4];
+  _mm_storeu_ps(begin_out, begin);
+  _mm_storeu_ps(end_out, end);
+  for (int c = 0; c < 3; c++) {
+    r_begin[c] = begin_out[c];
+    r_end[c] = end_out[c];
+  }
+}
+
+// Two Vector3s per register, one in each 128-bit lane
+GD_MATH_TARGET_AVX
+static inline __m256 gd_math_load_vector3_pair_avx(const gd_real_t *p_src) {
+  return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_setr_ps(p_src[0], p_src[1], p_src[2], 0)),
+                              _mm_setr_ps(p_src[3], p_src[4], p_src[5], 0),
+                              1);
+}
+
+GD_MATH_TARGET_AVX
+static inline void gd_math_store_vector3_pair_avx(gd_real_t *r_dst, __m256 p_value) {
+  __m128 low = _mm256_castps256_ps128(p_value);
+  __m128 high = _mm256_extractf128_ps(p_value, 1);
+  _mm_storel_pi((__m64 *)r_dst, low);
+  _mm_store_ss(r_dst + 2, _mm_movehl_ps(low, low));
+  _mm_storel_pi((__m64 *)(r_dst + 3), high);
+  _mm_store_ss(r_dst + 5, _mm_movehl_ps(high, high));
+}
+
+GD_MATH_TARGET_AVX
+static void gd_math_xform2_avx(const gd_real_t *p_columns, const gd_real_t *p_src, gd_real_t *r_dst, int64_t p_count) {
+  const gd_real_t *c = p_columns;
+  const __m256 column_x = _mm256_setr_ps(c[0], c[1], c[0], c[1], c[0], c[1], c[0], c[1]);
+  const __m256 column_y = _mm256_setr_ps(c[2], c[3], c[2], c[3], c[2], c[3], c[2], c[3]);
+  const __m256 origin = _mm256_setr_ps(c[4], c[5], c[4], c[5], c[4], c[5], c[4], c[5]);
+  int64_t i = 0;
+  for (; i + 4 <= p_count; i += 4) {
+    __m256 v = _mm256_loadu_ps(p_src + 2 * i);
+    __m256 x = _mm256_permute_ps(v, _MM_SHUFFLE(2, 2, 0, 0));
+    __m256 y = _mm256_permute_ps(v, _MM_SHUFFLE(3, 3, 1, 1));
+    __m256 r = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(column_x, x), _mm256_mul_ps(column_y, y)), origin);
+    _mm256_storeu_ps(r_dst + 2 * i, r);
+  }
+  gd_math_xform2_scalar(p_columns, p_src + 2 * i, r_dst + 2 * i, p_count - i);
+}
+
+GD_MATH_TARGET_AVX
+static void gd_math_xform3_avx(const gd_real_t *p_rows, const gd_real_t *p_origin, const gd_real_t *p_src, gd_real_t *r_dst, int64_t p_count) {
+  const gd_real_t *r = p_rows;
+  const __m256 column_x = _mm256_setr_ps(r[0], r[3], r[6], 0, r[0], r[3], r[6], 0);
+  const __m256 column_y = _mm256_setr_ps(r[1], r[4], r[7], 0, r[1], r[4], r[7], 0);
+  const __m256 column_z = _mm256_setr_ps(r[2], r[5], r[8], 0, r[2], r[5], r[8], 0);
+  const bool has_origin = p_origin != NULL;
+  const __m256 origin = has_origin
+    ? _mm256_setr_ps(p_origin[0], p_origin[1], p_origin[2], 0, p_origin[0], p_origin[1], p_origin[2], 0)
+    : _mm256_setzero_ps();
+  int64_t i = 0;
+  for (; i + 2 <= p_count; i += 2) {
+    __m256 v = gd_math_load_vector3_pair_avx(p_src + 3 * i);
+    __m256 x = _mm256_permute_ps(v, _MM_SHUFFLE(0, 0, 0, 0));
+    __m256 y = _mm256_permute_ps(v, _MM_SHUFFLE(1, 1, 1, 1));
+    __m256 z = _mm256_permute_ps(v, _MM_SHUFFLE(2, 2, 2, 2));
+    __m256 res = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(column_x, x), _mm256_mul_ps(column_y, y)),
+                               _mm256_mul_ps(column_z, z));
+    if (has_origin) res = _mm256_add_ps(res, origin);
+    gd_math_store_vector3_pair_avx(r_dst + 3 * i, res);
+  }
+  gd_math_xform3_scalar(p_rows, p_origin, p_src + 3 * i, r_dst + 3 * i, p_count - i);
+}
+
+// Per element the division and square root are the cost, and with AVX they
+// run on two halves on many CPUs: the SSE2 kernel is faster for Vector2
+#define gd_math_normalize2_avx gd_math_normalize2_sse2
+
+GD_MATH_TARGET_AVX
+static void gd_math_normalize3_avx(const gd_real_t *p_src, gd_real_t *r_dst, int64_t p_count) {
+  int64_t i = 0;
+  for (; i + 2 <= p_count; i += 2) {
+    __m256 v = gd_math_load_vector3_pair_avx(p_src + 3 * i);
+    __m256 squares = _mm256_mul_ps(v, v);
+    __m256 sum = _mm256_add_ps(squares, _mm256_permute_ps(squares, _MM_SHUFFLE(1, 1, 1, 1)));
+    sum = _mm256_add_ps(sum, _mm256_permute_ps(squares, _MM_SHUFFLE(2, 2, 2, 2)));
+    __m256 length_squared = _mm256_permute_ps(sum, _MM_SHUFFLE(0, 0, 0, 0));
+    __m256 res = _mm256_div_ps(v, _mm256_sqrt_ps(length_squared));
+    res = _mm256_and_ps(res, _mm256_cmp_ps(length_squared, _mm256_setzero_ps(), _CMP_NEQ_UQ));
+    gd_math_store_vector3_pair_avx(r_dst + 3 * i, res);
+  }
+  gd_math_normalize3_scalar(p_src + 3 * i, r_dst + 3 * i, p_count - i);
+}
+
+GD_MATH_TARGET_AVX
+static void gd_math_normalize4_avx(const gd_real_t *p_src, gd_real_t *r_dst, int64_t p_count, bool p_quaternion) {
+  int64_t i = 0;
+  for (; i + 2 <= p_count; i += 2) {
+    __m256 v = _mm256_loadu_ps(p_src + 4 * i);
+    __m256 squares = _mm256_mul_ps(v, v);
+    __m256 sum = _mm256_add_ps(squares, _mm256_permute_ps(squares, _MM_SHUFFLE(1, 1, 1, 1)));
+    sum = _mm256_add_ps(sum, _mm256_permute_ps(squares, _MM_SHUFFLE(2, 2, 2, 2)));
+    sum = _mm256_add_ps(sum, _mm256_permute_ps(squares, _MM_SHUFFLE(3, 3, 3, 3)));
+    __m256 length_squared = _mm256_permute_ps(sum, _MM_SHUFFLE(0, 0, 0, 0));
+    __m256 res;
+    if (p_quaternion) {
+      res = _mm256_mul_ps(v, _mm256_div_ps(_mm256_set1_ps(1), _mm256_sqrt_ps(length_squared)));
+    } else {
+      res = _mm256_div_ps(v, _mm256_sqrt_ps(length_squared));
+      res = _mm256_and_ps(res, _mm256_cmp_ps(length_squared, _mm256_setzero_ps(), _CMP_NEQ_UQ));
+    }
+    _mm256_storeu_ps(r_dst + 4 * i, res);
+  }
+  gd_math_normalize4_scalar(p_src + 4 * i, r_dst + 4 * i, p_count - i, p_quaternion);
+}
+
+GD_MATH_TARGET_AVX
+static void gd_math_lerp_avx(const gd_real_t *p_from, const gd_real_t *p_to, gd_real_t p_weight, gd_real_t *r_dst, int64_t p_count) {
+  const __m256 weight = _mm256_set1_ps(p_weight);
+  int64_t i = 0;
+  for (; i + 8 <= p_count; i += 8) {
+    __m256 from = _mm256_loadu_ps(p_from + i);
+    __m256 to = _mm256_loadu_ps(p_to + i);
+    _mm256_storeu_ps(r_dst + i, _mm256_add_ps(from, _mm256_mul_ps(_mm256_sub_ps(to, from), weight)));
+  }
+  gd_math_lerp_scalar(p_from + i, p_to + i, p_weight, r_dst + i, p_count - i);
+}
+
+#elif (GD_MATH_X86 && IS_GODOT_USING_LARGE_WORLD_COORDINATES)
+
+// With doubles an SSE2 register holds (x, y), so Vector3s are split into
+// (x, y) and (z, unused)
+
+GD_MATH_TARGET_SSE2
+static void gd_math_xform2_sse2(const gd_real_t *p_columns, const gd_real_t *p_src, gd_real_t *r_dst, int64_t p_count) {
+  const gd_real_t *c = p_columns;
+  const __m128d column_x = _mm_setr_pd(c[0], c[1]);
+  const __m128d column_y = _mm_setr_pd(c[2], c[3]);
+  const __m128d origin = _mm_setr_pd(c[4], c[5]);
+  for (int64_t i = 0; i < p_count; i++) {
+    __m128d x = _mm_set1_pd(p_src[2 * i]);
+    __m128d y = _mm_set1_pd(p_src[2 * i + 1]);
+    __m128d r = _mm_add_pd(_mm_add_pd(_mm_mul_pd(column_x, x), _mm_mul_pd(column_y, y)), origin);
+    _mm_storeu_pd(r_dst + 2 * i, r);
+  }
+}
+
+GD_MATH_TARGET_SSE2
+static void gd_math_xform3_sse2(const gd_real_t *p_rows, const gd_real_t *p_origin, const gd_real_t *p_src, gd_real_t *r_dst, int64_t p_count) {
+  const gd_real_t *r = p_rows;
+  const __m128d column_x_xy = _mm_setr_pd(r[0], r[3]);
+  const __m128d column_y_xy = _mm_setr_pd(r[1], r[4]);
+  const __m128d column_z_xy = _mm_setr_pd(r[2], r[5]);
+  const __m128d column_x_z = _mm_set_sd(r[6]);
+  const __m128d column_y_z = _mm_set_sd(r[7]);
+  const __m128d column_z_z = _mm_set_sd(r[8]);
+  const bool has_origin = p_origin != NULL;
+  const __m128d origin_xy = has_origin ? _mm_setr_pd(p_origin[0], p_origin[1]) : _mm_setzero_pd();
+  const __m128d origin_z = has_origin ? _mm_set_sd(p_origin[2]) : _mm_setzero_pd();
+  for (int64_t i = 0; i < p_count; i++) {
+    const gd_real_t *v = p_src + 3 * i;
+    __m128d x = _mm_set1_pd(v[0]);
+    __m128d y = _mm_set1_pd(v[1]);
+    __m128d z = _mm_set1_pd(v[2]);
+    __m128d res_xy = _mm_add_pd(_mm_add_pd(_mm_mul_pd(column_x_xy, x), _mm_mul_pd(column_y_xy, y)),
+                                _mm_mul_pd(column_z_xy, z));
+    __m128d res_z = _mm_add_sd(_mm_add_sd(_mm_mul_sd(column_x_z, x), _mm_mul_sd(column_y_z, y)),
+                               _mm_mul_sd(column_z_z, z));
+    if (has_origin) {
+      res_xy = _mm_add_pd(res_xy, origin_xy);
+      res_z = _mm_add_sd(res_z, origin_z);
+    }
+    gd_real_t *d = r_dst + 3 * i;
+    _mm_storeu_pd(d, res_xy);
+    _mm_store_sd(d + 2, res_z);
+  }
+}
+
+GD_MATH_TARGET_SSE2
+static void gd_math_normalize2_sse2(const gd_real_t *p_src, gd_real_t *r_dst, int64_t p_count) {
+  for (int64_t i = 0; i < p_count; i++) {
+    __m128d v = _mm_loadu_pd(p_src + 2 * i);
+    __m128d squares = _mm_mul_pd(v, v);
+    __m128d sum = _mm_add_sd(squares, _mm_unpackhi_pd(squares, squares));
+    __m128d length_squared = _mm_unpacklo_pd(sum, sum);
+    __m128d res = _mm_div_pd(v, _mm_sqrt_pd(length_squared));
+    // Zero vectors stay as they are
+    __m128d zero = _mm_cmpeq_pd(length_squared, _mm_setzero_pd());
+    res = _mm_or_pd(_mm_and_pd(zero, v), _mm_andnot_pd(zero, res));
+    _mm_storeu_pd(r_dst + 2 * i, res);
+  }
+}
+
+GD_MATH_TARGET_SSE2
+static void gd_math_normalize3_sse2(const gd_real_t *p_src, gd_real_t *r_dst, int64_t p_count) {
+  for (int64_t i = 0; i < p_count; i++) {
+    const gd_real_t *s = p_src + 3 * i;
+    __m128d v_xy = _mm_loadu_pd(s);
+    __m128d v_z = _mm_load_sd(s + 2);
+    __m128d squares_xy = _mm_mul_pd(v_xy, v_xy);
+    __m128d sum = _mm_add_sd(squares_xy, _mm_unpackhi_pd(squares_xy, squares_xy));
+    sum = _mm_add_sd(sum, _mm_mul_sd(v_z, v_z));
+    __m128d length = _mm_sqrt_sd(sum, sum);
+    length = _mm_unpacklo_pd(length, length);
+    __m128d not_zero = _mm_cmpneq_pd(length, _mm_setzero_pd());
+    gd_real_t *d = r_dst + 3 * i;
+    _mm_storeu_pd(d, _mm_and_pd(_mm_div_pd(v_xy, length), not_zero));
+    _mm_store_sd(d + 2, _mm_and_pd(_mm_div_sd(v_z, length), not_zero));
+  }
+}
+
+GD_MATH_TARGET_SSE2
+static void gd_math_normalize4_sse2(const gd_real_t *p_src, gd_real_t *r_dst, int64_t p_count, bool p_quaternion) {
+  for (int64_t i = 0; i < p_count; i++) {
+    __m128d v_xy = _mm_loadu_pd(p_src + 4 * i);
+    __m128d v_zw = _mm_loadu_pd(p_src + 4 * i + 2);
+    __m128d squares_xy = _mm_mul_pd(v_xy, v_xy);
+    __m128d squares_zw = _mm_mul_pd(v_zw, v_zw);
+    __m128d sum = _mm_add_sd(squares_xy, _mm_unpackhi_pd(squares_xy, squares_xy));
+    sum = _mm_add_sd(sum, squares_zw);
+    sum = _mm_add_sd(sum, _mm_unpackhi_pd(squares_zw, squares_zw));
+    __m128d length = _mm_sqrt_sd(sum, sum);
+    if (p_quaternion) {
+      __m128d inverse = _mm_div_sd(_mm_set_sd(1), length);
+      inverse = _mm_unpacklo_pd(inverse, inverse);
+      v_xy = _mm_mul_pd(v_xy, inverse);
+      v_zw = _mm_mul_pd(v_zw, inverse);
+    } else {
+      length = _mm_unpacklo_pd(length, length);
+      __m128d not_zero = _mm_cmpneq_pd(length, _mm_setzero_pd());
+      v_xy = _mm_and_pd(_mm_div_pd(v_xy, length), not_zero);
+      v_zw = _mm_and_pd(_mm_div_pd(v_zw, length), not_zero);
+    }
+    _mm_storeu_pd(r_dst + 4 * i, v_xy);
+    _mm_storeu_pd(r_dst + 4 * i + 2, v_zw);
+  }
+}
+
+GD_MATH_TARGET_SSE2
+static void gd_math_lerp_sse2(const gd_real_t *p_from, const gd_real_t *p_to, gd_real_t p_weight, gd_real_t *r_dst, int64_t p_count) {
+  const __m128d weight = _mm_set1_pd(p_weight);
+  int64_t i = 0;
+  for (; i + 2 <= p_count; i += 2) {
+    __m128d from = _mm_loadu_pd(p_from + i);
+    __m128d to = _mm_loadu_pd(p_to + i);
+    _mm_storeu_pd(r_dst + i, _mm_add_pd(from, _mm_mul_pd(_mm_sub_pd(to, from), weight)));
+  }
+  gd_math_lerp_scalar(p_from + i, p_to + i, p_weight, r_dst + i, p_count - i);
+}
+
+// Also the AVX kernel: it's bound by loads, wider registers don't help
+GD_MATH_TARGET_SSE2
+static void gd_math_aabb_merge_sse2(const gd_real_t *p_boxes, int64_t p_count, gd_real_t *r_begin, gd_real_t *r_end) {
+  __m128d begin_xy = _mm_loadu_pd(p_boxes);
+  __m128d begin_z = _mm_load_sd(p_boxes + 2);
+  __m128d end_xy = _mm_add_pd(begin_xy, _mm_loadu_pd(p_boxes + 3));
+  __m128d end_z = _mm_add_sd(begin_z, _mm_load_sd(p_boxes + 5));
+  for (int64_t i = 1; i < p_count; i++) {
+    const gd_real_t *box = p_boxes + 6 * i;
+    __m128d position_xy = _mm_loadu_pd(box);
+    __m128d position_z = _mm_load_sd(box + 2);
+    begin_xy = _mm_min_pd(begin_xy, position_xy);
+    begin_z = _mm_min_sd(begin_z, position_z);
+    end_xy = _mm_max_pd(end_xy, _mm_add_pd(position_xy, _mm_loadu_pd(box + 3)));
+    end_z = _mm_max_sd(end_z, _mm_add_sd(position_z, _mm_load_sd(box + 5)));
+  }
+  _mm_storeu_pd(r_begin, begin_xy);
+  _mm_store_sd(r_begin + 2, begin_z);
+  _mm_storeu_pd(r_end, end_xy);
+  _mm_store_sd(r_end + 2, end_z);
+}
+
+// One Vector3 per register as (x, y, z, unused)
+GD_MATH_TARGET_AVX
+static inline void gd_math_store_vector3_avx(gd_real_t *r_dst, __m256d p_value) {
+  _mm_storeu_pd(r_dst, _mm256_castpd256_pd128(p_value));
+  _mm_store_sd(r_dst + 2, _mm256_extractf128_pd(p_value, 1));
+}
+
+GD_MATH_TARGET_AVX
+static void gd_math_xform2_avx(const gd_real_t *p_columns, const gd_real_t *p_src, gd_real_t *r_dst, int64_t p_count) {
+  const gd_real_t *c = p_columns;
+  const __m256d column_x = _mm256_setr_pd(c[0], c[1], c[0], c[1]);
+  const __m256d column_y = _mm256_setr_pd(c[2], c[3], c[2], c[3]);
+  const __m256d origin = _mm256_setr_pd(c[4], c[5], c[4], c[5]);
+  int64_t i = 0;
+  for (; i + 2 <= p_count; i += 2) {
+    __m256d v = _mm256_loadu_pd(p_src + 2 * i);
+    __m256d x = _mm256_permute_pd(v, 0x0);
+    __m256d y = _mm256_permute_pd(v, 0xF);
+    __m256d r = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(column_x, x), _mm256_mul_pd(column_y, y)), origin);
+    _mm256_storeu_pd(r_dst + 2 * i, r);
+  }
+  gd_math_xform2_scalar(p_columns, p_src + 2 * i, r_dst + 2 * i, p_count - i);
+}
+
+GD_MATH_TARGET_AVX
+static void gd_math_xform3_avx(const gd_real_t *p_rows, const gd_real_t *p_origin, const gd_real_t *p_src, gd_real_t *r_dst, int64_t p_count) {
+  const gd_real_t *r = p_rows;
+  const __m256d column_x = _mm256_setr_pd(r[0], r[3], r[6], 0);
+  const __m256d column_y = _mm256_setr_pd(r[1], r[4], r[7], 0);
+  const __m256d column_z = _mm256_setr_pd(r[2], r[5], r[8], 0);
+  const bool has_origin = p_origin != NULL;
+  const __m256d origin = has_origin ? _mm256_setr_pd(p_origin[0], p_origin[1], p_origin[2], 0) : _mm256_setzero_pd();
+  for (int64_t i = 0; i < p_count; i++) {
+    const gd_real_t *v = p_src + 3 * i;
+    __m256d res = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(column_x, _mm256_broadcast_sd(v)),
+                                              _mm256_mul_pd(column_y, _mm256_broadcast_sd(v + 1))),
+                                _mm256_mul_pd(column_z, _mm256_broadcast_sd(v + 2)));
+    if (has_origin) res = _mm256_add_pd(res, origin);
+    gd_math_store_vector3_avx(r_dst + 3 * i, res);
+  }
+}
+
+GD_MATH_TARGET_AVX
+static void gd_math_normalize2_avx(const gd_real_t *p_src, gd_real_t *r_dst, int64_t p_count) {
+  int64_t i = 0;
+  for (; i + 2 <= p_count; i += 2) {
+    __m256d v = _mm256_loadu_pd(p_src + 2 * i);
+    __m256d squares = _mm256_mul_pd(v, v);
+    __m256d length_squared = _mm256_add_pd(squares, _mm256_permute_pd(squares, 0x5));
+    __m256d res = _mm256_div_pd(v, _mm256_sqrt_pd(length_squared));
+    __m256d zero = _mm256_cmp_pd(length_squared, _mm256_setzero_pd(), _CMP_EQ_OQ);
+    res = _mm256_blendv_pd(res, v, zero);
+    _mm256_storeu_pd(r_dst + 2 * i, res);
+  }
+  gd_math_normalize2_scalar(p_src + 2 * i, r_dst + 2 * i, p_count - i);
+}
+
+// A vector of doubles is one square root and division per element, wider
+// registers only add shuffles: the SSE2 kernels are faster
+#define gd_math_normalize3_avx gd_math_normalize3_sse2
+#define gd_math_normalize4_avx gd_math_normalize4_sse2
+
+GD_MATH_TARGET_AVX
+static void gd_math_lerp_avx(const gd_real_t *p_from, const gd_real_t *p_to, gd_real_t p_weight, gd_real_t *r_dst, int64_t p_count) {
+  const __m256d weight = _mm256_set1_pd(p_weight);
+  int64_t i = 0;
+  for (; i + 4 <= p_count; i += 4) {
+    __m256d from = _mm256_loadu_pd(p_from + i);
+    __m256d to = _mm256_loadu_pd(p_to + i);
+    _mm256_storeu_pd(r_dst + i, _mm256_add_pd(from, _mm256_mul_pd(_mm256_sub_pd(to, from), weight)));
+  }
+  gd_math_lerp_scalar(p_from + i, p_to + i, p_weight, r_dst + i, p_count - i);
+}
+
+#endif // GD_MATH_X86
+
+#if (GD_MATH_X86)
+static const gd_math_kernels_t gd_math_kernels_sse2 = {
+  .xform2 = gd_math_xform2_sse2,
+  .xform3 = gd_math_xform3_sse2,
+  .normalize2 = gd_math_normalize2_sse2,
+  .normalize3 = gd_math_normalize3_sse2,
+  .normalize4 = gd_math_normalize4_sse2,
+  .lerp = gd_math_lerp_sse2,
+  .aabb_merge = gd_math_aabb_merge_sse2,
+};
+
+static const gd_math_kernels_t gd_math_kernels_avx = {
+  .xform2 = gd_math_xform2_avx,
+  .xform3 = gd_math_xform3_avx,
+  .normalize2 = gd_math_normalize2_avx,
+  .normalize3 = gd_math_normalize3_avx,
+  .normalize4 = gd_math_normalize4_avx,
+  .lerp = gd_math_lerp_avx,
+  .aabb_merge = gd_math_aabb_merge_sse2,
+};
+#endif
+
+// ---------------------------------------------------------------------------
+// Dispatch
+// ---------------------------------------------------------------------------
+
+static struct {
+  gd_math_level_t level;
+  gd_math_level_t best_level;
+  gd_math_kernels_t kernels;
+} gd_math = {
+  .level = GD_MATH_LEVEL_SCALAR,
+  .best_level = GD_MATH_LEVEL_SCALAR,
+  .kernels = {
+    .xform2 = gd_math_xform2_scalar,
+    .xform3 = gd_math_xform3_scalar,
+    .normalize2 = gd_math_normalize2_scalar,
+    .normalize3 = gd_math_normalize3_scalar,
+    .normalize4 = gd_math_normalize4_scalar,
+    .lerp = gd_math_lerp_scalar,
+    .aabb_merge = gd_math_aabb_merge_scalar,
+  },
+};
+
+// NOTE: Switching isn't synchronized with other threads, do it before any
+// batch work starts
+static bool gd_math_set_level(gd_math_level_t p_level) {
+  if (p_level > gd_math.best_level) return false;
+  switch (p_level) {
+#if (GD_MATH_X86)
+    case GD_MATH_LEVEL_AVX: gd_math.kernels = gd_math_kernels_avx; break;
+    case GD_MATH_LEVEL_SSE2: gd_math.kernels = gd_math_kernels_sse2; break;
+#endif
+    default: gd_math.kernels = gd_math_kernels_scalar; break;
+  }
+  gd_math.level = p_level;
+  return true;
+}
+
+static void gd_math_init(void) {
+  gd_math.best_level = GD_MATH_LEVEL_SCALAR;
+#if (GD_MATH_X86)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("sse2")) gd_math.best_level = GD_MATH_LEVEL_SSE2;
+  if (__builtin_cpu_supports("avx")) gd_math.best_level = GD_MATH_LEVEL_AVX;
+#endif
+  gd_math_set_level(gd_math.best_level);
+}
+
+// ---------------------------------------------------------------------------
+// Public API
+// ---------------------------------------------------------------------------
+
+static inline void
+gd_math_transform2d_xform_vector2(
+  const gd_math_transform2d_t *p_transform,
+  const gd_math_vector2_t *p_src,
+  gd_math_vector2_t *r_dst,
+  int64_t p_count
+) {
+  gd_math.kernels.xform2(&p_transform->columns[0].x, &p_src->x, &r_dst->x, p_count);
+}
+
+static inline void
+gd_math_transform3d_xform_vector3(
+  const gd_math_transform3d_t *p_transform,
+  const gd_math_vector3_t *p_src,
+  gd_math_vector3_t *r_dst,
+  int64_t p_count
+) {
+  gd_math.kernels.xform3(&p_transform->basis.rows[0].x, &p_transform->origin.x, &p_src->x, &r_dst->x, p_count);
+}
+
+static inline void
+gd_math_basis_xform_vector3(
+  const gd_math_basis_t *p_basis,
+  const gd_math_vector3_t *p_src,
+  gd_math_vector3_t *r_dst,
+  int64_t p_count
+) {
+  gd_math.kernels.xform3(&p_basis->rows[0].x, NULL, &p_src->x, &r_dst->x, p_count);
+}
+
+static inline void gd_math_vector2_normalize(const gd_math_vector2_t *p_src, gd_math_vector2_t *r_dst, int64_t p_count) {
+  gd_math.kernels.normalize2(&p_src->x, &r_dst->x, p_count);
+}
+
+static inline void gd_math_vector3_normalize(const gd_math_vector3_t *p_src, gd_math_vector3_t *r_dst, int64_t p_count) {
+  gd_math.kernels.normalize3(&p_src->x, &r_dst->x, p_count);
+}
+
+static inline void gd_math_vector4_normalize(const gd_math_vector4_t *p_src, gd_math_vector4_t *r_dst, int64_t p_count) {
+  gd_math.kernels.normalize4(&p_src->x, &r_dst->x, p_count, false);
+}
+
+// Like Godot, a zero quaternion becomes NaNs
+static inline void gd_math_quaternion_normalize(const gd_math_quaternion_t *p_src, gd_math_quaternion_t *r_dst, int64_t p_count) {
+  gd_math.kernels.normalize4(&p_src->x, &r_dst->x, p_count, true);
+}
+
+// Lerps are component-wise, so all vector sizes share one kernel
+static inline void
+gd_math_vector2_lerp(
+  const gd_math_vector2_t *p_from,
+  const gd_math_vector2_t *p_to,
+  gd_real_t p_weight,
+  gd_math_vector2_t *r_dst,
+  int64_t p_count
+) {
+  gd_math.kernels.lerp(&p_from->x, &p_to->x, p_weight, &r_dst->x, p_count * 2);
+}
+
+static inline void
+gd_math_vector3_lerp(
+  const gd_math_vector3_t *p_from,
+  const gd_math_vector3_t *p_to,
+  gd_real_t p_weight,
+  gd_math_vector3_t *r_dst,
+  int64_t p_count
+) {
+  gd_math.kernels.lerp(&p_from->x, &p_to->x, p_weight, &r_dst->x, p_count * 3);
+}
+
+static inline void
+gd_math_vector4_lerp(
+  const gd_math_vector4_t *p_from,
+  const gd_math_vector4_t *p_to,
+  gd_real_t p_weight,
+  gd_math_vector4_t *r_dst,
+  int64_t p_count
+) {
+  gd_math.kernels.lerp(&p_from->x, &p_to->x, p_weight, &r_dst->x, p_count * 4);
+}
+
+// Godot's Quaternion::slerp, including its mix of precisions: the first
+// scale is computed in double even with float reals
+static void
+gd_math_quaternion_slerp(
+  const gd_math_quaternion_t *p_from,
+  const gd_math_quaternion_t *p_to,
+  gd_real_t p_weight,
+  gd_math_quaternion_t *r_dst,
+  int64_t p_count
+) {
+  for (int64_t i = 0; i < p_count; i++) {
+    gd_math_quaternion_t from = p_from[i];
+    gd_math_quaternion_t to = p_to[i];
+    gd_real_t cosom = from.x * to.x + from.y * to.y + from.z * to.z + from.w * to.w;
+    if (cosom < 0) {
+      cosom = -cosom;
+      to = (gd_math_quaternion_t){ .x = -to.x, .y = -to.y, .z = -to.z, .w = -to.w };
+    }
+
+    gd_real_t scale0;
+    gd_real_t scale1;
+    if ((1 - cosom) > (gd_real_t)GD_MATH_CMP_EPSILON) {
+      gd_real_t omega = GD_MATH_ACOS(cosom);
+      gd_real_t sinom = GD_MATH_SIN(omega);
+      scale0 = sin((1.0 - p_weight) * omega) / sinom;
+      scale1 = GD_MATH_SIN(p_weight * omega) / sinom;
+    } else {
+      // Very close, a lerp is good enough
+      scale0 = 1 - p_weight;
+      scale1 = p_weight;
+    }
+
+    r_dst[i] = (gd_math_quaternion_t){
+      .x = scale0 * from.x + scale1 * to.x,
+      .y = scale0 * from.y + scale1 * to.y,
+      .z = scale0 * from.z + scale1 * to.z,
+      .w = scale0 * from.w + scale1 * to.w,
+    };
+  }
+}
+
+// Merges `p_count` boxes (at least one) into the smallest box around all of
+// them
+static inline gd_math_aabb_t gd_math_aabb_merge(const gd_math_aabb_t *p_boxes, int64_t p_count) {
+  gd_real_t begin[3];
+  gd_real_t end[3];
+  gd_math.kernels.aabb_merge(&p_boxes->position.x, p_count, begin, end);
+  return (gd_math_aabb_t){
+    .position = { .x = begin[0], .y = begin[1], .z = begin[2] },
+    .size = { .x = end[0] - begin[0], .y = end[1] - begin[1], .z = end[2] - begin[2] },
+  };
+}
+
+#endif // GD_MATH_H
@@ -0,0 +1,225 @@
+#ifndef GD_STRING_H
+#define GD_STRING_H
+
+// Cheaper ways in and out of Godot Strings.
+//
+// `string_new_with_utf8_chars` decodes UTF-8 on every call, and
+// `string_to_utf8_chars` encodes it again (usually twice, once to get the
+// length). Godot stores Strings as UTF-32, so most of that work can be
+// skipped:
+//
+// - GD_STRING_NEW_LITERAL picks `string_new_with_latin1_chars_and_len` for
+//   ASCII literals, which widens bytes to code points without decoding, and
+//   falls back to UTF-8 otherwise. The ASCII check is folded away by the
+//   compiler for literals when optimizing.
+// - GD_STRING_NEW_UTF32 takes a literal and stores it as `U"..."`, so the
+//   compiler does the decoding and Godot only copies.
+// - GD_STRING_CACHED builds an immutable String for a literal the first time
+//   it's reached and returns the same one afterwards. Godot Strings are copy
+//   on write, so passing it as an argument or copying it costs a reference
+//   count at most.
+// - `gd_string_view` reads a String's UTF-32 buffer in place through
+//   `string_operator_index_const`, nothing is copied or encoded.
+// - UTF-8 copies are still there, but you have to ask for them by name with
+//   `gd_string_utf8_copy`.
+//
+// Usage:
+//
+//   gd_string_init(p_get_proc_address); // in godot_entry
+//   uint8_t title[8];
+//   GD_STRING_NEW_LITERAL(title, "Hello!");
+//   GDExtensionConstStringPtr body = GD_STRING_CACHED("Cached, never rebuilt");
+//   gd_string_view_t view = gd_string_view(title);
+//   ...
+//   gd_string_cache_clear(); // on deinitialization
+//
+// NOTE: A view points into the String's buffer. It's only valid until the
+// String is modified or destroyed.
+//
+// NOTE: GD_STRING_CACHED is a GNU statement expression (GCC and Clang). The
+// first call of each site should happen on the main thread, afterwards the
+// String is read-only and safe to use from any thread.
+
+#include "../godot-headers/gdextension_interface.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define GD_STRING_SIZE (sizeof(void *))
+
+static struct {
+  struct {
+    GDExtensionInterfaceStringNewWithLatin1CharsAndLen string_new_with_latin1_chars_and_len;
+    GDExtensionInterfaceStringNewWithUtf8CharsAndLen string_new_with_utf8_chars_and_len;
+    GDExtensionInterfaceStringNewWithUtf32CharsAndLen string_new_with_utf32_chars_and_len;
+    GDExtensionInterfaceStringNameNewWithLatin1Chars string_name_new_with_latin1_chars;
+    GDExtensionInterfaceStringNameNewWithUtf8CharsAndLen string_name_new_with_utf8_chars_and_len;
+    GDExtensionInterfaceStringToUtf8Chars string_to_utf8_chars;
+    GDExtensionInterfaceStringToUtf32Chars string_to_utf32_chars;
+    GDExtensionInterfaceStringOperatorIndexConst string_operator_index_const;
+    GDExtensionInterfaceVariantGetPtrDestructor variant_get_ptr_destructor;
+  } interface;
+
+  GDExtensionPtrDestructor string_destructor;
+  struct gd_string_cached *cached;
+} gd_string;
+
+#define GD_STRING_STORE_INTERFACE(name) \
+  gd_string.interface.name = (void *)p_get_proc_address(#name);
+
+static void gd_string_init(GDExtensionInterfaceGetProcAddress p_get_proc_address) {
+  GD_STRING_STORE_INTERFACE(string_new_with_latin1_chars_and_len);
+  GD_STRING_STORE_INTERFACE(string_new_with_utf8_chars_and_len);
+  GD_STRING_STORE_INTERFACE(string_new_with_utf32_chars_and_len);
+  GD_STRING_STORE_INTERFACE(string_name_new_with_latin1_chars);
+  GD_STRING_STORE_INTERFACE(string_name_new_with_utf8_chars_and_len);
+  GD_STRING_STORE_INTERFACE(string_to_utf8_chars);
+  GD_STRING_STORE_INTERFACE(string_to_utf32_chars);
+  GD_STRING_STORE_INTERFACE(string_operator_index_const);
+  GD_STRING_STORE_INTERFACE(variant_get_ptr_destructor);
+
+  gd_string.string_destructor = gd_string.interface.variant_get_ptr_destructor(GDEXTENSION_VARIANT_TYPE_STRING);
+}
+
+static inline bool gd_string_is_ascii(const char *p_contents, size_t p_length) {
+  for (size_t i = 0; i < p_length; i++) {
+    if ((unsigned char)p_contents[i] >= 0x80) return false;
+  }
+  return true;
+}
+
+// ASCII is Latin-1 is UTF-32 with the upper bytes zeroed, so Godot can take
+// it without decoding
+static inline void gd_string_new(GDExtensionUninitializedStringPtr r_dest, const char *p_utf8, size_t p_length) {
+  if (gd_string_is_ascii(p_utf8, p_length)) {
+    gd_string.interface.string_new_with_latin1_chars_and_len(r_dest, p_utf8, p_length);
+  } else {
+    gd_string.interface.string_new_with_utf8_chars_and_len(r_dest, p_utf8, p_length);
+  }
+}
+
+static inline void gd_string_name_new(GDExtensionUninitializedStringNamePtr r_dest, const char *p_utf8, size_t p_length) {
+  // NOTE: `p_is_static` would make Godot keep pointing at our string. That
+  // outlives the library when the editor reloads it, so it stays off.
+  if (gd_string_is_ascii(p_utf8, p_length)) {
+    gd_string.interface.string_name_new_with_latin1_chars(r_dest, p_utf8, false);
+  } else {
+    gd_string.interface.string_name_new_with_utf8_chars_and_len(r_dest, p_utf8, p_length);
+  }
+}
+
+// `"" literal` makes sure only string literals get in, sizeof gives the
+// length without a strlen
+#define GD_STRING_NEW_LITERAL(r_dest, literal) \
+  gd_string_new((r_dest), "" literal, sizeof("" literal) - 1)
+
+#define GD_STRING_NAME_NEW_LITERAL(r_dest, literal) \
+  gd_string_name_new((r_dest), "" literal, sizeof("" literal) - 1)
+
+#define GD_STRING_NEW_UTF32(r_dest, literal)                                \
+  gd_string.interface.string_new_with_utf32_chars_and_len((r_dest), U"" literal, \
+                                                           sizeof(U"" literal) / sizeof(char32_t) - 1)
+
+typedef struct gd_string_cached {
+  uint8_t string[GD_STRING_SIZE];
+  bool ready;
+  struct gd_string_cached *next;
+} gd_string_cached_t;
+
+static inline GDExtensionConstStringPtr gd_string_cached_at(gd_string_cached_t *slot, const char *p_utf8, size_t p_length) {
+  if (__builtin_expect(!slot->ready, 0)) {
+    gd_string_new(slot->string, p_utf8, p_length);
+    slot->next = gd_string.cached;
+    gd_string.cached = slot;
+    slot->ready = true;
+  }
+  return slot->string;
+}
+
+#define GD_STRING_CACHED(literal) ({                                              \
+    static gd_string_cached_t gd_string_cached_slot_;                             \
+    gd_string_cached_at(&gd_string_cached_slot_, "" literal, sizeof("" literal) - 1); \
+  })
+
+// Destroys every cached String. Sites that are reached again build theirs
+// again.
+static inline void gd_string_cache_clear(void) {
+  gd_string_cached_t *slot = gd_string.cached;
+  while (slot != NULL) {
+    gd_string_cached_t *next = slot->next;
+    gd_string.string_destructor(slot->string);
+    slot->ready = false;
+    slot->next = NULL;
+    slot = next;
+  }
+  gd_string.cached = NULL;
+}
+
+typedef struct {
+  const char32_t *data;
+  int64_t length;
+} gd_string_view_t;
+
+static inline gd_string_view_t gd_string_view(GDExtensionConstStringPtr p_string) {
+  // With no buffer to write to, this only returns the length
+  int64_t length = gd_string.interface.string_to_utf32_chars(p_string, NULL, 0);
+  gd_string_view_t res = { .data = NULL, .length = 0 };
+  if (length > 0) {
+    res.data = gd_string.interface.string_operator_index_const(p_string, 0);
+    res.length = length;
+  }
+  return res;
+}
+
+static inline gd_string_view_t gd_string_view_slice(gd_string_view_t view, int64_t p_from, int64_t p_to) {
+  if (p_from < 0) p_from = 0;
+  if (p_to > view.length) p_to = view.length;
+  if (p_from >= p_to) return (gd_string_view_t){ .data = NULL, .length = 0 };
+  return (gd_string_view_t){ .data = view.data + p_from, .length = p_to - p_from };
+}
+
+// Returns -1 if `p_char` isn't there
+static inline int64_t gd_string_view_find(gd_string_view_t view, char32_t p_char, int64_t p_from) {
+  for (int64_t i = p_from < 0 ? 0 : p_from; i < view.length; i++) {
+    if (view.data[i] == p_char) return i;
+  }
+  return -1;
+}
+
+static inline bool gd_string_view_equals_ascii(gd_string_view_t view, const char *p_ascii) {
+  int64_t i = 0;
+  for (; i < view.length; i++) {
+    if (p_ascii[i] == '\0' || view.data[i] != (unsigned char)p_ascii[i]) return false;
+  }
+  return p_ascii[i] == '\0';
+}
+
+static inline bool gd_string_view_starts_with_ascii(gd_string_view_t view, const char *p_ascii) {
+  for (int64_t i = 0; p_ascii[i] != '\0'; i++) {
+    if (i >= view.length || view.data[i] != (unsigned char)p_ascii[i]) return false;
+  }
+  return true;
+}
+
+// Walks the view with `ch` pointing at each code point, `*ch` is the
+// character. It's a single `for`, so `break` and `continue` work as usual.
+// `view` is evaluated more than once.
+#define GD_STRING_VIEW_FOREACH(view, ch)                                   \
+  for (const char32_t *ch = (view).data,                                  \
+                      *ch##_end_ = (view).length > 0 ? (view).data + (view).length : (view).data; \
+       ch != ch##_end_;                                                   \
+       ch++)
+
+// The opt-in UTF-8 copy, NUL-terminated, free it with `free`. `r_length` may
+// be NULL.
+static inline char *gd_string_utf8_copy(GDExtensionConstStringPtr p_string, size_t *r_length) {
+  GDExtensionInt length = gd_string.interface.string_to_utf8_chars(p_string, NULL, 0);
+  char *res = malloc(length + 1);
+  gd_string.interface.string_to_utf8_chars(p_string, res, length);
+  res[length] = '\0';
+  if (r_length != NULL) *r_length = length;
+  return res;
+}
+
+#endif
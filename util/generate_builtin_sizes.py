@@ -0,0 +1,129 @@
+#!/usr/bin/env python3
+
+# Generates util/builtin_sizes.h from gde-api's `builtin_class_sizes`.
+#
+#   ./util/generate_builtin_sizes.py [godot-headers/extension_api.json] [util/builtin_sizes.h]
+
+import json
+import re
+import sys
+
+# The order of GDExtensionVariantType, Nil and Variant are handled separately
+VARIANT_TYPES = [
+    "bool", "int", "float", "String", "Vector2", "Vector2i", "Rect2", "Rect2i",
+    "Vector3", "Vector3i", "Transform2D", "Vector4", "Vector4i", "Plane",
+    "Quaternion", "AABB", "Basis", "Transform3D", "Projection", "Color",
+    "StringName", "NodePath", "RID", "Object", "Callable", "Signal",
+    "Dictionary", "Array", "PackedByteArray", "PackedInt32Array",
+    "PackedInt64Array", "PackedFloat32Array", "PackedFloat64Array",
+    "PackedStringArray", "PackedVector2Array", "PackedVector3Array",
+    "PackedColorArray",
+]
+
+# Types made of `real_t` which is double with large world coordinates
+REAL_TYPES = {
+    "Vector2", "Rect2", "Vector3", "Transform2D", "Vector4", "Plane",
+    "Quaternion", "AABB", "Basis", "Transform3D", "Projection",
+}
+
+# Types made of 32-bit ints or floats regardless of the configuration
+WORD_TYPES = {"Vector2i", "Rect2i", "Vector3i", "Vector4i", "Color"}
+
+# Types that hold 64-bit values (or an ObjectID) regardless of the configuration
+DWORD_TYPES = {"int", "float", "RID", "Callable", "Signal", "Variant"}
+
+CONFIGURATIONS = [
+    # (name, is 64-bit, uses large world coordinates)
+    ("float_32", False, False),
+    ("float_64", True, False),
+    ("double_32", False, True),
+    ("double_64", True, True),
+]
+
+
+def enum_suffix(name):
+    # "PackedVector2Array" -> "PACKED_VECTOR2_ARRAY", "Transform2D" -> "TRANSFORM2D"
+    return re.sub(r"(?<=[a-z0-9])(?=[A-Z][a-z])", "_", name).upper()
+
+
+def snake_name(name):
+    return enum_suffix(name).lower()
+
+
+def alignment(name, is_64_bit, is_double):
+    if name == "bool":
+        return 1
+    if name in REAL_TYPES:
+        return 8 if is_double else 4
+    if name in WORD_TYPES:
+        return 4
+    if name in DWORD_TYPES:
+        return 8
+    # Everything else is one or two pointers
+    return 8 if is_64_bit else 4
+
+
+def generate(api):
+    sizes = {
+        entry["build_configuration"]: {s["name"]: s["size"] for s in entry["sizes"]}
+        for entry in api["builtin_class_sizes"]
+    }
+
+    out = []
+    out.append("#ifndef BUILTIN_SIZES_H")
+    out.append("#define BUILTIN_SIZES_H")
+    out.append("")
+    out.append("// Generated by util/generate_builtin_sizes.py from gde-api's")
+    out.append("// `builtin_class_sizes`, do not edit by hand.")
+    out.append("//")
+    out.append("// Define IS_GODOT_64_BIT and IS_GODOT_USING_LARGE_WORLD_COORDINATES before")
+    out.append("// including this header to pick a build configuration. There are no")
+    out.append("// defaults, a define that comes after the include would silently lose.")
+    out.append("")
+    out.append("// `true`/`false` have to be macros for the #if below to work in C")
+    out.append("#ifndef __cplusplus")
+    out.append("#include <stdbool.h>")
+    out.append("#endif")
+    out.append("")
+    out.append("#if !defined(IS_GODOT_64_BIT) || !defined(IS_GODOT_USING_LARGE_WORLD_COORDINATES)")
+    out.append("#error \"define IS_GODOT_64_BIT / IS_GODOT_USING_LARGE_WORLD_COORDINATES before including builtin_sizes.h\"")
+    out.append("#endif")
+    out.append("")
+    out.append("// X(ENUM_SUFFIX, GodotName, snake_name) for every builtin type but Nil and Object,")
+    out.append("// which have no constructors or destructor")
+    out.append("#define GD_BUILTIN_TYPES(X) \\")
+    for name in VARIANT_TYPES:
+        if name == "Object":
+            continue
+        out.append(f"  X({enum_suffix(name)}, {name}, {snake_name(name)}) \\")
+    out.append("")
+    out.append("")
+
+    first = True
+    for config, is_64_bit, is_double in CONFIGURATIONS:
+        condition = (
+            f"{'' if is_64_bit else '!'}IS_GODOT_64_BIT && "
+            f"{'' if is_double else '!'}IS_GODOT_USING_LARGE_WORLD_COORDINATES"
+        )
+        out.append(f"#{'if' if first else 'elif'} ({condition}) // {config}")
+        first = False
+        for name in VARIANT_TYPES + ["Variant"]:
+            suffix = enum_suffix(name)
+            out.append(f"#define GD_BUILTIN_SIZE_{suffix} ({sizes[config][name]})")
+            out.append(f"#define GD_BUILTIN_ALIGN_{suffix} ({alignment(name, is_64_bit, is_double)})")
+    out.append("#endif")
+    out.append("")
+    out.append("#endif")
+    out.append("")
+    return "\n".join(out)
+
+
+if __name__ == "__main__":
+    api_path = sys.argv[1] if len(sys.argv) > 1 else "godot-headers/extension_api.json"
+    out_path = sys.argv[2] if len(sys.argv) > 2 else "util/builtin_sizes.h"
+
+    with open(api_path) as f:
+        api = json.load(f)
+
+    with open(out_path, "w") as f:
+        f.write(generate(api))
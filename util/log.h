@@ -0,0 +1,434 @@
+#ifndef LOG_H
+#define LOG_H
+
+// Asynchronous logger with compile-time level filtering.
+//
+// A log call doesn't format anything. It copies a pointer to a static
+// description of the call site (level, format string, function, file, line)
+// and its arguments into a ring buffer owned by the calling thread. A
+// background thread drains the rings every few milliseconds, formats the
+// records and prints them: debug and info go to stdout, warnings and errors go
+// through Godot's `print_warning`/`print_error` so they show up in the editor
+// with the original function, file and line.
+//
+// Usage:
+//
+//   log_start(p_get_proc_address); // in godot_entry
+//   LOG_INFO("spawned %d nodes in %.3f ms", count, ms);
+//   log_stop(); // on deinitialization, prints whatever is left
+//
+// Calls below LOG_MIN_LEVEL compile to nothing. Define it before including
+// this header to change it, by default debug builds log everything and
+// release builds (NDEBUG) skip LOG_DEBUG.
+//
+// NOTE: A call takes at most LOG_MAX_ARGS arguments. Integers, floats,
+// `void *` and strings are supported, cast other pointers to `void *`.
+// Strings are copied into the record (up to LOG_TEXT_SIZE bytes for all
+// strings of a call together), so they don't have to outlive the call.
+//
+// NOTE: When a ring is full the record is dropped and counted, except
+// warnings and errors which are then printed right away. Before `log_start`
+// and after `log_stop` everything is printed right away.
+
+#include "../godot-headers/gdextension_interface.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define LOG_LEVEL_DEBUG (0)
+#define LOG_LEVEL_INFO (1)
+#define LOG_LEVEL_WARNING (2)
+#define LOG_LEVEL_ERROR (3)
+#define LOG_LEVEL_NONE (4)
+
+#ifndef LOG_MIN_LEVEL
+#ifdef NDEBUG
+#define LOG_MIN_LEVEL LOG_LEVEL_INFO
+#else
+#define LOG_MIN_LEVEL LOG_LEVEL_DEBUG
+#endif
+#endif
+
+// Records per thread, has to be a power of two
+#define LOG_RING_SIZE (1024)
+#define LOG_MAX_ARGS (4)
+#define LOG_TEXT_SIZE (64)
+#define LOG_LINE_SIZE (1024)
+#define LOG_FLUSH_INTERVAL_NS (10 * 1000 * 1000)
+
+typedef struct {
+  int level;
+  const char *format;
+  const char *function;
+  const char *file;
+  int32_t line;
+} log_site_t;
+
+typedef enum {
+  LOG_ARG_INT,
+  LOG_ARG_UINT,
+  LOG_ARG_DOUBLE,
+  LOG_ARG_POINTER,
+  LOG_ARG_STRING,
+} log_arg_kind_t;
+
+typedef struct {
+  log_arg_kind_t kind;
+  union {
+    int64_t i;
+    uint64_t u;
+    double d;
+    const void *p;
+    const char *s;
+  };
+} log_arg_t;
+
+typedef struct {
+  const log_site_t *site;
+  uint64_t timestamp_ns;
+  uint8_t arg_count;
+  uint8_t kinds[LOG_MAX_ARGS];
+  // Strings are stored as an offset into `text`
+  union {
+    int64_t i;
+    uint64_t u;
+    double d;
+    const void *p;
+    uint32_t text_offset;
+  } args[LOG_MAX_ARGS];
+  char text[LOG_TEXT_SIZE];
+} log_record_t;
+
+// Single producer (the owning thread), single consumer (the flusher). The
+// indices only ever grow, `head - tail` is the number of pending records.
+typedef struct log_ring {
+  _Alignas(64) atomic_uint head;
+  _Alignas(64) atomic_uint tail;
+  struct log_ring *next;
+  uint32_t thread_index;
+  log_record_t records[LOG_RING_SIZE];
+} log_ring_t;
+
+static struct {
+  GDExtensionInterfacePrintError print_error;
+  GDExtensionInterfacePrintWarning print_warning;
+  log_ring_t *_Atomic rings;
+  atomic_uint thread_count;
+  atomic_ulong dropped;
+  atomic_bool running;
+  // Number of `log_write` calls in progress, `log_stop` waits for it to drop
+  // to zero before it drains and frees the rings
+  atomic_uint writers;
+  // Bumped by `log_stop`, a thread whose ring is from an older generation
+  // registers a new one
+  atomic_uint generation;
+  pthread_t flusher;
+} log_state;
+
+static _Thread_local log_ring_t *log_thread_ring;
+static _Thread_local unsigned log_thread_generation;
+
+static inline log_arg_t log_arg_int(int64_t v) { return (log_arg_t){ .kind = LOG_ARG_INT, .i = v }; }
+static inline log_arg_t log_arg_uint(uint64_t v) { return (log_arg_t){ .kind = LOG_ARG_UINT, .u = v }; }
+static inline log_arg_t log_arg_double(double v) { return (log_arg_t){ .kind = LOG_ARG_DOUBLE, .d = v }; }
+static inline log_arg_t log_arg_pointer(const void *v) { return (log_arg_t){ .kind = LOG_ARG_POINTER, .p = v }; }
+static inline log_arg_t log_arg_string(const char *v) { return (log_arg_t){ .kind = LOG_ARG_STRING, .s = v }; }
+
+#define LOG_ARG(x) _Generic((x),                                        \
+    float: log_arg_double,                                              \
+    double: log_arg_double,                                             \
+    char *: log_arg_string,                                             \
+    const char *: log_arg_string,                                       \
+    void *: log_arg_pointer,                                            \
+    const void *: log_arg_pointer,                                      \
+    unsigned char: log_arg_uint,                                        \
+    unsigned short: log_arg_uint,                                       \
+    unsigned int: log_arg_uint,                                         \
+    unsigned long: log_arg_uint,                                        \
+    unsigned long long: log_arg_uint,                                   \
+    default: log_arg_int)(x)
+
+// The format string is the first of the variadic arguments, so a call without
+// arguments is still valid C99 (`...` never ends up empty). Every argument is
+// followed by a comma and the array ends with an unused element, which keeps
+// the initializer from being empty.
+#define LOG_FORMAT(...) LOG_FORMAT_FIRST(__VA_ARGS__, unused)
+#define LOG_FORMAT_FIRST(format, ...) format
+#define LOG_ARGS_0(f)
+#define LOG_ARGS_1(f, a) LOG_ARG(a),
+#define LOG_ARGS_2(f, a, b) LOG_ARG(a), LOG_ARG(b),
+#define LOG_ARGS_3(f, a, b, c) LOG_ARG(a), LOG_ARG(b), LOG_ARG(c),
+#define LOG_ARGS_4(f, a, b, c, d) LOG_ARG(a), LOG_ARG(b), LOG_ARG(c), LOG_ARG(d),
+#define LOG_ARGS_PICK(f, _1, _2, _3, _4, name, ...) name
+#define LOG_ARGS(...) \
+  LOG_ARGS_PICK(__VA_ARGS__, LOG_ARGS_4, LOG_ARGS_3, LOG_ARGS_2, LOG_ARGS_1, LOG_ARGS_0, unused)(__VA_ARGS__)
+
+#define LOG_AT(p_level, ...) do {                                            \
+    if ((p_level) >= LOG_MIN_LEVEL) {                                        \
+      static const log_site_t log_site = {                                   \
+        (p_level), LOG_FORMAT(__VA_ARGS__), __func__, __FILE__, __LINE__     \
+      };                                                                     \
+      const log_arg_t log_args[] = { LOG_ARGS(__VA_ARGS__) log_arg_int(0) }; \
+      log_write(&log_site, log_args, sizeof(log_args) / sizeof(log_arg_t) - 1); \
+    }                                                                        \
+  } while (0)
+
+#define LOG_DEBUG(...) LOG_AT(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#define LOG_INFO(...) LOG_AT(LOG_LEVEL_INFO, __VA_ARGS__)
+#define LOG_WARNING(...) LOG_AT(LOG_LEVEL_WARNING, __VA_ARGS__)
+#define LOG_ERROR(...) LOG_AT(LOG_LEVEL_ERROR, __VA_ARGS__)
+
+static inline uint64_t log_now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// ---------------------------------------------------------------------------
+// Formatting, only ever done by the flusher (or when printing right away)
+// ---------------------------------------------------------------------------
+
+// printf with the arguments of a record. Every conversion is formatted on its
+// own, with the length modifier replaced by the one matching how the argument
+// was stored.
+static void log_format(const log_record_t *record, char *r_line, size_t size) {
+  const char *format = record->site->format;
+  size_t len = 0;
+  int arg = 0;
+
+  while (*format != '\0' && len + 1 < size) {
+    if (*format != '%') {
+      r_line[len++] = *format++;
+      continue;
+    }
+    if (format[1] == '%') {
+      r_line[len++] = '%';
+      format += 2;
+      continue;
+    }
+
+    // Flags, width and precision are kept, length modifiers are dropped
+    char spec[32];
+    size_t spec_len = 0;
+    spec[spec_len++] = *format++;
+    while (*format != '\0' && strchr("-+ #0123456789.*", *format) != NULL && spec_len < 24) {
+      spec[spec_len++] = *format++;
+    }
+    while (*format != '\0' && strchr("hlLqjzt", *format) != NULL) format++;
+    char conversion = *format;
+    if (conversion == '\0') break;
+    format++;
+
+    if (arg >= record->arg_count) {
+      len += snprintf(r_line + len, size - len, "<missing>");
+      continue;
+    }
+
+    int n = 0;
+    switch (record->kinds[arg]) {
+      case LOG_ARG_INT:
+      case LOG_ARG_UINT:
+        if (conversion == 'c') {
+          spec[spec_len++] = 'c';
+          spec[spec_len] = '\0';
+          n = snprintf(r_line + len, size - len, spec, (int)record->args[arg].i);
+        } else {
+          spec[spec_len++] = 'l';
+          spec[spec_len++] = 'l';
+          spec[spec_len++] = conversion;
+          spec[spec_len] = '\0';
+          n = record->kinds[arg] == LOG_ARG_INT
+            ? snprintf(r_line + len, size - len, spec, (long long)record->args[arg].i)
+            : snprintf(r_line + len, size - len, spec, (unsigned long long)record->args[arg].u);
+        }
+        break;
+      case LOG_ARG_DOUBLE:
+        spec[spec_len++] = conversion;
+        spec[spec_len] = '\0';
+        n = snprintf(r_line + len, size - len, spec, record->args[arg].d);
+        break;
+      case LOG_ARG_POINTER:
+        n = snprintf(r_line + len, size - len, "%p", record->args[arg].p);
+        break;
+      case LOG_ARG_STRING:
+        spec[spec_len++] = 's';
+        spec[spec_len] = '\0';
+        n = snprintf(r_line + len, size - len, spec, record->text + record->args[arg].text_offset);
+        break;
+    }
+    arg++;
+    if (n > 0) len += n;
+  }
+
+  if (len >= size) len = size - 1;
+  r_line[len] = '\0';
+}
+
+static void log_output(const log_record_t *record) {
+  char line[LOG_LINE_SIZE];
+  log_format(record, line, sizeof(line));
+
+  const log_site_t *site = record->site;
+  if (site->level == LOG_LEVEL_ERROR && log_state.print_error != NULL) {
+    log_state.print_error(line, site->function, site->file, site->line, true);
+  } else if (site->level == LOG_LEVEL_WARNING && log_state.print_warning != NULL) {
+    log_state.print_warning(line, site->function, site->file, site->line, false);
+  } else if (site->level >= LOG_LEVEL_WARNING) {
+    fprintf(stderr, "%s (%s:%d)\n", line, site->file, (int)site->line);
+  } else {
+    fputs(line, stdout);
+    fputc('\n', stdout);
+  }
+}
+
+// ---------------------------------------------------------------------------
+// Writing
+// ---------------------------------------------------------------------------
+
+static void log_fill_record(log_record_t *r_record, const log_site_t *site, const log_arg_t *args, int arg_count) {
+  r_record->site = site;
+  r_record->timestamp_ns = log_now_ns();
+  r_record->arg_count = arg_count < LOG_MAX_ARGS ? arg_count : LOG_MAX_ARGS;
+
+  uint32_t text_len = 0;
+  for (int i = 0; i < r_record->arg_count; i++) {
+    r_record->kinds[i] = args[i].kind;
+    if (args[i].kind != LOG_ARG_STRING) {
+      r_record->args[i].u = args[i].u;
+      continue;
+    }
+
+    // Long strings are cut off, the last string might end up empty
+    const char *s = args[i].s != NULL ? args[i].s : "(null)";
+    uint32_t room = LOG_TEXT_SIZE - text_len - 1;
+    uint32_t n = strnlen(s, room);
+    r_record->args[i].text_offset = text_len;
+    memcpy(r_record->text + text_len, s, n);
+    r_record->text[text_len + n] = '\0';
+    text_len += n + 1;
+    if (text_len > LOG_TEXT_SIZE - 1) text_len = LOG_TEXT_SIZE - 1;
+  }
+}
+
+static log_ring_t *log_register_thread() {
+  log_ring_t *ring = calloc(1, sizeof(log_ring_t));
+  if (ring == NULL) return NULL;
+  ring->thread_index = atomic_fetch_add(&log_state.thread_count, 1);
+
+  log_ring_t *head = atomic_load_explicit(&log_state.rings, memory_order_relaxed);
+  do {
+    ring->next = head;
+  } while (!atomic_compare_exchange_weak_explicit(&log_state.rings, &head, ring,
+                                                  memory_order_release,
+                                                  memory_order_relaxed));
+  log_thread_ring = ring;
+  log_thread_generation = atomic_load_explicit(&log_state.generation, memory_order_relaxed);
+  return ring;
+}
+
+static void log_write(const log_site_t *site, const log_arg_t *args, int arg_count) {
+  log_record_t record;
+  // Sequentially consistent, pairs with `log_stop` which clears `running`
+  // before it reads `writers`. Either we see `running` cleared or it sees us.
+  atomic_fetch_add(&log_state.writers, 1);
+  if (!atomic_load(&log_state.running)) {
+    atomic_fetch_sub(&log_state.writers, 1);
+    log_fill_record(&record, site, args, arg_count);
+    log_output(&record);
+    return;
+  }
+
+  log_ring_t *ring = log_thread_ring;
+  if (ring == NULL || log_thread_generation != atomic_load_explicit(&log_state.generation, memory_order_relaxed)) {
+    ring = log_register_thread();
+  }
+
+  unsigned head = ring != NULL ? atomic_load_explicit(&ring->head, memory_order_relaxed) : 0;
+  unsigned tail = ring != NULL ? atomic_load_explicit(&ring->tail, memory_order_acquire) : 0;
+  if (ring == NULL || head - tail == LOG_RING_SIZE) {
+    atomic_fetch_add_explicit(&log_state.dropped, 1, memory_order_relaxed);
+    atomic_fetch_sub_explicit(&log_state.writers, 1, memory_order_release);
+    if (site->level >= LOG_LEVEL_WARNING) {
+      log_fill_record(&record, site, args, arg_count);
+      log_output(&record);
+    }
+    return;
+  }
+
+  log_fill_record(&ring->records[head & (LOG_RING_SIZE - 1)], site, args, arg_count);
+  atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+  atomic_fetch_sub_explicit(&log_state.writers, 1, memory_order_release);
+}
+
+// ---------------------------------------------------------------------------
+// Flushing
+// ---------------------------------------------------------------------------
+
+static void log_drain() {
+  for (log_ring_t *ring = atomic_load_explicit(&log_state.rings, memory_order_acquire);
+       ring != NULL;
+       ring = ring->next) {
+    unsigned tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    unsigned head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    for (; tail != head; tail++) {
+      log_output(&ring->records[tail & (LOG_RING_SIZE - 1)]);
+    }
+    atomic_store_explicit(&ring->tail, tail, memory_order_release);
+  }
+
+  unsigned long dropped = atomic_exchange_explicit(&log_state.dropped, 0, memory_order_relaxed);
+  if (dropped > 0) {
+    fprintf(stderr, "log: %lu records dropped, a ring buffer was full\n", dropped);
+  }
+  fflush(stdout);
+}
+
+static void *log_flusher_main(void *userdata) {
+  const struct timespec interval = { .tv_sec = 0, .tv_nsec = LOG_FLUSH_INTERVAL_NS };
+  while (atomic_load_explicit(&log_state.running, memory_order_acquire)) {
+    log_drain();
+    nanosleep(&interval, NULL);
+  }
+  return NULL;
+}
+
+static void log_start(GDExtensionInterfaceGetProcAddress p_get_proc_address) {
+  log_state.print_error = (void *)p_get_proc_address("print_error");
+  log_state.print_warning = (void *)p_get_proc_address("print_warning");
+
+  atomic_store(&log_state.running, true);
+  if (pthread_create(&log_state.flusher, NULL, log_flusher_main, NULL) != 0) {
+    atomic_store(&log_state.running, false);
+    fprintf(stderr, "log: can't start the flusher thread, logging synchronously\n");
+  }
+}
+
+// Stops the flusher, waits for writes that are still in progress, prints
+// what's left in the rings and frees them. Threads that log after this print
+// right away.
+static void log_stop() {
+  if (!atomic_exchange(&log_state.running, false)) return;
+  pthread_join(log_state.flusher, NULL);
+
+  const struct timespec pause = { .tv_sec = 0, .tv_nsec = 1000 };
+  while (atomic_load(&log_state.writers) != 0) {
+    nanosleep(&pause, NULL);
+  }
+  log_drain();
+
+  log_ring_t *ring = atomic_exchange(&log_state.rings, NULL);
+  while (ring != NULL) {
+    log_ring_t *next = ring->next;
+    free(ring);
+    ring = next;
+  }
+  atomic_store(&log_state.thread_count, 0);
+  atomic_fetch_add(&log_state.generation, 1);
+}
+
+#endif
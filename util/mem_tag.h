@@ -0,0 +1,347 @@
+#ifndef MEM_TAG_H
+#define MEM_TAG_H
+
+// Tagged allocations with per-tag accounting and budgets.
+//
+// Every allocation names a tag, usually one per class or subsystem
+// ("MyCustomNode", "property_list", "trail"...). A tag counts the bytes it
+// holds now and at most, how many allocations are alive and how many it made
+// per second. The memory comes from a backend: Godot's `mem_alloc` by default,
+// so it shows up in Godot's static memory monitor, or libc, or anything
+// with the same three functions.
+//
+// Usage:
+//
+//   static mem_tag_t trail_tag = MEM_TAG("trail", 256 * 1024, MEM_BUDGET_REFUSE);
+//
+//   mem_tag_init(p_get_proc_address); // in godot_entry
+//   double *p = mem_tag_alloc(&trail_tag, 64 * sizeof(double));
+//   p = mem_tag_realloc(p, 128 * sizeof(double));
+//   mem_tag_free(p);
+//   ...
+//   mem_tag_sample(); // once per frame, closes the rate window every second
+//   mem_tag_report(stdout);
+//
+// A tag with a budget warns on stderr when an allocation takes it over, once
+// until it's back under. With MEM_BUDGET_REFUSE the allocation fails instead
+// and returns NULL, so a system can't grow past its share.
+//
+// Instance structs and other fixed-size things that come and go often can
+// use a `mem_pool_t`. It takes chunks from its tag and keeps freed elements
+// for reuse, the tag counts the chunks as bytes and the elements as
+// allocations.
+//
+// NOTE: Each allocation carries a MEM_TAG_HEADER_SIZE header with its tag and
+// size, so `mem_tag_free` needs no tag and the result stays 16-byte aligned.
+// Memory from `mem_tag_alloc` must go back through `mem_tag_free`.
+//
+// NOTE: Tags and pools can be used from any thread. The counters are
+// atomics and a budget is reserved before the memory is allocated, so
+// threads allocating together can't overshoot a refusing budget. Pools take
+// a lock, they are for things that come and go at node rather than at frame
+// rate. Switch the backend with `mem_tag_use_backend` only while nothing is
+// allocated.
+
+#include "../godot-headers/gdextension_interface.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define MEM_TAG_HEADER_SIZE (16)
+#define MEM_TAG_RATE_WINDOW_NS (1000000000ull)
+#define MEM_POOL_CHUNK_ELEMENTS (64)
+
+typedef enum {
+  MEM_BUDGET_WARN,
+  MEM_BUDGET_REFUSE,
+} mem_budget_policy_t;
+
+typedef struct mem_tag {
+  const char *name;
+  // 0 means no budget
+  size_t budget_bytes;
+  mem_budget_policy_t policy;
+
+  atomic_size_t bytes;
+  atomic_size_t peak_bytes;
+  atomic_size_t live;
+  atomic_uint_least64_t allocations;
+  atomic_uint_least64_t refused;
+  atomic_bool over_budget;
+
+  // Allocations per second over the last whole window, and the highest seen.
+  // Only the thread that closes a window writes them.
+  uint64_t window_allocations;
+  _Atomic double rate;
+  _Atomic double peak_rate;
+
+  // Tags link themselves in on their first allocation
+  atomic_bool registered;
+  struct mem_tag *next;
+} mem_tag_t;
+
+#define MEM_TAG(tag_name, budget, budget_policy) { .name = (tag_name), .budget_bytes = (budget), .policy = (budget_policy) }
+
+typedef struct {
+  const char *name;
+  void *(*alloc)(size_t p_bytes);
+  void *(*realloc)(void *p_ptr, size_t p_bytes);
+  void (*free)(void *p_ptr);
+} mem_backend_t;
+
+typedef struct {
+  mem_tag_t *tag;
+  size_t size;
+} mem_tag_header_t;
+
+_Static_assert(sizeof(mem_tag_header_t) <= MEM_TAG_HEADER_SIZE, "mem_tag_header_t has to fit the header");
+
+static const mem_backend_t mem_backend_libc = {
+  .name = "libc",
+  .alloc = malloc,
+  .realloc = realloc,
+  .free = free,
+};
+
+static mem_backend_t mem_backend_godot = { .name = "godot" };
+
+static const mem_backend_t *mem_tag_backend = &mem_backend_libc;
+static mem_tag_t *_Atomic mem_tag_list = NULL;
+static _Atomic uint64_t mem_tag_window_start_ns = 0;
+
+static inline uint64_t mem_tag_now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// Uses Godot's allocator when the interface has one, libc otherwise
+static void mem_tag_init(GDExtensionInterfaceGetProcAddress p_get_proc_address) {
+  mem_backend_godot.alloc = (void *)p_get_proc_address("mem_alloc");
+  mem_backend_godot.realloc = (void *)p_get_proc_address("mem_realloc");
+  mem_backend_godot.free = (void *)p_get_proc_address("mem_free");
+  if (mem_backend_godot.alloc != NULL && mem_backend_godot.realloc != NULL && mem_backend_godot.free != NULL) {
+    mem_tag_backend = &mem_backend_godot;
+  }
+  mem_tag_window_start_ns = mem_tag_now_ns();
+}
+
+static inline void mem_tag_use_backend(const mem_backend_t *backend) {
+  mem_tag_backend = backend;
+}
+
+static inline void mem_tag_register(mem_tag_t *tag) {
+  if (atomic_load_explicit(&tag->registered, memory_order_relaxed)) return;
+  if (atomic_exchange_explicit(&tag->registered, true, memory_order_relaxed)) return;
+  tag->next = atomic_load_explicit(&mem_tag_list, memory_order_relaxed);
+  while (!atomic_compare_exchange_weak_explicit(&mem_tag_list, &tag->next, tag,
+                                                memory_order_release, memory_order_relaxed)) {
+  }
+}
+
+// Reserves `grow` more bytes for `tag`. Warns or refuses when that takes it
+// over its budget, a refused reservation is given back right away.
+static inline bool mem_tag_reserve(mem_tag_t *tag, size_t grow) {
+  mem_tag_register(tag);
+  size_t bytes = atomic_fetch_add_explicit(&tag->bytes, grow, memory_order_relaxed) + grow;
+  if (tag->budget_bytes == 0 || bytes <= tag->budget_bytes) {
+    if (atomic_load_explicit(&tag->over_budget, memory_order_relaxed)) {
+      atomic_store_explicit(&tag->over_budget, false, memory_order_relaxed);
+    }
+  } else if (tag->policy == MEM_BUDGET_REFUSE) {
+    atomic_fetch_sub_explicit(&tag->bytes, grow, memory_order_relaxed);
+    atomic_fetch_add_explicit(&tag->refused, 1, memory_order_relaxed);
+    return false;
+  } else if (!atomic_exchange_explicit(&tag->over_budget, true, memory_order_relaxed)) {
+    fprintf(stderr, "mem_tag %s: %zu bytes are over the budget of %zu bytes\n",
+            tag->name, bytes, tag->budget_bytes);
+  }
+
+  size_t peak = atomic_load_explicit(&tag->peak_bytes, memory_order_relaxed);
+  while (bytes > peak && !atomic_compare_exchange_weak_explicit(&tag->peak_bytes, &peak, bytes,
+                                                                memory_order_relaxed, memory_order_relaxed)) {
+  }
+  return true;
+}
+
+static inline void *mem_tag_alloc(mem_tag_t *tag, size_t size) {
+  if (!mem_tag_reserve(tag, size)) return NULL;
+  mem_tag_header_t *header = mem_tag_backend->alloc(MEM_TAG_HEADER_SIZE + size);
+  if (header == NULL) {
+    atomic_fetch_sub_explicit(&tag->bytes, size, memory_order_relaxed);
+    return NULL;
+  }
+
+  header->tag = tag;
+  header->size = size;
+  atomic_fetch_add_explicit(&tag->live, 1, memory_order_relaxed);
+  atomic_fetch_add_explicit(&tag->allocations, 1, memory_order_relaxed);
+  return (unsigned char *)header + MEM_TAG_HEADER_SIZE;
+}
+
+static inline mem_tag_header_t *mem_tag_header(void *p) {
+  return (mem_tag_header_t *)((unsigned char *)p - MEM_TAG_HEADER_SIZE);
+}
+
+static inline void mem_tag_free(void *p) {
+  if (p == NULL) return;
+  mem_tag_header_t *header = mem_tag_header(p);
+  atomic_fetch_sub_explicit(&header->tag->bytes, header->size, memory_order_relaxed);
+  atomic_fetch_sub_explicit(&header->tag->live, 1, memory_order_relaxed);
+  mem_tag_backend->free(header);
+}
+
+// Like realloc, the old block is kept when this fails. A realloc counts as an
+// allocation for the rate, since that's what it costs.
+static inline void *mem_tag_realloc(void *p, size_t size) {
+  if (p == NULL) return NULL;
+  mem_tag_header_t *header = mem_tag_header(p);
+  mem_tag_t *tag = header->tag;
+  size_t old_size = header->size;
+  if (size > old_size && !mem_tag_reserve(tag, size - old_size)) return NULL;
+
+  mem_tag_header_t *moved = mem_tag_backend->realloc(header, MEM_TAG_HEADER_SIZE + size);
+  if (moved == NULL) {
+    if (size > old_size) atomic_fetch_sub_explicit(&tag->bytes, size - old_size, memory_order_relaxed);
+    return NULL;
+  }
+
+  moved->size = size;
+  if (size < old_size) atomic_fetch_sub_explicit(&tag->bytes, old_size - size, memory_order_relaxed);
+  atomic_fetch_add_explicit(&tag->allocations, 1, memory_order_relaxed);
+  return (unsigned char *)moved + MEM_TAG_HEADER_SIZE;
+}
+
+static inline size_t mem_tag_size(void *p) {
+  return mem_tag_header(p)->size;
+}
+
+// Closes the rate window once it's MEM_TAG_RATE_WINDOW_NS old. Cheap enough to
+// call every frame, rates only change once per window. When threads sample
+// together, the one that moves the window start closes the window.
+static inline void mem_tag_sample() {
+  uint64_t now = mem_tag_now_ns();
+  uint64_t start = atomic_load_explicit(&mem_tag_window_start_ns, memory_order_acquire);
+  uint64_t elapsed = now - start;
+  if (elapsed < MEM_TAG_RATE_WINDOW_NS) return;
+  if (!atomic_compare_exchange_strong_explicit(&mem_tag_window_start_ns, &start, now,
+                                               memory_order_acq_rel, memory_order_acquire)) {
+    return;
+  }
+
+  mem_tag_t *tag = atomic_load_explicit(&mem_tag_list, memory_order_acquire);
+  for (; tag != NULL; tag = tag->next) {
+    uint64_t allocations = atomic_load_explicit(&tag->allocations, memory_order_relaxed);
+    double rate = (double)(allocations - tag->window_allocations) * 1e9 / (double)elapsed;
+    tag->window_allocations = allocations;
+    atomic_store_explicit(&tag->rate, rate, memory_order_relaxed);
+    if (rate > atomic_load_explicit(&tag->peak_rate, memory_order_relaxed)) {
+      atomic_store_explicit(&tag->peak_rate, rate, memory_order_relaxed);
+    }
+  }
+}
+
+static inline void mem_tag_report(FILE *out) {
+  fprintf(out, "%-16s %12s %12s %8s %10s %10s %12s %8s  (%s)\n",
+          "tag", "bytes", "peak", "live", "allocs/s", "peak/s", "budget", "refused",
+          mem_tag_backend->name);
+  mem_tag_t *tag = atomic_load_explicit(&mem_tag_list, memory_order_acquire);
+  for (; tag != NULL; tag = tag->next) {
+    fprintf(out, "%-16s %12zu %12zu %8zu %10.0f %10.0f ",
+            tag->name,
+            atomic_load_explicit(&tag->bytes, memory_order_relaxed),
+            atomic_load_explicit(&tag->peak_bytes, memory_order_relaxed),
+            atomic_load_explicit(&tag->live, memory_order_relaxed),
+            atomic_load_explicit(&tag->rate, memory_order_relaxed),
+            atomic_load_explicit(&tag->peak_rate, memory_order_relaxed));
+    if (tag->budget_bytes > 0) {
+      fprintf(out, "%12zu %8llu\n", tag->budget_bytes,
+              (unsigned long long)atomic_load_explicit(&tag->refused, memory_order_relaxed));
+    } else {
+      fprintf(out, "%12s %8s\n", "-", "-");
+    }
+  }
+}
+
+typedef struct mem_pool_chunk {
+  struct mem_pool_chunk *next;
+  _Alignas(16) unsigned char data[];
+} mem_pool_chunk_t;
+
+typedef struct {
+  mem_tag_t *tag;
+  size_t element_size;
+  pthread_mutex_t lock;
+  mem_pool_chunk_t *chunks;
+  // Freed elements, linked through their first bytes
+  void *free_list;
+} mem_pool_t;
+
+static inline void mem_pool_init(mem_pool_t *pool, mem_tag_t *tag, size_t element_size) {
+  *pool = (mem_pool_t){
+    .tag = tag,
+    // Room for the free list link and keeps every element 16-byte aligned
+    .element_size = (element_size + 15) & ~(size_t)15,
+  };
+  pthread_mutex_init(&pool->lock, NULL);
+}
+
+static inline void *mem_pool_alloc(mem_pool_t *pool) {
+  pthread_mutex_lock(&pool->lock);
+  if (pool->free_list == NULL) {
+    mem_pool_chunk_t *chunk = mem_tag_alloc(pool->tag, sizeof(mem_pool_chunk_t) + MEM_POOL_CHUNK_ELEMENTS * pool->element_size);
+    if (chunk == NULL) {
+      pthread_mutex_unlock(&pool->lock);
+      return NULL;
+    }
+    // The chunk's bytes stay with the tag, its elements are counted one by one
+    atomic_fetch_sub_explicit(&pool->tag->live, 1, memory_order_relaxed);
+    atomic_fetch_sub_explicit(&pool->tag->allocations, 1, memory_order_relaxed);
+
+    chunk->next = pool->chunks;
+    pool->chunks = chunk;
+    for (size_t i = MEM_POOL_CHUNK_ELEMENTS; i > 0; i--) {
+      void *element = chunk->data + (i - 1) * pool->element_size;
+      *(void **)element = pool->free_list;
+      pool->free_list = element;
+    }
+  }
+
+  void *res = pool->free_list;
+  pool->free_list = *(void **)res;
+  pthread_mutex_unlock(&pool->lock);
+  atomic_fetch_add_explicit(&pool->tag->live, 1, memory_order_relaxed);
+  atomic_fetch_add_explicit(&pool->tag->allocations, 1, memory_order_relaxed);
+  return res;
+}
+
+static inline void mem_pool_free(mem_pool_t *pool, void *p) {
+  if (p == NULL) return;
+  pthread_mutex_lock(&pool->lock);
+  *(void **)p = pool->free_list;
+  pool->free_list = p;
+  pthread_mutex_unlock(&pool->lock);
+  atomic_fetch_sub_explicit(&pool->tag->live, 1, memory_order_relaxed);
+}
+
+// Gives the chunks back, every element has to be freed by now
+static inline void mem_pool_destroy(mem_pool_t *pool) {
+  mem_pool_chunk_t *chunk = pool->chunks;
+  while (chunk != NULL) {
+    mem_pool_chunk_t *next = chunk->next;
+    // mem_tag_free takes one off live for the chunk, which never counted
+    atomic_fetch_add_explicit(&pool->tag->live, 1, memory_order_relaxed);
+    mem_tag_free(chunk);
+    chunk = next;
+  }
+  pool->chunks = NULL;
+  pool->free_list = NULL;
+  pthread_mutex_destroy(&pool->lock);
+}
+
+#endif
@@ -0,0 +1,298 @@
+#ifndef OBJECT_HANDLE_H
+#define OBJECT_HANDLE_H
+
+// Generation-checked handles to Godot objects and the native structs behind
+// them.
+//
+// A raw `GDExtensionObjectPtr` dangles as soon as the object is freed, and
+// `object_get_instance_from_id` is an interface call plus a lookup in
+// Godot's object database on every access. A handle is a slot index and the
+// generation of the slot when the handle was made, packed into 64 bits:
+//
+//   object_handle_t handle = object_handle_bind(object, my_instance);
+//   ...
+//   my_custom_class_t *instance = object_handle_get(handle); // NULL once freed
+//
+// Binding also gives the object an instance binding. Godot calls its free
+// callback when the object is freed, which frees the slot and bumps its
+// generation, so every handle to it stops resolving without us having to
+// track lifetimes. Lookups are a couple of loads and no interface calls, from
+// any thread.
+//
+// Usage:
+//
+//   object_handle_init(p_get_proc_address); // in godot_entry
+//   object_handle_t handle = object_handle_bind(object, instance);
+//   void *instance = object_handle_get(handle);
+//   object_handle_release(handle); // in free_instance_func, see below
+//   object_handle_deinit(); // on deinitialization
+//
+// NOTE: Godot frees an extension class instance before it calls the free
+// callbacks of the object's instance bindings. Classes that bind their own
+// instance struct should call `object_handle_release` in their
+// `free_instance_func` before freeing the struct, otherwise a lookup on
+// another thread can still return it in between.
+//
+// NOTE: A lookup tells you the object was alive when you asked. Nothing stops
+// the main thread from freeing it while a worker uses the result, so jobs
+// that hold instances should finish before the main thread frees objects (for
+// example within a frame), the same as with any other pointer.
+//
+// NOTE: Generations are 32 bits. A handle kept through 2^31 reuses of its
+// slot would resolve again, which is far beyond any real lifetime.
+
+#include "../godot-headers/gdextension_interface.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define OBJECT_HANDLE_PAGE_BITS (10)
+#define OBJECT_HANDLE_PAGE_SIZE (1u << OBJECT_HANDLE_PAGE_BITS)
+// Pages are never moved or freed while the table is in use, which is what
+// makes lock-free lookups possible. 1024 pages are ~1M live objects.
+#define OBJECT_HANDLE_MAX_PAGES (1024)
+#define OBJECT_HANDLE_NULL ((object_handle_t)0)
+#define OBJECT_HANDLE_NO_FREE_SLOT (UINT32_MAX)
+
+typedef uint64_t object_handle_t;
+
+typedef struct {
+  // Odd while handles resolve, so a generation of 0 (and the null handle)
+  // never does
+  _Atomic uint32_t generation;
+  uint32_t next_free;
+  void *_Atomic instance;
+  _Atomic GDObjectInstanceID instance_id;
+  // Only touched under the lock. Set from binding until the object is freed,
+  // also while the slot is released by hand.
+  GDExtensionObjectPtr object;
+} object_handle_slot_t;
+
+static struct {
+  struct {
+    GDExtensionInterfaceObjectGetInstanceId object_get_instance_id;
+    GDExtensionInterfaceObjectGetInstanceBinding object_get_instance_binding;
+  } interface;
+
+  object_handle_slot_t *_Atomic pages[OBJECT_HANDLE_MAX_PAGES];
+  uint32_t page_count;
+  uint32_t first_free;
+  _Atomic uint32_t live_count;
+  // The instance `object_handle_bind` is binding, for the create callback
+  void *pending_instance;
+  pthread_mutex_t lock;
+} object_handle = {
+  .first_free = OBJECT_HANDLE_NO_FREE_SLOT,
+  .lock = PTHREAD_MUTEX_INITIALIZER,
+};
+
+#define OBJECT_HANDLE_STORE_INTERFACE(name) \
+  object_handle.interface.name = (void *)p_get_proc_address(#name);
+
+static void object_handle_init(GDExtensionInterfaceGetProcAddress p_get_proc_address) {
+  OBJECT_HANDLE_STORE_INTERFACE(object_get_instance_id);
+  OBJECT_HANDLE_STORE_INTERFACE(object_get_instance_binding);
+}
+
+static inline uint32_t object_handle_index(object_handle_t p_handle) {
+  return (uint32_t)p_handle;
+}
+
+static inline uint32_t object_handle_generation(object_handle_t p_handle) {
+  return (uint32_t)(p_handle >> 32);
+}
+
+static inline object_handle_slot_t *object_handle_slot(uint32_t p_index) {
+  uint32_t page = p_index >> OBJECT_HANDLE_PAGE_BITS;
+  if (page >= OBJECT_HANDLE_MAX_PAGES) return NULL;
+  object_handle_slot_t *slots = atomic_load_explicit(&object_handle.pages[page], memory_order_acquire);
+  return slots == NULL ? NULL : &slots[p_index & (OBJECT_HANDLE_PAGE_SIZE - 1)];
+}
+
+// Our bindings are keyed by the table itself, so they don't collide with
+// bindings the library or other languages make
+#define OBJECT_HANDLE_TOKEN ((void *)&object_handle)
+
+// Called with the lock held
+static uint32_t object_handle_take_slot(void) {
+  if (object_handle.first_free == OBJECT_HANDLE_NO_FREE_SLOT) {
+    if (object_handle.page_count == OBJECT_HANDLE_MAX_PAGES) return OBJECT_HANDLE_NO_FREE_SLOT;
+
+    object_handle_slot_t *slots = calloc(OBJECT_HANDLE_PAGE_SIZE, sizeof(object_handle_slot_t));
+    uint32_t base = object_handle.page_count << OBJECT_HANDLE_PAGE_BITS;
+    for (uint32_t i = 0; i < OBJECT_HANDLE_PAGE_SIZE; i++) {
+      slots[i].next_free = i + 1 < OBJECT_HANDLE_PAGE_SIZE ? base + i + 1 : OBJECT_HANDLE_NO_FREE_SLOT;
+    }
+    atomic_store_explicit(&object_handle.pages[object_handle.page_count], slots, memory_order_release);
+    object_handle.page_count++;
+    object_handle.first_free = base;
+  }
+
+  uint32_t index = object_handle.first_free;
+  object_handle.first_free = object_handle_slot(index)->next_free;
+  return index;
+}
+
+// Called with the lock held. The fields are published to lookups by the
+// release store of the new (odd) generation.
+static uint32_t object_handle_activate(object_handle_slot_t *slot, void *p_instance) {
+  atomic_store_explicit(&slot->instance, p_instance, memory_order_relaxed);
+  atomic_store_explicit(&slot->instance_id, object_handle.interface.object_get_instance_id(slot->object),
+                        memory_order_relaxed);
+  uint32_t generation = atomic_load_explicit(&slot->generation, memory_order_relaxed) + 1;
+  atomic_store_explicit(&slot->generation, generation, memory_order_release);
+  atomic_fetch_add_explicit(&object_handle.live_count, 1, memory_order_relaxed);
+  return generation;
+}
+
+// Called with the lock held. The new generation goes out first, lookups that
+// still read the old instance see it changed when they check again.
+static void object_handle_deactivate(object_handle_slot_t *slot) {
+  uint32_t generation = atomic_load_explicit(&slot->generation, memory_order_relaxed);
+  if ((generation & 1) == 0) return;
+
+  atomic_store_explicit(&slot->generation, generation + 1, memory_order_relaxed);
+  atomic_thread_fence(memory_order_release);
+  atomic_store_explicit(&slot->instance, NULL, memory_order_relaxed);
+  atomic_store_explicit(&slot->instance_id, 0, memory_order_relaxed);
+  atomic_fetch_sub_explicit(&object_handle.live_count, 1, memory_order_relaxed);
+}
+
+// Bindings are `index + 1`, so that slot 0 isn't a NULL binding. Godot only
+// calls this from `object_get_instance_binding` in `object_handle_bind`,
+// which holds the lock.
+static void *object_handle_binding_create(void *p_token, void *p_instance) {
+  uint32_t index = object_handle_take_slot();
+  if (index == OBJECT_HANDLE_NO_FREE_SLOT) return NULL;
+
+  object_handle_slot_t *slot = object_handle_slot(index);
+  slot->object = p_instance;
+  object_handle_activate(slot, object_handle.pending_instance);
+  return (void *)((uintptr_t)index + 1);
+}
+
+// The object is being freed: the slot goes back to the free list, even if
+// it was already released by hand
+static void object_handle_binding_free(void *p_token, void *p_instance, void *p_binding) {
+  if (p_binding == NULL) return;
+
+  pthread_mutex_lock(&object_handle.lock);
+  uint32_t index = (uint32_t)((uintptr_t)p_binding - 1);
+  object_handle_slot_t *slot = object_handle_slot(index);
+  if (slot != NULL && slot->object == p_instance) {
+    object_handle_deactivate(slot);
+    slot->object = NULL;
+    slot->next_free = object_handle.first_free;
+    object_handle.first_free = index;
+  }
+  pthread_mutex_unlock(&object_handle.lock);
+}
+
+static GDExtensionBool object_handle_binding_reference(void *p_token, void *p_binding, GDExtensionBool p_reference) {
+  return true;
+}
+
+static const GDExtensionInstanceBindingCallbacks object_handle_binding_callbacks = {
+  .create_callback = object_handle_binding_create,
+  .free_callback = object_handle_binding_free,
+  .reference_callback = object_handle_binding_reference,
+};
+
+// Returns the object's handle, making one the first time. `p_instance` is
+// what lookups return, usually the native instance struct or the object
+// itself. Returns OBJECT_HANDLE_NULL when the table is full.
+//
+// NOTE: Goes through `object_get_instance_binding` and its create callback
+// rather than `object_set_instance_binding`, which only allows one binding
+// per object and would clash with the library's or another language's.
+static object_handle_t object_handle_bind(GDExtensionObjectPtr p_object, void *p_instance) {
+  pthread_mutex_lock(&object_handle.lock);
+
+  object_handle.pending_instance = p_instance;
+  void *binding = object_handle.interface.object_get_instance_binding(p_object, OBJECT_HANDLE_TOKEN,
+                                                                      &object_handle_binding_callbacks);
+  object_handle.pending_instance = NULL;
+  if (binding == NULL) {
+    pthread_mutex_unlock(&object_handle.lock);
+    return OBJECT_HANDLE_NULL;
+  }
+
+  uint32_t index = (uint32_t)((uintptr_t)binding - 1);
+  object_handle_slot_t *slot = object_handle_slot(index);
+  uint32_t generation = atomic_load_explicit(&slot->generation, memory_order_relaxed);
+  // Released by hand earlier, the slot waited for the object to come back
+  if ((generation & 1) == 0) {
+    generation = object_handle_activate(slot, p_instance);
+  }
+
+  pthread_mutex_unlock(&object_handle.lock);
+  return ((object_handle_t)generation << 32) | index;
+}
+
+// Invalidates every handle to the object now, instead of when Godot frees it.
+// The slot stays with the object until then, binding it again makes a new
+// handle.
+static void object_handle_release(object_handle_t p_handle) {
+  object_handle_slot_t *slot = object_handle_slot(object_handle_index(p_handle));
+  if (slot == NULL) return;
+
+  pthread_mutex_lock(&object_handle.lock);
+  if (atomic_load_explicit(&slot->generation, memory_order_relaxed) == object_handle_generation(p_handle)) {
+    object_handle_deactivate(slot);
+  }
+  pthread_mutex_unlock(&object_handle.lock);
+}
+
+// Seqlock-style read: the instance only counts if the generation is the
+// handle's before and after reading it
+static inline void *object_handle_get(object_handle_t p_handle) {
+  object_handle_slot_t *slot = object_handle_slot(object_handle_index(p_handle));
+  if (slot == NULL) return NULL;
+
+  uint32_t generation = object_handle_generation(p_handle);
+  if (atomic_load_explicit(&slot->generation, memory_order_acquire) != generation) return NULL;
+  void *res = atomic_load_explicit(&slot->instance, memory_order_relaxed);
+  atomic_thread_fence(memory_order_acquire);
+  if (atomic_load_explicit(&slot->generation, memory_order_relaxed) != generation) return NULL;
+  return res;
+}
+
+static inline bool object_handle_is_valid(object_handle_t p_handle) {
+  return object_handle_get(p_handle) != NULL;
+}
+
+// 0 once the object is gone. Hand it to `object_get_instance_from_id` when you
+// need the object itself on the main thread.
+static inline GDObjectInstanceID object_handle_get_instance_id(object_handle_t p_handle) {
+  object_handle_slot_t *slot = object_handle_slot(object_handle_index(p_handle));
+  if (slot == NULL) return 0;
+
+  uint32_t generation = object_handle_generation(p_handle);
+  if (atomic_load_explicit(&slot->generation, memory_order_acquire) != generation) return 0;
+  GDObjectInstanceID res = atomic_load_explicit(&slot->instance_id, memory_order_relaxed);
+  atomic_thread_fence(memory_order_acquire);
+  if (atomic_load_explicit(&slot->generation, memory_order_relaxed) != generation) return 0;
+  return res;
+}
+
+static inline uint32_t object_handle_live_count(void) {
+  return atomic_load_explicit(&object_handle.live_count, memory_order_relaxed);
+}
+
+// Frees the pages. Only call it when nothing looks up handles anymore and
+// every bound object is gone, their binding free callbacks come back here.
+static void object_handle_deinit(void) {
+  pthread_mutex_lock(&object_handle.lock);
+  for (uint32_t i = 0; i < object_handle.page_count; i++) {
+    free(atomic_load_explicit(&object_handle.pages[i], memory_order_relaxed));
+    atomic_store_explicit(&object_handle.pages[i], NULL, memory_order_relaxed);
+  }
+  object_handle.page_count = 0;
+  object_handle.first_free = OBJECT_HANDLE_NO_FREE_SLOT;
+  atomic_store_explicit(&object_handle.live_count, 0, memory_order_relaxed);
+  pthread_mutex_unlock(&object_handle.lock);
+}
+
+#endif
@@ -0,0 +1,187 @@
+#ifndef RID_STORAGE_H
+#define RID_STORAGE_H
+
+// Dense storage addressed by RIDs, the way Godot's servers keep their
+// resources (RID_Owner).
+//
+// The storage only hands out ids and tracks where each one lives. The data
+// itself sits in the caller's arrays, one per component, indexed by the
+// dense index. Live entries are always packed into [0, count), so batch
+// processing is a loop over plain arrays. Freeing moves the last entry into
+// the hole, and the caller moves its components the same way.
+//
+// A RID is `generation << 32 | slot`. The slot finds the dense index, and
+// the generation goes up every time the slot is freed, so a freed RID stays
+// invalid when the slot is reused. Generations start at 1, which keeps 0
+// free to mean "no RID", same as in Godot. The value fits the uint64_t that
+// RID Variants hold and that `get_rid_func` returns.
+//
+// Usage:
+//
+//   rid_storage_t storage;
+//   rid_storage_init(&storage);
+//   ...
+//   if (storage.count == storage.capacity) {
+//     rid_storage_reserve(&storage, capacity * 2); // grow the components too
+//   }
+//   uint32_t index;
+//   uint64_t rid = rid_storage_make(&storage, &index);
+//   positions[index] = ...;
+//   ...
+//   uint32_t index = rid_storage_index(&storage, rid); // RID_STORAGE_INVALID if stale
+//   ...
+//   uint32_t moved_from;
+//   uint32_t index = rid_storage_free(&storage, rid, &moved_from);
+//   if (index != RID_STORAGE_INVALID && index != moved_from) positions[index] = positions[moved_from];
+//   ...
+//   rid_storage_destroy(&storage);
+//
+// NOTE: A RID only means something to the storage that made it. Passing a
+// RID from RenderingServer usually gives RID_STORAGE_INVALID, but a RID from
+// another storage may well look valid.
+//
+// NOTE: The storage isn't thread safe. Reading components from several
+// threads is fine as long as nothing is made or freed meanwhile.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define RID_STORAGE_INVALID (UINT32_MAX)
+// What the storage itself costs per entry of capacity
+#define RID_STORAGE_BYTES_PER_ENTRY (3 * sizeof(uint32_t))
+
+typedef struct {
+  // Slot -> dense index while the slot is in use, next free slot otherwise
+  uint32_t *slots;
+  // Slot -> generation of the RID it hands out next or handed out last
+  uint32_t *generations;
+  // Dense index -> slot
+  uint32_t *owners;
+  // Live entries, packed into [0, count)
+  uint32_t count;
+  uint32_t capacity;
+  // Slots that were ever used, all of them below `capacity`
+  uint32_t slot_count;
+  uint32_t free_slot;
+} rid_storage_t;
+
+static inline void rid_storage_init(rid_storage_t *storage) {
+  storage->slots = NULL;
+  storage->generations = NULL;
+  storage->owners = NULL;
+  storage->count = 0;
+  storage->capacity = 0;
+  storage->slot_count = 0;
+  storage->free_slot = RID_STORAGE_INVALID;
+}
+
+static inline uint64_t rid_storage_make_rid(uint32_t generation, uint32_t slot) {
+  return ((uint64_t)generation << 32) | slot;
+}
+
+// Capacity never shrinks. Returns false when out of memory, the storage is
+// left as it was.
+static inline bool rid_storage_reserve(rid_storage_t *storage, uint32_t capacity) {
+  if (capacity <= storage->capacity) return true;
+  if (capacity == RID_STORAGE_INVALID) return false;
+
+  uint32_t *slots = realloc(storage->slots, capacity * sizeof(uint32_t));
+  if (slots == NULL) return false;
+  storage->slots = slots;
+  uint32_t *generations = realloc(storage->generations, capacity * sizeof(uint32_t));
+  if (generations == NULL) return false;
+  storage->generations = generations;
+  uint32_t *owners = realloc(storage->owners, capacity * sizeof(uint32_t));
+  if (owners == NULL) return false;
+  storage->owners = owners;
+
+  storage->capacity = capacity;
+  return true;
+}
+
+// Returns 0 when the storage is full, `rid_storage_reserve` first. The
+// new entry is always the last one, `*r_index == count - 1`.
+static inline uint64_t rid_storage_make(rid_storage_t *storage, uint32_t *r_index) {
+  if (storage->count == storage->capacity) return 0;
+
+  uint32_t slot;
+  if (storage->free_slot != RID_STORAGE_INVALID) {
+    slot = storage->free_slot;
+    storage->free_slot = storage->slots[slot];
+  } else {
+    slot = storage->slot_count++;
+    storage->generations[slot] = 1;
+  }
+
+  uint32_t index = storage->count++;
+  storage->slots[slot] = index;
+  storage->owners[index] = slot;
+  if (r_index != NULL) *r_index = index;
+  return rid_storage_make_rid(storage->generations[slot], slot);
+}
+
+static inline uint32_t rid_storage_index(const rid_storage_t *storage, uint64_t rid) {
+  uint32_t slot = (uint32_t)rid;
+  uint32_t generation = (uint32_t)(rid >> 32);
+  if (slot >= storage->slot_count || storage->generations[slot] != generation) {
+    return RID_STORAGE_INVALID;
+  }
+  // A free slot keeps its generation until it's reused, and its link in
+  // `slots` can be any number. Only a live slot owns its dense index.
+  uint32_t index = storage->slots[slot];
+  if (index >= storage->count || storage->owners[index] != slot) return RID_STORAGE_INVALID;
+  return index;
+}
+
+static inline bool rid_storage_owns(const rid_storage_t *storage, uint64_t rid) {
+  return rid_storage_index(storage, rid) != RID_STORAGE_INVALID;
+}
+
+// The RID of the entry at `index`, for walking the dense arrays
+static inline uint64_t rid_storage_get_rid(const rid_storage_t *storage, uint32_t index) {
+  uint32_t slot = storage->owners[index];
+  return rid_storage_make_rid(storage->generations[slot], slot);
+}
+
+static inline void rid_storage_release_slot(rid_storage_t *storage, uint32_t slot) {
+  if (++storage->generations[slot] == 0) storage->generations[slot] = 1;
+  storage->slots[slot] = storage->free_slot;
+  storage->free_slot = slot;
+}
+
+// Returns the dense index the entry had, or RID_STORAGE_INVALID for a stale
+// RID. The last entry moves into it, `*r_moved_from` is where it came from.
+// The two are equal when the freed entry was the last one.
+static inline uint32_t rid_storage_free(rid_storage_t *storage, uint64_t rid, uint32_t *r_moved_from) {
+  uint32_t index = rid_storage_index(storage, rid);
+  if (index == RID_STORAGE_INVALID) return RID_STORAGE_INVALID;
+
+  uint32_t last = --storage->count;
+  if (index != last) {
+    uint32_t moved_slot = storage->owners[last];
+    storage->owners[index] = moved_slot;
+    storage->slots[moved_slot] = index;
+  }
+  rid_storage_release_slot(storage, (uint32_t)rid);
+
+  if (r_moved_from != NULL) *r_moved_from = last;
+  return index;
+}
+
+// Frees every entry, every RID made so far becomes invalid
+static inline void rid_storage_clear(rid_storage_t *storage) {
+  for (uint32_t i = 0; i < storage->count; i++) {
+    rid_storage_release_slot(storage, storage->owners[i]);
+  }
+  storage->count = 0;
+}
+
+static inline void rid_storage_destroy(rid_storage_t *storage) {
+  free(storage->slots);
+  free(storage->generations);
+  free(storage->owners);
+  rid_storage_init(storage);
+}
+
+#endif // RID_STORAGE_H
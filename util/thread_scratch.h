@@ -0,0 +1,139 @@
+#ifndef THREAD_SCRATCH_H
+#define THREAD_SCRATCH_H
+
+// Per-thread scratch memory for temporaries that only live during a call.
+//
+// A global scratch buffer breaks as soon as two threads call in at the same
+// time, which Godot does with nodes in a sub-thread process group, and
+// `malloc` in `_process` makes every frame allocate. Each thread gets its own
+// bump allocator instead, the first time it asks for scratch memory.
+// Allocations are given back all at once by returning to a mark, so calls can
+// nest.
+//
+// Usage:
+//
+//   thread_scratch_mark_t mark = thread_scratch_mark();
+//   double *terms = thread_scratch_alloc(count * sizeof(double));
+//   ...
+//   thread_scratch_release(mark);
+//   ...
+//   thread_scratch_destroy(); // on deinitialization
+//
+// A thread's blocks are kept after a release, so once they have grown to what
+// the calls need, scratch memory never allocates again.
+//
+// NOTE: Scratch memory belongs to the thread that allocated it. Don't hand it
+// to another thread, and don't keep it past the matching release.
+//
+// NOTE: The threads are Godot's, so the library can't free a thread's blocks
+// when it exits. `thread_scratch_destroy` frees every thread's blocks, call it
+// once no thread runs extension code anymore.
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+#define THREAD_SCRATCH_BLOCK_SIZE (64 * 1024)
+#define THREAD_SCRATCH_ALIGNMENT (16)
+
+// Blocks are linked oldest first. After a release the blocks past the current
+// one are spares for the next allocations.
+typedef struct thread_scratch_block {
+  struct thread_scratch_block *next;
+  size_t size;
+  _Alignas(THREAD_SCRATCH_ALIGNMENT) unsigned char data[];
+} thread_scratch_block_t;
+
+typedef struct thread_scratch {
+  thread_scratch_block_t *first;
+  thread_scratch_block_t *current;
+  unsigned char *cursor;
+  // Every thread's scratch, for `thread_scratch_destroy`
+  struct thread_scratch *next;
+} thread_scratch_t;
+
+typedef struct {
+  thread_scratch_block_t *block;
+  unsigned char *cursor;
+} thread_scratch_mark_t;
+
+static _Thread_local thread_scratch_t *thread_scratch_local;
+static thread_scratch_t *_Atomic thread_scratch_all;
+
+static thread_scratch_t *thread_scratch_get() {
+  thread_scratch_t *scratch = thread_scratch_local;
+  if (scratch != NULL) return scratch;
+
+  scratch = calloc(1, sizeof(thread_scratch_t));
+  if (scratch == NULL) return NULL;
+  scratch->next = atomic_load_explicit(&thread_scratch_all, memory_order_relaxed);
+  while (!atomic_compare_exchange_weak_explicit(&thread_scratch_all, &scratch->next, scratch,
+                                                memory_order_release, memory_order_relaxed)) {
+  }
+  thread_scratch_local = scratch;
+  return scratch;
+}
+
+static inline thread_scratch_mark_t thread_scratch_mark() {
+  thread_scratch_t *scratch = thread_scratch_get();
+  if (scratch == NULL) return (thread_scratch_mark_t){ 0 };
+  return (thread_scratch_mark_t){ .block = scratch->current, .cursor = scratch->cursor };
+}
+
+static void *thread_scratch_alloc(size_t size) {
+  thread_scratch_t *scratch = thread_scratch_get();
+  if (scratch == NULL) return NULL;
+  size_t padded = (size + THREAD_SCRATCH_ALIGNMENT - 1) & ~(size_t)(THREAD_SCRATCH_ALIGNMENT - 1);
+
+  thread_scratch_block_t *block = scratch->current;
+  if (block != NULL && (size_t)(block->data + block->size - scratch->cursor) >= padded) {
+    void *res = scratch->cursor;
+    scratch->cursor += padded;
+    return res;
+  }
+
+  // Move on to the next spare block that is big enough, or put a new one in
+  // front of the spares
+  thread_scratch_block_t **link = block != NULL ? &block->next : &scratch->first;
+  while (*link != NULL && (*link)->size < padded) link = &(*link)->next;
+  if (*link == NULL || (*link)->size < padded) {
+    size_t block_size = padded > THREAD_SCRATCH_BLOCK_SIZE ? padded : THREAD_SCRATCH_BLOCK_SIZE;
+    thread_scratch_block_t *fresh = malloc(sizeof(thread_scratch_block_t) + block_size);
+    if (fresh == NULL) return NULL;
+    fresh->size = block_size;
+    fresh->next = *link;
+    *link = fresh;
+  }
+  // Spares too small to be skipped to stay behind the new current block, so
+  // a release to an earlier mark finds them again
+  scratch->current = *link;
+  scratch->cursor = scratch->current->data + padded;
+  return scratch->current->data;
+}
+
+static inline void thread_scratch_release(thread_scratch_mark_t mark) {
+  thread_scratch_t *scratch = thread_scratch_local;
+  if (scratch == NULL) return;
+  scratch->current = mark.block;
+  scratch->cursor = mark.cursor;
+}
+
+static void thread_scratch_destroy() {
+  thread_scratch_t *scratch = atomic_exchange_explicit(&thread_scratch_all, NULL, memory_order_acquire);
+  while (scratch != NULL) {
+    thread_scratch_t *next = scratch->next;
+    thread_scratch_block_t *block = scratch->first;
+    while (block != NULL) {
+      thread_scratch_block_t *next_block = block->next;
+      free(block);
+      block = next_block;
+    }
+    free(scratch);
+    scratch = next;
+  }
+  // Only this thread's pointer can be cleared, the others must not use
+  // scratch memory anymore
+  thread_scratch_local = NULL;
+}
+
+#endif
@@ -0,0 +1,177 @@
+#ifndef VARIANT_CACHE_H
+#define VARIANT_CACHE_H
+
+// Lazily filled tables of the Variant function pointers that Godot hands out
+// per type (and per operator/type pair for operator evaluators).
+//
+// Every lookup is a single indexed load. The first lookup of an entry goes
+// through the interface and publishes the result with a release store, later
+// lookups only do an acquire load, so readers never take a lock. Two threads
+// missing the same entry at the same time both ask Godot and store the same
+// pointer, which is harmless.
+//
+// Usage:
+//
+//   variant_cache_init(p_get_proc_address); // in godot_entry
+//   GDExtensionPtrOperatorEvaluator eq
+//     = variant_cache_operator_evaluator(GDEXTENSION_VARIANT_OP_EQUAL,
+//                                        GDEXTENSION_VARIANT_TYPE_STRING_NAME,
+//                                        GDEXTENSION_VARIANT_TYPE_STRING_NAME);
+//
+// The cache lives in static storage, so every translation unit that includes
+// this header gets its own (our examples are single files anyway).
+//
+// NOTE: The operator table alone is GDEXTENSION_VARIANT_OP_MAX *
+// GDEXTENSION_VARIANT_TYPE_VARIANT_MAX^2 pointers (~300KB on 64-bit). It lives
+// in .bss, so only the pages that are actually used get backed by memory.
+
+#include "../godot-headers/gdextension_interface.h"
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Highest constructor index + 1 over all builtin types (see "constructors" in
+// `extension_api.json`)
+#define VARIANT_CACHE_MAX_CONSTRUCTORS (16)
+
+#define VARIANT_CACHE_TYPE_COUNT (GDEXTENSION_VARIANT_TYPE_VARIANT_MAX)
+#define VARIANT_CACHE_OP_COUNT (GDEXTENSION_VARIANT_OP_MAX)
+
+// Stored for entries Godot has no function for, so that we don't keep asking
+static void variant_cache_missing(void) {}
+#define VARIANT_CACHE_MISSING ((void *)variant_cache_missing)
+
+static struct {
+  struct {
+    GDExtensionInterfaceVariantGetPtrOperatorEvaluator variant_get_ptr_operator_evaluator;
+    GDExtensionInterfaceVariantGetPtrConstructor variant_get_ptr_constructor;
+    GDExtensionInterfaceVariantGetPtrDestructor variant_get_ptr_destructor;
+    GDExtensionInterfaceGetVariantFromTypeConstructor get_variant_from_type_constructor;
+    GDExtensionInterfaceGetVariantToTypeConstructor get_variant_to_type_constructor;
+    GDExtensionInterfaceVariantGetPtrIndexedGetter variant_get_ptr_indexed_getter;
+    GDExtensionInterfaceVariantGetPtrIndexedSetter variant_get_ptr_indexed_setter;
+    GDExtensionInterfaceVariantGetPtrKeyedGetter variant_get_ptr_keyed_getter;
+    GDExtensionInterfaceVariantGetPtrKeyedSetter variant_get_ptr_keyed_setter;
+  } interface;
+
+  void *_Atomic operator_evaluator[VARIANT_CACHE_OP_COUNT][VARIANT_CACHE_TYPE_COUNT][VARIANT_CACHE_TYPE_COUNT];
+  void *_Atomic constructor[VARIANT_CACHE_TYPE_COUNT][VARIANT_CACHE_MAX_CONSTRUCTORS];
+  void *_Atomic destructor[VARIANT_CACHE_TYPE_COUNT];
+  void *_Atomic wrap[VARIANT_CACHE_TYPE_COUNT];
+  void *_Atomic unwrap[VARIANT_CACHE_TYPE_COUNT];
+  void *_Atomic indexed_getter[VARIANT_CACHE_TYPE_COUNT];
+  void *_Atomic indexed_setter[VARIANT_CACHE_TYPE_COUNT];
+  void *_Atomic keyed_getter[VARIANT_CACHE_TYPE_COUNT];
+  void *_Atomic keyed_setter[VARIANT_CACHE_TYPE_COUNT];
+} variant_cache;
+
+#define VARIANT_CACHE_STORE_INTERFACE(name) \
+  variant_cache.interface.name = (void *)p_get_proc_address(#name);
+
+static void variant_cache_init(GDExtensionInterfaceGetProcAddress p_get_proc_address) {
+  VARIANT_CACHE_STORE_INTERFACE(variant_get_ptr_operator_evaluator);
+  VARIANT_CACHE_STORE_INTERFACE(variant_get_ptr_constructor);
+  VARIANT_CACHE_STORE_INTERFACE(variant_get_ptr_destructor);
+  VARIANT_CACHE_STORE_INTERFACE(get_variant_from_type_constructor);
+  VARIANT_CACHE_STORE_INTERFACE(get_variant_to_type_constructor);
+  VARIANT_CACHE_STORE_INTERFACE(variant_get_ptr_indexed_getter);
+  VARIANT_CACHE_STORE_INTERFACE(variant_get_ptr_indexed_setter);
+  VARIANT_CACHE_STORE_INTERFACE(variant_get_ptr_keyed_getter);
+  VARIANT_CACHE_STORE_INTERFACE(variant_get_ptr_keyed_setter);
+}
+
+#undef VARIANT_CACHE_STORE_INTERFACE
+
+static inline void *variant_cache_publish(void *_Atomic *slot, void *fetched) {
+  atomic_store_explicit(slot, fetched != NULL ? fetched : VARIANT_CACHE_MISSING, memory_order_release);
+  return fetched;
+}
+
+// Shared shape of all lookups: fast path is the load + two compares, the
+// fetch expression is only evaluated on a miss.
+#define VARIANT_CACHE_LOOKUP(slot, fetch) do {                          \
+    void *cached = atomic_load_explicit((slot), memory_order_acquire);  \
+    if (cached == VARIANT_CACHE_MISSING) return NULL;                   \
+    if (cached != NULL) return cached;                                  \
+    return variant_cache_publish((slot), (void *)(fetch));              \
+  } while (0)
+
+static inline GDExtensionPtrOperatorEvaluator
+variant_cache_operator_evaluator(
+  GDExtensionVariantOperator p_operator,
+  GDExtensionVariantType p_type_a,
+  GDExtensionVariantType p_type_b
+) {
+  VARIANT_CACHE_LOOKUP(&variant_cache.operator_evaluator[p_operator][p_type_a][p_type_b],
+                       variant_cache.interface.variant_get_ptr_operator_evaluator(p_operator,
+                                                                                  p_type_a,
+                                                                                  p_type_b));
+}
+
+static inline GDExtensionPtrConstructor
+variant_cache_constructor(GDExtensionVariantType p_type, int32_t p_constructor) {
+  if (p_constructor < 0 || p_constructor >= VARIANT_CACHE_MAX_CONSTRUCTORS) {
+    return variant_cache.interface.variant_get_ptr_constructor(p_type, p_constructor);
+  }
+  VARIANT_CACHE_LOOKUP(&variant_cache.constructor[p_type][p_constructor],
+                       variant_cache.interface.variant_get_ptr_constructor(p_type, p_constructor));
+}
+
+static inline GDExtensionPtrDestructor variant_cache_destructor(GDExtensionVariantType p_type) {
+  VARIANT_CACHE_LOOKUP(&variant_cache.destructor[p_type],
+                       variant_cache.interface.variant_get_ptr_destructor(p_type));
+}
+
+// Type -> Variant, same as `get_variant_from_type_constructor`
+static inline GDExtensionVariantFromTypeConstructorFunc variant_cache_wrap(GDExtensionVariantType p_type) {
+  VARIANT_CACHE_LOOKUP(&variant_cache.wrap[p_type],
+                       variant_cache.interface.get_variant_from_type_constructor(p_type));
+}
+
+// Variant -> type, same as `get_variant_to_type_constructor`
+static inline GDExtensionTypeFromVariantConstructorFunc variant_cache_unwrap(GDExtensionVariantType p_type) {
+  VARIANT_CACHE_LOOKUP(&variant_cache.unwrap[p_type],
+                       variant_cache.interface.get_variant_to_type_constructor(p_type));
+}
+
+static inline GDExtensionPtrIndexedGetter variant_cache_indexed_getter(GDExtensionVariantType p_type) {
+  VARIANT_CACHE_LOOKUP(&variant_cache.indexed_getter[p_type],
+                       variant_cache.interface.variant_get_ptr_indexed_getter(p_type));
+}
+
+static inline GDExtensionPtrIndexedSetter variant_cache_indexed_setter(GDExtensionVariantType p_type) {
+  VARIANT_CACHE_LOOKUP(&variant_cache.indexed_setter[p_type],
+                       variant_cache.interface.variant_get_ptr_indexed_setter(p_type));
+}
+
+static inline GDExtensionPtrKeyedGetter variant_cache_keyed_getter(GDExtensionVariantType p_type) {
+  VARIANT_CACHE_LOOKUP(&variant_cache.keyed_getter[p_type],
+                       variant_cache.interface.variant_get_ptr_keyed_getter(p_type));
+}
+
+static inline GDExtensionPtrKeyedSetter variant_cache_keyed_setter(GDExtensionVariantType p_type) {
+  VARIANT_CACHE_LOOKUP(&variant_cache.keyed_setter[p_type],
+                       variant_cache.interface.variant_get_ptr_keyed_setter(p_type));
+}
+
+#undef VARIANT_CACHE_LOOKUP
+
+// Evaluates `p_a <op> p_b` on raw (not Variant) values. Returns false if Godot
+// doesn't define the operator for these types.
+static inline bool
+variant_cache_evaluate(
+  GDExtensionVariantOperator p_operator,
+  GDExtensionVariantType p_type_a,
+  GDExtensionConstTypePtr p_a,
+  GDExtensionVariantType p_type_b,
+  GDExtensionConstTypePtr p_b,
+  GDExtensionTypePtr r_result
+) {
+  GDExtensionPtrOperatorEvaluator evaluator
+    = variant_cache_operator_evaluator(p_operator, p_type_a, p_type_b);
+  if (evaluator == NULL) return false;
+  evaluator(p_a, p_b, r_result);
+  return true;
+}
+
+#endif
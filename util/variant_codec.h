@@ -0,0 +1,1077 @@
+#ifndef VARIANT_CODEC_H
+#define VARIANT_CODEC_H
+
+// Compact binary encoding of Variants, with optional delta encoding.
+//
+// `var_to_bytes` writes every value with a 4-byte type word and pads
+// everything to 4 bytes. That is fine for saves but a lot for entity state
+// sent on every network tick. This codec writes a one-byte tag per value,
+// varints for integers and lengths, floats as 4 bytes when that loses
+// nothing, and the raw memory of vectors, colors, transforms and packed
+// arrays.
+//
+// With a baseline, usually the previous snapshot the receiver has, values are
+// written as the difference to it. An unchanged value is a single byte, an
+// Array or Dictionary only spells out the entries that changed, and a packed
+// array of the same size only the runs of elements that differ. The decoder
+// needs the same baseline to put the value back together.
+//
+// Usage:
+//
+//   variant_codec_init(p_get_proc_address); // in godot_entry
+//
+//   variant_codec_writer_t writer = variant_codec_writer(buffer, capacity);
+//   variant_codec_encode(&writer, &state, &previous_state); // or NULL for no delta
+//   send(buffer, writer.size);
+//   ...
+//   variant_codec_reader_t reader = variant_codec_reader(data, size);
+//   uint8_t state[GD_BUILTIN_SIZE_VARIANT];
+//   variant_codec_decode(&reader, state, &previous_state);
+//
+// Every encoded value starts with a header: "GV", the format version and
+// flags (delta encoded, reals are doubles). Several values can be written
+// after each other into the same buffer, the reader's `position` moves past
+// each one.
+//
+// Supported are Nil, bool, int, float, String, StringName, every builtin
+// that is plain memory (vectors, rects, transforms, Basis, Plane, Quaternion,
+// AABB, Projection, Color), the packed arrays, and Arrays and Dictionaries of
+// those. Objects, Callables, Signals, RIDs and NodePaths fail with
+// VARIANT_CODEC_ERROR_UNSUPPORTED, they don't mean anything in another
+// process.
+//
+// NOTE: The raw memory is written in host byte order, and the size of reals
+// follows the build. Decoding checks the flag and rejects data from a build
+// with the other real size. Typed Arrays come back untyped.
+//
+// NOTE: Dictionary deltas look a key up among the baseline's keys, trying the
+// same position first. Entity state keeps its keys in the same order, so
+// that's one compare per key. A Dictionary whose keys move around costs a
+// scan of the baseline keys per key.
+
+#include "../godot-headers/gdextension_interface.h"
+#include "builtin_sizes.h"
+#include "gd_container.h"
+#include "gd_string.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#define VARIANT_CODEC_VERSION (1)
+#define VARIANT_CODEC_HEADER_SIZE (4)
+#define VARIANT_CODEC_FLAG_DELTA (1)
+#define VARIANT_CODEC_FLAG_DOUBLE_REALS (2)
+// Deeper nesting is refused on both sides, it's corrupt or hostile data
+#define VARIANT_CODEC_MAX_DEPTH (64)
+// Shared by Array and every packed array
+#define VARIANT_CODEC_SIZE_HASH (3173160232)
+#define VARIANT_CODEC_RESIZE_HASH (848867239)
+
+typedef enum {
+  VARIANT_CODEC_OK,
+  // The writer's buffer is too small
+  VARIANT_CODEC_ERROR_FULL,
+  VARIANT_CODEC_ERROR_UNSUPPORTED,
+  VARIANT_CODEC_ERROR_TOO_DEEP,
+  // Truncated or malformed data
+  VARIANT_CODEC_ERROR_CORRUPT,
+  // Not our magic, another version, or the other real size
+  VARIANT_CODEC_ERROR_VERSION,
+  // Delta encoded data, but no baseline or one that doesn't match
+  VARIANT_CODEC_ERROR_BASELINE,
+} variant_codec_error_t;
+
+// Wire tags, append only: changing one needs a new VARIANT_CODEC_VERSION
+enum {
+  VARIANT_CODEC_TAG_NIL,
+  VARIANT_CODEC_TAG_FALSE,
+  VARIANT_CODEC_TAG_TRUE,
+  // Zigzag varint
+  VARIANT_CODEC_TAG_INT,
+  VARIANT_CODEC_TAG_FLOAT32,
+  VARIANT_CODEC_TAG_FLOAT64,
+  // Varint byte length, UTF-8
+  VARIANT_CODEC_TAG_STRING,
+  VARIANT_CODEC_TAG_STRING_NAME,
+  // Variant type byte, the value's memory
+  VARIANT_CODEC_TAG_RAW,
+  // Variant type byte, varint count, the elements' memory
+  VARIANT_CODEC_TAG_PACKED,
+  // Varint count, strings like VARIANT_CODEC_TAG_STRING without the tag
+  VARIANT_CODEC_TAG_PACKED_STRINGS,
+  // Varint count, values
+  VARIANT_CODEC_TAG_ARRAY,
+  // Varint count, key and value pairs
+  VARIANT_CODEC_TAG_DICTIONARY,
+  // Only in delta encoded data:
+  // Equal to the baseline
+  VARIANT_CODEC_TAG_SAME,
+  // Varint count, values against the baseline's element at the same index
+  VARIANT_CODEC_TAG_ARRAY_DELTA,
+  // Varint count, pairs of a key (a value or VARIANT_CODEC_TAG_KEY_INDEX) and
+  // a value against the baseline's value for that key
+  VARIANT_CODEC_TAG_DICTIONARY_DELTA,
+  // Varint index into the baseline's keys
+  VARIANT_CODEC_TAG_KEY_INDEX,
+  // Variant type byte, varint count (the baseline's), then pairs of varints
+  // (unchanged elements to skip, changed elements that follow) with the
+  // changed elements' memory, until the count is reached
+  VARIANT_CODEC_TAG_PACKED_DELTA,
+};
+
+typedef void *(*variant_codec_packed_index_t)(GDExtensionTypePtr p_self, GDExtensionInt p_index);
+typedef const void *(*variant_codec_packed_index_const_t)(GDExtensionConstTypePtr p_self, GDExtensionInt p_index);
+
+static struct {
+  struct {
+    GDExtensionInterfaceVariantNewCopy variant_new_copy;
+    GDExtensionInterfaceVariantNewNil variant_new_nil;
+    GDExtensionInterfaceVariantDestroy variant_destroy;
+    GDExtensionInterfaceVariantGetType variant_get_type;
+    GDExtensionInterfaceVariantGetPtrConstructor variant_get_ptr_constructor;
+    GDExtensionInterfaceVariantGetPtrDestructor variant_get_ptr_destructor;
+    GDExtensionInterfaceVariantGetPtrBuiltinMethod variant_get_ptr_builtin_method;
+    GDExtensionInterfaceGetVariantFromTypeConstructor get_variant_from_type_constructor;
+    GDExtensionInterfaceGetVariantToTypeConstructor get_variant_to_type_constructor;
+    GDExtensionInterfaceDictionaryOperatorIndex dictionary_operator_index;
+    GDExtensionInterfaceStringNameNewWithUtf8Chars string_name_new_with_utf8_chars;
+  } interface;
+
+  GDExtensionVariantFromTypeConstructorFunc from_type[GDEXTENSION_VARIANT_TYPE_VARIANT_MAX];
+  GDExtensionTypeFromVariantConstructorFunc to_type[GDEXTENSION_VARIANT_TYPE_VARIANT_MAX];
+  GDExtensionPtrDestructor destructor[GDEXTENSION_VARIANT_TYPE_VARIANT_MAX];
+  GDExtensionPtrConstructor default_constructor[GDEXTENSION_VARIANT_TYPE_VARIANT_MAX];
+  GDExtensionPtrConstructor copy_constructor[GDEXTENSION_VARIANT_TYPE_VARIANT_MAX];
+  GDExtensionPtrBuiltInMethod size[GDEXTENSION_VARIANT_TYPE_VARIANT_MAX];
+  GDExtensionPtrBuiltInMethod resize[GDEXTENSION_VARIANT_TYPE_VARIANT_MAX];
+  variant_codec_packed_index_t packed_index[GDEXTENSION_VARIANT_TYPE_VARIANT_MAX];
+  variant_codec_packed_index_const_t packed_index_const[GDEXTENSION_VARIANT_TYPE_VARIANT_MAX];
+  GDExtensionPtrConstructor string_from_string_name;
+} variant_codec;
+
+// Bytes of a value that is plain memory, 0 for everything else
+static const uint8_t variant_codec_raw_size[GDEXTENSION_VARIANT_TYPE_VARIANT_MAX] = {
+  [GDEXTENSION_VARIANT_TYPE_VECTOR2] = GD_BUILTIN_SIZE_VECTOR2,
+  [GDEXTENSION_VARIANT_TYPE_VECTOR2I] = GD_BUILTIN_SIZE_VECTOR2I,
+  [GDEXTENSION_VARIANT_TYPE_RECT2] = GD_BUILTIN_SIZE_RECT2,
+  [GDEXTENSION_VARIANT_TYPE_RECT2I] = GD_BUILTIN_SIZE_RECT2I,
+  [GDEXTENSION_VARIANT_TYPE_VECTOR3] = GD_BUILTIN_SIZE_VECTOR3,
+  [GDEXTENSION_VARIANT_TYPE_VECTOR3I] = GD_BUILTIN_SIZE_VECTOR3I,
+  [GDEXTENSION_VARIANT_TYPE_TRANSFORM2D] = GD_BUILTIN_SIZE_TRANSFORM2D,
+  [GDEXTENSION_VARIANT_TYPE_VECTOR4] = GD_BUILTIN_SIZE_VECTOR4,
+  [GDEXTENSION_VARIANT_TYPE_VECTOR4I] = GD_BUILTIN_SIZE_VECTOR4I,
+  [GDEXTENSION_VARIANT_TYPE_PLANE] = GD_BUILTIN_SIZE_PLANE,
+  [GDEXTENSION_VARIANT_TYPE_QUATERNION] = GD_BUILTIN_SIZE_QUATERNION,
+  [GDEXTENSION_VARIANT_TYPE_AABB] = GD_BUILTIN_SIZE_AABB,
+  [GDEXTENSION_VARIANT_TYPE_BASIS] = GD_BUILTIN_SIZE_BASIS,
+  [GDEXTENSION_VARIANT_TYPE_TRANSFORM3D] = GD_BUILTIN_SIZE_TRANSFORM3D,
+  [GDEXTENSION_VARIANT_TYPE_PROJECTION] = GD_BUILTIN_SIZE_PROJECTION,
+  [GDEXTENSION_VARIANT_TYPE_COLOR] = GD_BUILTIN_SIZE_COLOR,
+};
+
+// Bytes of an element of the packed arrays that hold plain memory
+static const uint8_t variant_codec_element_size[GDEXTENSION_VARIANT_TYPE_VARIANT_MAX] = {
+  [GDEXTENSION_VARIANT_TYPE_PACKED_BYTE_ARRAY] = 1,
+  [GDEXTENSION_VARIANT_TYPE_PACKED_INT32_ARRAY] = 4,
+  [GDEXTENSION_VARIANT_TYPE_PACKED_INT64_ARRAY] = 8,
+  [GDEXTENSION_VARIANT_TYPE_PACKED_FLOAT32_ARRAY] = 4,
+  [GDEXTENSION_VARIANT_TYPE_PACKED_FLOAT64_ARRAY] = 8,
+  [GDEXTENSION_VARIANT_TYPE_PACKED_VECTOR2_ARRAY] = GD_BUILTIN_SIZE_VECTOR2,
+  [GDEXTENSION_VARIANT_TYPE_PACKED_VECTOR3_ARRAY] = GD_BUILTIN_SIZE_VECTOR3,
+  [GDEXTENSION_VARIANT_TYPE_PACKED_COLOR_ARRAY] = GD_BUILTIN_SIZE_COLOR,
+};
+
+#define VARIANT_CODEC_STORE_INTERFACE(name) \
+  variant_codec.interface.name = (void *)p_get_proc_address(#name);
+
+static GDExtensionPtrBuiltInMethod
+variant_codec_builtin_method(GDExtensionVariantType p_type, const char *p_name, GDExtensionInt p_hash) {
+  uint8_t name[GD_BUILTIN_SIZE_STRING_NAME];
+  variant_codec.interface.string_name_new_with_utf8_chars(name, p_name);
+  GDExtensionPtrBuiltInMethod res = variant_codec.interface.variant_get_ptr_builtin_method(p_type, name, p_hash);
+  variant_codec.interface.variant_get_ptr_destructor(GDEXTENSION_VARIANT_TYPE_STRING_NAME)(name);
+  return res;
+}
+
+static void variant_codec_init(GDExtensionInterfaceGetProcAddress p_get_proc_address) {
+  VARIANT_CODEC_STORE_INTERFACE(variant_new_copy);
+  VARIANT_CODEC_STORE_INTERFACE(variant_new_nil);
+  VARIANT_CODEC_STORE_INTERFACE(variant_destroy);
+  VARIANT_CODEC_STORE_INTERFACE(variant_get_type);
+  VARIANT_CODEC_STORE_INTERFACE(variant_get_ptr_constructor);
+  VARIANT_CODEC_STORE_INTERFACE(variant_get_ptr_destructor);
+  VARIANT_CODEC_STORE_INTERFACE(variant_get_ptr_builtin_method);
+  VARIANT_CODEC_STORE_INTERFACE(get_variant_from_type_constructor);
+  VARIANT_CODEC_STORE_INTERFACE(get_variant_to_type_constructor);
+  VARIANT_CODEC_STORE_INTERFACE(dictionary_operator_index);
+  VARIANT_CODEC_STORE_INTERFACE(string_name_new_with_utf8_chars);
+
+  for (int type = GDEXTENSION_VARIANT_TYPE_BOOL; type < GDEXTENSION_VARIANT_TYPE_VARIANT_MAX; type++) {
+    variant_codec.from_type[type] = variant_codec.interface.get_variant_from_type_constructor(type);
+    variant_codec.to_type[type] = variant_codec.interface.get_variant_to_type_constructor(type);
+    variant_codec.destructor[type] = variant_codec.interface.variant_get_ptr_destructor(type);
+  }
+
+#define VARIANT_CODEC_PACKED(NAME, name)                                                                  \
+  variant_codec.packed_index[GDEXTENSION_VARIANT_TYPE_##NAME]                                             \
+    = (void *)p_get_proc_address(#name "_operator_index");                                                \
+  variant_codec.packed_index_const[GDEXTENSION_VARIANT_TYPE_##NAME]                                       \
+    = (void *)p_get_proc_address(#name "_operator_index_const");
+  VARIANT_CODEC_PACKED(PACKED_BYTE_ARRAY, packed_byte_array)
+  VARIANT_CODEC_PACKED(PACKED_INT32_ARRAY, packed_int32_array)
+  VARIANT_CODEC_PACKED(PACKED_INT64_ARRAY, packed_int64_array)
+  VARIANT_CODEC_PACKED(PACKED_FLOAT32_ARRAY, packed_float32_array)
+  VARIANT_CODEC_PACKED(PACKED_FLOAT64_ARRAY, packed_float64_array)
+  VARIANT_CODEC_PACKED(PACKED_STRING_ARRAY, packed_string_array)
+  VARIANT_CODEC_PACKED(PACKED_VECTOR2_ARRAY, packed_vector2_array)
+  VARIANT_CODEC_PACKED(PACKED_VECTOR3_ARRAY, packed_vector3_array)
+  VARIANT_CODEC_PACKED(PACKED_COLOR_ARRAY, packed_color_array)
+#undef VARIANT_CODEC_PACKED
+
+  for (int type = GDEXTENSION_VARIANT_TYPE_DICTIONARY; type < GDEXTENSION_VARIANT_TYPE_VARIANT_MAX; type++) {
+    variant_codec.default_constructor[type] = variant_codec.interface.variant_get_ptr_constructor(type, 0);
+    variant_codec.copy_constructor[type] = variant_codec.interface.variant_get_ptr_constructor(type, 1);
+    if (type == GDEXTENSION_VARIANT_TYPE_DICTIONARY) continue;
+    variant_codec.size[type] = variant_codec_builtin_method(type, "size", VARIANT_CODEC_SIZE_HASH);
+    variant_codec.resize[type] = variant_codec_builtin_method(type, "resize", VARIANT_CODEC_RESIZE_HASH);
+  }
+  // String(StringName)
+  variant_codec.string_from_string_name
+    = variant_codec.interface.variant_get_ptr_constructor(GDEXTENSION_VARIANT_TYPE_STRING, 2);
+
+  gd_container_init(p_get_proc_address);
+  gd_string_init(p_get_proc_address);
+}
+
+// ---------------------------------------------------------------------------
+// Writing
+// ---------------------------------------------------------------------------
+
+typedef struct {
+  uint8_t *data;
+  size_t capacity;
+  size_t size;
+  variant_codec_error_t error;
+} variant_codec_writer_t;
+
+static inline variant_codec_writer_t variant_codec_writer(uint8_t *p_data, size_t p_capacity) {
+  return (variant_codec_writer_t){ .data = p_data, .capacity = p_capacity };
+}
+
+static inline bool variant_codec_fail(variant_codec_error_t *r_error, variant_codec_error_t p_error) {
+  if (*r_error == VARIANT_CODEC_OK) *r_error = p_error;
+  return false;
+}
+
+static inline bool variant_codec_put(variant_codec_writer_t *w, const void *p_bytes, size_t p_count) {
+  if (w->capacity - w->size < p_count) return variant_codec_fail(&w->error, VARIANT_CODEC_ERROR_FULL);
+  // Empty packed arrays have no data pointer
+  if (p_count == 0) return true;
+  memcpy(w->data + w->size, p_bytes, p_count);
+  w->size += p_count;
+  return true;
+}
+
+static inline bool variant_codec_put_u8(variant_codec_writer_t *w, uint8_t p_byte) {
+  if (w->size == w->capacity) return variant_codec_fail(&w->error, VARIANT_CODEC_ERROR_FULL);
+  w->data[w->size++] = p_byte;
+  return true;
+}
+
+static inline bool variant_codec_put_varint(variant_codec_writer_t *w, uint64_t p_value) {
+  uint8_t bytes[10];
+  size_t count = 0;
+  do {
+    bytes[count] = (p_value & 0x7f) | (p_value > 0x7f ? 0x80 : 0);
+    p_value >>= 7;
+    count++;
+  } while (p_value != 0);
+  return variant_codec_put(w, bytes, count);
+}
+
+// UTF-32 to UTF-8, written straight from the String's buffer
+static bool variant_codec_put_string(variant_codec_writer_t *w, GDExtensionConstStringPtr p_string) {
+  gd_string_view_t view = gd_string_view(p_string);
+  size_t length = 0;
+  for (int64_t i = 0; i < view.length; i++) {
+    char32_t c = view.data[i];
+    length += c < 0x80 ? 1 : c < 0x800 ? 2 : c < 0x10000 ? 3 : 4;
+  }
+  if (!variant_codec_put_varint(w, length)) return false;
+  if (w->capacity - w->size < length) return variant_codec_fail(&w->error, VARIANT_CODEC_ERROR_FULL);
+
+  uint8_t *out = w->data + w->size;
+  for (int64_t i = 0; i < view.length; i++) {
+    char32_t c = view.data[i];
+    if (c < 0x80) {
+      *out++ = c;
+    } else if (c < 0x800) {
+      *out++ = 0xc0 | (c >> 6);
+      *out++ = 0x80 | (c & 0x3f);
+    } else if (c < 0x10000) {
+      *out++ = 0xe0 | (c >> 12);
+      *out++ = 0x80 | ((c >> 6) & 0x3f);
+      *out++ = 0x80 | (c & 0x3f);
+    } else {
+      *out++ = 0xf0 | ((c >> 18) & 0x07);
+      *out++ = 0x80 | ((c >> 12) & 0x3f);
+      *out++ = 0x80 | ((c >> 6) & 0x3f);
+      *out++ = 0x80 | (c & 0x3f);
+    }
+  }
+  w->size += length;
+  return true;
+}
+
+static bool variant_codec_strings_equal(GDExtensionConstStringPtr p_a, GDExtensionConstStringPtr p_b) {
+  gd_string_view_t a = gd_string_view(p_a);
+  gd_string_view_t b = gd_string_view(p_b);
+  return a.length == b.length && (a.data == b.data || memcmp(a.data, b.data, a.length * sizeof(char32_t)) == 0);
+}
+
+// Whether two values that aren't containers are equal, bit for bit for
+// floats. Used for the keys of Dictionary deltas.
+static bool variant_codec_same_scalar(GDExtensionConstVariantPtr p_a, GDExtensionConstVariantPtr p_b) {
+  GDExtensionVariantType type = variant_codec.interface.variant_get_type(p_a);
+  if (variant_codec.interface.variant_get_type(p_b) != type) return false;
+  if (type == GDEXTENSION_VARIANT_TYPE_NIL) return true;
+
+  bool res = false;
+  if (type == GDEXTENSION_VARIANT_TYPE_STRING) {
+    uint8_t a[GD_BUILTIN_SIZE_STRING];
+    uint8_t b[GD_BUILTIN_SIZE_STRING];
+    variant_codec.to_type[type](a, (void *)p_a);
+    variant_codec.to_type[type](b, (void *)p_b);
+    res = variant_codec_strings_equal(a, b);
+    variant_codec.destructor[type](a);
+    variant_codec.destructor[type](b);
+  } else if (type == GDEXTENSION_VARIANT_TYPE_STRING_NAME || type == GDEXTENSION_VARIANT_TYPE_BOOL
+             || type == GDEXTENSION_VARIANT_TYPE_INT || type == GDEXTENSION_VARIANT_TYPE_FLOAT
+             || variant_codec_raw_size[type] > 0) {
+    // StringNames are interned, equal exactly when they point at the same data
+    uint8_t a[GD_BUILTIN_SIZE_PROJECTION];
+    uint8_t b[GD_BUILTIN_SIZE_PROJECTION];
+    size_t size = type == GDEXTENSION_VARIANT_TYPE_BOOL ? GD_BUILTIN_SIZE_BOOL
+                  : type == GDEXTENSION_VARIANT_TYPE_STRING_NAME ? GD_BUILTIN_SIZE_STRING_NAME
+                  : type == GDEXTENSION_VARIANT_TYPE_INT || type == GDEXTENSION_VARIANT_TYPE_FLOAT ? 8
+                  : variant_codec_raw_size[type];
+    variant_codec.to_type[type](a, (void *)p_a);
+    variant_codec.to_type[type](b, (void *)p_b);
+    res = memcmp(a, b, size) == 0;
+    if (type == GDEXTENSION_VARIANT_TYPE_STRING_NAME) {
+      variant_codec.destructor[type](a);
+      variant_codec.destructor[type](b);
+    }
+  }
+  return res;
+}
+
+static bool variant_codec_encode_value(variant_codec_writer_t *w, GDExtensionConstVariantPtr p_value, GDExtensionConstVariantPtr p_baseline, int depth);
+
+// A child written as a single VARIANT_CODEC_TAG_SAME
+static inline bool variant_codec_wrote_same(const variant_codec_writer_t *w, size_t p_start) {
+  return w->size == p_start + 1 && w->data[p_start] == VARIANT_CODEC_TAG_SAME;
+}
+
+// Replaces what was written since `p_start` with VARIANT_CODEC_TAG_SAME
+static inline bool variant_codec_collapse(variant_codec_writer_t *w, size_t p_start) {
+  w->size = p_start;
+  return variant_codec_put_u8(w, VARIANT_CODEC_TAG_SAME);
+}
+
+static bool
+variant_codec_encode_array(
+  variant_codec_writer_t *w,
+  GDExtensionConstTypePtr p_array,
+  GDExtensionConstTypePtr p_baseline,
+  int depth
+) {
+  size_t start = w->size;
+  gd_array_view_t view = gd_array_view(p_array);
+  gd_array_view_t baseline = p_baseline != NULL ? gd_array_view(p_baseline) : (gd_array_view_t){ 0 };
+  if (!variant_codec_put_u8(w, p_baseline != NULL ? VARIANT_CODEC_TAG_ARRAY_DELTA : VARIANT_CODEC_TAG_ARRAY)) return false;
+  if (!variant_codec_put_varint(w, view.size)) return false;
+
+  bool all_same = p_baseline != NULL && view.size == baseline.size;
+  for (int64_t i = 0; i < view.size; i++) {
+    size_t element_start = w->size;
+    GDExtensionConstVariantPtr baseline_element = i < baseline.size ? gd_array_view_at(baseline, i) : NULL;
+    if (!variant_codec_encode_value(w, gd_array_view_at(view, i), baseline_element, depth + 1)) return false;
+    all_same = all_same && variant_codec_wrote_same(w, element_start);
+  }
+  return all_same ? variant_codec_collapse(w, start) : true;
+}
+
+// Index of `p_key` among `keys`, starting the search at `p_hint`, or -1
+static int64_t variant_codec_find_key(gd_array_view_t keys, GDExtensionConstVariantPtr p_key, int64_t p_hint) {
+  for (int64_t n = 0; n < keys.size; n++) {
+    int64_t i = (p_hint + n) % keys.size;
+    if (variant_codec_same_scalar(gd_array_view_at(keys, i), p_key)) return i;
+  }
+  return -1;
+}
+
+static bool
+variant_codec_encode_dictionary(
+  variant_codec_writer_t *w,
+  GDExtensionConstTypePtr p_dictionary,
+  GDExtensionConstTypePtr p_baseline,
+  int depth
+) {
+  size_t start = w->size;
+  uint8_t keys[GD_BUILTIN_SIZE_ARRAY];
+  uint8_t baseline_keys[GD_BUILTIN_SIZE_ARRAY];
+  // The keys are assigned into the Arrays, which have to exist already
+  gd_container.array_constructor(keys, NULL);
+  gd_container.dictionary_keys((void *)p_dictionary, NULL, keys, 0);
+  if (p_baseline != NULL) {
+    gd_container.array_constructor(baseline_keys, NULL);
+    gd_container.dictionary_keys((void *)p_baseline, NULL, baseline_keys, 0);
+  }
+  gd_array_view_t view = gd_array_view(keys);
+  gd_array_view_t baseline = p_baseline != NULL ? gd_array_view(baseline_keys) : (gd_array_view_t){ 0 };
+
+  bool ok = variant_codec_put_u8(w, p_baseline != NULL ? VARIANT_CODEC_TAG_DICTIONARY_DELTA : VARIANT_CODEC_TAG_DICTIONARY)
+            && variant_codec_put_varint(w, view.size);
+  bool all_same = p_baseline != NULL && view.size == baseline.size;
+  for (int64_t i = 0; ok && i < view.size; i++) {
+    GDExtensionConstVariantPtr key = gd_array_view_at(view, i);
+    GDExtensionConstVariantPtr value = gd_container.interface.dictionary_operator_index_const(p_dictionary, key);
+    int64_t baseline_index = p_baseline != NULL ? variant_codec_find_key(baseline, key, i) : -1;
+
+    GDExtensionConstVariantPtr baseline_value = NULL;
+    if (baseline_index >= 0) {
+      baseline_value = gd_container.interface.dictionary_operator_index_const(p_baseline, gd_array_view_at(baseline, baseline_index));
+      ok = variant_codec_put_u8(w, VARIANT_CODEC_TAG_KEY_INDEX) && variant_codec_put_varint(w, baseline_index);
+    } else {
+      ok = variant_codec_encode_value(w, key, NULL, depth + 1);
+    }
+
+    size_t value_start = w->size;
+    ok = ok && variant_codec_encode_value(w, value, baseline_value, depth + 1);
+    all_same = all_same && baseline_index == i && variant_codec_wrote_same(w, value_start);
+  }
+
+  gd_container.array_destructor(keys);
+  if (p_baseline != NULL) gd_container.array_destructor(baseline_keys);
+  if (!ok) return false;
+  return all_same ? variant_codec_collapse(w, start) : true;
+}
+
+static bool
+variant_codec_encode_packed(
+  variant_codec_writer_t *w,
+  GDExtensionVariantType p_type,
+  GDExtensionConstTypePtr p_array,
+  GDExtensionConstTypePtr p_baseline
+) {
+  size_t element_size = variant_codec_element_size[p_type];
+  GDExtensionInt count;
+  variant_codec.size[p_type]((void *)p_array, NULL, &count, 0);
+  const uint8_t *data = count > 0 ? variant_codec.packed_index_const[p_type](p_array, 0) : NULL;
+
+  GDExtensionInt baseline_count = -1;
+  if (p_baseline != NULL) variant_codec.size[p_type]((void *)p_baseline, NULL, &baseline_count, 0);
+
+  if (baseline_count != count) {
+    return variant_codec_put_u8(w, VARIANT_CODEC_TAG_PACKED)
+           && variant_codec_put_u8(w, p_type)
+           && variant_codec_put_varint(w, count)
+           && variant_codec_put(w, data, count * element_size);
+  }
+
+  // Same size as the baseline: only the runs of changed elements
+  size_t start = w->size;
+  const uint8_t *baseline_data = count > 0 ? variant_codec.packed_index_const[p_type](p_baseline, 0) : NULL;
+  if (!variant_codec_put_u8(w, VARIANT_CODEC_TAG_PACKED_DELTA)
+      || !variant_codec_put_u8(w, p_type)
+      || !variant_codec_put_varint(w, count)) {
+    return false;
+  }
+  bool changed = false;
+  GDExtensionInt i = 0;
+  while (i < count) {
+    GDExtensionInt skip = 0;
+    while (i + skip < count && memcmp(data + (i + skip) * element_size, baseline_data + (i + skip) * element_size, element_size) == 0) {
+      skip++;
+    }
+    GDExtensionInt run = 0;
+    while (i + skip + run < count && memcmp(data + (i + skip + run) * element_size, baseline_data + (i + skip + run) * element_size, element_size) != 0) {
+      run++;
+    }
+    if (!variant_codec_put_varint(w, skip)
+        || !variant_codec_put_varint(w, run)
+        || !variant_codec_put(w, data + (i + skip) * element_size, run * element_size)) {
+      return false;
+    }
+    changed = changed || run > 0;
+    i += skip + run;
+  }
+  return changed ? true : variant_codec_collapse(w, start);
+}
+
+static bool
+variant_codec_encode_packed_strings(
+  variant_codec_writer_t *w,
+  GDExtensionConstTypePtr p_array,
+  GDExtensionConstTypePtr p_baseline
+) {
+  GDExtensionVariantType type = GDEXTENSION_VARIANT_TYPE_PACKED_STRING_ARRAY;
+  GDExtensionInt count;
+  variant_codec.size[type]((void *)p_array, NULL, &count, 0);
+
+  if (p_baseline != NULL) {
+    GDExtensionInt baseline_count;
+    variant_codec.size[type]((void *)p_baseline, NULL, &baseline_count, 0);
+    bool same = baseline_count == count;
+    for (GDExtensionInt i = 0; same && i < count; i++) {
+      same = variant_codec_strings_equal(variant_codec.packed_index_const[type](p_array, i),
+                                         variant_codec.packed_index_const[type](p_baseline, i));
+    }
+    if (same) return variant_codec_put_u8(w, VARIANT_CODEC_TAG_SAME);
+  }
+
+  if (!variant_codec_put_u8(w, VARIANT_CODEC_TAG_PACKED_STRINGS) || !variant_codec_put_varint(w, count)) return false;
+  for (GDExtensionInt i = 0; i < count; i++) {
+    if (!variant_codec_put_string(w, variant_codec.packed_index_const[type](p_array, i))) return false;
+  }
+  return true;
+}
+
+static bool
+variant_codec_encode_value(
+  variant_codec_writer_t *w,
+  GDExtensionConstVariantPtr p_value,
+  GDExtensionConstVariantPtr p_baseline,
+  int depth
+) {
+  if (depth > VARIANT_CODEC_MAX_DEPTH) return variant_codec_fail(&w->error, VARIANT_CODEC_ERROR_TOO_DEEP);
+  GDExtensionVariantType type = variant_codec.interface.variant_get_type(p_value);
+  if (p_baseline != NULL && variant_codec.interface.variant_get_type(p_baseline) != type) p_baseline = NULL;
+
+  switch (type) {
+    case GDEXTENSION_VARIANT_TYPE_NIL:
+      return variant_codec_put_u8(w, p_baseline != NULL ? VARIANT_CODEC_TAG_SAME : VARIANT_CODEC_TAG_NIL);
+
+    case GDEXTENSION_VARIANT_TYPE_BOOL:
+    case GDEXTENSION_VARIANT_TYPE_INT:
+    case GDEXTENSION_VARIANT_TYPE_FLOAT:
+    case GDEXTENSION_VARIANT_TYPE_STRING_NAME: {
+      if (p_baseline != NULL && variant_codec_same_scalar(p_value, p_baseline)) {
+        return variant_codec_put_u8(w, VARIANT_CODEC_TAG_SAME);
+      }
+      if (type == GDEXTENSION_VARIANT_TYPE_BOOL) {
+        GDExtensionBool value;
+        variant_codec.to_type[type](&value, (void *)p_value);
+        return variant_codec_put_u8(w, value ? VARIANT_CODEC_TAG_TRUE : VARIANT_CODEC_TAG_FALSE);
+      }
+      if (type == GDEXTENSION_VARIANT_TYPE_INT) {
+        GDExtensionInt value;
+        variant_codec.to_type[type](&value, (void *)p_value);
+        uint64_t zigzag = ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+        return variant_codec_put_u8(w, VARIANT_CODEC_TAG_INT) && variant_codec_put_varint(w, zigzag);
+      }
+      if (type == GDEXTENSION_VARIANT_TYPE_FLOAT) {
+        double value;
+        variant_codec.to_type[type](&value, (void *)p_value);
+        float narrow = (float)value;
+        if ((double)narrow == value) {
+          return variant_codec_put_u8(w, VARIANT_CODEC_TAG_FLOAT32) && variant_codec_put(w, &narrow, sizeof(narrow));
+        }
+        return variant_codec_put_u8(w, VARIANT_CODEC_TAG_FLOAT64) && variant_codec_put(w, &value, sizeof(value));
+      }
+      uint8_t name[GD_BUILTIN_SIZE_STRING_NAME];
+      uint8_t string[GD_BUILTIN_SIZE_STRING];
+      variant_codec.to_type[type](name, (void *)p_value);
+      GDExtensionConstTypePtr args[] = { name };
+      variant_codec.string_from_string_name(string, args);
+      bool ok = variant_codec_put_u8(w, VARIANT_CODEC_TAG_STRING_NAME) && variant_codec_put_string(w, string);
+      variant_codec.destructor[GDEXTENSION_VARIANT_TYPE_STRING](string);
+      variant_codec.destructor[type](name);
+      return ok;
+    }
+
+    case GDEXTENSION_VARIANT_TYPE_STRING: {
+      if (p_baseline != NULL && variant_codec_same_scalar(p_value, p_baseline)) {
+        return variant_codec_put_u8(w, VARIANT_CODEC_TAG_SAME);
+      }
+      uint8_t string[GD_BUILTIN_SIZE_STRING];
+      variant_codec.to_type[type](string, (void *)p_value);
+      bool ok = variant_codec_put_u8(w, VARIANT_CODEC_TAG_STRING) && variant_codec_put_string(w, string);
+      variant_codec.destructor[type](string);
+      return ok;
+    }
+
+    case GDEXTENSION_VARIANT_TYPE_ARRAY:
+    case GDEXTENSION_VARIANT_TYPE_DICTIONARY:
+    case GDEXTENSION_VARIANT_TYPE_PACKED_BYTE_ARRAY:
+    case GDEXTENSION_VARIANT_TYPE_PACKED_INT32_ARRAY:
+    case GDEXTENSION_VARIANT_TYPE_PACKED_INT64_ARRAY:
+    case GDEXTENSION_VARIANT_TYPE_PACKED_FLOAT32_ARRAY:
+    case GDEXTENSION_VARIANT_TYPE_PACKED_FLOAT64_ARRAY:
+    case GDEXTENSION_VARIANT_TYPE_PACKED_STRING_ARRAY:
+    case GDEXTENSION_VARIANT_TYPE_PACKED_VECTOR2_ARRAY:
+    case GDEXTENSION_VARIANT_TYPE_PACKED_VECTOR3_ARRAY:
+    case GDEXTENSION_VARIANT_TYPE_PACKED_COLOR_ARRAY: {
+      // Unwrapping a container takes a reference, nothing is copied
+      uint8_t value[GD_BUILTIN_SIZE_PACKED_BYTE_ARRAY];
+      uint8_t baseline[GD_BUILTIN_SIZE_PACKED_BYTE_ARRAY];
+      variant_codec.to_type[type](value, (void *)p_value);
+      if (p_baseline != NULL) variant_codec.to_type[type](baseline, (void *)p_baseline);
+      void *baseline_ptr = p_baseline != NULL ? baseline : NULL;
+
+      bool ok;
+      if (type == GDEXTENSION_VARIANT_TYPE_ARRAY) {
+        ok = variant_codec_encode_array(w, value, baseline_ptr, depth);
+      } else if (type == GDEXTENSION_VARIANT_TYPE_DICTIONARY) {
+        ok = variant_codec_encode_dictionary(w, value, baseline_ptr, depth);
+      } else if (type == GDEXTENSION_VARIANT_TYPE_PACKED_STRING_ARRAY) {
+        ok = variant_codec_encode_packed_strings(w, value, baseline_ptr);
+      } else {
+        ok = variant_codec_encode_packed(w, type, value, baseline_ptr);
+      }
+
+      variant_codec.destructor[type](value);
+      if (p_baseline != NULL) variant_codec.destructor[type](baseline);
+      return ok;
+    }
+
+    default: {
+      size_t size = variant_codec_raw_size[type];
+      if (size == 0) return variant_codec_fail(&w->error, VARIANT_CODEC_ERROR_UNSUPPORTED);
+      if (p_baseline != NULL && variant_codec_same_scalar(p_value, p_baseline)) {
+        return variant_codec_put_u8(w, VARIANT_CODEC_TAG_SAME);
+      }
+      uint8_t value[GD_BUILTIN_SIZE_PROJECTION];
+      variant_codec.to_type[type](value, (void *)p_value);
+      return variant_codec_put_u8(w, VARIANT_CODEC_TAG_RAW)
+             && variant_codec_put_u8(w, type)
+             && variant_codec_put(w, value, size);
+    }
+  }
+}
+
+// Writes a header and `p_value`, as the difference to `p_baseline` unless
+// that's NULL. On failure the writer's size is back where it was and
+// `error` says why.
+static bool
+variant_codec_encode(
+  variant_codec_writer_t *w,
+  GDExtensionConstVariantPtr p_value,
+  GDExtensionConstVariantPtr p_baseline
+) {
+  size_t start = w->size;
+  w->error = VARIANT_CODEC_OK;
+  uint8_t header[VARIANT_CODEC_HEADER_SIZE] = {
+    'G',
+    'V',
+    VARIANT_CODEC_VERSION,
+    (p_baseline != NULL ? VARIANT_CODEC_FLAG_DELTA : 0)
+      | (GD_BUILTIN_SIZE_VECTOR2 == 16 ? VARIANT_CODEC_FLAG_DOUBLE_REALS : 0),
+  };
+  if (variant_codec_put(w, header, sizeof(header)) && variant_codec_encode_value(w, p_value, p_baseline, 0)) {
+    return true;
+  }
+  w->size = start;
+  return false;
+}
+
+// ---------------------------------------------------------------------------
+// Reading
+// ---------------------------------------------------------------------------
+
+typedef struct {
+  const uint8_t *data;
+  size_t size;
+  size_t position;
+  variant_codec_error_t error;
+} variant_codec_reader_t;
+
+static inline variant_codec_reader_t variant_codec_reader(const uint8_t *p_data, size_t p_size) {
+  return (variant_codec_reader_t){ .data = p_data, .size = p_size };
+}
+
+static inline const uint8_t *variant_codec_take(variant_codec_reader_t *r, uint64_t p_count) {
+  if (r->size - r->position < p_count) {
+    variant_codec_fail(&r->error, VARIANT_CODEC_ERROR_CORRUPT);
+    return NULL;
+  }
+  const uint8_t *res = r->data + r->position;
+  r->position += p_count;
+  return res;
+}
+
+static inline bool variant_codec_take_u8(variant_codec_reader_t *r, uint8_t *r_byte) {
+  const uint8_t *byte = variant_codec_take(r, 1);
+  if (byte == NULL) return false;
+  *r_byte = *byte;
+  return true;
+}
+
+static inline bool variant_codec_take_varint(variant_codec_reader_t *r, uint64_t *r_value) {
+  uint64_t value = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    uint8_t byte;
+    if (!variant_codec_take_u8(r, &byte)) return false;
+    value |= (uint64_t)(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) {
+      *r_value = value;
+      return true;
+    }
+  }
+  return variant_codec_fail(&r->error, VARIANT_CODEC_ERROR_CORRUPT);
+}
+
+// A count of things that take at least `p_min_bytes` each, checked against
+// what's left so corrupt data can't make us allocate gigabytes
+static inline bool variant_codec_take_count(variant_codec_reader_t *r, uint64_t p_min_bytes, GDExtensionInt *r_count) {
+  uint64_t count;
+  if (!variant_codec_take_varint(r, &count)) return false;
+  if (p_min_bytes > 0 && count > (r->size - r->position) / p_min_bytes) {
+    return variant_codec_fail(&r->error, VARIANT_CODEC_ERROR_CORRUPT);
+  }
+  *r_count = (GDExtensionInt)count;
+  return true;
+}
+
+// Into an uninitialized String or StringName
+static bool variant_codec_take_string(variant_codec_reader_t *r, GDExtensionUninitializedTypePtr r_string, bool p_string_name) {
+  GDExtensionInt length;
+  if (!variant_codec_take_count(r, 1, &length)) return false;
+  const uint8_t *bytes = variant_codec_take(r, length);
+  if (p_string_name) {
+    // Not `gd_string_name_new`, its ASCII path needs a terminating zero
+    gd_string.interface.string_name_new_with_utf8_chars_and_len(r_string, (const char *)bytes, length);
+  } else {
+    gd_string_new(r_string, (const char *)bytes, length);
+  }
+  return true;
+}
+
+static bool variant_codec_decode_value(variant_codec_reader_t *r, GDExtensionUninitializedVariantPtr r_value, GDExtensionConstVariantPtr p_baseline, int depth);
+
+// Wraps a container built in `p_local` into `r_value` and lets go of it
+static inline void variant_codec_wrap(GDExtensionVariantType p_type, GDExtensionUninitializedVariantPtr r_value, GDExtensionTypePtr p_local) {
+  variant_codec.from_type[p_type](r_value, p_local);
+  variant_codec.destructor[p_type](p_local);
+}
+
+static inline bool variant_codec_resize(GDExtensionVariantType p_type, GDExtensionTypePtr p_container, GDExtensionInt p_count) {
+  GDExtensionConstTypePtr args[] = { &p_count };
+  GDExtensionInt error;
+  variant_codec.resize[p_type](p_container, args, &error, 1);
+  return error == 0;
+}
+
+static bool
+variant_codec_decode_array(
+  variant_codec_reader_t *r,
+  GDExtensionUninitializedVariantPtr r_value,
+  GDExtensionConstTypePtr p_baseline,
+  int depth
+) {
+  GDExtensionInt count;
+  if (!variant_codec_take_count(r, 1, &count)) return false;
+  gd_array_view_t baseline = p_baseline != NULL ? gd_array_view(p_baseline) : (gd_array_view_t){ 0 };
+
+  uint8_t array[GD_BUILTIN_SIZE_ARRAY];
+  gd_container.array_constructor(array, NULL);
+  variant_codec_resize(GDEXTENSION_VARIANT_TYPE_ARRAY, array, count);
+  bool ok = true;
+  for (GDExtensionInt i = 0; ok && i < count; i++) {
+    GDExtensionConstVariantPtr baseline_element = i < baseline.size ? gd_array_view_at(baseline, i) : NULL;
+    // Resizing filled the Array with Nils, they need no destroying
+    ok = variant_codec_decode_value(r, gd_array_at(array, i), baseline_element, depth + 1);
+  }
+  variant_codec_wrap(GDEXTENSION_VARIANT_TYPE_ARRAY, r_value, array);
+  return ok;
+}
+
+static bool
+variant_codec_decode_dictionary(
+  variant_codec_reader_t *r,
+  GDExtensionUninitializedVariantPtr r_value,
+  GDExtensionConstTypePtr p_baseline,
+  int depth
+) {
+  GDExtensionInt count;
+  if (!variant_codec_take_count(r, 2, &count)) return false;
+  uint8_t baseline_keys[GD_BUILTIN_SIZE_ARRAY];
+  if (p_baseline != NULL) {
+    gd_container.array_constructor(baseline_keys, NULL);
+    gd_container.dictionary_keys((void *)p_baseline, NULL, baseline_keys, 0);
+  }
+  gd_array_view_t baseline = p_baseline != NULL ? gd_array_view(baseline_keys) : (gd_array_view_t){ 0 };
+
+  uint8_t dictionary[GD_BUILTIN_SIZE_DICTIONARY];
+  variant_codec.default_constructor[GDEXTENSION_VARIANT_TYPE_DICTIONARY](dictionary, NULL);
+  bool ok = true;
+  for (GDExtensionInt i = 0; ok && i < count; i++) {
+    uint8_t key[GD_BUILTIN_SIZE_VARIANT];
+    GDExtensionConstVariantPtr baseline_value = NULL;
+    if (p_baseline != NULL && r->position < r->size && r->data[r->position] == VARIANT_CODEC_TAG_KEY_INDEX) {
+      uint64_t index;
+      r->position++;
+      ok = variant_codec_take_varint(r, &index);
+      if (ok && index >= (uint64_t)baseline.size) ok = variant_codec_fail(&r->error, VARIANT_CODEC_ERROR_BASELINE);
+      if (!ok) break;
+      GDExtensionConstVariantPtr baseline_key = gd_array_view_at(baseline, index);
+      variant_codec.interface.variant_new_copy(key, baseline_key);
+      baseline_value = gd_container.interface.dictionary_operator_index_const(p_baseline, baseline_key);
+    } else if (!variant_codec_decode_value(r, key, NULL, depth + 1)) {
+      variant_codec.interface.variant_destroy(key);
+      ok = false;
+      break;
+    }
+
+    GDExtensionVariantPtr value = variant_codec.interface.dictionary_operator_index(dictionary, key);
+    // Corrupt data could repeat a key
+    variant_codec.interface.variant_destroy(value);
+    ok = variant_codec_decode_value(r, value, baseline_value, depth + 1);
+    variant_codec.interface.variant_destroy(key);
+  }
+
+  if (p_baseline != NULL) gd_container.array_destructor(baseline_keys);
+  variant_codec_wrap(GDEXTENSION_VARIANT_TYPE_DICTIONARY, r_value, dictionary);
+  return ok;
+}
+
+static bool
+variant_codec_decode_packed(
+  variant_codec_reader_t *r,
+  GDExtensionUninitializedVariantPtr r_value,
+  GDExtensionConstVariantPtr p_baseline,
+  bool p_delta
+) {
+  uint8_t type;
+  if (!variant_codec_take_u8(r, &type)) return false;
+  size_t element_size = type < GDEXTENSION_VARIANT_TYPE_VARIANT_MAX ? variant_codec_element_size[type] : 0;
+  if (element_size == 0) return variant_codec_fail(&r->error, VARIANT_CODEC_ERROR_CORRUPT);
+  GDExtensionInt count;
+  if (!variant_codec_take_count(r, p_delta ? 0 : element_size, &count)) return false;
+
+  uint8_t array[GD_BUILTIN_SIZE_PACKED_BYTE_ARRAY];
+  if (!p_delta) {
+    const uint8_t *data = variant_codec_take(r, count * element_size);
+    if (data == NULL) return false;
+    variant_codec.default_constructor[type](array, NULL);
+    variant_codec_resize(type, array, count);
+    if (count > 0) memcpy(variant_codec.packed_index[type](array, 0), data, count * element_size);
+    variant_codec_wrap(type, r_value, array);
+    return true;
+  }
+
+  if (p_baseline == NULL || variant_codec.interface.variant_get_type(p_baseline) != type) {
+    return variant_codec_fail(&r->error, VARIANT_CODEC_ERROR_BASELINE);
+  }
+  // A copy of the baseline shares its buffer until the first write
+  uint8_t baseline[GD_BUILTIN_SIZE_PACKED_BYTE_ARRAY];
+  variant_codec.to_type[type](baseline, (void *)p_baseline);
+  GDExtensionInt baseline_count;
+  variant_codec.size[type](baseline, NULL, &baseline_count, 0);
+  if (baseline_count != count) {
+    variant_codec.destructor[type](baseline);
+    return variant_codec_fail(&r->error, VARIANT_CODEC_ERROR_BASELINE);
+  }
+  GDExtensionConstTypePtr args[] = { baseline };
+  variant_codec.copy_constructor[type](array, args);
+  variant_codec.destructor[type](baseline);
+
+  uint8_t *data = count > 0 ? variant_codec.packed_index[type](array, 0) : NULL;
+  GDExtensionInt i = 0;
+  bool ok = true;
+  while (ok && i < count) {
+    uint64_t skip;
+    uint64_t run;
+    ok = variant_codec_take_varint(r, &skip) && variant_codec_take_varint(r, &run);
+    if (ok && (skip + run == 0 || skip > (uint64_t)(count - i) || run > (uint64_t)(count - i) - skip)) {
+      ok = variant_codec_fail(&r->error, VARIANT_CODEC_ERROR_CORRUPT);
+    }
+    const uint8_t *changed = ok ? variant_codec_take(r, run * element_size) : NULL;
+    if (changed == NULL) {
+      ok = false;
+      break;
+    }
+    memcpy(data + (i + skip) * element_size, changed, run * element_size);
+    i += skip + run;
+  }
+  variant_codec_wrap(type, r_value, array);
+  return ok;
+}
+
+static bool variant_codec_decode_packed_strings(variant_codec_reader_t *r, GDExtensionUninitializedVariantPtr r_value) {
+  GDExtensionVariantType type = GDEXTENSION_VARIANT_TYPE_PACKED_STRING_ARRAY;
+  GDExtensionInt count;
+  if (!variant_codec_take_count(r, 1, &count)) return false;
+
+  uint8_t array[GD_BUILTIN_SIZE_PACKED_STRING_ARRAY];
+  variant_codec.default_constructor[type](array, NULL);
+  variant_codec_resize(type, array, count);
+  bool ok = true;
+  for (GDExtensionInt i = 0; ok && i < count; i++) {
+    GDExtensionTypePtr string = variant_codec.packed_index[type](array, i);
+    variant_codec.destructor[GDEXTENSION_VARIANT_TYPE_STRING](string);
+    ok = variant_codec_take_string(r, string, false);
+    if (!ok) gd_string_new(string, "", 0);
+  }
+  variant_codec_wrap(type, r_value, array);
+  return ok;
+}
+
+// On failure `r_value` still holds a valid Variant (Nil, or a partly decoded
+// container) for the caller to destroy
+static bool
+variant_codec_decode_value(
+  variant_codec_reader_t *r,
+  GDExtensionUninitializedVariantPtr r_value,
+  GDExtensionConstVariantPtr p_baseline,
+  int depth
+) {
+  variant_codec.interface.variant_new_nil(r_value);
+  if (depth > VARIANT_CODEC_MAX_DEPTH) return variant_codec_fail(&r->error, VARIANT_CODEC_ERROR_TOO_DEEP);
+  uint8_t tag;
+  if (!variant_codec_take_u8(r, &tag)) return false;
+
+  switch (tag) {
+    case VARIANT_CODEC_TAG_NIL:
+      return true;
+
+    case VARIANT_CODEC_TAG_FALSE:
+    case VARIANT_CODEC_TAG_TRUE: {
+      GDExtensionBool value = tag == VARIANT_CODEC_TAG_TRUE;
+      variant_codec.from_type[GDEXTENSION_VARIANT_TYPE_BOOL](r_value, &value);
+      return true;
+    }
+
+    case VARIANT_CODEC_TAG_INT: {
+      uint64_t zigzag;
+      if (!variant_codec_take_varint(r, &zigzag)) return false;
+      GDExtensionInt value = (GDExtensionInt)(zigzag >> 1) ^ -(GDExtensionInt)(zigzag & 1);
+      variant_codec.from_type[GDEXTENSION_VARIANT_TYPE_INT](r_value, &value);
+      return true;
+    }
+
+    case VARIANT_CODEC_TAG_FLOAT32:
+    case VARIANT_CODEC_TAG_FLOAT64: {
+      const uint8_t *bytes = variant_codec_take(r, tag == VARIANT_CODEC_TAG_FLOAT32 ? sizeof(float) : sizeof(double));
+      if (bytes == NULL) return false;
+      double value;
+      if (tag == VARIANT_CODEC_TAG_FLOAT32) {
+        float narrow;
+        memcpy(&narrow, bytes, sizeof(narrow));
+        value = narrow;
+      } else {
+        memcpy(&value, bytes, sizeof(value));
+      }
+      variant_codec.from_type[GDEXTENSION_VARIANT_TYPE_FLOAT](r_value, &value);
+      return true;
+    }
+
+    case VARIANT_CODEC_TAG_STRING:
+    case VARIANT_CODEC_TAG_STRING_NAME: {
+      GDExtensionVariantType type = tag == VARIANT_CODEC_TAG_STRING ? GDEXTENSION_VARIANT_TYPE_STRING : GDEXTENSION_VARIANT_TYPE_STRING_NAME;
+      uint8_t string[GD_BUILTIN_SIZE_STRING];
+      if (!variant_codec_take_string(r, string, type == GDEXTENSION_VARIANT_TYPE_STRING_NAME)) return false;
+      variant_codec_wrap(type, r_value, string);
+      return true;
+    }
+
+    case VARIANT_CODEC_TAG_RAW: {
+      uint8_t type;
+      if (!variant_codec_take_u8(r, &type)) return false;
+      size_t size = type < GDEXTENSION_VARIANT_TYPE_VARIANT_MAX ? variant_codec_raw_size[type] : 0;
+      if (size == 0) return variant_codec_fail(&r->error, VARIANT_CODEC_ERROR_CORRUPT);
+      const uint8_t *bytes = variant_codec_take(r, size);
+      if (bytes == NULL) return false;
+      uint8_t value[GD_BUILTIN_SIZE_PROJECTION];
+      memcpy(value, bytes, size);
+      variant_codec.from_type[type](r_value, value);
+      return true;
+    }
+
+    case VARIANT_CODEC_TAG_PACKED:
+    case VARIANT_CODEC_TAG_PACKED_DELTA:
+      return variant_codec_decode_packed(r, r_value, p_baseline, tag == VARIANT_CODEC_TAG_PACKED_DELTA);
+
+    case VARIANT_CODEC_TAG_PACKED_STRINGS:
+      return variant_codec_decode_packed_strings(r, r_value);
+
+    case VARIANT_CODEC_TAG_SAME:
+      if (p_baseline == NULL) return variant_codec_fail(&r->error, VARIANT_CODEC_ERROR_BASELINE);
+      variant_codec.interface.variant_new_copy(r_value, p_baseline);
+      return true;
+
+    case VARIANT_CODEC_TAG_ARRAY:
+    case VARIANT_CODEC_TAG_ARRAY_DELTA:
+    case VARIANT_CODEC_TAG_DICTIONARY:
+    case VARIANT_CODEC_TAG_DICTIONARY_DELTA: {
+      bool array = tag == VARIANT_CODEC_TAG_ARRAY || tag == VARIANT_CODEC_TAG_ARRAY_DELTA;
+      GDExtensionVariantType type = array ? GDEXTENSION_VARIANT_TYPE_ARRAY : GDEXTENSION_VARIANT_TYPE_DICTIONARY;
+      bool delta = tag == VARIANT_CODEC_TAG_ARRAY_DELTA || tag == VARIANT_CODEC_TAG_DICTIONARY_DELTA;
+      if (delta && (p_baseline == NULL || variant_codec.interface.variant_get_type(p_baseline) != type)) {
+        return variant_codec_fail(&r->error, VARIANT_CODEC_ERROR_BASELINE);
+      }
+
+      uint8_t baseline[GD_BUILTIN_SIZE_DICTIONARY];
+      if (delta) variant_codec.to_type[type](baseline, (void *)p_baseline);
+      bool ok = array ? variant_codec_decode_array(r, r_value, delta ? baseline : NULL, depth)
+                      : variant_codec_decode_dictionary(r, r_value, delta ? baseline : NULL, depth);
+      if (delta) variant_codec.destructor[type](baseline);
+      return ok;
+    }
+
+    default:
+      return variant_codec_fail(&r->error, VARIANT_CODEC_ERROR_CORRUPT);
+  }
+}
+
+// Reads a header and the value after it into `r_value`. Delta encoded data
+// needs the `p_baseline` it was encoded against. `r_value` is always
+// initialized, on failure it's Nil and `error` says why.
+static bool
+variant_codec_decode(
+  variant_codec_reader_t *r,
+  GDExtensionUninitializedVariantPtr r_value,
+  GDExtensionConstVariantPtr p_baseline
+) {
+  r->error = VARIANT_CODEC_OK;
+  const uint8_t *header = variant_codec_take(r, VARIANT_CODEC_HEADER_SIZE);
+  if (header == NULL) {
+    variant_codec.interface.variant_new_nil(r_value);
+    return false;
+  }
+  uint8_t real_flag = GD_BUILTIN_SIZE_VECTOR2 == 16 ? VARIANT_CODEC_FLAG_DOUBLE_REALS : 0;
+  if (header[0] != 'G' || header[1] != 'V' || header[2] != VARIANT_CODEC_VERSION
+      || (header[3] & VARIANT_CODEC_FLAG_DOUBLE_REALS) != real_flag) {
+    variant_codec.interface.variant_new_nil(r_value);
+    r->error = VARIANT_CODEC_ERROR_VERSION;
+    return false;
+  }
+  if ((header[3] & VARIANT_CODEC_FLAG_DELTA) != 0 && p_baseline == NULL) {
+    variant_codec.interface.variant_new_nil(r_value);
+    r->error = VARIANT_CODEC_ERROR_BASELINE;
+    return false;
+  }
+
+  GDExtensionConstVariantPtr baseline = (header[3] & VARIANT_CODEC_FLAG_DELTA) != 0 ? p_baseline : NULL;
+  if (variant_codec_decode_value(r, r_value, baseline, 0)) return true;
+  variant_codec.interface.variant_destroy(r_value);
+  variant_codec.interface.variant_new_nil(r_value);
+  return false;
+}
+
+static const char *variant_codec_error_name(variant_codec_error_t p_error) {
+  switch (p_error) {
+    case VARIANT_CODEC_OK: return "ok";
+    case VARIANT_CODEC_ERROR_FULL: return "buffer full";
+    case VARIANT_CODEC_ERROR_UNSUPPORTED: return "unsupported type";
+    case VARIANT_CODEC_ERROR_TOO_DEEP: return "nested too deep";
+    case VARIANT_CODEC_ERROR_CORRUPT: return "corrupt data";
+    case VARIANT_CODEC_ERROR_VERSION: return "wrong format version";
+    case VARIANT_CODEC_ERROR_BASELINE: return "baseline missing or different";
+  }
+  return "unknown error";
+}
+
+#endif
@@ -0,0 +1,253 @@
+#ifndef VARIANT_UNWRAP_H
+#define VARIANT_UNWRAP_H
+
+// Typed unwrapping of Variants, with the conversions GDScript expects.
+//
+// The usual setter asks `variant_get_type`, compares it against one type and
+// then calls the unwrap function of that type. Anything else is rejected, so
+// `node.amplitude = 2` does nothing because 2 is an int. Here every
+// (Variant type, wanted type) pair has an entry in a table that is filled once
+// at init:
+//
+// - same type: the unwrap function of the type, nothing else
+// - bool/int/float, VectorN/VectorNi, Rect2/Rect2i: unwrapped and converted
+//   in C, the same way Godot converts them (floats are truncated)
+// - String/StringName/NodePath, Array to Packed*Array: unwrapped and passed
+//   to the builtin constructor Godot uses for the conversion
+// - null to Object: a NULL object
+// - everything else: no entry, `variant_unwrap_as` returns false
+//
+// So a call is `variant_get_type`, one indexed load and the unwrap function,
+// the same crossings as the hand-written check. Only conversions that need a
+// builtin constructor cost more, and only as much as doing it by hand.
+//
+// Usage:
+//
+//   variant_unwrap_init(p_get_proc_address); // in godot_entry
+//   double amplitude;
+//   if (variant_unwrap_as(GDEXTENSION_VARIANT_TYPE_FLOAT, p_value, &amplitude)) { ... }
+//
+// NOTE: `r_value` has to be big enough for the wanted type (see
+// `builtin_sizes.h`) and is only written when the call returns true. Values
+// that own memory (String, Array...) have to be destroyed by the caller like
+// any other unwrapped value.
+//
+// NOTE: The table is read-only after `variant_unwrap_init`, calls are safe
+// from any thread.
+
+#include "../godot-headers/gdextension_interface.h"
+#include "builtin_sizes.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define VARIANT_UNWRAP_TYPE_COUNT (GDEXTENSION_VARIANT_TYPE_VARIANT_MAX)
+
+// Projection is the biggest builtin that can be unwrapped as a source
+#define VARIANT_UNWRAP_SCRATCH_SIZE (GD_BUILTIN_SIZE_PROJECTION)
+
+// Builtin constructor indices from `extension_api.json`
+#define VARIANT_UNWRAP_STRING_FROM_STRING_NAME (2)
+#define VARIANT_UNWRAP_STRING_FROM_NODE_PATH (3)
+#define VARIANT_UNWRAP_STRING_NAME_FROM_STRING (2)
+#define VARIANT_UNWRAP_NODE_PATH_FROM_STRING (2)
+#define VARIANT_UNWRAP_PACKED_ARRAY_FROM_ARRAY (2)
+
+#if (IS_GODOT_USING_LARGE_WORLD_COORDINATES)
+typedef double variant_unwrap_real_t;
+#else
+typedef float variant_unwrap_real_t;
+#endif
+
+typedef struct variant_unwrap_conversion variant_unwrap_conversion_t;
+
+typedef void (*variant_unwrap_convert_func_t)(const variant_unwrap_conversion_t *p_conversion, GDExtensionUninitializedTypePtr r_value, const void *p_source);
+
+struct variant_unwrap_conversion {
+  // Of the Variant's type. NULL together with `convert` means there's no
+  // conversion.
+  GDExtensionTypeFromVariantConstructorFunc unwrap;
+  // NULL when unwrapping is all there is to it
+  variant_unwrap_convert_func_t convert;
+  // Of the wanted type, for `variant_unwrap_convert_construct`
+  GDExtensionPtrConstructor constructor;
+  // Of the Variant's type, when the unwrapped source owns memory
+  GDExtensionPtrDestructor destructor;
+};
+
+static struct {
+  struct {
+    GDExtensionInterfaceVariantGetType variant_get_type;
+    GDExtensionInterfaceGetVariantToTypeConstructor get_variant_to_type_constructor;
+    GDExtensionInterfaceVariantGetPtrConstructor variant_get_ptr_constructor;
+    GDExtensionInterfaceVariantGetPtrDestructor variant_get_ptr_destructor;
+  } interface;
+
+  // [Variant type][wanted type]
+  variant_unwrap_conversion_t conversion[VARIANT_UNWRAP_TYPE_COUNT][VARIANT_UNWRAP_TYPE_COUNT];
+} variant_unwrap;
+
+#define VARIANT_UNWRAP_STORE_INTERFACE(name) \
+  variant_unwrap.interface.name = (void *)p_get_proc_address(#name);
+
+// Scalars, read as their Godot types: bool is a byte, int an int64, float a
+// double
+static void variant_unwrap_bool_to_int(const variant_unwrap_conversion_t *p_conversion, GDExtensionUninitializedTypePtr r_value, const void *p_source) {
+  *(int64_t *)r_value = *(const uint8_t *)p_source ? 1 : 0;
+}
+
+static void variant_unwrap_bool_to_float(const variant_unwrap_conversion_t *p_conversion, GDExtensionUninitializedTypePtr r_value, const void *p_source) {
+  *(double *)r_value = *(const uint8_t *)p_source ? 1.0 : 0.0;
+}
+
+static void variant_unwrap_int_to_bool(const variant_unwrap_conversion_t *p_conversion, GDExtensionUninitializedTypePtr r_value, const void *p_source) {
+  *(uint8_t *)r_value = *(const int64_t *)p_source != 0;
+}
+
+static void variant_unwrap_int_to_float(const variant_unwrap_conversion_t *p_conversion, GDExtensionUninitializedTypePtr r_value, const void *p_source) {
+  *(double *)r_value = (double)*(const int64_t *)p_source;
+}
+
+static void variant_unwrap_float_to_bool(const variant_unwrap_conversion_t *p_conversion, GDExtensionUninitializedTypePtr r_value, const void *p_source) {
+  *(uint8_t *)r_value = *(const double *)p_source != 0.0;
+}
+
+static void variant_unwrap_float_to_int(const variant_unwrap_conversion_t *p_conversion, GDExtensionUninitializedTypePtr r_value, const void *p_source) {
+  *(int64_t *)r_value = (int64_t)*(const double *)p_source;
+}
+
+// VectorN, VectorNi, Rect2 and Rect2i are plain arrays of `real_t` or int32
+#define VARIANT_UNWRAP_DEFINE_COMPONENT_CONVERSIONS(name, count)                                         \
+  static void variant_unwrap_##name##i_to_##name(const variant_unwrap_conversion_t *p_conversion,        \
+                                                 GDExtensionUninitializedTypePtr r_value,                \
+                                                 const void *p_source) {                                 \
+    for (int i = 0; i < (count); i++) {                                                                  \
+      ((variant_unwrap_real_t *)r_value)[i] = (variant_unwrap_real_t)((const int32_t *)p_source)[i];     \
+    }                                                                                                    \
+  }                                                                                                      \
+  static void variant_unwrap_##name##_to_##name##i(const variant_unwrap_conversion_t *p_conversion,      \
+                                                   GDExtensionUninitializedTypePtr r_value,              \
+                                                   const void *p_source) {                               \
+    for (int i = 0; i < (count); i++) {                                                                  \
+      ((int32_t *)r_value)[i] = (int32_t)((const variant_unwrap_real_t *)p_source)[i];                   \
+    }                                                                                                    \
+  }
+
+VARIANT_UNWRAP_DEFINE_COMPONENT_CONVERSIONS(vector2, 2)
+VARIANT_UNWRAP_DEFINE_COMPONENT_CONVERSIONS(vector3, 3)
+VARIANT_UNWRAP_DEFINE_COMPONENT_CONVERSIONS(vector4, 4)
+VARIANT_UNWRAP_DEFINE_COMPONENT_CONVERSIONS(rect2, 4)
+
+static void variant_unwrap_nil_to_object(const variant_unwrap_conversion_t *p_conversion, GDExtensionUninitializedTypePtr r_value, const void *p_source) {
+  *(GDExtensionObjectPtr *)r_value = NULL;
+}
+
+static void variant_unwrap_convert_construct(const variant_unwrap_conversion_t *p_conversion, GDExtensionUninitializedTypePtr r_value, const void *p_source) {
+  const GDExtensionConstTypePtr args[1] = { p_source };
+  p_conversion->constructor(r_value, args);
+}
+
+static void variant_unwrap_add(GDExtensionVariantType p_from, GDExtensionVariantType p_to, variant_unwrap_convert_func_t p_convert) {
+  variant_unwrap_conversion_t *conversion = &variant_unwrap.conversion[p_from][p_to];
+  conversion->unwrap = p_from == GDEXTENSION_VARIANT_TYPE_NIL
+    ? NULL
+    : variant_unwrap.interface.get_variant_to_type_constructor(p_from);
+  conversion->convert = p_convert;
+}
+
+static void variant_unwrap_add_both(GDExtensionVariantType p_a, GDExtensionVariantType p_b, variant_unwrap_convert_func_t p_a_to_b, variant_unwrap_convert_func_t p_b_to_a) {
+  variant_unwrap_add(p_a, p_b, p_a_to_b);
+  variant_unwrap_add(p_b, p_a, p_b_to_a);
+}
+
+static void variant_unwrap_add_constructor(GDExtensionVariantType p_from, GDExtensionVariantType p_to, int32_t p_constructor) {
+  variant_unwrap_add(p_from, p_to, variant_unwrap_convert_construct);
+  variant_unwrap_conversion_t *conversion = &variant_unwrap.conversion[p_from][p_to];
+  conversion->constructor = variant_unwrap.interface.variant_get_ptr_constructor(p_to, p_constructor);
+  conversion->destructor = variant_unwrap.interface.variant_get_ptr_destructor(p_from);
+}
+
+static void variant_unwrap_init(GDExtensionInterfaceGetProcAddress p_get_proc_address) {
+  VARIANT_UNWRAP_STORE_INTERFACE(variant_get_type);
+  VARIANT_UNWRAP_STORE_INTERFACE(get_variant_to_type_constructor);
+  VARIANT_UNWRAP_STORE_INTERFACE(variant_get_ptr_constructor);
+  VARIANT_UNWRAP_STORE_INTERFACE(variant_get_ptr_destructor);
+
+  // Nil has nothing to unwrap, every other type unwraps as itself
+  for (int type = GDEXTENSION_VARIANT_TYPE_BOOL; type < VARIANT_UNWRAP_TYPE_COUNT; type++) {
+    variant_unwrap_add(type, type, NULL);
+  }
+
+  variant_unwrap_add_both(GDEXTENSION_VARIANT_TYPE_BOOL, GDEXTENSION_VARIANT_TYPE_INT,
+                          variant_unwrap_bool_to_int, variant_unwrap_int_to_bool);
+  variant_unwrap_add_both(GDEXTENSION_VARIANT_TYPE_BOOL, GDEXTENSION_VARIANT_TYPE_FLOAT,
+                          variant_unwrap_bool_to_float, variant_unwrap_float_to_bool);
+  variant_unwrap_add_both(GDEXTENSION_VARIANT_TYPE_INT, GDEXTENSION_VARIANT_TYPE_FLOAT,
+                          variant_unwrap_int_to_float, variant_unwrap_float_to_int);
+
+  variant_unwrap_add_both(GDEXTENSION_VARIANT_TYPE_VECTOR2I, GDEXTENSION_VARIANT_TYPE_VECTOR2,
+                          variant_unwrap_vector2i_to_vector2, variant_unwrap_vector2_to_vector2i);
+  variant_unwrap_add_both(GDEXTENSION_VARIANT_TYPE_VECTOR3I, GDEXTENSION_VARIANT_TYPE_VECTOR3,
+                          variant_unwrap_vector3i_to_vector3, variant_unwrap_vector3_to_vector3i);
+  variant_unwrap_add_both(GDEXTENSION_VARIANT_TYPE_VECTOR4I, GDEXTENSION_VARIANT_TYPE_VECTOR4,
+                          variant_unwrap_vector4i_to_vector4, variant_unwrap_vector4_to_vector4i);
+  variant_unwrap_add_both(GDEXTENSION_VARIANT_TYPE_RECT2I, GDEXTENSION_VARIANT_TYPE_RECT2,
+                          variant_unwrap_rect2i_to_rect2, variant_unwrap_rect2_to_rect2i);
+
+  variant_unwrap_add(GDEXTENSION_VARIANT_TYPE_NIL, GDEXTENSION_VARIANT_TYPE_OBJECT, variant_unwrap_nil_to_object);
+
+  variant_unwrap_add_constructor(GDEXTENSION_VARIANT_TYPE_STRING_NAME, GDEXTENSION_VARIANT_TYPE_STRING,
+                                 VARIANT_UNWRAP_STRING_FROM_STRING_NAME);
+  variant_unwrap_add_constructor(GDEXTENSION_VARIANT_TYPE_NODE_PATH, GDEXTENSION_VARIANT_TYPE_STRING,
+                                 VARIANT_UNWRAP_STRING_FROM_NODE_PATH);
+  variant_unwrap_add_constructor(GDEXTENSION_VARIANT_TYPE_STRING, GDEXTENSION_VARIANT_TYPE_STRING_NAME,
+                                 VARIANT_UNWRAP_STRING_NAME_FROM_STRING);
+  variant_unwrap_add_constructor(GDEXTENSION_VARIANT_TYPE_STRING, GDEXTENSION_VARIANT_TYPE_NODE_PATH,
+                                 VARIANT_UNWRAP_NODE_PATH_FROM_STRING);
+
+  for (int type = GDEXTENSION_VARIANT_TYPE_PACKED_BYTE_ARRAY; type < VARIANT_UNWRAP_TYPE_COUNT; type++) {
+    variant_unwrap_add_constructor(GDEXTENSION_VARIANT_TYPE_ARRAY, type, VARIANT_UNWRAP_PACKED_ARRAY_FROM_ARRAY);
+  }
+}
+
+static inline bool variant_unwrap_can_convert(GDExtensionVariantType p_from, GDExtensionVariantType p_to) {
+  const variant_unwrap_conversion_t *conversion = &variant_unwrap.conversion[p_from][p_to];
+  return conversion->unwrap != NULL || conversion->convert != NULL;
+}
+
+static bool variant_unwrap_convert(const variant_unwrap_conversion_t *p_conversion, GDExtensionConstVariantPtr p_variant, GDExtensionUninitializedTypePtr r_value) {
+  _Alignas(8) uint8_t source[VARIANT_UNWRAP_SCRATCH_SIZE];
+  if (p_conversion->unwrap != NULL) {
+    p_conversion->unwrap(source, (GDExtensionVariantPtr)p_variant);
+  }
+  p_conversion->convert(p_conversion, r_value, source);
+  if (p_conversion->destructor != NULL) {
+    p_conversion->destructor(source);
+  }
+  return true;
+}
+
+static inline bool variant_unwrap_as(GDExtensionVariantType p_type, GDExtensionConstVariantPtr p_variant, GDExtensionUninitializedTypePtr r_value) {
+  GDExtensionVariantType from = variant_unwrap.interface.variant_get_type(p_variant);
+  const variant_unwrap_conversion_t *conversion = &variant_unwrap.conversion[from][p_type];
+  if (__builtin_expect(conversion->convert == NULL, 1)) {
+    if (conversion->unwrap == NULL) return false;
+    conversion->unwrap(r_value, (GDExtensionVariantPtr)p_variant);
+    return true;
+  }
+  return variant_unwrap_convert(conversion, p_variant, r_value);
+}
+
+static inline bool variant_unwrap_bool(GDExtensionConstVariantPtr p_variant, GDExtensionBool *r_value) {
+  return variant_unwrap_as(GDEXTENSION_VARIANT_TYPE_BOOL, p_variant, r_value);
+}
+
+static inline bool variant_unwrap_int(GDExtensionConstVariantPtr p_variant, GDExtensionInt *r_value) {
+  return variant_unwrap_as(GDEXTENSION_VARIANT_TYPE_INT, p_variant, r_value);
+}
+
+static inline bool variant_unwrap_float(GDExtensionConstVariantPtr p_variant, double *r_value) {
+  return variant_unwrap_as(GDEXTENSION_VARIANT_TYPE_FLOAT, p_variant, r_value);
+}
+
+#endif